@@ -0,0 +1,293 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dataflow.c -- dataflow solver benchmarks
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define BENCH_VREGS   100000
+#define BENCH_BB_DEFS 100
+#define BENCH_RUNS    5
+
+
+typedef struct result_s {
+	double   ms;        // building gen and kill included
+	double   solve_ms;
+	size_t   visits;
+	uint64_t checksum;
+} result_t;
+
+
+static uint64_t rng_state = UINT64_C(0x9e3779b97f4a7c15);
+
+
+static int append(ir_bb_t *ir_bb, ir_quad_t *ir_quad, int ret)
+{
+	if (ret) return ret;
+
+	if (vector_append(&ir_bb->quad, &ir_quad)) {
+		IR_QUAD_FREE(ir_quad);
+		return IR_ERROR_NOMEM;
+	}
+
+	return 0;
+}
+
+static uint64_t checksum(const ir_dataflow_t *ir_dataflow)
+{
+	uint64_t hash = UINT64_C(0xcbf29ce484222325);
+
+	for (size_t i = 0; i < ir_dataflow->ir_cfg->bbs; i++) {
+		const bitset_t *set[] = {
+			&ir_dataflow->in[i],
+			&ir_dataflow->out[i],
+		};
+
+		for (size_t j = 0; j < sizeof(set) / sizeof(*set); j++)
+			for (size_t k = 0; k < set[j]->words; k++) {
+				hash ^= set[j]->word[k];
+				hash *= UINT64_C(0x100000001b3);
+			}
+	}
+
+	return hash;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static uint64_t rng(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+
+	return rng_state;
+}
+
+static void resolve(ir_dataflow_t *ir_dataflow, result_t *result)
+{
+	// start over from the bottom of the lattice
+	for (size_t i = 0; i < ir_dataflow->ir_cfg->bbs; i++) {
+		bitset_zero(&ir_dataflow->in[i]);
+		bitset_zero(&ir_dataflow->out[i]);
+	}
+
+	ir_dataflow->visits = 0;
+
+	double start = now();
+	ir_dataflow_solve(ir_dataflow);
+	double stop = now();
+
+	if (stop - start < result->solve_ms) result->solve_ms = stop - start;
+
+	result->visits   = ir_dataflow->visits;
+	result->checksum = checksum(ir_dataflow);
+}
+
+static int solve(ir_function_t *ir_function, result_t *result)
+{
+	ir_cfg_t      ir_cfg;
+	ir_liveness_t ir_liveness;
+	ir_reaching_t ir_reaching;
+
+	int ret = ir_cfg_init(&ir_cfg, ir_function);
+	if (ret) return ret;
+
+	for (size_t i = 0; i < 2; i++)
+		result[i].ms = result[i].solve_ms = 1e300;
+
+	for (size_t i = 0; i < BENCH_RUNS; i++) {
+		double start = now();
+		ret = ir_liveness_init(&ir_liveness, &ir_cfg);
+		if (ret) goto error;
+		double stop = now();
+
+		if (stop - start < result[0].ms) result[0].ms = stop - start;
+
+		resolve(&ir_liveness.dataflow, &result[0]);
+		ir_liveness_free(&ir_liveness);
+
+		start = now();
+		ret = ir_reaching_init(&ir_reaching, &ir_cfg);
+		if (ret) goto error;
+		stop = now();
+
+		if (stop - start < result[1].ms) result[1].ms = stop - start;
+
+		resolve(&ir_reaching.dataflow, &result[1]);
+		ir_reaching_free(&ir_reaching);
+	}
+
+error:
+	ir_cfg_free(&ir_cfg);
+
+	return ret;
+}
+
+static ir_function_t *synthesize(size_t vregs)
+{
+	ir_function_t *ir_function = ir_function_alloc();
+	if (!ir_function) return NULL;
+
+	if (vector_init(&ir_function->bb, sizeof(ir_bb_t*), 0))
+		goto error;
+
+	size_t bbs  = (vregs + BENCH_BB_DEFS - 1) / BENCH_BB_DEFS;
+	size_t vreg = 0;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_bb_t   *ir_bb = ir_bb_alloc(i);
+		ir_quad_t *quad;
+
+		if (!ir_bb) goto error;
+
+		if (vector_append(&ir_function->bb, &ir_bb)) {
+			ir_bb_free(ir_bb);
+			goto error;
+		}
+
+		for (size_t j = 0; j < BENCH_BB_DEFS && vreg < vregs; j++) {
+			int ret;
+
+			if (vreg < 2) {
+				ret = ir_quad_mov_gen(
+					&quad,
+					vreg,
+					IR_REG_TYPE_I32,
+					vreg);
+				goto append_def;
+			}
+
+			// mostly local operands with a few long live ranges
+			size_t window = (vreg < 64) ? vreg : 64;
+
+			ret = ir_quad_binop_gen(
+				&quad,
+				vreg,
+				IR_QUAD_BINOP_ADD,
+				IR_REG_TYPE_I32,
+				vreg - 1 - rng() % window,
+				rng() % vreg);
+
+append_def:
+			if (append(ir_bb, quad, ret)) goto error;
+
+			++vreg;
+		}
+
+		if (i + 1 == bbs) {
+			int ret = ir_quad_ret_gen(
+				&quad,
+				IR_REG_TYPE_I32,
+				vreg - 1);
+			if (append(ir_bb, quad, ret)) goto error;
+			break;
+		}
+
+		// loop back every so often
+		if (i && !(rng() % 8)) {
+			int ret = ir_quad_cmp_gen(&quad, vreg - 1, vreg - 2);
+			if (append(ir_bb, quad, ret)) goto error;
+
+			ret = ir_quad_br_gen(&quad, IR_QUAD_BR_LT, rng() % i);
+			if (append(ir_bb, quad, ret)) goto error;
+		}
+
+		int ret = ir_quad_br_gen(&quad, IR_QUAD_BR_AL, i + 1);
+		if (append(ir_bb, quad, ret)) goto error;
+	}
+
+	return ir_function;
+
+error:
+	ir_function_free(ir_function);
+
+	return NULL;
+}
+
+
+int main(int argc, char **argv)
+{
+	size_t vregs = (argc > 1) ? strtoul(argv[1], NULL, 10) : BENCH_VREGS;
+
+	if (!vregs) vregs = BENCH_VREGS;
+
+	ir_function_t *ir_function = synthesize(vregs);
+	if (!ir_function) return EXIT_FAILURE;
+
+	printf(
+		"dataflow: %zu vregs, %zu bbs, best of %d\n",
+		vregs,
+		ir_function->bb.use,
+		BENCH_RUNS);
+	printf(
+		"%-8s %12s %10s %8s %12s %10s %8s\n",
+		"kernel",
+		"liveness-ms",
+		"solve-ms",
+		"visits",
+		"reaching-ms",
+		"solve-ms",
+		"visits");
+
+	int      status = EXIT_SUCCESS;
+	result_t reference[2] = {0};
+
+	for (bitset_kernel_t i = 0; i < BITSET_KERNELS_TOTAL; i++) {
+		result_t result[2];
+
+		if (bitset_kernel_set(i)) continue;
+
+		if (solve(ir_function, result)) {
+			status = EXIT_FAILURE;
+			break;
+		}
+
+		printf(
+			"%-8s %12.3f %10.3f %8zu %12.3f %10.3f %8zu\n",
+			bitset_kernel_str(i),
+			result[0].ms,
+			result[0].solve_ms,
+			result[0].visits,
+			result[1].ms,
+			result[1].solve_ms,
+			result[1].visits);
+
+		if (i == BITSET_KERNEL_SCALAR) {
+			reference[0] = result[0];
+			reference[1] = result[1];
+			continue;
+		}
+
+		// every kernel has to agree with the scalar one
+		if (result[0].checksum != reference[0].checksum
+			|| result[1].checksum != reference[1].checksum) {
+			fprintf(
+				stderr,
+				"dataflow: %s disagrees with scalar\n",
+				bitset_kernel_str(i));
+			status = EXIT_FAILURE;
+		}
+	}
+
+	ir_function_free(ir_function);
+
+	return status;
+}
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * sched.c -- task scheduler benchmarks
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <jkcc/sched.h>
+
+
+#define BENCH_TASKS   1000000
+#define BENCH_FIB_N   25
+#define BENCH_RUNS    5
+
+
+typedef struct fib_s {
+	sched_t *sched;
+	unsigned n;
+	uint64_t result;
+} fib_t;
+
+typedef struct result_s {
+	double       ms;
+	size_t       tasks;
+	sched_stat_t stat;
+} result_t;
+
+
+static void fib(void *arg)
+{
+	fib_t *fib_arg = arg;
+
+	if (fib_arg->n < 2) {
+		fib_arg->result = fib_arg->n;
+		return;
+	}
+
+	fib_t lhs = {
+		.sched = fib_arg->sched,
+		.n     = fib_arg->n - 1,
+	};
+	fib_t rhs = {
+		.sched = fib_arg->sched,
+		.n     = fib_arg->n - 2,
+	};
+
+	sched_group_t group;
+
+	sched_group_init(&group);
+
+	sched_spawn(fib_arg->sched, &group, fib, &lhs);
+	fib(&rhs);
+
+	sched_wait(fib_arg->sched, &group);
+
+	fib_arg->result = lhs.result + rhs.result;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void tick(void *arg)
+{
+	atomic_fetch_add_explicit(
+		(atomic_size_t*) arg,
+		1,
+		memory_order_relaxed);
+}
+
+static int run(size_t workers, bool tree, result_t *result)
+{
+	sched_t sched;
+
+	result->ms = 1e300;
+
+	if (sched_init(&sched, workers)) return -1;
+
+	for (size_t i = 0; i < BENCH_RUNS; i++) {
+		double start = now();
+
+		if (tree) {
+			// spawns come from every worker, so most run stolen
+			fib_t root = {
+				.sched = &sched,
+				.n     = BENCH_FIB_N,
+			};
+
+			fib(&root);
+		} else {
+			// one producer, the rest can only steal
+			sched_group_t group;
+			atomic_size_t count;
+
+			sched_group_init(&group);
+			atomic_init(&count, 0);
+
+			for (size_t j = 0; j < BENCH_TASKS; j++)
+				sched_spawn(&sched, &group, tick, &count);
+
+			sched_wait(&sched, &group);
+		}
+
+		double stop = now();
+
+		if (stop - start < result->ms) result->ms = stop - start;
+
+		sched_reset(&sched);
+	}
+
+	sched_stat(&sched, &result->stat);
+
+	result->tasks = result->stat.spawned / BENCH_RUNS;
+
+	sched_free(&sched);
+
+	return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+	long online = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t max  = (argc > 1) ? strtoul(argv[1], NULL, 10) : 0;
+
+	if (!max) max = (online > 0) ? (size_t) online : 1;
+
+	printf("sched: up to %zu workers, best of %d\n", max, BENCH_RUNS);
+	printf(
+		"%-6s %8s %10s %10s %10s %12s\n",
+		"bench",
+		"workers",
+		"tasks",
+		"ms",
+		"ns/task",
+		"stolen/run");
+
+	static const char *const bench_str[] = {"flat", "fib"};
+
+	for (size_t tree = 0; tree < 2; tree++)
+		for (size_t workers = 1; workers <= max; workers *= 2) {
+			result_t result;
+
+			if (run(workers, tree, &result)) return EXIT_FAILURE;
+
+			printf(
+				"%-6s %8zu %10zu %10.3f %10.1f %12.0f\n",
+				bench_str[tree],
+				workers,
+				result.tasks,
+				result.ms,
+				result.ms * 1e6 / result.tasks,
+				(double) result.stat.stolen / BENCH_RUNS);
+		}
+
+	return EXIT_SUCCESS;
+}
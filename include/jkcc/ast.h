@@ -87,9 +87,22 @@ extern void (*const fprint_ast_node[AST_NODES_TOTAL])(
 	size_t       level,
 	uint_fast8_t flags);
 
+extern void (*const fprint_ast_node_jsonl[AST_NODES_TOTAL])(
+	FILE         *stream,
+	const ast_t  *ast,
+	ast_jsonl_t  *jsonl);
+
 extern const char *const ast_node_str[AST_NODES_TOTAL];
 
 
+void ast_jsonl_push(
+	ast_jsonl_t      *jsonl,
+	const ast_t      *ast,
+	const char       *edge,
+	size_t            index);
+int  fprint_ast_jsonl(
+	FILE             *stream,
+	const ast_t      *ast);
 void fprint_file(
 	FILE             *stream,
 	const file_t     *file,
@@ -100,6 +113,9 @@ void fprint_location(
 	const location_t *location,
 	size_t            level,
 	uint_fast8_t      flags);
+void fprint_location_jsonl(
+	FILE             *stream,
+	const location_t *location);
 
 
 #endif  /* JKCC_AST_H */
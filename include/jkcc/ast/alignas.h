@@ -34,6 +34,10 @@ void fprint_ast_alignas(
 	const ast_t  *ast,
 	size_t        level,
 	uint_fast8_t  flags);
+void fprint_ast_alignas_jsonl(
+	FILE         *stream,
+	const ast_t  *ast,
+	ast_jsonl_t  *jsonl);
 
 
 #endif  /* JKCC_AST_ALIGNAS_H */
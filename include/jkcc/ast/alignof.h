@@ -34,6 +34,10 @@ void fprint_ast_alignof(
 	const ast_t  *ast,
 	size_t        level,
 	uint_fast8_t  flags);
+void fprint_ast_alignof_jsonl(
+	FILE         *stream,
+	const ast_t  *ast,
+	ast_jsonl_t  *jsonl);
 
 
 #endif  /* JKCC_AST_ALIGNOF_H */
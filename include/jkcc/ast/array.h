@@ -45,6 +45,10 @@ void fprint_ast_array(
 	const ast_t  *ast,
 	size_t        level,
 	uint_fast8_t  flags);
+void fprint_ast_array_jsonl(
+	FILE         *stream,
+	const ast_t  *ast,
+	ast_jsonl_t  *jsonl);
 
 
 #endif  /* JKCC_AST_ARRAY_H */
@@ -53,11 +53,17 @@ ast_t *ast_assignment_get_lvalue(
 	ast_t         *ast);
 ast_t *ast_assignment_get_rvalue(
 	ast_t         *ast);
+const char *ast_assignment_str(
+	const ast_t   *ast);
 void fprint_ast_assignment(
 	FILE          *stream,
 	const ast_t   *ast,
 	size_t         level,
 	uint_fast8_t   flags);
+void fprint_ast_assignment_jsonl(
+	FILE          *stream,
+	const ast_t   *ast,
+	ast_jsonl_t   *jsonl);
 
 
 #endif  /* JKCC_AST_ASSIGNMENT_H */
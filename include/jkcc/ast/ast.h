@@ -8,6 +8,11 @@
 #define JKCC_AST_AST_H
 
 
+#include <stddef.h>
+
+#include <jkcc/vector.h>
+
+
 typedef enum ast_e {
 	AST_ADDRESSOF,
 	AST_ALIGNAS,
@@ -58,5 +63,19 @@ typedef enum ast_e {
 	AST_NODES_TOTAL,
 } ast_t;
 
+typedef struct ast_jsonl_node_s {
+	const ast_t *ast;
+	const char  *edge;
+	size_t       index;
+	size_t       parent;
+} ast_jsonl_node_t;
+
+typedef struct ast_jsonl_s {
+	vector_t pending;
+	size_t   id;
+	size_t   current;
+	int      error;
+} ast_jsonl_t;
+
 
 #endif  /* JKCC_AST_AST_H */
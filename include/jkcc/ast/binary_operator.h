@@ -60,11 +60,17 @@ uint_fast32_t ast_binary_operator_get_operator(
 	ast_t         *ast);
 ast_t *ast_binary_operator_get_rhs(
 	ast_t         *ast);
+const char *ast_binary_operator_str(
+	const ast_t   *ast);
 void fprint_ast_binary_operator(
 	FILE          *stream,
 	const ast_t   *ast,
 	size_t         level,
 	uint_fast8_t   flags);
+void fprint_ast_binary_operator_jsonl(
+	FILE          *stream,
+	const ast_t   *ast,
+	ast_jsonl_t   *jsonl);
 
 
 #endif  /* JKCC_AST_BINARY_OPERATOR_H */
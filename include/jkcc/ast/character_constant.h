@@ -30,11 +30,17 @@ ast_t *ast_character_constant_init(
 	location_t           *location);
 void ast_character_constant_free(
 	ast_t                *ast);
+const char *ast_character_constant_type_str(
+	const ast_t          *ast);
 void fprint_ast_character_constant(
 	FILE                 *stream,
 	const ast_t          *ast,
 	size_t                level,
 	uint_fast8_t          flags);
+void fprint_ast_character_constant_jsonl(
+	FILE                 *stream,
+	const ast_t          *ast,
+	ast_jsonl_t          *jsonl);
 
 
 #endif  /* JKCC_AST_CHARACTER_CONSTANT_H */
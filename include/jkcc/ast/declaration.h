@@ -50,11 +50,17 @@ uint_fast8_t ast_declaration_get_storage_class(
 	ast_t         *ast);
 ast_t *ast_declaration_get_type(
 	ast_t         *ast);
+const char *ast_declaration_storage_class_str(
+	const ast_t   *ast);
 void fprint_ast_declaration(
 	FILE          *stream,
 	const ast_t   *ast,
 	size_t         level,
 	uint_fast8_t   flags);
+void fprint_ast_declaration_jsonl(
+	FILE          *stream,
+	const ast_t   *ast,
+	ast_jsonl_t   *jsonl);
 
 
 #endif  /* JKCC_AST_DECLARATION_H */
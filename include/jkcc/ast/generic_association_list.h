@@ -41,6 +41,10 @@ void fprint_ast_generic_association_list(
 	const ast_t   *ast,
 	size_t         level,
 	uint_fast8_t   flags);
+void fprint_ast_generic_association_list_jsonl(
+	FILE          *stream,
+	const ast_t   *ast,
+	ast_jsonl_t   *jsonl);
 
 
 #endif  /* JKCC_AST_GENERIC_ASSOCIATION_LIST_H */
@@ -32,11 +32,17 @@ void ast_integer_constant_free(
 	ast_t              *ast);
 const integer_constant_t *ast_integer_constant_get_integer_constant(
 	ast_t              *ast);
+const char *ast_integer_constant_type_str(
+	const ast_t        *ast);
 void fprint_ast_integer_constant(
 	FILE               *stream,
 	const ast_t        *ast,
 	size_t              level,
 	uint_fast8_t        flags);
+void fprint_ast_integer_constant_jsonl(
+	FILE               *stream,
+	const ast_t        *ast,
+	ast_jsonl_t        *jsonl);
 
 
 #endif  /* JKCC_AST_INTEGER_CONSTANT_H */
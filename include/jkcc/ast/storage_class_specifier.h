@@ -37,11 +37,17 @@ ast_t *ast_storage_class_specifier_init(
 	location_t   *location);
 void ast_storage_class_specifier_free(
 	ast_t        *ast);
+const char *ast_storage_class_specifier_str(
+	const ast_t  *ast);
 void fprint_ast_storage_class_specifier(
 	FILE         *stream,
 	const ast_t  *ast,
 	size_t        level,
 	uint_fast8_t  flags);
+void fprint_ast_storage_class_specifier_jsonl(
+	FILE         *stream,
+	const ast_t  *ast,
+	ast_jsonl_t  *jsonl);
 
 
 #endif  /* JKCC_AST_STORAGE_CLASS_SPECIFIER_H */
@@ -30,11 +30,17 @@ ast_t *ast_string_literal_init(
 	location_t       *location);
 void ast_string_literal_free(
 	ast_t            *ast);
+const char *ast_string_literal_encoding_str(
+	const ast_t      *ast);
 void fprint_ast_string_literal(
 	FILE             *stream,
 	const ast_t      *ast,
 	size_t            level,
 	uint_fast8_t      flags);
+void fprint_ast_string_literal_jsonl(
+	FILE             *stream,
+	const ast_t      *ast,
+	ast_jsonl_t      *jsonl);
 
 
 #endif  /* JKCC_AST_STRING_LITERAL_H */
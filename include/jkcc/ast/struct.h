@@ -62,11 +62,17 @@ void ast_struct_set_definition(
 void ast_struct_set_symbol_table(
 	ast_t          *ast,
 	symbol_table_t *members);
+const char *ast_struct_type_str(
+	const ast_t    *ast);
 void fprint_ast_struct(
 	FILE           *stream,
 	const ast_t    *ast,
 	size_t          level,
 	uint_fast8_t    flags);
+void fprint_ast_struct_jsonl(
+	FILE           *stream,
+	const ast_t    *ast,
+	ast_jsonl_t    *jsonl);
 
 
 #endif  /* JKCC_AST_STRUCT_H */
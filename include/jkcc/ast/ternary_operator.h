@@ -34,11 +34,21 @@ ast_t *ast_ternary_operator_init(
 	location_t   *location_end);
 void ast_ternary_operator_free(
 	ast_t        *ast);
+ast_t *ast_ternary_operator_get_condition(
+	ast_t        *ast);
+ast_t *ast_ternary_operator_get_lhs(
+	ast_t        *ast);
+ast_t *ast_ternary_operator_get_rhs(
+	ast_t        *ast);
 void fprint_ast_ternary_operator(
 	FILE         *stream,
 	const ast_t  *ast,
 	size_t        level,
 	uint_fast8_t  flags);
+void fprint_ast_ternary_operator_jsonl(
+	FILE         *stream,
+	const ast_t  *ast,
+	ast_jsonl_t  *jsonl);
 
 
 #endif  /* JKCC_AST_TERNARY_OPERATOR_H */
@@ -39,6 +39,8 @@ ast_t *ast_type_append(
 	ast_t         *specifier,
 	location_t    *location,
 	const char   **error);
+uint_fast16_t ast_type_get_type_specifier(
+	ast_t         *type);
 ast_t *ast_type_init(
 	ast_t         *specifier,
 	location_t    *location);
@@ -49,6 +51,10 @@ void fprint_ast_type(
 	const ast_t   *ast,
 	size_t         level,
 	uint_fast8_t   flags);
+void fprint_ast_type_jsonl(
+	FILE          *stream,
+	const ast_t   *ast,
+	ast_jsonl_t   *jsonl);
 
 
 #endif  /* JKCC_AST_TYPE_H */
@@ -35,11 +35,17 @@ ast_t *ast_type_qualifier_init(
 	location_t   *location);
 void ast_type_qualifier_free(
 	ast_t        *ast);
+const char *ast_type_qualifier_str(
+	const ast_t  *ast);
 void fprint_ast_type_qualifier(
 	FILE         *stream,
 	const ast_t  *ast,
 	size_t        level,
 	uint_fast8_t  flags);
+void fprint_ast_type_qualifier_jsonl(
+	FILE         *stream,
+	const ast_t  *ast,
+	ast_jsonl_t  *jsonl);
 
 
 #endif  /* JKCC_AST_TYPE_QUALIFIER_H */
@@ -44,11 +44,17 @@ ast_t *ast_unary_operator_init(
 	location_t    *location_end);
 void ast_unary_operator_free(
 	ast_t         *ast);
+const char *ast_unary_operator_str(
+	const ast_t   *ast);
 void fprint_ast_unary_operator(
 	FILE          *stream,
 	const ast_t   *ast,
 	size_t         level,
 	uint_fast8_t   flags);
+void fprint_ast_unary_operator_jsonl(
+	FILE          *stream,
+	const ast_t   *ast,
+	ast_jsonl_t   *jsonl);
 
 
 #endif  /* JKCC_AST_UNARY_OPERATOR_H */
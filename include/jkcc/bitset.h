@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * bitset.h -- dense bit-sets
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_BITSET_H
+#define JKCC_BITSET_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define BITSET_WORD_BITS    64
+#define BITSET_VECTOR_WORDS 4  // widest kernel operates on 256 bits
+
+#define BITSET_CLEAR(bitset, bit)                            \
+	((bitset)->word[(bit) / BITSET_WORD_BITS]            \
+		&= ~(UINT64_C(1) << ((bit) % BITSET_WORD_BITS)))
+#define BITSET_SET(bitset, bit)                              \
+	((bitset)->word[(bit) / BITSET_WORD_BITS]            \
+		|= UINT64_C(1) << ((bit) % BITSET_WORD_BITS))
+#define BITSET_TEST(bitset, bit)                             \
+	(((bitset)->word[(bit) / BITSET_WORD_BITS]           \
+		>> ((bit) % BITSET_WORD_BITS)) & 1)
+
+
+typedef enum bitset_kernel_e {
+	BITSET_KERNEL_SCALAR,
+	BITSET_KERNEL_SSE2,
+	BITSET_KERNEL_AVX2,
+	BITSET_KERNELS_TOTAL,
+} bitset_kernel_t;
+
+typedef struct bitset_s {
+	uint64_t *word;
+	size_t    words;  // multiple of BITSET_VECTOR_WORDS
+} bitset_t;
+
+
+void bitset_copy(
+	bitset_t        *dst,
+	const bitset_t  *src);
+bool bitset_diff(
+	bitset_t        *dst,
+	const bitset_t  *src);
+bool bitset_equal(
+	const bitset_t  *lhs,
+	const bitset_t  *rhs);
+void bitset_fill(
+	bitset_t        *bitset);
+void bitset_free(
+	bitset_t        *bitset);
+int bitset_init(
+	bitset_t        *bitset,
+	size_t           bits);
+bool bitset_intersect(
+	bitset_t        *dst,
+	const bitset_t  *src);
+bitset_kernel_t bitset_kernel(
+	void);
+int bitset_kernel_set(
+	bitset_kernel_t  kernel);
+const char *bitset_kernel_str(
+	bitset_kernel_t  kernel);
+bool bitset_transfer(
+	bitset_t        *dst,
+	const bitset_t  *gen,
+	const bitset_t  *src,
+	const bitset_t  *kill);
+bool bitset_union(
+	bitset_t        *dst,
+	const bitset_t  *src);
+void bitset_zero(
+	bitset_t        *bitset);
+
+
+#endif  /* JKCC_BITSET_H */
@@ -8,11 +8,35 @@
 #define JKCC_IR_H
 
 
+#include <jkcc/ir/alias.h>
 #include <jkcc/ir/bb.h>
+#include <jkcc/ir/callgraph.h>
+#include <jkcc/ir/cfg.h>
+#include <jkcc/ir/codegen.h>
+#include <jkcc/ir/copy.h>
+#include <jkcc/ir/dataflow.h>
+#include <jkcc/ir/dce.h>
+#include <jkcc/ir/dse.h>
+#include <jkcc/ir/elf.h>
 #include <jkcc/ir/function.h>
+#include <jkcc/ir/inline.h>
+#include <jkcc/ir/instcombine.h>
+#include <jkcc/ir/interp.h>
 #include <jkcc/ir/ir.h>
+#include <jkcc/ir/iv.h>
+#include <jkcc/ir/jit.h>
+#include <jkcc/ir/liveness.h>
+#include <jkcc/ir/loop.h>
+#include <jkcc/ir/pass.h>
 #include <jkcc/ir/quad.h>
+#include <jkcc/ir/reaching.h>
+#include <jkcc/ir/regalloc.h>
+#include <jkcc/ir/simplify.h>
+#include <jkcc/ir/tail.h>
+#include <jkcc/ir/unroll.h>
+#include <jkcc/ir/vectorize.h>
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -26,9 +50,15 @@ void ir_align_fprint(
 int ir_declaration(
 	ir_context_t            *ir_context,
 	ast_t                   *declaration);
+size_t ir_declaration_size(
+	ast_t                   *declaration,
+	size_t                   cell);
 void ir_extern_declaration_symbol_fprint(
 	FILE                    *stream,
 	ast_t                   *declaration);
+void ir_location_fprint_jsonl(
+	FILE                    *stream,
+	const ir_location_t     *location);
 ir_static_declaration_t *ir_static_declaration_alloc(
 	ir_context_t            *ir_context,
 	ast_t                   *declaration);
@@ -40,9 +70,13 @@ ir_reg_type_t ir_reg_type_gen(
 void ir_reg_type_fprint(
 	FILE                    *stream,
 	ir_reg_type_t            type);
+const char *ir_reg_type_str(
+	ir_reg_type_t            type);
 void ir_static_declaration_symbol_fprint(
 	FILE                    *stream,
 	ir_static_declaration_t *declaration);
+bool ir_type_int(
+	ast_t                   *type);
 ir_unit_t *ir_unit_alloc(
 	void);
 void ir_unit_deinit(
@@ -52,6 +86,9 @@ void ir_unit_free(
 void ir_unit_fprint(
 	FILE                    *stream,
 	ir_unit_t               *ir_unit);
+void ir_unit_fprint_jsonl(
+	FILE                    *stream,
+	ir_unit_t               *ir_unit);
 int ir_unit_gen(
 	ir_unit_t               *ir_unit,
 	ast_t                   *ast);
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * alias.h -- alias analysis
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_ALIAS_H
+#define JKCC_IR_ALIAS_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ht.h>
+
+
+typedef enum ir_alias_result_e {
+	IR_ALIAS_NO,
+	IR_ALIAS_MAY,
+	IR_ALIAS_MUST,
+} ir_alias_result_t;
+
+typedef enum ir_alias_base_e {
+	IR_ALIAS_BASE_NONE,     // a plain value, or no idea where it points
+	IR_ALIAS_BASE_CELL,     // an alloca or parameter cell
+	IR_ALIAS_BASE_STATIC,   // a static declaration or string literal
+	IR_ALIAS_BASE_EXTERN,   // an extern declaration
+	IR_ALIAS_BASE_POINTER,  // whatever a pointer loaded from memory holds
+} ir_alias_base_t;
+
+// where a vreg points: base + offset, or just a value with no base
+typedef struct ir_alias_address_s {
+	ir_alias_base_t base;
+	uintptr_t       object;  // cell, declaration, or the loading vreg
+	int64_t         offset;
+	bool            exact;   // offset is known
+} ir_alias_address_t;
+
+typedef struct ir_alias_s {
+	ir_function_t      *ir_function;
+	size_t              vregs;
+	ir_quad_t         **def;       // per vreg, NULL unless defined once
+	ir_alias_address_t *address;   // per vreg
+	bitset_t            resolved;  // vregs with an address worked out
+	bitset_t            escaped;   // cells whose address got away
+	ht_t                cache;     // quad pair -> result + 1
+	size_t              queries;
+	size_t              hits;
+} ir_alias_t;
+
+
+void ir_alias_free(
+	ir_alias_t      *ir_alias);
+int ir_alias_init(
+	ir_alias_t      *ir_alias,
+	ir_function_t   *ir_function);
+ir_alias_result_t ir_alias_query(
+	ir_alias_t      *ir_alias,
+	const ir_quad_t *lhs,
+	const ir_quad_t *rhs);
+
+
+#endif  /* JKCC_IR_ALIAS_H */
@@ -21,6 +21,7 @@
 #include <jkcc/ir/bb/list.h>
 #include <jkcc/ir/bb/mov.h>
 #include <jkcc/ir/bb/return.h>
+#include <jkcc/ir/bb/select.h>
 #include <jkcc/ir/bb/sizeof.h>
 #include <jkcc/ir/bb/statement.h>
 #include <jkcc/ir/bb/store.h>
@@ -28,6 +29,7 @@
 #include <jkcc/ir/bb/symbol.h>
 #include <jkcc/ir/bb/while.h>
 
+#include <stddef.h>
 #include <stdio.h>
 
 #include <jkcc/ast.h>
@@ -46,6 +48,11 @@ ir_bb_t *ir_bb_alloc(
 void ir_bb_fprint(
 	FILE         *stream,
 	ir_bb_t      *ir_bb);
+void ir_bb_fprint_jsonl(
+	FILE         *stream,
+	ir_bb_t      *ir_bb,
+	size_t        parent,
+	size_t       *id);
 void ir_bb_free(
 	ir_bb_t      *ir_bb);
 int ir_bb_unknown_gen(
@@ -16,6 +16,8 @@
 int ir_bb_mov_gen(
 	ir_context_t *ir_context,
 	ast_t        *ast);
+int ir_bb_mov_reg_gen(
+	ir_context_t *ir_context);
 
 
 #endif  /* JKCC_IR_BB_MOV_H */
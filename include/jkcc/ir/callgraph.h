@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * callgraph.h -- call graph
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_CALLGRAPH_H
+#define JKCC_IR_CALLGRAPH_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stddef.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/vector.h>
+
+
+typedef struct ir_callgraph_s {
+	ir_unit_t *ir_unit;
+	size_t     functions;
+	ht_t       lookup;     // name -> index + 1
+	vector_t  *callee;     // size_t, per function
+	vector_t  *caller;     // size_t, per function
+	size_t    *scc;        // component of each function
+	size_t     sccs;
+	size_t    *order;      // callees before callers, by component
+} ir_callgraph_t;
+
+
+void ir_callgraph_free(
+	ir_callgraph_t  *ir_callgraph);
+int ir_callgraph_init(
+	ir_callgraph_t  *ir_callgraph,
+	ir_unit_t       *ir_unit);
+size_t ir_callgraph_lookup(
+	ir_callgraph_t  *ir_callgraph,
+	const ir_quad_t *ir_quad);
+
+
+#endif  /* JKCC_IR_CALLGRAPH_H */
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * cfg.h -- control-flow graph
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_CFG_H
+#define JKCC_IR_CFG_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stddef.h>
+
+#include <jkcc/vector.h>
+
+
+typedef struct ir_cfg_s {
+	ir_function_t *ir_function;
+	size_t         bbs;
+	vector_t      *succ;       // size_t, per bb
+	vector_t      *pred;       // size_t, per bb
+	size_t        *rpo;        // bbs in reverse postorder
+	size_t        *rpo_index;  // position of a bb in rpo
+} ir_cfg_t;
+
+
+void ir_cfg_free(
+	ir_cfg_t      *ir_cfg);
+int ir_cfg_init(
+	ir_cfg_t      *ir_cfg,
+	ir_function_t *ir_function);
+
+
+#endif  /* JKCC_IR_CFG_H */
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * codegen.h -- x86-64 instruction selection
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_CODEGEN_H
+#define JKCC_IR_CODEGEN_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/vector.h>
+#include <jkcc/x86.h>
+
+
+#define IR_CODEGEN_ARGV_MAX 16
+
+// every alloca, parameter, and global gets a cell this wide
+#define IR_CODEGEN_CELL 8
+
+
+typedef enum ir_codegen_section_e {
+	IR_CODEGEN_SECTION_UNDEF,
+	IR_CODEGEN_SECTION_TEXT,
+	IR_CODEGEN_SECTION_RODATA,  // string literals
+	IR_CODEGEN_SECTION_BSS,     // zero-initialized cells
+	IR_CODEGEN_SECTIONS_TOTAL,
+} ir_codegen_section_t;
+
+// x86-64 psabi semantics, patched as a rel32 at offset
+typedef enum ir_codegen_reloc_type_e {
+	IR_CODEGEN_RELOC_PC32,   // S + A - P
+	IR_CODEGEN_RELOC_PLT32,  // L + A - P
+} ir_codegen_reloc_type_t;
+
+typedef struct ir_codegen_symbol_s {
+	const char           *name;     // NULL for statics and literals
+	ir_codegen_section_t  section;
+	size_t                offset;   // into section
+	size_t                size;
+	bool                  global;
+} ir_codegen_symbol_t;
+
+typedef struct ir_codegen_reloc_s {
+	size_t                   offset;  // into text
+	size_t                   symbol;
+	ir_codegen_reloc_type_t  type;
+	int64_t                  addend;
+} ir_codegen_reloc_t;
+
+typedef struct ir_codegen_s {
+	ir_unit_t *ir_unit;
+	x86_t      text;
+	uint8_t   *rodata;
+	size_t     rodata_size;
+	size_t     bss_size;
+	vector_t   symbol;     // ir_codegen_symbol_t
+	vector_t   reloc;      // ir_codegen_reloc_t, unresolved in text
+	ht_t       lookup;     // name -> symbol index
+} ir_codegen_t;
+
+
+void ir_codegen_free(
+	ir_codegen_t *ir_codegen);
+int ir_codegen_init(
+	ir_codegen_t *ir_codegen,
+	ir_unit_t    *ir_unit);
+ir_codegen_symbol_t *ir_codegen_lookup(
+	ir_codegen_t *ir_codegen,
+	const char   *name);
+
+
+#endif  /* JKCC_IR_CODEGEN_H */
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * copy.h -- copy propagation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_COPY_H
+#define JKCC_IR_COPY_H
+
+
+#include <jkcc/ir/ir.h>
+
+
+int ir_copy_prop_function(
+	ir_function_t *ir_function);
+
+
+#endif  /* JKCC_IR_COPY_H */
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dataflow.h -- bit-vector dataflow analysis
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_DATAFLOW_H
+#define JKCC_IR_DATAFLOW_H
+
+
+#include <jkcc/ir/cfg.h>
+
+#include <stddef.h>
+
+#include <jkcc/bitset.h>
+
+
+typedef enum ir_dataflow_direction_e {
+	IR_DATAFLOW_BACKWARD,
+	IR_DATAFLOW_FORWARD,
+} ir_dataflow_direction_t;
+
+typedef enum ir_dataflow_meet_e {
+	IR_DATAFLOW_INTERSECT,
+	IR_DATAFLOW_UNION,
+} ir_dataflow_meet_t;
+
+typedef struct ir_dataflow_s {
+	const ir_cfg_t          *ir_cfg;
+	ir_dataflow_direction_t  direction;
+	ir_dataflow_meet_t       meet;
+	size_t                   bits;
+	bitset_t                *gen;     // per bb
+	bitset_t                *kill;    // per bb
+	bitset_t                *in;      // per bb
+	bitset_t                *out;     // per bb
+	size_t                   visits;  // transfers until fixpoint
+} ir_dataflow_t;
+
+
+void ir_dataflow_free(
+	ir_dataflow_t           *ir_dataflow);
+int ir_dataflow_init(
+	ir_dataflow_t           *ir_dataflow,
+	const ir_cfg_t          *ir_cfg,
+	ir_dataflow_direction_t  direction,
+	ir_dataflow_meet_t       meet,
+	size_t                   bits);
+int ir_dataflow_solve(
+	ir_dataflow_t           *ir_dataflow);
+
+
+#endif  /* JKCC_IR_DATAFLOW_H */
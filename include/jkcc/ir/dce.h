@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dce.h -- dead quad elimination
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_DCE_H
+#define JKCC_IR_DCE_H
+
+
+#include <jkcc/ir/ir.h>
+
+
+int ir_dce_function(
+	ir_function_t *ir_function);
+int ir_dce_unit(
+	ir_unit_t     *ir_unit);
+
+
+#endif  /* JKCC_IR_DCE_H */
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dse.h -- dead store elimination
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_DSE_H
+#define JKCC_IR_DSE_H
+
+
+#include <jkcc/ir/ir.h>
+
+
+int ir_dse_function(
+	ir_function_t *ir_function);
+
+
+#endif  /* JKCC_IR_DSE_H */
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * elf.h -- elf64 relocatable object writer
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_ELF_H
+#define JKCC_IR_ELF_H
+
+
+#include <jkcc/ir/codegen.h>
+
+#include <stdio.h>
+
+
+int ir_elf_write(
+	FILE         *stream,
+	ir_codegen_t *ir_codegen,
+	const char   *file);
+
+
+#endif  /* JKCC_IR_ELF_H */
@@ -10,20 +10,35 @@
 
 #include <jkcc/ir/ir.h>
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 
 ir_function_t *ir_function_alloc(
 	void);
+void ir_function_argv_reg(
+	ir_function_t *ir_function,
+	size_t         pos,
+	uintptr_t     *reg,
+	ir_reg_type_t *type);
 void ir_function_fprint(
 	FILE          *stream,
 	ir_function_t *ir_function);
+void ir_function_fprint_jsonl(
+	FILE          *stream,
+	ir_function_t *ir_function,
+	size_t        *id);
 void ir_function_free(
 	ir_function_t *ir_function);
 int ir_function_gen(
 	ir_context_t  *ir_context,
 	ir_function_t *ir_function,
 	ast_t         *ast_function);
+const char *ir_function_linkage_str(
+	ir_function_t *ir_function);
+size_t ir_function_vregs(
+	ir_function_t *ir_function);
 
 
 #endif  /* JKCC_IR_FUNCTION_H */
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * inline.h -- function inlining
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_INLINE_H
+#define JKCC_IR_INLINE_H
+
+
+#include <jkcc/ir/ir.h>
+
+
+int ir_inline_unit(
+	ir_unit_t *ir_unit);
+
+
+#endif  /* JKCC_IR_INLINE_H */
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * instcombine.h -- instruction combining
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_INSTCOMBINE_H
+#define JKCC_IR_INSTCOMBINE_H
+
+
+#include <jkcc/ir/ir.h>
+
+
+int ir_instcombine_function(
+	ir_function_t *ir_function);
+
+
+#endif  /* JKCC_IR_INSTCOMBINE_H */
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * interp.h -- ir interpreter
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_INTERP_H
+#define JKCC_IR_INTERP_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/vector.h>
+
+
+#define IR_INTERP_ARGV_MAX  16
+#define IR_INTERP_DEPTH_MAX 4096
+#define IR_INTERP_REGS      (UINT64_C(1) << 20)
+#define IR_INTERP_STACK     (UINT64_C(8) << 20)
+
+// every alloca, parameter, and global gets a cell this wide
+#define IR_INTERP_CELL 8
+
+
+typedef enum ir_interp_op_e {
+	IR_INTERP_OP_ADD32,
+	IR_INTERP_OP_ADD64,
+	IR_INTERP_OP_ALLOCA,
+	IR_INTERP_OP_AND,
+	IR_INTERP_OP_ARG,
+	IR_INTERP_OP_BR_EQ,  // conditional branches follow ir_quad_br_t
+	IR_INTERP_OP_BR_NE,
+	IR_INTERP_OP_BR_HS,
+	IR_INTERP_OP_BR_LO,
+	IR_INTERP_OP_BR_MI,
+	IR_INTERP_OP_BR_PL,
+	IR_INTERP_OP_BR_VS,
+	IR_INTERP_OP_BR_VC,
+	IR_INTERP_OP_BR_HI,
+	IR_INTERP_OP_BR_LS,
+	IR_INTERP_OP_BR_GE,
+	IR_INTERP_OP_BR_LT,
+	IR_INTERP_OP_BR_GT,
+	IR_INTERP_OP_BR_LE,
+	IR_INTERP_OP_CALL,
+	IR_INTERP_OP_CALL_SHIM,
+	IR_INTERP_OP_CMP,
+	IR_INTERP_OP_COPY,
+	IR_INTERP_OP_DIV32,
+	IR_INTERP_OP_DIV64,
+	IR_INTERP_OP_EOR,
+	IR_INTERP_OP_JMP,
+	IR_INTERP_OP_LEA,
+	IR_INTERP_OP_LOAD32,
+	IR_INTERP_OP_LOAD64,
+	IR_INTERP_OP_LSL32,
+	IR_INTERP_OP_LSL64,
+	IR_INTERP_OP_LSR32,
+	IR_INTERP_OP_LSR64,
+	IR_INTERP_OP_MOD32,
+	IR_INTERP_OP_MOD64,
+	IR_INTERP_OP_MOV,
+	IR_INTERP_OP_MUL32,
+	IR_INTERP_OP_MUL64,
+	IR_INTERP_OP_OOR,
+	IR_INTERP_OP_RET,
+	IR_INTERP_OP_RET_VOID,
+	IR_INTERP_OP_SELECT_EQ,  // conditional selects follow ir_quad_br_t
+	IR_INTERP_OP_SELECT_NE,
+	IR_INTERP_OP_SELECT_HS,
+	IR_INTERP_OP_SELECT_LO,
+	IR_INTERP_OP_SELECT_MI,
+	IR_INTERP_OP_SELECT_PL,
+	IR_INTERP_OP_SELECT_VS,
+	IR_INTERP_OP_SELECT_VC,
+	IR_INTERP_OP_SELECT_HI,
+	IR_INTERP_OP_SELECT_LS,
+	IR_INTERP_OP_SELECT_GE,
+	IR_INTERP_OP_SELECT_LT,
+	IR_INTERP_OP_SELECT_GT,
+	IR_INTERP_OP_SELECT_LE,
+	IR_INTERP_OP_STORE32,
+	IR_INTERP_OP_STORE64,
+	IR_INTERP_OP_SUB32,
+	IR_INTERP_OP_SUB64,
+	IR_INTERP_OP_TAIL,
+	IR_INTERP_OP_TRAP,
+	IR_INTERP_OP_VADD,
+	IR_INTERP_OP_VAND,
+	IR_INTERP_OP_VEOR,
+	IR_INTERP_OP_VOOR,
+	IR_INTERP_OP_VSUB,
+	IR_INTERP_OPS_TOTAL,
+} ir_interp_op_t;
+
+typedef enum ir_interp_trap_e {
+	IR_INTERP_TRAP_NONE,
+	IR_INTERP_TRAP_BAD_CALL,
+	IR_INTERP_TRAP_BAD_FORMAT,
+	IR_INTERP_TRAP_DIVIDE_BY_ZERO,
+	IR_INTERP_TRAP_EXIT,
+	IR_INTERP_TRAP_INVALID_LOAD,
+	IR_INTERP_TRAP_INVALID_STORE,
+	IR_INTERP_TRAP_INVALID_STRING,
+	IR_INTERP_TRAP_STACK_OVERFLOW,
+	IR_INTERP_TRAP_UNDEFINED_FUNCTION,
+	IR_INTERP_TRAP_UNSUPPORTED_QUAD,
+	IR_INTERP_TRAPS_TOTAL,
+} ir_interp_trap_t;
+
+typedef struct ir_interp_function_s ir_interp_function_t;
+
+// quads pre-decoded onto dense frame register indices
+typedef struct ir_interp_insn_s {
+	const void *handler;  // set when the function is first entered
+	uint16_t    op;       // ir_interp_op_t
+	uint8_t     quad;     // ir_quad_t it was decoded from
+	uint32_t    dst;
+	uint32_t    lhs;
+	uint32_t    rhs;
+	union {
+		int64_t                  imm;
+		size_t                   target;  // bb position while decoding
+		struct ir_interp_insn_s *jump;
+		ir_interp_function_t    *callee;
+		const char              *symbol;  // of an undefined call
+	};
+} ir_interp_insn_t;
+
+struct ir_interp_function_s {
+	ir_function_t *ir_function;
+	const char    *name;
+	vector_t       insn;     // ir_interp_insn_t
+	vector_t       constant; // int64_t, frame registers past the vregs
+	uint32_t      *argv;     // frame register of each parameter
+	size_t         argc;
+	size_t         regs;     // counting constants
+	size_t         frame;    // bytes of parameters and allocas
+	bool           threaded;
+};
+
+typedef struct ir_interp_s {
+	ir_unit_t            *ir_unit;
+	ir_interp_function_t *function;
+	size_t                functions;
+	ht_t                  lookup;       // name -> ir_interp_function_t*
+	uint8_t              *data;         // globals and string literals
+	size_t                data_size;
+	uint8_t              *stack;
+	size_t                sp;
+	uint64_t             *reg;
+	size_t                rp;
+	size_t                depth;
+	uint64_t              argv[IR_INTERP_ARGV_MAX];
+	FILE                 *stream;       // program output
+	ir_interp_trap_t      trap;
+	const char           *trap_function;
+	const char           *trap_symbol;
+	int64_t               status;       // passed to exit()
+	uint64_t              calls;
+	uint64_t              executed[IR_QUAD_TOTAL];
+} ir_interp_t;
+
+
+void ir_interp_fprint(
+	FILE              *stream,
+	const ir_interp_t *ir_interp);
+void ir_interp_free(
+	ir_interp_t       *ir_interp);
+int ir_interp_init(
+	ir_interp_t       *ir_interp,
+	ir_unit_t         *ir_unit);
+ir_interp_function_t *ir_interp_lookup(
+	ir_interp_t       *ir_interp,
+	const char        *name);
+int ir_interp_run(
+	ir_interp_t       *ir_interp,
+	const char        *name,
+	int64_t           *ret);
+const char *ir_interp_trap_str(
+	ir_interp_trap_t   trap);
+
+
+#endif  /* JKCC_IR_INTERP_H */
@@ -23,6 +23,33 @@
 #define IR_ERROR_UNKNOWN_AST_NODE            (-3)
 #define IR_ERROR_UNIMPLEMENTED_STORAGE_CLASS (-4)
 #define IR_ERROR_EMPTY_FUNCTION_BODY         (-5)
+#define IR_ERROR_REGISTER_PRESSURE           (-6)
+#define IR_ERROR_TRAP                        (-7)
+#define IR_ERROR_UNDEFINED_SYMBOL            (-8)
+#define IR_ERROR_UNSUPPORTED_HOST            (-9)
+#define IR_ERROR_WRITE                       (-10)
+
+// set on registers rewritten onto the machine register file
+#define IR_REG_PHYSICAL    ((UINTPTR_MAX >> 1) + 1)
+#define IR_REG_INDEX(reg)  ((reg) & ~IR_REG_PHYSICAL)
+
+// operands that take a constant in place of a register carry it
+// under this tag, sign-extended from the bit below it
+#define IR_REG_IMMEDIATE      (IR_REG_PHYSICAL >> 1)
+#define IR_REG_IMMEDIATE_MASK (IR_REG_IMMEDIATE - 1)
+
+#define IR_REG_IMMEDIATE_GEN(val) \
+	((((uintptr_t) (val)) & IR_REG_IMMEDIATE_MASK) | IR_REG_IMMEDIATE)
+
+#define IR_REG_IMMEDIATE_VALUE(reg) ((int64_t) ((intptr_t) ((reg) << 2) >> 2))
+
+#define IR_REG_IMMEDIATE_FITS(val) \
+	(IR_REG_IMMEDIATE_VALUE(IR_REG_IMMEDIATE_GEN(val)) == (int64_t) (val))
+
+#define IR_REG_IS_IMMEDIATE(reg) \
+	(((reg) & (IR_REG_PHYSICAL | IR_REG_IMMEDIATE)) == IR_REG_IMMEDIATE)
+
+#define IR_QUAD_REG_USES 3
 
 
 typedef enum ir_reg_type_e {
@@ -39,16 +66,35 @@ typedef enum ir_quad_e {
 	IR_QUAD_CMP,
 	IR_QUAD_LOAD,
 	IR_QUAD_MOV,
+	IR_QUAD_RELOAD,
 	IR_QUAD_RET,
+	IR_QUAD_SELECT,
+	IR_QUAD_SPILL,
 	IR_QUAD_STORE,
+	IR_QUAD_VECTOR,
 	IR_QUAD_TOTAL,
 } ir_quad_t;
 
+typedef struct ir_quad_reg_s {
+	uintptr_t     *def;
+	ir_reg_type_t  type;  // of def
+	uintptr_t     *use[IR_QUAD_REG_USES];  // NULL for an immediate
+	unsigned       immediate;               // bit per use that may be one
+} ir_quad_reg_t;
+
 typedef struct ir_bb_s {
 	size_t   id;
 	vector_t quad;  // ir_quad_t*
 } ir_bb_t;
 
+typedef struct ir_regalloc_s {
+	size_t    registers;
+	size_t    slots;
+	size_t    spills;
+	size_t    reloads;
+	uintptr_t argv[];   // physical register, or spill slot
+} ir_regalloc_t;
+
 typedef struct ir_function_s {
 	ir_reg_type_t  return_type;
 	vector_t      *argv;         // ast_t*
@@ -58,6 +104,7 @@ typedef struct ir_function_s {
 		ht_t lookup;
 		ht_t type;
 	} reg;
+	ir_regalloc_t *regalloc;     // NULL until allocated
 } ir_function_t;
 
 typedef struct ir_static_declaration_s {
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * iv.h -- induction variables
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_IV_H
+#define JKCC_IR_IV_H
+
+
+#include <jkcc/ir/cfg.h>
+#include <jkcc/ir/ir.h>
+#include <jkcc/ir/loop.h>
+#include <jkcc/ir/quad/br.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/vector.h>
+
+
+typedef struct ir_iv_def_s {
+	size_t defs;
+	size_t bb;    // SIZE_MAX unless defined by exactly one quad
+	size_t quad;
+	size_t uses;
+} ir_iv_def_t;
+
+// the frontend keeps variables in frame cells, so a basic iv is a
+// cell whose only store in the loop adds a constant to what it held
+typedef struct ir_iv_basic_s {
+	uintptr_t     cell;
+	ir_reg_type_t type;  // i32, or ptr once strength reduced
+	int64_t       step;
+	size_t        bb;    // of the store
+	size_t        quad;
+	size_t        load;  // position of the load feeding the store
+} ir_iv_basic_t;
+
+// base + basic * scale, as an add of a loop-invariant pointer
+typedef struct ir_iv_derived_s {
+	size_t    basic;
+	int64_t   scale;
+	uintptr_t base;
+	size_t    bb;     // of the add
+	size_t    quad;
+} ir_iv_derived_t;
+
+// an innermost loop whose header only tests a basic iv against
+// something invariant, stepped once on every trip around
+typedef struct ir_iv_counted_s {
+	ir_iv_basic_t          basic;      // the counter
+	ir_quad_br_condition_t condition;  // to go around, counter on the left
+	uintptr_t              counter;    // loaded from the counter
+	uintptr_t              limit;
+	size_t                 enter;      // header succ in the body
+	size_t                 exit;       // header succ outside of it
+} ir_iv_counted_t;
+
+typedef struct ir_iv_s {
+	ir_function_t   *ir_function;
+	const ir_loop_t *ir_loop;
+	size_t           vregs;
+	ir_iv_def_t     *def;      // per vreg
+	bitset_t         private;  // cells only ever loaded or stored
+	bitset_t         stored;   // cells stored in the loop
+	vector_t         basic;    // ir_iv_basic_t
+	vector_t         derived;  // ir_iv_derived_t
+} ir_iv_t;
+
+
+bool ir_iv_constant(
+	const ir_iv_t        *ir_iv,
+	uintptr_t             reg,
+	int64_t              *value);
+bool ir_iv_counted(
+	const ir_iv_t        *ir_iv,
+	const ir_cfg_t       *ir_cfg,
+	const ir_loop_nest_t *ir_loop_nest,
+	ir_iv_counted_t      *counted);
+void ir_iv_free(
+	ir_iv_t              *ir_iv);
+int ir_iv_init(
+	ir_iv_t              *ir_iv,
+	ir_function_t        *ir_function,
+	const ir_loop_t      *ir_loop);
+bool ir_iv_invariant(
+	const ir_iv_t        *ir_iv,
+	uintptr_t             reg);
+size_t ir_iv_lookup(
+	const ir_iv_t        *ir_iv,
+	uintptr_t             reg);
+int ir_strength_reduce_function(
+	ir_function_t        *ir_function);
+
+
+#endif  /* JKCC_IR_IV_H */
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * jit.h -- in-memory x86-64 loader
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_JIT_H
+#define JKCC_IR_JIT_H
+
+
+#include <jkcc/ir/codegen.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// jmp *0(%rip) followed by the absolute address, padded
+#define IR_JIT_STUB 16
+
+
+typedef struct ir_jit_s {
+	ir_codegen_t *ir_codegen;
+	uint8_t      *mem;        // text and stubs, rodata, bss; page aligned
+	size_t        size;
+	uint8_t      *text;
+	uint8_t      *stub;
+	size_t        stubs;
+	uint8_t      *rodata;
+	uint8_t      *bss;
+	void         *dl;         // handle searched for undefined symbols
+	const char   *undefined;  // the symbol that failed to resolve
+} ir_jit_t;
+
+
+void ir_jit_free(
+	ir_jit_t     *ir_jit);
+int ir_jit_init(
+	ir_jit_t     *ir_jit,
+	ir_codegen_t *ir_codegen);
+int ir_jit_run(
+	ir_jit_t     *ir_jit,
+	const char   *name,
+	int64_t      *ret);
+
+
+#endif  /* JKCC_IR_JIT_H */
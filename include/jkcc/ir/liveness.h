@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * liveness.h -- live virtual registers
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_LIVENESS_H
+#define JKCC_IR_LIVENESS_H
+
+
+#include <jkcc/ir/cfg.h>
+#include <jkcc/ir/dataflow.h>
+
+#include <stddef.h>
+
+
+typedef struct ir_liveness_s {
+	ir_dataflow_t dataflow;  // in is live-in, out is live-out
+	size_t        vregs;
+} ir_liveness_t;
+
+
+void ir_liveness_free(
+	ir_liveness_t  *ir_liveness);
+int ir_liveness_init(
+	ir_liveness_t  *ir_liveness,
+	const ir_cfg_t *ir_cfg);
+
+
+#endif  /* JKCC_IR_LIVENESS_H */
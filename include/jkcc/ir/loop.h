@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * loop.h -- dominators and natural loops
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_LOOP_H
+#define JKCC_IR_LOOP_H
+
+
+#include <jkcc/ir/cfg.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/vector.h>
+
+
+typedef struct ir_loop_s {
+	size_t   header;     // bb index
+	size_t   preheader;  // SIZE_MAX without a dedicated one
+	bitset_t body;       // bb indices, the header included
+	size_t   bbs;        // in body
+} ir_loop_t;
+
+typedef struct ir_loop_nest_s {
+	const ir_cfg_t *ir_cfg;
+	size_t         *idom;  // SIZE_MAX when unreachable
+	vector_t        loop;  // ir_loop_t, inner loops first
+} ir_loop_nest_t;
+
+
+bool ir_loop_dominates(
+	const ir_loop_nest_t *ir_loop_nest,
+	size_t                dominator,
+	size_t                bb);
+void ir_loop_nest_free(
+	ir_loop_nest_t       *ir_loop_nest);
+int ir_loop_nest_init(
+	ir_loop_nest_t       *ir_loop_nest,
+	const ir_cfg_t       *ir_cfg);
+
+
+#endif  /* JKCC_IR_LOOP_H */
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * pass.h -- ir pass manager
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_PASS_H
+#define JKCC_IR_PASS_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <jkcc/sched.h>
+
+
+#define IR_PASS_LEVEL_MAX    2
+#define IR_PASS_PIPELINE_MAX 32
+
+
+typedef enum ir_pass_id_e {
+	IR_PASS_COPY_PROP,
+	IR_PASS_DCE,
+	IR_PASS_DSE,
+	IR_PASS_GLOBAL_DCE,
+	IR_PASS_INLINE,
+	IR_PASS_INSTCOMBINE,
+	IR_PASS_SIMPLIFY_CFG,
+	IR_PASS_STRENGTH_REDUCE,
+	IR_PASS_TAIL_CALL,
+	IR_PASS_UNROLL,
+	IR_PASS_VECTORIZE,
+	IR_PASSES_TOTAL,
+} ir_pass_id_t;
+
+typedef enum ir_pass_kind_e {
+	IR_PASS_KIND_FUNCTION,
+	IR_PASS_KIND_UNIT,
+} ir_pass_kind_t;
+
+// passes work on cells and vregs, so neither entry point may be
+// handed ir that has been through regalloc; ir_pass_manager_run()
+// leaves such a unit alone, direct callers have to check themselves
+typedef struct ir_pass_s {
+	const char     *name;
+	ir_pass_kind_t  kind;
+	union {
+		int (*function)(ir_function_t *ir_function);
+		int (*unit)(ir_unit_t *ir_unit);
+	};
+} ir_pass_t;
+
+// removed counts go negative for passes that grow the ir,
+// ns is summed over every worker
+typedef struct ir_pass_stat_s {
+	size_t   runs;
+	uint64_t ns;
+	int64_t  quads;
+	int64_t  bbs;
+} ir_pass_stat_t;
+
+typedef struct ir_pass_manager_s {
+	ir_pass_id_t   pipeline[IR_PASS_PIPELINE_MAX];
+	size_t         passes;
+	sched_t       *sched;    // runs function passes, NULL is serial
+	ir_pass_stat_t stat[IR_PASSES_TOTAL];
+} ir_pass_manager_t;
+
+
+extern const ir_pass_t ir_pass[IR_PASSES_TOTAL];
+
+
+ir_pass_id_t ir_pass_lookup(
+	const char              *name);
+void ir_pass_manager_fprint(
+	FILE                    *stream,
+	const ir_pass_manager_t *ir_pass_manager);
+void ir_pass_manager_init(
+	ir_pass_manager_t       *ir_pass_manager,
+	unsigned                 level);
+int ir_pass_manager_parse(
+	ir_pass_manager_t       *ir_pass_manager,
+	const char              *list);
+int ir_pass_manager_run(
+	ir_pass_manager_t       *ir_pass_manager,
+	ir_unit_t               *ir_unit);
+
+
+#endif  /* JKCC_IR_PASS_H */
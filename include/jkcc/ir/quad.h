@@ -16,23 +16,55 @@
 #include <jkcc/ir/quad/cmp.h>
 #include <jkcc/ir/quad/load.h>
 #include <jkcc/ir/quad/mov.h>
+#include <jkcc/ir/quad/reload.h>
 #include <jkcc/ir/quad/ret.h>
+#include <jkcc/ir/quad/select.h>
+#include <jkcc/ir/quad/spill.h>
 #include <jkcc/ir/quad/store.h>
+#include <jkcc/ir/quad/vector.h>
 
 #include <stdint.h>
 #include <stdio.h>
 
 
+#define IR_QUAD_CLONE(clone, ir_quad) ir_quad_clone[*ir_quad](clone, ir_quad)
+
 #define IR_QUAD_FPRINT(stream, ir_quad) if (ir_quad) ir_quad_fprint[*ir_quad]( \
 	stream,                                                                \
 	ir_quad)
 
+#define IR_QUAD_FPRINT_JSONL(stream, ir_quad) if (ir_quad) ir_quad_fprint_jsonl[*ir_quad]( \
+	stream,                                                                            \
+	ir_quad)
+
+#define IR_QUAD_FREE(ir_quad) if (ir_quad) ir_quad_free[*ir_quad](ir_quad)
+
+#define IR_QUAD_REG(ir_quad, reg) ir_quad_reg[*ir_quad](ir_quad, reg)
+
+#define IR_QUAD_STR(ir_quad) ir_quad_str[*ir_quad]
+
 #define OFFSETOF_IR_QUAD(quad, type) ((type*) (((uintptr_t) quad) - offsetof(type, ir_quad)))
 
 
+extern int (*const ir_quad_clone[IR_QUAD_TOTAL])(
+	ir_quad_t **clone,
+	ir_quad_t  *ir_quad);
+
 extern void (*const ir_quad_fprint[IR_QUAD_TOTAL])(
 	FILE      *stream,
 	ir_quad_t *ir_quad);
 
+extern void (*const ir_quad_fprint_jsonl[IR_QUAD_TOTAL])(
+	FILE      *stream,
+	ir_quad_t *ir_quad);
+
+extern void (*const ir_quad_free[IR_QUAD_TOTAL])(ir_quad_t *ir_quad);
+
+extern void (*const ir_quad_reg[IR_QUAD_TOTAL])(
+	ir_quad_t     *ir_quad,
+	ir_quad_reg_t *reg);
+
+extern const char *const ir_quad_str[IR_QUAD_TOTAL];
+
 
 #endif  /* JKCC_IR_QUAD_H */
@@ -22,13 +22,24 @@ typedef struct ir_quad_alloc_s {
 } ir_quad_alloca_t;
 
 
+int ir_quad_alloca_clone(
+	ir_quad_t    **clone,
+	ir_quad_t     *ir_quad);
 void ir_quad_alloca_fprint(
 	FILE          *stream,
 	ir_quad_t     *ir_quad);
+void ir_quad_alloca_fprint_jsonl(
+	FILE          *stream,
+	ir_quad_t     *ir_quad);
+void ir_quad_alloca_free(
+	ir_quad_t     *ir_quad);
 int ir_quad_alloca_gen(
 	ir_quad_t    **ir_quad,
 	uintptr_t      dst,
 	ir_reg_type_t  type);
+void ir_quad_alloca_reg(
+	ir_quad_t     *ir_quad,
+	ir_quad_reg_t *reg);
 
 
 #endif  /* JKCC_IR_QUAD_ALLOCA_H */
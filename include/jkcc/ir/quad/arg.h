@@ -23,14 +23,25 @@ typedef struct ir_quad_arg_s {
 } ir_quad_arg_t;
 
 
+int ir_quad_arg_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
 void ir_quad_arg_fprint(
 	FILE           *stream,
 	ir_quad_t      *ir_quad);
+void ir_quad_arg_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_arg_free(
+	ir_quad_t      *ir_quad);
 int ir_quad_arg_gen(
 	ir_quad_t     **ir_quad,
 	size_t          pos,
 	uintptr_t       src,
 	ir_reg_type_t   type);
+void ir_quad_arg_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
 
 
 #endif  /* JKCC_IR_QUAD_ARG_H */
@@ -38,9 +38,17 @@ typedef struct ir_quad_binop_s {
 } ir_quad_binop_t;
 
 
+int ir_quad_binop_clone(
+	ir_quad_t          **clone,
+	ir_quad_t           *ir_quad);
 void ir_quad_binop_fprint(
 	FILE                *stream,
 	ir_quad_t           *ir_quad);
+void ir_quad_binop_fprint_jsonl(
+	FILE                *stream,
+	ir_quad_t           *ir_quad);
+void ir_quad_binop_free(
+	ir_quad_t           *ir_quad);
 int ir_quad_binop_gen(
 	ir_quad_t          **ir_quad,
 	uintptr_t            dst,
@@ -48,6 +56,11 @@ int ir_quad_binop_gen(
 	ir_reg_type_t        type,
 	uintptr_t            lhs,
 	uintptr_t            rhs);
+const char *ir_quad_binop_op_str(
+	ir_quad_binop_op_t   op);
+void ir_quad_binop_reg(
+	ir_quad_t           *ir_quad,
+	ir_quad_reg_t       *reg);
 
 
 #endif  /* JKCC_IR_QUAD_BINOP_H */
@@ -40,13 +40,26 @@ typedef struct ir_quad_br_s {
 } ir_quad_br_t;
 
 
+int ir_quad_br_clone(
+	ir_quad_t              **clone,
+	ir_quad_t               *ir_quad);
 void ir_quad_br_fprint(
 	FILE                    *stream,
 	ir_quad_t               *ir_quad);
+void ir_quad_br_fprint_jsonl(
+	FILE                    *stream,
+	ir_quad_t               *ir_quad);
+void ir_quad_br_free(
+	ir_quad_t               *ir_quad);
 int ir_quad_br_gen(
 	ir_quad_t              **ir_quad,
 	ir_quad_br_condition_t   condition,
 	size_t                   bb);
+const char *ir_quad_br_condition_str(
+	ir_quad_br_condition_t   condition);
+void ir_quad_br_reg(
+	ir_quad_t               *ir_quad,
+	ir_quad_reg_t           *reg);
 
 
 #endif  /* JKCC_IR_QUAD_BR_H */
@@ -10,6 +10,7 @@
 
 #include <jkcc/ir/ir.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -18,18 +19,30 @@ typedef struct ir_quad_call_s {
 	uintptr_t     dst;
 	ir_reg_type_t type;
 	ir_location_t src;
+	bool          tail;     // its result is returned as is
 	ir_quad_t     ir_quad;
 } ir_quad_call_t;
 
 
+int ir_quad_call_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
 void ir_quad_call_fprint(
 	FILE           *stream,
 	ir_quad_t      *ir_quad);
+void ir_quad_call_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_call_free(
+	ir_quad_t      *ir_quad);
 int ir_quad_call_gen(
 	ir_quad_t     **ir_quad,
 	uintptr_t       dst,
 	ir_reg_type_t   type,
 	ir_location_t  *src);
+void ir_quad_call_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
 
 
 #endif  /* JKCC_IR_QUAD_CALL_H */
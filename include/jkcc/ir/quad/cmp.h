@@ -21,13 +21,24 @@ typedef struct ir_quad_cmp_s {
 } ir_quad_cmp_t;
 
 
+int ir_quad_cmp_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
 void ir_quad_cmp_fprint(
-	FILE       *stream,
-	ir_quad_t  *ir_quad);
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_cmp_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_cmp_free(
+	ir_quad_t      *ir_quad);
 int ir_quad_cmp_gen(
-	ir_quad_t **ir_quad,
-	uintptr_t   lhs,
-	uintptr_t   rhs);
+	ir_quad_t     **ir_quad,
+	uintptr_t       lhs,
+	uintptr_t       rhs);
+void ir_quad_cmp_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
 
 
 #endif  /* JKCC_IR_QUAD_CMP_H */
@@ -24,14 +24,25 @@ typedef struct ir_quad_load_s {
 } ir_quad_load_t;
 
 
+int ir_quad_load_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
 void ir_quad_load_fprint(
 	FILE           *stream,
 	ir_quad_t      *ir_quad);
+void ir_quad_load_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_load_free(
+	ir_quad_t      *ir_quad);
 int ir_quad_load_gen(
 	ir_quad_t     **ir_quad,
 	uintptr_t       dst,
 	ir_reg_type_t   type,
 	ir_location_t  *src);
+void ir_quad_load_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
 
 
 #endif  /* JKCC_IR_QUAD_LOAD_H */
@@ -24,14 +24,25 @@ typedef struct ir_quad_mov_s {
 } ir_quad_mov_t;
 
 
+int ir_quad_mov_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
 void ir_quad_mov_fprint(
 	FILE           *stream,
 	ir_quad_t      *ir_quad);
+void ir_quad_mov_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_mov_free(
+	ir_quad_t      *ir_quad);
 int ir_quad_mov_gen(
 	ir_quad_t     **ir_quad,
 	uintptr_t       dst,
 	ir_reg_type_t   type,
 	uintptr_t       immediate);
+void ir_quad_mov_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
 
 
 #endif  /* JKCC_IR_QUAD_MOV_H */
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * reload.h -- reload quad
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_QUAD_RELOAD_H
+#define JKCC_IR_QUAD_RELOAD_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+typedef struct ir_quad_reload_s {
+	uintptr_t     dst;
+	ir_reg_type_t type;
+	size_t        slot;
+	ir_quad_t     ir_quad;
+} ir_quad_reload_t;
+
+
+int ir_quad_reload_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
+void ir_quad_reload_fprint(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_reload_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_reload_free(
+	ir_quad_t      *ir_quad);
+int ir_quad_reload_gen(
+	ir_quad_t     **ir_quad,
+	uintptr_t       dst,
+	ir_reg_type_t   type,
+	size_t          slot);
+void ir_quad_reload_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
+
+
+#endif  /* JKCC_IR_QUAD_RELOAD_H */
@@ -21,13 +21,24 @@ typedef struct ir_quad_ret_s {
 } ir_quad_ret_t;
 
 
+int ir_quad_ret_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
 void ir_quad_ret_fprint(
 	FILE           *stream,
 	ir_quad_t      *ir_quad);
+void ir_quad_ret_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_ret_free(
+	ir_quad_t      *ir_quad);
 int ir_quad_ret_gen(
 	ir_quad_t     **ir_quad,
 	ir_reg_type_t   type,
 	uintptr_t       src);
+void ir_quad_ret_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
 
 
 #endif  /* JKCC_IR_QUAD_RET_H */
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * select.h -- select quad
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_QUAD_SELECT_H
+#define JKCC_IR_QUAD_SELECT_H
+
+
+#include <jkcc/ir/ir.h>
+#include <jkcc/ir/quad/br.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+
+// reads the flags of the last cmp as a branch would, lhs when the
+// condition holds and rhs when it does not
+typedef struct ir_quad_select_s {
+	uintptr_t              dst;
+	ir_quad_br_condition_t condition;
+	ir_reg_type_t          type;
+	uintptr_t              lhs;
+	uintptr_t              rhs;
+	ir_quad_t              ir_quad;
+} ir_quad_select_t;
+
+
+int ir_quad_select_clone(
+	ir_quad_t              **clone,
+	ir_quad_t               *ir_quad);
+void ir_quad_select_fprint(
+	FILE                    *stream,
+	ir_quad_t               *ir_quad);
+void ir_quad_select_fprint_jsonl(
+	FILE                    *stream,
+	ir_quad_t               *ir_quad);
+void ir_quad_select_free(
+	ir_quad_t               *ir_quad);
+int ir_quad_select_gen(
+	ir_quad_t              **ir_quad,
+	uintptr_t                dst,
+	ir_quad_br_condition_t   condition,
+	ir_reg_type_t            type,
+	uintptr_t                lhs,
+	uintptr_t                rhs);
+void ir_quad_select_reg(
+	ir_quad_t               *ir_quad,
+	ir_quad_reg_t           *reg);
+
+
+#endif  /* JKCC_IR_QUAD_SELECT_H */
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * spill.h -- spill quad
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_QUAD_SPILL_H
+#define JKCC_IR_QUAD_SPILL_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+typedef struct ir_quad_spill_s {
+	ir_reg_type_t type;
+	uintptr_t     src;
+	size_t        slot;
+	ir_quad_t     ir_quad;
+} ir_quad_spill_t;
+
+
+int ir_quad_spill_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
+void ir_quad_spill_fprint(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_spill_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_spill_free(
+	ir_quad_t      *ir_quad);
+int ir_quad_spill_gen(
+	ir_quad_t     **ir_quad,
+	ir_reg_type_t   type,
+	uintptr_t       src,
+	size_t          slot);
+void ir_quad_spill_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
+
+
+#endif  /* JKCC_IR_QUAD_SPILL_H */
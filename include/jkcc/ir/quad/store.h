@@ -24,14 +24,25 @@ typedef struct ir_quad_store_s {
 } ir_quad_store_t;
 
 
+int ir_quad_store_clone(
+	ir_quad_t     **clone,
+	ir_quad_t      *ir_quad);
 void ir_quad_store_fprint(
 	FILE           *stream,
 	ir_quad_t      *ir_quad);
+void ir_quad_store_fprint_jsonl(
+	FILE           *stream,
+	ir_quad_t      *ir_quad);
+void ir_quad_store_free(
+	ir_quad_t      *ir_quad);
 int ir_quad_store_gen(
 	ir_quad_t     **ir_quad,
 	uintptr_t       src,
 	ir_reg_type_t   type,
 	uintptr_t       dst);
+void ir_quad_store_reg(
+	ir_quad_t      *ir_quad,
+	ir_quad_reg_t  *reg);
 
 
 #endif  /* JKCC_IR_QUAD_STORE_H */
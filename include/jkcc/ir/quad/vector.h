@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * vector.h -- vector quad
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_QUAD_VECTOR_H
+#define JKCC_IR_QUAD_VECTOR_H
+
+
+#include <jkcc/ir/ir.h>
+#include <jkcc/ir/quad/binop.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+#define IR_QUAD_VECTOR_LANES_MAX 8
+
+
+// lanes consecutive elements of type are read from lhs and rhs and
+// combined into dst, every lane read before any is written
+typedef struct ir_quad_vector_s {
+	ir_quad_binop_op_t op;
+	ir_reg_type_t      type;   // of each lane
+	size_t             lanes;
+	uintptr_t          dst;    // addresses of the first lane
+	uintptr_t          lhs;
+	uintptr_t          rhs;
+	ir_quad_t          ir_quad;
+} ir_quad_vector_t;
+
+
+int ir_quad_vector_clone(
+	ir_quad_t          **clone,
+	ir_quad_t           *ir_quad);
+void ir_quad_vector_fprint(
+	FILE                *stream,
+	ir_quad_t           *ir_quad);
+void ir_quad_vector_fprint_jsonl(
+	FILE                *stream,
+	ir_quad_t           *ir_quad);
+void ir_quad_vector_free(
+	ir_quad_t           *ir_quad);
+int ir_quad_vector_gen(
+	ir_quad_t          **ir_quad,
+	ir_quad_binop_op_t   op,
+	ir_reg_type_t        type,
+	size_t               lanes,
+	uintptr_t            dst,
+	uintptr_t            lhs,
+	uintptr_t            rhs);
+void ir_quad_vector_reg(
+	ir_quad_t           *ir_quad,
+	ir_quad_reg_t       *reg);
+
+
+#endif  /* JKCC_IR_QUAD_VECTOR_H */
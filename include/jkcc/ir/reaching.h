@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * reaching.h -- reaching definitions
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_REACHING_H
+#define JKCC_IR_REACHING_H
+
+
+#include <jkcc/ir/cfg.h>
+#include <jkcc/ir/dataflow.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/vector.h>
+
+
+#define IR_REACHING_PARAMETER SIZE_MAX
+
+
+typedef struct ir_reaching_def_s {
+	size_t    bb;
+	size_t    quad;  // IR_REACHING_PARAMETER when defined on entry
+	uintptr_t vreg;
+} ir_reaching_def_t;
+
+typedef struct ir_reaching_s {
+	ir_dataflow_t  dataflow;  // bits index def
+	vector_t       def;       // ir_reaching_def_t
+	size_t         vregs;
+	size_t        *first;     // first def of a vreg
+	size_t        *next;      // next def of the same vreg
+} ir_reaching_t;
+
+
+void ir_reaching_free(
+	ir_reaching_t  *ir_reaching);
+int ir_reaching_init(
+	ir_reaching_t  *ir_reaching,
+	const ir_cfg_t *ir_cfg);
+
+
+#endif  /* JKCC_IR_REACHING_H */
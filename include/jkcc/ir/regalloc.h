@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * regalloc.h -- linear-scan register allocation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_REGALLOC_H
+#define JKCC_IR_REGALLOC_H
+
+
+#include <jkcc/ir/ir.h>
+
+#include <stddef.h>
+#include <stdio.h>
+
+
+void ir_regalloc_fprint(
+	FILE          *stream,
+	ir_function_t *ir_function);
+void ir_regalloc_fprint_jsonl(
+	FILE          *stream,
+	ir_function_t *ir_function);
+int ir_regalloc_function(
+	ir_function_t *ir_function,
+	size_t         registers);
+int ir_regalloc_unit(
+	ir_unit_t     *ir_unit,
+	size_t         registers);
+
+
+#endif  /* JKCC_IR_REGALLOC_H */
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * unroll.h -- loop unrolling
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_UNROLL_H
+#define JKCC_IR_UNROLL_H
+
+
+#include <jkcc/ir/ir.h>
+
+
+int ir_unroll_unit(
+	ir_unit_t *ir_unit);
+
+
+#endif  /* JKCC_IR_UNROLL_H */
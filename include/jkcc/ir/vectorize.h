@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * vectorize.h -- loop vectorization
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_IR_VECTORIZE_H
+#define JKCC_IR_VECTORIZE_H
+
+
+#include <jkcc/ir/ir.h>
+
+
+int ir_vectorize_unit(
+	ir_unit_t *ir_unit);
+
+
+#endif  /* JKCC_IR_VECTORIZE_H */
@@ -10,6 +10,9 @@
 
 #include <stddef.h>
 
+#include <jkcc/ir/pass.h>
+#include <jkcc/perf.h>
+#include <jkcc/sched.h>
 #include <jkcc/trace.h>
 #include <jkcc/vector.h>
 
@@ -18,18 +21,37 @@ typedef struct jkcc_config_s {
 	unsigned ansi_sgr_stdout : 1;
 	unsigned ansi_sgr_stderr : 1;
 	unsigned clean_exit      : 1;
+	unsigned compile         : 1;
+	unsigned interpret       : 1;
+	unsigned mem_report      : 1;
+	unsigned pass_stats      : 1;
+	unsigned perf_counters   : 1;
 	unsigned print_ast       : 1;
+	unsigned print_ast_jsonl : 1;
 	unsigned print_ir        : 1;
+	unsigned print_ir_jsonl  : 1;
+	unsigned run             : 1;
 	unsigned trace           : 1;
+	unsigned trace_sites     : 1;
 } jkcc_config_t;
 
 typedef struct jkcc_s {
-	const char    **file;
-	size_t          file_count;
-	vector_t        translation_unit;  // ast_t*
-	vector_t        ir_unit;           // ir_unit_t*
-	trace_t         trace;
-	jkcc_config_t   config;
+	const char        **file;
+	size_t              file_count;
+	vector_t            translation_unit;  // ast_t*
+	vector_t            ir_unit;           // ir_unit_t*
+	vector_t            perf_sample;       // perf_sample_t
+	perf_t              perf;
+	const char         *output;            // of -c, NULL derives it
+	size_t              jobs;              // of -j, 0 runs serially
+	sched_t             sched;
+	unsigned            opt_level;
+	const char         *passes;            // of -f pass=, over -O
+	ir_pass_manager_t   pass_manager;
+	size_t              registers;         // 0 skips allocation
+	trace_t             trace;
+	const char         *trace_binary;
+	jkcc_config_t       config;
 } jkcc_t;
 
 
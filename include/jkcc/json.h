@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * json.h -- json output helpers
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_JSON_H
+#define JKCC_JSON_H
+
+
+#include <stdio.h>
+
+
+void fprint_json_string(FILE *stream, const char *str);
+
+
+#endif  /* JKCC_JSON_H */
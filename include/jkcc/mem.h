@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * mem.h -- tagged memory allocation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_MEM_H
+#define JKCC_MEM_H
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jkcc/config.h>
+
+
+#define MEM_KINDS_MAX 64
+
+#ifdef JKCC_CONFIG_OPTION_MEM_CENSUS
+#define MEM_CALLOC(tag, kind, nmemb, size) mem_calloc(tag, kind, nmemb, size)
+#define MEM_FREE(ptr)                      mem_free(ptr)
+#define MEM_MALLOC(tag, kind, size)        mem_malloc(tag, kind, size)
+#define MEM_REALLOC(tag, kind, ptr, size)  mem_realloc(tag, kind, ptr, size)
+#define MEM_STRDUP(tag, kind, str)         mem_strdup(tag, kind, str)
+#else
+#define MEM_CALLOC(tag, kind, nmemb, size) calloc(nmemb, size)
+#define MEM_FREE(ptr)                      free(ptr)
+#define MEM_MALLOC(tag, kind, size)        malloc(size)
+#define MEM_REALLOC(tag, kind, ptr, size)  realloc(ptr, size)
+#define MEM_STRDUP(tag, kind, str)         strdup(str)
+#endif  /* JKCC_CONFIG_OPTION_MEM_CENSUS */
+
+
+typedef enum mem_tag_e {
+	MEM_TAG_AST,      // kind is ast_node_type_t
+	MEM_TAG_BITSET,
+	MEM_TAG_HT,       // kind is mem_ht_t
+	MEM_TAG_IR,       // kind is mem_ir_t
+	MEM_TAG_IR_QUAD,  // kind is ir_quad_t
+	MEM_TAG_PARSER,
+	MEM_TAG_SCHED,    // kind is mem_sched_t
+	MEM_TAG_SCOPE,
+	MEM_TAG_STRING,
+	MEM_TAG_SYMBOL,
+	MEM_TAG_VECTOR,
+	MEM_TAG_X86,
+	MEM_TAGS_TOTAL,
+} mem_tag_t;
+
+typedef enum mem_ht_e {
+	MEM_HT_ENTRIES,
+	MEM_HT_KEY,
+	MEM_HT_TOTAL,
+} mem_ht_t;
+
+typedef enum mem_ir_e {
+	MEM_IR_ALIAS,
+	MEM_IR_BB,
+	MEM_IR_CALLGRAPH,
+	MEM_IR_CFG,
+	MEM_IR_CODEGEN,
+	MEM_IR_DATAFLOW,
+	MEM_IR_ELF,
+	MEM_IR_FUNCTION,
+	MEM_IR_INTERP,
+	MEM_IR_JIT,
+	MEM_IR_LOOP,
+	MEM_IR_PASS,
+	MEM_IR_REGALLOC,
+	MEM_IR_STATIC_DECLARATION,
+	MEM_IR_UNIT,
+	MEM_IR_TOTAL,
+} mem_ir_t;
+
+typedef enum mem_sched_e {
+	MEM_SCHED_ARENA,
+	MEM_SCHED_DEQUE,
+	MEM_SCHED_WORKER,
+	MEM_SCHED_TOTAL,
+} mem_sched_t;
+
+
+void *mem_calloc(
+	mem_tag_t   tag,
+	unsigned    kind,
+	size_t      nmemb,
+	size_t      size);
+void  mem_free(
+	void       *ptr);
+void *mem_malloc(
+	mem_tag_t   tag,
+	unsigned    kind,
+	size_t      size);
+void *mem_realloc(
+	mem_tag_t   tag,
+	unsigned    kind,
+	void       *ptr,
+	size_t      size);
+void  mem_report(
+	FILE              *stream,
+	const char *const *const kind_str[MEM_TAGS_TOTAL]);
+char *mem_strdup(
+	mem_tag_t   tag,
+	unsigned    kind,
+	const char *str);
+
+
+#endif  /* JKCC_MEM_H */
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * perf.h -- hardware performance counters
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PERF_H
+#define JKCC_PERF_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+typedef enum perf_counter_e {
+	PERF_COUNTER_CYCLES,
+	PERF_COUNTER_INSTRUCTIONS,
+	PERF_COUNTER_CACHE_MISSES,
+	PERF_COUNTER_BRANCH_MISSES,
+	PERF_COUNTERS_TOTAL,
+} perf_counter_t;
+
+typedef enum perf_phase_e {
+	PERF_PHASE_PARSE,
+	PERF_PHASE_IR_GEN,
+	PERF_PHASE_OPT,
+	PERF_PHASE_REGALLOC,
+	PERF_PHASE_INTERP,
+	PERF_PHASE_JIT,
+	PERF_PHASE_EMIT,
+	PERF_PHASE_PRINT,
+	PERF_PHASES_TOTAL,
+} perf_phase_t;
+
+typedef struct perf_s {
+	bool     enabled;
+	int      fd[PERF_COUNTERS_TOTAL];
+	uint64_t start[PERF_COUNTERS_TOTAL];
+} perf_t;
+
+typedef struct perf_sample_s {
+	uint64_t value[PERF_PHASES_TOTAL][PERF_COUNTERS_TOTAL];
+} perf_sample_t;
+
+
+void perf_begin(perf_t *perf);
+void perf_close(perf_t *perf);
+void perf_end(perf_t *perf, perf_sample_t *sample, perf_phase_t phase);
+int  perf_open(perf_t *perf);
+void perf_sample_fprint(
+	FILE                *stream,
+	const perf_t        *perf,
+	const perf_sample_t *sample,
+	const char          *name);
+
+
+#endif  /* JKCC_PERF_H */
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * alias.h -- alias analysis
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_ALIAS_H
+#define JKCC_PRIVATE_ALIAS_H
+
+
+#include <jkcc/ir/alias.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+
+
+#define ALIAS_ACCESSES_MAX 3   // a vector quad reads two and writes one
+#define ALIAS_DEPTH        16  // defs followed back to find a base
+
+
+// memory a quad touches; wild for anything a call may reach
+typedef struct alias_access_s {
+	ir_alias_address_t address;
+	size_t             size;
+	ir_reg_type_t      type;
+	bool               wild;
+} alias_access_t;
+
+typedef struct alias_pair_s {
+	const ir_quad_t *lhs;
+	const ir_quad_t *rhs;
+} alias_pair_t;
+
+
+static size_t             accesses(
+	const ir_alias_t         *ir_alias,
+	const ir_quad_t          *ir_quad,
+	alias_access_t           *access);
+static ir_alias_address_t arithmetic(
+	const ir_quad_binop_t    *binop,
+	ir_alias_address_t        lhs,
+	ir_alias_address_t        rhs);
+static ir_alias_result_t  compare(
+	const ir_alias_t         *ir_alias,
+	const alias_access_t     *lhs,
+	const alias_access_t     *rhs);
+static bool               contained(
+	const ir_alias_t         *ir_alias,
+	const ir_quad_t          *ir_quad,
+	uintptr_t                 reg);
+static bool               declared(
+	const ir_alias_address_t *address,
+	ir_reg_type_t            *type);
+static void               escapes(
+	ir_alias_t               *ir_alias);
+static bool               object(
+	const ir_alias_address_t *address);
+static ir_alias_address_t resolve(
+	ir_alias_t               *ir_alias,
+	uintptr_t                 reg,
+	size_t                    depth);
+static bool               same(
+	const ir_alias_address_t *lhs,
+	const ir_alias_address_t *rhs);
+static ir_alias_result_t  unknown(
+	const ir_alias_t         *ir_alias,
+	const alias_access_t     *access,
+	const ir_alias_address_t *known);
+static size_t             width(
+	ir_reg_type_t             type);
+
+
+#endif  /* JKCC_PRIVATE_ALIAS_H */
@@ -10,12 +10,15 @@
 
 #include <jkcc/ast.h>
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <jkcc/config.h>
+#include <jkcc/json.h>
 #include <jkcc/lexer.h>
+#include <jkcc/mem.h>
 
 
 #define INDENT(stream, level) if (level) {              \
@@ -24,8 +27,8 @@
 	fwrite(buf, sizeof(*buf), sizeof(buf), stream); \
 }
 
-#define AST_INIT(type)                      \
-	type *node = malloc(sizeof(*node)); \
+#define AST_INIT(type, kind)                                    \
+	type *node = MEM_MALLOC(MEM_TAG_AST, kind, sizeof(*node)); \
 	if (!node) return NULL;
 
 #define AST_NODE_LOCATION                             \
@@ -178,5 +181,51 @@
 	FPRINT_AST_FINISH;
 #endif  /* JKCC_CONFIG_AST_PRINT_LOCATION */
 
+#define FPRINT_AST_JSONL_NODE_BEGIN(type)          \
+	type *node = OFFSETOF_AST_NODE(ast, type); \
+                                                   \
+	(void) stream;                             \
+	(void) jsonl;
+
+#define FPRINT_AST_JSONL_BOOL(name, value) \
+	fprintf(stream, ",\"%s\":%s", name, value ? "true" : "false");
+
+#define FPRINT_AST_JSONL_MEMBER(type, member) if (member) \
+	ast_jsonl_push(jsonl, member, type, SIZE_MAX);
+
+#define FPRINT_AST_JSONL_FIELD(name, value) { \
+	fprintf(stream, ",\"%s\":", name);    \
+	fprint_json_string(stream, value);    \
+}
+
+#define FPRINT_AST_JSONL_POINTER(name, value) \
+	fprintf(stream, ",\"%s\":\"%p\"", name, (void*) value);
+
+#define FPRINT_AST_JSONL_LIST(name, member) {               \
+	ast_t **tmp = member.buf;                           \
+                                                            \
+	for (size_t pos = 0; pos < member.use; pos++)       \
+		ast_jsonl_push(jsonl, tmp[pos], name, pos); \
+}
+
+#define FPRINT_AST_JSONL_REVERSE_LIST(name, member) { \
+	ast_t **tmp = member.buf;                     \
+                                                      \
+	for (size_t pos = 0; pos < member.use; pos++) \
+		ast_jsonl_push(                       \
+			jsonl,                        \
+			tmp[member.use - pos - 1],    \
+			name,                         \
+			pos);                         \
+}
+
+#ifdef JKCC_CONFIG_AST_PRINT_LOCATION
+#define FPRINT_AST_JSONL_NODE_FINISH       \
+	fprintf(stream, ",\"location\":"); \
+	fprint_location_jsonl(stream, &node->location);
+#else  /* JKCC_CONFIG_AST_PRINT_LOCATION */
+#define FPRINT_AST_JSONL_NODE_FINISH (void) node;
+#endif  /* JKCC_CONFIG_AST_PRINT_LOCATION */
+
 
 #endif  /* JKCC_PRIVATE_AST_H */
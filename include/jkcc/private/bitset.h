@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * bitset.h -- dense bit-sets
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_BITSET_H
+#define JKCC_PRIVATE_BITSET_H
+
+
+#include <jkcc/bitset.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BITSET_X86
+#endif
+
+
+static void kernel_detect(void);
+
+static bool diff_scalar(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+static bool intersect_scalar(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+static bool transfer_scalar(
+	uint64_t       *dst,
+	const uint64_t *gen,
+	const uint64_t *src,
+	const uint64_t *kill,
+	size_t          words);
+static bool union_scalar(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+
+#ifdef BITSET_X86
+static bool diff_sse2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+static bool intersect_sse2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+static bool transfer_sse2(
+	uint64_t       *dst,
+	const uint64_t *gen,
+	const uint64_t *src,
+	const uint64_t *kill,
+	size_t          words);
+static bool union_sse2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+
+static bool diff_avx2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+static bool intersect_avx2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+static bool transfer_avx2(
+	uint64_t       *dst,
+	const uint64_t *gen,
+	const uint64_t *src,
+	const uint64_t *kill,
+	size_t          words);
+static bool union_avx2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words);
+#endif  /* BITSET_X86 */
+
+
+#endif  /* JKCC_PRIVATE_BITSET_H */
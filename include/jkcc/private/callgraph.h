@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * callgraph.h -- call graph
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_CALLGRAPH_H
+#define JKCC_PRIVATE_CALLGRAPH_H
+
+
+#include <jkcc/ir/callgraph.h>
+
+#include <stddef.h>
+
+
+static int         edges(ir_callgraph_t *ir_callgraph);
+static const char *name(const ir_function_t *ir_function);
+static int         names(ir_callgraph_t *ir_callgraph);
+static int         tarjan(ir_callgraph_t *ir_callgraph);
+
+
+#endif  /* JKCC_PRIVATE_CALLGRAPH_H */
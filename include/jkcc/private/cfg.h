@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * cfg.h -- control-flow graph
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_CFG_H
+#define JKCC_PRIVATE_CFG_H
+
+
+#include <jkcc/ir/cfg.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <jkcc/ht.h>
+
+
+static int  edges(ir_cfg_t *ir_cfg, ht_t *index);
+static bool fallthrough(ir_bb_t *ir_bb);
+static int  postorder(ir_cfg_t *ir_cfg);
+
+
+#endif  /* JKCC_PRIVATE_CFG_H */
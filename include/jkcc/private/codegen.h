@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * codegen.h -- x86-64 instruction selection
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_CODEGEN_H
+#define JKCC_PRIVATE_CODEGEN_H
+
+
+#include <jkcc/ir/codegen.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+#include <jkcc/x86.h>
+
+
+#define CALLEE_SAVED 5
+
+// system v passes this many integer arguments in registers
+#define ARGV_REGS 6
+
+// an xmm register holds this many i32 lanes
+#define CODEGEN_SSE_BYTES 16
+#define CODEGEN_SSE_LANES 4
+
+// i32 values live sign-extended in 64-bit registers
+#define CODEGEN_I32(val) ((int64_t) (int32_t) (uint32_t) (val))
+
+
+typedef struct fixup_s {
+	size_t offset;  // of the rel32
+	size_t bb;      // layout position of the target
+} fixup_t;
+
+typedef struct isel_s {
+	ir_codegen_t   *ir_codegen;
+	ir_function_t  *ir_function;
+	ht_t           *symbol;       // declaration -> symbol index
+	ht_t            bb;           // id -> layout position
+	size_t         *bb_offset;
+	vector_t        fixup;        // fixup_t
+	uint32_t        argv[IR_CODEGEN_ARGV_MAX];  // cells of the pending call
+	size_t          argc;
+	size_t          regs;
+	size_t          physical;     // regs held in callee-saved registers
+	size_t          params;
+	size_t          allocas;
+	size_t          outgoing;     // cells staging call arguments
+	size_t          cell;         // next free alloca cell
+	ir_quad_cmp_t  *cmp;          // last cmp, re-issued if flags are lost
+	bool            flags;
+	bool            terminated;   // by a ret or jmp
+} isel_t;
+
+
+static int       call(
+	isel_t              *isel,
+	ir_quad_call_t      *quad);
+static void      compare(
+	isel_t              *isel,
+	const ir_quad_t     *next);
+static int32_t   disp(
+	const isel_t        *isel,
+	uint32_t             index);
+static void      epilogue(
+	isel_t              *isel);
+static int       function(
+	ir_codegen_t        *ir_codegen,
+	size_t               pos,
+	ht_t                *symbol);
+static int       layout(
+	ir_codegen_t        *ir_codegen,
+	ht_t                *symbol);
+static x86_reg_t operand(
+	isel_t              *isel,
+	uint32_t             index,
+	x86_reg_t            scratch);
+static void      prologue(
+	isel_t              *isel);
+static bool      readable(
+	const isel_t        *isel,
+	uintptr_t            src);
+static uint32_t  reg(
+	const isel_t        *isel,
+	uintptr_t            reg);
+static int       select_quad(
+	isel_t              *isel,
+	ir_quad_t           *ir_quad,
+	ir_quad_t           *following,
+	size_t               next);
+static x86_reg_t source(
+	isel_t              *isel,
+	uintptr_t            src,
+	x86_reg_t            scratch);
+static int       symbol_add(
+	ir_codegen_t        *ir_codegen,
+	ir_codegen_symbol_t *symbol,
+	size_t              *index);
+static x86_reg_t target(
+	const isel_t        *isel,
+	uint32_t             index,
+	x86_reg_t            scratch);
+static void      teardown(
+	isel_t              *isel);
+static void      writeback(
+	isel_t              *isel,
+	uint32_t             index,
+	x86_reg_t            src);
+
+
+#endif  /* JKCC_PRIVATE_CODEGEN_H */
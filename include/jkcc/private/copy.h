@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * copy.h -- copy propagation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_COPY_H
+#define JKCC_PRIVATE_COPY_H
+
+
+#include <jkcc/ir/copy.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define COPY_LOADS_MAX 256  // loads worth querying every memory quad for
+
+
+typedef struct copy_s {
+	ir_function_t *ir_function;
+	ir_cfg_t       ir_cfg;
+	ir_alias_t     ir_alias;
+	vector_t       load;     // ir_quad_t*, in program order
+} copy_t;
+
+
+static void available(
+	copy_t          *copy,
+	const ir_quad_t *ir_quad,
+	bitset_t        *gen,
+	bitset_t        *kill);
+static void compact(
+	ir_bb_t         *ir_bb);
+static int  gather(
+	copy_t          *copy);
+static void mark(
+	bitset_t        *gen,
+	bitset_t        *kill,
+	size_t           bit,
+	bool             set);
+static int  propagate(
+	copy_t          *copy,
+	size_t          *changed);
+static bool redundant(
+	copy_t          *copy,
+	const ir_quad_t *ir_quad,
+	const bitset_t  *avail,
+	uintptr_t       *rename);
+
+
+#endif  /* JKCC_PRIVATE_COPY_H */
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dataflow.h -- bit-vector dataflow analysis
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_DATAFLOW_H
+#define JKCC_PRIVATE_DATAFLOW_H
+
+
+#include <jkcc/ir/dataflow.h>
+
+#include <stddef.h>
+
+#include <jkcc/bitset.h>
+
+
+static void meet(
+	ir_dataflow_t  *ir_dataflow,
+	bitset_t       *dst,
+	const vector_t *edge,
+	const bitset_t *src);
+
+
+#endif  /* JKCC_PRIVATE_DATAFLOW_H */
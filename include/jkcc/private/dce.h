@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dce.h -- dead quad elimination
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_DCE_H
+#define JKCC_PRIVATE_DCE_H
+
+
+#include <jkcc/ir/dce.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+
+
+static int    reference(
+	ir_function_t   *ir_function,
+	ht_t            *referenced);
+static bool   removable(
+	const ir_quad_t *ir_quad);
+static size_t sweep(
+	ir_bb_t         *ir_bb,
+	bitset_t        *live);
+
+
+#endif  /* JKCC_PRIVATE_DCE_H */
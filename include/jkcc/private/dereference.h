@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dereference.h -- dereference basic block
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_DEREFERENCE_H
+#define JKCC_PRIVATE_DEREFERENCE_H
+
+
+#include <jkcc/ir/bb/dereference.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+
+
+static ast_t        *declared(
+	ast_t *ast);
+static ir_reg_type_t element(
+	ast_t *ast);
+
+
+#endif  /* JKCC_PRIVATE_DEREFERENCE_H */
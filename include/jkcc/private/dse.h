@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dse.h -- dead store elimination
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_DSE_H
+#define JKCC_PRIVATE_DSE_H
+
+
+#include <jkcc/ir/dse.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define DSE_STORES_MAX 256  // stores worth querying every memory quad for
+
+
+typedef struct dse_store_s {
+	ir_quad_t *quad;
+	uintptr_t  pointer;  // loaded base the address moves with, or none
+	bool       local;    // in a cell nothing outlives the function through
+	bool       dead;
+} dse_store_t;
+
+typedef struct dse_s {
+	ir_function_t *ir_function;
+	ir_cfg_t       ir_cfg;
+	ir_alias_t     ir_alias;
+	vector_t       store;    // dse_store_t, in program order
+} dse_t;
+
+
+static void available(
+	dse_t           *dse,
+	const ir_quad_t *ir_quad,
+	bitset_t        *gen,
+	bitset_t        *kill);
+static void compact(
+	ir_bb_t         *ir_bb);
+static int  dead(
+	dse_t           *dse);
+static int  forward(
+	dse_t           *dse,
+	size_t          *changed);
+static bool forwardable(
+	dse_t           *dse,
+	const ir_quad_t *ir_quad,
+	const bitset_t  *avail,
+	bitset_t        *pinned,
+	uintptr_t       *rename);
+static int  gather(
+	dse_t           *dse);
+static void mark(
+	bitset_t        *gen,
+	bitset_t        *kill,
+	size_t           bit,
+	bool             set);
+static void overwritten(
+	dse_t           *dse,
+	const ir_quad_t *ir_quad,
+	bitset_t        *gen,
+	bitset_t        *kill);
+static int  pin(
+	dse_t           *dse,
+	bitset_t        *pinned);
+
+
+#endif  /* JKCC_PRIVATE_DSE_H */
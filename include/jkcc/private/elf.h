@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * elf.h -- elf64 relocatable object writer
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_ELF_H
+#define JKCC_PRIVATE_ELF_H
+
+
+#include <jkcc/ir/elf.h>
+
+#include <elf.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <jkcc/string.h>
+
+
+typedef enum elf_section_e {
+	ELF_SECTION_NULL,
+	ELF_SECTION_TEXT,
+	ELF_SECTION_DATA,
+	ELF_SECTION_BSS,
+	ELF_SECTION_RODATA,
+	ELF_SECTION_RELA_TEXT,
+	ELF_SECTION_SYMTAB,
+	ELF_SECTION_STRTAB,
+	ELF_SECTION_SHSTRTAB,
+	ELF_SECTION_NOTE_GNU_STACK,
+	ELF_SECTIONS_TOTAL,
+} elf_section_t;
+
+typedef struct elf_s {
+	FILE   *stream;
+	size_t  pos;  // bytes written so far
+} elf_t;
+
+
+static void align(
+	elf_t            *elf,
+	size_t            alignment);
+static void bytes(
+	elf_t            *elf,
+	const void       *buf,
+	size_t            size);
+static void ehdr(
+	elf_t            *elf,
+	const Elf64_Ehdr *ehdr);
+static void le(
+	elf_t            *elf,
+	uint64_t          val,
+	size_t            size);
+static void rela(
+	elf_t            *elf,
+	const Elf64_Rela *rela);
+static void shdr(
+	elf_t            *elf,
+	const Elf64_Shdr *shdr);
+static int  strtab_add(
+	string_t         *strtab,
+	const char       *str,
+	Elf64_Word       *offset);
+static void sym(
+	elf_t            *elf,
+	const Elf64_Sym  *sym);
+
+
+#endif  /* JKCC_PRIVATE_ELF_H */
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * inline.h -- function inlining
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_INLINE_H
+#define JKCC_PRIVATE_INLINE_H
+
+
+#include <jkcc/ir/inline.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define INLINE_ARGV_MAX   8
+#define INLINE_CALLEE_MAX 32  // quads
+#define INLINE_DEPTH_MAX  3   // of calls exposed by inlining
+#define INLINE_GROWTH     2   // times the original size of a caller
+#define INLINE_GROWTH_MIN 64  // quads any caller may grow by
+
+
+typedef struct inline_s {
+	ir_callgraph_t callgraph;
+	size_t         bb;         // next unused bb id in the unit
+} inline_t;
+
+typedef struct inline_site_s {
+	ir_function_t *caller;
+	ir_function_t *callee;
+	size_t         bb;                    // holding the call
+	size_t         quad;
+	size_t         arg[INLINE_ARGV_MAX];  // quad passing each argument
+} inline_site_t;
+
+
+static size_t         argc(
+	const ir_function_t *ir_function);
+static int            collect(
+	inline_site_t       *site);
+static int            expand(
+	inline_t            *inliner,
+	inline_site_t       *site,
+	size_t              *added);
+static int            function(
+	inline_t            *inliner,
+	size_t               caller);
+static void           remap(
+	ir_quad_t           *ir_quad,
+	uintptr_t            base,
+	ht_t                *target);
+static size_t         size(
+	const ir_function_t *ir_function);
+static void           widen(
+	vector_t            *vector,
+	size_t               pos,
+	size_t               count);
+
+
+#endif  /* JKCC_PRIVATE_INLINE_H */
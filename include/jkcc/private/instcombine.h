@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * instcombine.h -- instruction combining
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_INSTCOMBINE_H
+#define JKCC_PRIVATE_INSTCOMBINE_H
+
+
+#include <jkcc/ir/instcombine.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define INSTCOMBINE_EXPAND_MAX 16  // quads a division by a constant grows to
+#define INSTCOMBINE_OP(op)     (1U << IR_QUAD_BINOP_##op)
+#define INSTCOMBINE_OPS        ((1U << (IR_QUAD_BINOP_LSR + 1)) - 1)
+
+
+// what an operand has to be for a pattern to match
+typedef enum instcombine_operand_e {
+	INSTCOMBINE_ANY,
+	INSTCOMBINE_CONSTANT,
+	INSTCOMBINE_ZERO,
+	INSTCOMBINE_ONE,
+	INSTCOMBINE_ONES,        // -1
+	INSTCOMBINE_POWER,       // a power of two past 1
+	INSTCOMBINE_SAME,        // the other operand
+	INSTCOMBINE_NEGATED,     // sub 0, y
+	INSTCOMBINE_INVERTED,    // eor y, c by the other operand's c
+	INSTCOMBINE_DIFFERENCE,  // sub a, b or eor a, b
+} instcombine_operand_t;
+
+typedef struct instcombine_s instcombine_t;
+
+typedef struct instcombine_pattern_s {
+	ir_quad_t             type;  // IR_QUAD_BINOP or IR_QUAD_CMP
+	unsigned              ops;   // INSTCOMBINE_OP() of every binop it fits
+	instcombine_operand_t lhs;
+	instcombine_operand_t rhs;
+	int                 (*action)(
+		instcombine_t *instcombine,
+		size_t         at,
+		bool          *done);
+} instcombine_pattern_t;
+
+typedef struct instcombine_quad_s {
+	ir_quad_t *quad;
+	size_t     bb;
+	size_t     pos;
+	bool       queued;
+	bool       dead;
+} instcombine_quad_t;
+
+// a new quad that goes in ahead of quad[at]
+typedef struct instcombine_insert_s {
+	size_t     at;
+	ir_quad_t *quad;
+} instcombine_insert_t;
+
+struct instcombine_s {
+	ir_function_t      *ir_function;
+	size_t              vregs;
+	uintptr_t           next;     // first unused vreg
+	size_t              quads;
+	instcombine_quad_t *quad;     // every quad, in program order
+	size_t             *defs;     // per vreg, times it is defined
+	size_t             *def;      // per vreg, quad index of a def
+	size_t             *users;    // per vreg + 1, offsets into user
+	size_t             *user;     // quad indices, grouped by vreg
+	uintptr_t          *rename;   // per vreg, what it now reads as
+	bitset_t            local;    // only read after its def, in its bb
+	bitset_t            pinned;   // read where no immediate can stand in
+	vector_t            insert;   // instcombine_insert_t
+	vector_t            work;     // size_t, quad indices
+	size_t              changed;
+};
+
+
+static bool                    accepts(
+	const instcombine_t    *instcombine,
+	uintptr_t               reg);
+static int                     apply(
+	instcombine_t          *instcombine);
+static void                    canonical(
+	instcombine_t          *instcombine,
+	ir_quad_binop_t        *binop);
+static bool                    constant(
+	const instcombine_t    *instcombine,
+	uintptr_t               reg,
+	int64_t                *value);
+static size_t                  consumers(
+	const instcombine_t    *instcombine,
+	size_t                  at);
+static int                     decide(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+static ir_quad_t              *definition(
+	const instcombine_t    *instcombine,
+	uintptr_t               reg);
+static int                     divide(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+static int                     emit(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	ir_quad_t             **seq,
+	size_t                  quads);
+static bool                    evaluate(
+	ir_quad_binop_op_t      op,
+	ir_reg_type_t           type,
+	int64_t                 lhs,
+	int64_t                 rhs,
+	int64_t                *value);
+static uintptr_t               find(
+	const instcombine_t    *instcombine,
+	uintptr_t               reg);
+static int                     fold(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+static int                     forward(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+static int                     gather(
+	instcombine_t          *instcombine);
+static int                     inner(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+static int                     known(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	int64_t                 value,
+	bool                   *done);
+static bool                    match(
+	const instcombine_t    *instcombine,
+	instcombine_operand_t   operand,
+	uintptr_t               reg,
+	uintptr_t               other);
+static int                     materialize(
+	instcombine_t          *instcombine,
+	ir_quad_t             **seq,
+	size_t                 *quads,
+	ir_reg_type_t           type,
+	int64_t                 value,
+	uintptr_t              *dst);
+static bool                    narrow(
+	const instcombine_t    *instcombine,
+	uintptr_t               reg);
+static int                     operation(
+	instcombine_t          *instcombine,
+	ir_quad_t             **seq,
+	size_t                 *quads,
+	ir_quad_binop_op_t      op,
+	ir_reg_type_t           type,
+	uintptr_t               lhs,
+	uintptr_t               rhs,
+	uintptr_t              *dst);
+static ir_quad_br_condition_t *predicate(
+	ir_quad_t              *ir_quad);
+static ir_quad_binop_t        *producer(
+	const instcombine_t    *instcombine,
+	uintptr_t               reg);
+static int                     push(
+	instcombine_t          *instcombine,
+	size_t                  at);
+static bool                    renamable(
+	const instcombine_t    *instcombine,
+	uintptr_t               from,
+	uintptr_t               to,
+	ir_reg_type_t           type);
+static void                    replace(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	ir_quad_t              *quad);
+static int                     requeue(
+	instcombine_t          *instcombine,
+	uintptr_t               reg);
+static bool                    reverse(
+	ir_quad_br_condition_t *condition);
+static int                     shift(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+static int                     split(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+static bool                    stable(
+	const instcombine_t    *instcombine,
+	uintptr_t               reg);
+static int                     substitute(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	uintptr_t               from,
+	uintptr_t               to);
+static int                     swap(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+static int                     taken(
+	ir_quad_br_condition_t  condition,
+	int64_t                 lhs,
+	int64_t                 rhs);
+static int                     visit(
+	instcombine_t          *instcombine,
+	size_t                  at);
+static int                     zero(
+	instcombine_t          *instcombine,
+	size_t                  at,
+	bool                   *done);
+
+
+#endif  /* JKCC_PRIVATE_INSTCOMBINE_H */
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * interp.h -- ir interpreter
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_INTERP_H
+#define JKCC_PRIVATE_INTERP_H
+
+
+#include <jkcc/ir/interp.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+
+
+// labels as values are a gnu extension
+#define INTERP_LABEL(label) (__extension__ &&label)
+
+#define INTERP_DISPATCH                                   \
+	do {                                              \
+		++executed[insn->quad];                   \
+		__extension__ ({ goto *insn->handler; }); \
+	} while (0)
+
+#define INTERP_NEXT              \
+	do {                     \
+		++insn;          \
+		INTERP_DISPATCH; \
+	} while (0)
+
+#define INTERP_BRANCH(condition)           \
+	do {                               \
+		if (condition) {           \
+			insn = insn->jump; \
+			INTERP_DISPATCH;   \
+		}                          \
+                                           \
+		INTERP_NEXT;               \
+	} while (0)
+
+#define INTERP_SELECT(condition)                                          \
+	do {                                                              \
+		r[insn->dst] = (condition) ? r[insn->lhs] : r[insn->rhs]; \
+		INTERP_NEXT;                                              \
+	} while (0)
+
+// every lane is read before any is written, as a simd register would
+#define INTERP_VECTOR(operator)                                          \
+	do {                                                             \
+		size = insn->imm * sizeof(*lane[0]);                     \
+                                                                         \
+		if (!valid(ir_interp, r[insn->lhs], size)                \
+			|| !valid(ir_interp, r[insn->rhs], size)) {      \
+			reason = IR_INTERP_TRAP_INVALID_LOAD;            \
+			goto trap;                                       \
+		}                                                        \
+                                                                         \
+		if (!valid(ir_interp, r[insn->dst], size)) {             \
+			reason = IR_INTERP_TRAP_INVALID_STORE;           \
+			goto trap;                                       \
+		}                                                        \
+                                                                         \
+		memcpy(lane[0], (void*) (uintptr_t) r[insn->lhs], size); \
+		memcpy(lane[1], (void*) (uintptr_t) r[insn->rhs], size); \
+                                                                         \
+		for (int64_t k = 0; k < insn->imm; k++)                  \
+			lane[0][k] = lane[0][k] operator lane[1][k];     \
+                                                                         \
+		memcpy((void*) (uintptr_t) r[insn->dst], lane[0], size); \
+		INTERP_NEXT;                                             \
+	} while (0)
+
+// i32 values live sign-extended in 64-bit registers
+#define INTERP_I32(val) ((int64_t) (int32_t) (uint32_t) (val))
+
+
+typedef enum shim_e {
+	SHIM_ABS,
+	SHIM_EXIT,
+	SHIM_PRINTF,
+	SHIM_PUTCHAR,
+	SHIM_PUTS,
+	SHIMS_TOTAL,
+} shim_t;
+
+typedef struct decode_s {
+	ir_interp_t          *ir_interp;
+	ir_interp_function_t *function;
+	ht_t                  bb;         // id -> layout position
+	ht_t                  constant;   // immediate -> frame register
+	size_t               *bb_insn;    // first insn of each bb
+	ht_t                 *symbol;     // declaration -> data offset
+	size_t                allocas;
+	size_t                argc;       // of the pending call
+} decode_t;
+
+
+static int  decode(
+	ir_interp_t          *ir_interp,
+	ir_interp_function_t *function,
+	ht_t                 *symbol);
+static int  decode_quad(
+	decode_t             *decode,
+	ir_quad_t            *ir_quad,
+	size_t                next);
+static int  emit(
+	decode_t             *decode,
+	ir_interp_insn_t     *insn);
+static int  execute(
+	ir_interp_t          *ir_interp,
+	ir_interp_function_t *function,
+	size_t                argc,
+	uint64_t             *ret);
+static int  layout(
+	ir_interp_t          *ir_interp,
+	ht_t                 *symbol);
+static int  operand(
+	decode_t             *decode,
+	uintptr_t             src,
+	uint32_t             *index);
+static uint32_t reg(
+	const ir_function_t  *ir_function,
+	uintptr_t             reg);
+static int  shim_abs(
+	ir_interp_t          *ir_interp,
+	size_t                argc,
+	uint64_t             *ret);
+static int  shim_exit(
+	ir_interp_t          *ir_interp,
+	size_t                argc,
+	uint64_t             *ret);
+static int  shim_printf(
+	ir_interp_t          *ir_interp,
+	size_t                argc,
+	uint64_t             *ret);
+static int  shim_putchar(
+	ir_interp_t          *ir_interp,
+	size_t                argc,
+	uint64_t             *ret);
+static int  shim_puts(
+	ir_interp_t          *ir_interp,
+	size_t                argc,
+	uint64_t             *ret);
+static const char *string(
+	const ir_interp_t    *ir_interp,
+	uint64_t              addr);
+static int  trap(
+	ir_interp_t          *ir_interp,
+	const char           *function,
+	ir_interp_trap_t      reason);
+static bool valid(
+	const ir_interp_t    *ir_interp,
+	uint64_t              addr,
+	size_t                size);
+
+
+#endif  /* JKCC_PRIVATE_INTERP_H */
@@ -13,6 +13,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <jkcc/mem.h>
+
 
 #define IR_BB_INIT                                                       \
 	if (!ir_context->ir_bb) {                                        \
@@ -35,13 +37,21 @@
 	ret = ir_quad_br_gen(ir_quad, IR_QUAD_BR_AL, id);               \
 	if (!ret) {                                                     \
 		if (vector_append(&ir_context->ir_bb->quad, ir_quad)) { \
-			free(quad);                                     \
+			IR_QUAD_FREE(*(ir_quad));                       \
 			ret = IR_ERROR_NOMEM;                           \
 		}                                                       \
 	}
 
-#define IR_QUAD_INIT(type)                  \
-	type *quad = malloc(sizeof(*quad)); \
+#define IR_QUAD_CLONE_COPY(type, kind)                                \
+	type *quad = MEM_MALLOC(MEM_TAG_IR_QUAD, kind, sizeof(*quad)); \
+	if (!quad) return IR_ERROR_NOMEM;                              \
+                                                                       \
+	*quad  = *OFFSETOF_IR_QUAD(ir_quad, type);                     \
+	*clone = &quad->ir_quad;                                       \
+	return 0;
+
+#define IR_QUAD_INIT(type, kind)                                    \
+	type *quad = MEM_MALLOC(MEM_TAG_IR_QUAD, kind, sizeof(*quad)); \
 	if (!quad) return IR_ERROR_NOMEM;
 
 #define IR_QUAD_RETURN(val)        \
@@ -56,6 +66,42 @@
 #define IR_QUAD_FPRINT_FINISH  \
 	fprintf(stream, "\n");
 
+#define IR_QUAD_FREE_BEGIN(type) \
+	type *quad = OFFSETOF_IR_QUAD(ir_quad, type);
+
+#define IR_QUAD_FPRINT_JSONL_BEGIN(type) \
+	type *quad = OFFSETOF_IR_QUAD(ir_quad, type);
+
+#define IR_QUAD_REG_BEGIN(type)                       \
+	type *quad = OFFSETOF_IR_QUAD(ir_quad, type); \
+                                                      \
+	*reg = (ir_quad_reg_t) {0};
+
+// an immediate is no register, so it is never reported as a use
+#define IR_QUAD_REG_IMMEDIATE(k, operand)          \
+	do {                                       \
+		reg->immediate |= 1U << (k);       \
+                                                   \
+		if (!IR_REG_IS_IMMEDIATE(operand)) \
+			reg->use[k] = &(operand);  \
+	} while (0)
+
+#define IR_FPRINT_JSONL_FIELD(name, value) \
+	fprintf(stream, ",\"%s\":\"%s\"", name, value);
+
+#define IR_FPRINT_JSONL_UINT(name, value) \
+	fprintf(stream, ",\"%s\":%lu", name, (unsigned long) value);
+
+#define IR_FPRINT_JSONL_REG(name, reg)                       \
+	if (IR_REG_IS_IMMEDIATE(reg))                        \
+		fprintf(                                     \
+			stream,                              \
+			",\"%s\":{\"immediate\":%ld}",       \
+			name,                                \
+			(long) IR_REG_IMMEDIATE_VALUE(reg)); \
+	else                                                 \
+		IR_FPRINT_JSONL_UINT(name, IR_REG_INDEX(reg));
+
 
 
 #endif  /* JKCC_PRIVATE_IR_H */
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * iv.h -- induction variables
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_IV_H
+#define JKCC_PRIVATE_IV_H
+
+
+#include <jkcc/ir/iv.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define IV_INVARIANT_DEPTH 4
+
+
+typedef enum iv_edit_where_e {
+	IV_EDIT_BEFORE,
+	IV_EDIT_REPLACE,
+	IV_EDIT_AFTER,
+} iv_edit_where_t;
+
+typedef struct iv_edit_s {
+	size_t           bb;
+	size_t           pos;
+	iv_edit_where_t  where;
+	size_t           seq;
+	ir_quad_t       *quad;   // NULL to remove what is at pos
+} iv_edit_t;
+
+// every derived iv of the same basic iv, scale, and base shares a
+// pointer cell that is stepped right after the basic iv is
+typedef struct iv_group_s {
+	size_t    basic;
+	int64_t   scale;
+	uintptr_t key;    // base, or the cell it is loaded from
+	bool      cell;
+	uintptr_t ptr;
+	uintptr_t base;   // as materialized in the preheader
+	uintptr_t step;   // scale, as an immediate
+} iv_group_t;
+
+typedef struct iv_reduce_s {
+	ir_iv_t        *ir_iv;
+	const ir_cfg_t *ir_cfg;
+	vector_t        edit;       // iv_edit_t
+	vector_t        group;      // iv_group_t
+	bitset_t        dead;       // vregs whose def is removed
+	uintptr_t       next;       // first unused vreg
+	size_t          preheader;  // where preheader code goes
+} iv_reduce_t;
+
+
+static int                    apply(
+	iv_reduce_t             *reduce);
+static int                    basics(
+	ir_iv_t                 *ir_iv);
+static void                   cells(
+	ir_iv_t                 *ir_iv);
+static int                    compare(
+	const void              *lhs,
+	const void              *rhs);
+static ir_quad_t             *def(
+	const ir_iv_t           *ir_iv,
+	uintptr_t                reg);
+static void                   defs(
+	ir_iv_t                 *ir_iv);
+static int                    deriveds(
+	ir_iv_t                 *ir_iv);
+static int                    edit(
+	iv_reduce_t             *reduce,
+	size_t                   bb,
+	size_t                   pos,
+	iv_edit_where_t          where,
+	ir_quad_t               *quad);
+static int                    group(
+	iv_reduce_t             *reduce,
+	const ir_iv_derived_t   *derived,
+	iv_group_t             **found);
+static bool                   invariant(
+	const ir_iv_t           *ir_iv,
+	uintptr_t                reg,
+	size_t                   depth);
+static int                    lftr(
+	iv_reduce_t             *reduce);
+static bool                   loaded(
+	iv_reduce_t             *reduce,
+	const ir_iv_basic_t     *basic);
+static bool                   live(
+	iv_reduce_t             *reduce,
+	uintptr_t                cell);
+static size_t                 lookup(
+	const ir_function_t     *ir_function,
+	size_t                   id);
+static int                    materialize(
+	iv_reduce_t             *reduce,
+	uintptr_t                reg,
+	uintptr_t               *dst);
+static ir_quad_br_condition_t negate(
+	ir_quad_br_condition_t   condition);
+static int                    prune(
+	iv_reduce_t             *reduce,
+	uintptr_t                reg);
+static int                    rewrite(
+	ir_function_t           *ir_function,
+	const ir_cfg_t          *ir_cfg,
+	const ir_loop_t         *ir_loop);
+static int                    scaled(
+	iv_reduce_t             *reduce,
+	uintptr_t                base,
+	uintptr_t                index,
+	uintptr_t                step,
+	uintptr_t               *dst);
+static ir_quad_br_condition_t swap(
+	ir_quad_br_condition_t   condition);
+
+
+#endif  /* JKCC_PRIVATE_IV_H */
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * jit.h -- in-memory x86-64 loader
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_JIT_H
+#define JKCC_PRIVATE_JIT_H
+
+
+#include <jkcc/ir/jit.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// the selected code follows the system v abi
+#if defined(__x86_64__) && defined(__unix__)
+#define JIT_HOST
+#endif
+
+
+#ifdef JIT_HOST
+static int  relocate(
+	ir_jit_t  *ir_jit,
+	uintptr_t *address);
+static int  resolve(
+	ir_jit_t  *ir_jit,
+	size_t     symbol,
+	uintptr_t *address);
+static void stub(
+	uint8_t   *pos,
+	uintptr_t  target);
+#endif  /* JIT_HOST */
+
+
+#endif  /* JKCC_PRIVATE_JIT_H */
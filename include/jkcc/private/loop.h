@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * loop.h -- dominators and natural loops
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_LOOP_H
+#define JKCC_PRIVATE_LOOP_H
+
+
+#include <jkcc/ir/loop.h>
+
+#include <stddef.h>
+
+
+static int    body(
+	ir_loop_nest_t       *ir_loop_nest,
+	ir_loop_t            *ir_loop,
+	size_t                latch);
+static void   dominators(
+	ir_loop_nest_t       *ir_loop_nest);
+static size_t intersect(
+	const ir_loop_nest_t *ir_loop_nest,
+	size_t                lhs,
+	size_t                rhs);
+static int    order(
+	const void           *lhs,
+	const void           *rhs);
+static void   preheader(
+	ir_loop_nest_t       *ir_loop_nest,
+	ir_loop_t            *ir_loop);
+
+
+#endif  /* JKCC_PRIVATE_LOOP_H */
@@ -10,13 +10,31 @@
 
 #include <argp.h>
 
+#include <jkcc/ir.h>
 
-#define KEY_COLOR 257
-#define KEY_TRACE 258
+
+#define KEY_COLOR         257
+#define KEY_TRACE         258
+#define KEY_TRACE_BINARY  259
+#define KEY_TRACE_SITES   260
+#define KEY_PERF_COUNTERS 261
+#define KEY_MEM_REPORT    262
+#define KEY_INTERPRET     263
+#define KEY_RUN           264
+#define KEY_PASS_STATS    265
+
+#define F_PASS         "pass="
+#define F_PASS_LEN     (sizeof(F_PASS) - 1)
+
+#define F_REGALLOC     "regalloc="
+#define F_REGALLOC_LEN (sizeof(F_REGALLOC) - 1)
 
 
 static void    cleanup(void);
+static int     compile(ir_unit_t *ir_unit, const char *file);
+static int     interpret(ir_unit_t *ir_unit, int *status);
 static error_t parse_opt(int key, char *arg, struct argp_state *state);
+static int     run(ir_unit_t *ir_unit, int *status);
 
 
 #endif  /* JKCC_PRIVATE_MAIN_H */
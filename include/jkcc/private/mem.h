@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * mem.h -- tagged memory allocation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_MEM_H
+#define JKCC_PRIVATE_MEM_H
+
+
+#include <jkcc/mem.h>
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+
+typedef union mem_header_u {
+	struct {
+		size_t   size;
+		unsigned tag;
+		unsigned kind;
+	} info;
+	max_align_t align;
+} mem_header_t;
+
+typedef struct mem_stat_s {
+	atomic_size_t allocs;
+	atomic_size_t frees;
+	atomic_size_t reallocs;
+	atomic_size_t bytes;
+	atomic_size_t live;
+	atomic_size_t peak;
+} mem_stat_t;
+
+
+static const char *tag_kind_str(unsigned tag, unsigned kind);
+static void        stat_alloc(mem_stat_t *stat, size_t size);
+static void        stat_free(mem_stat_t *stat, size_t size);
+static void        stat_fprint(
+	FILE             *stream,
+	const char       *name,
+	mem_stat_t       *stat);
+static void        stat_peak(mem_stat_t *stat, size_t live);
+static void        stat_realloc(mem_stat_t *stat, size_t old, size_t new);
+
+
+#endif  /* JKCC_PRIVATE_MEM_H */
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * pass.h -- ir pass manager
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_PASS_H
+#define JKCC_PRIVATE_PASS_H
+
+
+#include <jkcc/ir/pass.h>
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/sched.h>
+
+
+#define PASS_LIST_SEPARATOR ','
+
+
+typedef struct pass_work_s {
+	const ir_pass_id_t  *pipeline;
+	size_t               passes;
+	sched_t             *sched;   // NULL runs serially
+	ir_pass_stat_t     (*stat)[IR_PASSES_TOTAL];  // of each worker
+	atomic_int           ret;
+} pass_work_t;
+
+typedef struct pass_task_s {
+	pass_work_t   *work;
+	ir_function_t *ir_function;
+} pass_task_t;
+
+
+static void     count(
+	ir_function_t       *ir_function,
+	int64_t             *quads,
+	int64_t             *bbs);
+static void     count_unit(
+	ir_unit_t           *ir_unit,
+	int64_t             *quads,
+	int64_t             *bbs);
+static uint64_t now(
+	void);
+static int      run_function(
+	pass_work_t         *work,
+	ir_function_t       *ir_function);
+static int      run_functions(
+	ir_pass_manager_t   *ir_pass_manager,
+	ir_unit_t           *ir_unit,
+	const ir_pass_id_t  *pipeline,
+	size_t               passes);
+static void     run_task(
+	void                *arg);
+static int      run_unit(
+	ir_pass_manager_t   *ir_pass_manager,
+	ir_unit_t           *ir_unit,
+	ir_pass_id_t         id);
+
+
+#endif  /* JKCC_PRIVATE_PASS_H */
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * perf.h -- hardware performance counters
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_PERF_H
+#define JKCC_PRIVATE_PERF_H
+
+
+#include <jkcc/perf.h>
+
+#include <stdint.h>
+
+
+static uint64_t read_counter(int fd);
+
+
+#endif  /* JKCC_PRIVATE_PERF_H */
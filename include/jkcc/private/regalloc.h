@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * regalloc.h -- linear-scan register allocation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_REGALLOC_H
+#define JKCC_PRIVATE_REGALLOC_H
+
+
+#include <jkcc/ir/regalloc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define REGALLOC_NONE SIZE_MAX
+
+// positions: quad n of a bb uses at from + 2n + 2 and defines one later
+#define REGALLOC_POS(from, n) ((from) + 2 * ((n) + 1))
+
+
+
+typedef struct regalloc_interval_s regalloc_interval_t;
+
+struct regalloc_interval_s {
+	uintptr_t            vreg;
+	ir_reg_type_t        type;
+	size_t               start;
+	size_t               end;
+	size_t               split;  // register only holds vreg before split
+	size_t               reg;    // REGALLOC_NONE when only in memory
+	size_t               slot;
+	vector_t             use;    // size_t, ascending
+	regalloc_interval_t *hint;   // dies where this starts, to coalesce with
+};
+
+typedef struct regalloc_s {
+	ir_function_t        *ir_function;
+	ir_cfg_t              ir_cfg;
+	ir_liveness_t         liveness;
+	size_t                argc;
+	size_t                bbs;
+	size_t                vregs;
+	size_t               *from;      // first position of a bb
+	size_t               *to;        // last position of a bb
+	size_t               *pred_to;   // last position branching to a bb
+	regalloc_interval_t  *interval;  // indexed by vreg
+	regalloc_interval_t **sorted;    // by start
+	size_t                intervals;
+	regalloc_interval_t **active;
+	size_t               *pool;      // free registers
+	size_t                slots;
+	size_t                scratch;   // registers to reload operands into
+} regalloc_t;
+
+
+static int    analyze(regalloc_t *regalloc);
+static void   coalesce(regalloc_t *regalloc);
+static void   context_free(regalloc_t *regalloc);
+static int    emit_reload(
+	regalloc_t          *regalloc,
+	vector_t            *quad,
+	size_t               reg,
+	regalloc_interval_t *interval);
+static int    emit_spill(
+	regalloc_t          *regalloc,
+	vector_t            *quad,
+	size_t               reg,
+	regalloc_interval_t *interval);
+static int    interval_cmp(const void *a, const void *b);
+static int    interval_use(regalloc_interval_t *interval, size_t pos);
+static int    intervals(regalloc_t *regalloc);
+static size_t next_use(regalloc_interval_t *interval, size_t pos);
+static int    rewrite(regalloc_t *regalloc, size_t scratch);
+static int    rewrite_bb(regalloc_t *regalloc, size_t bb, size_t scratch);
+static size_t scan(regalloc_t *regalloc, size_t registers);
+
+
+#endif  /* JKCC_PRIVATE_REGALLOC_H */
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * sched.h -- work-stealing task scheduler
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_SCHED_H
+#define JKCC_PRIVATE_SCHED_H
+
+
+#include <jkcc/sched.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+static void           *arena_alloc(sched_arena_t *arena, size_t size);
+static void            arena_free(sched_arena_t *arena);
+static void            arena_reset(sched_arena_t *arena);
+static sched_worker_t *current(const sched_t *sched);
+static int             deque_init(sched_deque_t *deque);
+static void            deque_free(sched_deque_t *deque);
+static sched_task_t   *find(sched_worker_t *worker);
+static sched_array_t  *grow(
+	sched_deque_t    *deque,
+	sched_array_t    *array,
+	int_least64_t     top,
+	int_least64_t     bottom);
+static void           *loop(void *arg);
+static int             push(sched_deque_t *deque, sched_task_t *task);
+static uint64_t        rng(sched_worker_t *worker);
+static void            run(sched_worker_t *worker, sched_task_t *task);
+static sched_task_t   *steal(sched_deque_t *deque);
+static sched_task_t   *take(sched_deque_t *deque);
+
+
+#endif  /* JKCC_PRIVATE_SCHED_H */
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * select.h -- select basic block
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_SELECT_H
+#define JKCC_PRIVATE_SELECT_H
+
+
+#include <jkcc/ir/bb/select.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+
+
+#define SELECT_COST_MAX 4  // quads an arm may cost to always be evaluated
+
+
+// a cmp still to be issued, and what reads its flags as true
+typedef struct select_cmp_s {
+	ir_quad_br_condition_t condition;
+	uintptr_t              lhs;
+	uintptr_t              rhs;
+} select_cmp_t;
+
+
+static int    branch(
+	ir_context_t           *ir_context,
+	ast_t                  *ast);
+static int    choose(
+	ir_context_t           *ir_context,
+	ir_quad_br_condition_t  condition,
+	ir_reg_type_t           type,
+	uintptr_t               lhs,
+	uintptr_t               rhs);
+static int    compare(
+	ir_context_t           *ir_context,
+	const select_cmp_t     *select_cmp);
+static size_t cost(
+	ast_t                  *ast);
+static int    logical(
+	ir_context_t           *ir_context,
+	ast_t                  *ast,
+	bool                    and);
+static int    operands(
+	ir_context_t           *ir_context,
+	ast_t                  *ast,
+	select_cmp_t           *select_cmp);
+static int    relational(
+	uint_fast32_t           operator,
+	ir_quad_br_condition_t *condition);
+static int    ternary(
+	ir_context_t           *ir_context,
+	ast_t                  *ast);
+
+
+#endif  /* JKCC_PRIVATE_SELECT_H */
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * simplify.h -- control-flow simplification
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_SIMPLIFY_H
+#define JKCC_PRIVATE_SIMPLIFY_H
+
+
+#include <jkcc/ir/simplify.h>
+
+#include <stddef.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+
+
+static size_t forward(
+	ir_function_t *ir_function,
+	ht_t          *index,
+	size_t         bb);
+static void   terminate(
+	ir_function_t *ir_function);
+static int    thread(
+	ir_function_t *ir_function,
+	ht_t          *index);
+static int    unreachable(
+	ir_function_t *ir_function);
+
+
+#endif  /* JKCC_PRIVATE_SIMPLIFY_H */
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * tail.h -- tail calls
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_TAIL_H
+#define JKCC_PRIVATE_TAIL_H
+
+
+#include <jkcc/ir/tail.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+
+
+#define TAIL_ARGV_MAX 8
+
+
+static bool escapes(
+	ir_function_t *ir_function,
+	bitset_t      *frame);
+static int  loop(
+	ir_function_t *ir_function,
+	size_t         bb,
+	size_t         pos);
+static bool returns(
+	ir_function_t *ir_function,
+	ht_t          *index,
+	size_t         bb,
+	uintptr_t      dst);
+
+
+#endif  /* JKCC_PRIVATE_TAIL_H */
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * trace-decode.h -- decode binary execution traces
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_TRACE_DECODE_H
+#define JKCC_PRIVATE_TRACE_DECODE_H
+
+
+#include <argp.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <jkcc/trace.h>
+#include <jkcc/vector.h>
+
+
+typedef struct decode_site_s {
+	trace_site_type_t  type;
+	int                line;
+	char              *file;
+	char              *func;
+	char              *format;
+	char              *args;
+} decode_site_t;
+
+
+static int     decode(const char *path);
+static int     fprint_arg(
+	FILE                       *stream,
+	const char                 *spec,
+	size_t                      len,
+	trace_arg_t                 arg,
+	uint64_t                    raw);
+static void    fprint_event(
+	FILE                       *stream,
+	const decode_site_t        *site,
+	const trace_binary_event_t *event);
+static void    fprint_literal(FILE *stream, const char *str, size_t len);
+static void    free_sites(vector_t *sites);
+static error_t parse_opt(int key, char *arg, struct argp_state *state);
+static char   *read_string(FILE *stream, size_t len);
+static int     read_sites(FILE *stream, vector_t *sites);
+
+
+#endif  /* JKCC_PRIVATE_TRACE_DECODE_H */
@@ -10,12 +10,35 @@
 
 #include <jkcc/trace.h>
 
-
-#define ISO_8601_2000_FORMAT "yyyy-hh-mmThh:mm:ss-hhmm"
-#define TRACE_ARGS_DELIM     " ,\t\n"
-
-
-static void print_time(trace_t *trace);
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define ISO_8601_2000_FORMAT   "yyyy-hh-mmThh:mm:ss-hhmm"
+#define TRACE_ARGS_DELIM       " ,\t\n"
+#define TRACE_ARGS_FORMAT_SIZE 512
+
+
+typedef struct trace_ring_s {
+	struct trace_ring_s *next;  // of every thread's ring
+	size_t               use;
+	trace_binary_event_t event[TRACE_BINARY_RING_SIZE];
+} trace_ring_t;
+
+
+static void     print_time(trace_t *trace);
+static trace_ring_t *ring_self(void);
+static int      format_append(
+	char         *fmt,
+	size_t       *use,
+	const char   *str,
+	size_t        len);
+static bool     site_match(const trace_site_t *site, const char *pattern);
+static uint32_t site_id(trace_t *trace, trace_site_t *site);
+static void     trace_event(trace_t *trace, trace_site_t *site, va_list *ap);
+static int      write_all(int fd, const void *buf, size_t len);
 
 
 #endif  /* JKCC_PRIVATE_TRACE_H */
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * unroll.h -- loop unrolling
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_UNROLL_H
+#define JKCC_PRIVATE_UNROLL_H
+
+
+#include <jkcc/ir/unroll.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define UNROLL_BODY_MAX  32   // quads in a loop worth unrolling
+#define UNROLL_FACTOR    4    // copies of the body per trip around
+#define UNROLL_FULL_MAX  128  // quads a loop may grow to fully unrolled
+#define UNROLL_INIT_HOPS 4    // bbs searched back for the initial count
+
+
+typedef struct unroll_s {
+	size_t   bb;    // next unused bb id in the unit
+	vector_t done;  // size_t, ids of headers already looked at
+} unroll_t;
+
+typedef struct unroll_loop_s {
+	ir_function_t          *ir_function;
+	const ir_cfg_t         *ir_cfg;
+	const ir_loop_t        *ir_loop;
+	ir_iv_t                 ir_iv;
+	ir_iv_counted_t         counted;
+	size_t                  size;       // quads in the body
+	size_t                  trip;       // SIZE_MAX unless known
+	size_t                  factor;     // copies of the body
+} unroll_loop_t;
+
+
+static int                    append(
+	ir_bb_t                *ir_bb,
+	ir_quad_t              *ir_quad);
+static bool                   counted(
+	unroll_loop_t          *loop,
+	const ir_loop_nest_t   *ir_loop_nest);
+static int                    expand(
+	unroll_t               *unroll,
+	unroll_loop_t          *loop);
+static bool                   falls(
+	const ir_bb_t          *ir_bb);
+static int                    function(
+	unroll_t               *unroll,
+	ir_function_t          *ir_function);
+static bool                   holds(
+	ir_quad_br_condition_t  condition,
+	int64_t                 lhs,
+	int64_t                 rhs);
+static bool                   initial(
+	const unroll_loop_t    *loop,
+	int64_t                *init);
+static size_t                 lookup(
+	const ir_function_t    *ir_function,
+	size_t                  id);
+static int                    place(
+	const unroll_loop_t    *loop,
+	size_t                  bb,
+	size_t                  quads,
+	const size_t           *target,
+	const uintptr_t        *rename,
+	ir_bb_t                *dst);
+static bool                   plan(
+	unroll_loop_t          *loop);
+static bool                   scan(
+	unroll_loop_t          *loop);
+static void                   widen(
+	vector_t               *vector,
+	size_t                  pos,
+	size_t                  count);
+
+
+#endif  /* JKCC_PRIVATE_UNROLL_H */
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * vectorize.h -- loop vectorization
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_VECTORIZE_H
+#define JKCC_PRIVATE_VECTORIZE_H
+
+
+#include <jkcc/ir/vectorize.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+#define VECTORIZE_BODY_MAX     64  // quads in a loop worth vectorizing
+#define VECTORIZE_CHECKS_MAX   6   // overlap tests worth running up front
+#define VECTORIZE_LANES        4   // i32 lanes, as many as an xmm register
+#define VECTORIZE_PATTERNS_MAX 4   // vector quads per trip around
+#define VECTORIZE_STRIDE       4   // bytes a stream steps every trip around
+#define VECTORIZE_STREAMS_MAX  (VECTORIZE_PATTERNS_MAX * 3)
+#define VECTORIZE_WINDOW       (VECTORIZE_LANES * VECTORIZE_STRIDE)
+
+
+typedef struct vectorize_s {
+	size_t   bb;    // next unused bb id in the unit
+	vector_t done;  // size_t, ids of headers already looked at
+} vectorize_t;
+
+// addresses of the same basic iv, scale, and base are the same stream
+typedef struct vectorize_stream_s {
+	size_t    basic;
+	int64_t   scale;  // 0 for a pointer basic iv itself
+	uintptr_t key;    // base, or the cell it is loaded from
+	bool      cell;
+	bool      store;  // written through
+	uintptr_t reg;    // one of its addresses
+} vectorize_stream_t;
+
+// store (binop (load lhs) (load rhs)) dst, by position in the body
+typedef struct vectorize_pattern_s {
+	size_t    lhs;
+	size_t    rhs;
+	size_t    binop;
+	size_t    store;
+	uintptr_t address[3];  // dst, lhs, rhs
+} vectorize_pattern_t;
+
+typedef struct vectorize_loop_s {
+	ir_function_t       *ir_function;
+	const ir_cfg_t      *ir_cfg;
+	const ir_loop_t     *ir_loop;
+	ir_iv_t              ir_iv;
+	ir_iv_counted_t      counted;
+	size_t               body;      // bb index
+	size_t               first;     // position of the first basic store
+	size_t               checks;    // stream pairs that may overlap
+	size_t               patterns;
+	size_t               streams;
+	vectorize_pattern_t  pattern[VECTORIZE_PATTERNS_MAX];
+	vectorize_stream_t   stream[VECTORIZE_STREAMS_MAX];
+} vectorize_loop_t;
+
+
+static int                        append(
+	ir_bb_t                    *ir_bb,
+	ir_quad_t                  *ir_quad);
+static int                        body(
+	const vectorize_loop_t     *loop,
+	const uintptr_t            *rename,
+	size_t                      guard,
+	ir_bb_t                    *dst);
+static int                        checks(
+	const vectorize_loop_t     *loop,
+	uintptr_t                  *rename,
+	uintptr_t                  *next,
+	size_t                      guard,
+	ir_bb_t                    *dst);
+static bool                       classify(
+	vectorize_loop_t           *loop,
+	uintptr_t                   reg,
+	bool                        store);
+static bool                       counted(
+	vectorize_loop_t           *loop,
+	const ir_loop_nest_t       *ir_loop_nest);
+static ir_quad_t                 *definition(
+	const vectorize_loop_t     *loop,
+	uintptr_t                   reg);
+static int                        expand(
+	vectorize_t                *vectorize,
+	vectorize_loop_t           *loop);
+static bool                       falls(
+	const ir_bb_t              *ir_bb);
+static bool                       fold(
+	vectorize_loop_t           *loop,
+	size_t                      pos);
+static int                        function(
+	vectorize_t                *vectorize,
+	ir_function_t              *ir_function);
+static int                        guard(
+	const vectorize_loop_t     *loop,
+	const uintptr_t            *rename,
+	uintptr_t                  *next,
+	size_t                      body,
+	ir_bb_t                    *dst);
+static bool                       inside(
+	const vectorize_loop_t     *loop,
+	uintptr_t                   reg);
+static const vectorize_pattern_t *member(
+	const vectorize_loop_t     *loop,
+	size_t                      pos);
+static bool                       private(
+	const vectorize_loop_t     *loop,
+	uintptr_t                   cell);
+static bool                       scan(
+	vectorize_loop_t           *loop);
+static int                        slice(
+	const vectorize_loop_t     *loop,
+	uintptr_t                   reg,
+	uintptr_t                  *rename,
+	uintptr_t                  *next,
+	ir_bb_t                    *dst);
+static size_t                     stepper(
+	const vectorize_loop_t     *loop,
+	size_t                      pos);
+static void                       widen(
+	vector_t                   *vector,
+	size_t                      pos,
+	size_t                      count);
+
+
+#endif  /* JKCC_PRIVATE_VECTORIZE_H */
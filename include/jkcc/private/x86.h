@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * x86.h -- x86-64 machine code encoder
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_PRIVATE_X86_H
+#define JKCC_PRIVATE_X86_H
+
+
+#include <jkcc/x86.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+#define X86_REX   0x40
+#define X86_REX_W 0x08
+#define X86_REX_R 0x04
+#define X86_REX_X 0x02
+#define X86_REX_B 0x01
+
+#define X86_MOD_DISP8  0x40
+#define X86_MOD_DISP32 0x80
+#define X86_MOD_REG    0xc0
+
+#define X86_RM_RIP 0x05
+#define X86_SIB_SP 0x24
+
+
+static void byte(
+	x86_t     *x86,
+	uint8_t    val);
+static void imm32(
+	x86_t     *x86,
+	int32_t    val);
+static void modrm_mem(
+	x86_t     *x86,
+	unsigned   reg,
+	x86_reg_t  base,
+	int32_t    disp);
+static void modrm_reg(
+	x86_t     *x86,
+	unsigned   reg,
+	x86_reg_t  rm);
+static void rex(
+	x86_t     *x86,
+	bool       wide,
+	unsigned   reg,
+	x86_reg_t  base);
+
+
+#endif  /* JKCC_PRIVATE_X86_H */
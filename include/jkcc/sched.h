@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * sched.h -- work-stealing task scheduler
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_SCHED_H
+#define JKCC_SCHED_H
+
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define SCHED_DEQUE_MIN   64           // power of two
+#define SCHED_ARENA_BLOCK (64 * 1024)
+#define SCHED_SPINS       64           // before an idle worker sleeps
+
+#define SCHED_ERROR_NOMEM  (-1)
+#define SCHED_ERROR_THREAD (-2)
+
+
+typedef void (*sched_fn_t)(void *arg);
+
+typedef struct sched_group_s {
+	atomic_size_t pending;
+} sched_group_t;
+
+typedef struct sched_task_s {
+	sched_fn_t     fn;
+	void          *arg;
+	sched_group_t *group;
+} sched_task_t;
+
+typedef struct sched_array_s {
+	struct sched_array_s   *retired;  // freed with the deque
+	size_t                  mask;
+	_Atomic(sched_task_t*)  task[];
+} sched_array_t;
+
+// chase-lev: the owner pushes and takes at the bottom,
+// thieves steal from the top
+typedef struct sched_deque_s {
+	atomic_int_least64_t    top;
+	atomic_int_least64_t    bottom;
+	_Atomic(sched_array_t*) array;
+} sched_deque_t;
+
+typedef struct sched_arena_block_s {
+	struct sched_arena_block_s *next;
+	size_t                      size;
+	size_t                      used;
+	max_align_t                 data[];
+} sched_arena_block_t;
+
+typedef struct sched_arena_s {
+	sched_arena_block_t *block;  // current first
+} sched_arena_t;
+
+typedef struct sched_stat_s {
+	uint64_t spawned;
+	uint64_t executed;
+	uint64_t stolen;
+	uint64_t inlined;  // run by sched_spawn itself
+} sched_stat_t;
+
+typedef struct sched_s sched_t;
+
+typedef struct sched_worker_s {
+	sched_t       *sched;
+	size_t         id;
+	pthread_t      thread;
+	bool           started;
+	size_t         depth;   // tasks being run on this worker
+	uint64_t       rng;     // victim selection
+	sched_deque_t  deque;
+	sched_arena_t  arena;
+	sched_stat_t   stat;
+} sched_worker_t;
+
+// worker 0 is the thread that called sched_init()
+struct sched_s {
+	sched_worker_t  *worker;
+	size_t           workers;
+	atomic_size_t    queued;
+	atomic_size_t    live;
+	atomic_size_t    sleeping;
+	atomic_bool      stop;
+	pthread_mutex_t  mutex;
+	pthread_cond_t   cond;
+};
+
+
+void *sched_alloc(
+	sched_t        *sched,
+	size_t          size);
+void sched_free(
+	sched_t        *sched);
+void sched_group_init(
+	sched_group_t  *group);
+int sched_init(
+	sched_t        *sched,
+	size_t          workers);
+void sched_reset(
+	sched_t        *sched);
+void sched_spawn(
+	sched_t        *sched,
+	sched_group_t  *group,
+	sched_fn_t      fn,
+	void           *arg);
+void sched_stat(
+	const sched_t  *sched,
+	sched_stat_t   *stat);
+void sched_wait(
+	sched_t        *sched,
+	sched_group_t  *group);
+size_t sched_worker(
+	const sched_t  *sched);
+
+
+#endif  /* JKCC_SCHED_H */
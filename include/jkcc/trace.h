@@ -8,74 +8,170 @@
 #define JKCC_TRACE_H
 
 
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <stdio.h>
 
+#include <jkcc/config.h>
+
 
 #define JKCC_TRACE_LEVEL_NONE   0
 #define JKCC_TRACE_LEVEL_LOW    1
 #define JKCC_TRACE_LEVEL_MEDIUM 2
 #define JKCC_TRACE_LEVEL_HIGH   3
 
-#define TRACE_ARGS(trace, format, ...) {               \
-	if ((trace)->level >= JKCC_TRACE_LEVEL_MEDIUM) \
-		trace_args(                            \
-			trace,                         \
-			__FILE__,                      \
-			__func__,                      \
-			format,                        \
-			#__VA_ARGS__,                  \
-			__VA_ARGS__);                  \
+#define TRACE_BINARY_MAGIC       "jkcctrc"
+#define TRACE_BINARY_VERSION     1
+#define TRACE_BINARY_RECORD_ARGS 6
+#define TRACE_BINARY_RING_SIZE   4096
+
+#define TRACE_SITES_SECTION "jkcc_trace_sites"
+
+#ifdef JKCC_CONFIG_OPTION_TRACE
+#define TRACE_FIRST(first, ...) first
+
+#define TRACE_SITE(site_type, format_str, args_str)               \
+	static trace_site_t trace_site = {                        \
+		.enabled = true,                                  \
+		.type    = site_type,                             \
+		.file    = __FILE__,                              \
+		.func    = __func__,                              \
+		.line    = __LINE__,                              \
+		.format  = format_str,                            \
+		.args    = args_str,                              \
+	};                                                        \
+	static trace_site_t *const trace_site_entry               \
+	__attribute__((section(TRACE_SITES_SECTION), used))       \
+		= &trace_site
+
+#define TRACE_ARGS(trace, format, ...) {                               \
+	TRACE_SITE(TRACE_SITE_ARGS, format, #__VA_ARGS__);             \
+                                                                       \
+	if (trace_site.enabled                                         \
+		&& (trace)->level >= JKCC_TRACE_LEVEL_MEDIUM)          \
+		trace_args(trace, &trace_site, __VA_ARGS__);           \
 }
 
-#define TRACE_PRINTF(trace, ...) {                  \
-	if ((trace)->level >= JKCC_TRACE_LEVEL_LOW) \
-		trace_printf(                       \
-			trace,                      \
-			__FILE__,                   \
-			__func__,                   \
-			__LINE__,                   \
-			__VA_ARGS__);               \
+#define TRACE_PRINTF(trace, ...) {                                     \
+	TRACE_SITE(                                                    \
+		TRACE_SITE_PRINTF,                                     \
+		TRACE_FIRST(__VA_ARGS__, 0),                           \
+		#__VA_ARGS__);                                         \
+                                                                       \
+	if (trace_site.enabled                                         \
+		&& (trace)->level >= JKCC_TRACE_LEVEL_LOW)             \
+		trace_printf(trace, &trace_site, __VA_ARGS__);         \
 }
 
-#define TRACE_RULE(trace, rule, match) {            \
-	if ((trace)->level >= JKCC_TRACE_LEVEL_LOW) \
-		trace_rule(                         \
-			trace,                      \
-			__FILE__,                   \
-			__func__,                   \
-			rule,                       \
-			match);                     \
+#define TRACE_RULE(trace, rule, match) {                               \
+	TRACE_SITE(TRACE_SITE_RULE, rule, match);                      \
+                                                                       \
+	if (trace_site.enabled                                         \
+		&& (trace)->level >= JKCC_TRACE_LEVEL_LOW)             \
+		trace_rule(trace, &trace_site);                        \
 }
+#else  /* JKCC_CONFIG_OPTION_TRACE */
+#define TRACE_ARGS(trace, format, ...) {}
+#define TRACE_PRINTF(trace, ...)       {}
+#define TRACE_RULE(trace, rule, match) {}
+#endif  /* JKCC_CONFIG_OPTION_TRACE */
+
+
+typedef enum trace_site_type_e {
+	TRACE_SITE_ARGS,
+	TRACE_SITE_PRINTF,
+	TRACE_SITE_RULE,
+} trace_site_type_t;
+
+typedef struct trace_site_s {
+	atomic_uint_least32_t  id;
+	bool                   enabled;
+	trace_site_type_t      type;
+	const char            *file;
+	const char            *func;
+	int                    line;
+	const char            *format;
+	const char            *args;
+} trace_site_t;
+
+typedef enum trace_binary_kind_e {
+	TRACE_BINARY_KIND_EVENT = 1,
+	TRACE_BINARY_KIND_SITE  = 2,
+} trace_binary_kind_t;
+
+typedef enum trace_arg_e {
+	TRACE_ARG_NONE,
+	TRACE_ARG_INT,
+	TRACE_ARG_LONG,
+	TRACE_ARG_LONG_LONG,
+	TRACE_ARG_INTMAX,
+	TRACE_ARG_SIZE,
+	TRACE_ARG_PTRDIFF,
+	TRACE_ARG_DOUBLE,
+	TRACE_ARG_LONG_DOUBLE,
+	TRACE_ARG_POINTER,
+} trace_arg_t;
+
+typedef struct trace_binary_header_s {
+	char     magic[8];
+	uint32_t version;
+	uint32_t event_size;
+} trace_binary_header_t;
+
+typedef struct trace_binary_event_s {
+	uint32_t kind;
+	uint32_t site;
+	uint64_t timestamp;
+	uint64_t arg[TRACE_BINARY_RECORD_ARGS];
+} trace_binary_event_t;
 
+typedef struct trace_binary_site_s {
+	uint32_t kind;
+	uint32_t site;
+	uint32_t type;
+	int32_t  line;
+	uint32_t file_len;
+	uint32_t func_len;
+	uint32_t format_len;
+	uint32_t args_len;
+} trace_binary_site_t;
 
 typedef struct trace_s {
 	FILE *stream;
 	bool  ansi_sgr;
 	int   level;
+	int   binary;
 } trace_t;
 
 
 void trace_args(
-	trace_t    *trace,
-	const char *file,
-	const char *func,
-	const char *args,
-	const char *format,
+	trace_t      *trace,
+	trace_site_t *site,
 	...);
+const char *trace_arg_next(
+	const char   *format,
+	trace_arg_t  *arg,
+	size_t       *len);
+int  trace_binary_close(
+	trace_t      *trace);
+int  trace_binary_flush(
+	trace_t      *trace);
+int  trace_binary_open(
+	trace_t      *trace,
+	const char   *path);
 void trace_printf(
-	trace_t    *trace,
-	const char *file,
-	const char *func,
-	const int   line,
-	const char *format,
+	trace_t      *trace,
+	trace_site_t *site,
 	...);
 void trace_rule(
-	trace_t    *trace,
-	const char *file,
-	const char *func,
-	const char *rule,
-	const char *match);
+	trace_t      *trace,
+	trace_site_t *site);
+size_t trace_sites_enable(
+	const char   *pattern);
+void trace_sites_set(
+	bool          enabled);
 
 
 #endif  /* JKCC_TRACE_H */
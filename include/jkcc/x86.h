@@ -0,0 +1,246 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * x86.h -- x86-64 machine code encoder
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#ifndef JKCC_X86_H
+#define JKCC_X86_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define X86_DEFAULT_SIZE 4096
+
+
+typedef enum x86_reg_e {
+	X86_RAX,
+	X86_RCX,
+	X86_RDX,
+	X86_RBX,
+	X86_RSP,
+	X86_RBP,
+	X86_RSI,
+	X86_RDI,
+	X86_R8,
+	X86_R9,
+	X86_R10,
+	X86_R11,
+	X86_R12,
+	X86_R13,
+	X86_R14,
+	X86_R15,
+	X86_REGS_TOTAL,
+} x86_reg_t;
+
+typedef enum x86_xmm_e {
+	X86_XMM0,
+	X86_XMM1,
+	X86_XMM2,
+	X86_XMM3,
+	X86_XMM4,
+	X86_XMM5,
+	X86_XMM6,
+	X86_XMM7,
+	X86_XMM8,
+	X86_XMM9,
+	X86_XMM10,
+	X86_XMM11,
+	X86_XMM12,
+	X86_XMM13,
+	X86_XMM14,
+	X86_XMM15,
+	X86_XMMS_TOTAL,
+} x86_xmm_t;
+
+// condition codes as encoded in jcc and setcc
+typedef enum x86_cc_e {
+	X86_CC_O,
+	X86_CC_NO,
+	X86_CC_B,
+	X86_CC_AE,
+	X86_CC_E,
+	X86_CC_NE,
+	X86_CC_BE,
+	X86_CC_A,
+	X86_CC_S,
+	X86_CC_NS,
+	X86_CC_P,
+	X86_CC_NP,
+	X86_CC_L,
+	X86_CC_GE,
+	X86_CC_LE,
+	X86_CC_G,
+} x86_cc_t;
+
+// opcode of the 'op r/m, r' form, the /digit of 'op r/m, imm32' is op >> 3
+typedef enum x86_alu_e {
+	X86_ALU_ADD = 0x01,
+	X86_ALU_OR  = 0x09,
+	X86_ALU_AND = 0x21,
+	X86_ALU_SUB = 0x29,
+	X86_ALU_XOR = 0x31,
+	X86_ALU_CMP = 0x39,
+} x86_alu_t;
+
+// /digit of 'op r/m, cl'
+typedef enum x86_shift_e {
+	X86_SHIFT_SHL = 4,
+	X86_SHIFT_SHR = 5,
+	X86_SHIFT_SAR = 7,
+} x86_shift_t;
+
+// opcode after 66 0f of the sse2 'op xmm, xmm' on 32-bit lanes
+typedef enum x86_sse_e {
+	X86_SSE_PAND  = 0xdb,
+	X86_SSE_POR   = 0xeb,
+	X86_SSE_PXOR  = 0xef,
+	X86_SSE_PSUBD = 0xfa,
+	X86_SSE_PADDD = 0xfe,
+} x86_sse_t;
+
+typedef struct x86_s {
+	uint8_t *buf;
+	size_t   use;
+	size_t   size;
+	bool     nomem;  // sticky, checked once encoding is done
+} x86_t;
+
+
+void x86_alu(
+	x86_t       *x86,
+	x86_alu_t    op,
+	bool         wide,
+	x86_reg_t    dst,
+	x86_reg_t    src);
+void x86_alu_imm(
+	x86_t       *x86,
+	x86_alu_t    op,
+	bool         wide,
+	x86_reg_t    dst,
+	int32_t      imm);
+size_t x86_call(
+	x86_t       *x86);
+void x86_cmov(
+	x86_t       *x86,
+	x86_cc_t     cc,
+	x86_reg_t    dst,
+	x86_reg_t    src);
+void x86_cqo(
+	x86_t       *x86);
+void x86_emit(
+	x86_t       *x86,
+	const void  *buf,
+	size_t       size);
+void x86_free(
+	x86_t       *x86);
+void x86_idiv(
+	x86_t       *x86,
+	bool         wide,
+	x86_reg_t    src);
+void x86_imul(
+	x86_t       *x86,
+	bool         wide,
+	x86_reg_t    dst,
+	x86_reg_t    src);
+int x86_init(
+	x86_t       *x86);
+size_t x86_jcc(
+	x86_t       *x86,
+	x86_cc_t     cc);
+size_t x86_jmp(
+	x86_t       *x86);
+void x86_lea(
+	x86_t       *x86,
+	x86_reg_t    dst,
+	x86_reg_t    base,
+	int32_t      disp);
+size_t x86_lea_rip(
+	x86_t       *x86,
+	x86_reg_t    dst);
+void x86_load(
+	x86_t       *x86,
+	bool         wide,
+	x86_reg_t    dst,
+	x86_reg_t    base,
+	int32_t      disp);
+void x86_load_sx32(
+	x86_t       *x86,
+	x86_reg_t    dst,
+	x86_reg_t    base,
+	int32_t      disp);
+void x86_load_xmm(
+	x86_t       *x86,
+	x86_xmm_t    dst,
+	x86_reg_t    base,
+	int32_t      disp);
+void x86_mov(
+	x86_t       *x86,
+	bool         wide,
+	x86_reg_t    dst,
+	x86_reg_t    src);
+void x86_mov_imm(
+	x86_t       *x86,
+	x86_reg_t    dst,
+	int64_t      imm);
+void x86_movsxd(
+	x86_t       *x86,
+	x86_reg_t    dst,
+	x86_reg_t    src);
+void x86_patch32(
+	x86_t       *x86,
+	size_t       offset,
+	int32_t      val);
+void x86_pop(
+	x86_t       *x86,
+	x86_reg_t    dst);
+void x86_push(
+	x86_t       *x86,
+	x86_reg_t    src);
+void x86_ret(
+	x86_t       *x86);
+void x86_setcc(
+	x86_t       *x86,
+	x86_cc_t     cc,
+	x86_reg_t    dst);
+void x86_shift(
+	x86_t       *x86,
+	x86_shift_t  op,
+	bool         wide,
+	x86_reg_t    dst);
+void x86_shift_imm(
+	x86_t       *x86,
+	x86_shift_t  op,
+	bool         wide,
+	x86_reg_t    dst,
+	uint8_t      imm);
+void x86_sse(
+	x86_t       *x86,
+	x86_sse_t    op,
+	x86_xmm_t    dst,
+	x86_xmm_t    src);
+void x86_store(
+	x86_t       *x86,
+	bool         wide,
+	x86_reg_t    base,
+	int32_t      disp,
+	x86_reg_t    src);
+void x86_store_imm(
+	x86_t       *x86,
+	bool         wide,
+	x86_reg_t    base,
+	int32_t      disp,
+	int32_t      imm);
+void x86_store_xmm(
+	x86_t       *x86,
+	x86_reg_t    base,
+	int32_t      disp,
+	x86_xmm_t    src);
+void x86_ud2(
+	x86_t       *x86);
+
+
+#endif  /* JKCC_X86_H */
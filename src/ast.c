@@ -9,12 +9,15 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
+#include <jkcc/json.h>
 #include <jkcc/list.h>
 #include <jkcc/location.h>
 #include <jkcc/parser.h>
 #include <jkcc/string.h>
+#include <jkcc/vector.h>
 
 
 void (*const ast_node_free[AST_NODES_TOTAL])(ast_t *ast) = {
@@ -119,6 +122,58 @@ void (*const fprint_ast_node[AST_NODES_TOTAL])(
 	[AST_WHILE]                    = fprint_ast_while,
 };
 
+void (*const fprint_ast_node_jsonl[AST_NODES_TOTAL])(
+	FILE         *stream,
+	const ast_t  *ast,
+	ast_jsonl_t  *jsonl) = {
+	[AST_ADDRESSOF]                = fprint_ast_addressof_jsonl,
+	[AST_ALIGNAS]                  = fprint_ast_alignas_jsonl,
+	[AST_ALIGNOF]                  = fprint_ast_alignof_jsonl,
+	[AST_ARRAY]                    = fprint_ast_array_jsonl,
+	[AST_ASSIGNMENT]               = fprint_ast_assignment_jsonl,
+	[AST_ATOMIC]                   = fprint_ast_atomic_jsonl,
+	[AST_BINARY_OPERATOR]          = fprint_ast_binary_operator_jsonl,
+	[AST_BREAK]                    = fprint_ast_break_jsonl,
+	[AST_CALL]                     = fprint_ast_call_jsonl,
+	[AST_CASE]                     = fprint_ast_case_jsonl,
+	[AST_CAST]                     = fprint_ast_cast_jsonl,
+	[AST_CHARACTER_CONSTANT]       = fprint_ast_character_constant_jsonl,
+	[AST_CONTINUE]                 = fprint_ast_continue_jsonl,
+	[AST_DECLARATION]              = fprint_ast_declaration_jsonl,
+	[AST_DEREFERENCE]              = fprint_ast_dereference_jsonl,
+	[AST_EMPTY]                    = fprint_ast_empty_jsonl,
+	[AST_EXPRESSION]               = fprint_ast_expression_jsonl,
+	[AST_FLOATING_CONSTANT]        = fprint_ast_floating_constant_jsonl,
+	[AST_FOR]                      = fprint_ast_for_jsonl,
+	[AST_FUNCTION]                 = fprint_ast_function_jsonl,
+	[AST_FUNCTION_SPECIFIER]       = fprint_ast_function_specifier_jsonl,
+	[AST_GENERIC_ASSOCIATION]      = fprint_ast_generic_association_jsonl,
+	[AST_GENERIC_ASSOCIATION_LIST] = fprint_ast_generic_association_list_jsonl,
+	[AST_GENERIC_SELECTION]        = fprint_ast_generic_selection_jsonl,
+	[AST_GOTO]                     = fprint_ast_goto_jsonl,
+	[AST_IDENTIFIER]               = fprint_ast_identifier_jsonl,
+	[AST_IF]                       = fprint_ast_if_jsonl,
+	[AST_INTEGER_CONSTANT]         = fprint_ast_integer_constant_jsonl,
+	[AST_LABEL]                    = fprint_ast_label_jsonl,
+	[AST_LIST]                     = fprint_ast_list_jsonl,
+	[AST_MEMBER_ACCESS]            = fprint_ast_member_access_jsonl,
+	[AST_POINTER]                  = fprint_ast_pointer_jsonl,
+	[AST_RETURN]                   = fprint_ast_return_jsonl,
+	[AST_SIZEOF]                   = fprint_ast_sizeof_jsonl,
+	[AST_STATIC_ASSERT]            = fprint_ast_static_assert_jsonl,
+	[AST_STORAGE_CLASS_SPECIFIER]  = fprint_ast_storage_class_specifier_jsonl,
+	[AST_STRING_LITERAL]           = fprint_ast_string_literal_jsonl,
+	[AST_STRUCT]                   = fprint_ast_struct_jsonl,
+	[AST_SWITCH]                   = fprint_ast_switch_jsonl,
+	[AST_TERNARY_OPERATOR]         = fprint_ast_ternary_operator_jsonl,
+	[AST_TRANSLATION_UNIT]         = fprint_ast_translation_unit_jsonl,
+	[AST_TYPE]                     = fprint_ast_type_jsonl,
+	[AST_TYPE_QUALIFIER]           = fprint_ast_type_qualifier_jsonl,
+	[AST_TYPE_SPECIFIER]           = fprint_ast_type_specifier_jsonl,
+	[AST_UNARY_OPERATOR]           = fprint_ast_unary_operator_jsonl,
+	[AST_WHILE]                    = fprint_ast_while_jsonl,
+};
+
 
 const char *const ast_node_str[AST_NODES_TOTAL] = {
 	[AST_ADDRESSOF]                = "addressof",
@@ -170,6 +225,86 @@ const char *const ast_node_str[AST_NODES_TOTAL] = {
 };
 
 
+void ast_jsonl_push(
+	ast_jsonl_t      *jsonl,
+	const ast_t      *ast,
+	const char       *edge,
+	size_t            index)
+{
+	ast_jsonl_node_t node = {
+		.ast    = ast,
+		.edge   = edge,
+		.index  = index,
+		.parent = jsonl->current,
+	};
+
+	if (vector_append(&jsonl->pending, &node)) jsonl->error = -1;
+}
+
+int fprint_ast_jsonl(
+	FILE             *stream,
+	const ast_t      *ast)
+{
+	ast_jsonl_t jsonl = {
+		.id      = 0,
+		.current = SIZE_MAX,
+		.error   = 0,
+	};
+
+	if (vector_init(&jsonl.pending, sizeof(ast_jsonl_node_t), 0))
+		return -1;
+
+	ast_jsonl_push(&jsonl, ast, NULL, SIZE_MAX);
+
+	ast_jsonl_node_t  node;
+	void             *dst = &node;
+
+	while (jsonl.pending.use && !jsonl.error) {
+		vector_pop(&jsonl.pending, &dst);
+
+		jsonl.current = jsonl.id++;
+
+		fprintf(stream, "{\"id\":%zu", jsonl.current);
+
+		if (node.parent != SIZE_MAX)
+			fprintf(stream, ",\"parent\":%zu", node.parent);
+		else
+			fprintf(stream, ",\"parent\":null");
+
+		if (node.edge) fprintf(stream, ",\"edge\":\"%s\"", node.edge);
+
+		if (node.index != SIZE_MAX)
+			fprintf(stream, ",\"index\":%zu", node.index);
+
+		fprintf(
+			stream,
+			",\"ast-type\":\"%s\"",
+			AST_NODE_STR(node.ast));
+
+		size_t mark = jsonl.pending.use;
+
+		fprint_ast_node_jsonl[*node.ast](stream, node.ast, &jsonl);
+
+		fprintf(stream, "}\n");
+
+		// children are emitted in pre-order, so undo the stack order
+		ast_jsonl_node_t *child = jsonl.pending.buf;
+		size_t            head  = mark;
+		size_t            tail  = jsonl.pending.use;
+
+		while (head + 1 < tail) {
+			ast_jsonl_node_t tmp = child[head];
+
+			child[head++] = child[--tail];
+			child[tail]   = tmp;
+		}
+	}
+
+	vector_free(&jsonl.pending);
+
+	return jsonl.error;
+}
+
 void fprint_file(
 	FILE             *stream,
 	const file_t     *file,
@@ -262,3 +397,25 @@ void fprint_location(
 
 	FPRINT_AST_FINISH;
 }
+
+void fprint_location_jsonl(
+	FILE             *stream,
+	const location_t *location)
+{
+	fprintf(stream, "{\"file\":");
+	fprint_json_string(stream, location->file->path);
+
+	fprintf(
+		stream,
+		",\"start\":{\"offset\":%ld,\"line\":%d,\"column\":%d}",
+		location->start.offset,
+		location->start.line,
+		location->start.column);
+
+	fprintf(
+		stream,
+		",\"end\":{\"offset\":%ld,\"line\":%d,\"column\":%d}}",
+		location->end.offset,
+		location->end.line,
+		location->end.column);
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_alignas_init(
@@ -20,7 +21,7 @@ ast_t *ast_alignas_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_alignas_t);
+	AST_INIT(ast_alignas_t, AST_ALIGNAS);
 
 	node->operand = operand;
 
@@ -35,7 +36,7 @@ void ast_alignas_free(ast_t *ast)
 
 	AST_NODE_FREE(node->operand);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_alignas(
@@ -50,3 +51,15 @@ void fprint_ast_alignas(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_alignas_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_alignas_t);
+
+	FPRINT_AST_JSONL_MEMBER("operand", node->operand);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_array_init(
@@ -22,7 +23,7 @@ ast_t *ast_array_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_array_t);
+	AST_INIT(ast_array_t, AST_ARRAY);
 
 	node->type_qualifier_list = type_qualifier_list;
 	node->size                = size;
@@ -47,7 +48,7 @@ void ast_array_free(ast_t *ast)
 	AST_NODE_FREE(node->type_qualifier_list);
 	AST_NODE_FREE(node->size);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_array_get_size(ast_t *array)
@@ -83,3 +84,17 @@ void fprint_ast_array(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_array_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_array_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_TYPE], node->type);
+	FPRINT_AST_JSONL_MEMBER("type-qualifier-list", node->type_qualifier_list);
+	FPRINT_AST_JSONL_MEMBER("size", node->size);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
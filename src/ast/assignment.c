@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_assignment_init(
@@ -23,7 +24,7 @@ ast_t *ast_assignment_init(
 	location_t    *location_start,
 	location_t    *location_end)
 {
-	AST_INIT(ast_assignment_t);
+	AST_INIT(ast_assignment_t, AST_ASSIGNMENT);
 
 	node->lvalue     = lvalue;
 	node->rvalue     = rvalue;
@@ -41,7 +42,7 @@ void ast_assignment_free(ast_t *ast)
 	AST_NODE_FREE(node->lvalue);
 	AST_NODE_FREE(node->rvalue);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 uint_fast16_t ast_assignment_get_assignment(ast_t *ast)
@@ -59,16 +60,12 @@ ast_t *ast_assignment_get_rvalue(ast_t *ast)
 	return OFFSETOF_AST_NODE(ast, ast_assignment_t)->rvalue;
 }
 
-void fprint_ast_assignment(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_assignment_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_assignment_t);
-
-	FPRINT_AST_MEMBER("lvalue", node->lvalue);
-	FPRINT_AST_MEMBER("rvalue", node->rvalue);
+	const ast_assignment_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_assignment_t);
 
 	const char *assignment;
 	switch (node->assignment) {
@@ -121,7 +118,36 @@ void fprint_ast_assignment(
 			break;
 	}
 
-	FPRINT_AST_FIELD(ast_node_str[AST_ASSIGNMENT], assignment);
+	return assignment;
+}
+
+void fprint_ast_assignment(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_assignment_t);
+
+	FPRINT_AST_MEMBER("lvalue", node->lvalue);
+	FPRINT_AST_MEMBER("rvalue", node->rvalue);
+
+	FPRINT_AST_FIELD(ast_node_str[AST_ASSIGNMENT], ast_assignment_str(ast));
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_assignment_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_assignment_t);
+
+	FPRINT_AST_JSONL_MEMBER("lvalue", node->lvalue);
+	FPRINT_AST_JSONL_MEMBER("rvalue", node->rvalue);
+
+	FPRINT_AST_JSONL_FIELD(ast_node_str[AST_ASSIGNMENT], ast_assignment_str(ast));
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
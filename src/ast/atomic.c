@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_atomic_init(
@@ -31,7 +32,7 @@ ast_t *ast_atomic_init(
 		return NULL;
 	}
 
-	AST_INIT(ast_atomic_t);
+	AST_INIT(ast_atomic_t, AST_ATOMIC);
 
 	node->operand = operand;
 
@@ -46,7 +47,7 @@ void ast_atomic_free(ast_t *ast)
 
 	AST_NODE_FREE(node->operand);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_atomic(
@@ -61,3 +62,15 @@ void fprint_ast_atomic(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_atomic_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_atomic_t);
+
+	FPRINT_AST_JSONL_MEMBER("operand", node->operand);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
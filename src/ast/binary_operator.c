@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_binary_operator_init(
@@ -23,7 +24,7 @@ ast_t *ast_binary_operator_init(
 	location_t    *location_start,
 	location_t    *location_end)
 {
-	AST_INIT(ast_binary_operator_t);
+	AST_INIT(ast_binary_operator_t, AST_BINARY_OPERATOR);
 
 	node->lhs = lhs;
 	node->rhs = rhs;
@@ -42,7 +43,7 @@ void ast_binary_operator_free(ast_t *ast)
 	AST_NODE_FREE(node->lhs);
 	AST_NODE_FREE(node->rhs);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_binary_operator_get_lhs(ast_t *ast)
@@ -60,16 +61,12 @@ ast_t *ast_binary_operator_get_rhs(ast_t *ast)
 	return OFFSETOF_AST_NODE(ast, ast_binary_operator_t)->rhs;
 }
 
-void fprint_ast_binary_operator(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_binary_operator_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_binary_operator_t);
-
-	FPRINT_AST_MEMBER("lhs", node->lhs);
-	FPRINT_AST_MEMBER("rhs", node->rhs);
+	const ast_binary_operator_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_binary_operator_t);
 
 	const char *operator;
 	switch (node->operator) {
@@ -154,7 +151,36 @@ void fprint_ast_binary_operator(
 			break;
 	}
 
-	FPRINT_AST_FIELD("operator", operator);
+	return operator;
+}
+
+void fprint_ast_binary_operator(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_binary_operator_t);
+
+	FPRINT_AST_MEMBER("lhs", node->lhs);
+	FPRINT_AST_MEMBER("rhs", node->rhs);
+
+	FPRINT_AST_FIELD("operator", ast_binary_operator_str(ast));
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_binary_operator_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_binary_operator_t);
+
+	FPRINT_AST_JSONL_MEMBER("lhs", node->lhs);
+	FPRINT_AST_JSONL_MEMBER("rhs", node->rhs);
+
+	FPRINT_AST_JSONL_FIELD("operator", ast_binary_operator_str(ast));
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,12 +14,13 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_break_init(
 	location_t *location)
 {
-	AST_INIT(ast_break_t);
+	AST_INIT(ast_break_t, AST_BREAK);
 
 	node->location = *location;
 
@@ -30,7 +31,7 @@ void ast_break_free(ast_t *ast)
 {
 	AST_FREE(ast_break_t);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_break(
@@ -43,3 +44,13 @@ void fprint_ast_break(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_break_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_break_t);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_call_init(
@@ -21,7 +22,7 @@ ast_t *ast_call_init(
 	location_t   *location_start,
 	location_t   *location_end)
 {
-	AST_INIT(ast_call_t);
+	AST_INIT(ast_call_t, AST_CALL);
 
 	node->expression    = expression;
 	node->argument_list = argument_list;
@@ -38,7 +39,7 @@ void ast_call_free(ast_t *ast)
 	AST_NODE_FREE(node->expression);
 	AST_NODE_FREE(node->argument_list);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_call_get_argument_list(ast_t *ast)
@@ -64,3 +65,16 @@ void fprint_ast_call(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_call_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_call_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_EXPRESSION], node->expression);
+	FPRINT_AST_JSONL_MEMBER("argument-list", node->argument_list);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_cast_init(
@@ -22,7 +23,7 @@ ast_t *ast_cast_init(
 	location_t   *location_start,
 	location_t   *location_end)
 {
-	AST_INIT(ast_cast_t);
+	AST_INIT(ast_cast_t, AST_CAST);
 
 	node->expression = expression;
 	node->type       = type;
@@ -39,7 +40,7 @@ void ast_cast_free(ast_t *ast)
 	AST_NODE_FREE(node->expression);
 	AST_NODE_FREE(node->type);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_cast(
@@ -55,3 +56,16 @@ void fprint_ast_cast(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_cast_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_cast_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_EXPRESSION], node->expression);
+	FPRINT_AST_JSONL_MEMBER("type", node->type);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
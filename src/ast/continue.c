@@ -14,12 +14,13 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_continue_init(
 	location_t *location)
 {
-	AST_INIT(ast_continue_t);
+	AST_INIT(ast_continue_t, AST_CONTINUE);
 
 	node->location = *location;
 
@@ -30,7 +31,7 @@ void ast_continue_free(ast_t *ast)
 {
 	AST_FREE(ast_continue_t);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_continue(
@@ -43,3 +44,13 @@ void fprint_ast_continue(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_continue_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_continue_t);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
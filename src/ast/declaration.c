@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_declaration_init(
@@ -24,7 +25,7 @@ ast_t *ast_declaration_init(
 	location_t    *location_start,
 	location_t    *location_end)
 {
-	AST_INIT(ast_declaration_t);
+	AST_INIT(ast_declaration_t, AST_DECLARATION);
 
 	node->type          = type;
 	node->identifier    = identifier;
@@ -53,7 +54,7 @@ void ast_declaration_free(ast_t *ast)
 	AST_NODE_FREE(node->identifier);
 	AST_NODE_FREE(node->initializer);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_declaration_get_identifier(ast_t *ast)
@@ -71,17 +72,12 @@ ast_t *ast_declaration_get_type(ast_t *ast)
 	return OFFSETOF_AST_NODE(ast, ast_declaration_t)->type;
 }
 
-void fprint_ast_declaration(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_declaration_storage_class_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_declaration_t);
-
-	FPRINT_AST_MEMBER(ast_node_str[AST_TYPE], node->type);
-	FPRINT_AST_MEMBER(ast_node_str[AST_IDENTIFIER], node->identifier);
-	FPRINT_AST_MEMBER("initializer", node->initializer);
+	const ast_declaration_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_declaration_t);
 
 	const char *storage_class;
 	switch (node->storage_class) {
@@ -114,7 +110,42 @@ void fprint_ast_declaration(
 			break;
 	}
 
-	FPRINT_AST_FIELD("storage-class", storage_class);
+	return storage_class;
+}
+
+void fprint_ast_declaration(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_declaration_t);
+
+	FPRINT_AST_MEMBER(ast_node_str[AST_TYPE], node->type);
+	FPRINT_AST_MEMBER(ast_node_str[AST_IDENTIFIER], node->identifier);
+	FPRINT_AST_MEMBER("initializer", node->initializer);
+
+	FPRINT_AST_FIELD(
+		"storage-class",
+		ast_declaration_storage_class_str(ast));
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_declaration_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_declaration_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_TYPE], node->type);
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_IDENTIFIER], node->identifier);
+	FPRINT_AST_JSONL_MEMBER("initializer", node->initializer);
+
+	FPRINT_AST_JSONL_FIELD(
+		"storage-class",
+		ast_declaration_storage_class_str(ast));
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
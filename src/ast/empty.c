@@ -14,12 +14,13 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_empty_init(
 	location_t *location)
 {
-	AST_INIT(ast_empty_t);
+	AST_INIT(ast_empty_t, AST_EMPTY);
 
 	node->location = *location;
 
@@ -30,7 +31,7 @@ void ast_empty_free(ast_t *ast)
 {
 	AST_FREE(ast_empty_t);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_empty(
@@ -43,3 +44,13 @@ void fprint_ast_empty(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_empty_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_empty_t);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/vector.h>
 
 
@@ -45,7 +46,7 @@ ast_t *ast_expression_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_expression_t);
+	AST_INIT(ast_expression_t, AST_EXPRESSION);
 
 	if (vector_init(&node->expression, sizeof(expression), 0))
 		goto error_init;
@@ -78,7 +79,7 @@ void ast_expression_free(ast_t *ast)
 
 	vector_free(&node->expression);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_expression(
@@ -93,3 +94,15 @@ void fprint_ast_expression(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_expression_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_expression_t);
+
+	FPRINT_AST_JSONL_LIST(ast_node_str[AST_EXPRESSION], node->expression);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
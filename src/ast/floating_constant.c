@@ -15,6 +15,7 @@
 
 #include <jkcc/constant.h>
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/string.h>
 
 
@@ -22,7 +23,7 @@ ast_t *ast_floating_constant_init(
 	floating_constant_t *floating_constant,
 	location_t          *location)
 {
-	AST_INIT(ast_floating_constant_t);
+	AST_INIT(ast_floating_constant_t, AST_FLOATING_CONSTANT);
 
 	node->floating_constant = *floating_constant;
 	node->location          = *location;
@@ -35,16 +36,15 @@ void ast_floating_constant_free(ast_t *ast)
 	AST_FREE(ast_floating_constant_t);
 
 	string_free(&node->floating_constant.text);
-	free(node);
+	MEM_FREE(node);
 }
 
-void fprint_ast_floating_constant(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_floating_constant_type_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_floating_constant_t);
+	const ast_floating_constant_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_floating_constant_t);
 
 	const char *type;
 	switch (node->floating_constant.type) {
@@ -64,8 +64,32 @@ void fprint_ast_floating_constant(
 			type = "(unknown)";
 	}
 
-	FPRINT_AST_FIELD("type", type);
+	return type;
+}
+
+void fprint_ast_floating_constant(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_floating_constant_t);
+
+	FPRINT_AST_FIELD("type", ast_floating_constant_type_str(ast));
 	FPRINT_AST_FIELD("value", node->floating_constant.text.head);
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_floating_constant_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_floating_constant_t);
+
+	FPRINT_AST_JSONL_FIELD("type", ast_floating_constant_type_str(ast));
+	FPRINT_AST_JSONL_FIELD("value", node->floating_constant.text.head);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_for_init(
@@ -23,7 +24,7 @@ ast_t *ast_for_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_for_t);
+	AST_INIT(ast_for_t, AST_FOR);
 
 	node->initializer = initializer;
 	node->condition   = condition;
@@ -44,7 +45,7 @@ void ast_for_free(ast_t *ast)
 	AST_NODE_FREE(node->iteration);
 	AST_NODE_FREE(node->statement);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_for(
@@ -62,3 +63,18 @@ void fprint_ast_for(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_for_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_for_t);
+
+	FPRINT_AST_JSONL_MEMBER("initializer", node->initializer);
+	FPRINT_AST_JSONL_MEMBER("condition", node->condition);
+	FPRINT_AST_JSONL_MEMBER("iteration", node->iteration);
+	FPRINT_AST_JSONL_MEMBER("statement", node->statement);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
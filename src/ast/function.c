@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_function_init(
@@ -23,7 +24,7 @@ ast_t *ast_function_init(
 	location_t   *location_start,
 	location_t   *location_end)
 {
-	AST_INIT(ast_function_t);
+	AST_INIT(ast_function_t, AST_FUNCTION);
 
 	node->identifier      = identifier;
 	node->parameter_list  = parameter_list;
@@ -65,7 +66,7 @@ void ast_function_free(ast_t *ast)
 	AST_NODE_FREE(node->declaration_list);
 	AST_NODE_FREE(node->body);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_function_get_body(
@@ -149,3 +150,21 @@ void fprint_ast_function(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_function_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_function_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_IDENTIFIER], node->identifier);
+	FPRINT_AST_JSONL_MEMBER("return-type", node->return_type);
+	FPRINT_AST_JSONL_MEMBER("parameter-list", node->parameter_list);
+	FPRINT_AST_JSONL_MEMBER("identifier-list", node->identifier_list);
+	FPRINT_AST_JSONL_MEMBER("declaration-list", node->declaration_list);
+	FPRINT_AST_JSONL_MEMBER("body", node->body);
+	FPRINT_AST_JSONL_BOOL("variadic", node->variadic);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
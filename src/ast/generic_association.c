@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_generic_association_init(
@@ -21,7 +22,7 @@ ast_t *ast_generic_association_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_generic_association_t);
+	AST_INIT(ast_generic_association_t, AST_GENERIC_ASSOCIATION);
 
 	node->type       = type;
 	node->expression = expression;
@@ -38,7 +39,7 @@ void ast_generic_association_free(ast_t *ast)
 	AST_NODE_FREE(node->type);
 	AST_NODE_FREE(node->expression);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_generic_association(
@@ -54,3 +55,16 @@ void fprint_ast_generic_association(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_generic_association_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_generic_association_t);
+
+	FPRINT_AST_JSONL_MEMBER("type", node->type);
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_EXPRESSION], node->expression);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/vector.h>
 
 
@@ -48,7 +49,7 @@ ast_t *ast_generic_association_list_init(
 	ast_t      *generic_association,
 	location_t *location)
 {
-	AST_INIT(ast_generic_association_list_t);
+	AST_INIT(ast_generic_association_list_t, AST_GENERIC_ASSOCIATION_LIST);
 
 	if (vector_init(
 		&node->generic_association,
@@ -71,7 +72,7 @@ error_append:
 	vector_free(&node->generic_association);
 
 error_init:
-	free(node);
+	MEM_FREE(node);
 
 	return NULL;
 }
@@ -87,7 +88,7 @@ void ast_generic_association_list_free(ast_t *ast)
 
 	vector_free(&node->generic_association);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_generic_association_list(
@@ -104,3 +105,17 @@ void fprint_ast_generic_association_list(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_generic_association_list_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_generic_association_list_t);
+
+	FPRINT_AST_JSONL_LIST(
+		ast_node_str[AST_GENERIC_ASSOCIATION],
+		node->generic_association);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_generic_selection_init(
@@ -21,7 +22,7 @@ ast_t *ast_generic_selection_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_generic_selection_t);
+	AST_INIT(ast_generic_selection_t, AST_GENERIC_SELECTION);
 
 	node->expression               = expression;
 	node->generic_association_list = generic_association_list;
@@ -38,7 +39,7 @@ void ast_generic_selection_free(ast_t *ast)
 	AST_NODE_FREE(node->expression);
 	AST_NODE_FREE(node->generic_association_list);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_generic_selection(
@@ -56,3 +57,18 @@ void fprint_ast_generic_selection(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_generic_selection_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_generic_selection_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_EXPRESSION], node->expression);
+	FPRINT_AST_JSONL_MEMBER(
+		ast_node_str[AST_GENERIC_ASSOCIATION_LIST],
+		node->generic_association_list);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_goto_init(
@@ -20,7 +21,7 @@ ast_t *ast_goto_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_goto_t);
+	AST_INIT(ast_goto_t, AST_GOTO);
 
 	node->identifier = identifier;
 
@@ -37,7 +38,7 @@ void ast_goto_free(ast_t *ast)
 
 	AST_NODE_FREE(node->identifier);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_goto_get_identifier(
@@ -65,3 +66,15 @@ void fprint_ast_goto(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_goto_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_goto_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_IDENTIFIER], node->identifier);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
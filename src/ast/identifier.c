@@ -15,12 +15,13 @@
 
 #include <jkcc/constant.h>
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/string.h>
 
 
 ast_t *ast_identifier_init(identifier_t *identifier, location_t *location)
 {
-	AST_INIT(ast_identifier_t);
+	AST_INIT(ast_identifier_t, AST_IDENTIFIER);
 
 	node->identifier = *identifier;
 	node->type       =  NULL;
@@ -35,7 +36,7 @@ void ast_identifier_free(ast_t *ast)
 
 	string_free(&node->identifier.IDENTIFIER);
 	string_free(&node->identifier.text);
-	free(node);
+	MEM_FREE(node);
 }
 
 const string_t *ast_identifier_get_string(
@@ -84,3 +85,18 @@ void fprint_ast_identifier(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_identifier_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_identifier_t);
+
+	FPRINT_AST_JSONL_FIELD(
+		ast_node_str[AST_IDENTIFIER],
+		node->identifier.text.head);
+	FPRINT_AST_JSONL_POINTER("type-id", node->type);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
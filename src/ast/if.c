@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_if_init(
@@ -22,7 +23,7 @@ ast_t *ast_if_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_if_t);
+	AST_INIT(ast_if_t, AST_IF);
 
 	node->expression      = expression;
 	node->true_statement  = true_statement;
@@ -41,7 +42,7 @@ void ast_if_free(ast_t *ast)
 	AST_NODE_FREE(node->true_statement);
 	AST_NODE_FREE(node->false_statement);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_if_get_expression(ast_t *ast)
@@ -73,3 +74,17 @@ void fprint_ast_if(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_if_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_if_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_EXPRESSION], node->expression);
+	FPRINT_AST_JSONL_MEMBER("true-statement", node->true_statement);
+	FPRINT_AST_JSONL_MEMBER("false-statement", node->false_statement);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
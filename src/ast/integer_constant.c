@@ -15,6 +15,7 @@
 
 #include <jkcc/constant.h>
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/string.h>
 
 
@@ -22,7 +23,7 @@ ast_t *ast_integer_constant_init(
 	integer_constant_t *integer_constant,
 	location_t         *location)
 {
-	AST_INIT(ast_integer_constant_t);
+	AST_INIT(ast_integer_constant_t, AST_INTEGER_CONSTANT);
 
 	node->integer_constant = *integer_constant;
 	node->location         = *location;
@@ -35,7 +36,7 @@ void ast_integer_constant_free(ast_t *ast)
 	AST_FREE(ast_integer_constant_t);
 
 	string_free(&node->integer_constant.text);
-	free(node);
+	MEM_FREE(node);
 }
 
 const integer_constant_t *ast_integer_constant_get_integer_constant(ast_t *ast)
@@ -45,13 +46,12 @@ const integer_constant_t *ast_integer_constant_get_integer_constant(ast_t *ast)
 		ast_integer_constant_t)->integer_constant;
 }
 
-void fprint_ast_integer_constant(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_integer_constant_type_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_integer_constant_t);
+	const ast_integer_constant_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_integer_constant_t);
 
 	const char *type;
 	switch (node->integer_constant.type) {
@@ -83,8 +83,32 @@ void fprint_ast_integer_constant(
 			type = "(unknown)";
 	}
 
-	FPRINT_AST_FIELD("type", type);
+	return type;
+}
+
+void fprint_ast_integer_constant(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_integer_constant_t);
+
+	FPRINT_AST_FIELD("type", ast_integer_constant_type_str(ast));
 	FPRINT_AST_FIELD("value", node->integer_constant.text.head);
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_integer_constant_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_integer_constant_t);
+
+	FPRINT_AST_JSONL_FIELD("type", ast_integer_constant_type_str(ast));
+	FPRINT_AST_JSONL_FIELD("value", node->integer_constant.text.head);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_label_init(
@@ -21,7 +22,7 @@ ast_t *ast_label_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_label_t);
+	AST_INIT(ast_label_t, AST_LABEL);
 
 	node->identifier = identifier;
 	node->statement  = statement;
@@ -38,7 +39,7 @@ void ast_label_free(ast_t *ast)
 	AST_NODE_FREE(node->identifier);
 	AST_NODE_FREE(node->statement);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_label(
@@ -54,3 +55,16 @@ void fprint_ast_label(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_label_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_label_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_IDENTIFIER], node->identifier);
+	FPRINT_AST_JSONL_MEMBER("statement", node->statement);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -15,6 +15,7 @@
 #include <string.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/vector.h>
 
 
@@ -39,7 +40,7 @@ ast_t *ast_list_init(
 	ast_t      *ast,
 	location_t *location)
 {
-	AST_INIT(ast_list_t);
+	AST_INIT(ast_list_t, AST_LIST);
 
 	if (vector_init(&node->list, sizeof(ast), 0))
 		goto error_init;
@@ -55,7 +56,7 @@ error_append:
 	vector_free(&node->list);
 
 error_init:
-	free(node);
+	MEM_FREE(node);
 
 	return NULL;
 }
@@ -72,7 +73,7 @@ void ast_list_free(ast_t *ast)
 
 	vector_free(&node->list);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 vector_t *ast_list_get_list(ast_t *ast)
@@ -92,3 +93,15 @@ void fprint_ast_list(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_list_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_list_t);
+
+	FPRINT_AST_JSONL_LIST(ast_node_str[AST_LIST], node->list);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_member_access_init(
@@ -21,7 +22,7 @@ ast_t *ast_member_access_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_member_access_t);
+	AST_INIT(ast_member_access_t, AST_MEMBER_ACCESS);
 
 	node->operand    = operand;
 	node->identifier = identifier;
@@ -38,7 +39,7 @@ void ast_member_access_free(ast_t *ast)
 	AST_NODE_FREE(node->operand);
 	AST_NODE_FREE(node->identifier);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_member_access(
@@ -54,3 +55,16 @@ void fprint_ast_member_access(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_member_access_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_member_access_t);
+
+	FPRINT_AST_JSONL_MEMBER("operand", node->operand);
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_IDENTIFIER], node->identifier);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
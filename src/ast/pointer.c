@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 void ast_pointer_append(
@@ -35,7 +36,7 @@ ast_t *ast_pointer_init(
 	ast_t      *type_qualifier_list,
 	location_t *location)
 {
-	AST_INIT(ast_pointer_t);
+	AST_INIT(ast_pointer_t, AST_POINTER);
 
 	node->pointer             =  pointer;
 	node->type_qualifier_list =  type_qualifier_list;
@@ -64,7 +65,7 @@ void ast_pointer_free(ast_t *ast)
 
 	AST_NODE_FREE(node->type_qualifier_list);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_pointer_get_pointer(ast_t *ast)
@@ -85,3 +86,16 @@ void fprint_ast_pointer(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_pointer_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_pointer_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_POINTER], node->pointer);
+	FPRINT_AST_JSONL_MEMBER("type-qualifier-list", node->type_qualifier_list);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_return_init(
@@ -20,7 +21,7 @@ ast_t *ast_return_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_return_t);
+	AST_INIT(ast_return_t, AST_RETURN);
 
 	node->expression = expression;
 
@@ -35,7 +36,7 @@ void ast_return_free(ast_t *ast)
 
 	AST_NODE_FREE(node->expression);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_return_get_expression(ast_t *ast)
@@ -55,3 +56,15 @@ void fprint_ast_return(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_return_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_return_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_EXPRESSION], node->expression);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
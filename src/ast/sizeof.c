@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_sizeof_init(
@@ -20,7 +21,7 @@ ast_t *ast_sizeof_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_sizeof_t);
+	AST_INIT(ast_sizeof_t, AST_SIZEOF);
 
 	node->operand = operand;
 
@@ -35,7 +36,7 @@ void ast_sizeof_free(ast_t *ast)
 
 	AST_NODE_FREE(node->operand);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_sizeof_get_operand(ast_t *ast)
@@ -55,3 +56,15 @@ void fprint_ast_sizeof(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_sizeof_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_sizeof_t);
+
+	FPRINT_AST_JSONL_MEMBER("operand", node->operand);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
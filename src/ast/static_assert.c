@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_static_assert_init(
@@ -21,7 +22,7 @@ ast_t *ast_static_assert_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_static_assert_t);
+	AST_INIT(ast_static_assert_t, AST_STATIC_ASSERT);
 
 	node->constant_expression = constant_expression;
 	node->string_literal      = string_literal;
@@ -38,7 +39,7 @@ void ast_static_assert_free(ast_t *ast)
 	AST_NODE_FREE(node->constant_expression);
 	AST_NODE_FREE(node->string_literal);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_static_assert(
@@ -56,3 +57,18 @@ void fprint_ast_static_assert(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_static_assert_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_static_assert_t);
+
+	FPRINT_AST_JSONL_MEMBER("constant-expression", node->constant_expression);
+	FPRINT_AST_JSONL_MEMBER(
+		ast_node_str[AST_STRING_LITERAL],
+		node->string_literal);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,13 +14,14 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_storage_class_specifier_init(
 	uint_fast8_t  specifier,
 	location_t   *location)
 {
-	AST_INIT(ast_storage_class_specifier_t);
+	AST_INIT(ast_storage_class_specifier_t, AST_STORAGE_CLASS_SPECIFIER);
 
 	node->specifier =  specifier;
 	node->location  = *location;
@@ -32,16 +33,15 @@ void ast_storage_class_specifier_free(ast_t *ast)
 {
 	AST_FREE(ast_storage_class_specifier_t);
 
-	free(node);
+	MEM_FREE(node);
 }
 
-void fprint_ast_storage_class_specifier(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_storage_class_specifier_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_storage_class_specifier_t);
+	const ast_storage_class_specifier_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_storage_class_specifier_t);
 
 	const char *specifier;
 	switch (node->specifier) {
@@ -74,7 +74,30 @@ void fprint_ast_storage_class_specifier(
 			break;
 	}
 
-	FPRINT_AST_FIELD("specifier", specifier);
+	return specifier;
+}
+
+void fprint_ast_storage_class_specifier(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_storage_class_specifier_t);
+
+	FPRINT_AST_FIELD("specifier", ast_storage_class_specifier_str(ast));
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_storage_class_specifier_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_storage_class_specifier_t);
+
+	FPRINT_AST_JSONL_FIELD("specifier", ast_storage_class_specifier_str(ast));
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
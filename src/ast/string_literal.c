@@ -12,9 +12,11 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <jkcc/constant.h>
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/string.h>
 
 
@@ -22,7 +24,7 @@ ast_t *ast_string_literal_init(
 	string_literal_t *string_literal,
 	location_t       *location)
 {
-	AST_INIT(ast_string_literal_t);
+	AST_INIT(ast_string_literal_t, AST_STRING_LITERAL);
 
 	node->string_literal = *string_literal;
 	node->location       = *location;
@@ -36,72 +38,82 @@ void ast_string_literal_free(ast_t *ast)
 
 	string_free(&node->string_literal.string);
 	string_free(&node->string_literal.text);
-	free(node);
+	MEM_FREE(node);
 }
 
-void fprint_ast_string_literal(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_string_literal_encoding_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_string_literal_t);
+	const ast_string_literal_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_string_literal_t);
 
 	const char *encoding;
-	const char *prefix;
 	switch (node->string_literal.encoding) {
 		case STRING_CHAR:
-			encoding = "char*";
-			prefix   = "";
-			break;
-
 		case STRING_UTF_8:
 			encoding = "char*";
-			prefix   = "u8";
 			break;
 
 		case STRING_CHAR16_T:
 			encoding = "char16_t*";
-			prefix   = "u";
 			break;
 
 		case STRING_CHAR32_T:
 			encoding = "char32_t*";
-			prefix   = "U";
 			break;
 
 		case STRING_WCHAR_T:
 			encoding = "wchar_t*";
-			prefix   = "L";
 			break;
 
 		default:
 			encoding = "(unknown)";
 	}
 
-	FPRINT_AST_FIELD("encoding", encoding);
+	return encoding;
+}
 
-	// escape quotes
-	const char *head = node->string_literal.text.head;
-	node->string_literal.text.tail[-1] = '\0';
+void fprint_ast_string_literal(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_string_literal_t);
 
-	// strip prefix
-	if (*head != '"') {
-		head += 2;
+	FPRINT_AST_FIELD("encoding", ast_string_literal_encoding_str(ast));
 
-		// u8
-		if (*head == '"') ++head;
-	} else ++head;
+	// escape quotes
+	const char *head  = node->string_literal.text.head;
+	const char *quote = strchr(head, '"');
+	node->string_literal.text.tail[-1] = '\0';
 
 	INDENT(stream, level);
 	fprintf(
 		stream,
-		"\"value\"    : \"%s\\\"%s\\\"\",\n",
-		prefix,
-		head);
+		"\"value\"    : \"%.*s\\\"%s\\\"\",\n",
+		(int) (quote - head),
+		head,
+		quote + 1);
 
 	// restore quote
 	node->string_literal.text.tail[-1] = '"';
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_string_literal_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_string_literal_t);
+
+	FPRINT_AST_JSONL_FIELD(
+		"encoding",
+		ast_string_literal_encoding_str(ast));
+	FPRINT_AST_JSONL_FIELD("value", node->string_literal.text.head);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
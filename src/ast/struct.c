@@ -15,6 +15,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_struct_init(
@@ -26,7 +27,7 @@ ast_t *ast_struct_init(
 	location_t     *location_start,
 	location_t     *location_end)
 {
-	AST_INIT(ast_struct_t);
+	AST_INIT(ast_struct_t, AST_STRUCT);
 
 	node->tag              = tag;
 	node->declaration_list = declaration_list;
@@ -48,7 +49,7 @@ void ast_struct_free(ast_t *ast)
 	AST_NODE_FREE(node->tag);
 	AST_NODE_FREE(node->declaration_list);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 bool ast_struct_get_declaration(
@@ -102,16 +103,12 @@ void ast_struct_set_symbol_table(
 	ast_struct->members = members;
 }
 
-void fprint_ast_struct(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_struct_type_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_struct_t);
-
-	FPRINT_AST_MEMBER("tag", node->tag);
-	FPRINT_AST_MEMBER("declaration-list", node->declaration_list);
+	const ast_struct_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_struct_t);
 
 	const char *type;
 	switch (node->type) {
@@ -128,7 +125,36 @@ void fprint_ast_struct(
 			break;
 	}
 
-	FPRINT_AST_FIELD("type", type);
+	return type;
+}
+
+void fprint_ast_struct(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_struct_t);
+
+	FPRINT_AST_MEMBER("tag", node->tag);
+	FPRINT_AST_MEMBER("declaration-list", node->declaration_list);
+
+	FPRINT_AST_FIELD("type", ast_struct_type_str(ast));
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_struct_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_struct_t);
+
+	FPRINT_AST_JSONL_MEMBER("tag", node->tag);
+	FPRINT_AST_JSONL_MEMBER("declaration-list", node->declaration_list);
+
+	FPRINT_AST_JSONL_FIELD("type", ast_struct_type_str(ast));
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_ternary_operator_init(
@@ -23,7 +24,7 @@ ast_t *ast_ternary_operator_init(
 	location_t   *location_start,
 	location_t   *location_end)
 {
-	AST_INIT(ast_ternary_operator_t);
+	AST_INIT(ast_ternary_operator_t, AST_TERNARY_OPERATOR);
 
 	node->condition = condition;
 	node->lhs       = lhs;
@@ -42,7 +43,22 @@ void ast_ternary_operator_free(ast_t *ast)
 	AST_NODE_FREE(node->lhs);
 	AST_NODE_FREE(node->rhs);
 
-	free(node);
+	MEM_FREE(node);
+}
+
+ast_t *ast_ternary_operator_get_condition(ast_t *ast)
+{
+	return OFFSETOF_AST_NODE(ast, ast_ternary_operator_t)->condition;
+}
+
+ast_t *ast_ternary_operator_get_lhs(ast_t *ast)
+{
+	return OFFSETOF_AST_NODE(ast, ast_ternary_operator_t)->lhs;
+}
+
+ast_t *ast_ternary_operator_get_rhs(ast_t *ast)
+{
+	return OFFSETOF_AST_NODE(ast, ast_ternary_operator_t)->rhs;
 }
 
 void fprint_ast_ternary_operator(
@@ -59,3 +75,17 @@ void fprint_ast_ternary_operator(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_ternary_operator_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_ternary_operator_t);
+
+	FPRINT_AST_JSONL_MEMBER("condition", node->condition);
+	FPRINT_AST_JSONL_MEMBER("lhs", node->lhs);
+	FPRINT_AST_JSONL_MEMBER("rhs", node->rhs);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/vector.h>
 
 
@@ -42,7 +43,7 @@ ast_t *ast_translation_unit_append_external_declaration(
 ast_t *ast_translation_unit_init(
 	void)
 {
-	AST_INIT(ast_translation_unit_t);
+	AST_INIT(ast_translation_unit_t, AST_TRANSLATION_UNIT);
 
 	node->external_declaration = NULL;
 
@@ -58,7 +59,7 @@ error_vector_init_file:
 	vector_free(&node->file);
 
 error_vector_init_base_type:
-	free(node);
+	MEM_FREE(node);
 
 	return NULL;
 }
@@ -75,14 +76,14 @@ void ast_translation_unit_free(ast_t *ast)
 
 	file_t **file = node->file.buf;
 	for (size_t i = 0; i < node->file.use; i++) {
-		free(file[i]->path);
-		free(file[i]);
+		MEM_FREE(file[i]->path);
+		MEM_FREE(file[i]);
 	}
 
 	vector_free(&node->base_type);
 	vector_free(&node->file);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 vector_t *ast_translation_unit_get_base_type(
@@ -112,3 +113,15 @@ void fprint_ast_translation_unit(
 
 	FPRINT_AST_FINISH;
 }
+
+void fprint_ast_translation_unit_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_translation_unit_t);
+
+	FPRINT_AST_JSONL_MEMBER(
+		"external-declaration",
+		node->external_declaration);
+}
@@ -16,6 +16,7 @@
 #include <string.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 #include <jkcc/vector.h>
 
 
@@ -269,11 +270,16 @@ multiset_error:
 	return NULL;
 }
 
+uint_fast16_t ast_type_get_type_specifier(ast_t *type)
+{
+	return OFFSETOF_AST_NODE(type, ast_type_t)->type_specifier;
+}
+
 ast_t *ast_type_init(
 	ast_t      *specifier,
 	location_t *location)
 {
-	AST_INIT(ast_type_t);
+	AST_INIT(ast_type_t, AST_TYPE);
 
 	memset(node, 0, sizeof(*node));
 
@@ -406,7 +412,7 @@ void ast_type_free(ast_t *ast)
 	vector_free(&node->function_specifier_vector);
 	vector_free(&node->alignment_specifier_vector);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 void fprint_ast_type(
@@ -444,3 +450,38 @@ void fprint_ast_type(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_type_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_type_t);
+
+	if (node->storage_class_specifier_vector.use)
+		FPRINT_AST_JSONL_REVERSE_LIST(
+			ast_node_str[AST_STORAGE_CLASS_SPECIFIER],
+			node->storage_class_specifier_vector);
+
+	if (node->type_specifier_vector.use)
+		FPRINT_AST_JSONL_REVERSE_LIST(
+			ast_node_str[AST_TYPE_SPECIFIER],
+			node->type_specifier_vector);
+
+	if (node->type_qualifier_vector.use)
+		FPRINT_AST_JSONL_REVERSE_LIST(
+			ast_node_str[AST_TYPE_QUALIFIER],
+			node->type_qualifier_vector);
+
+	if (node->function_specifier_vector.use)
+		FPRINT_AST_JSONL_REVERSE_LIST(
+			ast_node_str[AST_FUNCTION_SPECIFIER],
+			node->function_specifier_vector);
+
+	if (node->alignment_specifier_vector.use)
+		FPRINT_AST_JSONL_REVERSE_LIST(
+			ast_node_str[AST_ALIGNAS],
+			node->alignment_specifier_vector);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
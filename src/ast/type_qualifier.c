@@ -14,13 +14,14 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_type_qualifier_init(
 	uint_fast8_t  qualifier,
 	location_t   *location)
 {
-	AST_INIT(ast_type_qualifier_t);
+	AST_INIT(ast_type_qualifier_t, AST_TYPE_QUALIFIER);
 
 	node->qualifier =  qualifier;
 	node->location  = *location;
@@ -32,16 +33,15 @@ void ast_type_qualifier_free(ast_t *ast)
 {
 	AST_FREE(ast_type_qualifier_t);
 
-	free(node);
+	MEM_FREE(node);
 }
 
-void fprint_ast_type_qualifier(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_type_qualifier_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_type_qualifier_t);
+	const ast_type_qualifier_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_type_qualifier_t);
 
 	const char *qualifier;
 	switch (node->qualifier) {
@@ -66,7 +66,30 @@ void fprint_ast_type_qualifier(
 			break;
 	}
 
-	FPRINT_AST_FIELD("qualifier", qualifier);
+	return qualifier;
+}
+
+void fprint_ast_type_qualifier(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_type_qualifier_t);
+
+	FPRINT_AST_FIELD("qualifier", ast_type_qualifier_str(ast));
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_type_qualifier_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_type_qualifier_t);
+
+	FPRINT_AST_JSONL_FIELD("qualifier", ast_type_qualifier_str(ast));
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_type_specifier_init(
@@ -21,7 +22,7 @@ ast_t *ast_type_specifier_init(
 	ast_t         *semantic_type,
 	location_t    *location)
 {
-	AST_INIT(ast_type_specifier_t);
+	AST_INIT(ast_type_specifier_t, AST_TYPE_SPECIFIER);
 
 	node->specifier     =  specifier;
 	node->semantic_type =  semantic_type;
@@ -36,18 +37,15 @@ void ast_type_specifier_free(ast_t *ast)
 
 	AST_NODE_FREE(node->semantic_type);
 
-	free(node);
+	MEM_FREE(node);
 }
 
-void fprint_ast_type_specifier(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_type_specifier_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_type_specifier_t);
-
-	FPRINT_AST_MEMBER("semantic-type", node->semantic_type)
+	const ast_type_specifier_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_type_specifier_t);
 
 	const char *specifier;
 	switch (node->specifier) {
@@ -112,7 +110,34 @@ void fprint_ast_type_specifier(
 			break;
 	}
 
-	FPRINT_AST_FIELD("specifier", specifier);
+	return specifier;
+}
+
+void fprint_ast_type_specifier(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_type_specifier_t);
+
+	FPRINT_AST_MEMBER("semantic-type", node->semantic_type)
+
+	FPRINT_AST_FIELD("specifier", ast_type_specifier_str(ast));
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_type_specifier_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_type_specifier_t);
+
+	FPRINT_AST_JSONL_MEMBER("semantic-type", node->semantic_type)
+
+	FPRINT_AST_JSONL_FIELD("specifier", ast_type_specifier_str(ast));
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_unary_operator_init(
@@ -22,7 +23,7 @@ ast_t *ast_unary_operator_init(
 	location_t    *location_start,
 	location_t    *location_end)
 {
-	AST_INIT(ast_unary_operator_t);
+	AST_INIT(ast_unary_operator_t, AST_UNARY_OPERATOR);
 
 	node->operand  = operand;
 	node->operator = operator;
@@ -38,18 +39,15 @@ void ast_unary_operator_free(ast_t *ast)
 
 	AST_NODE_FREE(node->operand);
 
-	free(node);
+	MEM_FREE(node);
 }
 
-void fprint_ast_unary_operator(
-	FILE         *stream,
-	const ast_t  *ast,
-	size_t        level,
-	uint_fast8_t  flags)
+const char *ast_unary_operator_str(
+	const ast_t *ast)
 {
-	FPRINT_AST_NODE_BEGIN(ast_unary_operator_t);
-
-	FPRINT_AST_MEMBER("operand", node->operand);
+	const ast_unary_operator_t *node = OFFSETOF_AST_NODE(
+		ast,
+		ast_unary_operator_t);
 
 	const char *operator;
 	switch (node->operator) {
@@ -90,7 +88,34 @@ void fprint_ast_unary_operator(
 			break;
 	}
 
-	FPRINT_AST_FIELD("operator", operator);
+	return operator;
+}
+
+void fprint_ast_unary_operator(
+	FILE         *stream,
+	const ast_t  *ast,
+	size_t        level,
+	uint_fast8_t  flags)
+{
+	FPRINT_AST_NODE_BEGIN(ast_unary_operator_t);
+
+	FPRINT_AST_MEMBER("operand", node->operand);
+
+	FPRINT_AST_FIELD("operator", ast_unary_operator_str(ast));
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_unary_operator_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_unary_operator_t);
+
+	FPRINT_AST_JSONL_MEMBER("operand", node->operand);
+
+	FPRINT_AST_JSONL_FIELD("operator", ast_unary_operator_str(ast));
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <jkcc/location.h>
+#include <jkcc/mem.h>
 
 
 ast_t *ast_while_init(
@@ -23,7 +24,7 @@ ast_t *ast_while_init(
 	location_t *location_start,
 	location_t *location_end)
 {
-	AST_INIT(ast_while_t);
+	AST_INIT(ast_while_t, AST_WHILE);
 
 	node->expression  = expression;
 	node->statement   = statement;
@@ -41,7 +42,7 @@ void ast_while_free(ast_t *ast)
 	AST_NODE_FREE(node->expression);
 	AST_NODE_FREE(node->statement);
 
-	free(node);
+	MEM_FREE(node);
 }
 
 ast_t *ast_while_get_expression(ast_t *ast)
@@ -68,3 +69,17 @@ void fprint_ast_while(
 
 	FPRINT_AST_NODE_FINISH;
 }
+
+void fprint_ast_while_jsonl(
+	FILE        *stream,
+	const ast_t *ast,
+	ast_jsonl_t *jsonl)
+{
+	FPRINT_AST_JSONL_NODE_BEGIN(ast_while_t);
+
+	FPRINT_AST_JSONL_MEMBER(ast_node_str[AST_EXPRESSION], node->expression);
+	FPRINT_AST_JSONL_MEMBER("statement", node->statement);
+	FPRINT_AST_JSONL_BOOL("do-while", node->do_while);
+
+	FPRINT_AST_JSONL_NODE_FINISH;
+}
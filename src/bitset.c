@@ -0,0 +1,429 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * bitset.c -- dense bit-sets
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/bitset.h>
+#include <jkcc/private/bitset.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef BITSET_X86
+#include <immintrin.h>
+#endif  /* BITSET_X86 */
+
+#include <jkcc/mem.h>
+
+
+static bitset_kernel_t kernel = BITSET_KERNEL_SCALAR;
+
+static const char *const kernel_str[BITSET_KERNELS_TOTAL] = {
+	[BITSET_KERNEL_SCALAR] = "scalar",
+	[BITSET_KERNEL_SSE2]   = "sse2",
+	[BITSET_KERNEL_AVX2]   = "avx2",
+};
+
+static bool (*const diff_kernel[BITSET_KERNELS_TOTAL])(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words) = {
+	[BITSET_KERNEL_SCALAR] = diff_scalar,
+#ifdef BITSET_X86
+	[BITSET_KERNEL_SSE2]   = diff_sse2,
+	[BITSET_KERNEL_AVX2]   = diff_avx2,
+#endif  /* BITSET_X86 */
+};
+
+static bool (*const intersect_kernel[BITSET_KERNELS_TOTAL])(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words) = {
+	[BITSET_KERNEL_SCALAR] = intersect_scalar,
+#ifdef BITSET_X86
+	[BITSET_KERNEL_SSE2]   = intersect_sse2,
+	[BITSET_KERNEL_AVX2]   = intersect_avx2,
+#endif  /* BITSET_X86 */
+};
+
+static bool (*const transfer_kernel[BITSET_KERNELS_TOTAL])(
+	uint64_t       *dst,
+	const uint64_t *gen,
+	const uint64_t *src,
+	const uint64_t *kill,
+	size_t          words) = {
+	[BITSET_KERNEL_SCALAR] = transfer_scalar,
+#ifdef BITSET_X86
+	[BITSET_KERNEL_SSE2]   = transfer_sse2,
+	[BITSET_KERNEL_AVX2]   = transfer_avx2,
+#endif  /* BITSET_X86 */
+};
+
+static bool (*const union_kernel[BITSET_KERNELS_TOTAL])(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words) = {
+	[BITSET_KERNEL_SCALAR] = union_scalar,
+#ifdef BITSET_X86
+	[BITSET_KERNEL_SSE2]   = union_sse2,
+	[BITSET_KERNEL_AVX2]   = union_avx2,
+#endif  /* BITSET_X86 */
+};
+
+
+void bitset_copy(bitset_t *dst, const bitset_t *src)
+{
+	memcpy(dst->word, src->word, dst->words * sizeof(*dst->word));
+}
+
+bool bitset_diff(bitset_t *dst, const bitset_t *src)
+{
+	return diff_kernel[kernel](dst->word, src->word, dst->words);
+}
+
+bool bitset_equal(const bitset_t *lhs, const bitset_t *rhs)
+{
+	return !memcmp(lhs->word, rhs->word, lhs->words * sizeof(*lhs->word));
+}
+
+void bitset_fill(bitset_t *bitset)
+{
+	memset(bitset->word, 0xff, bitset->words * sizeof(*bitset->word));
+}
+
+void bitset_free(bitset_t *bitset)
+{
+	if (!bitset) return;
+
+	MEM_FREE(bitset->word);
+
+	bitset->word  = NULL;
+	bitset->words = 0;
+}
+
+int bitset_init(bitset_t *bitset, size_t bits)
+{
+	size_t vector_bits = BITSET_WORD_BITS * BITSET_VECTOR_WORDS;
+
+	// padding lets every kernel skip a scalar tail
+	size_t words = (bits + vector_bits - 1) / vector_bits;
+	words *= BITSET_VECTOR_WORDS;
+
+	if (!words) words = BITSET_VECTOR_WORDS;
+
+	uint64_t *word = MEM_CALLOC(MEM_TAG_BITSET, 0, words, sizeof(*word));
+	if (!word) return -1;
+
+	bitset->word  = word;
+	bitset->words = words;
+
+	return 0;
+}
+
+bool bitset_intersect(bitset_t *dst, const bitset_t *src)
+{
+	return intersect_kernel[kernel](dst->word, src->word, dst->words);
+}
+
+bitset_kernel_t bitset_kernel(void)
+{
+	return kernel;
+}
+
+int bitset_kernel_set(bitset_kernel_t kernel_new)
+{
+	if (kernel_new >= BITSET_KERNELS_TOTAL) return -1;
+
+	if (!union_kernel[kernel_new]) return -1;
+
+#ifdef BITSET_X86
+	if (kernel_new == BITSET_KERNEL_AVX2
+		&& !__builtin_cpu_supports("avx2")) return -1;
+#endif  /* BITSET_X86 */
+
+	kernel = kernel_new;
+
+	return 0;
+}
+
+const char *bitset_kernel_str(bitset_kernel_t kernel)
+{
+	return (kernel < BITSET_KERNELS_TOTAL) ? kernel_str[kernel] : NULL;
+}
+
+bool bitset_transfer(
+	bitset_t       *dst,
+	const bitset_t *gen,
+	const bitset_t *src,
+	const bitset_t *kill)
+{
+	return transfer_kernel[kernel](
+		dst->word,
+		gen->word,
+		src->word,
+		kill->word,
+		dst->words);
+}
+
+bool bitset_union(bitset_t *dst, const bitset_t *src)
+{
+	return union_kernel[kernel](dst->word, src->word, dst->words);
+}
+
+void bitset_zero(bitset_t *bitset)
+{
+	memset(bitset->word, 0, bitset->words * sizeof(*bitset->word));
+}
+
+
+__attribute__((constructor)) static void kernel_detect(void)
+{
+#ifdef BITSET_X86
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2")) {
+		kernel = BITSET_KERNEL_AVX2;
+		return;
+	}
+
+	if (__builtin_cpu_supports("sse2")) {
+		kernel = BITSET_KERNEL_SSE2;
+		return;
+	}
+#endif  /* BITSET_X86 */
+
+	kernel = BITSET_KERNEL_SCALAR;
+}
+
+static bool diff_scalar(uint64_t *dst, const uint64_t *src, size_t words)
+{
+	uint64_t changed = 0;
+
+	for (size_t i = 0; i < words; i++) {
+		uint64_t word = dst[i] & ~src[i];
+
+		changed |= word ^ dst[i];
+		dst[i]   = word;
+	}
+
+	return changed;
+}
+
+static bool intersect_scalar(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words)
+{
+	uint64_t changed = 0;
+
+	for (size_t i = 0; i < words; i++) {
+		uint64_t word = dst[i] & src[i];
+
+		changed |= word ^ dst[i];
+		dst[i]   = word;
+	}
+
+	return changed;
+}
+
+static bool transfer_scalar(
+	uint64_t       *dst,
+	const uint64_t *gen,
+	const uint64_t *src,
+	const uint64_t *kill,
+	size_t          words)
+{
+	uint64_t changed = 0;
+
+	for (size_t i = 0; i < words; i++) {
+		uint64_t word = gen[i] | (src[i] & ~kill[i]);
+
+		changed |= word ^ dst[i];
+		dst[i]   = word;
+	}
+
+	return changed;
+}
+
+static bool union_scalar(uint64_t *dst, const uint64_t *src, size_t words)
+{
+	uint64_t changed = 0;
+
+	for (size_t i = 0; i < words; i++) {
+		uint64_t word = dst[i] | src[i];
+
+		changed |= word ^ dst[i];
+		dst[i]   = word;
+	}
+
+	return changed;
+}
+
+#ifdef BITSET_X86
+__attribute__((target("sse2"))) static bool diff_sse2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words)
+{
+	__m128i changed = _mm_setzero_si128();
+
+	for (size_t i = 0; i < words; i += 2) {
+		__m128i d = _mm_loadu_si128((const __m128i*) (dst + i));
+		__m128i s = _mm_loadu_si128((const __m128i*) (src + i));
+		__m128i w = _mm_andnot_si128(s, d);
+
+		changed = _mm_or_si128(changed, _mm_xor_si128(w, d));
+		_mm_storeu_si128((__m128i*) (dst + i), w);
+	}
+
+	return _mm_movemask_epi8(
+		_mm_cmpeq_epi8(changed, _mm_setzero_si128())) != 0xffff;
+}
+
+__attribute__((target("sse2"))) static bool intersect_sse2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words)
+{
+	__m128i changed = _mm_setzero_si128();
+
+	for (size_t i = 0; i < words; i += 2) {
+		__m128i d = _mm_loadu_si128((const __m128i*) (dst + i));
+		__m128i s = _mm_loadu_si128((const __m128i*) (src + i));
+		__m128i w = _mm_and_si128(d, s);
+
+		changed = _mm_or_si128(changed, _mm_xor_si128(w, d));
+		_mm_storeu_si128((__m128i*) (dst + i), w);
+	}
+
+	return _mm_movemask_epi8(
+		_mm_cmpeq_epi8(changed, _mm_setzero_si128())) != 0xffff;
+}
+
+__attribute__((target("sse2"))) static bool transfer_sse2(
+	uint64_t       *dst,
+	const uint64_t *gen,
+	const uint64_t *src,
+	const uint64_t *kill,
+	size_t          words)
+{
+	__m128i changed = _mm_setzero_si128();
+
+	for (size_t i = 0; i < words; i += 2) {
+		__m128i d = _mm_loadu_si128((const __m128i*) (dst + i));
+		__m128i g = _mm_loadu_si128((const __m128i*) (gen + i));
+		__m128i s = _mm_loadu_si128((const __m128i*) (src + i));
+		__m128i k = _mm_loadu_si128((const __m128i*) (kill + i));
+		__m128i w = _mm_or_si128(g, _mm_andnot_si128(k, s));
+
+		changed = _mm_or_si128(changed, _mm_xor_si128(w, d));
+		_mm_storeu_si128((__m128i*) (dst + i), w);
+	}
+
+	return _mm_movemask_epi8(
+		_mm_cmpeq_epi8(changed, _mm_setzero_si128())) != 0xffff;
+}
+
+__attribute__((target("sse2"))) static bool union_sse2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words)
+{
+	__m128i changed = _mm_setzero_si128();
+
+	for (size_t i = 0; i < words; i += 2) {
+		__m128i d = _mm_loadu_si128((const __m128i*) (dst + i));
+		__m128i s = _mm_loadu_si128((const __m128i*) (src + i));
+		__m128i w = _mm_or_si128(d, s);
+
+		changed = _mm_or_si128(changed, _mm_xor_si128(w, d));
+		_mm_storeu_si128((__m128i*) (dst + i), w);
+	}
+
+	return _mm_movemask_epi8(
+		_mm_cmpeq_epi8(changed, _mm_setzero_si128())) != 0xffff;
+}
+
+__attribute__((target("avx2"))) static bool diff_avx2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words)
+{
+	__m256i changed = _mm256_setzero_si256();
+
+	for (size_t i = 0; i < words; i += 4) {
+		__m256i d = _mm256_loadu_si256((const __m256i*) (dst + i));
+		__m256i s = _mm256_loadu_si256((const __m256i*) (src + i));
+		__m256i w = _mm256_andnot_si256(s, d);
+
+		changed = _mm256_or_si256(changed, _mm256_xor_si256(w, d));
+		_mm256_storeu_si256((__m256i*) (dst + i), w);
+	}
+
+	return !_mm256_testz_si256(changed, changed);
+}
+
+__attribute__((target("avx2"))) static bool intersect_avx2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words)
+{
+	__m256i changed = _mm256_setzero_si256();
+
+	for (size_t i = 0; i < words; i += 4) {
+		__m256i d = _mm256_loadu_si256((const __m256i*) (dst + i));
+		__m256i s = _mm256_loadu_si256((const __m256i*) (src + i));
+		__m256i w = _mm256_and_si256(d, s);
+
+		changed = _mm256_or_si256(changed, _mm256_xor_si256(w, d));
+		_mm256_storeu_si256((__m256i*) (dst + i), w);
+	}
+
+	return !_mm256_testz_si256(changed, changed);
+}
+
+__attribute__((target("avx2"))) static bool transfer_avx2(
+	uint64_t       *dst,
+	const uint64_t *gen,
+	const uint64_t *src,
+	const uint64_t *kill,
+	size_t          words)
+{
+	__m256i changed = _mm256_setzero_si256();
+
+	for (size_t i = 0; i < words; i += 4) {
+		__m256i d = _mm256_loadu_si256((const __m256i*) (dst + i));
+		__m256i g = _mm256_loadu_si256((const __m256i*) (gen + i));
+		__m256i s = _mm256_loadu_si256((const __m256i*) (src + i));
+		__m256i k = _mm256_loadu_si256((const __m256i*) (kill + i));
+		__m256i w = _mm256_or_si256(g, _mm256_andnot_si256(k, s));
+
+		changed = _mm256_or_si256(changed, _mm256_xor_si256(w, d));
+		_mm256_storeu_si256((__m256i*) (dst + i), w);
+	}
+
+	return !_mm256_testz_si256(changed, changed);
+}
+
+__attribute__((target("avx2"))) static bool union_avx2(
+	uint64_t       *dst,
+	const uint64_t *src,
+	size_t          words)
+{
+	__m256i changed = _mm256_setzero_si256();
+
+	for (size_t i = 0; i < words; i += 4) {
+		__m256i d = _mm256_loadu_si256((const __m256i*) (dst + i));
+		__m256i s = _mm256_loadu_si256((const __m256i*) (src + i));
+		__m256i w = _mm256_or_si256(d, s);
+
+		changed = _mm256_or_si256(changed, _mm256_xor_si256(w, d));
+		_mm256_storeu_si256((__m256i*) (dst + i), w);
+	}
+
+	return !_mm256_testz_si256(changed, changed);
+}
+#endif  /* BITSET_X86 */
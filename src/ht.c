@@ -13,6 +13,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <jkcc/mem.h>
+
 
 bool ht_exists(ht_t *ht, const void *key, size_t size)
 {
@@ -44,27 +46,26 @@ bool ht_exists(ht_t *ht, const void *key, size_t size)
 
 void ht_free(ht_t *ht, void (*entry_free)(void *val))
 {
-	if (!ht) return;
+	if (!ht || !ht->entries) return;
 
-	if (entry_free)
-		for (size_t i = 0; i < ht->size; i++) {
-			if (!ht->entries[i].key) continue;
+	// deleted entries keep their key until reused, so every slot has
+	// to be visited regardless of how many entries are still live
+	for (size_t i = 0; i < ht->size; i++) {
+		ht_entry_t *entry = &ht->entries[i];
 
-			free(ht->entries[i].key);
-			entry_free(&ht->entries[i].val);
+		if (!entry->key) continue;
 
-			if (!--ht->use) break;
-		}
-	else
-		for (size_t i = 0; i < ht->size; i++) {
-			if (!ht->entries[i].key) continue;
+		if (entry_free && !(entry->attributes & HT_ATTRIBUTE_DELETED))
+			entry_free(&entry->val);
 
-			free(ht->entries[i].key);
+		MEM_FREE(entry->key);
+	}
 
-			if (!--ht->use) break;
-		}
+	MEM_FREE(ht->entries);
 
-	free(ht->entries);
+	ht->entries = NULL;
+	ht->use     = 0;
+	ht->size    = 0;
 }
 
 int ht_get(ht_t *ht, const void *key, size_t size, void **val)
@@ -107,7 +108,11 @@ int ht_init(ht_t *ht, size_t size)
 	ht->use  = 0;
 	ht->size = size;
 
-	ht->entries = calloc(ht->size, sizeof(*ht->entries));
+	ht->entries = MEM_CALLOC(
+		MEM_TAG_HT,
+		MEM_HT_ENTRIES,
+		ht->size,
+		sizeof(*ht->entries));
 	if (!ht->entries) return -1;
 
 	return 0;
@@ -121,7 +126,7 @@ int ht_insert(ht_t *ht, const void *key, size_t size, void *val)
 	if (ht->use >= ht->size / 2)
 		if (rehash(ht)) return -1;
 
-	void *key_buf = malloc(size);
+	void *key_buf = MEM_MALLOC(MEM_TAG_HT, MEM_HT_KEY, size);
 	if (!key_buf) return -1;
 
 	uint64_t pos = fnv1a_hash(key, size) % ht->size;
@@ -139,7 +144,7 @@ int ht_insert(ht_t *ht, const void *key, size_t size, void *val)
 				continue;
 			}
 
-			free(entry->key);
+			MEM_FREE(entry->key);
 			entry->attributes &= ~HT_ATTRIBUTE_DELETED;
 		}
 
@@ -154,7 +159,7 @@ int ht_insert(ht_t *ht, const void *key, size_t size, void *val)
 	}
 
 error:
-	free(key_buf);
+	MEM_FREE(key_buf);
 
 	// we've somehow traversed the entire hash table
 	return -1;
@@ -244,21 +249,22 @@ static int rehash(ht_t *ht)
 	// overflow
 	if (size / 2 != ht->size) return -1;
 
-	ht_entry_t *new_entries = calloc(size, sizeof(*new_entries));
+	ht_entry_t *new_entries = MEM_CALLOC(
+		MEM_TAG_HT,
+		MEM_HT_ENTRIES,
+		size,
+		sizeof(*new_entries));
 	if (!new_entries) return -1;
 
-	size_t use = ht->use;
-
 	ht_entry_t *entry;
 
+	// keep going past the last live entry to release deleted keys
 	for (size_t i = 0; i < ht->size; i++) {
-		if (!use) break;
-
 		entry = &ht->entries[i];
 
 		if (!entry->key) continue;
 		if (entry->attributes & HT_ATTRIBUTE_DELETED) {
-			free(entry->key);
+			MEM_FREE(entry->key);
 			continue;
 		}
 
@@ -275,11 +281,9 @@ static int rehash(ht_t *ht)
 			*tmp = *entry;
 			break;
 		}
-
-		--use;
 	}
 
-	free(ht->entries);
+	MEM_FREE(ht->entries);
 
 	ht->entries = new_entries;
 	ht->size    = size;
@@ -7,13 +7,17 @@
 #include <jkcc/ir.h>
 #include <jkcc/private/ir.h>
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <jkcc/ast.h>
+#include <jkcc/constant.h>
 #include <jkcc/ht.h>
+#include <jkcc/json.h>
+#include <jkcc/mem.h>
 #include <jkcc/string.h>
 #include <jkcc/vector.h>
 
@@ -87,11 +91,44 @@ error_ht_insert_ir_static_declaration:
 
 error_vector_append_ir_static_declaration:
 	--ir_context->current.bb;
-	free(ir_static_declaration);
+	MEM_FREE(ir_static_declaration);
 
 	return IR_ERROR_NOMEM;
 }
 
+size_t ir_declaration_size(ast_t *declaration, size_t cell)
+{
+	ast_t *type = ast_declaration_get_type(declaration);
+
+	if (*type != AST_ARRAY) return cell;
+
+	ast_t *element = type;
+
+	while (*element == AST_ARRAY) element = ast_array_get_type(element);
+
+	// pointer arithmetic strides by an int, so only int arrays are
+	// laid out element by element
+	if (!ir_type_int(element)) return cell;
+
+	size_t size = sizeof(int32_t);
+
+	for (; *type == AST_ARRAY; type = ast_array_get_type(type)) {
+		ast_t *ast_size = ast_array_get_size(type);
+
+		if (!ast_size || *ast_size != AST_INTEGER_CONSTANT) return cell;
+
+		const integer_constant_t *integer_constant
+			= ast_integer_constant_get_integer_constant(ast_size);
+
+		if (integer_constant->type != INT) return cell;
+
+		size *= integer_constant->INT;
+	}
+
+	// rounded up to a whole cell
+	return size + (cell - size % cell) % cell;
+}
+
 void ir_extern_declaration_symbol_fprint(FILE *stream, ast_t *declaration)
 {
 	const string_t *identifier = ast_identifier_get_string(
@@ -100,12 +137,52 @@ void ir_extern_declaration_symbol_fprint(FILE *stream, ast_t *declaration)
 	fprintf(stream, "@%s", identifier->head);
 }
 
+void ir_location_fprint_jsonl(FILE *stream, const ir_location_t *location)
+{
+	switch (location->type) {
+		case IR_LOCATION_REG:
+			fprintf(
+				stream,
+				"{\"type\":\"reg\",\"reg\":%lu}",
+				IR_REG_INDEX(location->reg));
+			break;
+
+		case IR_LOCATION_EXTERN_DECLARATION:;
+			const string_t *identifier = ast_identifier_get_string(
+				ast_declaration_get_identifier(
+					location->extern_declaration));
+
+			fprintf(
+				stream,
+				"{\"type\":\"extern-declaration\",\"symbol\":");
+			fprint_json_string(stream, identifier->head);
+			fprintf(stream, "}");
+			break;
+
+		case IR_LOCATION_STATIC_DECLARATION:
+			fprintf(
+				stream,
+				"{\"type\":\"static-declaration\",\"bb\":%lu}",
+				location->static_declaration->bb);
+			break;
+
+		case IR_LOCATION_IDENTIFIER:
+			fprintf(stream, "{\"type\":\"identifier\",\"symbol\":");
+			fprint_json_string(stream, location->identifier->head);
+			fprintf(stream, "}");
+			break;
+	}
+}
+
 ir_static_declaration_t *ir_static_declaration_alloc(
 	ir_context_t *ir_context,
 	ast_t        *declaration)
 {
 	ir_static_declaration_t *ir_static_declaration
-		= malloc(sizeof(*ir_static_declaration));
+		= MEM_MALLOC(
+			MEM_TAG_IR,
+			MEM_IR_STATIC_DECLARATION,
+			sizeof(*ir_static_declaration));
 
 	if (!ir_static_declaration) return NULL;
 
@@ -117,23 +194,17 @@ ir_static_declaration_t *ir_static_declaration_alloc(
 
 void ir_reg_fprint(FILE *stream, uintptr_t reg)
 {
-	fprintf(stream, "%%%lu", reg);
+	if (reg & IR_REG_PHYSICAL)
+		fprintf(stream, "$%lu", IR_REG_INDEX(reg));
+	else if (IR_REG_IS_IMMEDIATE(reg))
+		fprintf(stream, "#%ld", (long) IR_REG_IMMEDIATE_VALUE(reg));
+	else
+		fprintf(stream, "%%%lu", reg);
 }
 
 void ir_reg_type_fprint(FILE *stream, ir_reg_type_t type)
 {
-	const char *type_str;
-	switch (type) {
-		case IR_REG_TYPE_I32:
-			type_str = "i32";
-			break;
-
-		case IR_REG_TYPE_PTR:
-			type_str = "ptr";
-			break;
-	}
-
-	fprintf(stream, "%s", type_str);
+	fprintf(stream, "%s", ir_reg_type_str(type));
 }
 
 ir_reg_type_t ir_reg_type_gen(ast_t *type)
@@ -156,6 +227,38 @@ ir_reg_type_t ir_reg_type_gen(ast_t *type)
 	return reg_type;
 }
 
+bool ir_type_int(ast_t *type)
+{
+	if (*type != AST_TYPE) return false;
+
+	uint_fast16_t specifier = ast_type_get_type_specifier(type);
+
+	return specifier && !(specifier & ~(
+		AST_TYPE_SPECIFIER_INT
+		| AST_TYPE_SPECIFIER_SIGNED
+		| AST_TYPE_SPECIFIER_UNSIGNED));
+}
+
+const char *ir_reg_type_str(ir_reg_type_t type)
+{
+	const char *type_str;
+	switch (type) {
+		case IR_REG_TYPE_I32:
+			type_str = "i32";
+			break;
+
+		case IR_REG_TYPE_PTR:
+			type_str = "ptr";
+			break;
+
+		default:
+			type_str = "(unknown)";
+			break;
+	}
+
+	return type_str;
+}
+
 void ir_static_declaration_symbol_fprint(
 	FILE                    *stream,
 	ir_static_declaration_t *declaration)
@@ -165,7 +268,10 @@ void ir_static_declaration_symbol_fprint(
 
 ir_unit_t *ir_unit_alloc(void)
 {
-	ir_unit_t *ir_unit = malloc(sizeof(*ir_unit));
+	ir_unit_t *ir_unit = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_UNIT,
+		sizeof(*ir_unit));
 	if (!ir_unit) return NULL;
 
 	if (ir_unit_init(ir_unit)) goto error_ir_unit_init;
@@ -173,7 +279,7 @@ ir_unit_t *ir_unit_alloc(void)
 	return ir_unit;
 
 error_ir_unit_init:
-	free(ir_unit);
+	MEM_FREE(ir_unit);
 
 	return NULL;
 }
@@ -184,7 +290,7 @@ void ir_unit_free(ir_unit_t *ir_unit)
 
 	ir_unit_deinit(ir_unit);
 
-	free(ir_unit);
+	MEM_FREE(ir_unit);
 }
 
 void ir_unit_fprint(FILE *stream, ir_unit_t *ir_unit)
@@ -198,6 +304,15 @@ void ir_unit_fprint(FILE *stream, ir_unit_t *ir_unit)
 	}
 }
 
+void ir_unit_fprint_jsonl(FILE *stream, ir_unit_t *ir_unit)
+{
+	size_t id = 0;
+
+	ir_function_t **ir_function = ir_unit->function.buf;
+	for (size_t i = 0; i < ir_unit->function.use; i++)
+		ir_function_fprint_jsonl(stream, ir_function[i], &id);
+}
+
 int ir_unit_gen(ir_unit_t *ir_unit, ast_t *ast)
 {
 	int ir_error = IR_ERROR_NOMEM;
@@ -285,10 +400,15 @@ int ir_unit_gen(ir_unit_t *ir_unit, ast_t *ast)
 				goto error;
 		}
 
+	ht_free(&ir_context.extern_declaration, NULL);
+	ht_free(&ir_context.static_declaration, NULL);
+
 	return 0;
 
 error:
-	ht_free(&ir_context.static_declaration, free);
+	// declarations are owned by ir_unit, only drop the lookups
+	ht_free(&ir_context.extern_declaration, NULL);
+	ht_free(&ir_context.static_declaration, NULL);
 
 	{
 		ir_function_t **ir_function = ir_unit->function.buf;
@@ -310,7 +430,7 @@ void ir_unit_deinit(ir_unit_t *ir_unit)
 	ir_static_declaration_t **ir_static_declaration
 		= ir_unit->static_declaration.buf;
 	for (size_t i = 0; i < ir_unit->static_declaration.use; i++)
-		free(ir_static_declaration[i]);
+		MEM_FREE(ir_static_declaration[i]);
 
 	vector_free(&ir_unit->extern_declaration);
 	vector_free(&ir_unit->static_declaration);
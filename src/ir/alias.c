@@ -0,0 +1,607 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * alias.c -- alias analysis
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/alias.h>
+#include <jkcc/private/alias.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/bitset.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+
+
+void ir_alias_free(ir_alias_t *ir_alias)
+{
+	if (!ir_alias) return;
+
+	ht_free(&ir_alias->cache, NULL);
+
+	bitset_free(&ir_alias->escaped);
+	bitset_free(&ir_alias->resolved);
+
+	MEM_FREE(ir_alias->address);
+	MEM_FREE(ir_alias->def);
+
+	ir_alias->address = NULL;
+	ir_alias->def     = NULL;
+}
+
+int ir_alias_init(ir_alias_t *ir_alias, ir_function_t *ir_function)
+{
+	*ir_alias = (ir_alias_t) {
+		.ir_function = ir_function,
+		.vregs       = ir_function_vregs(ir_function),
+	};
+
+	size_t vregs = ir_alias->vregs + 1;
+
+	if (ht_init(&ir_alias->cache, 0)) return IR_ERROR_NOMEM;
+
+	ir_alias->def = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_ALIAS,
+		vregs,
+		sizeof(*ir_alias->def));
+	if (!ir_alias->def) goto error;
+
+	ir_alias->address = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_ALIAS,
+		vregs,
+		sizeof(*ir_alias->address));
+	if (!ir_alias->address) goto error;
+
+	if (bitset_init(&ir_alias->resolved, vregs)) goto error;
+	if (bitset_init(&ir_alias->escaped, vregs)) goto error;
+
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			if (!reg.def || *reg.def >= ir_alias->vregs) continue;
+
+			// a second def leaves nothing to go on
+			if (BITSET_TEST(&ir_alias->resolved, *reg.def)) {
+				ir_alias->def[*reg.def] = NULL;
+				continue;
+			}
+
+			BITSET_SET(&ir_alias->resolved, *reg.def);
+			ir_alias->def[*reg.def] = quad[j];
+		}
+	}
+
+	bitset_zero(&ir_alias->resolved);
+
+	// parameters arrive in cells of their own
+	size_t argc = (ir_function->argv) ? ir_function->argv->use : 0;
+
+	for (size_t i = 0; i < argc; i++) {
+		uintptr_t     reg;
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(ir_function, i, &reg, &type);
+
+		if (reg >= ir_alias->vregs) continue;
+
+		ir_alias->address[reg] = (ir_alias_address_t) {
+			.base   = IR_ALIAS_BASE_CELL,
+			.object = reg,
+			.exact  = true,
+		};
+
+		BITSET_SET(&ir_alias->resolved, reg);
+	}
+
+	for (size_t i = 0; i < ir_alias->vregs; i++)
+		resolve(ir_alias, i, 0);
+
+	escapes(ir_alias);
+
+	return 0;
+
+error:
+	ir_alias_free(ir_alias);
+
+	return IR_ERROR_NOMEM;
+}
+
+ir_alias_result_t ir_alias_query(
+	ir_alias_t      *ir_alias,
+	const ir_quad_t *lhs,
+	const ir_quad_t *rhs)
+{
+	++ir_alias->queries;
+
+	alias_access_t l[ALIAS_ACCESSES_MAX];
+	alias_access_t r[ALIAS_ACCESSES_MAX];
+
+	size_t ls = accesses(ir_alias, lhs, l);
+	size_t rs = accesses(ir_alias, rhs, r);
+
+	if (!ls || !rs) return IR_ALIAS_NO;
+
+	// the answer is symmetric, so only one order is kept
+	alias_pair_t key = {
+		.lhs = (lhs < rhs) ? lhs : rhs,
+		.rhs = (lhs < rhs) ? rhs : lhs,
+	};
+	void *val;
+
+	if (!ht_get(&ir_alias->cache, &key, sizeof(key), &val)) {
+		++ir_alias->hits;
+		return (ir_alias_result_t) ((uintptr_t) val - 1);
+	}
+
+	ir_alias_result_t result = IR_ALIAS_NO;
+
+	for (size_t i = 0; i < ls; i++) {
+		for (size_t j = 0; j < rs; j++) {
+			ir_alias_result_t pair = compare(
+				ir_alias,
+				&l[i],
+				&r[j]);
+
+			if (pair == IR_ALIAS_NO) continue;
+
+			// a quad touching more than one place only ever may
+			result = (ls == 1 && rs == 1) ? pair : IR_ALIAS_MAY;
+		}
+	}
+
+	// a miss here only costs working it out again
+	ht_insert(
+		&ir_alias->cache,
+		&key,
+		sizeof(key),
+		(void*) ((uintptr_t) result + 1));
+
+	return result;
+}
+
+
+static size_t accesses(
+	const ir_alias_t *ir_alias,
+	const ir_quad_t  *ir_quad,
+	alias_access_t   *access)
+{
+	const ir_alias_address_t *address = ir_alias->address;
+
+	switch (*ir_quad) {
+		case IR_QUAD_LOAD:;
+			const ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_load_t);
+
+			// loading a declaration only takes its address
+			if (load->src.type != IR_LOCATION_REG) return 0;
+
+			access[0] = (alias_access_t) {
+				.address = address[load->src.reg],
+				.size    = width(load->type),
+				.type    = load->type,
+			};
+
+			return 1;
+
+		case IR_QUAD_STORE:;
+			const ir_quad_store_t *store = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_store_t);
+
+			access[0] = (alias_access_t) {
+				.address = address[store->dst],
+				.size    = width(store->type),
+				.type    = store->type,
+			};
+
+			return 1;
+
+		case IR_QUAD_VECTOR:;
+			const ir_quad_vector_t *vector = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_vector_t);
+
+			uintptr_t reg[] = {
+				vector->dst,
+				vector->lhs,
+				vector->rhs,
+			};
+
+			for (size_t i = 0; i < ALIAS_ACCESSES_MAX; i++)
+				access[i] = (alias_access_t) {
+					.address = address[reg[i]],
+					.size    = vector->lanes
+						* width(vector->type),
+					.type    = vector->type,
+				};
+
+			return ALIAS_ACCESSES_MAX;
+
+		case IR_QUAD_CALL:
+			access[0] = (alias_access_t) {
+				.wild = true,
+			};
+
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+
+static ir_alias_address_t arithmetic(
+	const ir_quad_binop_t *binop,
+	ir_alias_address_t     lhs,
+	ir_alias_address_t     rhs)
+{
+	ir_alias_address_t none = {
+		.base = IR_ALIAS_BASE_NONE,
+	};
+
+	bool    exact = lhs.exact && rhs.exact;
+	int64_t value;
+
+	switch (binop->op) {
+		case IR_QUAD_BINOP_ADD:
+			// a pointer plus a pointer is no pointer at all, so one
+			// of them is an element mistyped by the frontend
+			if (object(&lhs) && rhs.base == IR_ALIAS_BASE_POINTER)
+				rhs = none;
+
+			if (object(&rhs) && lhs.base == IR_ALIAS_BASE_POINTER)
+				lhs = none;
+
+			if (lhs.base != IR_ALIAS_BASE_NONE
+				&& rhs.base != IR_ALIAS_BASE_NONE) return none;
+
+			exact = lhs.exact && rhs.exact;
+			value = (int64_t) ((uint64_t) lhs.offset
+				+ (uint64_t) rhs.offset);
+
+			if (rhs.base != IR_ALIAS_BASE_NONE) lhs = rhs;
+			break;
+
+		case IR_QUAD_BINOP_SUB:
+			if (rhs.base != IR_ALIAS_BASE_NONE) return none;
+
+			value = (int64_t) ((uint64_t) lhs.offset
+				- (uint64_t) rhs.offset);
+			break;
+
+		case IR_QUAD_BINOP_MUL:
+			if (lhs.base != IR_ALIAS_BASE_NONE
+				|| rhs.base != IR_ALIAS_BASE_NONE) return none;
+
+			value = (int64_t) ((uint64_t) lhs.offset
+				* (uint64_t) rhs.offset);
+			break;
+
+		case IR_QUAD_BINOP_LSL:
+			if (lhs.base != IR_ALIAS_BASE_NONE
+				|| rhs.base != IR_ALIAS_BASE_NONE) return none;
+
+			value = (int64_t) ((uint64_t) lhs.offset
+				<< (rhs.offset & 63));
+			break;
+
+		default:
+			return none;
+	}
+
+	// i32 results are kept sign-extended
+	if (binop->type == IR_REG_TYPE_I32) value = (int32_t) value;
+
+	lhs.offset = value;
+	lhs.exact  = exact;
+
+	return lhs;
+}
+
+static ir_alias_result_t compare(
+	const ir_alias_t     *ir_alias,
+	const alias_access_t *lhs,
+	const alias_access_t *rhs)
+{
+	const ir_alias_address_t *l = &lhs->address;
+	const ir_alias_address_t *r = &rhs->address;
+
+	// a call reaches everything but the cells nobody else can
+	if (lhs->wild || rhs->wild) {
+		const ir_alias_address_t *other = (lhs->wild) ? r : l;
+
+		if (lhs->wild && rhs->wild) return IR_ALIAS_MAY;
+
+		if (other->base == IR_ALIAS_BASE_CELL
+			&& !BITSET_TEST(&ir_alias->escaped, other->object))
+			return IR_ALIAS_NO;
+
+		return IR_ALIAS_MAY;
+	}
+
+	if (l->base == IR_ALIAS_BASE_NONE || l->base == IR_ALIAS_BASE_POINTER)
+		if (!same(l, r)) return unknown(ir_alias, lhs, r);
+
+	if (r->base == IR_ALIAS_BASE_NONE || r->base == IR_ALIAS_BASE_POINTER)
+		if (!same(l, r)) return unknown(ir_alias, rhs, l);
+
+	// distinct objects never overlap
+	if (!same(l, r)) return IR_ALIAS_NO;
+
+	if (!l->exact || !r->exact) return IR_ALIAS_MAY;
+
+	int64_t lo = l->offset;
+	int64_t ro = r->offset;
+
+	if (lo + (int64_t) lhs->size <= ro) return IR_ALIAS_NO;
+	if (ro + (int64_t) rhs->size <= lo) return IR_ALIAS_NO;
+
+	return (lo == ro && lhs->size == rhs->size)
+		? IR_ALIAS_MUST
+		: IR_ALIAS_MAY;
+}
+
+static bool contained(
+	const ir_alias_t *ir_alias,
+	const ir_quad_t  *ir_quad,
+	uintptr_t         reg)
+{
+	ir_quad_reg_t quad_reg;
+
+	switch (*ir_quad) {
+		case IR_QUAD_LOAD:
+		case IR_QUAD_VECTOR:
+			return true;
+
+		case IR_QUAD_STORE:
+			return OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_store_t)->dst == reg;
+
+		case IR_QUAD_BINOP:
+			IR_QUAD_REG((ir_quad_t*) ir_quad, &quad_reg);
+
+			return same(
+				&ir_alias->address[reg],
+				&ir_alias->address[*quad_reg.def]);
+
+		default:
+			return false;
+	}
+}
+
+static bool declared(const ir_alias_address_t *address, ir_reg_type_t *type)
+{
+	ast_t *declaration = (ast_t*) address->object;
+
+	// string literals are char arrays, which alias anything
+	if (*declaration != AST_DECLARATION) return false;
+
+	ast_t *ast_type = ast_declaration_get_type(declaration);
+
+	if (*ast_type != AST_POINTER) return false;
+
+	*type = IR_REG_TYPE_PTR;
+
+	return true;
+}
+
+static void escapes(ir_alias_t *ir_alias)
+{
+	ir_function_t  *ir_function = ir_alias->ir_function;
+	ir_bb_t       **ir_bb       = ir_function->bb.buf;
+	size_t          vregs       = ir_alias->vregs;
+
+	// a cell only ever accessed, or offset into something still
+	// known to point at it, cannot be reached any other way
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+				if (*reg.use[k] >= vregs) continue;
+
+				const ir_alias_address_t *use
+					= &ir_alias->address[*reg.use[k]];
+
+				if (use->base != IR_ALIAS_BASE_CELL) continue;
+				if (contained(ir_alias, quad[j], *reg.use[k]))
+					continue;
+
+				BITSET_SET(&ir_alias->escaped, use->object);
+			}
+		}
+	}
+}
+
+static bool object(const ir_alias_address_t *address)
+{
+	return address->base == IR_ALIAS_BASE_CELL
+		|| address->base == IR_ALIAS_BASE_STATIC
+		|| address->base == IR_ALIAS_BASE_EXTERN;
+}
+
+static ir_alias_address_t resolve(
+	ir_alias_t *ir_alias,
+	uintptr_t   reg,
+	size_t      depth)
+{
+	ir_alias_address_t none = {
+		.base = IR_ALIAS_BASE_NONE,
+	};
+
+	// an immediate is an exact offset from nothing, as a mov is
+	if (IR_REG_IS_IMMEDIATE(reg)) {
+		none.exact  = true;
+		none.offset = IR_REG_IMMEDIATE_VALUE(reg);
+
+		return none;
+	}
+
+	if (reg >= ir_alias->vregs) return none;
+
+	ir_alias_address_t *address = &ir_alias->address[reg];
+
+	if (BITSET_TEST(&ir_alias->resolved, reg)) return *address;
+
+	if (depth >= ALIAS_DEPTH) return none;
+
+	// also what a def reached again through itself sees
+	BITSET_SET(&ir_alias->resolved, reg);
+	*address = none;
+
+	const ir_quad_t *ir_quad = ir_alias->def[reg];
+
+	if (!ir_quad) return none;
+
+	switch (*ir_quad) {
+		case IR_QUAD_ALLOCA:
+			*address = (ir_alias_address_t) {
+				.base   = IR_ALIAS_BASE_CELL,
+				.object = reg,
+				.exact  = true,
+			};
+			break;
+
+		case IR_QUAD_BINOP:;
+			const ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_binop_t);
+
+			ir_alias_address_t lhs = resolve(
+				ir_alias,
+				binop->lhs,
+				depth + 1);
+			ir_alias_address_t rhs = resolve(
+				ir_alias,
+				binop->rhs,
+				depth + 1);
+
+			*address = arithmetic(binop, lhs, rhs);
+			break;
+
+		case IR_QUAD_LOAD:;
+			const ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_load_t);
+
+			address->exact = true;
+
+			switch (load->src.type) {
+				case IR_LOCATION_REG:
+					if (load->type != IR_REG_TYPE_PTR) {
+						address->exact = false;
+						break;
+					}
+
+					address->base   = IR_ALIAS_BASE_POINTER;
+					address->object = reg;
+					break;
+
+				case IR_LOCATION_STATIC_DECLARATION:
+					address->base   = IR_ALIAS_BASE_STATIC;
+					address->object = (uintptr_t)
+						load->src.static_declaration
+						->declaration;
+					break;
+
+				case IR_LOCATION_EXTERN_DECLARATION:
+					address->base   = IR_ALIAS_BASE_EXTERN;
+					address->object = (uintptr_t)
+						load->src.extern_declaration;
+					break;
+
+				default:
+					address->exact = false;
+					break;
+			}
+			break;
+
+		case IR_QUAD_MOV:;
+			const ir_quad_mov_t *mov = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_mov_t);
+
+			address->exact  = true;
+			address->offset = (mov->type == IR_REG_TYPE_I32)
+				? (int32_t) mov->immediate
+				: (int64_t) mov->immediate;
+			break;
+
+		default:
+			break;
+	}
+
+	return *address;
+}
+
+static bool same(const ir_alias_address_t *lhs, const ir_alias_address_t *rhs)
+{
+	if (lhs->base != rhs->base) return false;
+	if (lhs->base == IR_ALIAS_BASE_NONE) return false;
+	if (lhs->object == rhs->object) return true;
+
+	if (lhs->base != IR_ALIAS_BASE_EXTERN) return false;
+
+	// every declaration of an extern names the same object
+	const string_t *l = ast_identifier_get_string(
+		ast_declaration_get_identifier((ast_t*) lhs->object));
+	const string_t *r = ast_identifier_get_string(
+		ast_declaration_get_identifier((ast_t*) rhs->object));
+
+	return !strcmp(l->head, r->head);
+}
+
+static ir_alias_result_t unknown(
+	const ir_alias_t         *ir_alias,
+	const alias_access_t     *access,
+	const ir_alias_address_t *known)
+{
+	ir_reg_type_t type;
+
+	switch (known->base) {
+		case IR_ALIAS_BASE_CELL:
+			return BITSET_TEST(&ir_alias->escaped, known->object)
+				? IR_ALIAS_MAY
+				: IR_ALIAS_NO;
+
+		case IR_ALIAS_BASE_STATIC:
+		case IR_ALIAS_BASE_EXTERN:
+			// the frontend types every dereference as a ptr, so
+			// only an i32 access says what it really reads
+			if (access->type != IR_REG_TYPE_I32
+				|| !declared(known, &type)) return IR_ALIAS_MAY;
+
+			return (type != access->type)
+				? IR_ALIAS_NO
+				: IR_ALIAS_MAY;
+
+		default:
+			return IR_ALIAS_MAY;
+	}
+}
+
+static size_t width(ir_reg_type_t type)
+{
+	return (type == IR_REG_TYPE_I32) ? sizeof(int32_t) : sizeof(uint64_t);
+}
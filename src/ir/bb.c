@@ -13,6 +13,7 @@
 
 #include <jkcc/ast.h>
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 #include <jkcc/vector.h>
 
 
@@ -58,7 +59,7 @@ int (*const ir_bb_gen[AST_NODES_TOTAL])(
 	[AST_STRING_LITERAL]           = ir_bb_string_literal_gen,
 	[AST_STRUCT]                   = ir_bb_unknown_gen,
 	[AST_SWITCH]                   = ir_bb_unknown_gen,
-	[AST_TERNARY_OPERATOR]         = ir_bb_unknown_gen,
+	[AST_TERNARY_OPERATOR]         = ir_bb_select_gen,
 	[AST_TRANSLATION_UNIT]         = ir_bb_unknown_gen,
 	[AST_TYPE]                     = ir_bb_unknown_gen,
 	[AST_TYPE_QUALIFIER]           = ir_bb_unknown_gen,
@@ -70,7 +71,7 @@ int (*const ir_bb_gen[AST_NODES_TOTAL])(
 
 ir_bb_t *ir_bb_alloc(size_t id)
 {
-	ir_bb_t *ir_bb = malloc(sizeof(*ir_bb));
+	ir_bb_t *ir_bb = MEM_MALLOC(MEM_TAG_IR, MEM_IR_BB, sizeof(*ir_bb));
 	if (!ir_bb) return NULL;
 
 	if (vector_init(&ir_bb->quad, sizeof(ir_quad_t*), 0)) goto error;
@@ -80,7 +81,7 @@ ir_bb_t *ir_bb_alloc(size_t id)
 	return ir_bb;
 
 error:
-	free(ir_bb);
+	MEM_FREE(ir_bb);
 
 	return NULL;
 }
@@ -94,17 +95,49 @@ void ir_bb_fprint(FILE *stream, ir_bb_t *ir_bb)
 		IR_QUAD_FPRINT(stream, ir_quad[i]);
 }
 
+void ir_bb_fprint_jsonl(
+	FILE    *stream,
+	ir_bb_t *ir_bb,
+	size_t   parent,
+	size_t  *id)
+{
+	size_t bb_id = (*id)++;
+
+	fprintf(
+		stream,
+		"{\"id\":%zu,\"parent\":%zu,\"kind\":\"bb\",\"bb\":%lu}\n",
+		bb_id,
+		parent,
+		ir_bb->id);
+
+	ir_quad_t **ir_quad = ir_bb->quad.buf;
+	for (size_t i = 0; i < ir_bb->quad.use; i++) {
+		fprintf(
+			stream,
+			"{\"id\":%zu,\"parent\":%zu,\"kind\":\"quad\""
+			",\"index\":%zu,\"quad\":\"%s\"",
+			(*id)++,
+			bb_id,
+			i,
+			IR_QUAD_STR(ir_quad[i]));
+
+		IR_QUAD_FPRINT_JSONL(stream, ir_quad[i]);
+
+		fprintf(stream, "}\n");
+	}
+}
+
 void ir_bb_free(ir_bb_t *ir_bb)
 {
 	if (!ir_bb) return;
 
 	ir_quad_t **ir_quad = ir_bb->quad.buf;
 	for (size_t i = 0; i < ir_bb->quad.use; i++)
-		(void) ir_quad;
+		IR_QUAD_FREE(ir_quad[i]);
 
 	vector_free(&ir_bb->quad);
 
-	free(ir_bb);
+	MEM_FREE(ir_bb);
 }
 
 int ir_bb_unknown_gen(
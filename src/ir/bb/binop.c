@@ -76,13 +76,9 @@ int ir_bb_binop_gen(
 		case AST_BINARY_OPERATOR_GREATER_THAN_OR_EQUAL:
 		case AST_BINARY_OPERATOR_EQUALITY:
 		case AST_BINARY_OPERATOR_INEQUALITY:
-			return ir_bb_cmp_gen(ir_context, ast);
-
 		case AST_BINARY_OPERATOR_LOGICAL_AND:
-			return ir_bb_cmp_and_gen(ir_context, ast);
-
 		case AST_BINARY_OPERATOR_LOGICAL_OR:
-			return ir_bb_cmp_or_gen(ir_context, ast);
+			return ir_bb_select_gen(ir_context, ast);
 
 		default:
 			return IR_ERROR_UNKNOWN_AST_NODE;
@@ -107,18 +103,7 @@ int ir_bb_binop_gen(
 
 	// integer "promotion"
 	if (binop.lhs.type != binop.rhs.type) {
-		ret = ir_quad_mov_gen(
-				&quad,
-				ir_context->current.dst,
-				IR_REG_TYPE_I32,
-				4);
-		if (ret) return ret;
-
-		if (vector_append(
-			&ir_context->ir_bb->quad,
-			&quad)) return IR_ERROR_NOMEM;
-
-		ir_context->result = ir_context->current.dst++;
+		ir_context->result = IR_REG_IMMEDIATE_GEN(4);
 		ir_context->type   = IR_REG_TYPE_I32;
 
 		uintptr_t src = (binop.lhs.type == IR_REG_TYPE_I32)
@@ -182,7 +167,7 @@ error_ht_insert_reg_type:
 	vector_pop(&ir_context->ir_bb->quad, NULL);
 
 error_vector_append_ir_bb_quad:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return IR_ERROR_NOMEM;
 }
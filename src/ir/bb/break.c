@@ -34,7 +34,7 @@ int ir_bb_break_gen(
 	return 0;
 
 error_vector_append_ir_quad_br_true:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return IR_ERROR_NOMEM;
 }
@@ -8,6 +8,7 @@
 #include <jkcc/ir/ir.h>
 #include <jkcc/private/ir.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <jkcc/ast.h>
@@ -37,16 +38,25 @@ int ir_bb_call_gen(
 
 	IR_BB_INIT;
 
+	// arguments are only passed once every one of them is evaluated,
+	// as one may itself be a call that passes its own
+	vector_t arg;
+	size_t   passed = 0;
+
+	if (vector_init(&arg, sizeof(ir_quad_t*), 0)) return IR_ERROR_NOMEM;
+
 	if (ast_argument_list) {
 		vector_t *list = ast_list_get_list(ast_argument_list);
 
 		ast_t **argument = list->buf;
 		for (size_t i = list->use - 1; i != SIZE_MAX; i--) {
 			ret = IR_BB_GEN(ir_context, argument[i]);
-			if (ret) return ret;
+			if (ret) goto error_arg;
 
 			key = ir_context->result;
-			ht_get(
+			val = (void*) IR_REG_TYPE_I32;
+
+			if (!IR_REG_IS_IMMEDIATE(key)) ht_get(
 				&ir_context->ir_function->reg.type,
 				&key,
 				sizeof(key),
@@ -59,15 +69,32 @@ int ir_bb_call_gen(
 				i,
 				ir_context->result,
 				type);
-			if (ret) return ret;
+			if (ret) goto error_arg;
 
-			if (vector_append(
-				&ir_context->ir_bb->quad,
-				&quad))
-				return IR_ERROR_NOMEM;
+			if (vector_append(&arg, &quad)) {
+				IR_QUAD_FREE(quad);
+				ret = IR_ERROR_NOMEM;
+				goto error_arg;
+			}
 		}
 	}
 
+	ir_quad_t **pending = arg.buf;
+
+	for (; passed < arg.use; passed++)
+		if (vector_append(&ir_context->ir_bb->quad, &pending[passed]))
+			break;
+
+	ret = (passed < arg.use) ? IR_ERROR_NOMEM : 0;
+
+error_arg:
+	for (size_t i = passed; i < arg.use; i++)
+		IR_QUAD_FREE(((ir_quad_t**) arg.buf)[i]);
+
+	vector_free(&arg);
+
+	if (ret) return ret;
+
 	// TODO: determine return types
 	type = IR_REG_TYPE_I32;
 
@@ -199,18 +199,7 @@ int ir_bb_cmp_zr_gen(
 	if (ret) return ret;
 
 	cmp.lhs = ir_context->result;
-
-	ret = ir_quad_mov_gen(
-		&quad,
-		ir_context->current.dst,
-		IR_REG_TYPE_I32,
-		0);
-	if (ret) return ret;
-
-	if (vector_append(&ir_context->ir_bb->quad, &quad))
-		return IR_ERROR_NOMEM;
-
-	cmp.rhs = ir_context->current.dst++;
+	cmp.rhs = IR_REG_IMMEDIATE_GEN(0);
 
 	ret = ir_quad_cmp_gen(&quad, cmp.lhs, cmp.rhs);
 	if (ret) return ret;
@@ -224,5 +213,17 @@ int ir_bb_cmp_zr_gen(
 	if (vector_append(&ir_context->ir_bb->quad, &quad))
 		return IR_ERROR_NOMEM;
 
+	// same as a relational operand, only fall through mid-short-circuit
+	if (!ir_context->short_circuit) {
+		ret = ir_quad_br_gen(
+			&quad,
+			IR_QUAD_BR_AL,
+			ir_context->br_false);
+		if (ret) return ret;
+
+		if (vector_append(&ir_context->ir_bb->quad, &quad))
+			return IR_ERROR_NOMEM;
+	}
+
 	return 0;
 }
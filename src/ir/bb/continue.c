@@ -34,7 +34,7 @@ int ir_bb_continue_gen(
 	return 0;
 
 error_vector_append_ir_quad_br_loop_expression:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return IR_ERROR_NOMEM;
 }
@@ -75,7 +75,7 @@ error_ht_insert_reg_type:
 	ht_rm(&ir_context->ir_function->reg.lookup, &key, sizeof(key), NULL);
 
 error_ht_insert_reg_lookup:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return IR_ERROR_NOMEM;
 }
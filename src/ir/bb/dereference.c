@@ -6,6 +6,7 @@
 
 #include <jkcc/ir/bb/dereference.h>
 #include <jkcc/ir/ir.h>
+#include <jkcc/private/dereference.h>
 #include <jkcc/private/ir.h>
 
 #include <stdbool.h>
@@ -46,7 +47,7 @@ int ir_bb_dereference_gen(
 		ir_bb_dereference_gen(ir_context, operand);
 
 		load.src.reg = ir_context->result;
-		load.type    = IR_REG_TYPE_PTR;
+		load.type    = element(operand);
 
 		goto load_value;
 	}
@@ -55,8 +56,12 @@ int ir_bb_dereference_gen(
 
 	ret = IR_BB_GEN(ir_context, operand);
 	if (ret) return ret;
+
+	// loads and stores only address through a register
+	ret = ir_bb_mov_reg_gen(ir_context);
+	if (ret) return ret;
 	load.src.reg = ir_context->result;
-	load.type    = IR_REG_TYPE_PTR;
+	load.type    = element(operand);
 
 	// we want to avoid the final dereference
 	// if we're generating an lvalue
@@ -83,6 +88,7 @@ load_value:
 		val)) goto error_ht_insert_reg_type;
 
 	ir_context->result = ir_context->current.dst++;
+	ir_context->type   = load.type;
 
 	return 0;
 
@@ -90,7 +96,75 @@ error_ht_insert_reg_type:
 	vector_pop(&ir_context->ir_bb->quad, NULL);
 
 error_vector_append_ir_bb_quad:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return IR_ERROR_NOMEM;
 }
+
+
+static ast_t *declared(ast_t *ast)
+{
+	ast_t *type;
+
+	// without a type checker, the declaration a pointer came from
+	// is only traced through the operators that keep it a pointer
+	switch (*ast) {
+		case AST_IDENTIFIER:
+			return ast_identifier_get_type(ast);
+
+		case AST_BINARY_OPERATOR:
+			switch (ast_binary_operator_get_operator(ast)) {
+				case AST_BINARY_OPERATOR_ADDITION:
+				case AST_BINARY_OPERATOR_SUBTRACTION:
+					break;
+
+				default:
+					return NULL;
+			}
+
+			type = declared(ast_binary_operator_get_lhs(ast));
+			if (type && (*type == AST_POINTER || *type == AST_ARRAY))
+				return type;
+
+			return declared(ast_binary_operator_get_rhs(ast));
+
+		case AST_DEREFERENCE:
+			type = declared(ast_dereference_get_operand(ast));
+			if (!type) return NULL;
+
+			if (*type == AST_POINTER)
+				return ast_pointer_get_pointer(type);
+
+			if (*type == AST_ARRAY) return ast_array_get_type(type);
+
+			return NULL;
+
+		default:
+			return NULL;
+	}
+}
+
+static ir_reg_type_t element(ast_t *ast)
+{
+	ast_t *type = declared(ast);
+
+	// anything we can't see through stays an address
+	if (!type) return IR_REG_TYPE_PTR;
+
+	switch (*type) {
+		case AST_POINTER:
+			type = ast_pointer_get_pointer(type);
+			break;
+
+		case AST_ARRAY:
+			type = ast_array_get_type(type);
+			break;
+
+		default:
+			return IR_REG_TYPE_PTR;
+	}
+
+	// the ir only has a register type for ints, what else an
+	// element holds keeps being read the way it always was
+	return ir_type_int(type) ? IR_REG_TYPE_I32 : IR_REG_TYPE_PTR;
+}
@@ -14,6 +14,7 @@
 #include <jkcc/constant.h>
 #include <jkcc/ht.h>
 #include <jkcc/ir.h>
+#include <jkcc/vector.h>
 
 
 int ir_bb_mov_gen(
@@ -38,12 +39,22 @@ int ir_bb_mov_gen(
 
 	if (integer_constant->type != INT) return IR_ERROR_UNKNOWN_AST_NODE;
 
+	ir_context->result = IR_REG_IMMEDIATE_GEN(integer_constant->INT);
+	ir_context->type   = reg_type;
+
+	return 0;
+}
+
+int ir_bb_mov_reg_gen(ir_context_t *ir_context)
+{
+	if (!IR_REG_IS_IMMEDIATE(ir_context->result)) return 0;
+
 	ir_quad_t *quad;
 	int ret = ir_quad_mov_gen(
 		&quad,
 		ir_context->current.dst,
-		reg_type,
-		integer_constant->INT);
+		ir_context->type,
+		IR_REG_IMMEDIATE_VALUE(ir_context->result));
 	if (ret) return ret;
 
 	if (vector_append(
@@ -51,7 +62,7 @@ int ir_bb_mov_gen(
 		&quad)) goto error_vector_append_ir_bb_quad;
 
 	uintptr_t key = ir_context->current.dst;
-	uintptr_t val = reg_type;
+	uintptr_t val = ir_context->type;
 
 	if (ht_insert(
 		&ir_context->ir_function->reg.type,
@@ -60,7 +71,6 @@ int ir_bb_mov_gen(
 		(void*) val)) goto error_ht_insert_reg_type;
 
 	ir_context->result = ir_context->current.dst++;
-	ir_context->type   = reg_type;
 
 	return 0;
 
@@ -68,7 +78,7 @@ error_ht_insert_reg_type:
 	vector_pop(&ir_context->ir_bb->quad, NULL);
 
 error_vector_append_ir_bb_quad:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return IR_ERROR_NOMEM;
 }
@@ -37,9 +37,9 @@ int ir_bb_return_gen(
 		src = ir_context->result;
 
 		uintptr_t  key = src;
-		void      *val;
+		void      *val = (void*) IR_REG_TYPE_I32;
 
-		ht_get(
+		if (!IR_REG_IS_IMMEDIATE(key)) ht_get(
 			&ir_context->ir_function->reg.type,
 			&key,
 			sizeof(key),
@@ -62,7 +62,7 @@ int ir_bb_return_gen(
 	return 0;
 
 error_vector_append_ir_quad_ret:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return ret;
 }
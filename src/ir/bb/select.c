@@ -0,0 +1,479 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * select.c -- select basic block
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/bb/select.h>
+#include <jkcc/ir/ir.h>
+#include <jkcc/private/ir.h>
+#include <jkcc/private/select.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+int ir_bb_select_gen(
+	ir_context_t *ir_context,
+	ast_t        *ast)
+{
+	IR_BB_INIT;
+
+	if (*ast == AST_TERNARY_OPERATOR) return ternary(ir_context, ast);
+
+	if (*ast != AST_BINARY_OPERATOR) return IR_ERROR_UNKNOWN_AST_NODE;
+
+	uint_fast32_t operator = ast_binary_operator_get_operator(ast);
+	switch (operator) {
+		case AST_BINARY_OPERATOR_LOGICAL_AND:
+			return logical(ir_context, ast, true);
+
+		case AST_BINARY_OPERATOR_LOGICAL_OR:
+			return logical(ir_context, ast, false);
+
+		default:
+			break;
+	}
+
+	select_cmp_t select_cmp;
+
+	int ret = operands(ir_context, ast, &select_cmp);
+	if (ret) return ret;
+
+	ret = compare(ir_context, &select_cmp);
+	if (ret) return ret;
+
+	return choose(
+		ir_context,
+		select_cmp.condition,
+		IR_REG_TYPE_I32,
+		IR_REG_IMMEDIATE_GEN(1),
+		IR_REG_IMMEDIATE_GEN(0));
+}
+
+
+static int branch(
+	ir_context_t *ir_context,
+	ast_t        *ast)
+{
+	struct {
+		size_t     id;
+		ir_bb_t   *bb;
+		ast_t     *value;
+		ir_quad_t *store;
+	} path[2] = {0}, exit = {0};  // taken, not taken
+
+	ast_t *condition = ast;
+
+	if (*ast == AST_TERNARY_OPERATOR) {
+		condition     = ast_ternary_operator_get_condition(ast);
+		path[0].value = ast_ternary_operator_get_lhs(ast);
+		path[1].value = ast_ternary_operator_get_rhs(ast);
+	}
+
+	int        ret;
+	ir_quad_t *quad;
+	ir_quad_t *cell;
+
+	// both paths leave their value in a cell for the exit to load
+	ret = ir_quad_alloca_gen(
+		&cell,
+		ir_context->current.dst,
+		IR_REG_TYPE_I32);
+	if (ret) return ret;
+
+	if (vector_append(&ir_context->ir_bb->quad, &cell)) {
+		IR_QUAD_FREE(cell);
+		return IR_ERROR_NOMEM;
+	}
+
+	uintptr_t dst = ir_context->current.dst++;
+
+	for (size_t i = 0; i < 2; i++) {
+		path[i].bb = ir_bb_alloc(ir_context->current.bb);
+		if (!path[i].bb) return IR_ERROR_NOMEM;
+
+		if (vector_append(&ir_context->ir_function->bb, &path[i].bb))
+			return IR_ERROR_NOMEM;
+
+		path[i].id = ir_context->current.bb++;
+	}
+
+	exit.bb = ir_bb_alloc(ir_context->current.bb);
+	if (!exit.bb) return IR_ERROR_NOMEM;
+
+	if (vector_append(&ir_context->ir_function->bb, &exit.bb))
+		return IR_ERROR_NOMEM;
+
+	exit.id = ir_context->current.bb++;
+
+	// "push" our stack, we may be the operand of a short-circuit
+	size_t br_true       = ir_context->br_true;
+	size_t br_false      = ir_context->br_false;
+	size_t br_exit       = ir_context->br_exit;
+	bool   short_circuit = ir_context->short_circuit;
+
+	ir_context->br_true       = path[0].id;
+	ir_context->br_false      = path[1].id;
+	ir_context->br_exit       = exit.id;
+	ir_context->short_circuit = false;
+
+	ret = ir_bb_cmp_gen(ir_context, condition);
+	if (ret) return ret;
+
+	ir_reg_type_t type = IR_REG_TYPE_I32;
+
+	for (size_t i = 0; i < 2; i++) {
+		ir_context->ir_bb = path[i].bb;
+
+		if (path[i].value) {
+			ret = IR_BB_GEN(ir_context, path[i].value);
+			if (ret) return ret;
+		} else {
+			ir_context->result = IR_REG_IMMEDIATE_GEN(!i);
+			ir_context->type   = IR_REG_TYPE_I32;
+		}
+
+		if (ir_context->type == IR_REG_TYPE_PTR) type = IR_REG_TYPE_PTR;
+
+		ret = ir_quad_store_gen(
+			&path[i].store,
+			ir_context->result,
+			ir_context->type,
+			dst);
+		if (ret) return ret;
+
+		if (vector_append(&ir_context->ir_bb->quad, &path[i].store)) {
+			IR_QUAD_FREE(path[i].store);
+			return IR_ERROR_NOMEM;
+		}
+
+		IR_BB_FINISH(ret, &quad, exit.id);
+		if (ret) return ret;
+	}
+
+	// "popping" our stack
+	ir_context->br_true       = br_true;
+	ir_context->br_false      = br_false;
+	ir_context->br_exit       = br_exit;
+	ir_context->short_circuit = short_circuit;
+	ir_context->ir_bb         = exit.bb;
+
+	// an arm is only known to be a pointer once both are generated
+	OFFSETOF_IR_QUAD(cell, ir_quad_alloca_t)->type = type;
+
+	for (size_t i = 0; i < 2; i++)
+		OFFSETOF_IR_QUAD(path[i].store, ir_quad_store_t)->type = type;
+
+	uintptr_t key = dst;
+	uintptr_t val = type;
+
+	if (ht_insert(
+		&ir_context->ir_function->reg.type,
+		&key,
+		sizeof(key),
+		(void*) val)) return IR_ERROR_NOMEM;
+
+	ir_location_t src = {
+		.type = IR_LOCATION_REG,
+		.reg  = dst,
+	};
+
+	ret = ir_quad_load_gen(&quad, ir_context->current.dst, type, &src);
+	if (ret) return ret;
+
+	if (vector_append(&ir_context->ir_bb->quad, &quad))
+		goto error_vector_append_ir_bb_quad;
+
+	key = ir_context->current.dst;
+
+	if (ht_insert(
+		&ir_context->ir_function->reg.type,
+		&key,
+		sizeof(key),
+		(void*) val)) goto error_ht_insert_reg_type;
+
+	ir_context->result = ir_context->current.dst++;
+	ir_context->type   = type;
+
+	return 0;
+
+error_ht_insert_reg_type:
+	vector_pop(&ir_context->ir_bb->quad, NULL);
+
+error_vector_append_ir_bb_quad:
+	IR_QUAD_FREE(quad);
+
+	return IR_ERROR_NOMEM;
+}
+
+static int choose(
+	ir_context_t           *ir_context,
+	ir_quad_br_condition_t  condition,
+	ir_reg_type_t           type,
+	uintptr_t               lhs,
+	uintptr_t               rhs)
+{
+	ir_quad_t *quad;
+
+	int ret = ir_quad_select_gen(
+		&quad,
+		ir_context->current.dst,
+		condition,
+		type,
+		lhs,
+		rhs);
+	if (ret) return ret;
+
+	if (vector_append(&ir_context->ir_bb->quad, &quad))
+		goto error_vector_append_ir_bb_quad;
+
+	uintptr_t key = ir_context->current.dst;
+	uintptr_t val = type;
+
+	if (ht_insert(
+		&ir_context->ir_function->reg.type,
+		&key,
+		sizeof(key),
+		(void*) val)) goto error_ht_insert_reg_type;
+
+	ir_context->result = ir_context->current.dst++;
+	ir_context->type   = type;
+
+	return 0;
+
+error_ht_insert_reg_type:
+	vector_pop(&ir_context->ir_bb->quad, NULL);
+
+error_vector_append_ir_bb_quad:
+	IR_QUAD_FREE(quad);
+
+	return IR_ERROR_NOMEM;
+}
+
+static int compare(
+	ir_context_t       *ir_context,
+	const select_cmp_t *select_cmp)
+{
+	ir_quad_t *quad;
+
+	int ret = ir_quad_cmp_gen(&quad, select_cmp->lhs, select_cmp->rhs);
+	if (ret) return ret;
+
+	if (vector_append(&ir_context->ir_bb->quad, &quad)) {
+		IR_QUAD_FREE(quad);
+		return IR_ERROR_NOMEM;
+	}
+
+	return 0;
+}
+
+static size_t cost(ast_t *ast)
+{
+	// anything that may trap, write or call has to stay on its path
+	switch (*ast) {
+		case AST_INTEGER_CONSTANT:
+		case AST_SIZEOF:
+			return 0;
+
+		case AST_IDENTIFIER:
+		case AST_STRING_LITERAL:
+			return 1;
+
+		case AST_BINARY_OPERATOR: {
+			uint_fast32_t operator
+				= ast_binary_operator_get_operator(ast);
+
+			if (operator == AST_BINARY_OPERATOR_DIVISION
+				|| operator == AST_BINARY_OPERATOR_MODULO)
+				return SIZE_MAX;
+
+			size_t lhs = cost(ast_binary_operator_get_lhs(ast));
+			size_t rhs = cost(ast_binary_operator_get_rhs(ast));
+
+			if (lhs == SIZE_MAX || rhs == SIZE_MAX) return SIZE_MAX;
+
+			return 1 + lhs + rhs;
+		}
+
+		case AST_TERNARY_OPERATOR: {
+			size_t condition = cost(
+				ast_ternary_operator_get_condition(ast));
+			size_t lhs = cost(ast_ternary_operator_get_lhs(ast));
+			size_t rhs = cost(ast_ternary_operator_get_rhs(ast));
+
+			if (condition == SIZE_MAX
+				|| lhs == SIZE_MAX
+				|| rhs == SIZE_MAX) return SIZE_MAX;
+
+			return 2 + condition + lhs + rhs;
+		}
+
+		default:
+			return SIZE_MAX;
+	}
+}
+
+static int logical(
+	ir_context_t *ir_context,
+	ast_t        *ast,
+	bool          and)
+{
+	ast_t *lhs = ast_binary_operator_get_lhs(ast);
+	ast_t *rhs = ast_binary_operator_get_rhs(ast);
+
+	// short-circuiting is only observable when the rhs could be
+	if (cost(rhs) > SELECT_COST_MAX) return branch(ir_context, ast);
+
+	select_cmp_t select_cmp;
+
+	int ret = operands(ir_context, lhs, &select_cmp);
+	if (ret) return ret;
+
+	ret = compare(ir_context, &select_cmp);
+	if (ret) return ret;
+
+	ret = choose(
+		ir_context,
+		select_cmp.condition,
+		IR_REG_TYPE_I32,
+		IR_REG_IMMEDIATE_GEN(1),
+		IR_REG_IMMEDIATE_GEN(0));
+	if (ret) return ret;
+
+	uintptr_t first = ir_context->result;
+
+	ret = operands(ir_context, rhs, &select_cmp);
+	if (ret) return ret;
+
+	ret = compare(ir_context, &select_cmp);
+	if (ret) return ret;
+
+	return choose(
+		ir_context,
+		select_cmp.condition,
+		IR_REG_TYPE_I32,
+		(and) ? first : IR_REG_IMMEDIATE_GEN(1),
+		(and) ? IR_REG_IMMEDIATE_GEN(0) : first);
+}
+
+static int operands(
+	ir_context_t *ir_context,
+	ast_t        *ast,
+	select_cmp_t *select_cmp)
+{
+	int ret;
+
+	if (*ast == AST_BINARY_OPERATOR && !relational(
+		ast_binary_operator_get_operator(ast),
+		&select_cmp->condition)) {
+		ret = IR_BB_GEN(ir_context, ast_binary_operator_get_lhs(ast));
+		if (ret) return ret;
+		select_cmp->lhs = ir_context->result;
+
+		ret = IR_BB_GEN(ir_context, ast_binary_operator_get_rhs(ast));
+		if (ret) return ret;
+		select_cmp->rhs = ir_context->result;
+
+		return 0;
+	}
+
+	ret = IR_BB_GEN(ir_context, ast);
+	if (ret) return ret;
+
+	select_cmp->condition = IR_QUAD_BR_NE;
+	select_cmp->lhs       = ir_context->result;
+	select_cmp->rhs       = IR_REG_IMMEDIATE_GEN(0);
+
+	return 0;
+}
+
+static int relational(
+	uint_fast32_t           operator,
+	ir_quad_br_condition_t *condition)
+{
+	switch (operator) {
+		case AST_BINARY_OPERATOR_LESS_THAN:
+			*condition = IR_QUAD_BR_LT;
+			return 0;
+
+		case AST_BINARY_OPERATOR_GREATER_THAN:
+			*condition = IR_QUAD_BR_GT;
+			return 0;
+
+		case AST_BINARY_OPERATOR_LESS_THAN_OR_EQUAL:
+			*condition = IR_QUAD_BR_LE;
+			return 0;
+
+		case AST_BINARY_OPERATOR_GREATER_THAN_OR_EQUAL:
+			*condition = IR_QUAD_BR_GE;
+			return 0;
+
+		case AST_BINARY_OPERATOR_EQUALITY:
+			*condition = IR_QUAD_BR_EQ;
+			return 0;
+
+		case AST_BINARY_OPERATOR_INEQUALITY:
+			*condition = IR_QUAD_BR_NE;
+			return 0;
+
+		default:
+			return -1;
+	}
+}
+
+static int ternary(
+	ir_context_t *ir_context,
+	ast_t        *ast)
+{
+	ast_t *condition = ast_ternary_operator_get_condition(ast);
+	ast_t *lhs       = ast_ternary_operator_get_lhs(ast);
+	ast_t *rhs       = ast_ternary_operator_get_rhs(ast);
+
+	if (cost(lhs) > SELECT_COST_MAX || cost(rhs) > SELECT_COST_MAX)
+		return branch(ir_context, ast);
+
+	struct {
+		uintptr_t     reg;
+		ir_reg_type_t type;
+	} value[2];
+
+	select_cmp_t select_cmp;
+
+	// the condition's side effects happen before either arm reads
+	// anything, while its flags have to be the last ones set
+	int ret = operands(ir_context, condition, &select_cmp);
+	if (ret) return ret;
+
+	ret = IR_BB_GEN(ir_context, lhs);
+	if (ret) return ret;
+	value[0].reg  = ir_context->result;
+	value[0].type = ir_context->type;
+
+	ret = IR_BB_GEN(ir_context, rhs);
+	if (ret) return ret;
+	value[1].reg  = ir_context->result;
+	value[1].type = ir_context->type;
+
+	ret = compare(ir_context, &select_cmp);
+	if (ret) return ret;
+
+	ir_reg_type_t type
+		= (value[0].type == IR_REG_TYPE_PTR
+		|| value[1].type == IR_REG_TYPE_PTR)
+		? IR_REG_TYPE_PTR
+		: IR_REG_TYPE_I32;
+
+	return choose(
+		ir_context,
+		select_cmp.condition,
+		type,
+		value[0].reg,
+		value[1].reg);
+}
@@ -13,9 +13,7 @@
 
 #include <jkcc/ast.h>
 #include <jkcc/constant.h>
-#include <jkcc/ht.h>
 #include <jkcc/ir.h>
-#include <jkcc/vector.h>
 
 
 int ir_bb_sizeof_gen(
@@ -81,30 +79,7 @@ int ir_bb_sizeof_gen(
 		}
 	}
 
-	int        ret;
-	ir_quad_t *quad;
-
-	ret = ir_quad_mov_gen(
-		&quad,
-		ir_context->current.dst,
-		IR_REG_TYPE_I32,
-		size);
-	if (ret) return ret;
-
-	if (vector_append(
-		&ir_context->ir_bb->quad,
-		&quad)) return IR_ERROR_NOMEM;
-
-	uintptr_t  key = ir_context->current.dst;
-	void      *val = (void*) IR_REG_TYPE_I32;
-
-	if (ht_insert(
-		&ir_context->ir_function->reg.type,
-		&key,
-		sizeof(key),
-		val)) return IR_ERROR_NOMEM;
-
-	ir_context->result = ir_context->current.dst++;
+	ir_context->result = IR_REG_IMMEDIATE_GEN(size);
 	ir_context->type   = IR_REG_TYPE_I32;
 
 	return 0;
@@ -134,18 +134,7 @@ compound_assignment:
 
 	// integer "promotion"
 	if (binop.lhs.type != binop.rhs.type) {
-		ret = ir_quad_mov_gen(
-				&quad,
-				ir_context->current.dst,
-				IR_REG_TYPE_I32,
-				4);
-		if (ret) return ret;
-
-		if (vector_append(
-			&ir_context->ir_bb->quad,
-			&quad)) return IR_ERROR_NOMEM;
-
-		ir_context->result = ir_context->current.dst++;
+		ir_context->result = IR_REG_IMMEDIATE_GEN(4);
 		ir_context->type   = IR_REG_TYPE_I32;
 
 		uintptr_t src = (binop.lhs.type == IR_REG_TYPE_I32)
@@ -209,7 +198,7 @@ error_ht_insert_reg_type:
 	vector_pop(&ir_context->ir_bb->quad, NULL);
 
 error_vector_append_ir_bb_quad:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return IR_ERROR_NOMEM;
 }
@@ -8,6 +8,7 @@
 #include <jkcc/ir/ir.h>
 #include <jkcc/private/ir.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <jkcc/ast.h>
@@ -83,6 +84,8 @@ src_set:
 			? IR_REG_TYPE_I32
 			: IR_REG_TYPE_PTR;
 
+		bool array = *(ast_t*) key == AST_ARRAY;
+
 		key = ir_context->current.dst;
 		val = (void*) type;
 
@@ -93,6 +96,14 @@ src_set:
 			val)) return IR_ERROR_NOMEM;
 
 		val = (void*) ir_context->current.dst++;
+
+		// an array is the storage it names, not a pointer to it
+		if (array && !ir_context->lvalue) {
+			ir_context->result = (uintptr_t) val;
+			ir_context->type   = IR_REG_TYPE_PTR;
+
+			return 0;
+		}
 	}
 
 	if (ir_context->lvalue) {
@@ -135,7 +146,7 @@ error_ht_insert_reg_type:
 	vector_pop(&ir_context->ir_bb->quad, NULL);
 
 error_vector_append_ir_bb_quad:
-	free(quad);
+	IR_QUAD_FREE(quad);
 
 	return IR_ERROR_NOMEM;
 }
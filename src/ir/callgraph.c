@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * callgraph.c -- call graph
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/callgraph.h>
+#include <jkcc/private/callgraph.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+void ir_callgraph_free(ir_callgraph_t *ir_callgraph)
+{
+	if (!ir_callgraph) return;
+
+	for (size_t i = 0; i < ir_callgraph->functions; i++) {
+		if (ir_callgraph->callee) vector_free(&ir_callgraph->callee[i]);
+		if (ir_callgraph->caller) vector_free(&ir_callgraph->caller[i]);
+	}
+
+	ht_free(&ir_callgraph->lookup, NULL);
+
+	MEM_FREE(ir_callgraph->callee);
+	MEM_FREE(ir_callgraph->caller);
+	MEM_FREE(ir_callgraph->scc);
+
+	ir_callgraph->callee = NULL;
+	ir_callgraph->caller = NULL;
+	ir_callgraph->scc    = NULL;
+	ir_callgraph->order  = NULL;
+}
+
+int ir_callgraph_init(ir_callgraph_t *ir_callgraph, ir_unit_t *ir_unit)
+{
+	*ir_callgraph = (ir_callgraph_t) {
+		.ir_unit   = ir_unit,
+		.functions = ir_unit->function.use,
+	};
+
+	if (ht_init(&ir_callgraph->lookup, 0)) return IR_ERROR_NOMEM;
+
+	ir_callgraph->callee = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CALLGRAPH,
+		ir_callgraph->functions + 1,
+		sizeof(*ir_callgraph->callee));
+	if (!ir_callgraph->callee) goto error;
+
+	ir_callgraph->caller = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CALLGRAPH,
+		ir_callgraph->functions + 1,
+		sizeof(*ir_callgraph->caller));
+	if (!ir_callgraph->caller) goto error;
+
+	// order shares the allocation
+	ir_callgraph->scc = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CALLGRAPH,
+		(ir_callgraph->functions * 2 + 1) * sizeof(*ir_callgraph->scc));
+	if (!ir_callgraph->scc) goto error;
+
+	ir_callgraph->order = ir_callgraph->scc + ir_callgraph->functions;
+
+	if (names(ir_callgraph)) goto error;
+	if (edges(ir_callgraph)) goto error;
+	if (tarjan(ir_callgraph)) goto error;
+
+	return 0;
+
+error:
+	ir_callgraph_free(ir_callgraph);
+
+	return IR_ERROR_NOMEM;
+}
+
+size_t ir_callgraph_lookup(
+	ir_callgraph_t  *ir_callgraph,
+	const ir_quad_t *ir_quad)
+{
+	ir_quad_call_t *call = OFFSETOF_IR_QUAD(ir_quad, ir_quad_call_t);
+	const char     *name = NULL;
+	void           *val;
+
+	if (call->src.type == IR_LOCATION_IDENTIFIER)
+		name = call->src.identifier->head;
+
+	if (call->src.type == IR_LOCATION_EXTERN_DECLARATION)
+		name = ast_identifier_get_string(
+			ast_declaration_get_identifier(
+				call->src.extern_declaration))->head;
+
+	if (!name) return SIZE_MAX;
+
+	if (ht_get(&ir_callgraph->lookup, name, strlen(name), &val))
+		return SIZE_MAX;
+
+	return (uintptr_t) val - 1;
+}
+
+
+static int edges(ir_callgraph_t *ir_callgraph)
+{
+	ir_function_t **ir_function = ir_callgraph->ir_unit->function.buf;
+
+	for (size_t i = 0; i < ir_callgraph->functions; i++) {
+		vector_t *callee = &ir_callgraph->callee[i];
+		vector_t *caller = &ir_callgraph->caller[i];
+
+		if (vector_init(callee, sizeof(size_t), 0)) return -1;
+		if (vector_init(caller, sizeof(size_t), 0)) return -1;
+	}
+
+	for (size_t i = 0; i < ir_callgraph->functions; i++) {
+		ir_bb_t **ir_bb = ir_function[i]->bb.buf;
+
+		for (size_t j = 0; j < ir_function[i]->bb.use; j++) {
+			ir_quad_t **quad = ir_bb[j]->quad.buf;
+
+			for (size_t k = 0; k < ir_bb[j]->quad.use; k++) {
+				if (*quad[k] != IR_QUAD_CALL) continue;
+
+				size_t callee = ir_callgraph_lookup(
+					ir_callgraph,
+					quad[k]);
+
+				if (callee == SIZE_MAX) continue;
+
+				vector_t *edge = &ir_callgraph->callee[i];
+				size_t   *buf  = edge->buf;
+				size_t    l    = 0;
+
+				// a function is often called more than once
+				while (l < edge->use && buf[l] != callee) ++l;
+				if (l < edge->use) continue;
+
+				if (vector_append(edge, &callee)) return -1;
+
+				if (vector_append(
+					&ir_callgraph->caller[callee],
+					&i)) return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static const char *name(const ir_function_t *ir_function)
+{
+	return ast_identifier_get_string(
+		ast_function_get_identifier(
+			ir_function->declaration))->head;
+}
+
+static int names(ir_callgraph_t *ir_callgraph)
+{
+	ir_function_t **ir_function = ir_callgraph->ir_unit->function.buf;
+
+	for (size_t i = 0; i < ir_callgraph->functions; i++) {
+		const char *key = name(ir_function[i]);
+		size_t      len = strlen(key);
+
+		// the first definition is the one called
+		if (ht_exists(&ir_callgraph->lookup, key, len)) continue;
+
+		if (ht_insert(
+			&ir_callgraph->lookup,
+			key,
+			len,
+			(void*) (i + 1))) return -1;
+	}
+
+	return 0;
+}
+
+static int tarjan(ir_callgraph_t *ir_callgraph)
+{
+	size_t functions = ir_callgraph->functions;
+
+	// index, lowlink, the component stack, and frames of a function
+	// and the next callee to visit share the allocation
+	size_t *index = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CALLGRAPH,
+		(functions * 5 + 1) * sizeof(*index));
+	if (!index) return -1;
+
+	size_t *low   = index + functions;
+	size_t *stack = low + functions;
+	size_t *frame = stack + functions;
+
+	size_t next = 0;
+	size_t top  = 0;
+	size_t done = 0;
+
+	ir_callgraph->sccs = 0;
+
+	for (size_t i = 0; i < functions; i++) {
+		index[i]             = SIZE_MAX;
+		ir_callgraph->scc[i] = SIZE_MAX;
+	}
+
+	for (size_t root = 0; root < functions; root++) {
+		if (index[root] != SIZE_MAX) continue;
+
+		size_t depth = 0;
+
+		index[root]    = low[root] = next++;
+		stack[top++]   = root;
+		frame[depth++] = root;
+		frame[depth++] = 0;
+
+		while (depth) {
+			size_t  v      = frame[depth - 2];
+			size_t *edge   = &frame[depth - 1];
+			size_t *callee = ir_callgraph->callee[v].buf;
+
+			if (*edge < ir_callgraph->callee[v].use) {
+				size_t w = callee[(*edge)++];
+
+				if (index[w] == SIZE_MAX) {
+					index[w]       = low[w] = next++;
+					stack[top++]   = w;
+					frame[depth++] = w;
+					frame[depth++] = 0;
+					continue;
+				}
+
+				// still on the stack
+				if (ir_callgraph->scc[w] == SIZE_MAX
+					&& index[w] < low[v])
+					low[v] = index[w];
+
+				continue;
+			}
+
+			depth -= 2;
+
+			if (depth && low[v] < low[frame[depth - 2]])
+				low[frame[depth - 2]] = low[v];
+
+			if (low[v] != index[v]) continue;
+
+			// a component is complete only after every one it calls
+			size_t scc = ir_callgraph->sccs++;
+			size_t w;
+
+			do {
+				w = stack[--top];
+
+				ir_callgraph->scc[w]        = scc;
+				ir_callgraph->order[done++] = w;
+			} while (w != v);
+		}
+	}
+
+	MEM_FREE(index);
+
+	return 0;
+}
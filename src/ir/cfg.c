@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * cfg.c -- control-flow graph
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/cfg.h>
+#include <jkcc/private/cfg.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+void ir_cfg_free(ir_cfg_t *ir_cfg)
+{
+	if (!ir_cfg) return;
+
+	for (size_t i = 0; i < ir_cfg->bbs; i++) {
+		if (ir_cfg->succ) vector_free(&ir_cfg->succ[i]);
+		if (ir_cfg->pred) vector_free(&ir_cfg->pred[i]);
+	}
+
+	MEM_FREE(ir_cfg->succ);
+	MEM_FREE(ir_cfg->pred);
+	MEM_FREE(ir_cfg->rpo);
+
+	ir_cfg->succ      = NULL;
+	ir_cfg->pred      = NULL;
+	ir_cfg->rpo       = NULL;
+	ir_cfg->rpo_index = NULL;
+}
+
+int ir_cfg_init(ir_cfg_t *ir_cfg, ir_function_t *ir_function)
+{
+	*ir_cfg = (ir_cfg_t) {
+		.ir_function = ir_function,
+		.bbs         = ir_function->bb.use,
+	};
+
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+
+	ht_t index;
+	if (ht_init(&index, 0)) return IR_ERROR_NOMEM;
+
+	for (size_t i = 0; i < ir_cfg->bbs; i++)
+		if (ht_insert(
+			&index,
+			&ir_bb[i]->id,
+			sizeof(ir_bb[i]->id),
+			(void*) i)) goto error_ht_insert_index;
+
+	ir_cfg->succ = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CFG,
+		ir_cfg->bbs + 1,
+		sizeof(*ir_cfg->succ));
+	if (!ir_cfg->succ) goto error_alloc_succ;
+
+	ir_cfg->pred = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CFG,
+		ir_cfg->bbs + 1,
+		sizeof(*ir_cfg->pred));
+	if (!ir_cfg->pred) goto error_alloc_pred;
+
+	// rpo_index shares the allocation
+	ir_cfg->rpo = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CFG,
+		(ir_cfg->bbs * 2 + 1) * sizeof(*ir_cfg->rpo));
+	if (!ir_cfg->rpo) goto error_alloc_rpo;
+
+	ir_cfg->rpo_index = ir_cfg->rpo + ir_cfg->bbs;
+
+	if (edges(ir_cfg, &index)) goto error_edges;
+	if (postorder(ir_cfg)) goto error_postorder;
+
+	ht_free(&index, NULL);
+
+	return 0;
+
+error_postorder:
+error_edges:
+error_alloc_rpo:
+error_alloc_pred:
+error_alloc_succ:
+	ir_cfg_free(ir_cfg);
+
+error_ht_insert_index:
+	ht_free(&index, NULL);
+
+	return IR_ERROR_NOMEM;
+}
+
+
+static int edges(ir_cfg_t *ir_cfg, ht_t *index)
+{
+	ir_bb_t **ir_bb = ir_cfg->ir_function->bb.buf;
+
+	for (size_t i = 0; i < ir_cfg->bbs; i++) {
+		if (vector_init(&ir_cfg->succ[i], sizeof(size_t), 0)) return -1;
+		if (vector_init(&ir_cfg->pred[i], sizeof(size_t), 0)) return -1;
+	}
+
+	for (size_t i = 0; i < ir_cfg->bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j <= ir_bb[i]->quad.use; j++) {
+			size_t succ;
+
+			if (j == ir_bb[i]->quad.use) {
+				if (!fallthrough(ir_bb[i])) break;
+				if (i + 1 >= ir_cfg->bbs) break;
+
+				succ = i + 1;
+			} else {
+				if (*quad[j] != IR_QUAD_BR) continue;
+
+				ir_quad_br_t *br;
+				void         *val;
+
+				br = OFFSETOF_IR_QUAD(quad[j], ir_quad_br_t);
+
+				if (br->condition == IR_QUAD_BR_NV) continue;
+
+				size_t size = sizeof(br->bb);
+
+				if (ht_get(index, &br->bb, size, &val))
+					continue;
+
+				succ = (uintptr_t) val;
+			}
+
+			// br.cc and br.al can name the same bb
+			size_t *edge = ir_cfg->succ[i].buf;
+			size_t  k    = 0;
+			while (k < ir_cfg->succ[i].use && edge[k] != succ) ++k;
+			if (k < ir_cfg->succ[i].use) continue;
+
+			if (vector_append(&ir_cfg->succ[i], &succ)) return -1;
+			if (vector_append(&ir_cfg->pred[succ], &i)) return -1;
+		}
+	}
+
+	return 0;
+}
+
+static bool fallthrough(ir_bb_t *ir_bb)
+{
+	if (!ir_bb->quad.use) return true;
+
+	ir_quad_t *last = ((ir_quad_t**) ir_bb->quad.buf)[ir_bb->quad.use - 1];
+
+	if (*last == IR_QUAD_RET) return false;
+
+	if (*last != IR_QUAD_BR) return true;
+
+	return OFFSETOF_IR_QUAD(last, ir_quad_br_t)->condition
+		!= IR_QUAD_BR_AL;
+}
+
+static int postorder(ir_cfg_t *ir_cfg)
+{
+	size_t bbs = ir_cfg->bbs;
+
+	// each frame is a bb and the next successor to visit
+	size_t *stack = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CFG,
+		(bbs * 2 + 1) * sizeof(*stack));
+	if (!stack) return -1;
+
+	for (size_t i = 0; i < bbs; i++) ir_cfg->rpo_index[i] = SIZE_MAX;
+
+	// unreachable bbs are ordered after the entry's
+	size_t done = 0;
+	for (size_t root = 0; root < bbs; root++) {
+		if (ir_cfg->rpo_index[root] != SIZE_MAX) continue;
+
+		size_t base  = done;
+		size_t depth = 0;
+
+		ir_cfg->rpo_index[root] = 0;
+		stack[depth++] = root;
+		stack[depth++] = 0;
+
+		while (depth) {
+			size_t  bb   = stack[depth - 2];
+			size_t *next = &stack[depth - 1];
+			size_t *succ = ir_cfg->succ[bb].buf;
+
+			if (*next < ir_cfg->succ[bb].use) {
+				size_t s = succ[(*next)++];
+
+				if (ir_cfg->rpo_index[s] != SIZE_MAX) continue;
+
+				ir_cfg->rpo_index[s] = 0;
+				stack[depth++] = s;
+				stack[depth++] = 0;
+				continue;
+			}
+
+			ir_cfg->rpo[done++] = bb;
+			depth -= 2;
+		}
+
+		// postorder to reverse postorder
+		for (size_t i = base, j = done - 1; i < j; i++, j--) {
+			size_t tmp     = ir_cfg->rpo[i];
+			ir_cfg->rpo[i] = ir_cfg->rpo[j];
+			ir_cfg->rpo[j] = tmp;
+		}
+	}
+
+	for (size_t i = 0; i < bbs; i++) ir_cfg->rpo_index[ir_cfg->rpo[i]] = i;
+
+	MEM_FREE(stack);
+
+	return 0;
+}
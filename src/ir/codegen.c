@@ -0,0 +1,1300 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * codegen.c -- x86-64 instruction selection
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/codegen.h>
+#include <jkcc/private/codegen.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/string.h>
+#include <jkcc/vector.h>
+#include <jkcc/x86.h>
+
+
+// allocated registers never need saving around a call
+static const x86_reg_t callee_saved[CALLEE_SAVED] = {
+	X86_RBX,
+	X86_R12,
+	X86_R13,
+	X86_R14,
+	X86_R15,
+};
+
+static const x86_reg_t argv_reg[ARGV_REGS] = {
+	X86_RDI,
+	X86_RSI,
+	X86_RDX,
+	X86_RCX,
+	X86_R8,
+	X86_R9,
+};
+
+static const x86_cc_t br_cc[] = {
+	[IR_QUAD_BR_EQ] = X86_CC_E,
+	[IR_QUAD_BR_NE] = X86_CC_NE,
+	[IR_QUAD_BR_HS] = X86_CC_AE,
+	[IR_QUAD_BR_LO] = X86_CC_B,
+	[IR_QUAD_BR_MI] = X86_CC_S,
+	[IR_QUAD_BR_PL] = X86_CC_NS,
+	[IR_QUAD_BR_VS] = X86_CC_O,
+	[IR_QUAD_BR_VC] = X86_CC_NO,
+	[IR_QUAD_BR_HI] = X86_CC_A,
+	[IR_QUAD_BR_LS] = X86_CC_BE,
+	[IR_QUAD_BR_GE] = X86_CC_GE,
+	[IR_QUAD_BR_LT] = X86_CC_L,
+	[IR_QUAD_BR_GT] = X86_CC_G,
+	[IR_QUAD_BR_LE] = X86_CC_LE,
+};
+
+static const x86_alu_t binop_alu[] = {
+	[IR_QUAD_BINOP_ADD] = X86_ALU_ADD,
+	[IR_QUAD_BINOP_SUB] = X86_ALU_SUB,
+	[IR_QUAD_BINOP_AND] = X86_ALU_AND,
+	[IR_QUAD_BINOP_OOR] = X86_ALU_OR,
+	[IR_QUAD_BINOP_EOR] = X86_ALU_XOR,
+};
+
+static const x86_sse_t vector_sse[] = {
+	[IR_QUAD_BINOP_ADD] = X86_SSE_PADDD,
+	[IR_QUAD_BINOP_SUB] = X86_SSE_PSUBD,
+	[IR_QUAD_BINOP_AND] = X86_SSE_PAND,
+	[IR_QUAD_BINOP_OOR] = X86_SSE_POR,
+	[IR_QUAD_BINOP_EOR] = X86_SSE_PXOR,
+};
+
+
+void ir_codegen_free(ir_codegen_t *ir_codegen)
+{
+	if (!ir_codegen) return;
+
+	x86_free(&ir_codegen->text);
+	vector_free(&ir_codegen->symbol);
+	vector_free(&ir_codegen->reloc);
+	ht_free(&ir_codegen->lookup, NULL);
+
+	MEM_FREE(ir_codegen->rodata);
+
+	ir_codegen->rodata = NULL;
+}
+
+int ir_codegen_init(ir_codegen_t *ir_codegen, ir_unit_t *ir_unit)
+{
+	*ir_codegen = (ir_codegen_t) {
+		.ir_unit = ir_unit,
+	};
+
+	ht_t symbol;
+	int  ret = IR_ERROR_NOMEM;
+
+	if (ht_init(&symbol, 0)) return IR_ERROR_NOMEM;
+
+	if (x86_init(&ir_codegen->text)) goto error;
+
+	if (vector_init(
+		&ir_codegen->symbol,
+		sizeof(ir_codegen_symbol_t),
+		0)) goto error;
+
+	if (vector_init(
+		&ir_codegen->reloc,
+		sizeof(ir_codegen_reloc_t),
+		0)) goto error;
+
+	if (ht_init(&ir_codegen->lookup, 0)) goto error;
+
+	if (layout(ir_codegen, &symbol)) goto error;
+
+	// every name has to be known before any call is selected
+	ir_function_t **ir_function = ir_unit->function.buf;
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		const char *linkage = ir_function_linkage_str(ir_function[i]);
+
+		ir_codegen_symbol_t function = {
+			.name    = ast_identifier_get_string(
+				ast_function_get_identifier(
+					ir_function[i]->declaration))->head,
+			.section = IR_CODEGEN_SECTION_TEXT,
+			.global  = strcmp(linkage, "internal"),
+		};
+
+		if (symbol_add(ir_codegen, &function, NULL)) goto error;
+	}
+
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		ret = function(ir_codegen, i, &symbol);
+		if (ret) goto error;
+	}
+
+	ret = IR_ERROR_NOMEM;
+	if (ir_codegen->text.nomem) goto error;
+
+	// calls within the unit never need the linker
+	ir_codegen_symbol_t *sym   = ir_codegen->symbol.buf;
+	ir_codegen_reloc_t  *reloc = ir_codegen->reloc.buf;
+	size_t               kept  = 0;
+
+	for (size_t i = 0; i < ir_codegen->reloc.use; i++) {
+		ir_codegen_symbol_t *target = &sym[reloc[i].symbol];
+
+		if (target->section != IR_CODEGEN_SECTION_TEXT) {
+			reloc[kept++] = reloc[i];
+			continue;
+		}
+
+		x86_patch32(
+			&ir_codegen->text,
+			reloc[i].offset,
+			target->offset + reloc[i].addend - reloc[i].offset);
+	}
+
+	ir_codegen->reloc.use = kept;
+
+	ht_free(&symbol, NULL);
+
+	return 0;
+
+error:
+	ht_free(&symbol, NULL);
+	ir_codegen_free(ir_codegen);
+
+	return ret;
+}
+
+ir_codegen_symbol_t *ir_codegen_lookup(
+	ir_codegen_t *ir_codegen,
+	const char   *name)
+{
+	void *val;
+
+	if (ht_get(&ir_codegen->lookup, name, strlen(name), &val)) return NULL;
+
+	return (ir_codegen_symbol_t*) ir_codegen->symbol.buf + (uintptr_t) val;
+}
+
+
+static int call(isel_t *isel, ir_quad_call_t *quad)
+{
+	x86_t      *text = &isel->ir_codegen->text;
+	const char *name = NULL;
+	uint32_t    dst  = reg(isel, quad->dst);
+
+	if (quad->src.type == IR_LOCATION_IDENTIFIER)
+		name = quad->src.identifier->head;
+
+	if (quad->src.type == IR_LOCATION_EXTERN_DECLARATION)
+		name = ast_identifier_get_string(
+			ast_declaration_get_identifier(
+				quad->src.extern_declaration))->head;
+
+	size_t argc = isel->argc;
+
+	isel->argc = 0;
+
+	if (!name || dst == UINT32_MAX) {
+		x86_ud2(text);
+		return 0;
+	}
+
+	size_t index;
+	ir_codegen_symbol_t callee = {
+		.name    = name,
+		.section = IR_CODEGEN_SECTION_UNDEF,
+		.global  = true,
+	};
+
+	if (symbol_add(isel->ir_codegen, &callee, &index))
+		return IR_ERROR_NOMEM;
+
+	// with the frame gone the callee returns straight to our caller,
+	// which only works while every argument fits in a register
+	if (quad->tail && argc <= ARGV_REGS) {
+		for (size_t i = 0; i < argc; i++)
+			x86_load(
+				text,
+				true,
+				argv_reg[i],
+				X86_RBP,
+				disp(isel, isel->argv[i]));
+
+		teardown(isel);
+
+		x86_alu(text, X86_ALU_XOR, false, X86_RAX, X86_RAX);
+
+		ir_codegen_reloc_t reloc = {
+			.offset = x86_jmp(text),
+			.symbol = index,
+			.type   = IR_CODEGEN_RELOC_PLT32,
+			.addend = -(int64_t) sizeof(int32_t),
+		};
+
+		isel->terminated = true;
+
+		return vector_append(&isel->ir_codegen->reloc, &reloc)
+			? IR_ERROR_NOMEM
+			: 0;
+	}
+
+	// keep the stack 16-byte aligned across the call
+	size_t stack = (argc > ARGV_REGS) ? argc - ARGV_REGS : 0;
+	size_t pad   = stack % 2;
+
+	if (pad) x86_alu_imm(text, X86_ALU_SUB, true, X86_RSP, 8);
+
+	for (size_t i = argc; i-- > ARGV_REGS;) {
+		int32_t cell = disp(isel, isel->argv[i]);
+
+		x86_load(text, true, X86_RAX, X86_RBP, cell);
+		x86_push(text, X86_RAX);
+	}
+
+	for (size_t i = 0; i < argc && i < ARGV_REGS; i++)
+		x86_load(
+			text,
+			true,
+			argv_reg[i],
+			X86_RBP,
+			disp(isel, isel->argv[i]));
+
+	// variadic callees are told no vector registers are in use
+	x86_alu(text, X86_ALU_XOR, false, X86_RAX, X86_RAX);
+
+	ir_codegen_reloc_t reloc = {
+		.offset = x86_call(text),
+		.symbol = index,
+		.type   = IR_CODEGEN_RELOC_PLT32,
+		.addend = -(int64_t) sizeof(int32_t),
+	};
+
+	if (vector_append(&isel->ir_codegen->reloc, &reloc))
+		return IR_ERROR_NOMEM;
+
+	if (stack + pad)
+		x86_alu_imm(
+			text,
+			X86_ALU_ADD,
+			true,
+			X86_RSP,
+			(stack + pad) * IR_CODEGEN_CELL);
+
+	if (quad->type == IR_REG_TYPE_I32) x86_movsxd(text, X86_RAX, X86_RAX);
+
+	writeback(isel, dst, X86_RAX);
+
+	return 0;
+}
+
+static void compare(isel_t *isel, const ir_quad_t *next)
+{
+	x86_t     *text = &isel->ir_codegen->text;
+	uintptr_t  lhs  = isel->cmp->lhs;
+	uintptr_t  rhs  = isel->cmp->rhs;
+	int64_t    imm  = IR_REG_IMMEDIATE_VALUE(rhs);
+	bool       wide = true;
+
+	if (!readable(isel, lhs) || !readable(isel, rhs)) {
+		x86_ud2(text);
+		return;
+	}
+
+	// sign and overflow are only defined on the i32 difference
+	if (next && (*next == IR_QUAD_BR || *next == IR_QUAD_SELECT)) {
+		ir_quad_br_condition_t condition = (*next == IR_QUAD_BR)
+			? OFFSETOF_IR_QUAD(next, ir_quad_br_t)->condition
+			: OFFSETOF_IR_QUAD(next, ir_quad_select_t)->condition;
+
+		wide = condition < IR_QUAD_BR_MI || condition > IR_QUAD_BR_VC;
+	}
+
+	x86_reg_t l = source(isel, lhs, X86_RAX);
+
+	if (IR_REG_IS_IMMEDIATE(rhs) && imm == (int32_t) imm) {
+		x86_alu_imm(text, X86_ALU_CMP, wide, l, imm);
+		return;
+	}
+
+	x86_alu(text, X86_ALU_CMP, wide, l, source(isel, rhs, X86_RCX));
+}
+
+static int32_t disp(const isel_t *isel, uint32_t index)
+{
+	// below the saved registers: slots, parameters, allocas, then args
+	return -(int32_t) ((isel->physical + index + 1) * IR_CODEGEN_CELL);
+}
+
+static void epilogue(isel_t *isel)
+{
+	teardown(isel);
+	x86_ret(&isel->ir_codegen->text);
+
+	isel->terminated = true;
+}
+
+static int function(ir_codegen_t *ir_codegen, size_t pos, ht_t *symbol)
+{
+	ir_function_t *ir_function = ((ir_function_t**)
+		ir_codegen->ir_unit->function.buf)[pos];
+	ir_regalloc_t *regalloc    = ir_function->regalloc;
+	x86_t         *text        = &ir_codegen->text;
+
+	isel_t isel = {
+		.ir_codegen  = ir_codegen,
+		.ir_function = ir_function,
+		.symbol      = symbol,
+		.params      = (ir_function->argv) ? ir_function->argv->use : 0,
+	};
+
+	isel.regs = (regalloc)
+		? regalloc->registers + regalloc->slots
+		: ir_function_vregs(ir_function);
+
+	if (regalloc)
+		isel.physical = (regalloc->registers < CALLEE_SAVED)
+			? regalloc->registers
+			: CALLEE_SAVED;
+
+	// the frame is sized up front
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	size_t    bbs   = ir_function->bb.use;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] == IR_QUAD_ALLOCA) ++isel.allocas;
+
+			if (*quad[j] != IR_QUAD_ARG) continue;
+
+			size_t arg = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_arg_t)->pos + 1;
+
+			if (arg > isel.outgoing && arg <= IR_CODEGEN_ARGV_MAX)
+				isel.outgoing = arg;
+		}
+	}
+
+	if (ht_init(&isel.bb, 0)) return IR_ERROR_NOMEM;
+
+	int ret = IR_ERROR_NOMEM;
+
+	if (vector_init(&isel.fixup, sizeof(fixup_t), 0)) goto error;
+
+	isel.bb_offset = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CODEGEN,
+		(bbs + 1) * sizeof(*isel.bb_offset));
+	if (!isel.bb_offset) goto error;
+
+	for (size_t i = 0; i < bbs; i++)
+		if (ht_insert(
+			&isel.bb,
+			&ir_bb[i]->id,
+			sizeof(ir_bb[i]->id),
+			(void*) i)) goto error;
+
+	ir_codegen_symbol_t *sym = ir_codegen_lookup(
+		ir_codegen,
+		ast_identifier_get_string(
+			ast_function_get_identifier(
+				ir_function->declaration))->head);
+
+	// a redefinition keeps the first body under the name
+	size_t start = text->use;
+
+	prologue(&isel);
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		size_t      use  = ir_bb[i]->quad.use;
+
+		isel.bb_offset[i] = text->use;
+
+		for (size_t j = 0; j < use; j++) {
+			// a trailing br.al onto the next bb falls through
+			size_t next = (j + 1 == use && i + 1 < bbs)
+				? ir_bb[i + 1]->id
+				: SIZE_MAX;
+
+			ret = select_quad(
+				&isel,
+				quad[j],
+				(j + 1 < use) ? quad[j + 1] : NULL,
+				next);
+			if (ret) goto error;
+		}
+	}
+
+	// falling off the end returns nothing
+	if (!isel.terminated) {
+		x86_alu(text, X86_ALU_XOR, false, X86_RAX, X86_RAX);
+		epilogue(&isel);
+	}
+
+	ret = IR_ERROR_NOMEM;
+	if (text->nomem) goto error;
+
+	fixup_t *fixup = isel.fixup.buf;
+	for (size_t i = 0; i < isel.fixup.use; i++)
+		x86_patch32(
+			text,
+			fixup[i].offset,
+			isel.bb_offset[fixup[i].bb]
+				- (fixup[i].offset + sizeof(int32_t)));
+
+	if (!sym->size) {
+		sym->offset = start;
+		sym->size   = text->use - start;
+	}
+
+	ret = 0;
+
+error:
+	MEM_FREE(isel.bb_offset);
+	vector_free(&isel.fixup);
+	ht_free(&isel.bb, NULL);
+
+	return ret;
+}
+
+static int layout(ir_codegen_t *ir_codegen, ht_t *symbol)
+{
+	ir_unit_t *ir_unit = ir_codegen->ir_unit;
+	size_t     size[IR_CODEGEN_SECTIONS_TOTAL] = {0};
+
+	ast_t **extern_declaration = ir_unit->extern_declaration.buf;
+	for (size_t i = 0; i < ir_unit->extern_declaration.use; i++) {
+		const void *key         = extern_declaration[i];
+		ast_t      *declaration = extern_declaration[i];
+		size_t      index;
+
+		if (ht_exists(symbol, &key, sizeof(key))) continue;
+
+		ir_codegen_symbol_t sym = {
+			.name    = ast_identifier_get_string(
+				ast_declaration_get_identifier(
+					declaration))->head,
+			.section = IR_CODEGEN_SECTION_BSS,
+			.offset  = size[IR_CODEGEN_SECTION_BSS],
+			.size    = ir_declaration_size(
+				declaration,
+				IR_CODEGEN_CELL),
+			.global  = true,
+		};
+
+		// prototypes name something defined elsewhere
+		if (*ast_declaration_get_type(declaration) == AST_FUNCTION)
+			sym.section = IR_CODEGEN_SECTION_UNDEF;
+
+		if (ir_codegen_lookup(ir_codegen, sym.name))
+			sym.section = IR_CODEGEN_SECTION_UNDEF;
+
+		if (sym.section == IR_CODEGEN_SECTION_UNDEF) {
+			sym.offset = 0;
+			sym.size   = 0;
+		}
+
+		if (symbol_add(ir_codegen, &sym, &index))
+			return IR_ERROR_NOMEM;
+
+		if (ht_insert(symbol, &key, sizeof(key), (void*) index))
+			return IR_ERROR_NOMEM;
+
+		size[sym.section] += sym.size;
+	}
+
+	ir_static_declaration_t **static_declaration
+		= ir_unit->static_declaration.buf;
+	for (size_t i = 0; i < ir_unit->static_declaration.use; i++) {
+		const void *key         = static_declaration[i];
+		ast_t      *declaration = static_declaration[i]->declaration;
+		size_t      index;
+
+		ir_codegen_symbol_t sym = {
+			.section = IR_CODEGEN_SECTION_BSS,
+		};
+
+		if (*declaration != AST_STRING_LITERAL)
+			sym.size = ir_declaration_size(
+				declaration,
+				IR_CODEGEN_CELL);
+
+		if (*declaration == AST_STRING_LITERAL) {
+			const string_t *string = &OFFSETOF_AST_NODE(
+				declaration,
+				ast_string_literal_t)->string_literal.string;
+
+			// room for the nul, rounded up to a whole cell
+			sym.section = IR_CODEGEN_SECTION_RODATA;
+			sym.size    = string->tail - string->head;
+			sym.size   += IR_CODEGEN_CELL
+				- sym.size % IR_CODEGEN_CELL;
+		}
+
+		sym.offset = size[sym.section];
+
+		if (symbol_add(ir_codegen, &sym, &index))
+			return IR_ERROR_NOMEM;
+
+		if (ht_insert(symbol, &key, sizeof(key), (void*) index))
+			return IR_ERROR_NOMEM;
+
+		size[sym.section] += sym.size;
+	}
+
+	ir_codegen->rodata = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_CODEGEN,
+		size[IR_CODEGEN_SECTION_RODATA] + 1,
+		1);
+	if (!ir_codegen->rodata) return IR_ERROR_NOMEM;
+
+	ir_codegen->rodata_size = size[IR_CODEGEN_SECTION_RODATA];
+	ir_codegen->bss_size    = size[IR_CODEGEN_SECTION_BSS];
+
+	for (size_t i = 0; i < ir_unit->static_declaration.use; i++) {
+		const void *key         = static_declaration[i];
+		ast_t      *declaration = static_declaration[i]->declaration;
+		void       *val;
+
+		if (*declaration != AST_STRING_LITERAL) continue;
+
+		ht_get(symbol, &key, sizeof(key), &val);
+
+		const string_t *string = &OFFSETOF_AST_NODE(
+			declaration,
+			ast_string_literal_t)->string_literal.string;
+
+		ir_codegen_symbol_t *sym = ir_codegen->symbol.buf;
+
+		memcpy(
+			ir_codegen->rodata + sym[(uintptr_t) val].offset,
+			string->head,
+			string->tail - string->head);
+	}
+
+	return 0;
+}
+
+static x86_reg_t operand(isel_t *isel, uint32_t index, x86_reg_t scratch)
+{
+	if (index < isel->physical) return callee_saved[index];
+
+	x86_load(
+		&isel->ir_codegen->text,
+		true,
+		scratch,
+		X86_RBP,
+		disp(isel, index));
+
+	return scratch;
+}
+
+static void prologue(isel_t *isel)
+{
+	x86_t         *text        = &isel->ir_codegen->text;
+	ir_function_t *ir_function = isel->ir_function;
+	ir_regalloc_t *regalloc    = ir_function->regalloc;
+
+	x86_push(text, X86_RBP);
+	x86_mov(text, true, X86_RBP, X86_RSP);
+
+	for (size_t i = 0; i < isel->physical; i++)
+		x86_push(text, callee_saved[i]);
+
+	size_t cells = isel->regs + isel->params + isel->allocas
+		+ isel->outgoing;
+	size_t frame = cells * IR_CODEGEN_CELL;
+
+	// the return address and rbp leave the stack 16-byte aligned
+	if ((isel->physical * IR_CODEGEN_CELL + frame) % 16)
+		frame += IR_CODEGEN_CELL;
+
+	if (frame) x86_alu_imm(text, X86_ALU_SUB, true, X86_RSP, frame);
+
+	// parameters live in memory, their register holds the address
+	for (size_t i = 0; i < isel->params; i++) {
+		int32_t cell = disp(isel, isel->regs + i);
+
+		x86_reg_t src = (i < ARGV_REGS) ? argv_reg[i] : X86_RAX;
+
+		if (i >= ARGV_REGS)
+			x86_load(
+				text,
+				true,
+				X86_RAX,
+				X86_RBP,
+				(i - ARGV_REGS + 2) * IR_CODEGEN_CELL);
+
+		x86_store(text, true, X86_RBP, cell, src);
+
+		uintptr_t     vreg;
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(ir_function, i, &vreg, &type);
+
+		// allocated parameters arrive in a register or slot
+		if (regalloc) {
+			vreg = regalloc->argv[i];
+
+			if (!(vreg & IR_REG_PHYSICAL))
+				vreg = (regalloc->registers + vreg)
+					| IR_REG_PHYSICAL;
+		}
+
+		uint32_t index = reg(isel, vreg);
+		if (index == UINT32_MAX) continue;
+
+		x86_reg_t dst = target(isel, index, X86_RAX);
+
+		x86_lea(text, dst, X86_RBP, cell);
+		writeback(isel, index, dst);
+	}
+
+	isel->cell = isel->params;
+}
+
+static bool readable(const isel_t *isel, uintptr_t src)
+{
+	return IR_REG_IS_IMMEDIATE(src) || reg(isel, src) != UINT32_MAX;
+}
+
+static uint32_t reg(const isel_t *isel, uintptr_t reg)
+{
+	// allocated quads only name physical registers
+	if (isel->ir_function->regalloc) {
+		if (!(reg & IR_REG_PHYSICAL)) return UINT32_MAX;
+
+		reg = IR_REG_INDEX(reg);
+	}
+
+	return (reg < isel->regs) ? reg : UINT32_MAX;
+}
+
+static int select_quad(
+	isel_t    *isel,
+	ir_quad_t *ir_quad,
+	ir_quad_t *following,
+	size_t     next)
+{
+	x86_t         *text     = &isel->ir_codegen->text;
+	ir_regalloc_t *regalloc = isel->ir_function->regalloc;
+	uint32_t       dst;
+	uint32_t       lhs;
+	uint32_t       rhs;
+	x86_reg_t      x;
+	x86_reg_t      y;
+	int64_t        imm;
+	void          *val;
+
+	// the moves regalloc puts between a cmp and what reads it never
+	// touch the flags, and neither do branches or selects
+	switch (*ir_quad) {
+		case IR_QUAD_BR:
+		case IR_QUAD_RELOAD:
+		case IR_QUAD_SELECT:
+		case IR_QUAD_SPILL:
+			break;
+
+		default:
+			isel->flags = false;
+			break;
+	}
+
+	isel->terminated = false;
+
+	switch (*ir_quad) {
+		case IR_QUAD_ALLOCA: {
+			ir_quad_alloca_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_alloca_t);
+
+			dst = reg(isel, quad->dst);
+			if (dst == UINT32_MAX) break;
+
+			x = target(isel, dst, X86_RAX);
+
+			x86_lea(
+				text,
+				x,
+				X86_RBP,
+				disp(isel, isel->regs + isel->cell++));
+			writeback(isel, dst, x);
+			return 0;
+		}
+
+		case IR_QUAD_ARG: {
+			ir_quad_arg_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_arg_t);
+
+			if (!readable(isel, quad->src)) break;
+			if (quad->pos >= IR_CODEGEN_ARGV_MAX) break;
+
+			// copied out now, the register may be reused before
+			// the call
+			rhs = isel->regs + isel->params + isel->allocas
+				+ quad->pos;
+
+			isel->argv[quad->pos] = rhs;
+
+			if (isel->argc <= quad->pos) isel->argc = quad->pos + 1;
+
+			imm = IR_REG_IMMEDIATE_VALUE(quad->src);
+
+			if (IR_REG_IS_IMMEDIATE(quad->src)
+				&& imm == (int32_t) imm) {
+				x86_store_imm(
+					text,
+					true,
+					X86_RBP,
+					disp(isel, rhs),
+					imm);
+				return 0;
+			}
+
+			x = source(isel, quad->src, X86_RAX);
+			x86_store(text, true, X86_RBP, disp(isel, rhs), x);
+			return 0;
+		}
+
+		case IR_QUAD_BINOP: {
+			ir_quad_binop_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_binop_t);
+
+			bool wide = quad->type == IR_REG_TYPE_PTR;
+
+			dst = reg(isel, quad->dst);
+			imm = IR_REG_IMMEDIATE_VALUE(quad->rhs);
+
+			if (dst == UINT32_MAX
+				|| !readable(isel, quad->lhs)
+				|| !readable(isel, quad->rhs)) break;
+
+			// a result with a register of its own is worked out in
+			// place, with nothing to copy once it shares lhs's
+			x86_reg_t t = target(isel, dst, X86_RAX);
+
+			bool divide = quad->op == IR_QUAD_BINOP_DIV
+				|| quad->op == IR_QUAD_BINOP_MOD;
+			bool clash  = !IR_REG_IS_IMMEDIATE(quad->rhs)
+				&& reg(isel, quad->rhs) == dst
+				&& (IR_REG_IS_IMMEDIATE(quad->lhs)
+				|| reg(isel, quad->lhs) != dst);
+
+			if (divide || clash) t = X86_RAX;
+
+			x = source(isel, quad->lhs, t);
+			if (x != t) x86_mov(text, true, t, x);
+
+			// small immediates are encoded in the instruction
+			bool fold = IR_REG_IS_IMMEDIATE(quad->rhs)
+				&& imm == (int32_t) imm
+				&& quad->op != IR_QUAD_BINOP_MUL
+				&& !divide;
+
+			y = (fold) ? X86_RCX : source(isel, quad->rhs, X86_RCX);
+			x = t;
+
+			switch (quad->op) {
+				case IR_QUAD_BINOP_MUL:
+					x86_imul(text, true, t, y);
+					break;
+
+				// i32 operands are sign-extended, so the
+				// 64-bit divide can never overflow
+				case IR_QUAD_BINOP_MOD:
+					x = X86_RDX;
+					/* fallthrough */
+				case IR_QUAD_BINOP_DIV:
+					x86_cqo(text);
+					x86_idiv(text, true, y);
+					break;
+
+				case IR_QUAD_BINOP_LSL:
+				case IR_QUAD_BINOP_LSR: {
+					x86_shift_t shift = X86_SHIFT_SHR;
+					uint8_t     mask  = (wide) ? 63 : 31;
+
+					if (quad->op == IR_QUAD_BINOP_LSL)
+						shift = X86_SHIFT_SHL;
+
+					// masked as the hardware does
+					if (fold) {
+						x86_shift_imm(
+							text,
+							shift,
+							wide,
+							t,
+							imm & mask);
+						break;
+					}
+
+					if (y != X86_RCX)
+						x86_mov(text, true, X86_RCX, y);
+
+					x86_shift(text, shift, wide, t);
+					break;
+				}
+
+				default:
+					if (fold)
+						x86_alu_imm(
+							text,
+							binop_alu[quad->op],
+							true,
+							t,
+							imm);
+					else
+						x86_alu(
+							text,
+							binop_alu[quad->op],
+							true,
+							t,
+							y);
+					break;
+			}
+
+			if (!wide) x86_movsxd(text, x, x);
+
+			writeback(isel, dst, x);
+			return 0;
+		}
+
+		case IR_QUAD_BR: {
+			ir_quad_br_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_br_t);
+
+			bool al = quad->condition == IR_QUAD_BR_AL;
+
+			if (quad->condition == IR_QUAD_BR_NV) return 0;
+
+			if (al && quad->bb == next) return 0;
+
+			size_t size = sizeof(quad->bb);
+
+			if (ht_get(&isel->bb, &quad->bb, size, &val)) break;
+
+			if (!al && !isel->flags) {
+				if (!isel->cmp) break;
+
+				compare(isel, ir_quad);
+			}
+
+			fixup_t fixup = {
+				.offset = (al)
+					? x86_jmp(text)
+					: x86_jcc(text, br_cc[quad->condition]),
+				.bb     = (uintptr_t) val,
+			};
+
+			if (vector_append(&isel->fixup, &fixup))
+				return IR_ERROR_NOMEM;
+
+			isel->terminated = al;
+			return 0;
+		}
+
+		case IR_QUAD_CALL:
+			return call(
+				isel,
+				OFFSETOF_IR_QUAD(ir_quad, ir_quad_call_t));
+
+		case IR_QUAD_CMP:
+			isel->cmp = OFFSETOF_IR_QUAD(ir_quad, ir_quad_cmp_t);
+
+			compare(isel, following);
+
+			isel->flags = true;
+			return 0;
+
+		case IR_QUAD_LOAD: {
+			ir_quad_load_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_load_t);
+
+			dst = reg(isel, quad->dst);
+			if (dst == UINT32_MAX) break;
+
+			// declarations load their address
+			const void *key;
+			switch (quad->src.type) {
+				case IR_LOCATION_REG:
+					lhs = reg(isel, quad->src.reg);
+					if (lhs == UINT32_MAX) goto unsupported;
+
+					y = operand(isel, lhs, X86_RAX);
+					x = target(isel, dst, X86_RAX);
+
+					if (quad->type == IR_REG_TYPE_PTR)
+						x86_load(text, true, x, y, 0);
+					else
+						x86_load_sx32(text, x, y, 0);
+
+					writeback(isel, dst, x);
+					return 0;
+
+				case IR_LOCATION_EXTERN_DECLARATION:
+					key = quad->src.extern_declaration;
+					break;
+
+				case IR_LOCATION_STATIC_DECLARATION:
+					key = quad->src.static_declaration;
+					break;
+
+				default:
+					goto unsupported;
+			}
+
+			if (ht_get(isel->symbol, &key, sizeof(key), &val))
+				break;
+
+			x = target(isel, dst, X86_RAX);
+
+			ir_codegen_reloc_t reloc = {
+				.offset = x86_lea_rip(text, x),
+				.symbol = (uintptr_t) val,
+				.type   = IR_CODEGEN_RELOC_PC32,
+				.addend = -(int64_t) sizeof(int32_t),
+			};
+
+			if (vector_append(&isel->ir_codegen->reloc, &reloc))
+				return IR_ERROR_NOMEM;
+
+			writeback(isel, dst, x);
+			return 0;
+		}
+
+		case IR_QUAD_MOV: {
+			ir_quad_mov_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_mov_t);
+
+			imm = (quad->type == IR_REG_TYPE_PTR)
+				? (int64_t) quad->immediate
+				: CODEGEN_I32(quad->immediate);
+
+			dst = reg(isel, quad->dst);
+			if (dst == UINT32_MAX) break;
+
+			if (dst >= isel->physical && imm == (int32_t) imm) {
+				x86_store_imm(
+					text,
+					true,
+					X86_RBP,
+					disp(isel, dst),
+					imm);
+				return 0;
+			}
+
+			x = target(isel, dst, X86_RAX);
+
+			x86_mov_imm(text, x, imm);
+			writeback(isel, dst, x);
+			return 0;
+		}
+
+		case IR_QUAD_RELOAD: {
+			ir_quad_reload_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_reload_t);
+
+			if (!regalloc) break;
+
+			dst = reg(isel, quad->dst);
+			lhs = regalloc->registers + quad->slot;
+
+			if (dst == UINT32_MAX || lhs >= isel->regs) break;
+
+			writeback(isel, dst, operand(isel, lhs, X86_RAX));
+			return 0;
+		}
+
+		case IR_QUAD_RET: {
+			ir_quad_ret_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_ret_t);
+
+			x = X86_RAX;
+
+			if (quad->src == UINTPTR_MAX) {
+				x86_alu(text, X86_ALU_XOR, false, x, x);
+				epilogue(isel);
+				return 0;
+			}
+
+			if (!readable(isel, quad->src)) break;
+
+			x = source(isel, quad->src, X86_RAX);
+			if (x != X86_RAX) x86_mov(text, true, X86_RAX, x);
+
+			epilogue(isel);
+			return 0;
+		}
+
+		case IR_QUAD_SELECT: {
+			ir_quad_select_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_select_t);
+
+			int64_t l = IR_REG_IMMEDIATE_VALUE(quad->lhs);
+			int64_t r = IR_REG_IMMEDIATE_VALUE(quad->rhs);
+
+			dst = reg(isel, quad->dst);
+			if (dst == UINT32_MAX) break;
+
+			if (!readable(isel, quad->lhs)
+				|| !readable(isel, quad->rhs)) break;
+
+			x = target(isel, dst, X86_RAX);
+
+			// nothing left to choose between, just a copy
+			if (quad->condition == IR_QUAD_BR_AL
+				|| quad->condition == IR_QUAD_BR_NV) {
+				y = source(
+					isel,
+					(quad->condition == IR_QUAD_BR_AL)
+						? quad->lhs
+						: quad->rhs,
+					x);
+				if (y != x) x86_mov(text, true, x, y);
+
+				writeback(isel, dst, x);
+				return 0;
+			}
+
+			if (!isel->flags) {
+				if (!isel->cmp) break;
+
+				compare(isel, ir_quad);
+			}
+
+			x86_cc_t cc = br_cc[quad->condition];
+
+			// a 0 and a 1 either way round is a setcc, and flipping
+			// the low bit of a condition code negates it
+			if (IR_REG_IS_IMMEDIATE(quad->lhs)
+				&& IR_REG_IS_IMMEDIATE(quad->rhs)
+				&& (l == 0 || l == 1) && l + r == 1) {
+				x86_mov_imm(text, x, 0);
+				x86_setcc(text, (l) ? cc : cc ^ 1, x);
+
+				writeback(isel, dst, x);
+				return 0;
+			}
+
+			// rhs goes in first for lhs to move over when the
+			// condition holds, so lhs cannot live where rhs goes
+			if (!IR_REG_IS_IMMEDIATE(quad->lhs)
+				&& reg(isel, quad->lhs) == dst) x = X86_RAX;
+
+			if (IR_REG_IS_IMMEDIATE(quad->rhs)) {
+				x86_mov_imm(text, x, r);
+			} else {
+				y = operand(isel, reg(isel, quad->rhs), x);
+				if (y != x) x86_mov(text, true, x, y);
+			}
+
+			x86_cmov(text, cc, x, source(isel, quad->lhs, X86_RCX));
+
+			writeback(isel, dst, x);
+			return 0;
+		}
+
+		case IR_QUAD_SPILL: {
+			ir_quad_spill_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_spill_t);
+
+			if (!regalloc) break;
+
+			dst = regalloc->registers + quad->slot;
+			lhs = reg(isel, quad->src);
+
+			if (dst >= isel->regs || lhs == UINT32_MAX) break;
+
+			writeback(isel, dst, operand(isel, lhs, X86_RAX));
+			return 0;
+		}
+
+		case IR_QUAD_STORE: {
+			ir_quad_store_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_store_t);
+
+			bool wide = quad->type == IR_REG_TYPE_PTR;
+
+			rhs = reg(isel, quad->dst);
+			imm = IR_REG_IMMEDIATE_VALUE(quad->src);
+
+			if (!readable(isel, quad->src) || rhs == UINT32_MAX)
+				break;
+
+			y = operand(isel, rhs, X86_RCX);
+
+			if (IR_REG_IS_IMMEDIATE(quad->src)
+				&& imm == (int32_t) imm) {
+				x86_store_imm(text, wide, y, 0, imm);
+				return 0;
+			}
+
+			x = source(isel, quad->src, X86_RAX);
+
+			x86_store(text, wide, y, 0, x);
+			return 0;
+		}
+
+		case IR_QUAD_VECTOR: {
+			ir_quad_vector_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_vector_t);
+
+			size_t chunks = quad->lanes / CODEGEN_SSE_LANES;
+
+			if (quad->type != IR_REG_TYPE_I32) break;
+			if (!chunks || quad->lanes % CODEGEN_SSE_LANES) break;
+			if (quad->lanes > IR_QUAD_VECTOR_LANES_MAX) break;
+			if (quad->op >= sizeof(vector_sse)
+				/ sizeof(*vector_sse)) break;
+			if (!vector_sse[quad->op]) break;
+
+			dst = reg(isel, quad->dst);
+			lhs = reg(isel, quad->lhs);
+			rhs = reg(isel, quad->rhs);
+
+			if (dst == UINT32_MAX) break;
+			if (lhs == UINT32_MAX || rhs == UINT32_MAX) break;
+
+			x = operand(isel, lhs, X86_RAX);
+			y = operand(isel, rhs, X86_RCX);
+
+			// every lane is loaded before any is stored
+			for (size_t i = 0; i < chunks; i++) {
+				x86_xmm_t l    = X86_XMM0 + 2 * i;
+				x86_xmm_t r    = X86_XMM1 + 2 * i;
+				int32_t   disp = i * CODEGEN_SSE_BYTES;
+
+				x86_load_xmm(text, l, x, disp);
+				x86_load_xmm(text, r, y, disp);
+				x86_sse(text, vector_sse[quad->op], l, r);
+			}
+
+			x = operand(isel, dst, X86_RDX);
+
+			for (size_t i = 0; i < chunks; i++)
+				x86_store_xmm(
+					text,
+					x,
+					i * CODEGEN_SSE_BYTES,
+					X86_XMM0 + 2 * i);
+			return 0;
+		}
+
+		default:
+			break;
+	}
+
+unsupported:
+	// malformed quads fault if they are ever reached
+	x86_ud2(text);
+
+	return 0;
+}
+
+static x86_reg_t source(isel_t *isel, uintptr_t src, x86_reg_t scratch)
+{
+	if (!IR_REG_IS_IMMEDIATE(src))
+		return operand(isel, reg(isel, src), scratch);
+
+	x86_mov_imm(
+		&isel->ir_codegen->text,
+		scratch,
+		IR_REG_IMMEDIATE_VALUE(src));
+
+	return scratch;
+}
+
+static int symbol_add(
+	ir_codegen_t        *ir_codegen,
+	ir_codegen_symbol_t *symbol,
+	size_t              *index)
+{
+	size_t pos = ir_codegen->symbol.use;
+	void  *val;
+
+	// references by name share one symbol, a definition wins
+	if (symbol->name && !ht_get(
+		&ir_codegen->lookup,
+		symbol->name,
+		strlen(symbol->name),
+		&val)) {
+		ir_codegen_symbol_t *sym = ir_codegen->symbol.buf;
+
+		pos = (uintptr_t) val;
+
+		if (sym[pos].section == IR_CODEGEN_SECTION_UNDEF)
+			sym[pos] = *symbol;
+
+		goto done;
+	}
+
+	if (vector_append(&ir_codegen->symbol, symbol)) return IR_ERROR_NOMEM;
+
+	if (symbol->name && ht_insert(
+		&ir_codegen->lookup,
+		symbol->name,
+		strlen(symbol->name),
+		(void*) pos)) return IR_ERROR_NOMEM;
+
+done:
+	if (index) *index = pos;
+
+	return 0;
+}
+
+static x86_reg_t target(const isel_t *isel, uint32_t index, x86_reg_t scratch)
+{
+	return (index < isel->physical) ? callee_saved[index] : scratch;
+}
+
+static void teardown(isel_t *isel)
+{
+	x86_t *text = &isel->ir_codegen->text;
+
+	if (isel->physical)
+		x86_lea(
+			text,
+			X86_RSP,
+			X86_RBP,
+			-(int32_t) (isel->physical * IR_CODEGEN_CELL));
+	else
+		x86_mov(text, true, X86_RSP, X86_RBP);
+
+	for (size_t i = isel->physical; i--;) x86_pop(text, callee_saved[i]);
+
+	x86_pop(text, X86_RBP);
+}
+
+static void writeback(isel_t *isel, uint32_t index, x86_reg_t src)
+{
+	x86_t *text = &isel->ir_codegen->text;
+
+	if (index >= isel->physical) {
+		x86_store(text, true, X86_RBP, disp(isel, index), src);
+		return;
+	}
+
+	if (callee_saved[index] != src)
+		x86_mov(text, true, callee_saved[index], src);
+}
@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * copy.c -- copy propagation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/copy.h>
+#include <jkcc/private/copy.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+int ir_copy_prop_function(ir_function_t *ir_function)
+{
+	size_t changed;
+
+	if (!ir_function->bb.use) return 0;
+
+	// a renamed base can make loads through it the same place, so
+	// propagate until nothing is left
+	do {
+		copy_t copy = {
+			.ir_function = ir_function,
+		};
+		int    ret;
+
+		ret = ir_cfg_init(&copy.ir_cfg, ir_function);
+		if (ret) return ret;
+
+		ret = ir_alias_init(&copy.ir_alias, ir_function);
+		if (ret) goto error_ir_alias_init;
+
+		ret = IR_ERROR_NOMEM;
+		if (vector_init(&copy.load, sizeof(ir_quad_t*), 0))
+			goto error_vector_init;
+
+		if (gather(&copy)) goto error_gather;
+
+		ret     = 0;
+		changed = 0;
+
+		size_t loads = copy.load.use;
+
+		if (loads > 1 && loads <= COPY_LOADS_MAX)
+			ret = propagate(&copy, &changed);
+
+error_gather:
+		vector_free(&copy.load);
+
+error_vector_init:
+		ir_alias_free(&copy.ir_alias);
+
+error_ir_alias_init:
+		ir_cfg_free(&copy.ir_cfg);
+
+		if (ret) return ret;
+	} while (changed);
+
+	return 0;
+}
+
+
+static void available(
+	copy_t          *copy,
+	const ir_quad_t *ir_quad,
+	bitset_t        *gen,
+	bitset_t        *kill)
+{
+	ir_quad_t     **load  = copy->load.buf;
+	size_t          loads = copy->load.use;
+	ir_quad_reg_t   reg;
+
+	IR_QUAD_REG((ir_quad_t*) ir_quad, &reg);
+
+	bool clobber = *ir_quad == IR_QUAD_STORE
+		|| *ir_quad == IR_QUAD_VECTOR
+		|| *ir_quad == IR_QUAD_CALL;
+
+	if (!clobber && !reg.def) return;
+
+	for (size_t i = 0; i < loads; i++) {
+		if (load[i] == ir_quad) {
+			mark(gen, kill, i, true);
+			continue;
+		}
+
+		const ir_quad_load_t *quad = OFFSETOF_IR_QUAD(
+			load[i],
+			ir_quad_load_t);
+
+		// the same name for another address
+		bool killed = reg.def && *reg.def == quad->src.reg;
+
+		if (!killed && clobber)
+			killed = ir_alias_query(
+				&copy->ir_alias,
+				ir_quad,
+				load[i]) != IR_ALIAS_NO;
+
+		if (killed) mark(gen, kill, i, false);
+	}
+}
+
+static void compact(ir_bb_t *ir_bb)
+{
+	ir_quad_t **quad = ir_bb->quad.buf;
+	size_t      kept = 0;
+
+	for (size_t i = 0; i < ir_bb->quad.use; i++)
+		if (quad[i]) quad[kept++] = quad[i];
+
+	ir_bb->quad.use = kept;
+}
+
+static int gather(copy_t *copy)
+{
+	ir_function_t *ir_function = copy->ir_function;
+	ir_bb_t      **ir_bb       = ir_function->bb.buf;
+	ir_alias_t    *alias       = &copy->ir_alias;
+
+	// every use of a copy is renamed, so only a load that is the one
+	// def of its vreg can stand for the value it read
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_LOAD) continue;
+
+			const ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_load_t);
+
+			if (load->src.type != IR_LOCATION_REG) continue;
+			if (load->dst >= alias->vregs) continue;
+			if (alias->def[load->dst] != quad[j]) continue;
+
+			if (vector_append(&copy->load, &quad[j])) return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void mark(bitset_t *gen, bitset_t *kill, size_t bit, bool set)
+{
+	if (set) BITSET_SET(gen, bit);
+	else BITSET_CLEAR(gen, bit);
+
+	if (!kill) return;
+
+	if (set) BITSET_CLEAR(kill, bit);
+	else BITSET_SET(kill, bit);
+}
+
+static int propagate(copy_t *copy, size_t *changed)
+{
+	ir_function_t *ir_function = copy->ir_function;
+	ir_bb_t      **ir_bb       = ir_function->bb.buf;
+	size_t         bbs         = copy->ir_cfg.bbs;
+	size_t         vregs       = copy->ir_alias.vregs;
+	ir_dataflow_t  dataflow;
+	bitset_t       avail;
+
+	// a load is available once every path to a point has been
+	// through it with nothing since that may have written over what
+	// it read, or moved its base
+	int ret = ir_dataflow_init(
+		&dataflow,
+		&copy->ir_cfg,
+		IR_DATAFLOW_FORWARD,
+		IR_DATAFLOW_INTERSECT,
+		copy->load.use);
+	if (ret) return ret;
+
+	ret = IR_ERROR_NOMEM;
+
+	uintptr_t *rename = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		(vregs + 1) * sizeof(*rename));
+	if (!rename) goto error_alloc_rename;
+
+	for (size_t i = 0; i <= vregs; i++) rename[i] = i;
+
+	if (bitset_init(&avail, copy->load.use)) goto error_bitset_init;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++)
+			available(
+				copy,
+				quad[j],
+				&dataflow.gen[i],
+				&dataflow.kill[i]);
+	}
+
+	ret = ir_dataflow_solve(&dataflow);
+	if (ret) goto error_ir_dataflow_solve;
+
+	// a load of what an available load already read is a copy of it
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		bitset_copy(&avail, &dataflow.in[i]);
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (redundant(copy, quad[j], &avail, rename)) {
+				++*changed;
+				continue;
+			}
+
+			available(copy, quad[j], &avail, NULL);
+		}
+	}
+
+	// copies stay in the load list until here, so are only freed once
+	// nothing is left to look at them
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			if (*quad[j] == IR_QUAD_LOAD
+				&& *reg.def < vregs
+				&& rename[*reg.def] != *reg.def) {
+				IR_QUAD_FREE(quad[j]);
+
+				quad[j] = NULL;
+				continue;
+			}
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+				if (*reg.use[k] >= vregs) continue;
+
+				uintptr_t to = *reg.use[k];
+
+				while (rename[to] != to) to = rename[to];
+
+				*reg.use[k] = to;
+			}
+		}
+
+		compact(ir_bb[i]);
+	}
+
+	ret = 0;
+
+error_ir_dataflow_solve:
+	bitset_free(&avail);
+
+error_bitset_init:
+	MEM_FREE(rename);
+
+error_alloc_rename:
+	ir_dataflow_free(&dataflow);
+
+	return ret;
+}
+
+static bool redundant(
+	copy_t          *copy,
+	const ir_quad_t *ir_quad,
+	const bitset_t  *avail,
+	uintptr_t       *rename)
+{
+	ir_quad_t **load  = copy->load.buf;
+	ir_alias_t *alias = &copy->ir_alias;
+
+	if (*ir_quad != IR_QUAD_LOAD) return false;
+
+	const ir_quad_load_t *quad = OFFSETOF_IR_QUAD(
+		ir_quad,
+		ir_quad_load_t);
+
+	if (quad->src.type != IR_LOCATION_REG) return false;
+
+	if (quad->dst >= alias->vregs || alias->def[quad->dst] != ir_quad)
+		return false;
+
+	for (size_t i = 0; i < copy->load.use; i++) {
+		if (!BITSET_TEST(avail, i)) continue;
+		if (load[i] == ir_quad) continue;
+
+		const ir_quad_load_t *earlier = OFFSETOF_IR_QUAD(
+			load[i],
+			ir_quad_load_t);
+
+		if (earlier->type != quad->type) continue;
+
+		if (ir_alias_query(alias, ir_quad, load[i]) != IR_ALIAS_MUST)
+			continue;
+
+		uintptr_t src = earlier->dst;
+
+		// through whatever it was itself a copy of
+		while (rename[src] != src) src = rename[src];
+
+		if (src == quad->dst) continue;
+
+		rename[quad->dst] = src;
+
+		return true;
+	}
+
+	return false;
+}
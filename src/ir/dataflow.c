@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dataflow.c -- bit-vector dataflow analysis
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/dataflow.h>
+#include <jkcc/private/dataflow.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+void ir_dataflow_free(ir_dataflow_t *ir_dataflow)
+{
+	if (!ir_dataflow) return;
+
+	if (ir_dataflow->gen) {
+		size_t sets = ir_dataflow->ir_cfg->bbs * 4;
+
+		for (size_t i = 0; i < sets; i++)
+			bitset_free(&ir_dataflow->gen[i]);
+	}
+
+	MEM_FREE(ir_dataflow->gen);
+
+	ir_dataflow->gen  = NULL;
+	ir_dataflow->kill = NULL;
+	ir_dataflow->in   = NULL;
+	ir_dataflow->out  = NULL;
+}
+
+int ir_dataflow_init(
+	ir_dataflow_t           *ir_dataflow,
+	const ir_cfg_t          *ir_cfg,
+	ir_dataflow_direction_t  direction,
+	ir_dataflow_meet_t       meet,
+	size_t                   bits)
+{
+	*ir_dataflow = (ir_dataflow_t) {
+		.ir_cfg    = ir_cfg,
+		.direction = direction,
+		.meet      = meet,
+		.bits      = bits,
+	};
+
+	size_t bbs = ir_cfg->bbs;
+
+	// kill, in and out share the allocation
+	ir_dataflow->gen = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_DATAFLOW,
+		bbs * 4 + 1,
+		sizeof(*ir_dataflow->gen));
+	if (!ir_dataflow->gen) return IR_ERROR_NOMEM;
+
+	ir_dataflow->kill = ir_dataflow->gen + bbs;
+	ir_dataflow->in   = ir_dataflow->kill + bbs;
+	ir_dataflow->out  = ir_dataflow->in + bbs;
+
+	for (size_t i = 0; i < bbs * 4; i++)
+		if (bitset_init(&ir_dataflow->gen[i], bits))
+			goto error_bitset_init;
+
+	return 0;
+
+error_bitset_init:
+	ir_dataflow_free(ir_dataflow);
+
+	return IR_ERROR_NOMEM;
+}
+
+int ir_dataflow_solve(ir_dataflow_t *ir_dataflow)
+{
+	const ir_cfg_t *ir_cfg = ir_dataflow->ir_cfg;
+	size_t          bbs    = ir_cfg->bbs;
+
+	bool forward = ir_dataflow->direction == IR_DATAFLOW_FORWARD;
+
+	bitset_t *input  = (forward) ? ir_dataflow->in  : ir_dataflow->out;
+	bitset_t *output = (forward) ? ir_dataflow->out : ir_dataflow->in;
+	vector_t *edge   = (forward) ? ir_cfg->pred     : ir_cfg->succ;
+	vector_t *next   = (forward) ? ir_cfg->succ     : ir_cfg->pred;
+
+	// an intersection starts from the top of the lattice
+	if (ir_dataflow->meet == IR_DATAFLOW_INTERSECT)
+		for (size_t i = 0; i < bbs; i++) bitset_fill(&output[i]);
+
+	bitset_t dirty;
+	if (bitset_init(&dirty, bbs)) return IR_ERROR_NOMEM;
+
+	for (size_t i = 0; i < bbs; i++) BITSET_SET(&dirty, i);
+
+	// sweep the worklist in rpo (or its reverse when
+	// solving backward) until no bb is left dirty
+	size_t pending = bbs;
+	while (pending) {
+		for (size_t i = 0; i < bbs; i++) {
+			if (!BITSET_TEST(&dirty, i)) continue;
+
+			BITSET_CLEAR(&dirty, i);
+			--pending;
+
+			size_t bb = (forward)
+				? ir_cfg->rpo[i]
+				: ir_cfg->rpo[bbs - 1 - i];
+
+			// nothing flows into the entry
+			if (forward && !bb) bitset_zero(&input[bb]);
+			else meet(ir_dataflow, &input[bb], &edge[bb], output);
+
+			++ir_dataflow->visits;
+
+			if (!bitset_transfer(
+				&output[bb],
+				&ir_dataflow->gen[bb],
+				&input[bb],
+				&ir_dataflow->kill[bb])) continue;
+
+			size_t *succ = next[bb].buf;
+			for (size_t j = 0; j < next[bb].use; j++) {
+				size_t pos = ir_cfg->rpo_index[succ[j]];
+
+				if (!forward) pos = bbs - 1 - pos;
+
+				if (BITSET_TEST(&dirty, pos)) continue;
+
+				BITSET_SET(&dirty, pos);
+				++pending;
+			}
+		}
+	}
+
+	bitset_free(&dirty);
+
+	return 0;
+}
+
+
+static void meet(
+	ir_dataflow_t  *ir_dataflow,
+	bitset_t       *dst,
+	const vector_t *edge,
+	const bitset_t *src)
+{
+	size_t *bb = edge->buf;
+
+	if (!edge->use) {
+		bitset_zero(dst);
+		return;
+	}
+
+	bitset_copy(dst, &src[bb[0]]);
+
+	for (size_t i = 1; i < edge->use; i++) {
+		if (ir_dataflow->meet == IR_DATAFLOW_UNION)
+			bitset_union(dst, &src[bb[i]]);
+		else
+			bitset_intersect(dst, &src[bb[i]]);
+	}
+}
@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dce.c -- dead quad elimination
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/dce.h>
+#include <jkcc/private/dce.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+
+
+int ir_dce_function(ir_function_t *ir_function)
+{
+	size_t removed;
+
+	// a removed use can kill a def in a predecessor
+	do {
+		ir_cfg_t      ir_cfg;
+		ir_liveness_t ir_liveness;
+		bitset_t      live;
+		int           ret;
+
+		ret = ir_cfg_init(&ir_cfg, ir_function);
+		if (ret) return ret;
+
+		ret = ir_liveness_init(&ir_liveness, &ir_cfg);
+		if (ret) goto error_ir_liveness_init;
+
+		ret = IR_ERROR_NOMEM;
+		if (bitset_init(&live, ir_liveness.vregs))
+			goto error_bitset_init;
+
+		ir_bb_t **ir_bb = ir_function->bb.buf;
+
+		removed = 0;
+		for (size_t i = 0; i < ir_cfg.bbs; i++) {
+			bitset_copy(&live, &ir_liveness.dataflow.out[i]);
+
+			removed += sweep(ir_bb[i], &live);
+		}
+
+		ret = 0;
+
+		bitset_free(&live);
+
+error_bitset_init:
+		ir_liveness_free(&ir_liveness);
+
+error_ir_liveness_init:
+		ir_cfg_free(&ir_cfg);
+
+		if (ret) return ret;
+	} while (removed);
+
+	return 0;
+}
+
+int ir_dce_unit(ir_unit_t *ir_unit)
+{
+	ir_callgraph_t ir_callgraph;
+	ht_t           referenced;  // static declarations still loaded
+
+	int ret = ir_callgraph_init(&ir_callgraph, ir_unit);
+	if (ret) return ret;
+
+	ret = IR_ERROR_NOMEM;
+	if (ht_init(&referenced, 0)) goto error_ht_init;
+
+	size_t functions = ir_callgraph.functions;
+
+	// the stack and the marks share the allocation
+	size_t *stack = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		(functions * 2 + 1) * sizeof(*stack));
+	if (!stack) goto error_alloc_stack;
+
+	size_t *reached = stack + functions;
+	size_t  depth   = 0;
+
+	ir_function_t **ir_function = ir_unit->function.buf;
+
+	// anything visible outside the unit could be called from there
+	for (size_t i = 0; i < functions; i++) {
+		reached[i] = strcmp(
+			ir_function_linkage_str(ir_function[i]),
+			"internal") != 0;
+
+		if (reached[i]) stack[depth++] = i;
+	}
+
+	while (depth) {
+		size_t  caller = stack[--depth];
+		size_t *callee = ir_callgraph.callee[caller].buf;
+
+		for (size_t i = 0; i < ir_callgraph.callee[caller].use; i++) {
+			if (reached[callee[i]]) continue;
+
+			reached[callee[i]] = true;
+			stack[depth++]     = callee[i];
+		}
+	}
+
+	for (size_t i = 0; i < functions; i++)
+		if (reached[i] && reference(ir_function[i], &referenced))
+			goto error;
+
+	size_t kept = 0;
+
+	for (size_t i = 0; i < functions; i++) {
+		if (reached[i]) {
+			ir_function[kept++] = ir_function[i];
+			continue;
+		}
+
+		ir_function_free(ir_function[i]);
+	}
+
+	ir_unit->function.use = kept;
+
+	ir_static_declaration_t **ir_static_declaration
+		= ir_unit->static_declaration.buf;
+
+	kept = 0;
+
+	for (size_t i = 0; i < ir_unit->static_declaration.use; i++) {
+		ir_static_declaration_t *declaration
+			= ir_static_declaration[i];
+
+		if (ht_exists(&referenced, &declaration, sizeof(declaration))) {
+			ir_static_declaration[kept++] = declaration;
+			continue;
+		}
+
+		MEM_FREE(declaration);
+	}
+
+	ir_unit->static_declaration.use = kept;
+
+	ret = 0;
+
+error:
+	MEM_FREE(stack);
+
+error_alloc_stack:
+	ht_free(&referenced, NULL);
+
+error_ht_init:
+	ir_callgraph_free(&ir_callgraph);
+
+	return ret;
+}
+
+
+static int reference(ir_function_t *ir_function, ht_t *referenced)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_location_t *src;
+
+			switch (*quad[j]) {
+				case IR_QUAD_CALL:
+					src = &OFFSETOF_IR_QUAD(
+						quad[j],
+						ir_quad_call_t)->src;
+					break;
+
+				case IR_QUAD_LOAD:
+					src = &OFFSETOF_IR_QUAD(
+						quad[j],
+						ir_quad_load_t)->src;
+					break;
+
+				default:
+					continue;
+			}
+
+			if (src->type != IR_LOCATION_STATIC_DECLARATION)
+				continue;
+
+			const void *key  = &src->static_declaration;
+			size_t      size = sizeof(src->static_declaration);
+
+			if (ht_exists(referenced, key, size)) continue;
+
+			if (ht_insert(referenced, key, size, NULL)) return -1;
+		}
+	}
+
+	return 0;
+}
+
+static bool removable(const ir_quad_t *ir_quad)
+{
+	ir_quad_binop_op_t op;
+
+	switch (*ir_quad) {
+		case IR_QUAD_ALLOCA:
+		case IR_QUAD_LOAD:
+		case IR_QUAD_MOV:
+		case IR_QUAD_SELECT:
+			return true;
+
+		// a division by zero still has to trap
+		case IR_QUAD_BINOP:
+			op = OFFSETOF_IR_QUAD(ir_quad, ir_quad_binop_t)->op;
+
+			return op != IR_QUAD_BINOP_DIV
+				&& op != IR_QUAD_BINOP_MOD;
+
+		// calls, stores, and control flow are kept for their effects
+		default:
+			return false;
+	}
+}
+
+static size_t sweep(ir_bb_t *ir_bb, bitset_t *live)
+{
+	ir_quad_t **quad    = ir_bb->quad.buf;
+	size_t      removed = 0;
+
+	for (size_t i = ir_bb->quad.use; i--;) {
+		ir_quad_reg_t reg;
+
+		IR_QUAD_REG(quad[i], &reg);
+
+		if (reg.def && !BITSET_TEST(live, *reg.def)
+			&& removable(quad[i])) {
+			IR_QUAD_FREE(quad[i]);
+
+			quad[i] = NULL;
+			++removed;
+			continue;
+		}
+
+		if (reg.def) BITSET_CLEAR(live, *reg.def);
+
+		for (size_t j = 0; j < IR_QUAD_REG_USES; j++)
+			if (reg.use[j]) BITSET_SET(live, *reg.use[j]);
+	}
+
+	size_t kept = 0;
+
+	for (size_t i = 0; i < ir_bb->quad.use; i++)
+		if (quad[i]) quad[kept++] = quad[i];
+
+	ir_bb->quad.use = kept;
+
+	return removed;
+}
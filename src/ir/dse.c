@@ -0,0 +1,511 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dse.c -- dead store elimination
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/dse.h>
+#include <jkcc/private/dse.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+int ir_dse_function(ir_function_t *ir_function)
+{
+	size_t changed;
+
+	if (!ir_function->bb.use) return 0;
+
+	// a forwarded value can be stored and loaded again, so forward
+	// until nothing is left, then sweep out what no load reads
+	do {
+		dse_t dse = {
+			.ir_function = ir_function,
+		};
+		int   ret;
+
+		ret = ir_cfg_init(&dse.ir_cfg, ir_function);
+		if (ret) return ret;
+
+		ret = ir_alias_init(&dse.ir_alias, ir_function);
+		if (ret) goto error_ir_alias_init;
+
+		ret = IR_ERROR_NOMEM;
+		if (vector_init(&dse.store, sizeof(dse_store_t), 0))
+			goto error_vector_init;
+
+		if (gather(&dse)) goto error_gather;
+
+		ret     = 0;
+		changed = 0;
+
+		size_t stores = dse.store.use;
+
+		if (stores && stores <= DSE_STORES_MAX) {
+			ret = forward(&dse, &changed);
+
+			if (!ret && !changed) ret = dead(&dse);
+		}
+
+error_gather:
+		vector_free(&dse.store);
+
+error_vector_init:
+		ir_alias_free(&dse.ir_alias);
+
+error_ir_alias_init:
+		ir_cfg_free(&dse.ir_cfg);
+
+		if (ret) return ret;
+	} while (changed);
+
+	return 0;
+}
+
+
+static void available(
+	dse_t           *dse,
+	const ir_quad_t *ir_quad,
+	bitset_t        *gen,
+	bitset_t        *kill)
+{
+	const dse_store_t *store  = dse->store.buf;
+	size_t             stores = dse->store.use;
+	ir_quad_reg_t      reg;
+
+	IR_QUAD_REG((ir_quad_t*) ir_quad, &reg);
+
+	bool clobber = *ir_quad == IR_QUAD_STORE
+		|| *ir_quad == IR_QUAD_VECTOR
+		|| *ir_quad == IR_QUAD_CALL;
+
+	if (!clobber && !reg.def) return;
+
+	for (size_t i = 0; i < stores; i++) {
+		if (store[i].quad == ir_quad) {
+			mark(gen, kill, i, true);
+			continue;
+		}
+
+		const ir_quad_store_t *quad = OFFSETOF_IR_QUAD(
+			store[i].quad,
+			ir_quad_store_t);
+
+		// a new value, or the same name for another address
+		bool killed = reg.def && (*reg.def == quad->src
+			|| *reg.def == quad->dst
+			|| *reg.def == store[i].pointer);
+
+		if (!killed && clobber)
+			killed = ir_alias_query(
+				&dse->ir_alias,
+				ir_quad,
+				store[i].quad) != IR_ALIAS_NO;
+
+		if (killed) mark(gen, kill, i, false);
+	}
+}
+
+static void compact(ir_bb_t *ir_bb)
+{
+	ir_quad_t **quad = ir_bb->quad.buf;
+	size_t      kept = 0;
+
+	for (size_t i = 0; i < ir_bb->quad.use; i++)
+		if (quad[i]) quad[kept++] = quad[i];
+
+	ir_bb->quad.use = kept;
+}
+
+static int dead(dse_t *dse)
+{
+	ir_function_t *ir_function = dse->ir_function;
+	ir_bb_t      **ir_bb       = ir_function->bb.buf;
+	dse_store_t   *store       = dse->store.buf;
+	size_t         bbs         = dse->ir_cfg.bbs;
+	ir_dataflow_t  dataflow;
+	bitset_t       over;
+
+	// a store is dead once every path from it overwrites the same
+	// place, or returns from a cell nothing else can see, before
+	// anything may read it
+	int ret = ir_dataflow_init(
+		&dataflow,
+		&dse->ir_cfg,
+		IR_DATAFLOW_BACKWARD,
+		IR_DATAFLOW_INTERSECT,
+		dse->store.use);
+	if (ret) return ret;
+
+	ret = IR_ERROR_NOMEM;
+	if (bitset_init(&over, dse->store.use)) goto error_bitset_init;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = ir_bb[i]->quad.use; j--;)
+			overwritten(
+				dse,
+				quad[j],
+				&dataflow.gen[i],
+				&dataflow.kill[i]);
+	}
+
+	ret = ir_dataflow_solve(&dataflow);
+	if (ret) goto error_ir_dataflow_solve;
+
+	size_t k = dse->store.use;
+
+	for (size_t i = bbs; i--;) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		bitset_copy(&over, &dataflow.out[i]);
+
+		for (size_t j = ir_bb[i]->quad.use; j--;) {
+			bool remove = false;
+
+			if (*quad[j] == IR_QUAD_STORE) {
+				--k;
+				remove = BITSET_TEST(&over, k);
+			}
+
+			overwritten(dse, quad[j], &over, NULL);
+
+			if (!remove) continue;
+
+			store[k].dead = true;
+
+			quad[j] = NULL;
+		}
+
+		compact(ir_bb[i]);
+	}
+
+	// stores still answer for themselves until every bb is through
+	for (size_t i = 0; i < dse->store.use; i++)
+		if (store[i].dead) IR_QUAD_FREE(store[i].quad);
+
+error_ir_dataflow_solve:
+	bitset_free(&over);
+
+error_bitset_init:
+	ir_dataflow_free(&dataflow);
+
+	return ret;
+}
+
+static int forward(dse_t *dse, size_t *changed)
+{
+	ir_function_t *ir_function = dse->ir_function;
+	ir_bb_t      **ir_bb       = ir_function->bb.buf;
+	size_t         bbs         = dse->ir_cfg.bbs;
+	size_t         vregs       = dse->ir_alias.vregs;
+	ir_dataflow_t  dataflow;
+	bitset_t       avail;
+	bitset_t       pinned;
+
+	// a store is available once every path to a point has been
+	// through it with nothing since that may have written over it
+	int ret = ir_dataflow_init(
+		&dataflow,
+		&dse->ir_cfg,
+		IR_DATAFLOW_FORWARD,
+		IR_DATAFLOW_INTERSECT,
+		dse->store.use);
+	if (ret) return ret;
+
+	ret = IR_ERROR_NOMEM;
+
+	uintptr_t *rename = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		(vregs + 1) * sizeof(*rename));
+	if (!rename) goto error_alloc_rename;
+
+	for (size_t i = 0; i <= vregs; i++) rename[i] = i;
+
+	if (bitset_init(&avail, dse->store.use)) goto error_bitset_init;
+
+	if (pin(dse, &pinned)) goto error_pin;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++)
+			available(
+				dse,
+				quad[j],
+				&dataflow.gen[i],
+				&dataflow.kill[i]);
+	}
+
+	ret = ir_dataflow_solve(&dataflow);
+	if (ret) goto error_ir_dataflow_solve;
+
+	// a load of what an available store wrote is its value
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		bitset_copy(&avail, &dataflow.in[i]);
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			bool remove = forwardable(
+				dse,
+				quad[j],
+				&avail,
+				&pinned,
+				rename);
+
+			available(dse, quad[j], &avail, NULL);
+
+			if (!remove) continue;
+
+			IR_QUAD_FREE(quad[j]);
+
+			quad[j] = NULL;
+			++*changed;
+		}
+	}
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			if (!quad[j]) continue;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+				if (*reg.use[k] > vregs) continue;
+
+				uintptr_t to = *reg.use[k];
+
+				while (to <= vregs && rename[to] != to)
+					to = rename[to];
+
+				*reg.use[k] = to;
+			}
+		}
+
+		compact(ir_bb[i]);
+	}
+
+	ret = 0;
+
+error_ir_dataflow_solve:
+	bitset_free(&pinned);
+
+error_pin:
+	bitset_free(&avail);
+
+error_bitset_init:
+	MEM_FREE(rename);
+
+error_alloc_rename:
+	ir_dataflow_free(&dataflow);
+
+	return ret;
+}
+
+static bool forwardable(
+	dse_t           *dse,
+	const ir_quad_t *ir_quad,
+	const bitset_t  *avail,
+	bitset_t        *pinned,
+	uintptr_t       *rename)
+{
+	const dse_store_t *store  = dse->store.buf;
+	ir_alias_t        *alias  = &dse->ir_alias;
+
+	if (*ir_quad != IR_QUAD_LOAD) return false;
+
+	const ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+		ir_quad,
+		ir_quad_load_t);
+
+	if (load->src.type != IR_LOCATION_REG) return false;
+
+	// every use of the load is renamed, so it has to be the only def
+	if (load->dst >= alias->vregs || alias->def[load->dst] != ir_quad)
+		return false;
+
+	for (size_t i = 0; i < dse->store.use; i++) {
+		if (!BITSET_TEST(avail, i)) continue;
+
+		const ir_quad_store_t *quad = OFFSETOF_IR_QUAD(
+			store[i].quad,
+			ir_quad_store_t);
+
+		uintptr_t src = quad->src;
+
+		// through whatever it was itself forwarded from
+		while (src < alias->vregs && rename[src] != src)
+			src = rename[src];
+
+		bool immediate = IR_REG_IS_IMMEDIATE(src);
+
+		if (quad->type != load->type) continue;
+		if (immediate && BITSET_TEST(pinned, load->dst)) continue;
+		if (!immediate && (src >= alias->vregs || !alias->def[src]))
+			continue;
+
+		if (ir_alias_query(alias, ir_quad, store[i].quad)
+			!= IR_ALIAS_MUST) continue;
+
+		// every use of the load now reads src instead
+		if (!immediate && BITSET_TEST(pinned, load->dst))
+			BITSET_SET(pinned, src);
+
+		rename[load->dst] = src;
+
+		return true;
+	}
+
+	return false;
+}
+
+static int gather(dse_t *dse)
+{
+	ir_function_t *ir_function = dse->ir_function;
+	ir_bb_t      **ir_bb       = ir_function->bb.buf;
+	ir_alias_t    *alias       = &dse->ir_alias;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_STORE) continue;
+
+			uintptr_t dst = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_store_t)->dst;
+
+			const ir_alias_address_t *address = &alias->address[
+				(dst < alias->vregs) ? dst : alias->vregs];
+
+			dse_store_t dse_store = {
+				.quad    = quad[j],
+				.pointer = UINTPTR_MAX,
+				.local   = address->base == IR_ALIAS_BASE_CELL
+					&& !BITSET_TEST(
+						&alias->escaped,
+						address->object),
+			};
+
+			if (address->base == IR_ALIAS_BASE_POINTER)
+				dse_store.pointer = address->object;
+
+			if (vector_append(&dse->store, &dse_store)) return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void mark(bitset_t *gen, bitset_t *kill, size_t bit, bool set)
+{
+	if (set) BITSET_SET(gen, bit);
+	else BITSET_CLEAR(gen, bit);
+
+	if (!kill) return;
+
+	if (set) BITSET_CLEAR(kill, bit);
+	else BITSET_SET(kill, bit);
+}
+
+static void overwritten(
+	dse_t           *dse,
+	const ir_quad_t *ir_quad,
+	bitset_t        *gen,
+	bitset_t        *kill)
+{
+	const dse_store_t *store  = dse->store.buf;
+	size_t             stores = dse->store.use;
+	ir_quad_reg_t      reg;
+
+	IR_QUAD_REG((ir_quad_t*) ir_quad, &reg);
+
+	bool read = *ir_quad == IR_QUAD_VECTOR || *ir_quad == IR_QUAD_CALL;
+
+	if (*ir_quad == IR_QUAD_LOAD)
+		read = OFFSETOF_IR_QUAD(
+			ir_quad,
+			ir_quad_load_t)->src.type == IR_LOCATION_REG;
+
+	bool write = *ir_quad == IR_QUAD_STORE;
+	bool exit  = *ir_quad == IR_QUAD_RET;
+
+	if (!read && !write && !exit && !reg.def) return;
+
+	for (size_t i = 0; i < stores; i++) {
+		if (exit) {
+			if (store[i].local) mark(gen, kill, i, true);
+			continue;
+		}
+
+		const ir_quad_store_t *quad = OFFSETOF_IR_QUAD(
+			store[i].quad,
+			ir_quad_store_t);
+
+		// what comes after may write somewhere else by the same name
+		if (reg.def && (*reg.def == quad->dst
+			|| *reg.def == store[i].pointer)) {
+			mark(gen, kill, i, false);
+			continue;
+		}
+
+		if (read && ir_alias_query(
+			&dse->ir_alias,
+			ir_quad,
+			store[i].quad) != IR_ALIAS_NO) {
+			mark(gen, kill, i, false);
+			continue;
+		}
+
+		if (write && ir_alias_query(
+			&dse->ir_alias,
+			ir_quad,
+			store[i].quad) == IR_ALIAS_MUST)
+			mark(gen, kill, i, true);
+	}
+}
+
+static int pin(dse_t *dse, bitset_t *pinned)
+{
+	ir_function_t  *ir_function = dse->ir_function;
+	ir_bb_t       **ir_bb       = ir_function->bb.buf;
+	size_t          vregs       = dse->ir_alias.vregs;
+
+	if (bitset_init(pinned, vregs)) return -1;
+
+	// a register read where no immediate can stand in stays one
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+				if (*reg.use[k] >= vregs) continue;
+				if (reg.immediate & (1U << k)) continue;
+
+				BITSET_SET(pinned, *reg.use[k]);
+			}
+		}
+	}
+
+	return 0;
+}
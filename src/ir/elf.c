@@ -0,0 +1,407 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * elf.c -- elf64 relocatable object writer
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/elf.h>
+#include <jkcc/private/elf.h>
+
+#include <elf.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/string.h>
+#include <jkcc/vector.h>
+
+
+static const char *const section_name[ELF_SECTIONS_TOTAL] = {
+	[ELF_SECTION_NULL]           = "",
+	[ELF_SECTION_TEXT]           = ".text",
+	[ELF_SECTION_DATA]           = ".data",
+	[ELF_SECTION_BSS]            = ".bss",
+	[ELF_SECTION_RODATA]         = ".rodata",
+	[ELF_SECTION_RELA_TEXT]      = ".rela.text",
+	[ELF_SECTION_SYMTAB]         = ".symtab",
+	[ELF_SECTION_STRTAB]         = ".strtab",
+	[ELF_SECTION_SHSTRTAB]       = ".shstrtab",
+	[ELF_SECTION_NOTE_GNU_STACK] = ".note.GNU-stack",
+};
+
+static const Elf64_Section section_index[IR_CODEGEN_SECTIONS_TOTAL] = {
+	[IR_CODEGEN_SECTION_UNDEF]  = SHN_UNDEF,
+	[IR_CODEGEN_SECTION_TEXT]   = ELF_SECTION_TEXT,
+	[IR_CODEGEN_SECTION_RODATA] = ELF_SECTION_RODATA,
+	[IR_CODEGEN_SECTION_BSS]    = ELF_SECTION_BSS,
+};
+
+static const Elf64_Word reloc_type[] = {
+	[IR_CODEGEN_RELOC_PC32]  = R_X86_64_PC32,
+	[IR_CODEGEN_RELOC_PLT32] = R_X86_64_PLT32,
+};
+
+
+int ir_elf_write(FILE *stream, ir_codegen_t *ir_codegen, const char *file)
+{
+	ir_codegen_symbol_t *symbol  = ir_codegen->symbol.buf;
+	ir_codegen_reloc_t  *reloc   = ir_codegen->reloc.buf;
+	size_t               symbols = ir_codegen->symbol.use;
+	size_t               relocs  = ir_codegen->reloc.use;
+
+	Elf64_Shdr section[ELF_SECTIONS_TOTAL] = {0};
+	Elf64_Word section_symbol[IR_CODEGEN_SECTIONS_TOTAL] = {0};
+
+	string_t  strtab   = {0};
+	string_t  shstrtab = {0};
+	vector_t  symtab   = {0};
+	size_t   *index    = NULL;
+	int       ret      = IR_ERROR_NOMEM;
+
+	if (string_init(&strtab, 0)) goto error;
+	if (string_init(&shstrtab, 0)) goto error;
+	if (vector_init(&symtab, sizeof(Elf64_Sym), 0)) goto error;
+
+	// symtab position of each codegen symbol
+	index = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_ELF,
+		symbols + 1,
+		sizeof(*index));
+	if (!index) goto error;
+
+	// only imports something actually refers to are worth naming
+	for (size_t i = 0; i < relocs; i++) index[reloc[i].symbol] = SIZE_MAX;
+
+	Elf64_Sym entry = {0};
+
+	if (strtab_add(&strtab, "", &entry.st_name)) goto error;
+	if (vector_append(&symtab, &entry)) goto error;
+
+	if (file) {
+		const char *base = strrchr(file, '/');
+
+		entry = (Elf64_Sym) {
+			.st_info  = ELF64_ST_INFO(STB_LOCAL, STT_FILE),
+			.st_shndx = SHN_ABS,
+		};
+
+		if (strtab_add(
+			&strtab,
+			(base) ? base + 1 : file,
+			&entry.st_name)) goto error;
+
+		if (vector_append(&symtab, &entry)) goto error;
+	}
+
+	// statics and literals are reached through their section
+	for (size_t i = 1; i < IR_CODEGEN_SECTIONS_TOTAL; i++) {
+		entry = (Elf64_Sym) {
+			.st_info  = ELF64_ST_INFO(STB_LOCAL, STT_SECTION),
+			.st_shndx = section_index[i],
+		};
+
+		section_symbol[i] = symtab.use;
+
+		if (vector_append(&symtab, &entry)) goto error;
+	}
+
+	// every local has to precede the first global
+	for (size_t pass = 0; pass < 2; pass++) {
+		for (size_t i = 0; i < symbols; i++) {
+			bool undef = symbol[i].section
+				== IR_CODEGEN_SECTION_UNDEF;
+			bool local = !symbol[i].global && !undef;
+
+			if (!symbol[i].name || local != !pass) continue;
+
+			if (undef && index[i] != SIZE_MAX) continue;
+
+			unsigned char type = STT_OBJECT;
+
+			if (undef) type = STT_NOTYPE;
+			if (symbol[i].section == IR_CODEGEN_SECTION_TEXT)
+				type = STT_FUNC;
+
+			entry = (Elf64_Sym) {
+				.st_info  = ELF64_ST_INFO(
+					(local) ? STB_LOCAL : STB_GLOBAL,
+					type),
+				.st_shndx = section_index[symbol[i].section],
+				.st_value = symbol[i].offset,
+				.st_size  = symbol[i].size,
+			};
+
+			if (strtab_add(
+				&strtab,
+				symbol[i].name,
+				&entry.st_name)) goto error;
+
+			index[i] = symtab.use;
+
+			if (vector_append(&symtab, &entry)) goto error;
+		}
+
+		if (!pass) section[ELF_SECTION_SYMTAB].sh_info = symtab.use;
+	}
+
+	for (size_t i = 0; i < ELF_SECTIONS_TOTAL; i++)
+		if (strtab_add(
+			&shstrtab,
+			section_name[i],
+			&section[i].sh_name)) goto error;
+
+	size_t strtab_size   = strtab.tail - strtab.head;
+	size_t shstrtab_size = shstrtab.tail - shstrtab.head;
+
+	section[ELF_SECTION_TEXT] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_TEXT].sh_name,
+		.sh_type      = SHT_PROGBITS,
+		.sh_flags     = SHF_ALLOC | SHF_EXECINSTR,
+		.sh_size      = ir_codegen->text.use,
+		.sh_addralign = 16,
+	};
+
+	// nothing in the ir carries an initializer yet
+	section[ELF_SECTION_DATA] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_DATA].sh_name,
+		.sh_type      = SHT_PROGBITS,
+		.sh_flags     = SHF_ALLOC | SHF_WRITE,
+		.sh_addralign = IR_CODEGEN_CELL,
+	};
+
+	section[ELF_SECTION_BSS] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_BSS].sh_name,
+		.sh_type      = SHT_NOBITS,
+		.sh_flags     = SHF_ALLOC | SHF_WRITE,
+		.sh_size      = ir_codegen->bss_size,
+		.sh_addralign = IR_CODEGEN_CELL,
+	};
+
+	section[ELF_SECTION_RODATA] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_RODATA].sh_name,
+		.sh_type      = SHT_PROGBITS,
+		.sh_flags     = SHF_ALLOC,
+		.sh_size      = ir_codegen->rodata_size,
+		.sh_addralign = IR_CODEGEN_CELL,
+	};
+
+	section[ELF_SECTION_RELA_TEXT] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_RELA_TEXT].sh_name,
+		.sh_type      = SHT_RELA,
+		.sh_flags     = SHF_INFO_LINK,
+		.sh_size      = relocs * sizeof(Elf64_Rela),
+		.sh_link      = ELF_SECTION_SYMTAB,
+		.sh_info      = ELF_SECTION_TEXT,
+		.sh_addralign = 8,
+		.sh_entsize   = sizeof(Elf64_Rela),
+	};
+
+	section[ELF_SECTION_SYMTAB] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_SYMTAB].sh_name,
+		.sh_type      = SHT_SYMTAB,
+		.sh_size      = symtab.use * sizeof(Elf64_Sym),
+		.sh_link      = ELF_SECTION_STRTAB,
+		.sh_info      = section[ELF_SECTION_SYMTAB].sh_info,
+		.sh_addralign = 8,
+		.sh_entsize   = sizeof(Elf64_Sym),
+	};
+
+	section[ELF_SECTION_STRTAB] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_STRTAB].sh_name,
+		.sh_type      = SHT_STRTAB,
+		.sh_size      = strtab_size,
+		.sh_addralign = 1,
+	};
+
+	section[ELF_SECTION_SHSTRTAB] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_SHSTRTAB].sh_name,
+		.sh_type      = SHT_STRTAB,
+		.sh_size      = shstrtab_size,
+		.sh_addralign = 1,
+	};
+
+	// without it the linker assumes an executable stack
+	section[ELF_SECTION_NOTE_GNU_STACK] = (Elf64_Shdr) {
+		.sh_name      = section[ELF_SECTION_NOTE_GNU_STACK].sh_name,
+		.sh_type      = SHT_PROGBITS,
+		.sh_addralign = 1,
+	};
+
+	// the stream may be a pipe, so every offset is known up front
+	size_t offset = sizeof(Elf64_Ehdr);
+
+	for (size_t i = ELF_SECTION_TEXT; i < ELF_SECTIONS_TOTAL; i++) {
+		size_t alignment = section[i].sh_addralign;
+
+		offset += alignment - 1;
+		offset -= offset % alignment;
+
+		section[i].sh_offset = offset;
+
+		if (section[i].sh_type != SHT_NOBITS)
+			offset += section[i].sh_size;
+	}
+
+	offset += 8 - 1;
+	offset -= offset % 8;
+
+	elf_t elf = {
+		.stream = stream,
+	};
+
+	ehdr(&elf, &(Elf64_Ehdr) {
+		.e_ident = {
+			[EI_MAG0]    = ELFMAG0,
+			[EI_MAG1]    = ELFMAG1,
+			[EI_MAG2]    = ELFMAG2,
+			[EI_MAG3]    = ELFMAG3,
+			[EI_CLASS]   = ELFCLASS64,
+			[EI_DATA]    = ELFDATA2LSB,
+			[EI_VERSION] = EV_CURRENT,
+			[EI_OSABI]   = ELFOSABI_SYSV,
+		},
+		.e_type      = ET_REL,
+		.e_machine   = EM_X86_64,
+		.e_version   = EV_CURRENT,
+		.e_shoff     = offset,
+		.e_ehsize    = sizeof(Elf64_Ehdr),
+		.e_shentsize = sizeof(Elf64_Shdr),
+		.e_shnum     = ELF_SECTIONS_TOTAL,
+		.e_shstrndx  = ELF_SECTION_SHSTRTAB,
+	});
+
+	align(&elf, section[ELF_SECTION_TEXT].sh_addralign);
+	bytes(&elf, ir_codegen->text.buf, ir_codegen->text.use);
+
+	align(&elf, section[ELF_SECTION_RODATA].sh_addralign);
+	bytes(&elf, ir_codegen->rodata, ir_codegen->rodata_size);
+
+	align(&elf, section[ELF_SECTION_RELA_TEXT].sh_addralign);
+	for (size_t i = 0; i < relocs; i++) {
+		size_t     target = reloc[i].symbol;
+		Elf64_Word info   = index[target];
+		int64_t    addend = reloc[i].addend;
+
+		if (!symbol[target].name) {
+			info    = section_symbol[symbol[target].section];
+			addend += symbol[target].offset;
+		}
+
+		rela(&elf, &(Elf64_Rela) {
+			.r_offset = reloc[i].offset,
+			.r_info   = ELF64_R_INFO(
+				info,
+				reloc_type[reloc[i].type]),
+			.r_addend = addend,
+		});
+	}
+
+	align(&elf, section[ELF_SECTION_SYMTAB].sh_addralign);
+	Elf64_Sym *symtab_entry = symtab.buf;
+	for (size_t i = 0; i < symtab.use; i++) sym(&elf, &symtab_entry[i]);
+
+	bytes(&elf, strtab.head, strtab_size);
+	bytes(&elf, shstrtab.head, shstrtab_size);
+
+	align(&elf, 8);
+	for (size_t i = 0; i < ELF_SECTIONS_TOTAL; i++)
+		shdr(&elf, &section[i]);
+
+	ret = (ferror(stream)) ? IR_ERROR_WRITE : 0;
+
+error:
+	MEM_FREE(index);
+	vector_free(&symtab);
+	string_free(&shstrtab);
+	string_free(&strtab);
+
+	return ret;
+}
+
+
+static void align(elf_t *elf, size_t alignment)
+{
+	while (elf->pos % alignment) le(elf, 0, 1);
+}
+
+static void bytes(elf_t *elf, const void *buf, size_t size)
+{
+	fwrite(buf, 1, size, elf->stream);
+
+	elf->pos += size;
+}
+
+static void ehdr(elf_t *elf, const Elf64_Ehdr *ehdr)
+{
+	bytes(elf, ehdr->e_ident, sizeof(ehdr->e_ident));
+
+	le(elf, ehdr->e_type, sizeof(ehdr->e_type));
+	le(elf, ehdr->e_machine, sizeof(ehdr->e_machine));
+	le(elf, ehdr->e_version, sizeof(ehdr->e_version));
+	le(elf, ehdr->e_entry, sizeof(ehdr->e_entry));
+	le(elf, ehdr->e_phoff, sizeof(ehdr->e_phoff));
+	le(elf, ehdr->e_shoff, sizeof(ehdr->e_shoff));
+	le(elf, ehdr->e_flags, sizeof(ehdr->e_flags));
+	le(elf, ehdr->e_ehsize, sizeof(ehdr->e_ehsize));
+	le(elf, ehdr->e_phentsize, sizeof(ehdr->e_phentsize));
+	le(elf, ehdr->e_phnum, sizeof(ehdr->e_phnum));
+	le(elf, ehdr->e_shentsize, sizeof(ehdr->e_shentsize));
+	le(elf, ehdr->e_shnum, sizeof(ehdr->e_shnum));
+	le(elf, ehdr->e_shstrndx, sizeof(ehdr->e_shstrndx));
+}
+
+static void le(elf_t *elf, uint64_t val, size_t size)
+{
+	uint8_t buf[sizeof(val)];
+
+	// little-endian regardless of the host
+	for (size_t i = 0; i < size; i++, val >>= 8) buf[i] = val;
+
+	bytes(elf, buf, size);
+}
+
+static void rela(elf_t *elf, const Elf64_Rela *rela)
+{
+	le(elf, rela->r_offset, sizeof(rela->r_offset));
+	le(elf, rela->r_info, sizeof(rela->r_info));
+	le(elf, rela->r_addend, sizeof(rela->r_addend));
+}
+
+static void shdr(elf_t *elf, const Elf64_Shdr *shdr)
+{
+	le(elf, shdr->sh_name, sizeof(shdr->sh_name));
+	le(elf, shdr->sh_type, sizeof(shdr->sh_type));
+	le(elf, shdr->sh_flags, sizeof(shdr->sh_flags));
+	le(elf, shdr->sh_addr, sizeof(shdr->sh_addr));
+	le(elf, shdr->sh_offset, sizeof(shdr->sh_offset));
+	le(elf, shdr->sh_size, sizeof(shdr->sh_size));
+	le(elf, shdr->sh_link, sizeof(shdr->sh_link));
+	le(elf, shdr->sh_info, sizeof(shdr->sh_info));
+	le(elf, shdr->sh_addralign, sizeof(shdr->sh_addralign));
+	le(elf, shdr->sh_entsize, sizeof(shdr->sh_entsize));
+}
+
+static int strtab_add(string_t *strtab, const char *str, Elf64_Word *offset)
+{
+	*offset = strtab->tail - strtab->head;
+
+	// the nul string_append() leaves behind becomes the separator
+	if (*str && string_append(strtab, str, 0)) return -1;
+
+	return string_append(strtab, "", 1);
+}
+
+static void sym(elf_t *elf, const Elf64_Sym *sym)
+{
+	le(elf, sym->st_name, sizeof(sym->st_name));
+	le(elf, sym->st_info, sizeof(sym->st_info));
+	le(elf, sym->st_other, sizeof(sym->st_other));
+	le(elf, sym->st_shndx, sizeof(sym->st_shndx));
+	le(elf, sym->st_value, sizeof(sym->st_value));
+	le(elf, sym->st_size, sizeof(sym->st_size));
+}
@@ -7,63 +7,49 @@
 #include <jkcc/ir/function.h>
 #include <jkcc/ir/ir.h>
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <jkcc/ast.h>
 #include <jkcc/ir.h>
+#include <jkcc/json.h>
+#include <jkcc/mem.h>
 #include <jkcc/string.h>
 
 
 ir_function_t *ir_function_alloc(void)
 {
-	return calloc(1, sizeof(ir_function_t));
+	return MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_FUNCTION,
+		1,
+		sizeof(ir_function_t));
 }
 
-void ir_function_fprint(FILE *stream, ir_function_t *ir_function)
+void ir_function_argv_reg(
+	ir_function_t *ir_function,
+	size_t         pos,
+	uintptr_t     *reg,
+	ir_reg_type_t *type)
 {
-	fprintf(stream, "define ");
-	{
-		ast_t *return_type = ast_function_get_return_type(
-			ir_function->declaration);
+	ast_t **declaration = ir_function->argv->buf;
 
-		const char* storage_type;
+	uintptr_t key = (uintptr_t) ast_declaration_get_type(declaration[pos]);
+	void *val;
 
-retry_return_type:
-		switch (*return_type) {
-			case AST_POINTER:
-				return_type
-					= ast_pointer_get_pointer(return_type);
-				goto retry_return_type;
-
-			case AST_ARRAY:
-				return_type = ast_array_get_type(return_type);
-				goto retry_return_type;
-
-			case AST_TYPE:;
-				ast_type_t *type = OFFSETOF_AST_NODE(
-					return_type,
-					ast_type_t);
-
-				switch (type->storage_class_specifier) {
-					case AST_STORAGE_CLASS_SPECIFIER_STATIC:
-						storage_type = "internal";
-						break;
-
-					default:
-						storage_type = "dso_local";
-						break;
-				}
-
-				break;
-
-			default:
-				storage_type = "(unknown)";
-				break;
-		}
+	ht_get(&ir_function->reg.lookup, &key, sizeof(key), &val);
+	*reg = (uintptr_t) val;
 
-		fprintf(stream, "%s ", storage_type);
-	}
+	key = (uintptr_t) val;
+	ht_get(&ir_function->reg.type, &key, sizeof(key), &val);
+	*type = (uintptr_t) val;
+}
+
+void ir_function_fprint(FILE *stream, ir_function_t *ir_function)
+{
+	fprintf(stream, "define %s ", ir_function_linkage_str(ir_function));
 
 	ir_reg_type_fprint(stream, ir_function->return_type);
 	fprintf(stream, " @");
@@ -76,30 +62,23 @@ retry_return_type:
 
 	fprintf(stream, "(");
 	if (ir_function->argv) {
-		ast_t **declaration = ir_function->argv->buf;
 		for (size_t i = 0; i < ir_function->argv->use; i++) {
-			uintptr_t key = (uintptr_t) ast_declaration_get_type(
-				declaration[i]);
-			void *val;
+			uintptr_t     reg;
+			ir_reg_type_t type;
 
-			ht_get(
-				&ir_function->reg.lookup,
-				&key,
-				sizeof(key),
-				&val);
-			uintptr_t reg = (uintptr_t) val;
-
-			key = (uintptr_t) val;
-			ht_get(
-				&ir_function->reg.type,
-				&key,
-				sizeof(key),
-				&val);
-			ir_reg_type_t type = (uintptr_t) val;
+			ir_function_argv_reg(ir_function, i, &reg, &type);
 
 			ir_reg_type_fprint(stream, type);
 			fprintf(stream, " ");
-			ir_reg_fprint(stream, reg);
+
+			// allocated parameters arrive in a register or slot
+			if (ir_function->regalloc)
+				reg = ir_function->regalloc->argv[i];
+
+			if (ir_function->regalloc && !(reg & IR_REG_PHYSICAL))
+				fprintf(stream, "slot %lu", reg);
+			else
+				ir_reg_fprint(stream, reg);
 
 			if (i < ir_function->argv->use - 1)
 				fprintf(stream, ", ");
@@ -107,6 +86,8 @@ retry_return_type:
 	}
 	fprintf(stream, ") {\n");
 
+	ir_regalloc_fprint(stream, ir_function);
+
 	ir_bb_t **ir_bb = ir_function->bb.buf;
 	for (size_t i = 0; i < ir_function->bb.use; i++)
 		ir_bb_fprint(stream, ir_bb[i]);
@@ -114,13 +95,73 @@ retry_return_type:
 	fprintf(stream, "}\n");
 }
 
+void ir_function_fprint_jsonl(
+	FILE          *stream,
+	ir_function_t *ir_function,
+	size_t        *id)
+{
+	size_t function_id = (*id)++;
+
+	fprintf(
+		stream,
+		"{\"id\":%zu,\"parent\":null,\"kind\":\"function\"",
+		function_id);
+
+	fprintf(stream, ",\"name\":");
+	fprint_json_string(
+		stream,
+		ast_identifier_get_string(
+			ast_function_get_identifier(
+				ir_function->declaration))->head);
+
+	fprintf(
+		stream,
+		",\"linkage\":\"%s\",\"return-type\":\"%s\",\"argv\":[",
+		ir_function_linkage_str(ir_function),
+		ir_reg_type_str(ir_function->return_type));
+
+	if (ir_function->argv) {
+		for (size_t i = 0; i < ir_function->argv->use; i++) {
+			uintptr_t     reg;
+			ir_reg_type_t type;
+
+			ir_function_argv_reg(ir_function, i, &reg, &type);
+
+			fprintf(
+				stream,
+				"%s{\"reg\":%lu,\"type\":\"%s\"}",
+				(i) ? "," : "",
+				reg,
+				ir_reg_type_str(type));
+		}
+	}
+
+	fprintf(stream, "]");
+
+	ir_regalloc_fprint_jsonl(stream, ir_function);
+
+	fprintf(stream, "}\n");
+
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	for (size_t i = 0; i < ir_function->bb.use; i++)
+		ir_bb_fprint_jsonl(stream, ir_bb[i], function_id, id);
+}
+
 void ir_function_free(ir_function_t *ir_function)
 {
 	if (!ir_function) return;
 
-	(void) ir_function->bb;
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	for (size_t i = 0; i < ir_function->bb.use; i++)
+		ir_bb_free(ir_bb[i]);
+
+	vector_free(&ir_function->bb);
+
+	ht_free(&ir_function->reg.lookup, NULL);
+	ht_free(&ir_function->reg.type, NULL);
 
-	free(ir_function);
+	MEM_FREE(ir_function->regalloc);
+	MEM_FREE(ir_function);
 }
 
 int ir_function_gen(
@@ -233,3 +274,69 @@ error_ht_init_reg_type:
 
 	return ir_error;
 }
+
+const char *ir_function_linkage_str(ir_function_t *ir_function)
+{
+	ast_t *return_type = ast_function_get_return_type(
+		ir_function->declaration);
+
+	const char* storage_type;
+
+retry_return_type:
+	switch (*return_type) {
+		case AST_POINTER:
+			return_type = ast_pointer_get_pointer(return_type);
+			goto retry_return_type;
+
+		case AST_ARRAY:
+			return_type = ast_array_get_type(return_type);
+			goto retry_return_type;
+
+		case AST_TYPE:;
+			ast_type_t *type = OFFSETOF_AST_NODE(
+				return_type,
+				ast_type_t);
+
+			switch (type->storage_class_specifier) {
+				case AST_STORAGE_CLASS_SPECIFIER_STATIC:
+					storage_type = "internal";
+					break;
+
+				default:
+					storage_type = "dso_local";
+					break;
+			}
+
+			break;
+
+		default:
+			storage_type = "(unknown)";
+			break;
+	}
+
+	return storage_type;
+}
+
+size_t ir_function_vregs(ir_function_t *ir_function)
+{
+	size_t vregs = (ir_function->argv) ? ir_function->argv->use : 0;
+
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			if (reg.def && *reg.def >= vregs) vregs = *reg.def + 1;
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++)
+				if (reg.use[k] && *reg.use[k] >= vregs)
+					vregs = *reg.use[k] + 1;
+		}
+	}
+
+	return vregs;
+}
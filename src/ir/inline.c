@@ -0,0 +1,451 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * inline.c -- function inlining
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/inline.h>
+#include <jkcc/private/inline.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/vector.h>
+
+
+int ir_inline_unit(ir_unit_t *ir_unit)
+{
+	inline_t inliner = {
+		.bb = 0,
+	};
+
+	int ret = ir_callgraph_init(&inliner.callgraph, ir_unit);
+	if (ret) return ret;
+
+	// string literals draw their ids from the same counter as bbs
+	ir_static_declaration_t **ir_static_declaration
+		= ir_unit->static_declaration.buf;
+	for (size_t i = 0; i < ir_unit->static_declaration.use; i++)
+		if (ir_static_declaration[i]->bb >= inliner.bb)
+			inliner.bb = ir_static_declaration[i]->bb + 1;
+
+	ir_function_t **ir_function = ir_unit->function.buf;
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		ir_bb_t **ir_bb = ir_function[i]->bb.buf;
+
+		for (size_t j = 0; j < ir_function[i]->bb.use; j++)
+			if (ir_bb[j]->id >= inliner.bb)
+				inliner.bb = ir_bb[j]->id + 1;
+	}
+
+	// bottom-up, so a callee is final by the time it is copied
+	for (size_t i = 0; i < inliner.callgraph.functions; i++) {
+		ret = function(&inliner, inliner.callgraph.order[i]);
+		if (ret) break;
+	}
+
+	ir_callgraph_free(&inliner.callgraph);
+
+	return ret;
+}
+
+
+static size_t argc(const ir_function_t *ir_function)
+{
+	return (ir_function->argv) ? ir_function->argv->use : 0;
+}
+
+static int collect(inline_site_t *site)
+{
+	ir_bb_t    *ir_bb = ((ir_bb_t**) site->caller->bb.buf)[site->bb];
+	ir_quad_t **quad  = ir_bb->quad.buf;
+	size_t      args  = argc(site->callee);
+	size_t      found = 0;
+
+	if (args > INLINE_ARGV_MAX) return -1;
+
+	for (size_t i = 0; i < args; i++) site->arg[i] = SIZE_MAX;
+
+	// arguments are evaluated right to left, so one holding a call
+	// leaves those after it in an earlier bb, and an argument of an
+	// enclosing call can sit in front of ours
+	for (size_t i = site->quad; i-- > 0;) {
+		if (*quad[i] == IR_QUAD_CALL) break;
+
+		if (*quad[i] != IR_QUAD_ARG) continue;
+
+		ir_quad_arg_t *arg = OFFSETOF_IR_QUAD(quad[i], ir_quad_arg_t);
+
+		if (arg->pos >= args) return -1;
+
+		if (site->arg[arg->pos] != SIZE_MAX) return -1;
+
+		site->arg[arg->pos] = i;
+		++found;
+	}
+
+	return (found == args) ? 0 : -1;
+}
+
+static int expand(inline_t *inliner, inline_site_t *site, size_t *added)
+{
+	ir_function_t  *caller = site->caller;
+	ir_function_t  *callee = site->callee;
+	ir_bb_t        *head   = ((ir_bb_t**) caller->bb.buf)[site->bb];
+	ir_quad_t     **quad   = head->quad.buf;
+	ir_quad_call_t *call   = OFFSETOF_IR_QUAD(
+		quad[site->quad],
+		ir_quad_call_t);
+
+	size_t    args   = argc(callee);
+	size_t    bbs    = callee->bb.use;
+	size_t    tail   = head->quad.use - site->quad - 1;
+	uintptr_t base   = ir_function_vregs(caller);
+	uintptr_t result = base + ir_function_vregs(callee);
+
+	// parameters and the result are memory cells, the same as the
+	// callee already treats its parameters
+	ir_quad_t *cell[INLINE_ARGV_MAX + 1] = {NULL};
+	ir_quad_t *store[INLINE_ARGV_MAX]    = {NULL};
+	ir_quad_t *load                      = NULL;
+
+	ht_t     target;    // callee bb id to the id of its clone
+	vector_t block;     // ir_bb_t*, the clones then the continuation
+	vector_t prologue;  // ir_quad_t*, what is left of the head
+
+	int ret = IR_ERROR_NOMEM;
+
+	if (ht_init(&target, 0)) return IR_ERROR_NOMEM;
+
+	if (vector_init(&block, sizeof(ir_bb_t*), 0))
+		goto error_vector_init_block;
+
+	if (vector_init(&prologue, sizeof(ir_quad_t*), 0))
+		goto error_vector_init_prologue;
+
+	ir_bb_t **callee_bb = callee->bb.buf;
+	for (size_t i = 0; i <= bbs; i++) {
+		ir_bb_t *ir_bb = ir_bb_alloc(inliner->bb + i);
+		if (!ir_bb) goto error;
+
+		if (vector_append(&block, &ir_bb)) {
+			ir_bb_free(ir_bb);
+			goto error;
+		}
+
+		if (i == bbs) break;
+
+		if (ht_insert(
+			&target,
+			&callee_bb[i]->id,
+			sizeof(callee_bb[i]->id),
+			(void*) (uintptr_t) ir_bb->id)) goto error;
+	}
+
+	ir_bb_t **ir_bb = block.buf;
+	ir_bb_t  *cont  = ir_bb[bbs];
+
+	for (size_t i = 0; i < args; i++) {
+		uintptr_t     reg;
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(callee, i, &reg, &type);
+
+		ret = ir_quad_alloca_gen(&cell[i], base + reg, type);
+		if (ret) goto error;
+
+		ir_quad_arg_t *arg = OFFSETOF_IR_QUAD(
+			quad[site->arg[i]],
+			ir_quad_arg_t);
+
+		// the callee knows better than the call site what it takes
+		ret = ir_quad_store_gen(
+			&store[i],
+			arg->src,
+			type,
+			base + reg);
+		if (ret) goto error;
+	}
+
+	ret = ir_quad_alloca_gen(&cell[args], result, call->type);
+	if (ret) goto error;
+
+	ir_location_t src = {
+		.type = IR_LOCATION_REG,
+		.reg  = result,
+	};
+
+	ret = ir_quad_load_gen(&load, call->dst, call->type, &src);
+	if (ret) goto error;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **callee_quad = callee_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < callee_bb[i]->quad.use; j++) {
+			ir_quad_t *clone;
+
+			if (*callee_quad[j] != IR_QUAD_RET) {
+				ret = IR_QUAD_CLONE(&clone, callee_quad[j]);
+				if (ret) goto error;
+
+				remap(clone, base, &target);
+
+				ret = IR_ERROR_NOMEM;
+				if (vector_append(&ir_bb[i]->quad, &clone)) {
+					IR_QUAD_FREE(clone);
+					goto error;
+				}
+
+				continue;
+			}
+
+			ir_quad_ret_t *ir_quad_ret = OFFSETOF_IR_QUAD(
+				callee_quad[j],
+				ir_quad_ret_t);
+
+			if (ir_quad_ret->src != UINTPTR_MAX) {
+				uintptr_t value = ir_quad_ret->src;
+
+				if (!IR_REG_IS_IMMEDIATE(value)) value += base;
+
+				ret = ir_quad_store_gen(
+					&clone,
+					value,
+					ir_quad_ret->type,
+					result);
+				if (ret) goto error;
+
+				ret = IR_ERROR_NOMEM;
+				if (vector_append(&ir_bb[i]->quad, &clone)) {
+					IR_QUAD_FREE(clone);
+					goto error;
+				}
+			}
+
+			ret = ir_quad_br_gen(&clone, IR_QUAD_BR_AL, cont->id);
+			if (ret) goto error;
+
+			ret = IR_ERROR_NOMEM;
+			if (vector_append(&ir_bb[i]->quad, &clone)) {
+				IR_QUAD_FREE(clone);
+				goto error;
+			}
+
+			break;
+		}
+	}
+
+	// nothing past here may fail
+	ret = IR_ERROR_NOMEM;
+
+	if (vector_resize(&prologue, args + 1 + site->quad)) goto error;
+
+	if (vector_resize(&cont->quad, tail + 1)) goto error;
+
+	if (caller->bb.use + block.use > caller->bb.size && vector_resize(
+		&caller->bb,
+		caller->bb.use + block.use)) goto error;
+
+	for (size_t i = 0; i <= args; i++) vector_append(&prologue, &cell[i]);
+
+	for (size_t i = 0; i < site->quad; i++) {
+		ir_quad_t *ir_quad = quad[i];
+
+		for (size_t j = 0; j < args; j++) {
+			if (site->arg[j] != i) continue;
+
+			IR_QUAD_FREE(quad[i]);
+			ir_quad = store[j];
+			break;
+		}
+
+		vector_append(&prologue, &ir_quad);
+	}
+
+	vector_append(&cont->quad, &load);
+
+	for (size_t i = 0; i < tail; i++)
+		vector_append(&cont->quad, &quad[site->quad + 1 + i]);
+
+	IR_QUAD_FREE(quad[site->quad]);
+
+	vector_free(&head->quad);
+	head->quad = prologue;
+
+	widen(&caller->bb, site->bb + 1, block.use);
+	memcpy(
+		(ir_bb_t**) caller->bb.buf + site->bb + 1,
+		block.buf,
+		block.use * sizeof(ir_bb_t*));
+
+	inliner->bb += block.use;
+	*added       = block.use;
+
+	vector_free(&block);
+	ht_free(&target, NULL);
+
+	return 0;
+
+error:
+	for (size_t i = 0; i <= args; i++) IR_QUAD_FREE(cell[i]);
+	for (size_t i = 0; i < args; i++) IR_QUAD_FREE(store[i]);
+	IR_QUAD_FREE(load);
+
+	vector_free(&prologue);
+
+error_vector_init_prologue:
+	ir_bb = block.buf;
+	for (size_t i = 0; i < block.use; i++) ir_bb_free(ir_bb[i]);
+
+	vector_free(&block);
+
+error_vector_init_block:
+	ht_free(&target, NULL);
+
+	return ret;
+}
+
+static int function(inline_t *inliner, size_t caller)
+{
+	ir_callgraph_t  *callgraph   = &inliner->callgraph;
+	ir_function_t  **unit        = callgraph->ir_unit->function.buf;
+	ir_function_t   *ir_function = unit[caller];
+
+	size_t quads  = size(ir_function);
+	size_t budget = quads * INLINE_GROWTH;
+
+	if (budget < quads + INLINE_GROWTH_MIN)
+		budget = quads + INLINE_GROWTH_MIN;
+
+	vector_t depth;  // size_t, of inlining behind each bb
+
+	if (vector_init(&depth, sizeof(size_t), 0)) return IR_ERROR_NOMEM;
+
+	int ret = IR_ERROR_NOMEM;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		size_t level = 0;
+
+		if (vector_append(&depth, &level)) goto error;
+	}
+
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_bb_t **ir_bb = ir_function->bb.buf;
+		size_t   *level = depth.buf;
+
+		if (level[i] >= INLINE_DEPTH_MAX) continue;
+
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_CALL) continue;
+
+			size_t callee = ir_callgraph_lookup(callgraph, quad[j]);
+
+			if (callee == SIZE_MAX) continue;
+
+			// recursion could only ever be partially unrolled
+			if (callgraph->scc[callee] == callgraph->scc[caller])
+				continue;
+
+			inline_site_t site = {
+				.caller = ir_function,
+				.callee = unit[callee],
+				.bb     = i,
+				.quad   = j,
+			};
+
+			if (!site.callee->bb.use)
+				continue;
+
+			size_t grow = size(site.callee) + argc(site.callee) + 2;
+
+			if (grow > INLINE_CALLEE_MAX) continue;
+
+			if (quads + grow > budget) continue;
+
+			if (collect(&site)) continue;
+
+			size_t extra = site.callee->bb.use + 1;
+
+			if (depth.use + extra > depth.size && vector_resize(
+				&depth,
+				depth.use + extra)) goto error;
+
+			size_t added = 0;
+
+			ret = expand(inliner, &site, &added);
+			if (ret) goto error;
+
+			widen(&depth, i + 1, added);
+
+			level = depth.buf;
+			for (size_t k = 1; k < added; k++)
+				level[i + k] = level[i] + 1;
+			level[i + added] = level[i];
+
+			quads += grow;
+
+			// the rest of this bb moved into the continuation
+			break;
+		}
+	}
+
+	ret = 0;
+
+error:
+	vector_free(&depth);
+
+	return ret;
+}
+
+static void remap(ir_quad_t *ir_quad, uintptr_t base, ht_t *target)
+{
+	ir_quad_reg_t reg;
+
+	IR_QUAD_REG(ir_quad, &reg);
+
+	if (reg.def) *reg.def += base;
+
+	for (size_t i = 0; i < IR_QUAD_REG_USES; i++)
+		if (reg.use[i]) *reg.use[i] += base;
+
+	// the caller goes on after what was the callee's tail call
+	if (*ir_quad == IR_QUAD_CALL)
+		OFFSETOF_IR_QUAD(ir_quad, ir_quad_call_t)->tail = false;
+
+	if (*ir_quad != IR_QUAD_BR) return;
+
+	ir_quad_br_t *br = OFFSETOF_IR_QUAD(ir_quad, ir_quad_br_t);
+	void         *val;
+
+	if (ht_get(target, &br->bb, sizeof(br->bb), &val)) return;
+
+	br->bb = (uintptr_t) val;
+}
+
+static size_t size(const ir_function_t *ir_function)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	size_t    quads = 0;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++)
+		quads += ir_bb[i]->quad.use;
+
+	return quads;
+}
+
+static void widen(vector_t *vector, size_t pos, size_t count)
+{
+	// the room has to have been reserved already
+	uint8_t *buf = vector->buf;
+
+	memmove(
+		buf + (pos + count) * vector->element_size,
+		buf + pos * vector->element_size,
+		(vector->use - pos) * vector->element_size);
+
+	vector->use += count;
+}
@@ -0,0 +1,1516 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * instcombine.c -- instruction combining
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/instcombine.h>
+#include <jkcc/private/instcombine.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+// first match wins, binop operands are in canonical order by now
+static const instcombine_pattern_t pattern[] = {
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OPS,
+		.lhs    = INSTCOMBINE_CONSTANT,
+		.rhs    = INSTCOMBINE_CONSTANT,
+		.action = fold,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(ADD)
+			| INSTCOMBINE_OP(SUB)
+			| INSTCOMBINE_OP(OOR)
+			| INSTCOMBINE_OP(EOR)
+			| INSTCOMBINE_OP(LSL)
+			| INSTCOMBINE_OP(LSR),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_ZERO,
+		.action = forward,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(MUL) | INSTCOMBINE_OP(DIV),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_ONE,
+		.action = forward,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(AND),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_ONES,
+		.action = forward,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(AND) | INSTCOMBINE_OP(OOR),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_SAME,
+		.action = forward,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(MUL) | INSTCOMBINE_OP(AND),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_ZERO,
+		.action = zero,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(LSL) | INSTCOMBINE_OP(LSR),
+		.lhs    = INSTCOMBINE_ZERO,
+		.rhs    = INSTCOMBINE_ANY,
+		.action = zero,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(MOD),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_ONE,
+		.action = zero,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(MOD),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_ONES,
+		.action = zero,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(SUB) | INSTCOMBINE_OP(EOR),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_SAME,
+		.action = zero,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(SUB),
+		.lhs    = INSTCOMBINE_ZERO,
+		.rhs    = INSTCOMBINE_NEGATED,
+		.action = inner,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(EOR),
+		.lhs    = INSTCOMBINE_INVERTED,
+		.rhs    = INSTCOMBINE_CONSTANT,
+		.action = inner,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(MUL),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_POWER,
+		.action = shift,
+	},
+	{
+		.type   = IR_QUAD_BINOP,
+		.ops    = INSTCOMBINE_OP(DIV) | INSTCOMBINE_OP(MOD),
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_CONSTANT,
+		.action = divide,
+	},
+	{
+		.type   = IR_QUAD_CMP,
+		.lhs    = INSTCOMBINE_CONSTANT,
+		.rhs    = INSTCOMBINE_CONSTANT,
+		.action = decide,
+	},
+	{
+		.type   = IR_QUAD_CMP,
+		.lhs    = INSTCOMBINE_ANY,
+		.rhs    = INSTCOMBINE_SAME,
+		.action = decide,
+	},
+	{
+		.type   = IR_QUAD_CMP,
+		.lhs    = INSTCOMBINE_CONSTANT,
+		.rhs    = INSTCOMBINE_ANY,
+		.action = swap,
+	},
+	{
+		.type   = IR_QUAD_CMP,
+		.lhs    = INSTCOMBINE_DIFFERENCE,
+		.rhs    = INSTCOMBINE_ZERO,
+		.action = split,
+	},
+};
+
+
+int ir_instcombine_function(ir_function_t *ir_function)
+{
+	if (!ir_function->bb.use) return 0;
+
+	instcombine_t instcombine = {
+		.ir_function = ir_function,
+	};
+
+	int ret = gather(&instcombine);
+	if (ret) goto error;
+
+	// a rewrite can open up quads that were never queued behind it,
+	// so sweep everything again until a sweep changes nothing
+	do {
+		instcombine.changed = 0;
+
+		for (size_t i = instcombine.quads; i--;) {
+			ret = push(&instcombine, i);
+			if (ret) goto error;
+		}
+
+		while (instcombine.work.use) {
+			size_t at = ((size_t*) instcombine.work.buf)[
+				--instcombine.work.use];
+
+			instcombine.quad[at].queued = false;
+
+			ret = visit(&instcombine, at);
+			if (ret) goto error;
+		}
+	} while (instcombine.changed);
+
+	ret = apply(&instcombine);
+
+error:
+	// whatever was not applied is still ours
+	for (size_t i = 0; i < instcombine.insert.use; i++)
+		IR_QUAD_FREE(((instcombine_insert_t*)
+			instcombine.insert.buf)[i].quad);
+
+	vector_free(&instcombine.work);
+	vector_free(&instcombine.insert);
+	bitset_free(&instcombine.pinned);
+	bitset_free(&instcombine.local);
+	MEM_FREE(instcombine.rename);
+	MEM_FREE(instcombine.user);
+	MEM_FREE(instcombine.users);
+	MEM_FREE(instcombine.def);
+	MEM_FREE(instcombine.defs);
+	MEM_FREE(instcombine.quad);
+
+	return ret;
+}
+
+
+static bool accepts(const instcombine_t *instcombine, uintptr_t reg)
+{
+	if (reg >= instcombine->vregs || instcombine->defs[reg] != 1)
+		return false;
+
+	return !BITSET_TEST(&instcombine->pinned, reg);
+}
+
+static int apply(instcombine_t *instcombine)
+{
+	ir_bb_t             **ir_bb  = instcombine->ir_function->bb.buf;
+	size_t                bbs    = instcombine->ir_function->bb.use;
+	instcombine_quad_t   *quad   = instcombine->quad;
+	instcombine_insert_t *insert = instcombine->insert.buf;
+	size_t                quads  = instcombine->quads;
+	int                   ret    = IR_ERROR_NOMEM;
+
+	// new quads bucketed by the quad they go ahead of, in the
+	// order they were made
+	size_t *slot = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		quads + 1,
+		sizeof(*slot));
+	if (!slot) return ret;
+
+	ir_quad_t **order = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		(instcombine->insert.use + 1) * sizeof(*order));
+	if (!order) goto error_alloc_order;
+
+	for (size_t i = 0; i < instcombine->insert.use; i++)
+		++slot[insert[i].at + 1];
+
+	for (size_t i = 0; i < quads; i++) slot[i + 1] += slot[i];
+
+	for (size_t i = 0; i < instcombine->insert.use; i++)
+		order[slot[insert[i].at]++] = insert[i].quad;
+
+	// slot[i] now ends the run of quad i, which is where quad i + 1
+	// starts, so grow every bb before touching any of them
+	for (size_t i = 0, j = 0; i < bbs; i++) {
+		size_t need = 0;
+
+		for (; j < quads && quad[j].bb == i; j++)
+			need += !quad[j].dead
+				+ slot[j] - ((j) ? slot[j - 1] : 0);
+
+		if (need <= ir_bb[i]->quad.size) continue;
+
+		if (vector_resize(&ir_bb[i]->quad, need)) goto error;
+	}
+
+	for (size_t i = 0, j = 0; i < bbs; i++) {
+		ir_quad_t **buf = ir_bb[i]->quad.buf;
+		size_t      use = 0;
+
+		for (; j < quads && quad[j].bb == i; j++) {
+			for (size_t k = (j) ? slot[j - 1] : 0; k < slot[j]; k++)
+				buf[use++] = order[k];
+
+			if (!quad[j].dead) {
+				buf[use++] = quad[j].quad;
+				continue;
+			}
+
+			IR_QUAD_FREE(quad[j].quad);
+		}
+
+		ir_bb[i]->quad.use = use;
+
+		for (size_t k = 0; k < use; k++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(buf[k], &reg);
+
+			for (size_t l = 0; l < IR_QUAD_REG_USES; l++)
+				if (reg.use[l])
+					*reg.use[l] = find(
+						instcombine,
+						*reg.use[l]);
+		}
+	}
+
+	// every bb owns its new quads now
+	instcombine->insert.use = 0;
+
+	ret = 0;
+
+error:
+	MEM_FREE(order);
+
+error_alloc_order:
+	MEM_FREE(slot);
+
+	return ret;
+}
+
+static void canonical(instcombine_t *instcombine, ir_quad_binop_t *binop)
+{
+	switch (binop->op) {
+		case IR_QUAD_BINOP_ADD:
+		case IR_QUAD_BINOP_MUL:
+		case IR_QUAD_BINOP_AND:
+		case IR_QUAD_BINOP_OOR:
+		case IR_QUAD_BINOP_EOR:
+			break;
+
+		default:
+			return;
+	}
+
+	bool lhs = constant(instcombine, binop->lhs, NULL);
+	bool rhs = constant(instcombine, binop->rhs, NULL);
+
+	// constants on the right, otherwise the lower vreg on the left
+	if (lhs == rhs && binop->lhs <= binop->rhs) return;
+	if (!lhs && rhs) return;
+
+	uintptr_t tmp = binop->lhs;
+	binop->lhs    = binop->rhs;
+	binop->rhs    = tmp;
+}
+
+static bool constant(
+	const instcombine_t *instcombine,
+	uintptr_t            reg,
+	int64_t             *value)
+{
+	if (IR_REG_IS_IMMEDIATE(reg)) {
+		if (value) *value = IR_REG_IMMEDIATE_VALUE(reg);
+
+		return true;
+	}
+
+	ir_quad_t *ir_quad = definition(instcombine, reg);
+
+	if (!ir_quad || *ir_quad != IR_QUAD_MOV) return false;
+
+	const ir_quad_mov_t *mov = OFFSETOF_IR_QUAD(ir_quad, ir_quad_mov_t);
+
+	if (value)
+		*value = (mov->type == IR_REG_TYPE_PTR)
+			? (int64_t) mov->immediate
+			: (int32_t) mov->immediate;
+
+	return true;
+}
+
+static size_t consumers(const instcombine_t *instcombine, size_t at)
+{
+	const instcombine_quad_t *quad = instcombine->quad;
+	size_t                    end  = SIZE_MAX;
+	size_t                    i    = at + 1;
+
+	// the flags last until the next cmp, and only the branches and
+	// selects right behind it read them
+	for (; i < instcombine->quads && quad[i].bb == quad[at].bb; i++) {
+		if (quad[i].dead) continue;
+
+		if (*quad[i].quad == IR_QUAD_CMP) break;
+
+		const ir_quad_br_condition_t *condition = predicate(
+			quad[i].quad);
+
+		if (end == SIZE_MAX) {
+			if (!condition) end = i;
+			continue;
+		}
+
+		if (condition && *condition != IR_QUAD_BR_AL
+			&& *condition != IR_QUAD_BR_NV) return SIZE_MAX;
+	}
+
+	return (end == SIZE_MAX) ? i : end;
+}
+
+static int decide(instcombine_t *instcombine, size_t at, bool *done)
+{
+	instcombine_quad_t *quad = instcombine->quad;
+	ir_quad_cmp_t      *cmp  = OFFSETOF_IR_QUAD(
+		quad[at].quad,
+		ir_quad_cmp_t);
+	int64_t             lhs  = 0;
+	int64_t             rhs  = 0;
+
+	if (cmp->lhs != cmp->rhs) {
+		constant(instcombine, cmp->lhs, &lhs);
+		constant(instcombine, cmp->rhs, &rhs);
+	}
+
+	size_t end = consumers(instcombine, at);
+	if (end == SIZE_MAX) return 0;
+
+	for (size_t i = at + 1; i < end; i++) {
+		if (quad[i].dead) continue;
+
+		int holds = taken(*predicate(quad[i].quad), lhs, rhs);
+
+		if (holds < 0) return 0;
+
+		if (*quad[i].quad != IR_QUAD_SELECT) continue;
+
+		const ir_quad_select_t *select = OFFSETOF_IR_QUAD(
+			quad[i].quad,
+			ir_quad_select_t);
+
+		if (!renamable(
+			instcombine,
+			select->dst,
+			(holds) ? select->lhs : select->rhs,
+			select->type)) return 0;
+	}
+
+	// a select is whichever side it was always going to pick, and the
+	// first branch taken is the only way out, the rest go
+	bool out = false;
+
+	for (size_t i = at + 1; i < end; i++) {
+		if (quad[i].dead) continue;
+
+		if (*quad[i].quad == IR_QUAD_SELECT) {
+			const ir_quad_select_t *select = OFFSETOF_IR_QUAD(
+				quad[i].quad,
+				ir_quad_select_t);
+
+			int ret = substitute(
+				instcombine,
+				i,
+				select->dst,
+				(taken(select->condition, lhs, rhs))
+					? select->lhs
+					: select->rhs);
+			if (ret) return ret;
+
+			continue;
+		}
+
+		ir_quad_br_t *br = OFFSETOF_IR_QUAD(
+			quad[i].quad,
+			ir_quad_br_t);
+
+		if (!out && taken(br->condition, lhs, rhs)) {
+			br->condition = IR_QUAD_BR_AL;
+			out           = true;
+			continue;
+		}
+
+		quad[i].dead = true;
+	}
+
+	quad[at].dead = true;
+	*done         = true;
+
+	return 0;
+}
+
+static ir_quad_t *definition(const instcombine_t *instcombine, uintptr_t reg)
+{
+	if (reg >= instcombine->vregs || instcombine->defs[reg] != 1)
+		return NULL;
+
+	const instcombine_quad_t *quad = &instcombine->quad[
+		instcombine->def[reg]];
+
+	return (quad->dead) ? NULL : quad->quad;
+}
+
+static int divide(instcombine_t *instcombine, size_t at, bool *done)
+{
+	ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+		instcombine->quad[at].quad,
+		ir_quad_binop_t);
+	ir_quad_t       *seq[INSTCOMBINE_EXPAND_MAX];
+	ir_quad_t       *last;
+	size_t           quads = 0;
+	uintptr_t        x     = binop->lhs;
+	int64_t          d;
+	int              ret;
+
+	constant(instcombine, binop->rhs, &d);
+
+	// the operands are truncated to 32 bits first, so x has to be
+	// one already for its 64-bit magnitude to mean anything
+	if (binop->type != IR_REG_TYPE_I32) return 0;
+	if (d <= 1 || d > INT32_MAX) return 0;
+	if (!narrow(instcombine, x)) return 0;
+
+	bool mod   = binop->op == IR_QUAD_BINOP_MOD;
+	bool power = !(d & (d - 1));
+
+	uintptr_t c;
+	uintptr_t sign;
+	uintptr_t mask;
+	uintptr_t flip;
+	uintptr_t abs;
+	uintptr_t product;
+	uintptr_t quotient;
+	uintptr_t magnitude;
+	uintptr_t restored;
+
+	// mask = (x < 0) ? -1 : 0, and |x| fits in 64 bits even for
+	// INT32_MIN
+	ret = materialize(instcombine, seq, &quads, IR_REG_TYPE_I32, 31, &c);
+	if (ret) goto error;
+
+	ret = operation(
+		instcombine,
+		seq,
+		&quads,
+		IR_QUAD_BINOP_LSR,
+		IR_REG_TYPE_I32,
+		x,
+		c,
+		&sign);
+	if (ret) goto error;
+
+	ret = materialize(instcombine, seq, &quads, IR_REG_TYPE_I32, 0, &c);
+	if (ret) goto error;
+
+	ret = operation(
+		instcombine,
+		seq,
+		&quads,
+		IR_QUAD_BINOP_SUB,
+		IR_REG_TYPE_I32,
+		c,
+		sign,
+		&mask);
+	if (ret) goto error;
+
+	ret = operation(
+		instcombine,
+		seq,
+		&quads,
+		IR_QUAD_BINOP_EOR,
+		IR_REG_TYPE_PTR,
+		x,
+		mask,
+		&flip);
+	if (ret) goto error;
+
+	ret = operation(
+		instcombine,
+		seq,
+		&quads,
+		IR_QUAD_BINOP_SUB,
+		IR_REG_TYPE_PTR,
+		flip,
+		mask,
+		&abs);
+	if (ret) goto error;
+
+	if (power) {
+		// a mask or a shift does for a power of two
+		ret = materialize(
+			instcombine,
+			seq,
+			&quads,
+			IR_REG_TYPE_I32,
+			(mod) ? d - 1 : __builtin_ctzll(d),
+			&c);
+		if (ret) goto error;
+
+		ret = operation(
+			instcombine,
+			seq,
+			&quads,
+			(mod) ? IR_QUAD_BINOP_AND : IR_QUAD_BINOP_LSR,
+			IR_REG_TYPE_PTR,
+			abs,
+			c,
+			&magnitude);
+		if (ret) goto error;
+	} else {
+		// with l = ceil(log2(d)) and m = ceil(2^(32 + l) / d),
+		// (n * m) >> (32 + l) is n / d for every n below 2^32,
+		// and m stays under 2^33 so n * m never passes 2^64
+		unsigned l = 64 - __builtin_clzll(d - 1);
+		uint64_t m = (((uint64_t) 1 << (32 + l)) - 1) / d + 1;
+
+		ret = materialize(
+			instcombine,
+			seq,
+			&quads,
+			IR_REG_TYPE_PTR,
+			(int64_t) m,
+			&c);
+		if (ret) goto error;
+
+		ret = operation(
+			instcombine,
+			seq,
+			&quads,
+			IR_QUAD_BINOP_MUL,
+			IR_REG_TYPE_PTR,
+			abs,
+			c,
+			&product);
+		if (ret) goto error;
+
+		ret = materialize(
+			instcombine,
+			seq,
+			&quads,
+			IR_REG_TYPE_I32,
+			32 + l,
+			&c);
+		if (ret) goto error;
+
+		ret = operation(
+			instcombine,
+			seq,
+			&quads,
+			IR_QUAD_BINOP_LSR,
+			IR_REG_TYPE_PTR,
+			product,
+			c,
+			&quotient);
+		if (ret) goto error;
+
+		magnitude = quotient;
+
+		if (mod) {
+			ret = operation(
+				instcombine,
+				seq,
+				&quads,
+				IR_QUAD_BINOP_MUL,
+				IR_REG_TYPE_PTR,
+				quotient,
+				binop->rhs,
+				&product);
+			if (ret) goto error;
+
+			ret = operation(
+				instcombine,
+				seq,
+				&quads,
+				IR_QUAD_BINOP_SUB,
+				IR_REG_TYPE_PTR,
+				abs,
+				product,
+				&magnitude);
+			if (ret) goto error;
+		}
+	}
+
+	// both truncate toward zero, so the sign comes back from x
+	ret = operation(
+		instcombine,
+		seq,
+		&quads,
+		IR_QUAD_BINOP_EOR,
+		IR_REG_TYPE_I32,
+		magnitude,
+		mask,
+		&restored);
+	if (ret) goto error;
+
+	ret = ir_quad_binop_gen(
+		&last,
+		binop->dst,
+		IR_QUAD_BINOP_SUB,
+		IR_REG_TYPE_I32,
+		restored,
+		mask);
+	if (ret) goto error;
+
+	ret = emit(instcombine, at, seq, quads);
+	if (ret) goto error_emit;
+
+	replace(instcombine, at, last);
+
+	*done = true;
+
+	return 0;
+
+error_emit:
+	IR_QUAD_FREE(last);
+
+error:
+	for (size_t i = 0; i < quads; i++) IR_QUAD_FREE(seq[i]);
+
+	return ret;
+}
+
+static int emit(
+	instcombine_t  *instcombine,
+	size_t          at,
+	ir_quad_t     **seq,
+	size_t          quads)
+{
+	for (size_t i = 0; i < quads; i++) {
+		instcombine_insert_t insert = {
+			.at   = at,
+			.quad = seq[i],
+		};
+
+		if (!vector_append(&instcombine->insert, &insert)) continue;
+
+		// the caller still owns all of them
+		instcombine->insert.use -= i;
+
+		return IR_ERROR_NOMEM;
+	}
+
+	return 0;
+}
+
+static bool evaluate(
+	ir_quad_binop_op_t  op,
+	ir_reg_type_t       type,
+	int64_t             lhs,
+	int64_t             rhs,
+	int64_t            *value)
+{
+	bool     wide = type == IR_REG_TYPE_PTR;
+	uint64_t x    = lhs;
+	uint64_t y    = rhs;
+	uint64_t z;
+
+	// the same arithmetic the interpreter does
+	switch (op) {
+		case IR_QUAD_BINOP_ADD:
+			z = x + y;
+			break;
+
+		case IR_QUAD_BINOP_SUB:
+			z = x - y;
+			break;
+
+		case IR_QUAD_BINOP_MUL:
+			z = x * y;
+			break;
+
+		case IR_QUAD_BINOP_DIV:
+			if (!rhs) return false;
+
+			if (!wide) {
+				lhs = (int32_t) lhs;
+				rhs = (int32_t) rhs;
+			}
+
+			z = (rhs == -1) ? -x : (uint64_t) (lhs / rhs);
+			break;
+
+		case IR_QUAD_BINOP_MOD:
+			if (!rhs) return false;
+
+			if (!wide) {
+				lhs = (int32_t) lhs;
+				rhs = (int32_t) rhs;
+			}
+
+			z = (rhs == -1) ? 0 : (uint64_t) (lhs % rhs);
+			break;
+
+		case IR_QUAD_BINOP_AND:
+			z = x & y;
+			break;
+
+		case IR_QUAD_BINOP_OOR:
+			z = x | y;
+			break;
+
+		case IR_QUAD_BINOP_EOR:
+			z = x ^ y;
+			break;
+
+		case IR_QUAD_BINOP_LSL:
+			z = x << (y & ((wide) ? 63 : 31));
+			break;
+
+		case IR_QUAD_BINOP_LSR:
+			z = (wide) ? x >> (y & 63) : (uint32_t) x >> (y & 31);
+			break;
+
+		default:
+			return false;
+	}
+
+	*value = (wide) ? (int64_t) z : (int32_t) z;
+
+	return true;
+}
+
+static uintptr_t find(const instcombine_t *instcombine, uintptr_t reg)
+{
+	while (reg < instcombine->vregs && instcombine->rename[reg] != reg)
+		reg = instcombine->rename[reg];
+
+	return reg;
+}
+
+static int fold(instcombine_t *instcombine, size_t at, bool *done)
+{
+	ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+		instcombine->quad[at].quad,
+		ir_quad_binop_t);
+	int64_t          lhs;
+	int64_t          rhs;
+	int64_t          value;
+
+	constant(instcombine, binop->lhs, &lhs);
+	constant(instcombine, binop->rhs, &rhs);
+
+	// dividing by zero traps, which is left for run time
+	if (!evaluate(binop->op, binop->type, lhs, rhs, &value)) return 0;
+
+	return known(instcombine, at, value, done);
+}
+
+static int forward(instcombine_t *instcombine, size_t at, bool *done)
+{
+	ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+		instcombine->quad[at].quad,
+		ir_quad_binop_t);
+
+	if (!renamable(instcombine, binop->dst, binop->lhs, binop->type))
+		return 0;
+
+	*done = true;
+
+	return substitute(instcombine, at, binop->dst, binop->lhs);
+}
+
+static int gather(instcombine_t *instcombine)
+{
+	ir_function_t *ir_function = instcombine->ir_function;
+	ir_bb_t      **ir_bb       = ir_function->bb.buf;
+	size_t         bbs         = ir_function->bb.use;
+	size_t         vregs       = ir_function_vregs(ir_function);
+	size_t         quads       = 0;
+
+	for (size_t i = 0; i < bbs; i++) quads += ir_bb[i]->quad.use;
+
+	instcombine->vregs = vregs;
+	instcombine->next  = vregs;
+	instcombine->quads = quads;
+
+	if (vector_init(&instcombine->insert, sizeof(instcombine_insert_t), 0))
+		return IR_ERROR_NOMEM;
+
+	if (vector_init(&instcombine->work, sizeof(size_t), 0))
+		return IR_ERROR_NOMEM;
+
+	if (bitset_init(&instcombine->local, vregs + 1))
+		return IR_ERROR_NOMEM;
+
+	if (bitset_init(&instcombine->pinned, vregs + 1))
+		return IR_ERROR_NOMEM;
+
+	instcombine->quad = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		quads + 1,
+		sizeof(*instcombine->quad));
+	instcombine->defs = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		vregs + 1,
+		sizeof(*instcombine->defs));
+	instcombine->def = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		vregs + 1,
+		sizeof(*instcombine->def));
+	instcombine->users = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		vregs + 2,
+		sizeof(*instcombine->users));
+	instcombine->rename = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		(vregs + 1) * sizeof(*instcombine->rename));
+
+	if (!instcombine->quad
+		|| !instcombine->defs
+		|| !instcombine->def
+		|| !instcombine->users
+		|| !instcombine->rename) return IR_ERROR_NOMEM;
+
+	instcombine_quad_t *quad  = instcombine->quad;
+	size_t             *defs  = instcombine->defs;
+	size_t             *def   = instcombine->def;
+	size_t             *users = instcombine->users;
+
+	for (size_t i = 0; i <= vregs; i++) instcombine->rename[i] = i;
+
+	for (size_t i = 0, k = 0; i < bbs; i++) {
+		ir_quad_t **ir_quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++, k++) {
+			ir_quad_reg_t reg;
+
+			quad[k] = (instcombine_quad_t) {
+				.quad = ir_quad[j],
+				.bb   = i,
+				.pos  = j,
+			};
+
+			IR_QUAD_REG(ir_quad[j], &reg);
+
+			if (!reg.def || *reg.def >= vregs) continue;
+
+			++defs[*reg.def];
+			def[*reg.def] = k;
+		}
+	}
+
+	bitset_fill(&instcombine->local);
+
+	// a use anywhere but after the one def, in the same bb, could
+	// see another value of whatever the def read
+	for (size_t i = 0; i < quads; i++) {
+		ir_quad_reg_t reg;
+
+		IR_QUAD_REG(quad[i].quad, &reg);
+
+		for (size_t j = 0; j < IR_QUAD_REG_USES; j++) {
+			if (!reg.use[j] || *reg.use[j] >= vregs) continue;
+
+			uintptr_t use = *reg.use[j];
+
+			++users[use + 2];
+
+			if (!(reg.immediate & (1U << j)))
+				BITSET_SET(&instcombine->pinned, use);
+
+			if (defs[use] == 1
+				&& def[use] < i
+				&& quad[def[use]].bb == quad[i].bb) continue;
+
+			BITSET_CLEAR(&instcombine->local, use);
+		}
+	}
+
+	for (size_t i = 0; i < vregs; i++) users[i + 2] += users[i + 1];
+
+	instcombine->user = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		(users[vregs + 1] + 1) * sizeof(*instcombine->user));
+	if (!instcombine->user) return IR_ERROR_NOMEM;
+
+	// users[reg + 1] fills up to where reg + 1 starts
+	for (size_t i = 0; i < quads; i++) {
+		ir_quad_reg_t reg;
+
+		IR_QUAD_REG(quad[i].quad, &reg);
+
+		for (size_t j = 0; j < IR_QUAD_REG_USES; j++) {
+			if (!reg.use[j] || *reg.use[j] >= vregs) continue;
+
+			instcombine->user[users[*reg.use[j] + 1]++] = i;
+		}
+	}
+
+	return 0;
+}
+
+static int inner(instcombine_t *instcombine, size_t at, bool *done)
+{
+	ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+		instcombine->quad[at].quad,
+		ir_quad_binop_t);
+
+	// 0 - (0 - y) or (y ^ c) ^ c
+	bool             sub     = binop->op == IR_QUAD_BINOP_SUB;
+	uintptr_t        undo    = (sub) ? binop->rhs : binop->lhs;
+	ir_quad_binop_t *inverse = producer(instcombine, undo);
+
+	if (!inverse || inverse->type != binop->type) return 0;
+	if (!BITSET_TEST(&instcombine->local, undo)) return 0;
+
+	uintptr_t y = find(instcombine, (sub) ? inverse->rhs : inverse->lhs);
+
+	if (!renamable(instcombine, binop->dst, y, binop->type)) return 0;
+
+	*done = true;
+
+	return substitute(instcombine, at, binop->dst, y);
+}
+
+static int known(
+	instcombine_t *instcombine,
+	size_t         at,
+	int64_t        value,
+	bool          *done)
+{
+	ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+		instcombine->quad[at].quad,
+		ir_quad_binop_t);
+	uintptr_t        dst   = binop->dst;
+	ir_quad_t       *mov;
+
+	*done = true;
+
+	// where every read takes an immediate the binop just goes away
+	if (IR_REG_IMMEDIATE_FITS(value) && accepts(instcombine, dst))
+		return substitute(
+			instcombine,
+			at,
+			dst,
+			IR_REG_IMMEDIATE_GEN(value));
+
+	int ret = ir_quad_mov_gen(&mov, dst, binop->type, value);
+	if (ret) return ret;
+
+	replace(instcombine, at, mov);
+
+	return requeue(instcombine, dst);
+}
+
+static bool match(
+	const instcombine_t   *instcombine,
+	instcombine_operand_t  operand,
+	uintptr_t              reg,
+	uintptr_t              other)
+{
+	const ir_quad_binop_t *binop;
+	int64_t                value;
+	int64_t                c;
+
+	switch (operand) {
+		case INSTCOMBINE_ANY:
+			return true;
+
+		case INSTCOMBINE_CONSTANT:
+			return constant(instcombine, reg, NULL);
+
+		case INSTCOMBINE_ZERO:
+			return constant(instcombine, reg, &value) && !value;
+
+		case INSTCOMBINE_ONE:
+			return constant(instcombine, reg, &value) && value == 1;
+
+		case INSTCOMBINE_ONES:
+			return constant(instcombine, reg, &value)
+				&& value == -1;
+
+		case INSTCOMBINE_POWER:
+			return constant(instcombine, reg, &value)
+				&& value > 1
+				&& !(value & (value - 1));
+
+		case INSTCOMBINE_SAME:
+			return reg == other;
+
+		case INSTCOMBINE_NEGATED:
+			binop = producer(instcombine, reg);
+
+			return binop
+				&& binop->op == IR_QUAD_BINOP_SUB
+				&& constant(
+					instcombine,
+					find(instcombine, binop->lhs),
+					&value)
+				&& !value;
+
+		case INSTCOMBINE_INVERTED:
+			binop = producer(instcombine, reg);
+
+			return binop
+				&& binop->op == IR_QUAD_BINOP_EOR
+				&& constant(
+					instcombine,
+					find(instcombine, binop->rhs),
+					&value)
+				&& constant(instcombine, other, &c)
+				&& value == c;
+
+		case INSTCOMBINE_DIFFERENCE:
+			binop = producer(instcombine, reg);
+
+			return binop
+				&& (binop->op == IR_QUAD_BINOP_SUB
+				|| binop->op == IR_QUAD_BINOP_EOR);
+
+		default:
+			return false;
+	}
+}
+
+static int materialize(
+	instcombine_t  *instcombine,
+	ir_quad_t     **seq,
+	size_t         *quads,
+	ir_reg_type_t   type,
+	int64_t         value,
+	uintptr_t      *dst)
+{
+	if (IR_REG_IMMEDIATE_FITS(value)) {
+		*dst = IR_REG_IMMEDIATE_GEN(value);
+		return 0;
+	}
+
+	*dst = instcombine->next++;
+
+	int ret = ir_quad_mov_gen(&seq[*quads], *dst, type, value);
+	if (ret) return ret;
+
+	++*quads;
+
+	return 0;
+}
+
+static bool narrow(const instcombine_t *instcombine, uintptr_t reg)
+{
+	if (IR_REG_IS_IMMEDIATE(reg))
+		return IR_REG_IMMEDIATE_VALUE(reg)
+			== (int32_t) IR_REG_IMMEDIATE_VALUE(reg);
+
+	ir_quad_t     *ir_quad = definition(instcombine, reg);
+	ir_quad_reg_t  def;
+
+	if (!ir_quad) return false;
+
+	IR_QUAD_REG(ir_quad, &def);
+
+	return def.def && def.type == IR_REG_TYPE_I32;
+}
+
+static int operation(
+	instcombine_t       *instcombine,
+	ir_quad_t          **seq,
+	size_t              *quads,
+	ir_quad_binop_op_t   op,
+	ir_reg_type_t        type,
+	uintptr_t            lhs,
+	uintptr_t            rhs,
+	uintptr_t           *dst)
+{
+	*dst = instcombine->next++;
+
+	int ret = ir_quad_binop_gen(&seq[*quads], *dst, op, type, lhs, rhs);
+	if (ret) return ret;
+
+	++*quads;
+
+	return 0;
+}
+
+static ir_quad_br_condition_t *predicate(ir_quad_t *ir_quad)
+{
+	switch (*ir_quad) {
+		case IR_QUAD_BR:
+			return &OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_br_t)->condition;
+
+		case IR_QUAD_SELECT:
+			return &OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_select_t)->condition;
+
+		default:
+			return NULL;
+	}
+}
+
+static ir_quad_binop_t *producer(
+	const instcombine_t *instcombine,
+	uintptr_t            reg)
+{
+	ir_quad_t *ir_quad = definition(instcombine, reg);
+
+	if (!ir_quad || *ir_quad != IR_QUAD_BINOP) return NULL;
+
+	return OFFSETOF_IR_QUAD(ir_quad, ir_quad_binop_t);
+}
+
+static int push(instcombine_t *instcombine, size_t at)
+{
+	instcombine_quad_t *quad = &instcombine->quad[at];
+
+	if (quad->dead || quad->queued) return 0;
+
+	if (*quad->quad != IR_QUAD_BINOP && *quad->quad != IR_QUAD_CMP)
+		return 0;
+
+	if (vector_append(&instcombine->work, &at)) return IR_ERROR_NOMEM;
+
+	quad->queued = true;
+
+	return 0;
+}
+
+static bool renamable(
+	const instcombine_t *instcombine,
+	uintptr_t            from,
+	uintptr_t            to,
+	ir_reg_type_t        type)
+{
+	// every read of from has to see to as it was at the def,
+	// and an i32 result is only the same as an i32 operand
+	if (from >= instcombine->vregs || instcombine->defs[from] != 1)
+		return false;
+
+	if (!BITSET_TEST(&instcombine->local, from)) return false;
+
+	if (!stable(instcombine, to)) return false;
+
+	if (IR_REG_IS_IMMEDIATE(to) && !accepts(instcombine, from))
+		return false;
+
+	return type == IR_REG_TYPE_PTR || narrow(instcombine, to);
+}
+
+static void replace(instcombine_t *instcombine, size_t at, ir_quad_t *quad)
+{
+	instcombine_quad_t *entry = &instcombine->quad[at];
+	ir_bb_t           **ir_bb = instcombine->ir_function->bb.buf;
+
+	IR_QUAD_FREE(entry->quad);
+
+	entry->quad = quad;
+	((ir_quad_t**) ir_bb[entry->bb]->quad.buf)[entry->pos] = quad;
+}
+
+static int requeue(instcombine_t *instcombine, uintptr_t reg)
+{
+	if (reg >= instcombine->vregs) return 0;
+
+	const size_t *users = instcombine->users;
+
+	for (size_t i = users[reg]; i < users[reg + 1]; i++) {
+		int ret = push(instcombine, instcombine->user[i]);
+		if (ret) return ret;
+	}
+
+	return 0;
+}
+
+static bool reverse(ir_quad_br_condition_t *condition)
+{
+	switch (*condition) {
+		case IR_QUAD_BR_EQ:
+		case IR_QUAD_BR_NE:
+		case IR_QUAD_BR_AL:
+		case IR_QUAD_BR_NV:
+			return true;
+
+		case IR_QUAD_BR_HS:
+			*condition = IR_QUAD_BR_LS;
+			return true;
+
+		case IR_QUAD_BR_LO:
+			*condition = IR_QUAD_BR_HI;
+			return true;
+
+		case IR_QUAD_BR_HI:
+			*condition = IR_QUAD_BR_LO;
+			return true;
+
+		case IR_QUAD_BR_LS:
+			*condition = IR_QUAD_BR_HS;
+			return true;
+
+		case IR_QUAD_BR_GE:
+			*condition = IR_QUAD_BR_LE;
+			return true;
+
+		case IR_QUAD_BR_LT:
+			*condition = IR_QUAD_BR_GT;
+			return true;
+
+		case IR_QUAD_BR_GT:
+			*condition = IR_QUAD_BR_LT;
+			return true;
+
+		case IR_QUAD_BR_LE:
+			*condition = IR_QUAD_BR_GE;
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+static int shift(instcombine_t *instcombine, size_t at, bool *done)
+{
+	ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+		instcombine->quad[at].quad,
+		ir_quad_binop_t);
+	int64_t          value;
+
+	constant(instcombine, binop->rhs, &value);
+
+	binop->op  = IR_QUAD_BINOP_LSL;
+	binop->rhs = IR_REG_IMMEDIATE_GEN(__builtin_ctzll(value));
+
+	*done = true;
+
+	return 0;
+}
+
+static int split(instcombine_t *instcombine, size_t at, bool *done)
+{
+	instcombine_quad_t *quad = instcombine->quad;
+	ir_quad_cmp_t      *cmp  = OFFSETOF_IR_QUAD(
+		quad[at].quad,
+		ir_quad_cmp_t);
+	ir_quad_binop_t    *diff = producer(instcombine, cmp->lhs);
+
+	// a - b and a ^ b are only zero when a and b are equal, as long
+	// as nothing was truncated away on the way
+	if (!BITSET_TEST(&instcombine->local, cmp->lhs)) return 0;
+
+	uintptr_t a = find(instcombine, diff->lhs);
+	uintptr_t b = find(instcombine, diff->rhs);
+
+	if (!stable(instcombine, a) || !stable(instcombine, b)) return 0;
+
+	if (diff->type != IR_REG_TYPE_PTR
+		&& (!narrow(instcombine, a) || !narrow(instcombine, b)))
+		return 0;
+
+	size_t end = consumers(instcombine, at);
+	if (end == SIZE_MAX) return 0;
+
+	for (size_t i = at + 1; i < end; i++) {
+		if (quad[i].dead) continue;
+
+		ir_quad_br_condition_t condition = *predicate(quad[i].quad);
+
+		if (condition == IR_QUAD_BR_EQ || condition == IR_QUAD_BR_NE)
+			continue;
+
+		if (condition == IR_QUAD_BR_AL || condition == IR_QUAD_BR_NV)
+			continue;
+
+		return 0;
+	}
+
+	cmp->lhs = a;
+	cmp->rhs = b;
+
+	*done = true;
+
+	// the operands may be constants or the same vreg now
+	return push(instcombine, at);
+}
+
+static bool stable(const instcombine_t *instcombine, uintptr_t reg)
+{
+	if (IR_REG_IS_IMMEDIATE(reg)) return true;
+
+	if (reg >= instcombine->vregs || instcombine->defs[reg] != 1)
+		return false;
+
+	return BITSET_TEST(&instcombine->local, reg)
+		|| constant(instcombine, reg, NULL);
+}
+
+static int substitute(
+	instcombine_t *instcombine,
+	size_t         at,
+	uintptr_t      from,
+	uintptr_t      to)
+{
+	instcombine->rename[from] = to;
+	instcombine->quad[at].dead = true;
+
+	return requeue(instcombine, from);
+}
+
+static int swap(instcombine_t *instcombine, size_t at, bool *done)
+{
+	instcombine_quad_t *quad = instcombine->quad;
+	ir_quad_cmp_t      *cmp  = OFFSETOF_IR_QUAD(
+		quad[at].quad,
+		ir_quad_cmp_t);
+
+	if (constant(instcombine, cmp->rhs, NULL)) return 0;
+
+	size_t end = consumers(instcombine, at);
+	if (end == SIZE_MAX) return 0;
+
+	for (size_t i = at + 1; i < end; i++) {
+		if (quad[i].dead) continue;
+
+		ir_quad_br_condition_t condition = *predicate(quad[i].quad);
+
+		if (!reverse(&condition)) return 0;
+	}
+
+	for (size_t i = at + 1; i < end; i++) {
+		if (quad[i].dead) continue;
+
+		reverse(predicate(quad[i].quad));
+	}
+
+	uintptr_t tmp = cmp->lhs;
+	cmp->lhs      = cmp->rhs;
+	cmp->rhs      = tmp;
+
+	*done = true;
+
+	return 0;
+}
+
+static int taken(ir_quad_br_condition_t condition, int64_t lhs, int64_t rhs)
+{
+	uint64_t x = lhs;
+	uint64_t y = rhs;
+
+	switch (condition) {
+		case IR_QUAD_BR_EQ:
+			return lhs == rhs;
+
+		case IR_QUAD_BR_NE:
+			return lhs != rhs;
+
+		case IR_QUAD_BR_HS:
+			return x >= y;
+
+		case IR_QUAD_BR_LO:
+			return x < y;
+
+		case IR_QUAD_BR_HI:
+			return x > y;
+
+		case IR_QUAD_BR_LS:
+			return x <= y;
+
+		case IR_QUAD_BR_GE:
+			return lhs >= rhs;
+
+		case IR_QUAD_BR_LT:
+			return lhs < rhs;
+
+		case IR_QUAD_BR_GT:
+			return lhs > rhs;
+
+		case IR_QUAD_BR_LE:
+			return lhs <= rhs;
+
+		case IR_QUAD_BR_AL:
+			return 1;
+
+		case IR_QUAD_BR_NV:
+			return 0;
+
+		default:
+			return -1;
+	}
+}
+
+static int visit(instcombine_t *instcombine, size_t at)
+{
+	ir_quad_t *ir_quad = instcombine->quad[at].quad;
+	uintptr_t *lhs;
+	uintptr_t *rhs;
+	unsigned   op      = 0;
+
+	if (instcombine->quad[at].dead) return 0;
+
+	if (*ir_quad == IR_QUAD_BINOP) {
+		ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+			ir_quad,
+			ir_quad_binop_t);
+
+		binop->lhs = find(instcombine, binop->lhs);
+		binop->rhs = find(instcombine, binop->rhs);
+
+		canonical(instcombine, binop);
+
+		op  = 1U << binop->op;
+		lhs = &binop->lhs;
+		rhs = &binop->rhs;
+	} else {
+		ir_quad_cmp_t *cmp = OFFSETOF_IR_QUAD(ir_quad, ir_quad_cmp_t);
+
+		cmp->lhs = find(instcombine, cmp->lhs);
+		cmp->rhs = find(instcombine, cmp->rhs);
+
+		lhs = &cmp->lhs;
+		rhs = &cmp->rhs;
+	}
+
+	for (size_t i = 0; i < sizeof(pattern) / sizeof(*pattern); i++) {
+		if (pattern[i].type != *ir_quad) continue;
+		if (op && !(pattern[i].ops & op)) continue;
+
+		if (!match(instcombine, pattern[i].lhs, *lhs, *rhs)) continue;
+		if (!match(instcombine, pattern[i].rhs, *rhs, *lhs)) continue;
+
+		bool done = false;
+
+		int ret = pattern[i].action(instcombine, at, &done);
+		if (ret) return ret;
+
+		if (!done) continue;
+
+		++instcombine->changed;
+
+		break;
+	}
+
+	return 0;
+}
+
+static int zero(instcombine_t *instcombine, size_t at, bool *done)
+{
+	return known(instcombine, at, 0, done);
+}
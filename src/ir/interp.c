@@ -0,0 +1,1534 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * interp.c -- ir interpreter
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/interp.h>
+#include <jkcc/private/interp.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/string.h>
+#include <jkcc/vector.h>
+
+
+static const char *const trap_str[IR_INTERP_TRAPS_TOTAL] = {
+	[IR_INTERP_TRAP_NONE]               = "none",
+	[IR_INTERP_TRAP_BAD_CALL]           = "bad call",
+	[IR_INTERP_TRAP_BAD_FORMAT]         = "bad format string",
+	[IR_INTERP_TRAP_DIVIDE_BY_ZERO]     = "divide by zero",
+	[IR_INTERP_TRAP_EXIT]               = "exit",
+	[IR_INTERP_TRAP_INVALID_LOAD]       = "invalid load",
+	[IR_INTERP_TRAP_INVALID_STORE]      = "invalid store",
+	[IR_INTERP_TRAP_INVALID_STRING]     = "invalid string",
+	[IR_INTERP_TRAP_STACK_OVERFLOW]     = "stack overflow",
+	[IR_INTERP_TRAP_UNDEFINED_FUNCTION] = "undefined function",
+	[IR_INTERP_TRAP_UNSUPPORTED_QUAD]   = "unsupported quad",
+};
+
+static const char *const shim_str[SHIMS_TOTAL] = {
+	[SHIM_ABS]     = "abs",
+	[SHIM_EXIT]    = "exit",
+	[SHIM_PRINTF]  = "printf",
+	[SHIM_PUTCHAR] = "putchar",
+	[SHIM_PUTS]    = "puts",
+};
+
+static const size_t shim_argc[SHIMS_TOTAL] = {
+	[SHIM_ABS]     = 1,
+	[SHIM_EXIT]    = 1,
+	[SHIM_PRINTF]  = 1,
+	[SHIM_PUTCHAR] = 1,
+	[SHIM_PUTS]    = 1,
+};
+
+static int (*const shim[SHIMS_TOTAL])(
+	ir_interp_t *ir_interp,
+	size_t       argc,
+	uint64_t    *ret) = {
+	[SHIM_ABS]     = shim_abs,
+	[SHIM_EXIT]    = shim_exit,
+	[SHIM_PRINTF]  = shim_printf,
+	[SHIM_PUTCHAR] = shim_putchar,
+	[SHIM_PUTS]    = shim_puts,
+};
+
+// indexed by the type being a pointer
+static const ir_interp_op_t binop_op[][2] = {
+	[IR_QUAD_BINOP_ADD] = {IR_INTERP_OP_ADD32, IR_INTERP_OP_ADD64},
+	[IR_QUAD_BINOP_SUB] = {IR_INTERP_OP_SUB32, IR_INTERP_OP_SUB64},
+	[IR_QUAD_BINOP_MUL] = {IR_INTERP_OP_MUL32, IR_INTERP_OP_MUL64},
+	[IR_QUAD_BINOP_DIV] = {IR_INTERP_OP_DIV32, IR_INTERP_OP_DIV64},
+	[IR_QUAD_BINOP_MOD] = {IR_INTERP_OP_MOD32, IR_INTERP_OP_MOD64},
+	[IR_QUAD_BINOP_AND] = {IR_INTERP_OP_AND,   IR_INTERP_OP_AND},
+	[IR_QUAD_BINOP_OOR] = {IR_INTERP_OP_OOR,   IR_INTERP_OP_OOR},
+	[IR_QUAD_BINOP_EOR] = {IR_INTERP_OP_EOR,   IR_INTERP_OP_EOR},
+	[IR_QUAD_BINOP_LSL] = {IR_INTERP_OP_LSL32, IR_INTERP_OP_LSL64},
+	[IR_QUAD_BINOP_LSR] = {IR_INTERP_OP_LSR32, IR_INTERP_OP_LSR64},
+};
+
+// only the lane-wise operations sse2 has for 32-bit lanes
+static const ir_interp_op_t vector_op[] = {
+	[IR_QUAD_BINOP_ADD] = IR_INTERP_OP_VADD,
+	[IR_QUAD_BINOP_SUB] = IR_INTERP_OP_VSUB,
+	[IR_QUAD_BINOP_MUL] = IR_INTERP_OP_TRAP,
+	[IR_QUAD_BINOP_DIV] = IR_INTERP_OP_TRAP,
+	[IR_QUAD_BINOP_MOD] = IR_INTERP_OP_TRAP,
+	[IR_QUAD_BINOP_AND] = IR_INTERP_OP_VAND,
+	[IR_QUAD_BINOP_OOR] = IR_INTERP_OP_VOOR,
+	[IR_QUAD_BINOP_EOR] = IR_INTERP_OP_VEOR,
+	[IR_QUAD_BINOP_LSL] = IR_INTERP_OP_TRAP,
+	[IR_QUAD_BINOP_LSR] = IR_INTERP_OP_TRAP,
+};
+
+
+void ir_interp_fprint(FILE *stream, const ir_interp_t *ir_interp)
+{
+	uint64_t total = 0;
+
+	fprintf(stream, "interp: %-8s %16s\n", "quad", "executed");
+
+	for (size_t i = 0; i < IR_QUAD_TOTAL; i++) {
+		fprintf(
+			stream,
+			"interp: %-8s %16lu\n",
+			ir_quad_str[i],
+			(unsigned long) ir_interp->executed[i]);
+
+		total += ir_interp->executed[i];
+	}
+
+	fprintf(stream, "interp: %-8s %16lu\n", "total", (unsigned long) total);
+	fprintf(
+		stream,
+		"interp: %-8s %16lu\n",
+		"calls",
+		(unsigned long) ir_interp->calls);
+}
+
+void ir_interp_free(ir_interp_t *ir_interp)
+{
+	if (!ir_interp) return;
+
+	ir_interp_function_t *function = ir_interp->function;
+	for (size_t i = 0; function && i < ir_interp->functions; i++) {
+		vector_free(&function[i].insn);
+		vector_free(&function[i].constant);
+		MEM_FREE(function[i].argv);
+	}
+
+	ht_free(&ir_interp->lookup, NULL);
+
+	MEM_FREE(ir_interp->function);
+	MEM_FREE(ir_interp->data);
+	MEM_FREE(ir_interp->stack);
+	MEM_FREE(ir_interp->reg);
+
+	ir_interp->function = NULL;
+	ir_interp->data     = NULL;
+	ir_interp->stack    = NULL;
+	ir_interp->reg      = NULL;
+}
+
+int ir_interp_init(ir_interp_t *ir_interp, ir_unit_t *ir_unit)
+{
+	*ir_interp = (ir_interp_t) {
+		.ir_unit   = ir_unit,
+		.functions = ir_unit->function.use,
+		.stream    = stdout,
+	};
+
+	ht_t symbol;
+	int  ret = IR_ERROR_NOMEM;
+
+	if (ht_init(&ir_interp->lookup, 0)) return IR_ERROR_NOMEM;
+	if (ht_init(&symbol, 0)) goto error_ht_init_symbol;
+
+	ir_interp->function = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_INTERP,
+		ir_interp->functions + 1,
+		sizeof(*ir_interp->function));
+	if (!ir_interp->function) goto error;
+
+	ir_interp->stack = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_INTERP,
+		IR_INTERP_STACK);
+	if (!ir_interp->stack) goto error;
+
+	ir_interp->reg = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_INTERP,
+		IR_INTERP_REGS * sizeof(*ir_interp->reg));
+	if (!ir_interp->reg) goto error;
+
+	if (layout(ir_interp, &symbol)) goto error;
+
+	// every name has to be known before any call is decoded
+	ir_function_t **ir_function = ir_unit->function.buf;
+	for (size_t i = 0; i < ir_interp->functions; i++) {
+		ir_interp_function_t *function = &ir_interp->function[i];
+
+		function->ir_function = ir_function[i];
+		function->name        = ast_identifier_get_string(
+			ast_function_get_identifier(
+				ir_function[i]->declaration))->head;
+
+		size_t size = strlen(function->name);
+
+		if (ht_exists(&ir_interp->lookup, function->name, size))
+			continue;
+
+		if (ht_insert(
+			&ir_interp->lookup,
+			function->name,
+			size,
+			function)) goto error;
+	}
+
+	for (size_t i = 0; i < ir_interp->functions; i++) {
+		ret = decode(ir_interp, &ir_interp->function[i], &symbol);
+		if (ret) goto error;
+	}
+
+	ht_free(&symbol, NULL);
+
+	return 0;
+
+error:
+	ht_free(&symbol, NULL);
+
+error_ht_init_symbol:
+	ir_interp_free(ir_interp);
+
+	return ret;
+}
+
+ir_interp_function_t *ir_interp_lookup(
+	ir_interp_t *ir_interp,
+	const char  *name)
+{
+	void *val;
+
+	if (ht_get(&ir_interp->lookup, name, strlen(name), &val)) return NULL;
+
+	return val;
+}
+
+int ir_interp_run(ir_interp_t *ir_interp, const char *name, int64_t *ret)
+{
+	ir_interp->trap          = IR_INTERP_TRAP_NONE;
+	ir_interp->trap_function = NULL;
+	ir_interp->trap_symbol   = NULL;
+
+	ir_interp_function_t *function = ir_interp_lookup(ir_interp, name);
+
+	if (!function) {
+		ir_interp->trap_symbol = name;
+
+		return trap(ir_interp, NULL, IR_INTERP_TRAP_UNDEFINED_FUNCTION);
+	}
+
+	uint64_t value  = 0;
+	int      status = execute(ir_interp, function, 0, &value);
+
+	// exit() unwinds like a trap but finishes cleanly
+	if (status && ir_interp->trap == IR_INTERP_TRAP_EXIT) {
+		value  = ir_interp->status;
+		status = 0;
+	}
+
+	*ret = (int64_t) value;
+
+	return status;
+}
+
+const char *ir_interp_trap_str(ir_interp_trap_t trap)
+{
+	return (trap < IR_INTERP_TRAPS_TOTAL) ? trap_str[trap] : NULL;
+}
+
+
+static int decode(
+	ir_interp_t          *ir_interp,
+	ir_interp_function_t *function,
+	ht_t                 *symbol)
+{
+	ir_function_t *ir_function = function->ir_function;
+	ir_regalloc_t *regalloc    = ir_function->regalloc;
+
+	decode_t context = {
+		.ir_interp = ir_interp,
+		.function  = function,
+		.symbol    = symbol,
+	};
+
+	size_t bbs = ir_function->bb.use;
+
+	function->argc = (ir_function->argv) ? ir_function->argv->use : 0;
+	function->regs = (regalloc)
+		? regalloc->registers + regalloc->slots
+		: ir_function_vregs(ir_function);
+
+	if (vector_init(&function->insn, sizeof(ir_interp_insn_t), 0))
+		return IR_ERROR_NOMEM;
+
+	if (vector_init(&function->constant, sizeof(int64_t), 0))
+		return IR_ERROR_NOMEM;
+
+	function->argv = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_INTERP,
+		(function->argc + 1) * sizeof(*function->argv));
+	if (!function->argv) return IR_ERROR_NOMEM;
+
+	for (size_t i = 0; i < function->argc; i++) {
+		uintptr_t     vreg;
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(ir_function, i, &vreg, &type);
+
+		// allocated parameters arrive in a register or slot
+		if (regalloc) {
+			vreg = regalloc->argv[i];
+
+			if (!(vreg & IR_REG_PHYSICAL))
+				vreg = (regalloc->registers + vreg)
+					| IR_REG_PHYSICAL;
+		}
+
+		uint32_t index = reg(ir_function, vreg);
+
+		function->argv[i] = (index < function->regs)
+			? index
+			: UINT32_MAX;
+	}
+
+	if (ht_init(&context.bb, 0)) return IR_ERROR_NOMEM;
+
+	int ret = IR_ERROR_NOMEM;
+
+	if (ht_init(&context.constant, 0)) goto error;
+
+	context.bb_insn = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_INTERP,
+		(bbs + 1) * sizeof(*context.bb_insn));
+	if (!context.bb_insn) goto error;
+
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	for (size_t i = 0; i < bbs; i++)
+		if (ht_insert(
+			&context.bb,
+			&ir_bb[i]->id,
+			sizeof(ir_bb[i]->id),
+			(void*) i)) goto error;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		size_t      use  = ir_bb[i]->quad.use;
+
+		context.bb_insn[i] = function->insn.use;
+
+		for (size_t j = 0; j < use; j++) {
+			// a trailing br.al onto the next bb falls through
+			size_t next = (j + 1 == use && i + 1 < bbs)
+				? ir_bb[i + 1]->id
+				: SIZE_MAX;
+
+			ret = decode_quad(&context, quad[j], next);
+			if (ret) goto error;
+		}
+	}
+
+	// falling off the end returns nothing
+	ir_interp_insn_t *insn = function->insn.buf;
+	size_t            use  = function->insn.use;
+
+	if (!use
+		|| (insn[use - 1].op != IR_INTERP_OP_RET
+		&& insn[use - 1].op != IR_INTERP_OP_RET_VOID
+		&& insn[use - 1].op != IR_INTERP_OP_JMP
+		&& insn[use - 1].op != IR_INTERP_OP_TRAP)) {
+		ir_interp_insn_t ret_void = {
+			.op   = IR_INTERP_OP_RET_VOID,
+			.quad = IR_QUAD_RET,
+		};
+
+		ret = emit(&context, &ret_void);
+		if (ret) goto error;
+	}
+
+	insn = function->insn.buf;
+	for (size_t i = 0; i < function->insn.use; i++) {
+		bool branch = insn[i].op == IR_INTERP_OP_JMP
+			|| (insn[i].op >= IR_INTERP_OP_BR_EQ
+			&& insn[i].op <= IR_INTERP_OP_BR_LE);
+
+		if (!branch) continue;
+
+		insn[i].jump = &insn[context.bb_insn[insn[i].target]];
+	}
+
+	function->frame = (function->argc + context.allocas) * IR_INTERP_CELL;
+	function->regs += function->constant.use;
+
+	ret = 0;
+
+error:
+	MEM_FREE(context.bb_insn);
+	ht_free(&context.constant, NULL);
+	ht_free(&context.bb, NULL);
+
+	return ret;
+}
+
+static int decode_quad(decode_t *decode, ir_quad_t *ir_quad, size_t next)
+{
+	ir_function_t    *ir_function = decode->function->ir_function;
+	ir_regalloc_t    *regalloc    = ir_function->regalloc;
+	ir_interp_insn_t  insn        = {
+		.op   = IR_INTERP_OP_TRAP,
+		.quad = *ir_quad,
+		.rhs  = IR_INTERP_TRAP_UNSUPPORTED_QUAD,
+	};
+	void             *val;
+	int               ret;
+
+	switch (*ir_quad) {
+		case IR_QUAD_ALLOCA: {
+			ir_quad_alloca_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_alloca_t);
+
+			size_t cell = decode->function->argc + decode->allocas;
+
+			++decode->allocas;
+
+			insn.op  = IR_INTERP_OP_ALLOCA;
+			insn.dst = reg(ir_function, quad->dst);
+			insn.imm = cell * IR_INTERP_CELL;
+			break;
+		}
+
+		case IR_QUAD_ARG: {
+			ir_quad_arg_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_arg_t);
+
+			if (quad->pos >= IR_INTERP_ARGV_MAX) {
+				insn.rhs = IR_INTERP_TRAP_BAD_CALL;
+				break;
+			}
+
+			if (decode->argc <= quad->pos)
+				decode->argc = quad->pos + 1;
+
+			ret = operand(decode, quad->src, &insn.lhs);
+			if (ret) return ret;
+
+			insn.op  = IR_INTERP_OP_ARG;
+			insn.imm = quad->pos;
+			break;
+		}
+
+		case IR_QUAD_BINOP: {
+			ir_quad_binop_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_binop_t);
+
+			bool ptr = quad->type == IR_REG_TYPE_PTR;
+
+			ret = operand(decode, quad->lhs, &insn.lhs);
+			if (ret) return ret;
+
+			ret = operand(decode, quad->rhs, &insn.rhs);
+			if (ret) return ret;
+
+			insn.op  = binop_op[quad->op][ptr];
+			insn.dst = reg(ir_function, quad->dst);
+			break;
+		}
+
+		case IR_QUAD_BR: {
+			ir_quad_br_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_br_t);
+
+			bool al = quad->condition == IR_QUAD_BR_AL;
+
+			if (quad->condition == IR_QUAD_BR_NV) return 0;
+
+			if (al && quad->bb == next) return 0;
+
+			size_t size = sizeof(quad->bb);
+
+			if (ht_get(&decode->bb, &quad->bb, size, &val)) break;
+
+			insn.op = (al)
+				? IR_INTERP_OP_JMP
+				: IR_INTERP_OP_BR_EQ + quad->condition;
+			insn.target = (uintptr_t) val;
+			break;
+		}
+
+		case IR_QUAD_CALL: {
+			ir_quad_call_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_call_t);
+
+			const char *name = NULL;
+
+			if (quad->src.type == IR_LOCATION_IDENTIFIER)
+				name = quad->src.identifier->head;
+
+			ast_t *declaration = quad->src.extern_declaration;
+
+			if (quad->src.type == IR_LOCATION_EXTERN_DECLARATION)
+				name = ast_identifier_get_string(
+					ast_declaration_get_identifier(
+						declaration))->head;
+
+			insn.dst = reg(ir_function, quad->dst);
+			insn.lhs = decode->argc;
+
+			decode->argc = 0;
+
+			if (!name) break;
+
+			insn.callee = ir_interp_lookup(decode->ir_interp, name);
+			if (insn.callee) {
+				insn.op = (quad->tail)
+					? IR_INTERP_OP_TAIL
+					: IR_INTERP_OP_CALL;
+				break;
+			}
+
+			size_t i = 0;
+			while (i < SHIMS_TOTAL && strcmp(name, shim_str[i]))
+				++i;
+
+			if (i == SHIMS_TOTAL) {
+				insn.rhs    = IR_INTERP_TRAP_UNDEFINED_FUNCTION;
+				insn.symbol = name;
+				break;
+			}
+
+			if (insn.lhs < shim_argc[i]) {
+				insn.rhs = IR_INTERP_TRAP_BAD_CALL;
+				break;
+			}
+
+			insn.op  = IR_INTERP_OP_CALL_SHIM;
+			insn.imm = i;
+			break;
+		}
+
+		case IR_QUAD_CMP: {
+			ir_quad_cmp_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_cmp_t);
+
+			ret = operand(decode, quad->lhs, &insn.lhs);
+			if (ret) return ret;
+
+			ret = operand(decode, quad->rhs, &insn.rhs);
+			if (ret) return ret;
+
+			insn.op = IR_INTERP_OP_CMP;
+			break;
+		}
+
+		case IR_QUAD_LOAD: {
+			ir_quad_load_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_load_t);
+
+			insn.dst = reg(ir_function, quad->dst);
+
+			// declarations load their address
+			const void *key;
+			switch (quad->src.type) {
+				case IR_LOCATION_REG:
+					insn.op  = IR_INTERP_OP_LOAD32;
+					insn.lhs = reg(
+						ir_function,
+						quad->src.reg);
+
+					if (quad->type == IR_REG_TYPE_PTR)
+						insn.op = IR_INTERP_OP_LOAD64;
+
+					return emit(decode, &insn);
+
+				case IR_LOCATION_EXTERN_DECLARATION:
+					key = quad->src.extern_declaration;
+					break;
+
+				case IR_LOCATION_STATIC_DECLARATION:
+					key = quad->src.static_declaration;
+					break;
+
+				default:
+					return emit(decode, &insn);
+			}
+
+			if (ht_get(decode->symbol, &key, sizeof(key), &val))
+				break;
+
+			insn.op  = IR_INTERP_OP_LEA;
+			insn.imm = (intptr_t) (decode->ir_interp->data
+				+ (uintptr_t) val);
+			break;
+		}
+
+		case IR_QUAD_MOV: {
+			ir_quad_mov_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_mov_t);
+
+			insn.op  = IR_INTERP_OP_MOV;
+			insn.dst = reg(ir_function, quad->dst);
+			insn.imm = (quad->type == IR_REG_TYPE_PTR)
+				? (int64_t) quad->immediate
+				: INTERP_I32(quad->immediate);
+			break;
+		}
+
+		case IR_QUAD_RELOAD: {
+			ir_quad_reload_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_reload_t);
+
+			if (!regalloc) break;
+
+			insn.op  = IR_INTERP_OP_COPY;
+			insn.dst = reg(ir_function, quad->dst);
+			insn.lhs = regalloc->registers + quad->slot;
+			break;
+		}
+
+		case IR_QUAD_RET: {
+			ir_quad_ret_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_ret_t);
+
+			if (quad->src == UINTPTR_MAX) {
+				insn.op = IR_INTERP_OP_RET_VOID;
+				break;
+			}
+
+			ret = operand(decode, quad->src, &insn.lhs);
+			if (ret) return ret;
+
+			insn.op = IR_INTERP_OP_RET;
+			break;
+		}
+
+		case IR_QUAD_SELECT: {
+			ir_quad_select_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_select_t);
+
+			ret = operand(decode, quad->lhs, &insn.lhs);
+			if (ret) return ret;
+
+			ret = operand(decode, quad->rhs, &insn.rhs);
+			if (ret) return ret;
+
+			insn.dst = reg(ir_function, quad->dst);
+
+			// nothing left to choose between, just a copy
+			if (quad->condition == IR_QUAD_BR_AL) {
+				insn.op = IR_INTERP_OP_COPY;
+				break;
+			}
+
+			if (quad->condition == IR_QUAD_BR_NV) {
+				insn.op  = IR_INTERP_OP_COPY;
+				insn.lhs = insn.rhs;
+				break;
+			}
+
+			insn.op = IR_INTERP_OP_SELECT_EQ + quad->condition;
+			break;
+		}
+
+		case IR_QUAD_SPILL: {
+			ir_quad_spill_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_spill_t);
+
+			if (!regalloc) break;
+
+			insn.op  = IR_INTERP_OP_COPY;
+			insn.dst = regalloc->registers + quad->slot;
+			insn.lhs = reg(ir_function, quad->src);
+			break;
+		}
+
+		case IR_QUAD_STORE: {
+			ir_quad_store_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_store_t);
+
+			ret = operand(decode, quad->src, &insn.lhs);
+			if (ret) return ret;
+
+			insn.op = (quad->type == IR_REG_TYPE_PTR)
+				? IR_INTERP_OP_STORE64
+				: IR_INTERP_OP_STORE32;
+			insn.rhs = reg(ir_function, quad->dst);
+			break;
+		}
+
+		case IR_QUAD_VECTOR: {
+			ir_quad_vector_t *quad = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_vector_t);
+
+			if (quad->type != IR_REG_TYPE_I32) break;
+			if (!quad->lanes) break;
+			if (quad->lanes > IR_QUAD_VECTOR_LANES_MAX) break;
+
+			insn.op  = vector_op[quad->op];
+			insn.dst = reg(ir_function, quad->dst);
+			insn.lhs = reg(ir_function, quad->lhs);
+			insn.rhs = reg(ir_function, quad->rhs);
+			insn.imm = quad->lanes;
+
+			// the trap reason lives where rhs would
+			if (insn.op == IR_INTERP_OP_TRAP)
+				insn.rhs = IR_INTERP_TRAP_UNSUPPORTED_QUAD;
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	return emit(decode, &insn);
+}
+
+static int emit(decode_t *decode, ir_interp_insn_t *insn)
+{
+	// never index outside of the frame on a malformed quad
+	if (insn->op != IR_INTERP_OP_TRAP
+		&& (insn->dst == UINT32_MAX
+		|| insn->lhs == UINT32_MAX
+		|| insn->rhs == UINT32_MAX)) {
+		insn->op  = IR_INTERP_OP_TRAP;
+		insn->rhs = IR_INTERP_TRAP_UNSUPPORTED_QUAD;
+	}
+
+	if (vector_append(&decode->function->insn, insn)) return IR_ERROR_NOMEM;
+
+	return 0;
+}
+
+static int execute(
+	ir_interp_t          *ir_interp,
+	ir_interp_function_t *function,
+	size_t                argc,
+	uint64_t             *ret)
+{
+	static const void *const label[IR_INTERP_OPS_TOTAL] = {
+		[IR_INTERP_OP_ADD32]     = INTERP_LABEL(op_add32),
+		[IR_INTERP_OP_ADD64]     = INTERP_LABEL(op_add64),
+		[IR_INTERP_OP_ALLOCA]    = INTERP_LABEL(op_alloca),
+		[IR_INTERP_OP_AND]       = INTERP_LABEL(op_and),
+		[IR_INTERP_OP_ARG]       = INTERP_LABEL(op_arg),
+		[IR_INTERP_OP_BR_EQ]     = INTERP_LABEL(op_br_eq),
+		[IR_INTERP_OP_BR_NE]     = INTERP_LABEL(op_br_ne),
+		[IR_INTERP_OP_BR_HS]     = INTERP_LABEL(op_br_hs),
+		[IR_INTERP_OP_BR_LO]     = INTERP_LABEL(op_br_lo),
+		[IR_INTERP_OP_BR_MI]     = INTERP_LABEL(op_br_mi),
+		[IR_INTERP_OP_BR_PL]     = INTERP_LABEL(op_br_pl),
+		[IR_INTERP_OP_BR_VS]     = INTERP_LABEL(op_br_vs),
+		[IR_INTERP_OP_BR_VC]     = INTERP_LABEL(op_br_vc),
+		[IR_INTERP_OP_BR_HI]     = INTERP_LABEL(op_br_hi),
+		[IR_INTERP_OP_BR_LS]     = INTERP_LABEL(op_br_ls),
+		[IR_INTERP_OP_BR_GE]     = INTERP_LABEL(op_br_ge),
+		[IR_INTERP_OP_BR_LT]     = INTERP_LABEL(op_br_lt),
+		[IR_INTERP_OP_BR_GT]     = INTERP_LABEL(op_br_gt),
+		[IR_INTERP_OP_BR_LE]     = INTERP_LABEL(op_br_le),
+		[IR_INTERP_OP_CALL]      = INTERP_LABEL(op_call),
+		[IR_INTERP_OP_CALL_SHIM] = INTERP_LABEL(op_call_shim),
+		[IR_INTERP_OP_CMP]       = INTERP_LABEL(op_cmp),
+		[IR_INTERP_OP_COPY]      = INTERP_LABEL(op_copy),
+		[IR_INTERP_OP_DIV32]     = INTERP_LABEL(op_div32),
+		[IR_INTERP_OP_DIV64]     = INTERP_LABEL(op_div64),
+		[IR_INTERP_OP_EOR]       = INTERP_LABEL(op_eor),
+		[IR_INTERP_OP_JMP]       = INTERP_LABEL(op_jmp),
+		[IR_INTERP_OP_LEA]       = INTERP_LABEL(op_lea),
+		[IR_INTERP_OP_LOAD32]    = INTERP_LABEL(op_load32),
+		[IR_INTERP_OP_LOAD64]    = INTERP_LABEL(op_load64),
+		[IR_INTERP_OP_LSL32]     = INTERP_LABEL(op_lsl32),
+		[IR_INTERP_OP_LSL64]     = INTERP_LABEL(op_lsl64),
+		[IR_INTERP_OP_LSR32]     = INTERP_LABEL(op_lsr32),
+		[IR_INTERP_OP_LSR64]     = INTERP_LABEL(op_lsr64),
+		[IR_INTERP_OP_MOD32]     = INTERP_LABEL(op_mod32),
+		[IR_INTERP_OP_MOD64]     = INTERP_LABEL(op_mod64),
+		[IR_INTERP_OP_MOV]       = INTERP_LABEL(op_mov),
+		[IR_INTERP_OP_MUL32]     = INTERP_LABEL(op_mul32),
+		[IR_INTERP_OP_MUL64]     = INTERP_LABEL(op_mul64),
+		[IR_INTERP_OP_OOR]       = INTERP_LABEL(op_oor),
+		[IR_INTERP_OP_RET]       = INTERP_LABEL(op_ret),
+		[IR_INTERP_OP_RET_VOID]  = INTERP_LABEL(op_ret_void),
+		[IR_INTERP_OP_SELECT_EQ] = INTERP_LABEL(op_select_eq),
+		[IR_INTERP_OP_SELECT_NE] = INTERP_LABEL(op_select_ne),
+		[IR_INTERP_OP_SELECT_HS] = INTERP_LABEL(op_select_hs),
+		[IR_INTERP_OP_SELECT_LO] = INTERP_LABEL(op_select_lo),
+		[IR_INTERP_OP_SELECT_MI] = INTERP_LABEL(op_select_mi),
+		[IR_INTERP_OP_SELECT_PL] = INTERP_LABEL(op_select_pl),
+		[IR_INTERP_OP_SELECT_VS] = INTERP_LABEL(op_select_vs),
+		[IR_INTERP_OP_SELECT_VC] = INTERP_LABEL(op_select_vc),
+		[IR_INTERP_OP_SELECT_HI] = INTERP_LABEL(op_select_hi),
+		[IR_INTERP_OP_SELECT_LS] = INTERP_LABEL(op_select_ls),
+		[IR_INTERP_OP_SELECT_GE] = INTERP_LABEL(op_select_ge),
+		[IR_INTERP_OP_SELECT_LT] = INTERP_LABEL(op_select_lt),
+		[IR_INTERP_OP_SELECT_GT] = INTERP_LABEL(op_select_gt),
+		[IR_INTERP_OP_SELECT_LE] = INTERP_LABEL(op_select_le),
+		[IR_INTERP_OP_STORE32]   = INTERP_LABEL(op_store32),
+		[IR_INTERP_OP_STORE64]   = INTERP_LABEL(op_store64),
+		[IR_INTERP_OP_SUB32]     = INTERP_LABEL(op_sub32),
+		[IR_INTERP_OP_SUB64]     = INTERP_LABEL(op_sub64),
+		[IR_INTERP_OP_TAIL]      = INTERP_LABEL(op_tail),
+		[IR_INTERP_OP_TRAP]      = INTERP_LABEL(op_trap),
+		[IR_INTERP_OP_VADD]      = INTERP_LABEL(op_vadd),
+		[IR_INTERP_OP_VAND]      = INTERP_LABEL(op_vand),
+		[IR_INTERP_OP_VEOR]      = INTERP_LABEL(op_veor),
+		[IR_INTERP_OP_VOOR]      = INTERP_LABEL(op_voor),
+		[IR_INTERP_OP_VSUB]      = INTERP_LABEL(op_vsub),
+	};
+
+enter:
+	if (!function->threaded) {
+		ir_interp_insn_t *insn = function->insn.buf;
+
+		for (size_t i = 0; i < function->insn.use; i++)
+			insn[i].handler = label[insn[i].op];
+
+		function->threaded = true;
+	}
+
+	if (ir_interp->depth >= IR_INTERP_DEPTH_MAX
+		|| IR_INTERP_STACK - ir_interp->sp < function->frame
+		|| IR_INTERP_REGS - ir_interp->rp < function->regs)
+		return trap(
+			ir_interp,
+			function->name,
+			IR_INTERP_TRAP_STACK_OVERFLOW);
+
+	uint8_t  *mem = ir_interp->stack + ir_interp->sp;
+	uint64_t *r   = ir_interp->reg + ir_interp->rp;
+
+	ir_interp->sp += function->frame;
+	ir_interp->rp += function->regs;
+	++ir_interp->depth;
+	++ir_interp->calls;
+
+	memset(mem, 0, function->frame);
+	memset(r, 0, function->regs * sizeof(*r));
+
+	// immediates are read out of registers past the vregs
+	memcpy(
+		r + function->regs - function->constant.use,
+		function->constant.buf,
+		function->constant.use * sizeof(*r));
+
+	// parameters live in memory, their register holds the address
+	for (size_t i = 0; i < function->argc; i++) {
+		uint8_t *cell = mem + i * IR_INTERP_CELL;
+
+		if (i < argc)
+			memcpy(cell, &ir_interp->argv[i], IR_INTERP_CELL);
+
+		if (function->argv[i] != UINT32_MAX)
+			r[function->argv[i]] = (uintptr_t) cell;
+	}
+
+	uint64_t         *executed = ir_interp->executed;
+	ir_interp_insn_t *insn     = function->insn.buf;
+	ir_interp_trap_t  reason   = IR_INTERP_TRAP_NONE;
+	uint64_t          lhs      = 0;  // operands of the last cmp
+	uint64_t          rhs      = 0;
+	uint64_t          value    = 0;
+	uint64_t          addr;
+	int64_t           n;
+	int64_t           d;
+	int32_t           i32;
+	uint32_t          lane[2][IR_QUAD_VECTOR_LANES_MAX];
+	size_t            size;
+	int               status   = 0;
+
+	INTERP_DISPATCH;
+
+op_add32:
+	r[insn->dst] = INTERP_I32(r[insn->lhs] + r[insn->rhs]);
+	INTERP_NEXT;
+
+op_add64:
+	r[insn->dst] = r[insn->lhs] + r[insn->rhs];
+	INTERP_NEXT;
+
+op_alloca:
+	r[insn->dst] = (uintptr_t) (mem + insn->imm);
+	INTERP_NEXT;
+
+op_and:
+	r[insn->dst] = r[insn->lhs] & r[insn->rhs];
+	INTERP_NEXT;
+
+op_arg:
+	ir_interp->argv[insn->imm] = r[insn->lhs];
+	INTERP_NEXT;
+
+op_br_eq:
+	INTERP_BRANCH(lhs == rhs);
+
+op_br_ne:
+	INTERP_BRANCH(lhs != rhs);
+
+op_br_hs:
+	INTERP_BRANCH(lhs >= rhs);
+
+op_br_lo:
+	INTERP_BRANCH(lhs < rhs);
+
+op_br_mi:
+	INTERP_BRANCH(INTERP_I32(lhs - rhs) < 0);
+
+op_br_pl:
+	INTERP_BRANCH(INTERP_I32(lhs - rhs) >= 0);
+
+op_br_vs:
+	INTERP_BRANCH(INTERP_I32(lhs - rhs) != (int64_t) (lhs - rhs));
+
+op_br_vc:
+	INTERP_BRANCH(INTERP_I32(lhs - rhs) == (int64_t) (lhs - rhs));
+
+op_br_hi:
+	INTERP_BRANCH(lhs > rhs);
+
+op_br_ls:
+	INTERP_BRANCH(lhs <= rhs);
+
+op_br_ge:
+	INTERP_BRANCH((int64_t) lhs >= (int64_t) rhs);
+
+op_br_lt:
+	INTERP_BRANCH((int64_t) lhs < (int64_t) rhs);
+
+op_br_gt:
+	INTERP_BRANCH((int64_t) lhs > (int64_t) rhs);
+
+op_br_le:
+	INTERP_BRANCH((int64_t) lhs <= (int64_t) rhs);
+
+op_call:
+	status = execute(ir_interp, insn->callee, insn->lhs, &value);
+	if (status) goto unwind;
+
+	r[insn->dst] = value;
+	INTERP_NEXT;
+
+op_call_shim:
+	status = shim[insn->imm](ir_interp, insn->lhs, &value);
+	if (status) goto unwind;
+
+	r[insn->dst] = value;
+	INTERP_NEXT;
+
+op_cmp:
+	lhs = r[insn->lhs];
+	rhs = r[insn->rhs];
+	INTERP_NEXT;
+
+op_copy:
+	r[insn->dst] = r[insn->lhs];
+	INTERP_NEXT;
+
+op_div32:
+	n = INTERP_I32(r[insn->lhs]);
+	d = INTERP_I32(r[insn->rhs]);
+
+	if (!d) {
+		reason = IR_INTERP_TRAP_DIVIDE_BY_ZERO;
+		goto trap;
+	}
+
+	r[insn->dst] = INTERP_I32(n / d);
+	INTERP_NEXT;
+
+op_div64:
+	n = r[insn->lhs];
+	d = r[insn->rhs];
+
+	if (!d) {
+		reason = IR_INTERP_TRAP_DIVIDE_BY_ZERO;
+		goto trap;
+	}
+
+	r[insn->dst] = (d == -1) ? -(uint64_t) n : (uint64_t) (n / d);
+	INTERP_NEXT;
+
+op_eor:
+	r[insn->dst] = r[insn->lhs] ^ r[insn->rhs];
+	INTERP_NEXT;
+
+op_jmp:
+	insn = insn->jump;
+	INTERP_DISPATCH;
+
+op_lea:
+	r[insn->dst] = insn->imm;
+	INTERP_NEXT;
+
+op_load32:
+	addr = r[insn->lhs];
+
+	if (!valid(ir_interp, addr, sizeof(i32))) {
+		reason = IR_INTERP_TRAP_INVALID_LOAD;
+		goto trap;
+	}
+
+	memcpy(&i32, (void*) (uintptr_t) addr, sizeof(i32));
+	r[insn->dst] = (int64_t) i32;
+	INTERP_NEXT;
+
+op_load64:
+	addr = r[insn->lhs];
+
+	if (!valid(ir_interp, addr, sizeof(value))) {
+		reason = IR_INTERP_TRAP_INVALID_LOAD;
+		goto trap;
+	}
+
+	memcpy(&r[insn->dst], (void*) (uintptr_t) addr, sizeof(value));
+	INTERP_NEXT;
+
+op_lsl32:
+	r[insn->dst] = INTERP_I32(r[insn->lhs] << (r[insn->rhs] & 31));
+	INTERP_NEXT;
+
+op_lsl64:
+	r[insn->dst] = r[insn->lhs] << (r[insn->rhs] & 63);
+	INTERP_NEXT;
+
+op_lsr32:
+	r[insn->dst] = INTERP_I32(
+		(uint32_t) r[insn->lhs] >> (r[insn->rhs] & 31));
+	INTERP_NEXT;
+
+op_lsr64:
+	r[insn->dst] = r[insn->lhs] >> (r[insn->rhs] & 63);
+	INTERP_NEXT;
+
+op_mod32:
+	n = INTERP_I32(r[insn->lhs]);
+	d = INTERP_I32(r[insn->rhs]);
+
+	if (!d) {
+		reason = IR_INTERP_TRAP_DIVIDE_BY_ZERO;
+		goto trap;
+	}
+
+	r[insn->dst] = INTERP_I32(n % d);
+	INTERP_NEXT;
+
+op_mod64:
+	n = r[insn->lhs];
+	d = r[insn->rhs];
+
+	if (!d) {
+		reason = IR_INTERP_TRAP_DIVIDE_BY_ZERO;
+		goto trap;
+	}
+
+	r[insn->dst] = (d == -1) ? 0 : (uint64_t) (n % d);
+	INTERP_NEXT;
+
+op_mov:
+	r[insn->dst] = insn->imm;
+	INTERP_NEXT;
+
+op_mul32:
+	r[insn->dst] = INTERP_I32(r[insn->lhs] * r[insn->rhs]);
+	INTERP_NEXT;
+
+op_mul64:
+	r[insn->dst] = r[insn->lhs] * r[insn->rhs];
+	INTERP_NEXT;
+
+op_oor:
+	r[insn->dst] = r[insn->lhs] | r[insn->rhs];
+	INTERP_NEXT;
+
+op_ret:
+	value = r[insn->lhs];
+	goto done;
+
+op_ret_void:
+	value = 0;
+	goto done;
+
+op_select_eq:
+	INTERP_SELECT(lhs == rhs);
+
+op_select_ne:
+	INTERP_SELECT(lhs != rhs);
+
+op_select_hs:
+	INTERP_SELECT(lhs >= rhs);
+
+op_select_lo:
+	INTERP_SELECT(lhs < rhs);
+
+op_select_mi:
+	INTERP_SELECT(INTERP_I32(lhs - rhs) < 0);
+
+op_select_pl:
+	INTERP_SELECT(INTERP_I32(lhs - rhs) >= 0);
+
+op_select_vs:
+	INTERP_SELECT(INTERP_I32(lhs - rhs) != (int64_t) (lhs - rhs));
+
+op_select_vc:
+	INTERP_SELECT(INTERP_I32(lhs - rhs) == (int64_t) (lhs - rhs));
+
+op_select_hi:
+	INTERP_SELECT(lhs > rhs);
+
+op_select_ls:
+	INTERP_SELECT(lhs <= rhs);
+
+op_select_ge:
+	INTERP_SELECT((int64_t) lhs >= (int64_t) rhs);
+
+op_select_lt:
+	INTERP_SELECT((int64_t) lhs < (int64_t) rhs);
+
+op_select_gt:
+	INTERP_SELECT((int64_t) lhs > (int64_t) rhs);
+
+op_select_le:
+	INTERP_SELECT((int64_t) lhs <= (int64_t) rhs);
+
+op_store32:
+	addr = r[insn->rhs];
+
+	if (!valid(ir_interp, addr, sizeof(i32))) {
+		reason = IR_INTERP_TRAP_INVALID_STORE;
+		goto trap;
+	}
+
+	i32 = (int32_t) (uint32_t) r[insn->lhs];
+	memcpy((void*) (uintptr_t) addr, &i32, sizeof(i32));
+	INTERP_NEXT;
+
+op_store64:
+	addr = r[insn->rhs];
+
+	if (!valid(ir_interp, addr, sizeof(value))) {
+		reason = IR_INTERP_TRAP_INVALID_STORE;
+		goto trap;
+	}
+
+	memcpy((void*) (uintptr_t) addr, &r[insn->lhs], sizeof(value));
+	INTERP_NEXT;
+
+op_sub32:
+	r[insn->dst] = INTERP_I32(r[insn->lhs] - r[insn->rhs]);
+	INTERP_NEXT;
+
+op_sub64:
+	r[insn->dst] = r[insn->lhs] - r[insn->rhs];
+	INTERP_NEXT;
+
+op_tail:
+	// the callee takes over the frame, and returns for us
+	ir_interp->sp -= function->frame;
+	ir_interp->rp -= function->regs;
+	--ir_interp->depth;
+
+	argc     = insn->lhs;
+	function = insn->callee;
+	goto enter;
+
+op_vadd:
+	INTERP_VECTOR(+);
+
+op_vand:
+	INTERP_VECTOR(&);
+
+op_veor:
+	INTERP_VECTOR(^);
+
+op_voor:
+	INTERP_VECTOR(|);
+
+op_vsub:
+	INTERP_VECTOR(-);
+
+op_trap:
+	reason = insn->rhs;
+
+	if (reason == IR_INTERP_TRAP_UNDEFINED_FUNCTION)
+		ir_interp->trap_symbol = insn->symbol;
+
+trap:
+	status = trap(ir_interp, function->name, reason);
+	goto unwind;
+
+done:
+	*ret = value;
+
+unwind:
+	ir_interp->sp -= function->frame;
+	ir_interp->rp -= function->regs;
+	--ir_interp->depth;
+
+	return status;
+}
+
+static int layout(ir_interp_t *ir_interp, ht_t *symbol)
+{
+	ir_unit_t *ir_unit = ir_interp->ir_unit;
+	size_t     size    = 0;
+
+	ast_t **extern_declaration = ir_unit->extern_declaration.buf;
+	for (size_t i = 0; i < ir_unit->extern_declaration.use; i++) {
+		const void *key = extern_declaration[i];
+
+		if (ht_exists(symbol, &key, sizeof(key))) continue;
+
+		if (ht_insert(symbol, &key, sizeof(key), (void*) size))
+			return IR_ERROR_NOMEM;
+
+		size += ir_declaration_size(
+			extern_declaration[i],
+			IR_INTERP_CELL);
+	}
+
+	ir_static_declaration_t **static_declaration
+		= ir_unit->static_declaration.buf;
+	for (size_t i = 0; i < ir_unit->static_declaration.use; i++) {
+		const void *key         = static_declaration[i];
+		ast_t      *declaration = static_declaration[i]->declaration;
+		size_t      bytes;
+
+		if (*declaration != AST_STRING_LITERAL) {
+			bytes = ir_declaration_size(
+				declaration,
+				IR_INTERP_CELL);
+		} else {
+			const string_t *string = &OFFSETOF_AST_NODE(
+				declaration,
+				ast_string_literal_t)->string_literal.string;
+
+			// room for the nul, rounded up to a whole cell
+			bytes = string->tail - string->head + IR_INTERP_CELL;
+			bytes -= bytes % IR_INTERP_CELL;
+		}
+
+		if (ht_insert(symbol, &key, sizeof(key), (void*) size))
+			return IR_ERROR_NOMEM;
+
+		size += bytes;
+	}
+
+	ir_interp->data = MEM_CALLOC(MEM_TAG_IR, MEM_IR_INTERP, size + 1, 1);
+	if (!ir_interp->data) return IR_ERROR_NOMEM;
+
+	ir_interp->data_size = size;
+
+	for (size_t i = 0; i < ir_unit->static_declaration.use; i++) {
+		const void *key         = static_declaration[i];
+		ast_t      *declaration = static_declaration[i]->declaration;
+		void       *val;
+
+		if (*declaration != AST_STRING_LITERAL) continue;
+
+		ht_get(symbol, &key, sizeof(key), &val);
+
+		const string_t *string = &OFFSETOF_AST_NODE(
+			declaration,
+			ast_string_literal_t)->string_literal.string;
+
+		memcpy(
+			ir_interp->data + (uintptr_t) val,
+			string->head,
+			string->tail - string->head);
+	}
+
+	return 0;
+}
+
+static int operand(decode_t *decode, uintptr_t src, uint32_t *index)
+{
+	ir_interp_function_t *function = decode->function;
+
+	if (!IR_REG_IS_IMMEDIATE(src)) {
+		*index = reg(function->ir_function, src);
+		return 0;
+	}
+
+	void *val;
+	if (!ht_get(&decode->constant, &src, sizeof(src), &val)) {
+		*index = (uintptr_t) val;
+		return 0;
+	}
+
+	int64_t   value = IR_REG_IMMEDIATE_VALUE(src);
+	uintptr_t next  = function->regs + function->constant.use;
+
+	if (next >= UINT32_MAX) {
+		*index = UINT32_MAX;
+		return 0;
+	}
+
+	if (vector_append(&function->constant, &value))
+		return IR_ERROR_NOMEM;
+
+	if (ht_insert(&decode->constant, &src, sizeof(src), (void*) next)) {
+		vector_pop(&function->constant, NULL);
+		return IR_ERROR_NOMEM;
+	}
+
+	*index = next;
+
+	return 0;
+}
+
+static uint32_t reg(const ir_function_t *ir_function, uintptr_t reg)
+{
+	// allocated quads only name physical registers
+	if (ir_function->regalloc)
+		return (reg & IR_REG_PHYSICAL) ? IR_REG_INDEX(reg) : UINT32_MAX;
+
+	return (reg < UINT32_MAX) ? reg : UINT32_MAX;
+}
+
+static int shim_abs(ir_interp_t *ir_interp, size_t argc, uint64_t *ret)
+{
+	(void) argc;
+
+	int64_t val = INTERP_I32(ir_interp->argv[0]);
+
+	*ret = INTERP_I32((val < 0) ? -val : val);
+
+	return 0;
+}
+
+static int shim_exit(ir_interp_t *ir_interp, size_t argc, uint64_t *ret)
+{
+	(void) argc;
+
+	ir_interp->status = INTERP_I32(ir_interp->argv[0]);
+
+	*ret = 0;
+
+	return trap(ir_interp, shim_str[SHIM_EXIT], IR_INTERP_TRAP_EXIT);
+}
+
+static int shim_printf(ir_interp_t *ir_interp, size_t argc, uint64_t *ret)
+{
+	const char *format = string(ir_interp, ir_interp->argv[0]);
+
+	if (!format)
+		return trap(
+			ir_interp,
+			shim_str[SHIM_PRINTF],
+			IR_INTERP_TRAP_INVALID_STRING);
+
+	FILE    *stream  = ir_interp->stream;
+	size_t   next    = 1;
+	int64_t  written = 0;
+
+	for (const char *pos = format; *pos; pos++) {
+		if (*pos != '%') {
+			fputc(*pos, stream);
+			++written;
+			continue;
+		}
+
+		// rebuild the conversion without length modifiers,
+		// every integer argument is an int
+		const char *start = pos++;
+
+		pos += strspn(pos, "-+ #0");
+		pos += strspn(pos, "0123456789");
+
+		if (*pos == '.') {
+			++pos;
+			pos += strspn(pos, "0123456789");
+		}
+
+		size_t len = pos - start;
+
+		pos += strspn(pos, "hljzt");
+
+		char spec[32];
+		if (len + 2 > sizeof(spec)) goto error_format;
+
+		memcpy(spec, start, len);
+		spec[len]     = *pos;
+		spec[len + 1] = '\0';
+
+		if (*pos == '%') {
+			fputc('%', stream);
+			++written;
+			continue;
+		}
+
+		if (next >= argc) goto error_format;
+
+		uint64_t    arg = ir_interp->argv[next++];
+		const char *str;
+		int         count;
+
+		switch (*pos) {
+			case 'c':
+			case 'd':
+			case 'i':
+				count = fprintf(
+					stream,
+					spec,
+					(int) INTERP_I32(arg));
+				break;
+
+			case 'o':
+			case 'u':
+			case 'x':
+			case 'X':
+				count = fprintf(stream, spec, (unsigned) arg);
+				break;
+
+			case 'p':
+				count = fprintf(
+					stream,
+					spec,
+					(void*) (uintptr_t) arg);
+				break;
+
+			case 's':
+				str = string(ir_interp, arg);
+				if (!str)
+					return trap(
+						ir_interp,
+						shim_str[SHIM_PRINTF],
+						IR_INTERP_TRAP_INVALID_STRING);
+
+				count = fprintf(stream, spec, str);
+				break;
+
+			default:
+				goto error_format;
+		}
+
+		if (count < 0) {
+			written = -1;
+			break;
+		}
+
+		written += count;
+	}
+
+	*ret = INTERP_I32(written);
+
+	return 0;
+
+error_format:
+	return trap(
+		ir_interp,
+		shim_str[SHIM_PRINTF],
+		IR_INTERP_TRAP_BAD_FORMAT);
+}
+
+static int shim_putchar(ir_interp_t *ir_interp, size_t argc, uint64_t *ret)
+{
+	(void) argc;
+
+	int c = (unsigned char) ir_interp->argv[0];
+
+	*ret = INTERP_I32(fputc(c, ir_interp->stream));
+
+	return 0;
+}
+
+static int shim_puts(ir_interp_t *ir_interp, size_t argc, uint64_t *ret)
+{
+	(void) argc;
+
+	const char *str = string(ir_interp, ir_interp->argv[0]);
+
+	if (!str)
+		return trap(
+			ir_interp,
+			shim_str[SHIM_PUTS],
+			IR_INTERP_TRAP_INVALID_STRING);
+
+	bool error = fputs(str, ir_interp->stream) < 0
+		|| fputc('\n', ir_interp->stream) == EOF;
+
+	*ret = INTERP_I32((error) ? EOF : 0);
+
+	return 0;
+}
+
+static const char *string(const ir_interp_t *ir_interp, uint64_t addr)
+{
+	uint64_t stack = (uintptr_t) ir_interp->stack;
+	uint64_t data  = (uintptr_t) ir_interp->data;
+	size_t   size;
+
+	if (addr - stack < ir_interp->sp)
+		size = ir_interp->sp - (addr - stack);
+	else if (addr - data < ir_interp->data_size)
+		size = ir_interp->data_size - (addr - data);
+	else
+		return NULL;
+
+	const char *str = (const char*) (uintptr_t) addr;
+
+	return (memchr(str, '\0', size)) ? str : NULL;
+}
+
+static int trap(
+	ir_interp_t      *ir_interp,
+	const char       *function,
+	ir_interp_trap_t  reason)
+{
+	// only the innermost trap is reported
+	if (ir_interp->trap == IR_INTERP_TRAP_NONE) {
+		ir_interp->trap          = reason;
+		ir_interp->trap_function = function;
+	}
+
+	return IR_ERROR_TRAP;
+}
+
+static bool valid(const ir_interp_t *ir_interp, uint64_t addr, size_t size)
+{
+	uint64_t stack = (uintptr_t) ir_interp->stack;
+	uint64_t data  = (uintptr_t) ir_interp->data;
+
+	// only live frames of the stack are addressable
+	if (addr - stack < ir_interp->sp)
+		return ir_interp->sp - (addr - stack) >= size;
+
+	if (addr - data < ir_interp->data_size)
+		return ir_interp->data_size - (addr - data) >= size;
+
+	return false;
+}
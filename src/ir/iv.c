@@ -0,0 +1,1462 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * iv.c -- induction variables
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/iv.h>
+#include <jkcc/private/iv.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+bool ir_iv_constant(const ir_iv_t *ir_iv, uintptr_t reg, int64_t *value)
+{
+	if (IR_REG_IS_IMMEDIATE(reg)) {
+		*value = IR_REG_IMMEDIATE_VALUE(reg);
+		return true;
+	}
+
+	ir_quad_t *ir_quad = def(ir_iv, reg);
+
+	if (!ir_quad || *ir_quad != IR_QUAD_MOV) return false;
+
+	*value = (int64_t) OFFSETOF_IR_QUAD(ir_quad, ir_quad_mov_t)->immediate;
+
+	return true;
+}
+
+bool ir_iv_counted(
+	const ir_iv_t        *ir_iv,
+	const ir_cfg_t       *ir_cfg,
+	const ir_loop_nest_t *ir_loop_nest,
+	ir_iv_counted_t      *counted)
+{
+	ir_function_t   *ir_function = ir_iv->ir_function;
+	const ir_loop_t *ir_loop     = ir_iv->ir_loop;
+	ir_bb_t        **ir_bb       = ir_function->bb.buf;
+	size_t           header      = ir_loop->header;
+	ir_quad_t      **quad        = ir_bb[header]->quad.buf;
+	size_t           use         = ir_bb[header]->quad.use;
+
+	// only the innermost loops are small enough to be worth it
+	const ir_loop_t *inner = ir_loop_nest->loop.buf;
+
+	for (size_t i = 0; i < ir_loop_nest->loop.use; i++) {
+		if (inner[i].header == header) continue;
+
+		if (BITSET_TEST(&ir_loop->body, inner[i].header)) return false;
+	}
+
+	// a header that does nothing but compute its test, as
+	// ir_bb_while_gen() leaves it
+	if (use < 3) return false;
+
+	if (*quad[use - 3] != IR_QUAD_CMP) return false;
+	if (*quad[use - 2] != IR_QUAD_BR) return false;
+	if (*quad[use - 1] != IR_QUAD_BR) return false;
+
+	for (size_t i = 0; i < use - 3; i++)
+		if (*quad[i] != IR_QUAD_LOAD
+			&& *quad[i] != IR_QUAD_MOV
+			&& *quad[i] != IR_QUAD_BINOP) return false;
+
+	ir_quad_br_t *taken = OFFSETOF_IR_QUAD(quad[use - 2], ir_quad_br_t);
+	ir_quad_br_t *br    = OFFSETOF_IR_QUAD(quad[use - 1], ir_quad_br_t);
+
+	if (br->condition != IR_QUAD_BR_AL) return false;
+
+	switch (taken->condition) {
+		case IR_QUAD_BR_EQ:
+		case IR_QUAD_BR_NE:
+		case IR_QUAD_BR_GE:
+		case IR_QUAD_BR_LT:
+		case IR_QUAD_BR_GT:
+		case IR_QUAD_BR_LE:
+			break;
+
+		default:
+			return false;
+	}
+
+	size_t t = lookup(ir_function, taken->bb);
+	size_t f = lookup(ir_function, br->bb);
+
+	if (t == SIZE_MAX || f == SIZE_MAX) return false;
+
+	bool in = BITSET_TEST(&ir_loop->body, t);
+
+	if (in == BITSET_TEST(&ir_loop->body, f)) return false;
+
+	counted->enter     = (in) ? t : f;
+	counted->exit      = (in) ? f : t;
+	counted->condition = (in)
+		? taken->condition
+		: negate(taken->condition);
+
+	if (counted->enter == header) return false;
+
+	ir_quad_cmp_t *cmp  = OFFSETOF_IR_QUAD(quad[use - 3], ir_quad_cmp_t);
+	size_t         side = 0;
+	size_t         k    = SIZE_MAX;
+
+	for (; side < 2; side++) {
+		uintptr_t reg = (side) ? cmp->rhs : cmp->lhs;
+
+		k = ir_iv_lookup(ir_iv, reg);
+
+		if (k != SIZE_MAX && ir_iv->def[reg].bb == header) break;
+	}
+
+	if (side == 2) return false;
+
+	counted->counter = (side) ? cmp->rhs : cmp->lhs;
+	counted->limit   = (side) ? cmp->lhs : cmp->rhs;
+	counted->basic   = ((ir_iv_basic_t*) ir_iv->basic.buf)[k];
+
+	if (side) counted->condition = swap(counted->condition);
+
+	if (!ir_iv_invariant(ir_iv, counted->limit)) return false;
+
+	// every trip around steps the counter exactly once
+	const size_t *pred = ir_cfg->pred[header].buf;
+
+	if (counted->basic.bb == header) return false;
+
+	for (size_t i = 0; i < ir_cfg->pred[header].use; i++) {
+		if (!BITSET_TEST(&ir_loop->body, pred[i])) continue;
+
+		if (!ir_loop_dominates(
+			ir_loop_nest,
+			counted->basic.bb,
+			pred[i])) return false;
+	}
+
+	return true;
+}
+
+void ir_iv_free(ir_iv_t *ir_iv)
+{
+	if (!ir_iv) return;
+
+	vector_free(&ir_iv->basic);
+	vector_free(&ir_iv->derived);
+
+	bitset_free(&ir_iv->private);
+	bitset_free(&ir_iv->stored);
+
+	MEM_FREE(ir_iv->def);
+
+	ir_iv->def = NULL;
+}
+
+int ir_iv_init(
+	ir_iv_t         *ir_iv,
+	ir_function_t   *ir_function,
+	const ir_loop_t *ir_loop)
+{
+	*ir_iv = (ir_iv_t) {
+		.ir_function = ir_function,
+		.ir_loop     = ir_loop,
+		.vregs       = ir_function_vregs(ir_function),
+	};
+
+	ir_iv->def = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_LOOP,
+		(ir_iv->vregs + 1) * sizeof(*ir_iv->def));
+	if (!ir_iv->def) return IR_ERROR_NOMEM;
+
+	if (bitset_init(&ir_iv->private, ir_iv->vregs + 1)) goto error;
+	if (bitset_init(&ir_iv->stored, ir_iv->vregs + 1)) goto error;
+
+	if (vector_init(&ir_iv->basic, sizeof(ir_iv_basic_t), 0))
+		goto error;
+
+	if (vector_init(&ir_iv->derived, sizeof(ir_iv_derived_t), 0))
+		goto error;
+
+	defs(ir_iv);
+	cells(ir_iv);
+
+	if (basics(ir_iv)) goto error;
+	if (deriveds(ir_iv)) goto error;
+
+	return 0;
+
+error:
+	ir_iv_free(ir_iv);
+
+	return IR_ERROR_NOMEM;
+}
+
+bool ir_iv_invariant(const ir_iv_t *ir_iv, uintptr_t reg)
+{
+	return invariant(ir_iv, reg, IV_INVARIANT_DEPTH);
+}
+
+size_t ir_iv_lookup(const ir_iv_t *ir_iv, uintptr_t reg)
+{
+	ir_quad_t *ir_quad = def(ir_iv, reg);
+
+	if (!ir_quad || *ir_quad != IR_QUAD_LOAD) return SIZE_MAX;
+
+	ir_quad_load_t *load = OFFSETOF_IR_QUAD(ir_quad, ir_quad_load_t);
+
+	if (load->src.type != IR_LOCATION_REG) return SIZE_MAX;
+
+	ir_iv_basic_t *basic = ir_iv->basic.buf;
+
+	for (size_t i = 0; i < ir_iv->basic.use; i++)
+		if (basic[i].cell == load->src.reg)
+			return (basic[i].type == load->type) ? i : SIZE_MAX;
+
+	return SIZE_MAX;
+}
+
+int ir_strength_reduce_function(ir_function_t *ir_function)
+{
+	ir_cfg_t       ir_cfg;
+	ir_loop_nest_t ir_loop_nest;
+
+	if (!ir_function->bb.use) return 0;
+
+	int ret = ir_cfg_init(&ir_cfg, ir_function);
+	if (ret) return ret;
+
+	ret = ir_loop_nest_init(&ir_loop_nest, &ir_cfg);
+	if (ret) goto error_ir_loop_nest_init;
+
+	// only quads are added or removed, so the loops stay put
+	ir_loop_t *ir_loop = ir_loop_nest.loop.buf;
+
+	for (size_t i = 0; i < ir_loop_nest.loop.use; i++) {
+		if (ir_loop[i].preheader == SIZE_MAX) continue;
+
+		ret = rewrite(ir_function, &ir_cfg, &ir_loop[i]);
+		if (ret) break;
+	}
+
+	ir_loop_nest_free(&ir_loop_nest);
+
+error_ir_loop_nest_init:
+	ir_cfg_free(&ir_cfg);
+
+	return ret;
+}
+
+
+static int apply(iv_reduce_t *reduce)
+{
+	ir_function_t  *ir_function = reduce->ir_iv->ir_function;
+	ir_bb_t       **ir_bb       = ir_function->bb.buf;
+	iv_edit_t      *edits       = reduce->edit.buf;
+	size_t          total       = reduce->edit.use;
+
+	qsort(edits, total, sizeof(*edits), compare);
+
+	vector_t *built = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_LOOP,
+		ir_function->bb.use + 1,
+		sizeof(*built));
+	if (!built) return IR_ERROR_NOMEM;
+
+	// build every new quad list before touching any bb, with room
+	// for all of it so appending can no longer fail
+	for (size_t i = 0; i < total;) {
+		size_t      bb   = edits[i].bb;
+		ir_quad_t **quad = ir_bb[bb]->quad.buf;
+		size_t      use  = ir_bb[bb]->quad.use;
+
+		size_t size = use + total + 2;
+
+		if (vector_init(&built[bb], sizeof(ir_quad_t*), size))
+			goto error;
+
+		// edits at a position sort before, instead of, then after it
+		for (size_t pos = 0; pos <= use; pos++) {
+			iv_edit_where_t where = IV_EDIT_BEFORE;
+
+			for (; i < total && edits[i].bb == bb
+				&& edits[i].pos == pos; i++) {
+				if (where == IV_EDIT_BEFORE
+					&& edits[i].where == IV_EDIT_AFTER)
+					vector_append(&built[bb], &quad[pos]);
+
+				where = edits[i].where;
+
+				if (edits[i].quad)
+					vector_append(
+						&built[bb],
+						&edits[i].quad);
+			}
+
+			if (where == IV_EDIT_BEFORE && pos < use)
+				vector_append(&built[bb], &quad[pos]);
+		}
+	}
+
+	// nothing can fail from here on
+	for (size_t i = 0; i < total; i++) {
+		if (edits[i].where != IV_EDIT_REPLACE) continue;
+
+		IR_QUAD_FREE(((ir_quad_t**)
+			ir_bb[edits[i].bb]->quad.buf)[edits[i].pos]);
+	}
+
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		if (!built[i].buf) continue;
+
+		vector_free(&ir_bb[i]->quad);
+		ir_bb[i]->quad = built[i];
+	}
+
+	MEM_FREE(built);
+
+	reduce->edit.use = 0;
+
+	return 0;
+
+error:
+	for (size_t i = 0; i < ir_function->bb.use; i++)
+		vector_free(&built[i]);
+
+	MEM_FREE(built);
+
+	return IR_ERROR_NOMEM;
+}
+
+static int basics(ir_iv_t *ir_iv)
+{
+	ir_bb_t       **ir_bb   = ir_iv->ir_function->bb.buf;
+	const bitset_t *body    = &ir_iv->ir_loop->body;
+	size_t          bbs     = ir_iv->ir_function->bb.use;
+
+	// every private cell stored exactly once in the loop
+	for (size_t i = 0; i < bbs; i++) {
+		if (!BITSET_TEST(body, i)) continue;
+
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_STORE) continue;
+
+			ir_quad_store_t *store = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_store_t);
+
+			if (store->dst >= ir_iv->vregs) continue;
+			if (!BITSET_TEST(&ir_iv->private, store->dst)) continue;
+
+			ir_iv_basic_t *basic = ir_iv->basic.buf;
+			size_t         k     = 0;
+
+			while (k < ir_iv->basic.use
+				&& basic[k].cell != store->dst) ++k;
+
+			if (k < ir_iv->basic.use) {
+				basic[k].quad = SIZE_MAX;
+				continue;
+			}
+
+			ir_iv_basic_t candidate = {
+				.cell = store->dst,
+				.bb   = i,
+				.quad = j,
+			};
+
+			if (vector_append(&ir_iv->basic, &candidate))
+				return -1;
+		}
+	}
+
+	// that adds a constant to what the cell held
+	ir_iv_basic_t *basic = ir_iv->basic.buf;
+	size_t         kept  = 0;
+
+	for (size_t i = 0; i < ir_iv->basic.use; i++) {
+		if (basic[i].quad == SIZE_MAX) continue;
+
+		ir_quad_t       *ir_quad = ((ir_quad_t**)
+			ir_bb[basic[i].bb]->quad.buf)[basic[i].quad];
+		ir_quad_store_t *store   = OFFSETOF_IR_QUAD(
+			ir_quad,
+			ir_quad_store_t);
+
+		if (store->type != IR_REG_TYPE_I32
+			&& store->type != IR_REG_TYPE_PTR) continue;
+
+		ir_quad_t *add = def(ir_iv, store->src);
+
+		if (!add || *add != IR_QUAD_BINOP) continue;
+
+		const ir_iv_def_t *step = &ir_iv->def[store->src];
+
+		if (step->bb != basic[i].bb || step->quad > basic[i].quad)
+			continue;
+
+		ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(add, ir_quad_binop_t);
+
+		if (binop->type != store->type) continue;
+
+		if (binop->op != IR_QUAD_BINOP_ADD
+			&& binop->op != IR_QUAD_BINOP_SUB) continue;
+
+		// the cell has to come before the constant in a sub
+		for (size_t side = 0; side < 2; side++) {
+			uintptr_t  lhs  = (side) ? binop->rhs : binop->lhs;
+			uintptr_t  rhs  = (side) ? binop->lhs : binop->rhs;
+			ir_quad_t *load = def(ir_iv, lhs);
+			int64_t    k;
+
+			if (side && binop->op == IR_QUAD_BINOP_SUB) break;
+
+			if (!load || *load != IR_QUAD_LOAD) continue;
+			if (!ir_iv_constant(ir_iv, rhs, &k)) continue;
+
+			ir_quad_load_t *src = OFFSETOF_IR_QUAD(
+				load,
+				ir_quad_load_t);
+
+			if (src->src.type != IR_LOCATION_REG) continue;
+			if (src->src.reg != basic[i].cell) continue;
+			if (src->type != store->type) continue;
+			if (ir_iv->def[lhs].bb != basic[i].bb) continue;
+
+			if (store->type == IR_REG_TYPE_I32) k = (int32_t) k;
+
+			if (!k) break;
+
+			if (binop->op == IR_QUAD_BINOP_SUB) k = -k;
+
+			basic[i].type = store->type;
+			basic[i].step = k;
+			basic[i].load = ir_iv->def[lhs].quad;
+
+			basic[kept++] = basic[i];
+			break;
+		}
+	}
+
+	ir_iv->basic.use = kept;
+
+	return 0;
+}
+
+static void cells(ir_iv_t *ir_iv)
+{
+	ir_function_t  *ir_function = ir_iv->ir_function;
+	ir_bb_t       **ir_bb       = ir_function->bb.buf;
+	bitset_t       *private     = &ir_iv->private;
+	size_t          argc        = (ir_function->argv)
+		? ir_function->argv->use
+		: 0;
+
+	for (size_t i = 0; i < argc; i++) {
+		uintptr_t     reg;
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(ir_function, i, &reg, &type);
+
+		if (reg < ir_iv->vregs) BITSET_SET(private, reg);
+	}
+
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++)
+			if (*quad[j] == IR_QUAD_ALLOCA)
+				BITSET_SET(private, OFFSETOF_IR_QUAD(
+					quad[j],
+					ir_quad_alloca_t)->dst);
+	}
+
+	// an address loaded or stored through stays in the frame, and
+	// nothing but a store naming the cell itself can change it
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		bool        body = BITSET_TEST(&ir_iv->ir_loop->body, i);
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			if (*quad[j] == IR_QUAD_LOAD) continue;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			if (*quad[j] == IR_QUAD_STORE) {
+				if (body)
+					BITSET_SET(&ir_iv->stored, *reg.use[1]);
+
+				reg.use[1] = NULL;
+			}
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+
+				BITSET_CLEAR(private, *reg.use[k]);
+			}
+		}
+	}
+}
+
+static int compare(const void *lhs, const void *rhs)
+{
+	const iv_edit_t *l = lhs;
+	const iv_edit_t *r = rhs;
+
+	if (l->bb != r->bb) return (l->bb > r->bb) - (l->bb < r->bb);
+	if (l->pos != r->pos) return (l->pos > r->pos) - (l->pos < r->pos);
+	if (l->where != r->where) return (int) l->where - (int) r->where;
+
+	return (l->seq > r->seq) - (l->seq < r->seq);
+}
+
+static ir_quad_t *def(const ir_iv_t *ir_iv, uintptr_t reg)
+{
+	if (reg >= ir_iv->vregs) return NULL;
+
+	const ir_iv_def_t *ir_iv_def = &ir_iv->def[reg];
+
+	if (ir_iv_def->bb == SIZE_MAX) return NULL;
+
+	ir_bb_t *ir_bb = ((ir_bb_t**) ir_iv->ir_function->bb.buf)
+		[ir_iv_def->bb];
+
+	return ((ir_quad_t**) ir_bb->quad.buf)[ir_iv_def->quad];
+}
+
+static void defs(ir_iv_t *ir_iv)
+{
+	ir_bb_t **ir_bb = ir_iv->ir_function->bb.buf;
+
+	for (size_t i = 0; i <= ir_iv->vregs; i++)
+		ir_iv->def[i] = (ir_iv_def_t) {
+			.bb = SIZE_MAX,
+		};
+
+	for (size_t i = 0; i < ir_iv->ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++)
+				if (reg.use[k]) ++ir_iv->def[*reg.use[k]].uses;
+
+			if (!reg.def) continue;
+
+			ir_iv_def_t *ir_iv_def = &ir_iv->def[*reg.def];
+
+			if (ir_iv_def->defs++) {
+				ir_iv_def->bb = SIZE_MAX;
+				continue;
+			}
+
+			ir_iv_def->bb   = i;
+			ir_iv_def->quad = j;
+		}
+	}
+}
+
+static int deriveds(ir_iv_t *ir_iv)
+{
+	ir_bb_t       **ir_bb = ir_iv->ir_function->bb.buf;
+	ir_iv_basic_t  *basic = ir_iv->basic.buf;
+
+	if (!ir_iv->basic.use) return 0;
+
+	for (size_t i = 0; i < ir_iv->ir_function->bb.use; i++) {
+		if (!BITSET_TEST(&ir_iv->ir_loop->body, i)) continue;
+
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_BINOP) continue;
+
+			ir_quad_binop_t *add = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_binop_t);
+
+			if (add->op != IR_QUAD_BINOP_ADD) continue;
+			if (add->type != IR_REG_TYPE_PTR) continue;
+
+			uintptr_t operand[] = {add->lhs, add->rhs};
+
+			// the index is computed right here, from the basic iv
+			// as it is at this point in the iteration
+			for (size_t side = 0; side < 4; side++) {
+				uintptr_t  index = operand[side & 1];
+				uintptr_t  base  = operand[!(side & 1)];
+				ir_quad_t *mul   = def(ir_iv, index);
+
+				if (!mul || *mul != IR_QUAD_BINOP) continue;
+				if (ir_iv->def[index].bb != i) continue;
+
+				ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+					mul,
+					ir_quad_binop_t);
+
+				if (binop->op != IR_QUAD_BINOP_MUL) continue;
+				if (binop->type != IR_REG_TYPE_I32) continue;
+
+				uintptr_t factor[] = {binop->lhs, binop->rhs};
+
+				uintptr_t reg = factor[!!(side & 2)];
+				uintptr_t imm = factor[!(side & 2)];
+				size_t    k   = ir_iv_lookup(ir_iv, reg);
+				int64_t   scale;
+
+				if (k == SIZE_MAX) continue;
+				if (basic[k].type != IR_REG_TYPE_I32) continue;
+				if (!ir_iv_constant(ir_iv, imm, &scale))
+					continue;
+
+				const ir_iv_def_t *load = &ir_iv->def[reg];
+
+				if (load->bb != i || load->quad > j) continue;
+
+				if (basic[k].bb == i
+					&& load->quad < basic[k].quad
+					&& basic[k].quad < j) continue;
+
+				scale = (int32_t) scale;
+
+				if (!scale || base == index) continue;
+				if (!ir_iv_invariant(ir_iv, base)) continue;
+
+				ir_iv_derived_t derived = {
+					.basic = k,
+					.scale = scale,
+					.base  = base,
+					.bb    = i,
+					.quad  = j,
+				};
+
+				if (vector_append(&ir_iv->derived, &derived))
+					return -1;
+
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int edit(
+	iv_reduce_t     *reduce,
+	size_t           bb,
+	size_t           pos,
+	iv_edit_where_t  where,
+	ir_quad_t       *quad)
+{
+	ir_iv_t *ir_iv = reduce->ir_iv;
+
+	iv_edit_t iv_edit = {
+		.bb    = bb,
+		.pos   = pos,
+		.where = where,
+		.seq   = reduce->edit.use,
+		.quad  = quad,
+	};
+
+	if (vector_append(&reduce->edit, &iv_edit)) {
+		IR_QUAD_FREE(quad);
+		return IR_ERROR_NOMEM;
+	}
+
+	if (!quad) return 0;
+
+	// so nothing a new quad reads can be pruned from under it
+	ir_quad_reg_t reg;
+
+	IR_QUAD_REG(quad, &reg);
+
+	for (size_t i = 0; i < IR_QUAD_REG_USES; i++)
+		if (reg.use[i] && *reg.use[i] < ir_iv->vregs)
+			++ir_iv->def[*reg.use[i]].uses;
+
+	return 0;
+}
+
+static int group(
+	iv_reduce_t            *reduce,
+	const ir_iv_derived_t  *derived,
+	iv_group_t            **found)
+{
+	ir_iv_t             *ir_iv  = reduce->ir_iv;
+	const ir_iv_basic_t *basic  = (ir_iv_basic_t*) ir_iv->basic.buf
+		+ derived->basic;
+	ir_quad_t           *source = def(ir_iv, derived->base);
+
+	iv_group_t iv_group = {
+		.basic = derived->basic,
+		.scale = derived->scale,
+		.key   = derived->base,
+	};
+
+	// bases loaded from the same untouched cell are the same value
+	if (source && *source == IR_QUAD_LOAD) {
+		ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+			source,
+			ir_quad_load_t);
+
+		if (load->src.type == IR_LOCATION_REG) {
+			iv_group.key  = load->src.reg;
+			iv_group.cell = true;
+		}
+	}
+
+	iv_group_t *iv_groups = reduce->group.buf;
+
+	for (size_t i = 0; i < reduce->group.use; i++) {
+		if (iv_groups[i].basic != iv_group.basic) continue;
+		if (iv_groups[i].scale != iv_group.scale) continue;
+		if (iv_groups[i].key != iv_group.key) continue;
+		if (iv_groups[i].cell != iv_group.cell) continue;
+
+		*found = &iv_groups[i];
+		return 0;
+	}
+
+	ir_location_t cell = {
+		.type = IR_LOCATION_REG,
+		.reg  = basic->cell,
+	};
+	ir_location_t ptr  = {
+		.type = IR_LOCATION_REG,
+	};
+	ir_quad_t *quad;
+	uintptr_t  index;
+	uintptr_t  sum;
+	int        ret;
+
+	iv_group.ptr = reduce->next++;
+	ptr.reg      = iv_group.ptr;
+
+	ret = ir_quad_alloca_gen(&quad, iv_group.ptr, IR_REG_TYPE_PTR);
+	if (ret) return ret;
+
+	ret = edit(reduce, 0, 0, IV_EDIT_BEFORE, quad);
+	if (ret) return ret;
+
+	// base + basic * scale on the way in
+	size_t preheader = ir_iv->ir_loop->preheader;
+
+	ret = materialize(reduce, derived->base, &iv_group.base);
+	if (ret) return ret;
+
+	index = reduce->next++;
+
+	ret = ir_quad_load_gen(&quad, index, IR_REG_TYPE_I32, &cell);
+	if (ret) return ret;
+
+	ret = edit(
+		reduce,
+		preheader,
+		reduce->preheader,
+		IV_EDIT_BEFORE,
+		quad);
+	if (ret) return ret;
+
+	iv_group.step = IR_REG_IMMEDIATE_GEN(derived->scale);
+
+	ret = scaled(reduce, iv_group.base, index, iv_group.step, &sum);
+	if (ret) return ret;
+
+	ret = ir_quad_store_gen(
+		&quad,
+		sum,
+		IR_REG_TYPE_PTR,
+		iv_group.ptr);
+	if (ret) return ret;
+
+	ret = edit(
+		reduce,
+		preheader,
+		reduce->preheader,
+		IV_EDIT_BEFORE,
+		quad);
+	if (ret) return ret;
+
+	// and stepped along with the basic iv
+	int64_t   stride = basic->step * derived->scale;
+	uintptr_t old    = reduce->next++;
+	uintptr_t step   = IR_REG_IMMEDIATE_GEN(stride);
+	uintptr_t new    = reduce->next++;
+
+	ret = ir_quad_load_gen(&quad, old, IR_REG_TYPE_PTR, &ptr);
+	if (ret) return ret;
+
+	ret = edit(reduce, basic->bb, basic->quad, IV_EDIT_AFTER, quad);
+	if (ret) return ret;
+
+	if (!IR_REG_IMMEDIATE_FITS(stride)) {
+		step = reduce->next++;
+
+		ret = ir_quad_mov_gen(
+			&quad,
+			step,
+			IR_REG_TYPE_PTR,
+			(uintptr_t) stride);
+		if (ret) return ret;
+
+		ret = edit(
+			reduce,
+			basic->bb,
+			basic->quad,
+			IV_EDIT_AFTER,
+			quad);
+		if (ret) return ret;
+	}
+
+	ret = ir_quad_binop_gen(
+		&quad,
+		new,
+		IR_QUAD_BINOP_ADD,
+		IR_REG_TYPE_PTR,
+		old,
+		step);
+	if (ret) return ret;
+
+	ret = edit(reduce, basic->bb, basic->quad, IV_EDIT_AFTER, quad);
+	if (ret) return ret;
+
+	ret = ir_quad_store_gen(&quad, new, IR_REG_TYPE_PTR, iv_group.ptr);
+	if (ret) return ret;
+
+	ret = edit(reduce, basic->bb, basic->quad, IV_EDIT_AFTER, quad);
+	if (ret) return ret;
+
+	if (vector_append(&reduce->group, &iv_group)) return IR_ERROR_NOMEM;
+
+	*found = (iv_group_t*) reduce->group.buf + reduce->group.use - 1;
+
+	return 0;
+}
+
+static bool invariant(const ir_iv_t *ir_iv, uintptr_t reg, size_t depth)
+{
+	if (IR_REG_IS_IMMEDIATE(reg)) return true;
+
+	if (reg >= ir_iv->vregs) return false;
+
+	const ir_iv_def_t *ir_iv_def = &ir_iv->def[reg];
+
+	// parameters are defined on entry
+	if (!ir_iv_def->defs) return true;
+	if (ir_iv_def->bb == SIZE_MAX) return false;
+
+	if (!BITSET_TEST(&ir_iv->ir_loop->body, ir_iv_def->bb)) return true;
+
+	if (!depth--) return false;
+
+	ir_quad_t *ir_quad = def(ir_iv, reg);
+
+	// anything inside has to be safe to compute in the preheader
+	switch (*ir_quad) {
+		case IR_QUAD_MOV:
+			return true;
+
+		case IR_QUAD_LOAD: {
+			ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_load_t);
+
+			if (load->src.type != IR_LOCATION_REG) return true;
+
+			uintptr_t cell = load->src.reg;
+
+			if (cell >= ir_iv->vregs) return false;
+			if (!BITSET_TEST(&ir_iv->private, cell)) return false;
+			if (BITSET_TEST(&ir_iv->stored, cell)) return false;
+
+			return invariant(ir_iv, cell, depth);
+		}
+
+		case IR_QUAD_BINOP: {
+			ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_binop_t);
+
+			if (binop->op == IR_QUAD_BINOP_DIV
+				|| binop->op == IR_QUAD_BINOP_MOD) return false;
+
+			return invariant(ir_iv, binop->lhs, depth)
+				&& invariant(ir_iv, binop->rhs, depth);
+		}
+
+		default:
+			return false;
+	}
+}
+
+static int lftr(iv_reduce_t *reduce)
+{
+	ir_iv_t        *ir_iv  = reduce->ir_iv;
+	size_t          header = ir_iv->ir_loop->header;
+	ir_bb_t        *ir_bb  = ((ir_bb_t**)
+		ir_iv->ir_function->bb.buf)[header];
+	ir_quad_t     **quad   = ir_bb->quad.buf;
+	size_t          pos    = ir_bb->quad.use;
+
+	// the exit test ends the header
+	while (pos && *quad[pos - 1] == IR_QUAD_BR) {
+		ir_quad_br_condition_t condition = OFFSETOF_IR_QUAD(
+			quad[pos - 1],
+			ir_quad_br_t)->condition;
+
+		switch (condition) {
+			case IR_QUAD_BR_EQ:
+			case IR_QUAD_BR_NE:
+			case IR_QUAD_BR_GE:
+			case IR_QUAD_BR_LT:
+			case IR_QUAD_BR_GT:
+			case IR_QUAD_BR_LE:
+			case IR_QUAD_BR_AL:
+			case IR_QUAD_BR_NV:
+				break;
+
+			// a pointer has no meaningful sign or overflow
+			default:
+				return 0;
+		}
+
+		--pos;
+	}
+
+	if (!pos-- || *quad[pos] != IR_QUAD_CMP) return 0;
+
+	ir_quad_cmp_t *cmp = OFFSETOF_IR_QUAD(quad[pos], ir_quad_cmp_t);
+
+	for (size_t side = 0; side < 2; side++) {
+		uintptr_t  reg   = (side) ? cmp->rhs : cmp->lhs;
+		uintptr_t  limit = (side) ? cmp->lhs : cmp->rhs;
+		size_t     k     = ir_iv_lookup(ir_iv, reg);
+
+		if (k == SIZE_MAX) continue;
+
+		const ir_iv_basic_t *basic = (ir_iv_basic_t*) ir_iv->basic.buf
+			+ k;
+		const ir_iv_def_t   *load  = &ir_iv->def[reg];
+
+		if (load->bb != header) continue;
+
+		if (basic->bb == header
+			&& load->quad < basic->quad
+			&& basic->quad < pos) continue;
+
+		if (!ir_iv_invariant(ir_iv, limit)) continue;
+
+		// scaling by something positive keeps the order
+		iv_group_t *iv_group = reduce->group.buf;
+		size_t      i        = 0;
+
+		while (i < reduce->group.use
+			&& (iv_group[i].basic != k || iv_group[i].scale < 0))
+			++i;
+
+		if (i == reduce->group.use) continue;
+
+		ir_location_t ptr = {
+			.type = IR_LOCATION_REG,
+			.reg  = iv_group[i].ptr,
+		};
+		ir_quad_t *ir_quad;
+		uintptr_t  bound;
+		uintptr_t  current;
+		uintptr_t  end;
+		int        ret;
+
+		ret = materialize(reduce, limit, &bound);
+		if (ret) return ret;
+
+		ret = scaled(
+			reduce,
+			iv_group[i].base,
+			bound,
+			iv_group[i].step,
+			&end);
+		if (ret) return ret;
+
+		current = reduce->next++;
+
+		ret = ir_quad_load_gen(
+			&ir_quad,
+			current,
+			IR_REG_TYPE_PTR,
+			&ptr);
+		if (ret) return ret;
+
+		ret = edit(reduce, header, pos, IV_EDIT_BEFORE, ir_quad);
+		if (ret) return ret;
+
+		ret = ir_quad_cmp_gen(
+			&ir_quad,
+			(side) ? end : current,
+			(side) ? current : end);
+		if (ret) return ret;
+
+		ret = edit(reduce, header, pos, IV_EDIT_REPLACE, ir_quad);
+		if (ret) return ret;
+
+		ret = prune(reduce, reg);
+		if (ret) return ret;
+
+		ret = prune(reduce, limit);
+		if (ret) return ret;
+
+		// the basic iv itself may now only be feeding its own step
+		if (loaded(reduce, basic)) return 0;
+		if (live(reduce, basic->cell)) return 0;
+
+		ir_bb_t **bbs = ir_iv->ir_function->bb.buf;
+
+		ir_quad_store_t *store = OFFSETOF_IR_QUAD(
+			((ir_quad_t**) bbs[basic->bb]->quad.buf)[basic->quad],
+			ir_quad_store_t);
+
+		ret = edit(
+			reduce,
+			basic->bb,
+			basic->quad,
+			IV_EDIT_REPLACE,
+			NULL);
+		if (ret) return ret;
+
+		return prune(reduce, store->src);
+	}
+
+	return 0;
+}
+
+static bool loaded(iv_reduce_t *reduce, const ir_iv_basic_t *basic)
+{
+	const ir_iv_t  *ir_iv = reduce->ir_iv;
+	ir_bb_t       **ir_bb = ir_iv->ir_function->bb.buf;
+
+	for (size_t i = 0; i < ir_iv->ir_function->bb.use; i++) {
+		if (!BITSET_TEST(&ir_iv->ir_loop->body, i)) continue;
+
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_LOAD) continue;
+			if (i == basic->bb && j == basic->load) continue;
+
+			ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_load_t);
+
+			if (load->src.type != IR_LOCATION_REG) continue;
+			if (load->src.reg != basic->cell) continue;
+			if (BITSET_TEST(&reduce->dead, load->dst)) continue;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool live(iv_reduce_t *reduce, uintptr_t cell)
+{
+	const ir_cfg_t  *ir_cfg  = reduce->ir_cfg;
+	const ir_loop_t *ir_loop = reduce->ir_iv->ir_loop;
+	ir_bb_t        **ir_bb   = reduce->ir_iv->ir_function->bb.buf;
+	bitset_t         seen;
+	bool             found   = true;
+
+	if (bitset_init(&seen, ir_cfg->bbs + 1)) return true;
+
+	size_t *stack = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_LOOP,
+		(ir_cfg->bbs + 1) * sizeof(*stack));
+	if (!stack) goto error_alloc_stack;
+
+	size_t depth = 0;
+
+	for (size_t i = 0; i < ir_cfg->bbs; i++) {
+		if (!BITSET_TEST(&ir_loop->body, i)) continue;
+
+		size_t *succ = ir_cfg->succ[i].buf;
+
+		for (size_t j = 0; j < ir_cfg->succ[i].use; j++) {
+			if (BITSET_TEST(&ir_loop->body, succ[j])) continue;
+			if (BITSET_TEST(&seen, succ[j])) continue;
+
+			BITSET_SET(&seen, succ[j]);
+			stack[depth++] = succ[j];
+		}
+	}
+
+	// read on some path out before being written again, where
+	// coming back around to the preheader counts as a read
+	while (depth) {
+		size_t      bb   = stack[--depth];
+		ir_quad_t **quad = ir_bb[bb]->quad.buf;
+		bool        kill = false;
+
+		if (bb == ir_loop->preheader) goto done;
+		if (BITSET_TEST(&ir_loop->body, bb)) goto done;
+
+		for (size_t i = 0; i < ir_bb[bb]->quad.use && !kill; i++) {
+			if (*quad[i] == IR_QUAD_LOAD) {
+				ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+					quad[i],
+					ir_quad_load_t);
+
+				if (load->src.type == IR_LOCATION_REG
+					&& load->src.reg == cell) goto done;
+			}
+
+			if (*quad[i] == IR_QUAD_STORE)
+				kill = OFFSETOF_IR_QUAD(
+					quad[i],
+					ir_quad_store_t)->dst == cell;
+		}
+
+		if (kill) continue;
+
+		size_t *succ = ir_cfg->succ[bb].buf;
+
+		for (size_t j = 0; j < ir_cfg->succ[bb].use; j++) {
+			if (BITSET_TEST(&seen, succ[j])) continue;
+
+			BITSET_SET(&seen, succ[j]);
+			stack[depth++] = succ[j];
+		}
+	}
+
+	found = false;
+
+done:
+	MEM_FREE(stack);
+
+error_alloc_stack:
+	bitset_free(&seen);
+
+	return found;
+}
+
+static size_t lookup(const ir_function_t *ir_function, size_t id)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++)
+		if (ir_bb[i]->id == id) return i;
+
+	return SIZE_MAX;
+}
+
+static int materialize(iv_reduce_t *reduce, uintptr_t reg, uintptr_t *dst)
+{
+	ir_iv_t           *ir_iv     = reduce->ir_iv;
+	const ir_iv_def_t *ir_iv_def = &ir_iv->def[reg];
+
+	*dst = reg;
+
+	// already available in the preheader
+	if (reg >= ir_iv->vregs || ir_iv_def->bb == SIZE_MAX) return 0;
+	if (!BITSET_TEST(&ir_iv->ir_loop->body, ir_iv_def->bb)) return 0;
+
+	ir_quad_t     *clone;
+	ir_quad_reg_t  clone_reg;
+
+	int ret = IR_QUAD_CLONE(&clone, def(ir_iv, reg));
+	if (ret) return ret;
+
+	IR_QUAD_REG(clone, &clone_reg);
+
+	for (size_t i = 0; i < IR_QUAD_REG_USES; i++) {
+		if (!clone_reg.use[i]) continue;
+
+		ret = materialize(reduce, *clone_reg.use[i], clone_reg.use[i]);
+		if (ret) goto error;
+	}
+
+	*clone_reg.def = reduce->next++;
+	*dst           = *clone_reg.def;
+
+	return edit(
+		reduce,
+		ir_iv->ir_loop->preheader,
+		reduce->preheader,
+		IV_EDIT_BEFORE,
+		clone);
+
+error:
+	IR_QUAD_FREE(clone);
+
+	return ret;
+}
+
+static ir_quad_br_condition_t negate(ir_quad_br_condition_t condition)
+{
+	switch (condition) {
+		case IR_QUAD_BR_EQ:
+			return IR_QUAD_BR_NE;
+
+		case IR_QUAD_BR_NE:
+			return IR_QUAD_BR_EQ;
+
+		case IR_QUAD_BR_GE:
+			return IR_QUAD_BR_LT;
+
+		case IR_QUAD_BR_LT:
+			return IR_QUAD_BR_GE;
+
+		case IR_QUAD_BR_GT:
+			return IR_QUAD_BR_LE;
+
+		case IR_QUAD_BR_LE:
+			return IR_QUAD_BR_GT;
+
+		default:
+			return IR_QUAD_BR_NV;
+	}
+}
+
+static int prune(iv_reduce_t *reduce, uintptr_t reg)
+{
+	ir_iv_t *ir_iv = reduce->ir_iv;
+
+	if (reg >= ir_iv->vregs) return 0;
+
+	ir_iv_def_t *ir_iv_def = &ir_iv->def[reg];
+
+	if (!ir_iv_def->uses || --ir_iv_def->uses) return 0;
+	if (BITSET_TEST(&reduce->dead, reg)) return 0;
+
+	ir_quad_t *ir_quad = def(ir_iv, reg);
+	if (!ir_quad) return 0;
+
+	// already rewritten into something else
+	iv_edit_t *iv_edit = reduce->edit.buf;
+
+	for (size_t i = 0; i < reduce->edit.use; i++)
+		if (iv_edit[i].where == IV_EDIT_REPLACE
+			&& iv_edit[i].bb == ir_iv_def->bb
+			&& iv_edit[i].pos == ir_iv_def->quad) return 0;
+
+	// the same quads dead quad elimination would drop
+	switch (*ir_quad) {
+		case IR_QUAD_LOAD:
+		case IR_QUAD_MOV:
+			break;
+
+		case IR_QUAD_BINOP: {
+			ir_quad_binop_op_t op = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_binop_t)->op;
+
+			if (op == IR_QUAD_BINOP_DIV || op == IR_QUAD_BINOP_MOD)
+				return 0;
+
+			break;
+		}
+
+		default:
+			return 0;
+	}
+
+	BITSET_SET(&reduce->dead, reg);
+
+	int ret = edit(
+		reduce,
+		ir_iv_def->bb,
+		ir_iv_def->quad,
+		IV_EDIT_REPLACE,
+		NULL);
+	if (ret) return ret;
+
+	ir_quad_reg_t operand;
+
+	IR_QUAD_REG(ir_quad, &operand);
+
+	for (size_t i = 0; i < IR_QUAD_REG_USES; i++) {
+		if (!operand.use[i]) continue;
+
+		ret = prune(reduce, *operand.use[i]);
+		if (ret) return ret;
+	}
+
+	return 0;
+}
+
+static int rewrite(
+	ir_function_t   *ir_function,
+	const ir_cfg_t  *ir_cfg,
+	const ir_loop_t *ir_loop)
+{
+	ir_iv_t ir_iv;
+
+	int ret = ir_iv_init(&ir_iv, ir_function, ir_loop);
+	if (ret) return ret;
+
+	if (!ir_iv.derived.use) goto done;
+
+	ir_bb_t    *preheader = ((ir_bb_t**)
+		ir_function->bb.buf)[ir_loop->preheader];
+	ir_quad_t **quad      = preheader->quad.buf;
+
+	iv_reduce_t reduce = {
+		.ir_iv     = &ir_iv,
+		.ir_cfg    = ir_cfg,
+		.next      = ir_iv.vregs,
+		.preheader = preheader->quad.use,
+	};
+
+	// ahead of however the preheader gets to the header
+	while (reduce.preheader
+		&& (*quad[reduce.preheader - 1] == IR_QUAD_BR
+		|| *quad[reduce.preheader - 1] == IR_QUAD_CMP))
+		--reduce.preheader;
+
+	ret = IR_ERROR_NOMEM;
+
+	if (vector_init(&reduce.edit, sizeof(iv_edit_t), 0)) goto done;
+
+	if (vector_init(&reduce.group, sizeof(iv_group_t), 0))
+		goto error_vector_init_group;
+
+	if (bitset_init(&reduce.dead, ir_iv.vregs + 1))
+		goto error_bitset_init_dead;
+
+	ir_iv_derived_t *derived = ir_iv.derived.buf;
+
+	for (size_t i = 0; i < ir_iv.derived.use; i++) {
+		iv_group_t *iv_group;
+		ir_quad_t  *ir_quad;
+
+		ret = group(&reduce, &derived[i], &iv_group);
+		if (ret) goto error;
+
+		ir_quad_binop_t *add = OFFSETOF_IR_QUAD(
+			((ir_quad_t**) ((ir_bb_t**) ir_function->bb.buf)
+				[derived[i].bb]->quad.buf)[derived[i].quad],
+			ir_quad_binop_t);
+
+		ir_location_t ptr = {
+			.type = IR_LOCATION_REG,
+			.reg  = iv_group->ptr,
+		};
+
+		ret = ir_quad_load_gen(
+			&ir_quad,
+			add->dst,
+			IR_REG_TYPE_PTR,
+			&ptr);
+		if (ret) goto error;
+
+		ret = edit(
+			&reduce,
+			derived[i].bb,
+			derived[i].quad,
+			IV_EDIT_REPLACE,
+			ir_quad);
+		if (ret) goto error;
+
+		ret = prune(&reduce, add->lhs);
+		if (ret) goto error;
+
+		ret = prune(&reduce, add->rhs);
+		if (ret) goto error;
+	}
+
+	ret = lftr(&reduce);
+	if (ret) goto error;
+
+	ret = apply(&reduce);
+
+error:
+	// whatever was not applied is still ours
+	for (size_t i = 0; i < reduce.edit.use; i++)
+		IR_QUAD_FREE(((iv_edit_t*) reduce.edit.buf)[i].quad);
+
+	bitset_free(&reduce.dead);
+
+error_bitset_init_dead:
+	vector_free(&reduce.group);
+
+error_vector_init_group:
+	vector_free(&reduce.edit);
+
+done:
+	ir_iv_free(&ir_iv);
+
+	return ret;
+}
+
+static int scaled(
+	iv_reduce_t *reduce,
+	uintptr_t    base,
+	uintptr_t    index,
+	uintptr_t    step,
+	uintptr_t   *dst)
+{
+	ir_iv_t   *ir_iv  = reduce->ir_iv;
+	size_t     bb     = ir_iv->ir_loop->preheader;
+	uintptr_t  offset = reduce->next++;
+	ir_quad_t *quad;
+	int        ret;
+
+	// in 64 bits, so the pointer never wraps where the index would
+	ret = ir_quad_binop_gen(
+		&quad,
+		offset,
+		IR_QUAD_BINOP_MUL,
+		IR_REG_TYPE_PTR,
+		index,
+		step);
+	if (ret) return ret;
+
+	ret = edit(reduce, bb, reduce->preheader, IV_EDIT_BEFORE, quad);
+	if (ret) return ret;
+
+	*dst = reduce->next++;
+
+	ret = ir_quad_binop_gen(
+		&quad,
+		*dst,
+		IR_QUAD_BINOP_ADD,
+		IR_REG_TYPE_PTR,
+		base,
+		offset);
+	if (ret) return ret;
+
+	return edit(reduce, bb, reduce->preheader, IV_EDIT_BEFORE, quad);
+}
+
+static ir_quad_br_condition_t swap(ir_quad_br_condition_t condition)
+{
+	switch (condition) {
+		case IR_QUAD_BR_GE:
+			return IR_QUAD_BR_LE;
+
+		case IR_QUAD_BR_LT:
+			return IR_QUAD_BR_GT;
+
+		case IR_QUAD_BR_GT:
+			return IR_QUAD_BR_LT;
+
+		case IR_QUAD_BR_LE:
+			return IR_QUAD_BR_GE;
+
+		default:
+			return condition;
+	}
+}
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * jit.c -- in-memory x86-64 loader
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/jit.h>
+#include <jkcc/private/jit.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef JIT_HOST
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  /* JIT_HOST */
+
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+
+
+void ir_jit_free(ir_jit_t *ir_jit)
+{
+	if (!ir_jit) return;
+
+#ifdef JIT_HOST
+	if (ir_jit->mem) munmap(ir_jit->mem, ir_jit->size);
+	if (ir_jit->dl) dlclose(ir_jit->dl);
+#endif  /* JIT_HOST */
+
+	ir_jit->mem = NULL;
+	ir_jit->dl  = NULL;
+}
+
+int ir_jit_init(ir_jit_t *ir_jit, ir_codegen_t *ir_codegen)
+{
+	*ir_jit = (ir_jit_t) {
+		.ir_codegen = ir_codegen,
+	};
+
+#ifndef JIT_HOST
+	return IR_ERROR_UNSUPPORTED_HOST;
+#else
+	size_t page    = sysconf(_SC_PAGESIZE);
+	size_t symbols = ir_codegen->symbol.use;
+	size_t code    = ir_codegen->text.use;
+
+	// stubs are kept within rel32 reach of every call
+	code += IR_JIT_STUB - code % IR_JIT_STUB;
+
+	size_t text   = code + symbols * IR_JIT_STUB;
+	size_t rodata = ir_codegen->rodata_size;
+	size_t bss    = ir_codegen->bss_size + 1;
+
+	text   += page - 1;
+	text   -= text % page;
+	rodata += page - 1;
+	rodata -= rodata % page;
+	bss    += page - 1;
+	bss    -= bss % page;
+
+	ir_jit->size = text + rodata + bss;
+	ir_jit->mem  = mmap(
+		NULL,
+		ir_jit->size,
+		PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS,
+		-1,
+		0);
+
+	if (ir_jit->mem == MAP_FAILED) {
+		ir_jit->mem = NULL;
+		return IR_ERROR_NOMEM;
+	}
+
+	ir_jit->text   = ir_jit->mem;
+	ir_jit->stub   = ir_jit->mem + code;
+	ir_jit->rodata = ir_jit->mem + text;
+	ir_jit->bss    = ir_jit->mem + text + rodata;
+
+	memcpy(ir_jit->text, ir_codegen->text.buf, ir_codegen->text.use);
+	memcpy(ir_jit->rodata, ir_codegen->rodata, ir_codegen->rodata_size);
+
+	int ret = IR_ERROR_NOMEM;
+
+	uintptr_t *address = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_JIT,
+		symbols + 1,
+		sizeof(*address));
+	if (!address) goto error;
+
+	ret = relocate(ir_jit, address);
+	if (ret) goto error;
+
+	ret = IR_ERROR_NOMEM;
+	if (mprotect(ir_jit->mem, text, PROT_READ | PROT_EXEC)) goto error;
+	if (mprotect(ir_jit->rodata, rodata, PROT_READ)) goto error;
+
+	MEM_FREE(address);
+
+	return 0;
+
+error:
+	MEM_FREE(address);
+	ir_jit_free(ir_jit);
+
+	return ret;
+#endif  /* JIT_HOST */
+}
+
+int ir_jit_run(ir_jit_t *ir_jit, const char *name, int64_t *ret)
+{
+	ir_codegen_symbol_t *symbol = ir_codegen_lookup(
+		ir_jit->ir_codegen,
+		name);
+
+	if (!symbol || symbol->section != IR_CODEGEN_SECTION_TEXT) {
+		ir_jit->undefined = name;
+		return IR_ERROR_UNDEFINED_SYMBOL;
+	}
+
+#ifndef JIT_HOST
+	(void) ret;
+
+	return IR_ERROR_UNSUPPORTED_HOST;
+#else
+	uint8_t *addr = ir_jit->text + symbol->offset;
+	int    (*entry)(void);
+
+	// iso c has no cast from an object to a function pointer
+	memcpy(&entry, &addr, sizeof(entry));
+
+	*ret = entry();
+
+	return 0;
+#endif  /* JIT_HOST */
+}
+
+
+#ifdef JIT_HOST
+static int relocate(ir_jit_t *ir_jit, uintptr_t *address)
+{
+	ir_codegen_reloc_t *reloc = ir_jit->ir_codegen->reloc.buf;
+
+	for (size_t i = 0; i < ir_jit->ir_codegen->reloc.use; i++) {
+		size_t symbol = reloc[i].symbol;
+
+		if (!address[symbol]) {
+			int ret = resolve(ir_jit, symbol, address);
+			if (ret) return ret;
+		}
+
+		uint8_t *pos = ir_jit->text + reloc[i].offset;
+		int32_t  rel = address[symbol] + reloc[i].addend
+			- (uintptr_t) pos;
+
+		memcpy(pos, &rel, sizeof(rel));
+	}
+
+	return 0;
+}
+
+static int resolve(ir_jit_t *ir_jit, size_t symbol, uintptr_t *address)
+{
+	ir_codegen_symbol_t *sym = ir_jit->ir_codegen->symbol.buf;
+
+	switch (sym[symbol].section) {
+		case IR_CODEGEN_SECTION_TEXT:
+			address[symbol] = (uintptr_t) (ir_jit->text
+				+ sym[symbol].offset);
+			return 0;
+
+		case IR_CODEGEN_SECTION_RODATA:
+			address[symbol] = (uintptr_t) (ir_jit->rodata
+				+ sym[symbol].offset);
+			return 0;
+
+		case IR_CODEGEN_SECTION_BSS:
+			address[symbol] = (uintptr_t) (ir_jit->bss
+				+ sym[symbol].offset);
+			return 0;
+
+		default:
+			break;
+	}
+
+	if (!ir_jit->dl) ir_jit->dl = dlopen(NULL, RTLD_LAZY);
+
+	void *target = (ir_jit->dl && sym[symbol].name)
+		? dlsym(ir_jit->dl, sym[symbol].name)
+		: NULL;
+
+	if (!target) {
+		ir_jit->undefined = sym[symbol].name;
+		return IR_ERROR_UNDEFINED_SYMBOL;
+	}
+
+	// shared objects are mapped far outside of rel32 reach
+	uint8_t *pos = ir_jit->stub + ir_jit->stubs++ * IR_JIT_STUB;
+
+	stub(pos, (uintptr_t) target);
+
+	address[symbol] = (uintptr_t) pos;
+
+	return 0;
+}
+
+static void stub(uint8_t *pos, uintptr_t target)
+{
+	static const uint8_t jmp[] = {0xff, 0x25, 0x00, 0x00, 0x00, 0x00};
+
+	memset(pos, 0xcc, IR_JIT_STUB);
+	memcpy(pos, jmp, sizeof(jmp));
+	memcpy(pos + sizeof(jmp), &target, sizeof(target));
+}
+#endif  /* JIT_HOST */
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * liveness.c -- live virtual registers
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/liveness.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+
+
+void ir_liveness_free(ir_liveness_t *ir_liveness)
+{
+	if (!ir_liveness) return;
+
+	ir_dataflow_free(&ir_liveness->dataflow);
+}
+
+int ir_liveness_init(ir_liveness_t *ir_liveness, const ir_cfg_t *ir_cfg)
+{
+	ir_function_t *ir_function = ir_cfg->ir_function;
+	ir_dataflow_t *dataflow    = &ir_liveness->dataflow;
+
+	ir_liveness->vregs = ir_function_vregs(ir_function);
+
+	int ret = ir_dataflow_init(
+		dataflow,
+		ir_cfg,
+		IR_DATAFLOW_BACKWARD,
+		IR_DATAFLOW_UNION,
+		ir_liveness->vregs);
+	if (ret) return ret;
+
+	// gen holds upward-exposed uses, kill holds defs
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	for (size_t i = 0; i < ir_cfg->bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+
+				uintptr_t use = *reg.use[k];
+
+				if (!BITSET_TEST(&dataflow->kill[i], use))
+					BITSET_SET(&dataflow->gen[i], use);
+			}
+
+			if (reg.def) BITSET_SET(&dataflow->kill[i], *reg.def);
+		}
+	}
+
+	ret = ir_dataflow_solve(dataflow);
+	if (ret) goto error_ir_dataflow_solve;
+
+	return 0;
+
+error_ir_dataflow_solve:
+	ir_dataflow_free(dataflow);
+
+	return ret;
+}
@@ -0,0 +1,252 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * loop.c -- dominators and natural loops
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/loop.h>
+#include <jkcc/private/loop.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+bool ir_loop_dominates(
+	const ir_loop_nest_t *ir_loop_nest,
+	size_t                dominator,
+	size_t                bb)
+{
+	const size_t *idom = ir_loop_nest->idom;
+
+	if (idom[bb] == SIZE_MAX || idom[dominator] == SIZE_MAX) return false;
+
+	// the entry is its own immediate dominator
+	for (;;) {
+		if (bb == dominator) return true;
+		if (bb == idom[bb]) return false;
+
+		bb = idom[bb];
+	}
+}
+
+void ir_loop_nest_free(ir_loop_nest_t *ir_loop_nest)
+{
+	if (!ir_loop_nest) return;
+
+	ir_loop_t *ir_loop = ir_loop_nest->loop.buf;
+
+	for (size_t i = 0; i < ir_loop_nest->loop.use; i++)
+		bitset_free(&ir_loop[i].body);
+
+	vector_free(&ir_loop_nest->loop);
+
+	MEM_FREE(ir_loop_nest->idom);
+
+	ir_loop_nest->idom = NULL;
+}
+
+int ir_loop_nest_init(ir_loop_nest_t *ir_loop_nest, const ir_cfg_t *ir_cfg)
+{
+	*ir_loop_nest = (ir_loop_nest_t) {
+		.ir_cfg = ir_cfg,
+	};
+
+	if (vector_init(&ir_loop_nest->loop, sizeof(ir_loop_t), 0))
+		return IR_ERROR_NOMEM;
+
+	ir_loop_nest->idom = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_LOOP,
+		(ir_cfg->bbs + 1) * sizeof(*ir_loop_nest->idom));
+	if (!ir_loop_nest->idom) goto error;
+
+	dominators(ir_loop_nest);
+
+	// a back edge goes to a bb that dominates where it comes from,
+	// and every back edge to the same header shares one loop
+	for (size_t i = 0; i < ir_cfg->bbs; i++) {
+		size_t     header = ir_cfg->rpo[i];
+		size_t    *pred   = ir_cfg->pred[header].buf;
+		ir_loop_t *found  = NULL;
+
+		if (ir_loop_nest->idom[header] == SIZE_MAX) continue;
+
+		for (size_t j = 0; j < ir_cfg->pred[header].use; j++) {
+			if (!ir_loop_dominates(ir_loop_nest, header, pred[j]))
+				continue;
+
+			if (!found) {
+				ir_loop_t ir_loop = {
+					.header = header,
+				};
+
+				if (bitset_init(&ir_loop.body, ir_cfg->bbs))
+					goto error;
+
+				if (vector_append(
+					&ir_loop_nest->loop,
+					&ir_loop)) {
+					bitset_free(&ir_loop.body);
+					goto error;
+				}
+
+				found = (ir_loop_t*) ir_loop_nest->loop.buf
+					+ ir_loop_nest->loop.use - 1;
+
+				BITSET_SET(&found->body, header);
+				found->bbs = 1;
+			}
+
+			if (body(ir_loop_nest, found, pred[j])) goto error;
+		}
+
+		if (found) preheader(ir_loop_nest, found);
+	}
+
+	// an inner loop is a strict subset of the loops around it
+	qsort(
+		ir_loop_nest->loop.buf,
+		ir_loop_nest->loop.use,
+		sizeof(ir_loop_t),
+		order);
+
+	return 0;
+
+error:
+	ir_loop_nest_free(ir_loop_nest);
+
+	return IR_ERROR_NOMEM;
+}
+
+
+static int body(
+	ir_loop_nest_t *ir_loop_nest,
+	ir_loop_t      *ir_loop,
+	size_t          latch)
+{
+	const ir_cfg_t *ir_cfg = ir_loop_nest->ir_cfg;
+
+	if (BITSET_TEST(&ir_loop->body, latch)) return 0;
+
+	size_t *stack = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_LOOP,
+		(ir_cfg->bbs + 1) * sizeof(*stack));
+	if (!stack) return -1;
+
+	size_t depth = 0;
+
+	BITSET_SET(&ir_loop->body, latch);
+	++ir_loop->bbs;
+	stack[depth++] = latch;
+
+	// everything reaching the latch without passing the header
+	while (depth) {
+		size_t  bb   = stack[--depth];
+		size_t *pred = ir_cfg->pred[bb].buf;
+
+		for (size_t i = 0; i < ir_cfg->pred[bb].use; i++) {
+			if (ir_loop_nest->idom[pred[i]] == SIZE_MAX) continue;
+			if (BITSET_TEST(&ir_loop->body, pred[i])) continue;
+
+			BITSET_SET(&ir_loop->body, pred[i]);
+			++ir_loop->bbs;
+			stack[depth++] = pred[i];
+		}
+	}
+
+	MEM_FREE(stack);
+
+	return 0;
+}
+
+static void dominators(ir_loop_nest_t *ir_loop_nest)
+{
+	const ir_cfg_t *ir_cfg = ir_loop_nest->ir_cfg;
+	size_t         *idom   = ir_loop_nest->idom;
+
+	for (size_t i = 0; i < ir_cfg->bbs; i++) idom[i] = SIZE_MAX;
+
+	if (!ir_cfg->bbs) return;
+
+	idom[0] = 0;
+
+	// cooper, harvey, and kennedy: iterate in reverse postorder,
+	// with the reachable bbs ordered before the rest
+	bool changed;
+	do {
+		changed = false;
+
+		for (size_t i = 1; i < ir_cfg->bbs; i++) {
+			size_t  bb   = ir_cfg->rpo[i];
+			size_t *pred = ir_cfg->pred[bb].buf;
+			size_t  dom  = SIZE_MAX;
+
+			for (size_t j = 0; j < ir_cfg->pred[bb].use; j++) {
+				if (idom[pred[j]] == SIZE_MAX) continue;
+
+				dom = (dom == SIZE_MAX)
+					? pred[j]
+					: intersect(ir_loop_nest, dom, pred[j]);
+			}
+
+			if (dom == SIZE_MAX || idom[bb] == dom) continue;
+
+			idom[bb] = dom;
+			changed  = true;
+		}
+	} while (changed);
+}
+
+static size_t intersect(
+	const ir_loop_nest_t *ir_loop_nest,
+	size_t                lhs,
+	size_t                rhs)
+{
+	const size_t *rpo_index = ir_loop_nest->ir_cfg->rpo_index;
+	const size_t *idom      = ir_loop_nest->idom;
+
+	while (lhs != rhs) {
+		while (rpo_index[lhs] > rpo_index[rhs]) lhs = idom[lhs];
+		while (rpo_index[rhs] > rpo_index[lhs]) rhs = idom[rhs];
+	}
+
+	return lhs;
+}
+
+static int order(const void *lhs, const void *rhs)
+{
+	size_t l = ((const ir_loop_t*) lhs)->bbs;
+	size_t r = ((const ir_loop_t*) rhs)->bbs;
+
+	return (l > r) - (l < r);
+}
+
+static void preheader(ir_loop_nest_t *ir_loop_nest, ir_loop_t *ir_loop)
+{
+	const ir_cfg_t *ir_cfg = ir_loop_nest->ir_cfg;
+	size_t         *pred   = ir_cfg->pred[ir_loop->header].buf;
+	size_t          found  = SIZE_MAX;
+
+	ir_loop->preheader = SIZE_MAX;
+
+	// the only way in, and going nowhere else
+	for (size_t i = 0; i < ir_cfg->pred[ir_loop->header].use; i++) {
+		if (BITSET_TEST(&ir_loop->body, pred[i])) continue;
+
+		if (found != SIZE_MAX) return;
+
+		found = pred[i];
+	}
+
+	if (found == SIZE_MAX || ir_cfg->succ[found].use != 1) return;
+
+	ir_loop->preheader = found;
+}
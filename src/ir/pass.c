@@ -0,0 +1,430 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * pass.c -- ir pass manager
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/pass.h>
+#include <jkcc/private/pass.h>
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/sched.h>
+
+
+const ir_pass_t ir_pass[IR_PASSES_TOTAL] = {
+	[IR_PASS_COPY_PROP] = {
+		.name     = "copy-prop",
+		.kind     = IR_PASS_KIND_FUNCTION,
+		.function = ir_copy_prop_function,
+	},
+	[IR_PASS_DCE] = {
+		.name     = "dce",
+		.kind     = IR_PASS_KIND_FUNCTION,
+		.function = ir_dce_function,
+	},
+	[IR_PASS_DSE] = {
+		.name     = "dse",
+		.kind     = IR_PASS_KIND_FUNCTION,
+		.function = ir_dse_function,
+	},
+	[IR_PASS_GLOBAL_DCE] = {
+		.name     = "global-dce",
+		.kind     = IR_PASS_KIND_UNIT,
+		.unit     = ir_dce_unit,
+	},
+	[IR_PASS_INLINE] = {
+		.name     = "inline",
+		.kind     = IR_PASS_KIND_UNIT,
+		.unit     = ir_inline_unit,
+	},
+	[IR_PASS_INSTCOMBINE] = {
+		.name     = "instcombine",
+		.kind     = IR_PASS_KIND_FUNCTION,
+		.function = ir_instcombine_function,
+	},
+	[IR_PASS_SIMPLIFY_CFG] = {
+		.name     = "simplify-cfg",
+		.kind     = IR_PASS_KIND_FUNCTION,
+		.function = ir_simplify_cfg_function,
+	},
+	[IR_PASS_STRENGTH_REDUCE] = {
+		.name     = "strength-reduce",
+		.kind     = IR_PASS_KIND_FUNCTION,
+		.function = ir_strength_reduce_function,
+	},
+	[IR_PASS_TAIL_CALL] = {
+		.name     = "tail-call",
+		.kind     = IR_PASS_KIND_FUNCTION,
+		.function = ir_tail_call_function,
+	},
+	[IR_PASS_UNROLL] = {
+		.name     = "unroll",
+		.kind     = IR_PASS_KIND_UNIT,
+		.unit     = ir_unroll_unit,
+	},
+	[IR_PASS_VECTORIZE] = {
+		.name     = "vectorize",
+		.kind     = IR_PASS_KIND_UNIT,
+		.unit     = ir_vectorize_unit,
+	},
+};
+
+// IR_PASSES_TOTAL ends a pipeline
+static const ir_pass_id_t level_pipeline[IR_PASS_LEVEL_MAX + 1][
+	IR_PASS_PIPELINE_MAX] = {
+	[0] = {
+		IR_PASSES_TOTAL,
+	},
+	[1] = {
+		IR_PASS_GLOBAL_DCE,
+		IR_PASS_SIMPLIFY_CFG,
+		IR_PASS_DSE,
+		IR_PASS_COPY_PROP,
+		IR_PASS_INSTCOMBINE,
+		IR_PASS_DCE,
+		IR_PASS_SIMPLIFY_CFG,
+		IR_PASSES_TOTAL,
+	},
+	[2] = {
+		IR_PASS_GLOBAL_DCE,
+		IR_PASS_INLINE,
+		IR_PASS_GLOBAL_DCE,
+		IR_PASS_SIMPLIFY_CFG,
+		IR_PASS_STRENGTH_REDUCE,
+		IR_PASS_VECTORIZE,
+		IR_PASS_UNROLL,
+		IR_PASS_DSE,
+		IR_PASS_COPY_PROP,
+		IR_PASS_INSTCOMBINE,
+		IR_PASS_DCE,
+		IR_PASS_SIMPLIFY_CFG,
+		IR_PASS_TAIL_CALL,
+		IR_PASS_SIMPLIFY_CFG,
+		IR_PASSES_TOTAL,
+	},
+};
+
+
+ir_pass_id_t ir_pass_lookup(const char *name)
+{
+	for (size_t i = 0; i < IR_PASSES_TOTAL; i++)
+		if (!strcmp(ir_pass[i].name, name)) return i;
+
+	return IR_PASSES_TOTAL;
+}
+
+void ir_pass_manager_fprint(
+	FILE                    *stream,
+	const ir_pass_manager_t *ir_pass_manager)
+{
+	fprintf(
+		stream,
+		"pass: %-16s %8s %12s %10s %10s\n",
+		"name",
+		"runs",
+		"usec",
+		"quads",
+		"bbs");
+
+	for (size_t i = 0; i < IR_PASSES_TOTAL; i++) {
+		const ir_pass_stat_t *stat = &ir_pass_manager->stat[i];
+
+		if (!stat->runs) continue;
+
+		fprintf(
+			stream,
+			"pass: %-16s %8zu %12.3f %10lld %10lld\n",
+			ir_pass[i].name,
+			stat->runs,
+			stat->ns / 1e3,
+			(long long) stat->quads,
+			(long long) stat->bbs);
+	}
+}
+
+void ir_pass_manager_init(ir_pass_manager_t *ir_pass_manager, unsigned level)
+{
+	*ir_pass_manager = (ir_pass_manager_t) {0};
+
+	if (level > IR_PASS_LEVEL_MAX) level = IR_PASS_LEVEL_MAX;
+
+	const ir_pass_id_t *pipeline = level_pipeline[level];
+
+	while (pipeline[ir_pass_manager->passes] != IR_PASSES_TOTAL) {
+		ir_pass_manager->pipeline[ir_pass_manager->passes]
+			= pipeline[ir_pass_manager->passes];
+
+		++ir_pass_manager->passes;
+	}
+}
+
+int ir_pass_manager_parse(ir_pass_manager_t *ir_pass_manager, const char *list)
+{
+	ir_pass_manager->passes = 0;
+
+	// an empty list runs nothing
+	while (*list) {
+		const char *end = strchr(list, PASS_LIST_SEPARATOR);
+		size_t      len = (end) ? (size_t) (end - list) : strlen(list);
+		char        name[64];
+
+		if (len >= sizeof(name)) return -1;
+
+		memcpy(name, list, len);
+		name[len] = '\0';
+
+		ir_pass_id_t id = ir_pass_lookup(name);
+		if (id == IR_PASSES_TOTAL) return -1;
+
+		if (ir_pass_manager->passes >= IR_PASS_PIPELINE_MAX) return -1;
+
+		ir_pass_manager->pipeline[ir_pass_manager->passes++] = id;
+
+		list += len + !!end;
+	}
+
+	return 0;
+}
+
+int ir_pass_manager_run(ir_pass_manager_t *ir_pass_manager, ir_unit_t *ir_unit)
+{
+	const ir_pass_id_t  *pipeline    = ir_pass_manager->pipeline;
+	size_t               total       = ir_pass_manager->passes;
+	ir_function_t      **ir_function = ir_unit->function.buf;
+
+	// allocated quads name physical registers, not cells, so no
+	// pass sees a unit once it has been through regalloc
+	for (size_t i = 0; i < ir_unit->function.use; i++)
+		if (ir_function[i]->regalloc) return 0;
+
+	for (size_t i = 0; i < total;) {
+		size_t passes = 1;
+		int    ret;
+
+		if (ir_pass[pipeline[i]].kind == IR_PASS_KIND_UNIT) {
+			ret = run_unit(ir_pass_manager, ir_unit, pipeline[i]);
+		} else {
+			// a run of function passes is applied to each
+			// function in turn, so functions need no barrier
+			while (i + passes < total
+				&& ir_pass[pipeline[i + passes]].kind
+					== IR_PASS_KIND_FUNCTION)
+				++passes;
+
+			ret = run_functions(
+				ir_pass_manager,
+				ir_unit,
+				pipeline + i,
+				passes);
+		}
+
+		if (ret) return ret;
+
+		for (size_t j = i; j < i + passes; j++)
+			++ir_pass_manager->stat[pipeline[j]].runs;
+
+		i += passes;
+	}
+
+	return 0;
+}
+
+
+static void count(ir_function_t *ir_function, int64_t *quads, int64_t *bbs)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+
+	*quads = 0;
+	*bbs   = ir_function->bb.use;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++)
+		*quads += ir_bb[i]->quad.use;
+}
+
+static void count_unit(ir_unit_t *ir_unit, int64_t *quads, int64_t *bbs)
+{
+	ir_function_t **ir_function = ir_unit->function.buf;
+
+	*quads = 0;
+	*bbs   = 0;
+
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		int64_t function_quads;
+		int64_t function_bbs;
+
+		count(ir_function[i], &function_quads, &function_bbs);
+
+		*quads += function_quads;
+		*bbs   += function_bbs;
+	}
+}
+
+static uint64_t now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
+
+static int run_function(pass_work_t *work, ir_function_t *ir_function)
+{
+	// threads outside of the pool report into the last row
+	size_t          worker = (work->sched)
+		? sched_worker(work->sched)
+		: 0;
+	ir_pass_stat_t *row    = work->stat[worker];
+
+	for (size_t i = 0; i < work->passes; i++) {
+		ir_pass_id_t    id   = work->pipeline[i];
+		ir_pass_stat_t *stat = &row[id];
+		int64_t         quads[2];
+		int64_t         bbs[2];
+
+		count(ir_function, &quads[0], &bbs[0]);
+
+		uint64_t start = now();
+
+		int ret = ir_pass[id].function(ir_function);
+
+		stat->ns += now() - start;
+
+		if (ret) return ret;
+
+		count(ir_function, &quads[1], &bbs[1]);
+
+		stat->quads += quads[0] - quads[1];
+		stat->bbs   += bbs[0] - bbs[1];
+	}
+
+	return 0;
+}
+
+static int run_functions(
+	ir_pass_manager_t   *ir_pass_manager,
+	ir_unit_t           *ir_unit,
+	const ir_pass_id_t  *pipeline,
+	size_t               passes)
+{
+	sched_t        *sched       = ir_pass_manager->sched;
+	size_t          functions   = ir_unit->function.use;
+	size_t          workers     = (sched) ? sched->workers : 0;
+	ir_function_t **ir_function = ir_unit->function.buf;
+
+	if (!functions) return 0;
+
+	pass_work_t work = {
+		.pipeline = pipeline,
+		.passes   = passes,
+		.sched    = sched,
+	};
+
+	atomic_init(&work.ret, 0);
+
+	int ret = IR_ERROR_NOMEM;
+
+	work.stat = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		workers + 1,
+		sizeof(*work.stat));
+	if (!work.stat) goto error_stat;
+
+	pass_task_t *task = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		functions,
+		sizeof(*task));
+	if (!task) goto error_task;
+
+	sched_group_t group;
+
+	sched_group_init(&group);
+
+	// functions keep their place in the unit, so the order they
+	// finish in never shows in the output
+	for (size_t i = 0; i < functions; i++) {
+		task[i].work        = &work;
+		task[i].ir_function = ir_function[i];
+
+		if (sched) sched_spawn(sched, &group, run_task, &task[i]);
+		else run_task(&task[i]);
+	}
+
+	if (sched) {
+		sched_wait(sched, &group);
+		sched_reset(sched);
+	}
+
+	for (size_t i = 0; i <= workers; i++)
+		for (size_t j = 0; j < IR_PASSES_TOTAL; j++) {
+			ir_pass_stat_t *stat = &ir_pass_manager->stat[j];
+
+			stat->ns    += work.stat[i][j].ns;
+			stat->quads += work.stat[i][j].quads;
+			stat->bbs   += work.stat[i][j].bbs;
+		}
+
+	ret = atomic_load(&work.ret);
+
+	MEM_FREE(task);
+
+error_task:
+	MEM_FREE(work.stat);
+
+error_stat:
+	return ret;
+}
+
+static void run_task(void *arg)
+{
+	pass_task_t *task = arg;
+	pass_work_t *work = task->work;
+
+	// a failed function fails the unit, the rest need not run
+	if (atomic_load_explicit(&work->ret, memory_order_relaxed)) return;
+
+	int ret = run_function(work, task->ir_function);
+
+	if (ret) {
+		int expected = 0;
+
+		atomic_compare_exchange_strong(&work->ret, &expected, ret);
+	}
+}
+
+static int run_unit(
+	ir_pass_manager_t   *ir_pass_manager,
+	ir_unit_t           *ir_unit,
+	ir_pass_id_t         id)
+{
+	ir_pass_stat_t *stat = &ir_pass_manager->stat[id];
+	int64_t         quads[2];
+	int64_t         bbs[2];
+
+	count_unit(ir_unit, &quads[0], &bbs[0]);
+
+	uint64_t start = now();
+
+	int ret = ir_pass[id].unit(ir_unit);
+
+	stat->ns += now() - start;
+
+	if (ret) return ret;
+
+	count_unit(ir_unit, &quads[1], &bbs[1]);
+
+	stat->quads += quads[0] - quads[1];
+	stat->bbs   += bbs[0] - bbs[1];
+
+	return 0;
+}
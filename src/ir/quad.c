@@ -10,6 +10,25 @@
 #include <stdio.h>
 
 
+int (*const ir_quad_clone[IR_QUAD_TOTAL])(
+	ir_quad_t **clone,
+	ir_quad_t  *ir_quad) = {
+	[IR_QUAD_ALLOCA] = ir_quad_alloca_clone,
+	[IR_QUAD_ARG]    = ir_quad_arg_clone,
+	[IR_QUAD_BINOP]  = ir_quad_binop_clone,
+	[IR_QUAD_BR]     = ir_quad_br_clone,
+	[IR_QUAD_CALL]   = ir_quad_call_clone,
+	[IR_QUAD_CMP]    = ir_quad_cmp_clone,
+	[IR_QUAD_LOAD]   = ir_quad_load_clone,
+	[IR_QUAD_MOV]    = ir_quad_mov_clone,
+	[IR_QUAD_RELOAD] = ir_quad_reload_clone,
+	[IR_QUAD_RET]    = ir_quad_ret_clone,
+	[IR_QUAD_SELECT] = ir_quad_select_clone,
+	[IR_QUAD_SPILL]  = ir_quad_spill_clone,
+	[IR_QUAD_STORE]  = ir_quad_store_clone,
+	[IR_QUAD_VECTOR] = ir_quad_vector_clone,
+};
+
 void (*const ir_quad_fprint[IR_QUAD_TOTAL])(
 	FILE      *stream,
 	ir_quad_t *ir_quad) = {
@@ -21,6 +40,83 @@ void (*const ir_quad_fprint[IR_QUAD_TOTAL])(
 	[IR_QUAD_CMP]    = ir_quad_cmp_fprint,
 	[IR_QUAD_LOAD]   = ir_quad_load_fprint,
 	[IR_QUAD_MOV]    = ir_quad_mov_fprint,
+	[IR_QUAD_RELOAD] = ir_quad_reload_fprint,
 	[IR_QUAD_RET]    = ir_quad_ret_fprint,
+	[IR_QUAD_SELECT] = ir_quad_select_fprint,
+	[IR_QUAD_SPILL]  = ir_quad_spill_fprint,
 	[IR_QUAD_STORE]  = ir_quad_store_fprint,
+	[IR_QUAD_VECTOR] = ir_quad_vector_fprint,
+};
+
+void (*const ir_quad_fprint_jsonl[IR_QUAD_TOTAL])(
+	FILE      *stream,
+	ir_quad_t *ir_quad) = {
+	[IR_QUAD_ALLOCA] = ir_quad_alloca_fprint_jsonl,
+	[IR_QUAD_ARG]    = ir_quad_arg_fprint_jsonl,
+	[IR_QUAD_BINOP]  = ir_quad_binop_fprint_jsonl,
+	[IR_QUAD_BR]     = ir_quad_br_fprint_jsonl,
+	[IR_QUAD_CALL]   = ir_quad_call_fprint_jsonl,
+	[IR_QUAD_CMP]    = ir_quad_cmp_fprint_jsonl,
+	[IR_QUAD_LOAD]   = ir_quad_load_fprint_jsonl,
+	[IR_QUAD_MOV]    = ir_quad_mov_fprint_jsonl,
+	[IR_QUAD_RELOAD] = ir_quad_reload_fprint_jsonl,
+	[IR_QUAD_RET]    = ir_quad_ret_fprint_jsonl,
+	[IR_QUAD_SELECT] = ir_quad_select_fprint_jsonl,
+	[IR_QUAD_SPILL]  = ir_quad_spill_fprint_jsonl,
+	[IR_QUAD_STORE]  = ir_quad_store_fprint_jsonl,
+	[IR_QUAD_VECTOR] = ir_quad_vector_fprint_jsonl,
+};
+
+void (*const ir_quad_free[IR_QUAD_TOTAL])(ir_quad_t *ir_quad) = {
+	[IR_QUAD_ALLOCA] = ir_quad_alloca_free,
+	[IR_QUAD_ARG]    = ir_quad_arg_free,
+	[IR_QUAD_BINOP]  = ir_quad_binop_free,
+	[IR_QUAD_BR]     = ir_quad_br_free,
+	[IR_QUAD_CALL]   = ir_quad_call_free,
+	[IR_QUAD_CMP]    = ir_quad_cmp_free,
+	[IR_QUAD_LOAD]   = ir_quad_load_free,
+	[IR_QUAD_MOV]    = ir_quad_mov_free,
+	[IR_QUAD_RELOAD] = ir_quad_reload_free,
+	[IR_QUAD_RET]    = ir_quad_ret_free,
+	[IR_QUAD_SELECT] = ir_quad_select_free,
+	[IR_QUAD_SPILL]  = ir_quad_spill_free,
+	[IR_QUAD_STORE]  = ir_quad_store_free,
+	[IR_QUAD_VECTOR] = ir_quad_vector_free,
+};
+
+
+void (*const ir_quad_reg[IR_QUAD_TOTAL])(
+	ir_quad_t     *ir_quad,
+	ir_quad_reg_t *reg) = {
+	[IR_QUAD_ALLOCA] = ir_quad_alloca_reg,
+	[IR_QUAD_ARG]    = ir_quad_arg_reg,
+	[IR_QUAD_BINOP]  = ir_quad_binop_reg,
+	[IR_QUAD_BR]     = ir_quad_br_reg,
+	[IR_QUAD_CALL]   = ir_quad_call_reg,
+	[IR_QUAD_CMP]    = ir_quad_cmp_reg,
+	[IR_QUAD_LOAD]   = ir_quad_load_reg,
+	[IR_QUAD_MOV]    = ir_quad_mov_reg,
+	[IR_QUAD_RELOAD] = ir_quad_reload_reg,
+	[IR_QUAD_RET]    = ir_quad_ret_reg,
+	[IR_QUAD_SELECT] = ir_quad_select_reg,
+	[IR_QUAD_SPILL]  = ir_quad_spill_reg,
+	[IR_QUAD_STORE]  = ir_quad_store_reg,
+	[IR_QUAD_VECTOR] = ir_quad_vector_reg,
+};
+
+const char *const ir_quad_str[IR_QUAD_TOTAL] = {
+	[IR_QUAD_ALLOCA] = "alloca",
+	[IR_QUAD_ARG]    = "arg",
+	[IR_QUAD_BINOP]  = "binop",
+	[IR_QUAD_BR]     = "br",
+	[IR_QUAD_CALL]   = "call",
+	[IR_QUAD_CMP]    = "cmp",
+	[IR_QUAD_LOAD]   = "load",
+	[IR_QUAD_MOV]    = "mov",
+	[IR_QUAD_RELOAD] = "reload",
+	[IR_QUAD_RET]    = "ret",
+	[IR_QUAD_SELECT] = "select",
+	[IR_QUAD_SPILL]  = "spill",
+	[IR_QUAD_STORE]  = "store",
+	[IR_QUAD_VECTOR] = "vector",
 };
@@ -13,8 +13,14 @@
 
 #include <jkcc/ht.h>
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_alloca_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_alloca_t, IR_QUAD_ALLOCA);
+}
+
 void ir_quad_alloca_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_alloca_t);
@@ -28,12 +34,28 @@ void ir_quad_alloca_fprint(FILE *stream, ir_quad_t *ir_quad)
 	IR_QUAD_FPRINT_FINISH;
 }
 
+void ir_quad_alloca_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_alloca_t);
+
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_UINT("align", quad->align);
+}
+
+void ir_quad_alloca_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_alloca_t);
+
+	MEM_FREE(quad);
+}
+
 int ir_quad_alloca_gen(
 	ir_quad_t    **ir_quad,
 	uintptr_t      dst,
 	ir_reg_type_t  type)
 {
-	IR_QUAD_INIT(ir_quad_alloca_t);
+	IR_QUAD_INIT(ir_quad_alloca_t, IR_QUAD_ALLOCA);
 
 	quad->dst  = dst;
 	quad->type = type;
@@ -43,3 +65,11 @@ int ir_quad_alloca_gen(
 
 	IR_QUAD_RETURN(IR_QUAD_ALLOCA);
 }
+
+void ir_quad_alloca_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_alloca_t);
+
+	reg->def  = &quad->dst;
+	reg->type = IR_REG_TYPE_PTR;
+}
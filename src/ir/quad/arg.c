@@ -11,8 +11,14 @@
 #include <stdio.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_arg_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_arg_t, IR_QUAD_ARG);
+}
+
 void ir_quad_arg_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_arg_t);
@@ -25,13 +31,29 @@ void ir_quad_arg_fprint(FILE *stream, ir_quad_t *ir_quad)
 	IR_QUAD_FPRINT_FINISH;
 }
 
+void ir_quad_arg_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_arg_t);
+
+	IR_FPRINT_JSONL_UINT("pos", quad->pos);
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_REG("src", quad->src);
+}
+
+void ir_quad_arg_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_arg_t);
+
+	MEM_FREE(quad);
+}
+
 int ir_quad_arg_gen(
 	ir_quad_t     **ir_quad,
 	size_t          pos,
 	uintptr_t       src,
 	ir_reg_type_t   type)
 {
-	IR_QUAD_INIT(ir_quad_arg_t);
+	IR_QUAD_INIT(ir_quad_arg_t, IR_QUAD_ARG);
 
 	quad->pos  = pos;
 	quad->src  = src;
@@ -39,3 +61,10 @@ int ir_quad_arg_gen(
 
 	IR_QUAD_RETURN(IR_QUAD_ARG);
 }
+
+void ir_quad_arg_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_arg_t);
+
+	IR_QUAD_REG_IMMEDIATE(0, quad->src);
+}
@@ -12,8 +12,14 @@
 #include <stdio.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_binop_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_binop_t, IR_QUAD_BINOP);
+}
+
 void ir_quad_binop_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_binop_t);
@@ -21,78 +27,112 @@ void ir_quad_binop_fprint(FILE *stream, ir_quad_t *ir_quad)
 	ir_reg_fprint(stream, quad->dst);
 	fprintf(stream, " = ");
 
-	const char *op;
-	switch (quad->op) {
+	fprintf(stream, "%s ", ir_quad_binop_op_str(quad->op));
+	ir_reg_type_fprint(stream, quad->type);
+	fprintf(stream, " ");
+	ir_reg_fprint(stream, quad->lhs);
+	fprintf(stream, ", ");
+	ir_reg_fprint(stream, quad->rhs);
+
+	IR_QUAD_FPRINT_FINISH;
+}
+
+void ir_quad_binop_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_binop_t);
+
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_FIELD("op", ir_quad_binop_op_str(quad->op));
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_REG("lhs", quad->lhs);
+	IR_FPRINT_JSONL_REG("rhs", quad->rhs);
+}
+
+void ir_quad_binop_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_binop_t);
+
+	MEM_FREE(quad);
+}
+
+int ir_quad_binop_gen(
+	ir_quad_t          **ir_quad,
+	uintptr_t            dst,
+	ir_quad_binop_op_t   op,
+	ir_reg_type_t        type,
+	uintptr_t            lhs,
+	uintptr_t            rhs)
+{
+	IR_QUAD_INIT(ir_quad_binop_t, IR_QUAD_BINOP);
+
+	quad->dst  = dst;
+	quad->op   = op;
+	quad->type = type;
+	quad->lhs  = lhs;
+	quad->rhs  = rhs;
+
+	IR_QUAD_RETURN(IR_QUAD_BINOP);
+}
+
+const char *ir_quad_binop_op_str(ir_quad_binop_op_t op)
+{
+	const char *str;
+	switch (op) {
 		case IR_QUAD_BINOP_ADD:
-			op = "add";
+			str = "add";
 			break;
 
 		case IR_QUAD_BINOP_SUB:
-			op = "sub";
+			str = "sub";
 			break;
 
 		case IR_QUAD_BINOP_MUL:
-			op = "mul";
+			str = "mul";
 			break;
 
 		case IR_QUAD_BINOP_DIV:
-			op = "div";
+			str = "div";
 			break;
 
 		case IR_QUAD_BINOP_MOD:
-			op = "mod";
+			str = "mod";
 			break;
 
 		case IR_QUAD_BINOP_AND:
-			op = "and";
+			str = "and";
 			break;
 
 		case IR_QUAD_BINOP_OOR:
-			op = "oor";
+			str = "oor";
 			break;
 
 		case IR_QUAD_BINOP_EOR:
-			op = "eor";
+			str = "eor";
 			break;
 
 		case IR_QUAD_BINOP_LSL:
-			op = "lsl";
+			str = "lsl";
 			break;
 
 		case IR_QUAD_BINOP_LSR:
-			op = "lsr";
+			str = "lsr";
 			break;
 
 		default:
-			op = "(unknown)";
+			str = "(unknown)";
 			break;
 	}
 
-	fprintf(stream, "%s ", op);
-	ir_reg_type_fprint(stream, quad->type);
-	fprintf(stream, " ");
-	ir_reg_fprint(stream, quad->lhs);
-	fprintf(stream, ", ");
-	ir_reg_fprint(stream, quad->rhs);
-
-	IR_QUAD_FPRINT_FINISH;
+	return str;
 }
 
-int ir_quad_binop_gen(
-	ir_quad_t          **ir_quad,
-	uintptr_t            dst,
-	ir_quad_binop_op_t   op,
-	ir_reg_type_t        type,
-	uintptr_t            lhs,
-	uintptr_t            rhs)
+void ir_quad_binop_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
 {
-	IR_QUAD_INIT(ir_quad_binop_t);
+	IR_QUAD_REG_BEGIN(ir_quad_binop_t);
 
-	quad->dst  = dst;
-	quad->op   = op;
-	quad->type = type;
-	quad->lhs  = lhs;
-	quad->rhs  = rhs;
+	reg->def    = &quad->dst;
+	reg->type   = quad->type;
 
-	IR_QUAD_RETURN(IR_QUAD_BINOP);
+	IR_QUAD_REG_IMMEDIATE(0, quad->lhs);
+	IR_QUAD_REG_IMMEDIATE(1, quad->rhs);
 }
@@ -12,97 +12,136 @@
 #include <stdio.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_br_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_br_t, IR_QUAD_BR);
+}
+
 void ir_quad_br_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_br_t);
 
-	const char *condition;
-	switch (quad->condition) {
+	fprintf(
+		stream,
+		"br.%s .L%lu",
+		ir_quad_br_condition_str(quad->condition),
+		quad->bb);
+
+	IR_QUAD_FPRINT_FINISH;
+}
+
+void ir_quad_br_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_br_t);
+
+	IR_FPRINT_JSONL_FIELD(
+		"condition",
+		ir_quad_br_condition_str(quad->condition));
+	IR_FPRINT_JSONL_UINT("bb", quad->bb);
+}
+
+void ir_quad_br_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_br_t);
+
+	MEM_FREE(quad);
+}
+
+int ir_quad_br_gen(
+	ir_quad_t              **ir_quad,
+	ir_quad_br_condition_t   condition,
+	size_t                   bb)
+{
+	IR_QUAD_INIT(ir_quad_br_t, IR_QUAD_BR);
+
+	quad->condition = condition;
+	quad->bb        = bb;
+
+	IR_QUAD_RETURN(IR_QUAD_BR);
+}
+
+const char *ir_quad_br_condition_str(ir_quad_br_condition_t condition)
+{
+	const char *str;
+	switch (condition) {
 		case IR_QUAD_BR_EQ:
-			condition = "eq";
+			str = "eq";
 			break;
 
 		case IR_QUAD_BR_NE:
-			condition = "ne";
+			str = "ne";
 			break;
 
 		case IR_QUAD_BR_HS:
-			condition = "hs";
+			str = "hs";
 			break;
 
 		case IR_QUAD_BR_LO:
-			condition = "lo";
+			str = "lo";
 			break;
 
 		case IR_QUAD_BR_MI:
-			condition = "mi";
+			str = "mi";
 			break;
 
 		case IR_QUAD_BR_PL:
-			condition = "pl";
+			str = "pl";
 			break;
 
 		case IR_QUAD_BR_VS:
-			condition = "vs";
+			str = "vs";
 			break;
 
 		case IR_QUAD_BR_VC:
-			condition = "vc";
+			str = "vc";
 			break;
 
 		case IR_QUAD_BR_HI:
-			condition = "hi";
+			str = "hi";
 			break;
 
 		case IR_QUAD_BR_LS:
-			condition = "ls";
+			str = "ls";
 			break;
 
 		case IR_QUAD_BR_GE:
-			condition = "ge";
+			str = "ge";
 			break;
 
 		case IR_QUAD_BR_LT:
-			condition = "lt";
+			str = "lt";
 			break;
 
 		case IR_QUAD_BR_GT:
-			condition = "gt";
+			str = "gt";
 			break;
 
 		case IR_QUAD_BR_LE:
-			condition = "le";
+			str = "le";
 			break;
 
 		case IR_QUAD_BR_AL:
-			condition = "al";
+			str = "al";
 			break;
 
 		case IR_QUAD_BR_NV:
-			condition = "nv";
+			str = "nv";
 			break;
 
 		default:
-			condition = "(unknown)";
+			str = "(unknown)";
 			break;
 	}
 
-	fprintf(stream, "br.%s .L%lu", condition, quad->bb);
-
-	IR_QUAD_FPRINT_FINISH;
+	return str;
 }
 
-int ir_quad_br_gen(
-	ir_quad_t              **ir_quad,
-	ir_quad_br_condition_t   condition,
-	size_t                   bb)
+void ir_quad_br_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
 {
-	IR_QUAD_INIT(ir_quad_br_t);
+	IR_QUAD_REG_BEGIN(ir_quad_br_t);
 
-	quad->condition = condition;
-	quad->bb        = bb;
-
-	IR_QUAD_RETURN(IR_QUAD_BR);
+	(void) quad;
 }
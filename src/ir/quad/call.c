@@ -8,17 +8,24 @@
 #include <jkcc/ir/ir.h>
 #include <jkcc/private/ir.h>
 
+#include <stdbool.h>
 #include <stdio.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_call_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_call_t, IR_QUAD_CALL);
+}
+
 void ir_quad_call_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_call_t);
 
 	ir_reg_fprint(stream, quad->dst);
-	fprintf(stream, " = call ");
+	fprintf(stream, " = %scall ", (quad->tail) ? "tail " : "");
 	ir_reg_type_fprint(stream, quad->type);
 	fprintf(stream, " ");
 
@@ -47,17 +54,48 @@ void ir_quad_call_fprint(FILE *stream, ir_quad_t *ir_quad)
 	IR_QUAD_FPRINT_FINISH;
 }
 
+void ir_quad_call_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_call_t);
+
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+
+	fprintf(stream, ",\"src\":");
+	ir_location_fprint_jsonl(stream, &quad->src);
+
+	if (quad->tail) fprintf(stream, ",\"tail\":true");
+}
+
+void ir_quad_call_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_call_t);
+
+	MEM_FREE(quad);
+}
+
 int ir_quad_call_gen(
 	ir_quad_t     **ir_quad,
 	uintptr_t       dst,
 	ir_reg_type_t   type,
 	ir_location_t  *src)
 {
-	IR_QUAD_INIT(ir_quad_call_t);
+	IR_QUAD_INIT(ir_quad_call_t, IR_QUAD_CALL);
 
 	quad->dst  =  dst;
 	quad->type =  type;
 	quad->src  = *src;
+	quad->tail =  false;
 
 	IR_QUAD_RETURN(IR_QUAD_CALL);
 }
+
+void ir_quad_call_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_call_t);
+
+	reg->def  = &quad->dst;
+	reg->type = quad->type;
+
+	if (quad->src.type == IR_LOCATION_REG) reg->use[0] = &quad->src.reg;
+}
@@ -12,8 +12,14 @@
 #include <stdio.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_cmp_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_cmp_t, IR_QUAD_CMP);
+}
+
 void ir_quad_cmp_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_cmp_t);
@@ -26,12 +32,35 @@ void ir_quad_cmp_fprint(FILE *stream, ir_quad_t *ir_quad)
 	IR_QUAD_FPRINT_FINISH;
 }
 
+void ir_quad_cmp_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_cmp_t);
+
+	IR_FPRINT_JSONL_REG("lhs", quad->lhs);
+	IR_FPRINT_JSONL_REG("rhs", quad->rhs);
+}
+
+void ir_quad_cmp_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_cmp_t);
+
+	MEM_FREE(quad);
+}
+
 int ir_quad_cmp_gen(ir_quad_t **ir_quad, uintptr_t lhs, uintptr_t rhs)
 {
-	IR_QUAD_INIT(ir_quad_cmp_t);
+	IR_QUAD_INIT(ir_quad_cmp_t, IR_QUAD_CMP);
 
 	quad->lhs = lhs;
 	quad->rhs = rhs;
 
 	IR_QUAD_RETURN(IR_QUAD_CMP);
 }
+
+void ir_quad_cmp_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_cmp_t);
+
+	IR_QUAD_REG_IMMEDIATE(0, quad->lhs);
+	IR_QUAD_REG_IMMEDIATE(1, quad->rhs);
+}
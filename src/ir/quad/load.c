@@ -11,8 +11,14 @@
 #include <stdio.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_load_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_load_t, IR_QUAD_LOAD);
+}
+
 void ir_quad_load_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_load_t);
@@ -52,13 +58,33 @@ void ir_quad_load_fprint(FILE *stream, ir_quad_t *ir_quad)
 	IR_QUAD_FPRINT_FINISH;
 }
 
+void ir_quad_load_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_load_t);
+
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+
+	fprintf(stream, ",\"src\":");
+	ir_location_fprint_jsonl(stream, &quad->src);
+
+	IR_FPRINT_JSONL_UINT("align", quad->align);
+}
+
+void ir_quad_load_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_load_t);
+
+	MEM_FREE(quad);
+}
+
 int ir_quad_load_gen(
 	ir_quad_t     **ir_quad,
 	uintptr_t       dst,
 	ir_reg_type_t   type,
 	ir_location_t  *src)
 {
-	IR_QUAD_INIT(ir_quad_load_t);
+	IR_QUAD_INIT(ir_quad_load_t, IR_QUAD_LOAD);
 
 	quad->dst  =  dst;
 	quad->type =  type;
@@ -69,3 +95,13 @@ int ir_quad_load_gen(
 
 	IR_QUAD_RETURN(IR_QUAD_LOAD);
 }
+
+void ir_quad_load_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_load_t);
+
+	reg->def  = &quad->dst;
+	reg->type = quad->type;
+
+	if (quad->src.type == IR_LOCATION_REG) reg->use[0] = &quad->src.reg;
+}
@@ -12,8 +12,14 @@
 #include <stdio.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_mov_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_mov_t, IR_QUAD_MOV);
+}
+
 void ir_quad_mov_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_mov_t);
@@ -27,13 +33,30 @@ void ir_quad_mov_fprint(FILE *stream, ir_quad_t *ir_quad)
 	IR_QUAD_FPRINT_FINISH;
 }
 
+void ir_quad_mov_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_mov_t);
+
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_UINT("immediate", quad->immediate);
+	IR_FPRINT_JSONL_UINT("align", quad->align);
+}
+
+void ir_quad_mov_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_mov_t);
+
+	MEM_FREE(quad);
+}
+
 int ir_quad_mov_gen(
 	ir_quad_t     **ir_quad,
 	uintptr_t       dst,
 	ir_reg_type_t   type,
 	uintptr_t       immediate)
 {
-	IR_QUAD_INIT(ir_quad_mov_t);
+	IR_QUAD_INIT(ir_quad_mov_t, IR_QUAD_MOV);
 
 	quad->dst       = dst;
 	quad->type      = type;
@@ -44,3 +67,11 @@ int ir_quad_mov_gen(
 
 	IR_QUAD_RETURN(IR_QUAD_MOV);
 }
+
+void ir_quad_mov_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_mov_t);
+
+	reg->def  = &quad->dst;
+	reg->type = quad->type;
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * reload.c -- reload quad
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/quad/reload.h>
+#include <jkcc/ir/ir.h>
+#include <jkcc/private/ir.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+
+
+int ir_quad_reload_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_reload_t, IR_QUAD_RELOAD);
+}
+
+void ir_quad_reload_fprint(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_BEGIN(ir_quad_reload_t);
+
+	ir_reg_fprint(stream, quad->dst);
+	fprintf(stream, " = reload ");
+	ir_reg_type_fprint(stream, quad->type);
+	fprintf(stream, ", slot %lu", quad->slot);
+
+	IR_QUAD_FPRINT_FINISH;
+}
+
+void ir_quad_reload_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_reload_t);
+
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_UINT("slot", quad->slot);
+}
+
+void ir_quad_reload_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_reload_t);
+
+	MEM_FREE(quad);
+}
+
+int ir_quad_reload_gen(
+	ir_quad_t     **ir_quad,
+	uintptr_t       dst,
+	ir_reg_type_t   type,
+	size_t          slot)
+{
+	IR_QUAD_INIT(ir_quad_reload_t, IR_QUAD_RELOAD);
+
+	quad->dst  = dst;
+	quad->type = type;
+	quad->slot = slot;
+
+	IR_QUAD_RETURN(IR_QUAD_RELOAD);
+}
+
+void ir_quad_reload_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_reload_t);
+
+	reg->def  = &quad->dst;
+	reg->type = quad->type;
+}
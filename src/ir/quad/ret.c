@@ -11,8 +11,14 @@
 #include <stdint.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_ret_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_ret_t, IR_QUAD_RET);
+}
+
 void ir_quad_ret_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_ret_t);
@@ -29,15 +35,39 @@ void ir_quad_ret_fprint(FILE *stream, ir_quad_t *ir_quad)
 	IR_QUAD_FPRINT_FINISH;
 }
 
+void ir_quad_ret_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_ret_t);
+
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+
+	if (quad->src == UINTPTR_MAX) fprintf(stream, ",\"src\":null");
+	else IR_FPRINT_JSONL_REG("src", quad->src);
+}
+
+void ir_quad_ret_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_ret_t);
+
+	MEM_FREE(quad);
+}
+
 int ir_quad_ret_gen(
 	ir_quad_t     **ir_quad,
 	ir_reg_type_t   type,
 	uintptr_t       src)
 {
-	IR_QUAD_INIT(ir_quad_ret_t);
+	IR_QUAD_INIT(ir_quad_ret_t, IR_QUAD_RET);
 
 	quad->type = type;
 	quad->src  = src;
 
 	IR_QUAD_RETURN(IR_QUAD_RET);
 }
+
+void ir_quad_ret_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_ret_t);
+
+	if (quad->src != UINTPTR_MAX) IR_QUAD_REG_IMMEDIATE(0, quad->src);
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * select.c -- select quad
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/quad/select.h>
+#include <jkcc/ir/ir.h>
+#include <jkcc/private/ir.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+
+
+int ir_quad_select_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_select_t, IR_QUAD_SELECT);
+}
+
+void ir_quad_select_fprint(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_BEGIN(ir_quad_select_t);
+
+	ir_reg_fprint(stream, quad->dst);
+	fprintf(stream, " = ");
+
+	fprintf(
+		stream,
+		"select.%s ",
+		ir_quad_br_condition_str(quad->condition));
+	ir_reg_type_fprint(stream, quad->type);
+	fprintf(stream, " ");
+	ir_reg_fprint(stream, quad->lhs);
+	fprintf(stream, ", ");
+	ir_reg_fprint(stream, quad->rhs);
+
+	IR_QUAD_FPRINT_FINISH;
+}
+
+void ir_quad_select_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_select_t);
+
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_FIELD(
+		"condition",
+		ir_quad_br_condition_str(quad->condition));
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_REG("lhs", quad->lhs);
+	IR_FPRINT_JSONL_REG("rhs", quad->rhs);
+}
+
+void ir_quad_select_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_select_t);
+
+	MEM_FREE(quad);
+}
+
+int ir_quad_select_gen(
+	ir_quad_t              **ir_quad,
+	uintptr_t                dst,
+	ir_quad_br_condition_t   condition,
+	ir_reg_type_t            type,
+	uintptr_t                lhs,
+	uintptr_t                rhs)
+{
+	IR_QUAD_INIT(ir_quad_select_t, IR_QUAD_SELECT);
+
+	quad->dst       = dst;
+	quad->condition = condition;
+	quad->type      = type;
+	quad->lhs       = lhs;
+	quad->rhs       = rhs;
+
+	IR_QUAD_RETURN(IR_QUAD_SELECT);
+}
+
+void ir_quad_select_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_select_t);
+
+	reg->def  = &quad->dst;
+	reg->type = quad->type;
+
+	IR_QUAD_REG_IMMEDIATE(0, quad->lhs);
+	IR_QUAD_REG_IMMEDIATE(1, quad->rhs);
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * spill.c -- spill quad
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/quad/spill.h>
+#include <jkcc/ir/ir.h>
+#include <jkcc/private/ir.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+
+
+int ir_quad_spill_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_spill_t, IR_QUAD_SPILL);
+}
+
+void ir_quad_spill_fprint(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_BEGIN(ir_quad_spill_t);
+
+	fprintf(stream, "spill ");
+	ir_reg_type_fprint(stream, quad->type);
+	fprintf(stream, " ");
+	ir_reg_fprint(stream, quad->src);
+	fprintf(stream, ", slot %lu", quad->slot);
+
+	IR_QUAD_FPRINT_FINISH;
+}
+
+void ir_quad_spill_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_spill_t);
+
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_REG("src", quad->src);
+	IR_FPRINT_JSONL_UINT("slot", quad->slot);
+}
+
+void ir_quad_spill_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_spill_t);
+
+	MEM_FREE(quad);
+}
+
+int ir_quad_spill_gen(
+	ir_quad_t     **ir_quad,
+	ir_reg_type_t   type,
+	uintptr_t       src,
+	size_t          slot)
+{
+	IR_QUAD_INIT(ir_quad_spill_t, IR_QUAD_SPILL);
+
+	quad->type = type;
+	quad->src  = src;
+	quad->slot = slot;
+
+	IR_QUAD_RETURN(IR_QUAD_SPILL);
+}
+
+void ir_quad_spill_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_spill_t);
+
+	reg->use[0] = &quad->src;
+}
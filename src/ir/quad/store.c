@@ -11,8 +11,14 @@
 #include <stdint.h>
 
 #include <jkcc/ir.h>
+#include <jkcc/mem.h>
 
 
+int ir_quad_store_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_store_t, IR_QUAD_STORE);
+}
+
 void ir_quad_store_fprint(FILE *stream, ir_quad_t *ir_quad)
 {
 	IR_QUAD_FPRINT_BEGIN(ir_quad_store_t);
@@ -31,13 +37,30 @@ void ir_quad_store_fprint(FILE *stream, ir_quad_t *ir_quad)
 	IR_QUAD_FPRINT_FINISH;
 }
 
+void ir_quad_store_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_store_t);
+
+	IR_FPRINT_JSONL_REG("src", quad->src);
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_UINT("align", quad->align);
+}
+
+void ir_quad_store_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_store_t);
+
+	MEM_FREE(quad);
+}
+
 int ir_quad_store_gen(
 	ir_quad_t     **ir_quad,
 	uintptr_t       src,
 	ir_reg_type_t   type,
 	uintptr_t       dst)
 {
-	IR_QUAD_INIT(ir_quad_store_t);
+	IR_QUAD_INIT(ir_quad_store_t, IR_QUAD_STORE);
 
 	quad->src  = src;
 	quad->type = type;
@@ -48,3 +71,12 @@ int ir_quad_store_gen(
 
 	IR_QUAD_RETURN(IR_QUAD_STORE);
 }
+
+void ir_quad_store_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_store_t);
+
+	IR_QUAD_REG_IMMEDIATE(0, quad->src);
+
+	reg->use[1] = &quad->dst;
+}
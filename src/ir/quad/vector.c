@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * vector.c -- vector quad
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/quad/vector.h>
+#include <jkcc/ir/ir.h>
+#include <jkcc/private/ir.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+
+
+int ir_quad_vector_clone(ir_quad_t **clone, ir_quad_t *ir_quad)
+{
+	IR_QUAD_CLONE_COPY(ir_quad_vector_t, IR_QUAD_VECTOR);
+}
+
+void ir_quad_vector_fprint(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_BEGIN(ir_quad_vector_t);
+
+	fprintf(
+		stream,
+		"vector %s <%zu x ",
+		ir_quad_binop_op_str(quad->op),
+		quad->lanes);
+	ir_reg_type_fprint(stream, quad->type);
+	fprintf(stream, "> ");
+	ir_reg_type_fprint(stream, IR_REG_TYPE_PTR);
+	fprintf(stream, " ");
+	ir_reg_fprint(stream, quad->dst);
+	fprintf(stream, ", ");
+	ir_reg_type_fprint(stream, IR_REG_TYPE_PTR);
+	fprintf(stream, " ");
+	ir_reg_fprint(stream, quad->lhs);
+	fprintf(stream, ", ");
+	ir_reg_type_fprint(stream, IR_REG_TYPE_PTR);
+	fprintf(stream, " ");
+	ir_reg_fprint(stream, quad->rhs);
+
+	IR_QUAD_FPRINT_FINISH;
+}
+
+void ir_quad_vector_fprint_jsonl(FILE *stream, ir_quad_t *ir_quad)
+{
+	IR_QUAD_FPRINT_JSONL_BEGIN(ir_quad_vector_t);
+
+	IR_FPRINT_JSONL_FIELD("op", ir_quad_binop_op_str(quad->op));
+	IR_FPRINT_JSONL_FIELD("type", ir_reg_type_str(quad->type));
+	IR_FPRINT_JSONL_UINT("lanes", quad->lanes);
+	IR_FPRINT_JSONL_REG("dst", quad->dst);
+	IR_FPRINT_JSONL_REG("lhs", quad->lhs);
+	IR_FPRINT_JSONL_REG("rhs", quad->rhs);
+}
+
+void ir_quad_vector_free(ir_quad_t *ir_quad)
+{
+	IR_QUAD_FREE_BEGIN(ir_quad_vector_t);
+
+	MEM_FREE(quad);
+}
+
+int ir_quad_vector_gen(
+	ir_quad_t          **ir_quad,
+	ir_quad_binop_op_t   op,
+	ir_reg_type_t        type,
+	size_t               lanes,
+	uintptr_t            dst,
+	uintptr_t            lhs,
+	uintptr_t            rhs)
+{
+	IR_QUAD_INIT(ir_quad_vector_t, IR_QUAD_VECTOR);
+
+	quad->op    = op;
+	quad->type  = type;
+	quad->lanes = lanes;
+	quad->dst   = dst;
+	quad->lhs   = lhs;
+	quad->rhs   = rhs;
+
+	IR_QUAD_RETURN(IR_QUAD_VECTOR);
+}
+
+void ir_quad_vector_reg(ir_quad_t *ir_quad, ir_quad_reg_t *reg)
+{
+	IR_QUAD_REG_BEGIN(ir_quad_vector_t);
+
+	// every operand is an address, nothing is defined
+	reg->use[0] = &quad->dst;
+	reg->use[1] = &quad->lhs;
+	reg->use[2] = &quad->rhs;
+}
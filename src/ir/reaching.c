@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * reaching.c -- reaching definitions
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/reaching.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+void ir_reaching_free(ir_reaching_t *ir_reaching)
+{
+	if (!ir_reaching) return;
+
+	ir_dataflow_free(&ir_reaching->dataflow);
+
+	vector_free(&ir_reaching->def);
+
+	MEM_FREE(ir_reaching->first);
+
+	ir_reaching->first = NULL;
+	ir_reaching->next  = NULL;
+}
+
+int ir_reaching_init(ir_reaching_t *ir_reaching, const ir_cfg_t *ir_cfg)
+{
+	ir_function_t *ir_function = ir_cfg->ir_function;
+	ir_dataflow_t *dataflow    = &ir_reaching->dataflow;
+
+	*ir_reaching = (ir_reaching_t) {
+		.vregs = ir_function_vregs(ir_function),
+	};
+
+	int ret = IR_ERROR_NOMEM;
+
+	if (vector_init(&ir_reaching->def, sizeof(ir_reaching_def_t), 0))
+		return IR_ERROR_NOMEM;
+
+	size_t argc = (ir_function->argv) ? ir_function->argv->use : 0;
+	for (size_t i = 0; ir_cfg->bbs && i < argc; i++) {
+		ir_reaching_def_t def = {
+			.bb   = 0,
+			.quad = IR_REACHING_PARAMETER,
+		};
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(ir_function, i, &def.vreg, &type);
+
+		if (vector_append(&ir_reaching->def, &def))
+			goto error_vector_append_def;
+	}
+
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	for (size_t i = 0; i < ir_cfg->bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			if (!reg.def) continue;
+
+			ir_reaching_def_t def = {
+				.bb   = i,
+				.quad = j,
+				.vreg = *reg.def,
+			};
+
+			if (vector_append(&ir_reaching->def, &def))
+				goto error_vector_append_def;
+		}
+	}
+
+	ir_reaching_def_t *def  = ir_reaching->def.buf;
+	size_t             defs = ir_reaching->def.use;
+
+	// stamp shares the allocation
+	ir_reaching->first = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_DATAFLOW,
+		(ir_reaching->vregs * 2 + defs + 1)
+			* sizeof(*ir_reaching->first));
+	if (!ir_reaching->first) goto error_alloc_first;
+
+	ir_reaching->next = ir_reaching->first + ir_reaching->vregs;
+
+	size_t *stamp = ir_reaching->next + defs;
+
+	for (size_t i = 0; i < ir_reaching->vregs; i++) {
+		ir_reaching->first[i] = SIZE_MAX;
+		stamp[i]              = SIZE_MAX;
+	}
+
+	// chain the defs of every vreg in program order
+	for (size_t i = defs; i-- > 0;) {
+		size_t *first = &ir_reaching->first[def[i].vreg];
+
+		ir_reaching->next[i] = *first;
+		*first               = i;
+	}
+
+	ret = ir_dataflow_init(
+		dataflow,
+		ir_cfg,
+		IR_DATAFLOW_FORWARD,
+		IR_DATAFLOW_UNION,
+		defs);
+	if (ret) goto error_ir_dataflow_init;
+
+	// the last def of a vreg in a bb is generated,
+	// every def of a vreg defined in a bb is killed
+	for (size_t i = defs; i-- > 0;) {
+		size_t bb = def[i].bb;
+
+		if (stamp[def[i].vreg] == bb) continue;
+
+		stamp[def[i].vreg] = bb;
+
+		BITSET_SET(&dataflow->gen[bb], i);
+
+		for (size_t j = ir_reaching->first[def[i].vreg];
+			j != SIZE_MAX;
+			j = ir_reaching->next[j])
+			BITSET_SET(&dataflow->kill[bb], j);
+	}
+
+	ret = ir_dataflow_solve(dataflow);
+	if (ret) goto error_ir_dataflow_solve;
+
+	return 0;
+
+error_ir_dataflow_solve:
+	ir_dataflow_free(dataflow);
+
+error_ir_dataflow_init:
+	MEM_FREE(ir_reaching->first);
+	ir_reaching->first = NULL;
+	ir_reaching->next  = NULL;
+
+error_alloc_first:
+error_vector_append_def:
+	vector_free(&ir_reaching->def);
+
+	return ret;
+}
@@ -0,0 +1,672 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * regalloc.c -- linear-scan register allocation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/regalloc.h>
+#include <jkcc/private/regalloc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+void ir_regalloc_fprint(FILE *stream, ir_function_t *ir_function)
+{
+	ir_regalloc_t *regalloc = ir_function->regalloc;
+
+	if (!regalloc) return;
+
+	fprintf(
+		stream,
+		"\t; regalloc: %zu registers, %zu slots, "
+		"%zu spills, %zu reloads\n",
+		regalloc->registers,
+		regalloc->slots,
+		regalloc->spills,
+		regalloc->reloads);
+}
+
+void ir_regalloc_fprint_jsonl(FILE *stream, ir_function_t *ir_function)
+{
+	ir_regalloc_t *regalloc = ir_function->regalloc;
+
+	if (!regalloc) return;
+
+	fprintf(
+		stream,
+		",\"regalloc\":{\"registers\":%zu,\"slots\":%zu"
+		",\"spills\":%zu,\"reloads\":%zu,\"argv\":[",
+		regalloc->registers,
+		regalloc->slots,
+		regalloc->spills,
+		regalloc->reloads);
+
+	size_t argc = (ir_function->argv) ? ir_function->argv->use : 0;
+	for (size_t i = 0; i < argc; i++) {
+		uintptr_t arg = regalloc->argv[i];
+
+		fprintf(
+			stream,
+			"%s{\"%s\":%lu}",
+			(i) ? "," : "",
+			(arg & IR_REG_PHYSICAL) ? "reg" : "slot",
+			IR_REG_INDEX(arg));
+	}
+
+	fprintf(stream, "]}");
+}
+
+int ir_regalloc_function(ir_function_t *ir_function, size_t registers)
+{
+	// already rewritten
+	if (ir_function->regalloc) return 0;
+
+	regalloc_t regalloc = {
+		.ir_function = ir_function,
+		.argc        = (ir_function->argv) ? ir_function->argv->use : 0,
+		.bbs         = ir_function->bb.use,
+		.scratch     = 1,
+	};
+
+	int ret = ir_cfg_init(&regalloc.ir_cfg, ir_function);
+	if (ret) return ret;
+
+	ret = ir_liveness_init(&regalloc.liveness, &regalloc.ir_cfg);
+	if (ret) goto error_ir_liveness_init;
+
+	ret = analyze(&regalloc);
+	if (ret) goto error_analyze;
+
+	ret = intervals(&regalloc);
+	if (ret) goto error_intervals;
+
+	ret = IR_ERROR_NOMEM;
+
+	regalloc.active = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_REGALLOC,
+		(registers + 1) * sizeof(*regalloc.active));
+	if (!regalloc.active) goto error_alloc_active;
+
+	// free registers are handed out from the top of the pool
+	regalloc.pool = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_REGALLOC,
+		(registers + 1) * sizeof(*regalloc.pool));
+	if (!regalloc.pool) goto error_alloc_pool;
+
+	// any spill reserves the top registers as scratch for operands
+	// that live in memory, as many as the widest quad reads
+	size_t allocatable = registers;
+	if (scan(&regalloc, allocatable)) {
+		if (registers < regalloc.scratch) {
+			ret = IR_ERROR_REGISTER_PRESSURE;
+			goto error_register_pressure;
+		}
+
+		allocatable = registers - regalloc.scratch;
+		scan(&regalloc, allocatable);
+	}
+
+	ir_regalloc_t *result = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_REGALLOC,
+		sizeof(*result) + regalloc.argc * sizeof(*result->argv));
+	if (!result) goto error_alloc_result;
+
+	result->registers = registers;
+	result->slots     = regalloc.slots;
+	result->spills    = 0;
+	result->reloads   = 0;
+
+	for (size_t i = 0; i < regalloc.argc; i++) {
+		uintptr_t     reg;
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(ir_function, i, &reg, &type);
+
+		regalloc_interval_t *interval = &regalloc.interval[reg];
+
+		result->argv[i] = (interval->reg != REGALLOC_NONE)
+			? interval->reg | IR_REG_PHYSICAL
+			: interval->slot;
+	}
+
+	ir_function->regalloc = result;
+
+	ret = rewrite(&regalloc, allocatable);
+
+	context_free(&regalloc);
+
+	return ret;
+
+error_alloc_result:
+error_register_pressure:
+error_alloc_pool:
+error_alloc_active:
+error_intervals:
+error_analyze:
+error_ir_liveness_init:
+	context_free(&regalloc);
+
+	return ret;
+}
+
+int ir_regalloc_unit(ir_unit_t *ir_unit, size_t registers)
+{
+	ir_function_t **ir_function = ir_unit->function.buf;
+
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		int ret = ir_regalloc_function(ir_function[i], registers);
+		if (ret) return ret;
+	}
+
+	return 0;
+}
+
+
+static int analyze(regalloc_t *regalloc)
+{
+	ir_function_t  *ir_function = regalloc->ir_function;
+	ir_bb_t       **ir_bb       = ir_function->bb.buf;
+	size_t          bbs         = regalloc->bbs;
+
+	regalloc->vregs = regalloc->liveness.vregs;
+
+	regalloc->from = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_REGALLOC,
+		bbs * 3 + 1,
+		sizeof(*regalloc->from));
+	if (!regalloc->from) return IR_ERROR_NOMEM;
+
+	regalloc->to      = regalloc->from + bbs;
+	regalloc->pred_to = regalloc->to + bbs;
+
+	regalloc->interval = MEM_CALLOC(
+		MEM_TAG_IR,
+		MEM_IR_REGALLOC,
+		regalloc->vregs + 1,
+		sizeof(*regalloc->interval));
+	if (!regalloc->interval) return IR_ERROR_NOMEM;
+
+	for (size_t i = 0; i < regalloc->vregs; i++) {
+		regalloc->interval[i].vreg  = i;
+		regalloc->interval[i].start = REGALLOC_NONE;
+	}
+
+	// parameters are defined on entry
+	for (size_t i = 0; i < regalloc->argc; i++) {
+		uintptr_t     reg;
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(ir_function, i, &reg, &type);
+
+		regalloc->interval[reg].type  = type;
+		regalloc->interval[reg].start = 1;
+		regalloc->interval[reg].end   = 1;
+	}
+
+	size_t pos = 2;
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		size_t      use  = ir_bb[i]->quad.use;
+
+		regalloc->from[i] = pos;
+
+		for (size_t j = 0; j < use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			pos = REGALLOC_POS(regalloc->from[i], j);
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+
+				// only vector quads read a third operand
+				if (k >= regalloc->scratch)
+					regalloc->scratch = k + 1;
+
+				// both operands can name the same vreg
+				if (k && reg.use[0]
+					&& *reg.use[0] == *reg.use[k]) continue;
+
+				if (interval_use(
+					&regalloc->interval[*reg.use[k]],
+					pos)) return IR_ERROR_NOMEM;
+			}
+
+			if (!reg.def) continue;
+
+			regalloc_interval_t *interval
+				= &regalloc->interval[*reg.def];
+
+			interval->type = reg.type;
+
+			if (interval->start > pos + 1)
+				interval->start = pos + 1;
+
+			if (interval->end < pos + 1)
+				interval->end = pos + 1;
+		}
+
+		regalloc->to[i] = REGALLOC_POS(regalloc->from[i], use) - 1;
+		pos             = regalloc->to[i] + 1;
+	}
+
+	for (size_t i = 0; i < bbs; i++) {
+		size_t *pred = regalloc->ir_cfg.pred[i].buf;
+
+		for (size_t j = 0; j < regalloc->ir_cfg.pred[i].use; j++)
+			if (regalloc->pred_to[i] < regalloc->to[pred[j]])
+				regalloc->pred_to[i] = regalloc->to[pred[j]];
+	}
+
+	return 0;
+}
+
+static void coalesce(regalloc_t *regalloc)
+{
+	ir_bb_t **ir_bb = regalloc->ir_function->bb.buf;
+
+	// a binop result is better off in the register of an lhs that
+	// dies there, leaving codegen nothing to copy between the two
+	for (size_t i = 0; i < regalloc->bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_BINOP) continue;
+
+			const ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_binop_t);
+
+			if (IR_REG_IS_IMMEDIATE(binop->lhs)) continue;
+
+			size_t pos = REGALLOC_POS(regalloc->from[i], j);
+
+			regalloc_interval_t *lhs = &regalloc->interval[
+				binop->lhs];
+			regalloc_interval_t *dst = &regalloc->interval[
+				binop->dst];
+
+			// neither is live on the other's side of the binop
+			if (lhs->end != pos || dst->start != pos + 1) continue;
+
+			dst->hint = lhs;
+		}
+	}
+}
+
+static void context_free(regalloc_t *regalloc)
+{
+	if (regalloc->interval)
+		for (size_t i = 0; i < regalloc->vregs; i++)
+			vector_free(&regalloc->interval[i].use);
+
+	MEM_FREE(regalloc->pool);
+	MEM_FREE(regalloc->active);
+	MEM_FREE(regalloc->sorted);
+	MEM_FREE(regalloc->interval);
+	MEM_FREE(regalloc->from);
+
+	ir_liveness_free(&regalloc->liveness);
+	ir_cfg_free(&regalloc->ir_cfg);
+}
+
+static int emit_reload(
+	regalloc_t          *regalloc,
+	vector_t            *quad,
+	size_t               reg,
+	regalloc_interval_t *interval)
+{
+	ir_quad_t *reload;
+
+	int ret = ir_quad_reload_gen(
+		&reload,
+		reg | IR_REG_PHYSICAL,
+		interval->type,
+		interval->slot);
+	if (ret) return ret;
+
+	if (vector_append(quad, &reload)) {
+		IR_QUAD_FREE(reload);
+		return IR_ERROR_NOMEM;
+	}
+
+	++regalloc->ir_function->regalloc->reloads;
+
+	return 0;
+}
+
+static int emit_spill(
+	regalloc_t          *regalloc,
+	vector_t            *quad,
+	size_t               reg,
+	regalloc_interval_t *interval)
+{
+	ir_quad_t *spill;
+
+	int ret = ir_quad_spill_gen(
+		&spill,
+		interval->type,
+		reg | IR_REG_PHYSICAL,
+		interval->slot);
+	if (ret) return ret;
+
+	if (vector_append(quad, &spill)) {
+		IR_QUAD_FREE(spill);
+		return IR_ERROR_NOMEM;
+	}
+
+	++regalloc->ir_function->regalloc->spills;
+
+	return 0;
+}
+
+static int interval_cmp(const void *a, const void *b)
+{
+	const regalloc_interval_t *lhs = *(regalloc_interval_t**) a;
+	const regalloc_interval_t *rhs = *(regalloc_interval_t**) b;
+
+	if (lhs->start != rhs->start) return (lhs->start < rhs->start) ? -1 : 1;
+
+	// keep vreg order for a stable allocation
+	return (lhs->vreg < rhs->vreg) ? -1 : (lhs->vreg > rhs->vreg);
+}
+
+static int interval_use(regalloc_interval_t *interval, size_t pos)
+{
+	if (!interval->use.buf)
+		if (vector_init(&interval->use, sizeof(pos), 0))
+			return IR_ERROR_NOMEM;
+
+	if (vector_append(&interval->use, &pos)) return IR_ERROR_NOMEM;
+
+	if (interval->start > pos) interval->start = pos;
+	if (interval->end < pos) interval->end = pos;
+
+	return 0;
+}
+
+static int intervals(regalloc_t *regalloc)
+{
+	// extend each interval over the bbs it is live across
+	for (size_t i = 0; i < regalloc->bbs; i++) {
+		bitset_t *live_in  = &regalloc->liveness.dataflow.in[i];
+		bitset_t *live_out = &regalloc->liveness.dataflow.out[i];
+
+		for (size_t j = 0; j < regalloc->vregs; j++) {
+			regalloc_interval_t *interval = &regalloc->interval[j];
+
+			if (BITSET_TEST(live_in, j)
+				&& interval->start > regalloc->from[i])
+				interval->start = regalloc->from[i];
+
+			if (BITSET_TEST(live_out, j)
+				&& interval->end < regalloc->to[i])
+				interval->end = regalloc->to[i];
+		}
+	}
+
+	coalesce(regalloc);
+
+	regalloc->sorted = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_REGALLOC,
+		(regalloc->vregs + 1) * sizeof(*regalloc->sorted));
+	if (!regalloc->sorted) return IR_ERROR_NOMEM;
+
+	for (size_t i = 0; i < regalloc->vregs; i++)
+		if (regalloc->interval[i].start != REGALLOC_NONE)
+			regalloc->sorted[regalloc->intervals++]
+				= &regalloc->interval[i];
+
+	qsort(
+		regalloc->sorted,
+		regalloc->intervals,
+		sizeof(*regalloc->sorted),
+		interval_cmp);
+
+	return 0;
+}
+
+static size_t next_use(regalloc_interval_t *interval, size_t pos)
+{
+	size_t *use = interval->use.buf;
+
+	for (size_t i = 0; i < interval->use.use; i++)
+		if (use[i] >= pos) return use[i];
+
+	return REGALLOC_NONE;
+}
+
+static int rewrite(regalloc_t *regalloc, size_t scratch)
+{
+	for (size_t i = 0; i < regalloc->bbs; i++) {
+		int ret = rewrite_bb(regalloc, i, scratch);
+		if (ret) return ret;
+	}
+
+	return 0;
+}
+
+static int rewrite_bb(regalloc_t *regalloc, size_t bb, size_t scratch)
+{
+	ir_bb_t    *ir_bb = ((ir_bb_t**) regalloc->ir_function->bb.buf)[bb];
+	ir_quad_t **quad  = ir_bb->quad.buf;
+	size_t      from  = regalloc->from[bb];
+
+	vector_t rewritten;
+	if (vector_init(&rewritten, sizeof(ir_quad_t*), ir_bb->quad.use + 1))
+		return IR_ERROR_NOMEM;
+
+	int ret;
+
+	// split parameters keep their incoming value in memory
+	if (!bb) {
+		for (size_t i = 0; i < regalloc->argc; i++) {
+			regalloc_interval_t *interval = &regalloc->interval[i];
+
+			if (interval->reg == REGALLOC_NONE) continue;
+			if (interval->split == REGALLOC_NONE) continue;
+
+			ret = emit_spill(
+				regalloc,
+				&rewritten,
+				interval->reg,
+				interval);
+			if (ret) goto error;
+		}
+	}
+
+	// a branch from past the split point may
+	// have clobbered the register in between
+	bitset_t *live_in = &regalloc->liveness.dataflow.in[bb];
+	for (size_t i = 0; i < regalloc->vregs; i++) {
+		regalloc_interval_t *interval = &regalloc->interval[i];
+
+		if (interval->reg == REGALLOC_NONE) continue;
+		if (interval->split == REGALLOC_NONE) continue;
+		if (!BITSET_TEST(live_in, i)) continue;
+		if (from >= interval->split) continue;
+		if (regalloc->pred_to[bb] < interval->split) continue;
+
+		ret = emit_reload(
+			regalloc,
+			&rewritten,
+			interval->reg,
+			interval);
+		if (ret) goto error;
+	}
+
+	for (size_t i = 0; i < ir_bb->quad.use; i++) {
+		size_t        pos = REGALLOC_POS(from, i);
+		ir_quad_reg_t reg;
+		uintptr_t     vreg[IR_QUAD_REG_USES];
+
+		IR_QUAD_REG(quad[i], &reg);
+
+		for (size_t j = 0; j < IR_QUAD_REG_USES; j++)
+			if (reg.use[j]) vreg[j] = *reg.use[j];
+
+		for (size_t j = 0; j < IR_QUAD_REG_USES; j++) {
+			if (!reg.use[j]) continue;
+
+			regalloc_interval_t *interval
+				= &regalloc->interval[vreg[j]];
+
+			if (interval->reg != REGALLOC_NONE
+				&& pos < interval->split) {
+				*reg.use[j] = interval->reg | IR_REG_PHYSICAL;
+				continue;
+			}
+
+			if (j && reg.use[0] && vreg[0] == vreg[j]) {
+				*reg.use[j] = *reg.use[0];
+				continue;
+			}
+
+			ret = emit_reload(
+				regalloc,
+				&rewritten,
+				scratch + j,
+				interval);
+			if (ret) goto error;
+
+			*reg.use[j] = (scratch + j) | IR_REG_PHYSICAL;
+		}
+
+		if (vector_append(&rewritten, &quad[i])) {
+			ret = IR_ERROR_NOMEM;
+			goto error;
+		}
+
+		if (!reg.def) continue;
+
+		regalloc_interval_t *interval = &regalloc->interval[*reg.def];
+
+		size_t def = scratch;
+		if (interval->reg != REGALLOC_NONE && pos + 1 < interval->split)
+			def = interval->reg;
+
+		*reg.def = def | IR_REG_PHYSICAL;
+
+		if (interval->slot == REGALLOC_NONE) continue;
+
+		ret = emit_spill(regalloc, &rewritten, def, interval);
+		if (ret) goto error;
+	}
+
+	vector_free(&ir_bb->quad);
+	ir_bb->quad = rewritten;
+
+	return 0;
+
+error:
+	// originals are still owned by the bb
+	quad = rewritten.buf;
+	for (size_t i = 0; i < rewritten.use; i++)
+		if (*quad[i] == IR_QUAD_RELOAD || *quad[i] == IR_QUAD_SPILL)
+			IR_QUAD_FREE(quad[i]);
+
+	vector_free(&rewritten);
+
+	return ret;
+}
+
+static size_t scan(regalloc_t *regalloc, size_t registers)
+{
+	size_t active = 0;
+	size_t pool   = 0;
+	size_t spills = 0;
+
+	regalloc->slots = 0;
+
+	for (size_t i = registers; i-- > 0;) regalloc->pool[pool++] = i;
+
+	for (size_t i = 0; i < regalloc->intervals; i++) {
+		regalloc->sorted[i]->reg   = REGALLOC_NONE;
+		regalloc->sorted[i]->split = REGALLOC_NONE;
+		regalloc->sorted[i]->slot  = REGALLOC_NONE;
+	}
+
+	for (size_t i = 0; i < regalloc->intervals; i++) {
+		regalloc_interval_t *current = regalloc->sorted[i];
+
+		// expire
+		for (size_t j = 0; j < active;) {
+			if (regalloc->active[j]->end >= current->start) {
+				++j;
+				continue;
+			}
+
+			regalloc->pool[pool++] = regalloc->active[j]->reg;
+			regalloc->active[j]    = regalloc->active[--active];
+		}
+
+		if (pool) {
+			size_t k = pool - 1;
+
+			// the register a hint just expired out of
+			for (size_t j = 0; current->hint && j < pool; j++)
+				if (regalloc->pool[j] == current->hint->reg)
+					k = j;
+
+			current->reg = regalloc->pool[k];
+
+			for (--pool; k < pool; k++)
+				regalloc->pool[k] = regalloc->pool[k + 1];
+
+			regalloc->active[active++] = current;
+			continue;
+		}
+
+		// evict whichever is needed furthest away
+		regalloc_interval_t *victim   = current;
+		size_t               distance = next_use(victim, victim->start);
+		size_t               slot     = active;
+
+		for (size_t j = 0; j < active; j++) {
+			regalloc_interval_t *candidate = regalloc->active[j];
+
+			size_t use = next_use(candidate, current->start);
+
+			if (use < distance) continue;
+			if (use == distance && candidate->end <= victim->end)
+				continue;
+
+			victim   = candidate;
+			distance = use;
+			slot     = j;
+		}
+
+		victim->slot = regalloc->slots++;
+		++spills;
+
+		if (victim == current) {
+			current->split = current->start;
+			continue;
+		}
+
+		current->reg           = victim->reg;
+		victim->split          = current->start;
+		regalloc->active[slot] = current;
+
+		// never held its register
+		if (victim->split <= victim->start) victim->reg = REGALLOC_NONE;
+	}
+
+	return spills;
+}
@@ -0,0 +1,198 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * simplify.c -- control-flow simplification
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/simplify.h>
+#include <jkcc/private/simplify.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+
+
+int ir_simplify_cfg_function(ir_function_t *ir_function)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	ht_t      index;
+
+	if (ht_init(&index, 0)) return IR_ERROR_NOMEM;
+
+	int ret = IR_ERROR_NOMEM;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++)
+		if (ht_insert(
+			&index,
+			&ir_bb[i]->id,
+			sizeof(ir_bb[i]->id),
+			(void*) i)) goto error;
+
+	terminate(ir_function);
+
+	ret = thread(ir_function, &index);
+
+error:
+	ht_free(&index, NULL);
+
+	if (ret) return ret;
+
+	return unreachable(ir_function);
+}
+
+
+static size_t forward(ir_function_t *ir_function, ht_t *index, size_t bb)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	size_t    bbs   = ir_function->bb.use;
+
+	// a cycle of empty bbs is an infinite loop either way
+	for (size_t hops = 0; hops < bbs; hops++) {
+		if (!ir_bb[bb]->quad.use) {
+			if (bb + 1 >= bbs) break;
+
+			++bb;
+			continue;
+		}
+
+		if (ir_bb[bb]->quad.use != 1) break;
+
+		ir_quad_t *quad = *(ir_quad_t**) ir_bb[bb]->quad.buf;
+
+		if (*quad != IR_QUAD_BR) break;
+
+		ir_quad_br_t *br = OFFSETOF_IR_QUAD(quad, ir_quad_br_t);
+		void         *val;
+
+		if (br->condition != IR_QUAD_BR_AL) break;
+
+		if (ht_get(index, &br->bb, sizeof(br->bb), &val)) break;
+
+		bb = (uintptr_t) val;
+	}
+
+	return bb;
+}
+
+static void terminate(ir_function_t *ir_function)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+
+	// nothing after a ret or a br.al can execute
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		size_t      use  = ir_bb[i]->quad.use;
+		size_t      end  = 0;
+
+		while (end < use) {
+			ir_quad_t *last = quad[end++];
+
+			if (*last == IR_QUAD_RET) break;
+
+			if (*last == IR_QUAD_BR && OFFSETOF_IR_QUAD(
+				last,
+				ir_quad_br_t)->condition == IR_QUAD_BR_AL)
+				break;
+		}
+
+		for (size_t j = end; j < use; j++) IR_QUAD_FREE(quad[j]);
+
+		ir_bb[i]->quad.use = end;
+	}
+}
+
+static int thread(ir_function_t *ir_function, ht_t *index)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+
+	// branches onto a bb that only branches on go straight there
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_BR) continue;
+
+			ir_quad_br_t *br;
+			void         *val;
+
+			br = OFFSETOF_IR_QUAD(quad[j], ir_quad_br_t);
+
+			if (br->condition == IR_QUAD_BR_NV) continue;
+
+			if (ht_get(index, &br->bb, sizeof(br->bb), &val))
+				continue;
+
+			size_t target = forward(
+				ir_function,
+				index,
+				(uintptr_t) val);
+
+			br->bb = ir_bb[target]->id;
+		}
+	}
+
+	return 0;
+}
+
+static int unreachable(ir_function_t *ir_function)
+{
+	ir_cfg_t ir_cfg;
+
+	int ret = ir_cfg_init(&ir_cfg, ir_function);
+	if (ret) return ret;
+
+	// the stack and the marks share the allocation
+	size_t *stack = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_PASS,
+		(ir_cfg.bbs * 2 + 1) * sizeof(*stack));
+	if (!stack) {
+		ir_cfg_free(&ir_cfg);
+		return IR_ERROR_NOMEM;
+	}
+
+	size_t *reached = stack + ir_cfg.bbs;
+	size_t  depth   = 0;
+
+	for (size_t i = 0; i < ir_cfg.bbs; i++) reached[i] = false;
+
+	if (ir_cfg.bbs) {
+		reached[0]     = true;
+		stack[depth++] = 0;
+	}
+
+	while (depth) {
+		size_t  bb   = stack[--depth];
+		size_t *succ = ir_cfg.succ[bb].buf;
+
+		for (size_t i = 0; i < ir_cfg.succ[bb].use; i++) {
+			if (reached[succ[i]]) continue;
+
+			reached[succ[i]] = true;
+			stack[depth++]   = succ[i];
+		}
+	}
+
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	size_t    kept  = 0;
+
+	for (size_t i = 0; i < ir_cfg.bbs; i++) {
+		if (reached[i]) {
+			ir_bb[kept++] = ir_bb[i];
+			continue;
+		}
+
+		ir_bb_free(ir_bb[i]);
+	}
+
+	ir_function->bb.use = kept;
+
+	MEM_FREE(stack);
+	ir_cfg_free(&ir_cfg);
+
+	return 0;
+}
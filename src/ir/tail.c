@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * tail.c -- tail calls
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/tail.h>
+#include <jkcc/private/tail.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/bitset.h>
+#include <jkcc/ht.h>
+#include <jkcc/ir.h>
+
+
+int ir_tail_call_function(ir_function_t *ir_function)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	size_t    bbs   = ir_function->bb.use;
+	bitset_t  frame;  // registers holding an address in the frame
+	ht_t      index;
+
+	if (!bbs) return 0;
+
+	if (bitset_init(&frame, ir_function_vregs(ir_function) + 1))
+		return IR_ERROR_NOMEM;
+
+	int ret = IR_ERROR_NOMEM;
+
+	if (ht_init(&index, 0)) goto error_ht_init;
+
+	for (size_t i = 0; i < bbs; i++)
+		if (ht_insert(
+			&index,
+			&ir_bb[i]->id,
+			sizeof(ir_bb[i]->id),
+			(void*) i)) goto error;
+
+	ret = 0;
+
+	// the callee cannot be handed anything pointing into our frame
+	if (escapes(ir_function, &frame)) goto error;
+
+	const char *self = ast_identifier_get_string(
+		ast_function_get_identifier(
+			ir_function->declaration))->head;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		size_t      pos  = ir_bb[i]->quad.use;
+		size_t      next = i + 1;
+
+		if (!pos--) continue;
+
+		// a call always ends its bb with a br.al
+		if (*quad[pos] == IR_QUAD_BR) {
+			ir_quad_br_t *br = OFFSETOF_IR_QUAD(
+				quad[pos],
+				ir_quad_br_t);
+			void         *val;
+
+			if (br->condition != IR_QUAD_BR_AL) continue;
+
+			if (ht_get(&index, &br->bb, sizeof(br->bb), &val))
+				continue;
+
+			next = (uintptr_t) val;
+
+			if (!pos--) continue;
+		}
+
+		if (*quad[pos] != IR_QUAD_CALL) continue;
+
+		ir_quad_call_t *call = OFFSETOF_IR_QUAD(
+			quad[pos],
+			ir_quad_call_t);
+
+		if (call->tail) continue;
+
+		if (!returns(ir_function, &index, next, call->dst)) continue;
+
+		if (call->src.type == IR_LOCATION_IDENTIFIER
+			&& !strcmp(call->src.identifier->head, self)) {
+			ret = loop(ir_function, i, pos);
+			if (ret < 0) goto error;
+
+			if (!ret) continue;
+
+			ret = 0;
+		}
+
+		call->tail = true;
+	}
+
+error:
+	ht_free(&index, NULL);
+
+error_ht_init:
+	bitset_free(&frame);
+
+	return ret;
+}
+
+
+static bool escapes(ir_function_t *ir_function, bitset_t *frame)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	size_t    argc  = (ir_function->argv) ? ir_function->argv->use : 0;
+
+	for (size_t i = 0; i < argc; i++) {
+		uintptr_t     reg;
+		ir_reg_type_t type;
+
+		ir_function_argv_reg(ir_function, i, &reg, &type);
+
+		BITSET_SET(frame, reg);
+	}
+
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++)
+			if (*quad[j] == IR_QUAD_ALLOCA)
+				BITSET_SET(frame, OFFSETOF_IR_QUAD(
+					quad[j],
+					ir_quad_alloca_t)->dst);
+	}
+
+	// an address is fine to load through or store through,
+	// anything else could carry it past the frame
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			if (*quad[j] == IR_QUAD_LOAD) continue;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			if (*quad[j] == IR_QUAD_STORE) reg.use[1] = NULL;
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+
+				if (BITSET_TEST(frame, *reg.use[k])) return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static int loop(ir_function_t *ir_function, size_t bb, size_t pos)
+{
+	ir_bb_t    *ir_bb = ((ir_bb_t**) ir_function->bb.buf)[bb];
+	ir_quad_t **quad  = ir_bb->quad.buf;
+	size_t      argc  = (ir_function->argv) ? ir_function->argv->use : 0;
+	size_t      arg[TAIL_ARGV_MAX];
+	size_t      found = 0;
+
+	if (argc > TAIL_ARGV_MAX) return 1;
+
+	for (size_t i = 0; i < argc; i++) arg[i] = SIZE_MAX;
+
+	// the arguments have to be right here to become stores
+	for (size_t i = pos; i-- > 0;) {
+		if (*quad[i] == IR_QUAD_CALL) break;
+
+		if (*quad[i] != IR_QUAD_ARG) continue;
+
+		ir_quad_arg_t *ir_quad_arg = OFFSETOF_IR_QUAD(
+			quad[i],
+			ir_quad_arg_t);
+
+		if (ir_quad_arg->pos >= argc) return 1;
+
+		if (arg[ir_quad_arg->pos] != SIZE_MAX) return 1;
+
+		arg[ir_quad_arg->pos] = i;
+		++found;
+	}
+
+	if (found != argc) return 1;
+
+	ir_quad_t *store[TAIL_ARGV_MAX] = {NULL};
+	ir_quad_t *br;
+	int        ret;
+
+	for (size_t i = 0; i < argc; i++) {
+		ir_quad_arg_t *ir_quad_arg = OFFSETOF_IR_QUAD(
+			quad[arg[i]],
+			ir_quad_arg_t);
+		uintptr_t      reg;
+		ir_reg_type_t  type;
+
+		ir_function_argv_reg(ir_function, i, &reg, &type);
+
+		ret = ir_quad_store_gen(
+			&store[i],
+			ir_quad_arg->src,
+			ir_quad_arg->type,
+			reg);
+		if (ret) goto error;
+	}
+
+	size_t entry = (*(ir_bb_t**) ir_function->bb.buf)->id;
+
+	ret = ir_quad_br_gen(&br, IR_QUAD_BR_AL, entry);
+	if (ret) goto error;
+
+	// every argument is evaluated before any parameter is replaced
+	size_t kept = 0;
+
+	for (size_t i = 0; i < pos; i++) {
+		size_t j = 0;
+
+		while (j < argc && arg[j] != i) ++j;
+
+		if (j < argc) {
+			IR_QUAD_FREE(quad[i]);
+			continue;
+		}
+
+		quad[kept++] = quad[i];
+	}
+
+	for (size_t i = pos; i < ir_bb->quad.use; i++) IR_QUAD_FREE(quad[i]);
+
+	for (size_t i = 0; i < argc; i++) quad[kept++] = store[i];
+
+	quad[kept++]    = br;
+	ir_bb->quad.use = kept;
+
+	return 0;
+
+error:
+	for (size_t i = 0; i < argc; i++) IR_QUAD_FREE(store[i]);
+
+	return ret;
+}
+
+static bool returns(
+	ir_function_t *ir_function,
+	ht_t          *index,
+	size_t         bb,
+	uintptr_t      dst)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+	size_t    bbs   = ir_function->bb.use;
+
+	// a cycle of empty bbs never returns at all
+	for (size_t hops = 0; hops < bbs; hops++) {
+		// falling off the end returns nothing
+		if (bb >= bbs) return true;
+
+		if (!ir_bb[bb]->quad.use) {
+			++bb;
+			continue;
+		}
+
+		ir_quad_t *quad = *(ir_quad_t**) ir_bb[bb]->quad.buf;
+
+		if (*quad == IR_QUAD_RET) {
+			uintptr_t src = OFFSETOF_IR_QUAD(
+				quad,
+				ir_quad_ret_t)->src;
+
+			return src == dst || src == UINTPTR_MAX;
+		}
+
+		if (*quad != IR_QUAD_BR || ir_bb[bb]->quad.use != 1)
+			return false;
+
+		ir_quad_br_t *br = OFFSETOF_IR_QUAD(quad, ir_quad_br_t);
+		void         *val;
+
+		if (br->condition != IR_QUAD_BR_AL) return false;
+
+		if (ht_get(index, &br->bb, sizeof(br->bb), &val)) return false;
+
+		bb = (uintptr_t) val;
+	}
+
+	return false;
+}
@@ -0,0 +1,645 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * unroll.c -- loop unrolling
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/unroll.h>
+#include <jkcc/private/unroll.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+int ir_unroll_unit(ir_unit_t *ir_unit)
+{
+	unroll_t unroll = {
+		.bb = 0,
+	};
+
+	if (vector_init(&unroll.done, sizeof(size_t), 0))
+		return IR_ERROR_NOMEM;
+
+	// string literals draw their ids from the same counter as bbs
+	ir_static_declaration_t **ir_static_declaration
+		= ir_unit->static_declaration.buf;
+	for (size_t i = 0; i < ir_unit->static_declaration.use; i++)
+		if (ir_static_declaration[i]->bb >= unroll.bb)
+			unroll.bb = ir_static_declaration[i]->bb + 1;
+
+	ir_function_t **ir_function = ir_unit->function.buf;
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		ir_bb_t **ir_bb = ir_function[i]->bb.buf;
+
+		for (size_t j = 0; j < ir_function[i]->bb.use; j++)
+			if (ir_bb[j]->id >= unroll.bb)
+				unroll.bb = ir_bb[j]->id + 1;
+	}
+
+	int ret = 0;
+
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		ret = function(&unroll, ir_function[i]);
+		if (ret) break;
+	}
+
+	vector_free(&unroll.done);
+
+	return ret;
+}
+
+
+static int append(ir_bb_t *ir_bb, ir_quad_t *ir_quad)
+{
+	if (!vector_append(&ir_bb->quad, &ir_quad)) return 0;
+
+	IR_QUAD_FREE(ir_quad);
+
+	return IR_ERROR_NOMEM;
+}
+
+static bool counted(unroll_loop_t *loop, const ir_loop_nest_t *ir_loop_nest)
+{
+	const ir_loop_t *ir_loop = loop->ir_loop;
+	ir_bb_t        **ir_bb   = loop->ir_function->bb.buf;
+	size_t           header  = ir_loop->header;
+
+	if (ir_loop->preheader == SIZE_MAX) return false;
+
+	// the first copy goes where the header is, so only the
+	// preheader may fall into it
+	if (header
+		&& header - 1 != ir_loop->preheader
+		&& falls(ir_bb[header - 1])) return false;
+
+	if (!ir_iv_counted(
+		&loop->ir_iv,
+		loop->ir_cfg,
+		ir_loop_nest,
+		&loop->counted)) return false;
+
+	return scan(loop);
+}
+
+static int expand(unroll_t *unroll, unroll_loop_t *loop)
+{
+	ir_function_t   *ir_function = loop->ir_function;
+	const ir_loop_t *ir_loop     = loop->ir_loop;
+	ir_bb_t        **ir_bb       = ir_function->bb.buf;
+	ir_bb_t         *preheader   = ir_bb[ir_loop->preheader];
+	const ir_iv_t   *ir_iv       = &loop->ir_iv;
+	size_t           bbs         = ir_function->bb.use;
+	size_t           header      = ir_loop->header;
+	size_t           tail        = ir_bb[header]->quad.use - 3;
+	size_t           width       = ir_loop->bbs;
+	size_t           copies      = loop->factor;
+	bool             full        = loop->trip != SIZE_MAX;
+	size_t           blocks      = copies * width + full;
+	size_t           first       = unroll->bb;
+	uintptr_t        vregs       = ir_function_vregs(ir_function);
+	uintptr_t        next        = vregs;
+
+	vector_t block;  // ir_bb_t*, the copies in order
+
+	int ret = IR_ERROR_NOMEM;
+
+	size_t *target = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_LOOP,
+		(bbs + 1) * sizeof(*target));
+	if (!target) return IR_ERROR_NOMEM;
+
+	uintptr_t *rename = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_LOOP,
+		(vregs + 1) * sizeof(*rename));
+	if (!rename) goto error_alloc_rename;
+
+	if (vector_init(&block, sizeof(ir_bb_t*), blocks + 1))
+		goto error_vector_init_block;
+
+	for (size_t i = 0; i < blocks; i++) {
+		ir_bb_t *ir_bb = ir_bb_alloc(first + i);
+		if (!ir_bb) goto error;
+
+		if (vector_append(&block, &ir_bb)) {
+			ir_bb_free(ir_bb);
+			goto error;
+		}
+	}
+
+	ir_bb_t **copy = block.buf;
+
+	// each copy is its header then the rest of the body in order,
+	// and a fully unrolled loop has one last header to leave by
+	for (size_t j = 0; j < copies + full; j++) {
+		size_t base = first + j * width;
+		size_t rest = 0;
+
+		for (size_t i = 0; i < bbs; i++) {
+			if (!BITSET_TEST(&ir_loop->body, i))
+				target[i] = ir_bb[i]->id;
+			else if (i == header)
+				target[i] = base + width;
+			else
+				target[i] = base + 1 + rest++;
+		}
+
+		if (!full && j + 1 == copies) target[header] = first;
+
+		for (uintptr_t r = 0; r < vregs; r++) {
+			size_t bb = ir_iv->def[r].bb;
+
+			rename[r] = (bb != SIZE_MAX
+				&& BITSET_TEST(&ir_loop->body, bb))
+				? next++
+				: r;
+		}
+
+		ir_bb_t   *head = copy[j * width];
+		ir_quad_t *ir_quad;
+
+		ret = place(loop, header, tail, target, rename, head);
+		if (ret) goto error;
+
+		if (j == copies) {
+			ret = ir_quad_br_gen(
+				&ir_quad,
+				IR_QUAD_BR_AL,
+				ir_bb[loop->counted.exit]->id);
+			if (ret) goto error;
+
+			ret = append(head, ir_quad);
+			if (ret) goto error;
+
+			break;
+		}
+
+		if (!full && !j) {
+			// the whole trip around stays in bounds when the
+			// last of its counts does, checked in 64 bits
+			int64_t   step   = loop->counted.basic.step
+				* (int64_t) (copies - 1);
+			uintptr_t offset = IR_REG_IMMEDIATE_GEN(step);
+			uintptr_t last   = next++;
+			uintptr_t limit  = loop->counted.limit;
+
+			if (!IR_REG_IS_IMMEDIATE(limit)) limit = rename[limit];
+
+			if (!IR_REG_IMMEDIATE_FITS(step)) {
+				offset = next++;
+
+				ret = ir_quad_mov_gen(
+					&ir_quad,
+					offset,
+					IR_REG_TYPE_PTR,
+					(uintptr_t) step);
+				if (ret) goto error;
+
+				ret = append(head, ir_quad);
+				if (ret) goto error;
+			}
+
+			ret = ir_quad_binop_gen(
+				&ir_quad,
+				last,
+				IR_QUAD_BINOP_ADD,
+				IR_REG_TYPE_PTR,
+				rename[loop->counted.counter],
+				offset);
+			if (ret) goto error;
+
+			ret = append(head, ir_quad);
+			if (ret) goto error;
+
+			ret = ir_quad_cmp_gen(&ir_quad, last, limit);
+			if (ret) goto error;
+
+			ret = append(head, ir_quad);
+			if (ret) goto error;
+
+			ret = ir_quad_br_gen(
+				&ir_quad,
+				loop->counted.condition,
+				target[loop->counted.enter]);
+			if (ret) goto error;
+
+			ret = append(head, ir_quad);
+			if (ret) goto error;
+
+			// what is left over goes around the original
+			ret = ir_quad_br_gen(
+				&ir_quad,
+				IR_QUAD_BR_AL,
+				ir_bb[header]->id);
+			if (ret) goto error;
+		} else {
+			ret = ir_quad_br_gen(
+				&ir_quad,
+				IR_QUAD_BR_AL,
+				target[loop->counted.enter]);
+			if (ret) goto error;
+		}
+
+		ret = append(head, ir_quad);
+		if (ret) goto error;
+
+		for (size_t i = 0; i < bbs; i++) {
+			if (i == header) continue;
+			if (!BITSET_TEST(&ir_loop->body, i)) continue;
+
+			ret = place(
+				loop,
+				i,
+				ir_bb[i]->quad.use,
+				target,
+				rename,
+				copy[target[i] - first]);
+			if (ret) goto error;
+		}
+	}
+
+	// nothing past here may fail
+	ret = IR_ERROR_NOMEM;
+
+	if (vector_append(&unroll->done, &first)) goto error;
+
+	// the resize may move what ir_bb points into
+	size_t entry = ir_bb[header]->id;
+
+	if (bbs + blocks > ir_function->bb.size && vector_resize(
+		&ir_function->bb,
+		bbs + blocks)) goto error;
+
+	ir_quad_t **quad = preheader->quad.buf;
+
+	for (size_t i = 0; i < preheader->quad.use; i++) {
+		if (*quad[i] != IR_QUAD_BR) continue;
+
+		ir_quad_br_t *br = OFFSETOF_IR_QUAD(quad[i], ir_quad_br_t);
+
+		if (br->bb == entry) br->bb = first;
+	}
+
+	widen(&ir_function->bb, header, blocks);
+	memcpy(
+		(ir_bb_t**) ir_function->bb.buf + header,
+		block.buf,
+		blocks * sizeof(ir_bb_t*));
+
+	unroll->bb += blocks;
+
+	vector_free(&block);
+	MEM_FREE(rename);
+	MEM_FREE(target);
+
+	return 0;
+
+error:
+	copy = block.buf;
+	for (size_t i = 0; i < block.use; i++) ir_bb_free(copy[i]);
+
+	vector_free(&block);
+
+error_vector_init_block:
+	MEM_FREE(rename);
+
+error_alloc_rename:
+	MEM_FREE(target);
+
+	return ret;
+}
+
+static bool falls(const ir_bb_t *ir_bb)
+{
+	if (!ir_bb->quad.use) return true;
+
+	ir_quad_t *last = ((ir_quad_t**) ir_bb->quad.buf)[ir_bb->quad.use - 1];
+
+	if (*last == IR_QUAD_RET) return false;
+
+	if (*last != IR_QUAD_BR) return true;
+
+	return OFFSETOF_IR_QUAD(last, ir_quad_br_t)->condition
+		!= IR_QUAD_BR_AL;
+}
+
+static int function(unroll_t *unroll, ir_function_t *ir_function)
+{
+	if (!ir_function->bb.use) return 0;
+
+	unroll->done.use = 0;
+
+	// unrolling moves bbs around, so loops are found again after
+	// each one, and a header is only ever looked at once
+	for (;;) {
+		ir_cfg_t       ir_cfg;
+		ir_loop_nest_t ir_loop_nest;
+		bool           expanded = false;
+
+		int ret = ir_cfg_init(&ir_cfg, ir_function);
+		if (ret) return ret;
+
+		ret = ir_loop_nest_init(&ir_loop_nest, &ir_cfg);
+		if (ret) {
+			ir_cfg_free(&ir_cfg);
+			return ret;
+		}
+
+		ir_loop_t *ir_loop = ir_loop_nest.loop.buf;
+		ir_bb_t  **ir_bb   = ir_function->bb.buf;
+
+		for (size_t i = 0; i < ir_loop_nest.loop.use; i++) {
+			size_t  id   = ir_bb[ir_loop[i].header]->id;
+			size_t *done = unroll->done.buf;
+			size_t  j    = 0;
+
+			while (j < unroll->done.use && done[j] != id) ++j;
+
+			if (j < unroll->done.use) continue;
+
+			ret = IR_ERROR_NOMEM;
+			if (vector_append(&unroll->done, &id)) break;
+
+			unroll_loop_t loop = {
+				.ir_function = ir_function,
+				.ir_cfg      = &ir_cfg,
+				.ir_loop     = &ir_loop[i],
+			};
+
+			ret = ir_iv_init(&loop.ir_iv, ir_function, &ir_loop[i]);
+			if (ret) break;
+
+			if (counted(&loop, &ir_loop_nest) && plan(&loop)) {
+				ret      = expand(unroll, &loop);
+				expanded = !ret;
+			}
+
+			ir_iv_free(&loop.ir_iv);
+
+			if (ret || expanded) break;
+		}
+
+		ir_loop_nest_free(&ir_loop_nest);
+		ir_cfg_free(&ir_cfg);
+
+		if (ret || !expanded) return ret;
+	}
+}
+
+static bool holds(ir_quad_br_condition_t condition, int64_t lhs, int64_t rhs)
+{
+	switch (condition) {
+		case IR_QUAD_BR_EQ:
+			return lhs == rhs;
+
+		case IR_QUAD_BR_NE:
+			return lhs != rhs;
+
+		case IR_QUAD_BR_GE:
+			return lhs >= rhs;
+
+		case IR_QUAD_BR_LT:
+			return lhs < rhs;
+
+		case IR_QUAD_BR_GT:
+			return lhs > rhs;
+
+		case IR_QUAD_BR_LE:
+			return lhs <= rhs;
+
+		default:
+			return false;
+	}
+}
+
+static bool initial(const unroll_loop_t *loop, int64_t *init)
+{
+	const ir_cfg_t *ir_cfg = loop->ir_cfg;
+	const ir_iv_t  *ir_iv  = &loop->ir_iv;
+	ir_bb_t       **ir_bb  = loop->ir_function->bb.buf;
+	size_t          bb     = loop->ir_loop->preheader;
+
+	// the last store to the counter on the only way in
+	for (size_t hops = 0; hops < UNROLL_INIT_HOPS; hops++) {
+		ir_quad_t **quad = ir_bb[bb]->quad.buf;
+
+		for (size_t i = ir_bb[bb]->quad.use; i-- > 0;) {
+			if (*quad[i] != IR_QUAD_STORE) continue;
+
+			ir_quad_store_t *store = OFFSETOF_IR_QUAD(
+				quad[i],
+				ir_quad_store_t);
+
+			if (store->dst != loop->counted.basic.cell) continue;
+
+			if (!ir_iv_constant(ir_iv, store->src, init))
+				return false;
+
+			*init = (int32_t) *init;
+
+			return true;
+		}
+
+		if (ir_cfg->pred[bb].use != 1) return false;
+
+		bb = *(size_t*) ir_cfg->pred[bb].buf;
+	}
+
+	return false;
+}
+
+static size_t lookup(const ir_function_t *ir_function, size_t id)
+{
+	ir_bb_t **ir_bb = ir_function->bb.buf;
+
+	for (size_t i = 0; i < ir_function->bb.use; i++)
+		if (ir_bb[i]->id == id) return i;
+
+	return SIZE_MAX;
+}
+
+static int place(
+	const unroll_loop_t *loop,
+	size_t               bb,
+	size_t               quads,
+	const size_t        *target,
+	const uintptr_t     *rename,
+	ir_bb_t             *dst)
+{
+	ir_function_t *ir_function = loop->ir_function;
+	ir_bb_t       *src         = ((ir_bb_t**) ir_function->bb.buf)[bb];
+	ir_quad_t    **quad        = src->quad.buf;
+	ir_quad_t     *clone;
+	int            ret;
+
+	for (size_t i = 0; i < quads; i++) {
+		ir_quad_reg_t reg;
+
+		ret = IR_QUAD_CLONE(&clone, quad[i]);
+		if (ret) return ret;
+
+		IR_QUAD_REG(clone, &reg);
+
+		if (reg.def) *reg.def = rename[*reg.def];
+
+		for (size_t j = 0; j < IR_QUAD_REG_USES; j++)
+			if (reg.use[j]) *reg.use[j] = rename[*reg.use[j]];
+
+		if (*clone == IR_QUAD_BR) {
+			ir_quad_br_t *br    = OFFSETOF_IR_QUAD(
+				clone,
+				ir_quad_br_t);
+			size_t        index = lookup(ir_function, br->bb);
+
+			if (index != SIZE_MAX) br->bb = target[index];
+		}
+
+		ret = append(dst, clone);
+		if (ret) return ret;
+	}
+
+	// copies are laid out elsewhere, so nothing falls out of one
+	if (quads < src->quad.use || !falls(src)) return 0;
+
+	ret = ir_quad_br_gen(&clone, IR_QUAD_BR_AL, target[bb + 1]);
+	if (ret) return ret;
+
+	return append(dst, clone);
+}
+
+static bool plan(unroll_loop_t *loop)
+{
+	const ir_iv_t *ir_iv = &loop->ir_iv;
+	int64_t        init;
+
+	loop->trip   = SIZE_MAX;
+	loop->factor = 0;
+
+	if (loop->size > UNROLL_BODY_MAX) return false;
+
+	// a trip count known up front that fits unrolls all the way
+	int64_t bound;
+
+	if (ir_iv_constant(ir_iv, loop->counted.limit, &bound)
+		&& bound == (int32_t) bound
+		&& loop->counted.basic.type == IR_REG_TYPE_I32
+		&& initial(loop, &init)) {
+		int64_t value = init;
+		size_t  trips = 0;
+		bool    known = true;
+
+		while (known && holds(loop->counted.condition, value, bound)) {
+			value += loop->counted.basic.step;
+
+			if (value < INT32_MIN || value > INT32_MAX)
+				known = false;
+
+			if ((++trips + 1) * loop->size > UNROLL_FULL_MAX)
+				known = false;
+		}
+
+		if (known) {
+			loop->trip   = trips;
+			loop->factor = trips;
+
+			return true;
+		}
+	}
+
+	// otherwise copies run while the last of them would, and the
+	// original loop finishes off the rest
+	bool up = loop->counted.basic.step > 0;
+
+	switch (loop->counted.condition) {
+		case IR_QUAD_BR_LT:
+		case IR_QUAD_BR_LE:
+			if (!up) return false;
+			break;
+
+		case IR_QUAD_BR_GT:
+		case IR_QUAD_BR_GE:
+			if (up) return false;
+			break;
+
+		default:
+			return false;
+	}
+
+	loop->factor = UNROLL_FACTOR;
+
+	return true;
+}
+
+static bool scan(unroll_loop_t *loop)
+{
+	ir_function_t     *ir_function = loop->ir_function;
+	ir_bb_t          **ir_bb       = ir_function->bb.buf;
+	const bitset_t    *body        = &loop->ir_loop->body;
+	const ir_iv_def_t *def         = loop->ir_iv.def;
+	size_t             bbs         = ir_function->bb.use;
+
+	loop->size = 0;
+
+	for (size_t i = 0; i < bbs; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		bool        in   = BITSET_TEST(body, i);
+
+		if (in) {
+			loop->size += ir_bb[i]->quad.use;
+
+			// a copy has to be able to say where it goes next
+			if (i + 1 == bbs && falls(ir_bb[i])) return false;
+		}
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			// a copy would need its own cell, and a call
+			// dwarfs the branch unrolling saves
+			if (in) {
+				if (*quad[j] == IR_QUAD_ALLOCA) return false;
+				if (*quad[j] == IR_QUAD_CALL) return false;
+
+				if (reg.def && def[*reg.def].defs != 1)
+					return false;
+
+				continue;
+			}
+
+			// each copy renames what the body defines
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+
+				size_t bb = def[*reg.use[k]].bb;
+
+				if (bb != SIZE_MAX && BITSET_TEST(body, bb))
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static void widen(vector_t *vector, size_t pos, size_t count)
+{
+	// the room has to have been reserved already
+	uint8_t *buf = vector->buf;
+
+	memmove(
+		buf + (pos + count) * vector->element_size,
+		buf + pos * vector->element_size,
+		(vector->use - pos) * vector->element_size);
+
+	vector->use += count;
+}
@@ -0,0 +1,931 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * vectorize.c -- loop vectorization
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/ir/vectorize.h>
+#include <jkcc/private/vectorize.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/mem.h>
+#include <jkcc/vector.h>
+
+
+int ir_vectorize_unit(ir_unit_t *ir_unit)
+{
+	vectorize_t vectorize = {
+		.bb = 0,
+	};
+
+	if (vector_init(&vectorize.done, sizeof(size_t), 0))
+		return IR_ERROR_NOMEM;
+
+	// string literals draw their ids from the same counter as bbs
+	ir_static_declaration_t **ir_static_declaration
+		= ir_unit->static_declaration.buf;
+	for (size_t i = 0; i < ir_unit->static_declaration.use; i++)
+		if (ir_static_declaration[i]->bb >= vectorize.bb)
+			vectorize.bb = ir_static_declaration[i]->bb + 1;
+
+	ir_function_t **ir_function = ir_unit->function.buf;
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		ir_bb_t **ir_bb = ir_function[i]->bb.buf;
+
+		for (size_t j = 0; j < ir_function[i]->bb.use; j++)
+			if (ir_bb[j]->id >= vectorize.bb)
+				vectorize.bb = ir_bb[j]->id + 1;
+	}
+
+	int ret = 0;
+
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		ret = function(&vectorize, ir_function[i]);
+		if (ret) break;
+	}
+
+	vector_free(&vectorize.done);
+
+	return ret;
+}
+
+
+static int append(ir_bb_t *ir_bb, ir_quad_t *ir_quad)
+{
+	if (!vector_append(&ir_bb->quad, &ir_quad)) return 0;
+
+	IR_QUAD_FREE(ir_quad);
+
+	return IR_ERROR_NOMEM;
+}
+
+static int body(
+	const vectorize_loop_t *loop,
+	const uintptr_t        *rename,
+	size_t                  guard,
+	ir_bb_t                *dst)
+{
+	ir_bb_t        *src  = ((ir_bb_t**)
+		loop->ir_function->bb.buf)[loop->body];
+	ir_quad_t     **quad = src->quad.buf;
+	ir_iv_basic_t  *iv   = loop->ir_iv.basic.buf;
+	ir_quad_t      *clone;
+	int             ret;
+
+	// everything but the branch back around, with each pattern
+	// folded into a vector quad where its store was
+	for (size_t i = 0; i + 1 < src->quad.use; i++) {
+		const vectorize_pattern_t *pattern = member(loop, i);
+
+		if (pattern) {
+			if (i != pattern->store) continue;
+
+			ret = ir_quad_vector_gen(
+				&clone,
+				OFFSETOF_IR_QUAD(
+					quad[pattern->binop],
+					ir_quad_binop_t)->op,
+				IR_REG_TYPE_I32,
+				VECTORIZE_LANES,
+				rename[pattern->address[0]],
+				rename[pattern->address[1]],
+				rename[pattern->address[2]]);
+			if (ret) return ret;
+
+			ret = append(dst, clone);
+			if (ret) return ret;
+
+			continue;
+		}
+
+		ir_quad_reg_t reg;
+
+		ret = IR_QUAD_CLONE(&clone, quad[i]);
+		if (ret) return ret;
+
+		IR_QUAD_REG(clone, &reg);
+
+		if (reg.def) *reg.def = rename[*reg.def];
+
+		for (size_t j = 0; j < IR_QUAD_REG_USES; j++)
+			if (reg.use[j]) *reg.use[j] = rename[*reg.use[j]];
+
+		size_t k = stepper(loop, i);
+
+		if (k != SIZE_MAX) {
+			// every basic iv steps over as many trips at once
+			ir_quad_binop_t *step   = OFFSETOF_IR_QUAD(
+				quad[i],
+				ir_quad_binop_t);
+			ir_quad_binop_t *binop  = OFFSETOF_IR_QUAD(
+				clone,
+				ir_quad_binop_t);
+			uintptr_t        loaded = OFFSETOF_IR_QUAD(
+				quad[iv[k].load],
+				ir_quad_load_t)->dst;
+			int64_t          by     = iv[k].step * VECTORIZE_LANES;
+
+			if (binop->op == IR_QUAD_BINOP_SUB) by = -by;
+
+			if (step->lhs == loaded)
+				binop->rhs = IR_REG_IMMEDIATE_GEN(by);
+			else
+				binop->lhs = IR_REG_IMMEDIATE_GEN(by);
+		}
+
+		ret = append(dst, clone);
+		if (ret) return ret;
+	}
+
+	ret = ir_quad_br_gen(&clone, IR_QUAD_BR_AL, guard);
+	if (ret) return ret;
+
+	return append(dst, clone);
+}
+
+static int checks(
+	const vectorize_loop_t *loop,
+	uintptr_t              *rename,
+	uintptr_t              *next,
+	size_t                  guard,
+	ir_bb_t                *dst)
+{
+	const vectorize_stream_t *stream = loop->stream;
+	ir_bb_t                 **ir_bb  = loop->ir_function->bb.buf;
+	size_t                    header = ir_bb[loop->ir_loop->header]->id;
+	uintptr_t                 bias   = (*next)++;
+	uintptr_t                 span   = (*next)++;
+	ir_quad_t                *ir_quad;
+	int                       ret;
+
+	// where each stream is as the first trip around begins
+	for (size_t i = 0; i < loop->streams; i++) {
+		ret = slice(loop, stream[i].reg, rename, next, dst);
+		if (ret) return ret;
+	}
+
+	ret = ir_quad_mov_gen(
+		&ir_quad,
+		bias,
+		IR_REG_TYPE_PTR,
+		VECTORIZE_WINDOW - 1);
+	if (ret) return ret;
+
+	ret = append(dst, ir_quad);
+	if (ret) return ret;
+
+	ret = ir_quad_mov_gen(
+		&ir_quad,
+		span,
+		IR_REG_TYPE_PTR,
+		VECTORIZE_WINDOW * 2 - 1);
+	if (ret) return ret;
+
+	ret = append(dst, ir_quad);
+	if (ret) return ret;
+
+	// streams a whole vector apart never meet in one, so anything
+	// closer goes the original way, checked once as the distance
+	// between two streams stays put
+	for (size_t i = 0; i < loop->streams; i++) {
+		for (size_t j = i + 1; j < loop->streams; j++) {
+			if (!stream[i].store && !stream[j].store) continue;
+
+			uintptr_t distance = (*next)++;
+			uintptr_t biased   = (*next)++;
+
+			ret = ir_quad_binop_gen(
+				&ir_quad,
+				distance,
+				IR_QUAD_BINOP_SUB,
+				IR_REG_TYPE_PTR,
+				rename[stream[i].reg],
+				rename[stream[j].reg]);
+			if (ret) return ret;
+
+			ret = append(dst, ir_quad);
+			if (ret) return ret;
+
+			ret = ir_quad_binop_gen(
+				&ir_quad,
+				biased,
+				IR_QUAD_BINOP_ADD,
+				IR_REG_TYPE_PTR,
+				distance,
+				bias);
+			if (ret) return ret;
+
+			ret = append(dst, ir_quad);
+			if (ret) return ret;
+
+			ret = ir_quad_cmp_gen(&ir_quad, biased, span);
+			if (ret) return ret;
+
+			ret = append(dst, ir_quad);
+			if (ret) return ret;
+
+			ret = ir_quad_br_gen(&ir_quad, IR_QUAD_BR_LO, header);
+			if (ret) return ret;
+
+			ret = append(dst, ir_quad);
+			if (ret) return ret;
+		}
+	}
+
+	ret = ir_quad_br_gen(&ir_quad, IR_QUAD_BR_AL, guard);
+	if (ret) return ret;
+
+	return append(dst, ir_quad);
+}
+
+static bool classify(vectorize_loop_t *loop, uintptr_t reg, bool store)
+{
+	const ir_iv_t      *ir_iv = &loop->ir_iv;
+	ir_iv_basic_t      *basic = ir_iv->basic.buf;
+	const ir_iv_def_t  *def   = &ir_iv->def[reg];
+	vectorize_stream_t  found = {
+		.store = store,
+		.reg   = reg,
+	};
+
+	if (!inside(loop, reg)) return false;
+
+	size_t k = ir_iv_lookup(ir_iv, reg);
+
+	if (k != SIZE_MAX) {
+		// a pointer stepped on its own
+		if (basic[k].type != IR_REG_TYPE_PTR) return false;
+		if (basic[k].step != VECTORIZE_STRIDE) return false;
+
+		found.basic = k;
+	} else {
+		ir_iv_derived_t *derived = ir_iv->derived.buf;
+		size_t           i       = 0;
+
+		while (i < ir_iv->derived.use
+			&& (derived[i].bb != def->bb
+			|| derived[i].quad != def->quad)) ++i;
+
+		if (i == ir_iv->derived.use) return false;
+
+		k = derived[i].basic;
+
+		if (derived[i].scale * basic[k].step != VECTORIZE_STRIDE)
+			return false;
+
+		found.basic = k;
+		found.scale = derived[i].scale;
+		found.key   = derived[i].base;
+
+		// a base loaded afresh every trip around is the same
+		// base so long as it is loaded from the same cell
+		ir_quad_t *ir_quad = definition(loop, derived[i].base);
+
+		if (ir_quad && *ir_quad == IR_QUAD_LOAD) {
+			ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+				ir_quad,
+				ir_quad_load_t);
+
+			if (load->src.type == IR_LOCATION_REG) {
+				found.key  = load->src.reg;
+				found.cell = true;
+			}
+		}
+	}
+
+	vectorize_stream_t *seen = loop->stream;
+
+	for (size_t i = 0; i < loop->streams; i++) {
+		if (seen[i].basic != found.basic) continue;
+		if (seen[i].scale != found.scale) continue;
+		if (seen[i].key != found.key) continue;
+		if (seen[i].cell != found.cell) continue;
+
+		seen[i].store |= store;
+
+		return true;
+	}
+
+	if (loop->streams == VECTORIZE_STREAMS_MAX) return false;
+
+	seen[loop->streams++] = found;
+
+	return true;
+}
+
+static bool counted(
+	vectorize_loop_t     *loop,
+	const ir_loop_nest_t *ir_loop_nest)
+{
+	const ir_loop_t *ir_loop = loop->ir_loop;
+	ir_bb_t        **ir_bb   = loop->ir_function->bb.buf;
+	size_t           header  = ir_loop->header;
+
+	if (ir_loop->preheader == SIZE_MAX) return false;
+
+	// the checks go where the header is, so only the preheader
+	// may fall into it
+	if (header
+		&& header - 1 != ir_loop->preheader
+		&& falls(ir_bb[header - 1])) return false;
+
+	// a header and a body that goes straight back around
+	if (ir_loop->bbs != 2) return false;
+
+	if (!ir_iv_counted(
+		&loop->ir_iv,
+		loop->ir_cfg,
+		ir_loop_nest,
+		&loop->counted)) return false;
+
+	// whole vectors run while the last of their lanes would
+	bool up = loop->counted.basic.step > 0;
+
+	switch (loop->counted.condition) {
+		case IR_QUAD_BR_LT:
+		case IR_QUAD_BR_LE:
+			if (!up) return false;
+			break;
+
+		case IR_QUAD_BR_GT:
+		case IR_QUAD_BR_GE:
+			if (up) return false;
+			break;
+
+		default:
+			return false;
+	}
+
+	loop->body = loop->counted.enter;
+
+	return scan(loop);
+}
+
+static ir_quad_t *definition(const vectorize_loop_t *loop, uintptr_t reg)
+{
+	const ir_iv_def_t *def = &loop->ir_iv.def[reg];
+
+	if (def->bb == SIZE_MAX) return NULL;
+
+	ir_bb_t *ir_bb = ((ir_bb_t**) loop->ir_function->bb.buf)[def->bb];
+
+	return ((ir_quad_t**) ir_bb->quad.buf)[def->quad];
+}
+
+static int expand(vectorize_t *vectorize, vectorize_loop_t *loop)
+{
+	ir_function_t   *ir_function = loop->ir_function;
+	const ir_loop_t *ir_loop     = loop->ir_loop;
+	ir_bb_t        **ir_bb       = ir_function->bb.buf;
+	ir_bb_t         *preheader   = ir_bb[ir_loop->preheader];
+	size_t           bbs         = ir_function->bb.use;
+	size_t           header      = ir_loop->header;
+	size_t           blocks      = 2 + !!loop->checks;
+	size_t           first       = vectorize->bb;
+	size_t           head        = first + !!loop->checks;
+	uintptr_t        vregs       = ir_function_vregs(ir_function);
+	uintptr_t        next        = vregs;
+	ir_bb_t         *block[3]    = {NULL};
+
+	int ret = IR_ERROR_NOMEM;
+
+	uintptr_t *rename = MEM_MALLOC(
+		MEM_TAG_IR,
+		MEM_IR_LOOP,
+		(vregs + 1) * sizeof(*rename));
+	if (!rename) return IR_ERROR_NOMEM;
+
+	for (size_t i = 0; i < blocks; i++) {
+		block[i] = ir_bb_alloc(first + i);
+		if (!block[i]) goto error;
+	}
+
+	for (uintptr_t r = 0; r < vregs; r++) rename[r] = r;
+
+	if (loop->checks) {
+		ret = checks(loop, rename, &next, head, block[0]);
+		if (ret) goto error;
+	}
+
+	// the vector loop renames what the original defines, and its
+	// body only ever sees the header as it is in the guard
+	for (uintptr_t r = 0; r < vregs; r++)
+		rename[r] = (inside(loop, r)) ? next++ : r;
+
+	ret = guard(loop, rename, &next, head + 1, block[blocks - 2]);
+	if (ret) goto error;
+
+	ret = body(loop, rename, head, block[blocks - 1]);
+	if (ret) goto error;
+
+	// nothing past here may fail
+	ret = IR_ERROR_NOMEM;
+
+	if (vector_append(&vectorize->done, &head)) goto error;
+
+	// the resize may move what ir_bb points into
+	size_t entry = ir_bb[header]->id;
+
+	if (bbs + blocks > ir_function->bb.size && vector_resize(
+		&ir_function->bb,
+		bbs + blocks)) goto error;
+
+	ir_quad_t **quad = preheader->quad.buf;
+
+	for (size_t i = 0; i < preheader->quad.use; i++) {
+		if (*quad[i] != IR_QUAD_BR) continue;
+
+		ir_quad_br_t *br = OFFSETOF_IR_QUAD(quad[i], ir_quad_br_t);
+
+		if (br->bb == entry) br->bb = first;
+	}
+
+	widen(&ir_function->bb, header, blocks);
+	memcpy(
+		(ir_bb_t**) ir_function->bb.buf + header,
+		block,
+		blocks * sizeof(ir_bb_t*));
+
+	vectorize->bb += blocks;
+
+	MEM_FREE(rename);
+
+	return 0;
+
+error:
+	for (size_t i = 0; i < blocks; i++) ir_bb_free(block[i]);
+
+	MEM_FREE(rename);
+
+	return ret;
+}
+
+static bool falls(const ir_bb_t *ir_bb)
+{
+	if (!ir_bb->quad.use) return true;
+
+	ir_quad_t *last = ((ir_quad_t**) ir_bb->quad.buf)[ir_bb->quad.use - 1];
+
+	if (*last == IR_QUAD_RET) return false;
+
+	if (*last != IR_QUAD_BR) return true;
+
+	return OFFSETOF_IR_QUAD(last, ir_quad_br_t)->condition
+		!= IR_QUAD_BR_AL;
+}
+
+static bool fold(vectorize_loop_t *loop, size_t pos)
+{
+	const ir_iv_def_t *def  = loop->ir_iv.def;
+	size_t             body = loop->body;
+	ir_quad_t        **quad = ((ir_bb_t**)
+		loop->ir_function->bb.buf)[body]->quad.buf;
+
+	if (loop->patterns == VECTORIZE_PATTERNS_MAX) return false;
+
+	ir_quad_store_t *store = OFFSETOF_IR_QUAD(quad[pos], ir_quad_store_t);
+
+	if (store->type != IR_REG_TYPE_I32) return false;
+
+	if (store->src >= loop->ir_iv.vregs) return false;
+
+	// each value feeds the next and nothing else
+	const ir_iv_def_t *value = &def[store->src];
+
+	if (value->bb != body || value->uses != 1 || value->quad > pos)
+		return false;
+
+	if (*quad[value->quad] != IR_QUAD_BINOP) return false;
+
+	ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+		quad[value->quad],
+		ir_quad_binop_t);
+
+	if (binop->type != IR_REG_TYPE_I32) return false;
+
+	switch (binop->op) {
+		case IR_QUAD_BINOP_ADD:
+		case IR_QUAD_BINOP_SUB:
+		case IR_QUAD_BINOP_AND:
+		case IR_QUAD_BINOP_OOR:
+		case IR_QUAD_BINOP_EOR:
+			break;
+
+		default:
+			return false;
+	}
+
+	vectorize_pattern_t *pattern = &loop->pattern[loop->patterns];
+
+	pattern->binop      = value->quad;
+	pattern->store      = pos;
+	pattern->address[0] = store->dst;
+
+	uintptr_t  operand[] = {binop->lhs, binop->rhs};
+	size_t    *at[]      = {&pattern->lhs, &pattern->rhs};
+
+	for (size_t side = 0; side < 2; side++) {
+		if (operand[side] >= loop->ir_iv.vregs) return false;
+
+		const ir_iv_def_t *loaded = &def[operand[side]];
+
+		if (loaded->bb != body || loaded->uses != 1) return false;
+		if (loaded->quad > pattern->binop) return false;
+		if (*quad[loaded->quad] != IR_QUAD_LOAD) return false;
+
+		ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+			quad[loaded->quad],
+			ir_quad_load_t);
+
+		if (load->type != IR_REG_TYPE_I32) return false;
+		if (load->src.type != IR_LOCATION_REG) return false;
+		if (private(loop, load->src.reg)) return false;
+
+		*at[side]                  = loaded->quad;
+		pattern->address[side + 1] = load->src.reg;
+	}
+
+	for (size_t i = 0; i < 3; i++)
+		if (!classify(loop, pattern->address[i], !i))
+			return false;
+
+	++loop->patterns;
+
+	return true;
+}
+
+static int function(vectorize_t *vectorize, ir_function_t *ir_function)
+{
+	if (!ir_function->bb.use) return 0;
+
+	vectorize->done.use = 0;
+
+	// new bbs move the rest around, so loops are found again after
+	// each one, and a header is only ever looked at once
+	for (;;) {
+		ir_cfg_t       ir_cfg;
+		ir_loop_nest_t ir_loop_nest;
+		bool           expanded = false;
+
+		int ret = ir_cfg_init(&ir_cfg, ir_function);
+		if (ret) return ret;
+
+		ret = ir_loop_nest_init(&ir_loop_nest, &ir_cfg);
+		if (ret) {
+			ir_cfg_free(&ir_cfg);
+			return ret;
+		}
+
+		ir_loop_t *ir_loop = ir_loop_nest.loop.buf;
+		ir_bb_t  **ir_bb   = ir_function->bb.buf;
+
+		for (size_t i = 0; i < ir_loop_nest.loop.use; i++) {
+			size_t  id   = ir_bb[ir_loop[i].header]->id;
+			size_t *done = vectorize->done.buf;
+			size_t  j    = 0;
+
+			while (j < vectorize->done.use && done[j] != id) ++j;
+
+			if (j < vectorize->done.use) continue;
+
+			ret = IR_ERROR_NOMEM;
+			if (vector_append(&vectorize->done, &id)) break;
+
+			vectorize_loop_t loop = {
+				.ir_function = ir_function,
+				.ir_cfg      = &ir_cfg,
+				.ir_loop     = &ir_loop[i],
+			};
+
+			ret = ir_iv_init(&loop.ir_iv, ir_function, &ir_loop[i]);
+			if (ret) break;
+
+			if (counted(&loop, &ir_loop_nest)) {
+				ret      = expand(vectorize, &loop);
+				expanded = !ret;
+			}
+
+			ir_iv_free(&loop.ir_iv);
+
+			if (ret || expanded) break;
+		}
+
+		ir_loop_nest_free(&ir_loop_nest);
+		ir_cfg_free(&ir_cfg);
+
+		if (ret || !expanded) return ret;
+	}
+}
+
+static int guard(
+	const vectorize_loop_t *loop,
+	const uintptr_t        *rename,
+	uintptr_t              *next,
+	size_t                  body,
+	ir_bb_t                *dst)
+{
+	ir_bb_t      **ir_bb   = loop->ir_function->bb.buf;
+	ir_bb_t       *header  = ir_bb[loop->ir_loop->header];
+	ir_quad_t    **quad    = header->quad.buf;
+	int64_t        step    = loop->counted.basic.step
+		* (VECTORIZE_LANES - 1);
+	uintptr_t      offset  = IR_REG_IMMEDIATE_GEN(step);
+	uintptr_t      last    = (*next)++;
+	uintptr_t      limit   = loop->counted.limit;
+	ir_quad_t     *ir_quad;
+	int            ret;
+
+	// the header as it computes its test
+	for (size_t i = 0; i + 3 < header->quad.use; i++) {
+		ir_quad_reg_t reg;
+
+		ret = IR_QUAD_CLONE(&ir_quad, quad[i]);
+		if (ret) return ret;
+
+		IR_QUAD_REG(ir_quad, &reg);
+
+		if (reg.def) *reg.def = rename[*reg.def];
+
+		for (size_t j = 0; j < IR_QUAD_REG_USES; j++)
+			if (reg.use[j]) *reg.use[j] = rename[*reg.use[j]];
+
+		ret = append(dst, ir_quad);
+		if (ret) return ret;
+	}
+
+	// a whole vector stays in bounds when its last lane does,
+	// checked in 64 bits, and what is left over goes around the
+	// original
+	if (!IR_REG_IS_IMMEDIATE(limit)) limit = rename[limit];
+
+	ret = ir_quad_binop_gen(
+		&ir_quad,
+		last,
+		IR_QUAD_BINOP_ADD,
+		IR_REG_TYPE_PTR,
+		rename[loop->counted.counter],
+		offset);
+	if (ret) return ret;
+
+	ret = append(dst, ir_quad);
+	if (ret) return ret;
+
+	ret = ir_quad_cmp_gen(&ir_quad, last, limit);
+	if (ret) return ret;
+
+	ret = append(dst, ir_quad);
+	if (ret) return ret;
+
+	ret = ir_quad_br_gen(&ir_quad, loop->counted.condition, body);
+	if (ret) return ret;
+
+	ret = append(dst, ir_quad);
+	if (ret) return ret;
+
+	ret = ir_quad_br_gen(&ir_quad, IR_QUAD_BR_AL, header->id);
+	if (ret) return ret;
+
+	return append(dst, ir_quad);
+}
+
+static bool inside(const vectorize_loop_t *loop, uintptr_t reg)
+{
+	if (reg >= loop->ir_iv.vregs) return false;
+
+	size_t bb = loop->ir_iv.def[reg].bb;
+
+	return bb != SIZE_MAX && BITSET_TEST(&loop->ir_loop->body, bb);
+}
+
+static const vectorize_pattern_t *member(
+	const vectorize_loop_t *loop,
+	size_t                  pos)
+{
+	const vectorize_pattern_t *pattern = loop->pattern;
+
+	for (size_t i = 0; i < loop->patterns; i++)
+		if (pattern[i].lhs == pos
+			|| pattern[i].rhs == pos
+			|| pattern[i].binop == pos
+			|| pattern[i].store == pos) return &pattern[i];
+
+	return NULL;
+}
+
+static bool private(const vectorize_loop_t *loop, uintptr_t cell)
+{
+	return cell < loop->ir_iv.vregs
+		&& BITSET_TEST(&loop->ir_iv.private, cell);
+}
+
+static bool scan(vectorize_loop_t *loop)
+{
+	ir_function_t     *ir_function = loop->ir_function;
+	ir_bb_t          **ir_bb       = ir_function->bb.buf;
+	const ir_iv_t     *ir_iv       = &loop->ir_iv;
+	const ir_iv_def_t *def         = ir_iv->def;
+	ir_iv_basic_t     *basic       = ir_iv->basic.buf;
+	size_t             body        = loop->body;
+	size_t             header      = loop->ir_loop->header;
+	ir_quad_t        **quad        = ir_bb[body]->quad.buf;
+	size_t             use         = ir_bb[body]->quad.use;
+	size_t             loads       = 0;
+
+	if (use > VECTORIZE_BODY_MAX) return false;
+
+	if (!use || *quad[use - 1] != IR_QUAD_BR) return false;
+
+	ir_quad_br_t *br = OFFSETOF_IR_QUAD(quad[use - 1], ir_quad_br_t);
+
+	if (br->condition != IR_QUAD_BR_AL) return false;
+	if (br->bb != ir_bb[header]->id) return false;
+
+	loop->first = use;
+
+	for (size_t i = 0; i + 1 < use; i++) {
+		switch (*quad[i]) {
+			case IR_QUAD_MOV:
+			case IR_QUAD_BINOP:
+				break;
+
+			case IR_QUAD_LOAD: {
+				ir_quad_load_t *load = OFFSETOF_IR_QUAD(
+					quad[i],
+					ir_quad_load_t);
+
+				if (load->src.type != IR_LOCATION_REG)
+					return false;
+
+				if (!private(loop, load->src.reg)) ++loads;
+
+				break;
+			}
+
+			case IR_QUAD_STORE: {
+				ir_quad_store_t *store = OFFSETOF_IR_QUAD(
+					quad[i],
+					ir_quad_store_t);
+
+				if (!private(loop, store->dst)) {
+					if (!fold(loop, i)) return false;
+					break;
+				}
+
+				// frame cells only ever step
+				size_t k = 0;
+
+				while (k < ir_iv->basic.use
+					&& basic[k].cell != store->dst) ++k;
+
+				if (k == ir_iv->basic.use) return false;
+
+				if (basic[k].type == IR_REG_TYPE_I32
+					&& (basic[k].step > INT32_MAX
+						/ VECTORIZE_LANES
+					|| basic[k].step < INT32_MIN
+						/ VECTORIZE_LANES))
+					return false;
+
+				if (i < loop->first) loop->first = i;
+
+				break;
+			}
+
+			default:
+				return false;
+		}
+	}
+
+	// every load through memory that may be shared is in a pattern
+	if (!loop->patterns || loads != loop->patterns * 2) return false;
+
+	// a pattern moves its loads down to its store, so no other
+	// store may come between them, and every address it uses is
+	// from before the basic ivs step
+	const vectorize_pattern_t *pattern = loop->pattern;
+
+	for (size_t i = 0; i < loop->patterns; i++) {
+		size_t from = (pattern[i].lhs < pattern[i].rhs)
+			? pattern[i].lhs
+			: pattern[i].rhs;
+
+		if (pattern[i].store > loop->first) return false;
+
+		for (size_t j = 0; j < loop->patterns; j++)
+			if (from < pattern[j].store
+				&& pattern[j].store < pattern[i].store)
+				return false;
+	}
+
+	// each copy renames what the loop defines
+	for (size_t i = 0; i < ir_function->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+		bool        in   = BITSET_TEST(&loop->ir_loop->body, i);
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			ir_quad_reg_t reg;
+
+			IR_QUAD_REG(quad[j], &reg);
+
+			if (in) {
+				if (reg.def && def[*reg.def].defs != 1)
+					return false;
+
+				if (i == body) continue;
+			}
+
+			for (size_t k = 0; k < IR_QUAD_REG_USES; k++) {
+				if (!reg.use[k]) continue;
+
+				if (def[*reg.use[k]].bb == body) return false;
+			}
+		}
+	}
+
+	const vectorize_stream_t *stream = loop->stream;
+
+	loop->checks = 0;
+
+	for (size_t i = 0; i < loop->streams; i++)
+		for (size_t j = i + 1; j < loop->streams; j++)
+			if (stream[i].store || stream[j].store) ++loop->checks;
+
+	return loop->checks <= VECTORIZE_CHECKS_MAX;
+}
+
+static int slice(
+	const vectorize_loop_t *loop,
+	uintptr_t               reg,
+	uintptr_t              *rename,
+	uintptr_t              *next,
+	ir_bb_t                *dst)
+{
+	if (!inside(loop, reg) || rename[reg] != reg) return 0;
+
+	ir_quad_t     *clone;
+	ir_quad_reg_t  use;
+
+	int ret = IR_QUAD_CLONE(&clone, definition(loop, reg));
+	if (ret) return ret;
+
+	IR_QUAD_REG(clone, &use);
+
+	// only loads from frame cells and arithmetic lead up to an
+	// address, so the whole of it is safe to compute early
+	for (size_t i = 0; i < IR_QUAD_REG_USES; i++) {
+		if (!use.use[i]) continue;
+
+		ret = slice(loop, *use.use[i], rename, next, dst);
+		if (ret) {
+			IR_QUAD_FREE(clone);
+			return ret;
+		}
+
+		*use.use[i] = rename[*use.use[i]];
+	}
+
+	rename[reg] = (*next)++;
+	*use.def    = rename[reg];
+
+	return append(dst, clone);
+}
+
+static size_t stepper(const vectorize_loop_t *loop, size_t pos)
+{
+	const ir_iv_t *ir_iv = &loop->ir_iv;
+	ir_iv_basic_t *basic = ir_iv->basic.buf;
+	ir_bb_t       *ir_bb = ((ir_bb_t**)
+		loop->ir_function->bb.buf)[loop->body];
+	ir_quad_t    **quad  = ir_bb->quad.buf;
+
+	for (size_t i = 0; i < ir_iv->basic.use; i++) {
+		if (basic[i].bb != loop->body) continue;
+
+		ir_quad_store_t *store = OFFSETOF_IR_QUAD(
+			quad[basic[i].quad],
+			ir_quad_store_t);
+
+		if (ir_iv->def[store->src].quad == pos) return i;
+	}
+
+	return SIZE_MAX;
+}
+
+static void widen(vector_t *vector, size_t pos, size_t count)
+{
+	// the room has to have been reserved already
+	uint8_t *buf = vector->buf;
+
+	memmove(
+		buf + (pos + count) * vector->element_size,
+		buf + pos * vector->element_size,
+		(vector->use - pos) * vector->element_size);
+
+	vector->use += count;
+}
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * json.c -- json output helpers
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/json.h>
+
+#include <stdio.h>
+
+
+void fprint_json_string(FILE *stream, const char *str)
+{
+	fputc('"', stream);
+
+	// write out runs that need no escaping in one go
+	const char *run = str;
+
+	for (; *str; str++) {
+		unsigned char c = *str;
+
+		if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+		fwrite(run, sizeof(*run), str - run, stream);
+		run = str + 1;
+
+		switch (c) {
+			case '"':
+				fputs("\\\"", stream);
+				break;
+
+			case '\\':
+				fputs("\\\\", stream);
+				break;
+
+			case '\n':
+				fputs("\\n", stream);
+				break;
+
+			case '\r':
+				fputs("\\r", stream);
+				break;
+
+			case '\t':
+				fputs("\\t", stream);
+				break;
+
+			default:
+				fprintf(stream, "\\u%04x", c);
+		}
+	}
+
+	fwrite(run, sizeof(*run), str - run, stream);
+
+	fputc('"', stream);
+}
@@ -7,6 +7,7 @@
 #include <jkcc/private/main.h>
 
 #include <argp.h>
+#include <errno.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,7 +17,11 @@
 #include <jkcc/ast.h>
 #include <jkcc/ir.h>
 #include <jkcc/jkcc.h>
+#include <jkcc/mem.h>
 #include <jkcc/parser.h>
+#include <jkcc/perf.h>
+#include <jkcc/sched.h>
+#include <jkcc/string.h>
 #include <jkcc/trace.h>
 #include <jkcc/vector.h>
 #include <jkcc/version.h>
@@ -26,10 +31,36 @@ const char *argp_program_version     = JKCC_VERSION;
 const char *argp_program_bug_address = "<jacobkoziej@gmail.com>";
 
 static const struct argp_option options[] = {
+	{
+		.key  = 'c',
+		.doc  = "Compile each FILE to an elf relocatable object; "
+			"do not link"
+	},
 	{
 		.key  = 'f',
 		.arg  = "OPTION",
-		.doc  = "Enable OPTION."
+		.doc  = "Enable OPTION; OPTION is 'clean-exit', "
+			"'print-ast[=jsonl]', 'print-ir[=jsonl]', "
+			"'pass=LIST' to run the comma-separated passes in "
+			"LIST instead of those of the -O level, or "
+			"'regalloc=K' to rewrite the ir onto K registers"
+	},
+	{
+		.key  = 'j',
+		.arg  = "JOBS",
+		.doc  = "Run function passes on JOBS threads;\n"
+			"'0' uses every online processor"
+	},
+	{
+		.key   = 'O',
+		.flags = OPTION_ARG_OPTIONAL,
+		.arg   = "LEVEL",
+		.doc   = "Optimize the ir;\nLEVEL is '0..2', '1' when omitted"
+	},
+	{
+		.key  = 'o',
+		.arg  = "FILE",
+		.doc  = "Write the object to FILE"
 	},
 	{
 		.name = "color",
@@ -37,6 +68,36 @@ static const struct argp_option options[] = {
 		.arg  = "WHEN",
 		.doc  = "Override color output;\nWHEN is 'stdout', 'stderr', 'always', or 'never'"
 	},
+	{
+		.name = "interpret",
+		.key  = KEY_INTERPRET,
+		.doc  = "Run main with the ir interpreter and report executed "
+			"quads;\nexits with the value main returns"
+	},
+	{
+		.name = "mem-report",
+		.key  = KEY_MEM_REPORT,
+		.doc  = "Report allocations by subsystem and leaks at exit;\n"
+			"implies '-f clean-exit'"
+	},
+	{
+		.name = "pass-stats",
+		.key  = KEY_PASS_STATS,
+		.doc  = "Report time, quads removed, and bbs removed "
+			"for each ir pass"
+	},
+	{
+		.name = "perf-counters",
+		.key  = KEY_PERF_COUNTERS,
+		.doc  = "Report hardware performance counters for each "
+			"compiler phase"
+	},
+	{
+		.name = "run",
+		.key  = KEY_RUN,
+		.doc  = "Compile to machine code in memory and run main;\n"
+			"exits with the value main returns"
+	},
 	{
 		.name  = "trace",
 		.key   = KEY_TRACE,
@@ -44,6 +105,21 @@ static const struct argp_option options[] = {
 		.arg   = "LEVEL",
 		.doc   = "Enable execution traces;\nLEVEL is '0..3'"
 	},
+	{
+		.name  = "trace-binary",
+		.key   = KEY_TRACE_BINARY,
+		.arg   = "FILE",
+		.doc   = "Write execution traces as binary records to FILE;\n"
+			"decode them with jkcc-trace-decode"
+	},
+	{
+		.name  = "trace-sites",
+		.key   = KEY_TRACE_SITES,
+		.arg   = "PATTERN",
+		.doc   = "Only trace sites matching PATTERN;\n"
+			"PATTERN is a glob over 'FILE:FUNC:LINE' "
+			"or the rule name"
+	},
 	{0},
 };
 
@@ -53,6 +129,16 @@ static const struct argp argp = {
 	.args_doc = "[FILE]...",
 };
 
+#ifdef JKCC_CONFIG_OPTION_MEM_CENSUS
+static const char *const *const mem_kind_str[MEM_TAGS_TOTAL] = {
+	[MEM_TAG_AST]     = ast_node_str,
+	[MEM_TAG_IR_QUAD] = ir_quad_str,
+};
+
+_Static_assert(AST_NODES_TOTAL <= MEM_KINDS_MAX, "too many ast kinds");
+_Static_assert(IR_QUAD_TOTAL <= MEM_KINDS_MAX, "too many ir quad kinds");
+#endif  /* JKCC_CONFIG_OPTION_MEM_CENSUS */
+
 static jkcc_t jkcc;
 
 
@@ -64,7 +150,15 @@ int main(int argc, char **argv)
 	jkcc.config.ansi_sgr_stdout = isatty(STDOUT_FILENO);
 	jkcc.config.ansi_sgr_stderr = isatty(STDERR_FILENO);
 
+	jkcc.trace.binary = -1;
+
 	const char *JKCC_TRACE = getenv("JKCC_TRACE");
+#ifndef JKCC_CONFIG_OPTION_TRACE
+	if (JKCC_TRACE)
+		fprintf(
+			stderr,
+			"warning: trace: support disabled at build time\n");
+#else
 	if (JKCC_TRACE) {
 		int level = atoi(JKCC_TRACE);
 
@@ -80,22 +174,56 @@ int main(int argc, char **argv)
 		jkcc.trace.ansi_sgr = jkcc.config.ansi_sgr_stderr;
 		jkcc.trace.level    = level;
 	}
+#endif  /* JKCC_CONFIG_OPTION_TRACE */
 
 	argp_parse(&argp, argc, argv, 0, 0, &jkcc);
 
-	ast_t     *translation_unit;
-	ir_unit_t *ir_unit;
+	if (jkcc.trace_binary)
+		if (trace_binary_open(&jkcc.trace, jkcc.trace_binary)) {
+			fprintf(
+				stderr,
+				"error: trace: cannot open '%s'\n",
+				jkcc.trace_binary);
+			return EXIT_FAILURE;
+		}
+
+	// ahead of the workers, so that they inherit the counters
+	if (jkcc.config.perf_counters && perf_open(&jkcc.perf))
+		fprintf(
+			stderr,
+			"warning: perf: counters unavailable: %s\n",
+			strerror(errno));
+
+	if (jkcc.jobs) {
+		if (sched_init(&jkcc.sched, jkcc.jobs)) {
+			fprintf(
+				stderr,
+				"error: sched: cannot start %zu workers\n",
+				jkcc.jobs);
+			return EXIT_FAILURE;
+		}
+
+		jkcc.pass_manager.sched = &jkcc.sched;
+	}
+
+	ast_t         *translation_unit;
+	ir_unit_t     *ir_unit;
+	perf_sample_t  perf_sample;
 
 	if (vector_init(&jkcc.translation_unit, sizeof(translation_unit), 0))
 		return EXIT_FAILURE;
 
 	if (vector_init(&jkcc.ir_unit, sizeof(ir_unit), 0)) goto error;
 
+	if (vector_init(&jkcc.perf_sample, sizeof(perf_sample), 0))
+		goto error;
+
 	parser_t parser = {
 		.path  = NULL,
 		.trace = &jkcc.trace,
 	};
 	size_t processed = 0;
+	int    status    = -1;  // of an interpreted or jitted main
 
 	if (!jkcc.file_count) goto parse_stdin;
 
@@ -103,15 +231,29 @@ int main(int argc, char **argv)
 		parser.path = jkcc.file[processed];
 
 parse_stdin:
+		memset(&perf_sample, 0, sizeof(perf_sample));
+
+		perf_begin(&jkcc.perf);
 		translation_unit = parse(&parser);
+		perf_end(&jkcc.perf, &perf_sample, PERF_PHASE_PARSE);
 		if (!translation_unit) goto error;
 
+		perf_begin(&jkcc.perf);
+
 		if (jkcc.config.print_ast)
 			FPRINT_AST_NODE(stdout, translation_unit, 0, 0);
 
+		if (jkcc.config.print_ast_jsonl)
+			if (fprint_ast_jsonl(stdout, translation_unit))
+				goto error;
+
+		perf_end(&jkcc.perf, &perf_sample, PERF_PHASE_PRINT);
+
 		if (vector_append(&jkcc.translation_unit, &translation_unit))
 			goto error;
 
+		if (vector_append(&jkcc.perf_sample, &perf_sample)) goto error;
+
 		++processed;
 	}
 
@@ -119,9 +261,14 @@ parse_stdin:
 		ir_unit = ir_unit_alloc();
 		if (!ir_unit) goto error;
 
-		ast_t **translation_unit = jkcc.translation_unit.buf;
+		ast_t         **translation_unit = jkcc.translation_unit.buf;
+		perf_sample_t  *sample           = jkcc.perf_sample.buf;
+
+		perf_begin(&jkcc.perf);
+		int ret = ir_unit_gen(ir_unit, translation_unit[i]);
+		perf_end(&jkcc.perf, &sample[i], PERF_PHASE_IR_GEN);
 
-		switch (ir_unit_gen(ir_unit, translation_unit[i])) {
+		switch (ret) {
 			case IR_ERROR_EMPTY_TRANSLATION_UNIT:
 				break;
 
@@ -132,13 +279,93 @@ parse_stdin:
 				goto error;
 		}
 
+		perf_begin(&jkcc.perf);
+		ret = ir_pass_manager_run(&jkcc.pass_manager, ir_unit);
+		perf_end(&jkcc.perf, &sample[i], PERF_PHASE_OPT);
+
+		if (ret) goto error;
+
+		perf_begin(&jkcc.perf);
+		ret = (jkcc.registers)
+			? ir_regalloc_unit(ir_unit, jkcc.registers)
+			: 0;
+		perf_end(&jkcc.perf, &sample[i], PERF_PHASE_REGALLOC);
+
+		switch (ret) {
+			case IR_ERROR_REGISTER_PRESSURE:
+				fprintf(
+					stderr,
+					"error: regalloc: too few registers "
+					"(%zu) for the operands of a quad\n",
+					jkcc.registers);
+				goto error;
+
+			case 0:
+				break;
+
+			default:
+				goto error;
+		}
+
+		perf_begin(&jkcc.perf);
+
 		if (jkcc.config.print_ir)
 			ir_unit_fprint(stdout, ir_unit);
 
+		if (jkcc.config.print_ir_jsonl)
+			ir_unit_fprint_jsonl(stdout, ir_unit);
+
+		perf_end(&jkcc.perf, &sample[i], PERF_PHASE_PRINT);
+
 		if (vector_append(&jkcc.ir_unit, &ir_unit)) goto error;
+
+		perf_begin(&jkcc.perf);
+		ret = (jkcc.config.interpret) ? interpret(ir_unit, &status) : 0;
+		perf_end(&jkcc.perf, &sample[i], PERF_PHASE_INTERP);
+
+		if (ret) goto error;
+
+		perf_begin(&jkcc.perf);
+		ret = (jkcc.config.run) ? run(ir_unit, &status) : 0;
+		perf_end(&jkcc.perf, &sample[i], PERF_PHASE_JIT);
+
+		if (ret) goto error;
+
+		perf_begin(&jkcc.perf);
+		ret = (jkcc.config.compile)
+			? compile(
+				ir_unit,
+				(jkcc.file_count) ? jkcc.file[i] : NULL)
+			: 0;
+		perf_end(&jkcc.perf, &sample[i], PERF_PHASE_EMIT);
+
+		if (ret) goto error;
+	}
+
+	if ((jkcc.config.interpret || jkcc.config.run) && status < 0) {
+		fprintf(
+			stderr,
+			"error: %s: no 'main' to run\n",
+			(jkcc.config.run) ? "jit" : "interp");
+		goto error;
 	}
 
-	return EXIT_SUCCESS;
+	if (jkcc.config.pass_stats)
+		ir_pass_manager_fprint(stderr, &jkcc.pass_manager);
+
+	for (size_t i = 0; i < jkcc.perf_sample.use; i++) {
+		perf_sample_t *sample = jkcc.perf_sample.buf;
+
+		perf_sample_fprint(
+			stderr,
+			&jkcc.perf,
+			&sample[i],
+			(jkcc.file_count) ? jkcc.file[i] : "<stdin>");
+	}
+
+	return (jkcc.config.interpret || jkcc.config.run)
+		? status
+		: EXIT_SUCCESS;
 
 error:
 	return EXIT_FAILURE;
@@ -147,6 +374,11 @@ error:
 
 static void cleanup(void)
 {
+	// buffered trace records are lost otherwise
+	trace_binary_close(&jkcc.trace);
+
+	perf_close(&jkcc.perf);
+
 	if (!jkcc.config.clean_exit) return;
 
 	if (jkcc.translation_unit.buf) {
@@ -166,6 +398,159 @@ static void cleanup(void)
 
 		vector_free(&jkcc.ir_unit);
 	}
+
+	if (jkcc.perf_sample.buf) vector_free(&jkcc.perf_sample);
+
+	sched_free(&jkcc.sched);
+
+#ifdef JKCC_CONFIG_OPTION_MEM_CENSUS
+	if (jkcc.config.mem_report) mem_report(stderr, mem_kind_str);
+#endif  /* JKCC_CONFIG_OPTION_MEM_CENSUS */
+}
+
+static int compile(ir_unit_t *ir_unit, const char *file)
+{
+	ir_codegen_t ir_codegen;
+	string_t     path = {0};
+	int          ret  = IR_ERROR_NOMEM;
+
+	if (ir_codegen_init(&ir_codegen, ir_unit)) return IR_ERROR_NOMEM;
+
+	const char *output = jkcc.output;
+
+	// foo/bar.c becomes bar.o in the working directory
+	if (!output) {
+		const char *base = (file) ? strrchr(file, '/') : NULL;
+		const char *name = (base) ? base + 1 : (file) ? file : "a.c";
+		const char *ext  = strrchr(name, '.');
+
+		if (string_init(&path, 0)) goto error;
+
+		if (string_append(
+			&path,
+			name,
+			(ext && ext != name) ? (size_t) (ext - name) : 0))
+			goto error;
+
+		if (string_append(&path, ".o", 0)) goto error;
+
+		output = path.head;
+	}
+
+	FILE *stream = fopen(output, "wb");
+
+	if (!stream) {
+		fprintf(
+			stderr,
+			"error: elf: cannot open '%s': %s\n",
+			output,
+			strerror(errno));
+		goto error;
+	}
+
+	ret = ir_elf_write(stream, &ir_codegen, (file) ? file : "<stdin>");
+
+	if (fclose(stream) && !ret) ret = IR_ERROR_WRITE;
+
+	if (ret == IR_ERROR_WRITE)
+		fprintf(stderr, "error: elf: cannot write '%s'\n", output);
+
+error:
+	string_free(&path);
+	ir_codegen_free(&ir_codegen);
+
+	return ret;
+}
+
+static int interpret(ir_unit_t *ir_unit, int *status)
+{
+	ir_interp_t ir_interp;
+	int64_t     ret;
+
+	if (ir_interp_init(&ir_interp, ir_unit)) return IR_ERROR_NOMEM;
+
+	if (!ir_interp_lookup(&ir_interp, "main")) {
+		ir_interp_free(&ir_interp);
+		return 0;
+	}
+
+	int error = ir_interp_run(&ir_interp, "main", &ret);
+
+	// keep what the program printed ahead of the report
+	fflush(stdout);
+
+	if (error) {
+		fprintf(
+			stderr,
+			"error: interp: %s in @%s",
+			ir_interp_trap_str(ir_interp.trap),
+			ir_interp.trap_function);
+
+		if (ir_interp.trap_symbol)
+			fprintf(stderr, " calling @%s", ir_interp.trap_symbol);
+
+		fprintf(stderr, "\n");
+	}
+
+	ir_interp_fprint(stderr, &ir_interp);
+	ir_interp_free(&ir_interp);
+
+	*status = (error) ? EXIT_FAILURE : (unsigned char) ret;
+
+	return error;
+}
+
+static int run(ir_unit_t *ir_unit, int *status)
+{
+	ir_codegen_t ir_codegen;
+	ir_jit_t     ir_jit;
+	int64_t      ret;
+
+	if (ir_codegen_init(&ir_codegen, ir_unit)) return IR_ERROR_NOMEM;
+
+	ir_codegen_symbol_t *entry = ir_codegen_lookup(&ir_codegen, "main");
+
+	if (!entry || entry->section != IR_CODEGEN_SECTION_TEXT) {
+		ir_codegen_free(&ir_codegen);
+		return 0;
+	}
+
+	int error = ir_jit_init(&ir_jit, &ir_codegen);
+
+	switch (error) {
+		case IR_ERROR_UNDEFINED_SYMBOL:
+			fprintf(
+				stderr,
+				"error: jit: undefined symbol '%s'\n",
+				ir_jit.undefined);
+			break;
+
+		case IR_ERROR_UNSUPPORTED_HOST:
+			fprintf(
+				stderr,
+				"error: jit: only x86-64 system v hosts "
+				"are supported\n");
+			break;
+
+		default:
+			break;
+	}
+
+	if (error) goto error;
+
+	ir_jit_run(&ir_jit, "main", &ret);
+
+	// keep what the program printed ahead of anything we print
+	fflush(stdout);
+
+	ir_jit_free(&ir_jit);
+
+	*status = (unsigned char) ret;
+
+error:
+	ir_codegen_free(&ir_codegen);
+
+	return error;
 }
 
 static error_t parse_opt(int key, char *arg, struct argp_state *state)
@@ -182,6 +567,30 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
 			state->next = state->argc;
 			break;
 
+		case ARGP_KEY_END:
+			if (jkcc->output && jkcc->file_count > 1)
+				argp_error(
+					state,
+					"'-o' with multiple files");
+
+			ir_pass_manager_init(
+				&jkcc->pass_manager,
+				jkcc->opt_level);
+
+			if (jkcc->passes && ir_pass_manager_parse(
+				&jkcc->pass_manager,
+				jkcc->passes))
+				argp_error(
+					state,
+					"invalid pass list: '%s'",
+					jkcc->passes);
+
+			break;
+
+		case 'c':
+			jkcc->config.compile = 1;
+			break;
+
 		case 'f':
 			if (!strcmp(arg, "clean-exit")) {
 				jkcc->config.clean_exit = 1;
@@ -193,14 +602,87 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
 				break;
 			}
 
+			if (!strcmp(arg, "print-ast=jsonl")) {
+				jkcc->config.print_ast_jsonl = 1;
+				break;
+			}
+
 			if (!strcmp(arg, "print-ir")) {
 				jkcc->config.print_ir = 1;
 				break;
 			}
 
+			if (!strcmp(arg, "print-ir=jsonl")) {
+				jkcc->config.print_ir_jsonl = 1;
+				break;
+			}
+
+			if (!strncmp(arg, F_PASS, F_PASS_LEN)) {
+				jkcc->passes = arg + F_PASS_LEN;
+				break;
+			}
+
+			if (!strncmp(arg, F_REGALLOC, F_REGALLOC_LEN)) {
+				const char *registers = arg + F_REGALLOC_LEN;
+				char       *end;
+
+				errno = 0;
+				jkcc->registers = strtoul(registers, &end, 10);
+
+				if (errno
+					|| !*registers
+					|| *end
+					|| !jkcc->registers)
+					argp_error(
+						state,
+						"invalid register count: '%s'",
+						registers);
+
+				break;
+			}
+
 			argp_error(state, "unrecognized option: '%s'", arg);
 			break;
 
+		case 'j': {
+			char *end;
+
+			errno = 0;
+			long jobs = strtol(arg, &end, 10);
+
+			if (errno || !*arg || *end || jobs < 0)
+				argp_error(
+					state,
+					"invalid job count: '%s'",
+					arg);
+
+			if (!jobs) jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+			jkcc->jobs = (jobs > 0) ? jobs : 1;
+			break;
+		}
+
+		case 'O':
+			if (!arg) {
+				jkcc->opt_level = 1;
+				break;
+			}
+
+			if (strlen(arg) != 1
+				|| *arg < '0'
+				|| *arg > '0' + IR_PASS_LEVEL_MAX)
+				argp_error(
+					state,
+					"invalid optimization level: '%s'",
+					arg);
+
+			jkcc->opt_level = *arg - '0';
+			break;
+
+		case 'o':
+			jkcc->output = arg;
+			break;
+
 		case KEY_COLOR:
 			if (!strcmp(arg, "stdout")) {
 				jkcc->config.ansi_sgr_stdout = 1;
@@ -229,6 +711,43 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
 			argp_error(state, "unrecognized argument: '%s'", arg);
 			break;
 
+		case KEY_INTERPRET:
+			jkcc->config.interpret = 1;
+			break;
+
+		case KEY_MEM_REPORT:
+#ifndef JKCC_CONFIG_OPTION_MEM_CENSUS
+			argp_error(
+				state,
+				"memory census disabled at build time");
+#endif  /* JKCC_CONFIG_OPTION_MEM_CENSUS */
+
+			// anything still allocated afterwards is a real leak
+			jkcc->config.clean_exit = 1;
+			jkcc->config.mem_report = 1;
+			break;
+
+		case KEY_PASS_STATS:
+			jkcc->config.pass_stats = 1;
+			break;
+
+		case KEY_PERF_COUNTERS:
+			jkcc->config.perf_counters = 1;
+			break;
+
+		case KEY_RUN:
+			jkcc->config.run = 1;
+			break;
+
+#ifndef JKCC_CONFIG_OPTION_TRACE
+		case KEY_TRACE:
+		case KEY_TRACE_BINARY:
+		case KEY_TRACE_SITES:
+			argp_error(
+				state,
+				"trace support disabled at build time");
+			break;
+#else
 		case KEY_TRACE:;
 			int level = JKCC_TRACE_LEVEL_LOW;
 
@@ -250,6 +769,39 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
 
 			break;
 
+		case KEY_TRACE_BINARY:
+			jkcc->config.trace = 1;
+
+			jkcc->trace_binary = arg;
+
+			if (jkcc->trace.level < JKCC_TRACE_LEVEL_LOW)
+				jkcc->trace.level = JKCC_TRACE_LEVEL_LOW;
+
+			break;
+
+		case KEY_TRACE_SITES:
+			// the first pattern narrows down from every site
+			if (!jkcc->config.trace_sites) trace_sites_set(false);
+
+			jkcc->config.trace_sites = 1;
+
+			if (!trace_sites_enable(arg))
+				fprintf(
+					stderr,
+					"warning: trace: no sites match '%s'\n",
+					arg);
+
+			if (jkcc->trace.level >= JKCC_TRACE_LEVEL_LOW) break;
+
+			jkcc->config.trace = 1;
+
+			jkcc->trace.stream   = stderr;
+			jkcc->trace.ansi_sgr = jkcc->config.ansi_sgr_stderr;
+			jkcc->trace.level    = JKCC_TRACE_LEVEL_LOW;
+
+			break;
+#endif  /* JKCC_CONFIG_OPTION_TRACE */
+
 		default:
 			return ARGP_ERR_UNKNOWN;
 	}
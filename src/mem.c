@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * mem.c -- tagged memory allocation
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/mem.h>
+#include <jkcc/private/mem.h>
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+static mem_stat_t census[MEM_TAGS_TOTAL][MEM_KINDS_MAX];
+static mem_stat_t total;
+
+static const char *const tag_str[MEM_TAGS_TOTAL] = {
+	[MEM_TAG_AST]     = "ast",
+	[MEM_TAG_BITSET]  = "bitset",
+	[MEM_TAG_HT]      = "ht",
+	[MEM_TAG_IR]      = "ir",
+	[MEM_TAG_IR_QUAD] = "ir-quad",
+	[MEM_TAG_PARSER]  = "parser",
+	[MEM_TAG_SCHED]   = "sched",
+	[MEM_TAG_SCOPE]   = "scope",
+	[MEM_TAG_STRING]  = "string",
+	[MEM_TAG_SYMBOL]  = "symbol",
+	[MEM_TAG_VECTOR]  = "vector",
+	[MEM_TAG_X86]     = "x86",
+};
+
+static const char *const ht_str[MEM_HT_TOTAL] = {
+	[MEM_HT_ENTRIES] = "entries",
+	[MEM_HT_KEY]     = "key",
+};
+
+static const char *const ir_str[MEM_IR_TOTAL] = {
+	[MEM_IR_ALIAS]              = "alias",
+	[MEM_IR_BB]                 = "bb",
+	[MEM_IR_CALLGRAPH]          = "callgraph",
+	[MEM_IR_CFG]                = "cfg",
+	[MEM_IR_CODEGEN]            = "codegen",
+	[MEM_IR_DATAFLOW]           = "dataflow",
+	[MEM_IR_ELF]                = "elf",
+	[MEM_IR_FUNCTION]           = "function",
+	[MEM_IR_INTERP]             = "interp",
+	[MEM_IR_JIT]                = "jit",
+	[MEM_IR_LOOP]               = "loop",
+	[MEM_IR_PASS]               = "pass",
+	[MEM_IR_REGALLOC]           = "regalloc",
+	[MEM_IR_STATIC_DECLARATION] = "static-declaration",
+	[MEM_IR_UNIT]               = "unit",
+};
+
+static const char *const sched_str[MEM_SCHED_TOTAL] = {
+	[MEM_SCHED_ARENA]  = "arena",
+	[MEM_SCHED_DEQUE]  = "deque",
+	[MEM_SCHED_WORKER] = "worker",
+};
+
+
+void *mem_calloc(
+	mem_tag_t   tag,
+	unsigned    kind,
+	size_t      nmemb,
+	size_t      size)
+{
+	if (size && nmemb > (size_t) -1 / size) return NULL;
+
+	void *ptr = mem_malloc(tag, kind, nmemb * size);
+	if (!ptr) return NULL;
+
+	memset(ptr, 0, nmemb * size);
+
+	return ptr;
+}
+
+void mem_free(
+	void       *ptr)
+{
+	if (!ptr) return;
+
+	mem_header_t *header = ((mem_header_t*) ptr) - 1;
+
+	mem_stat_t *stat = &census[header->info.tag][header->info.kind];
+
+	stat_free(stat, header->info.size);
+	stat_free(&total, header->info.size);
+
+	free(header);
+}
+
+void *mem_malloc(
+	mem_tag_t   tag,
+	unsigned    kind,
+	size_t      size)
+{
+	if (size > (size_t) -1 - sizeof(mem_header_t)) return NULL;
+
+	mem_header_t *header = malloc(sizeof(*header) + size);
+	if (!header) return NULL;
+
+	header->info.size = size;
+	header->info.tag  = tag;
+	header->info.kind = kind;
+
+	stat_alloc(&census[tag][kind], size);
+	stat_alloc(&total, size);
+
+	return header + 1;
+}
+
+void *mem_realloc(
+	mem_tag_t   tag,
+	unsigned    kind,
+	void       *ptr,
+	size_t      size)
+{
+	if (!ptr) return mem_malloc(tag, kind, size);
+
+	if (size > (size_t) -1 - sizeof(mem_header_t)) return NULL;
+
+	mem_header_t *header = ((mem_header_t*) ptr) - 1;
+	size_t        old    = header->info.size;
+
+	// the block keeps the tag it was first allocated under
+	header = realloc(header, sizeof(*header) + size);
+	if (!header) return NULL;
+
+	header->info.size = size;
+
+	mem_stat_t *stat = &census[header->info.tag][header->info.kind];
+
+	stat_realloc(stat, old, size);
+	stat_realloc(&total, old, size);
+
+	return header + 1;
+}
+
+void mem_report(
+	FILE              *stream,
+	const char *const *const kind_str[MEM_TAGS_TOTAL])
+{
+	fprintf(
+		stream,
+		"mem: %-32s %10s %10s %10s %12s %12s %10s %12s\n",
+		"tag",
+		"allocs",
+		"frees",
+		"reallocs",
+		"bytes",
+		"peak",
+		"leaks",
+		"leaked-bytes");
+
+	for (size_t i = 0; i < MEM_TAGS_TOTAL; i++)
+		for (size_t j = 0; j < MEM_KINDS_MAX; j++) {
+			if (!atomic_load(&census[i][j].allocs)) continue;
+
+			char name[64];
+
+			const char *kind = (kind_str[i])
+				? kind_str[i][j]
+				: tag_kind_str(i, j);
+
+			snprintf(
+				name,
+				sizeof(name),
+				(kind) ? "%s/%s" : "%s",
+				tag_str[i],
+				kind);
+
+			stat_fprint(stream, name, &census[i][j]);
+		}
+
+	stat_fprint(stream, "total", &total);
+}
+
+char *mem_strdup(
+	mem_tag_t   tag,
+	unsigned    kind,
+	const char *str)
+{
+	size_t len = strlen(str) + 1;
+
+	char *dup = mem_malloc(tag, kind, len);
+	if (!dup) return NULL;
+
+	return memcpy(dup, str, len);
+}
+
+
+static const char *tag_kind_str(unsigned tag, unsigned kind)
+{
+	switch (tag) {
+		case MEM_TAG_HT:
+			return (kind < MEM_HT_TOTAL) ? ht_str[kind] : NULL;
+
+		case MEM_TAG_IR:
+			return (kind < MEM_IR_TOTAL) ? ir_str[kind] : NULL;
+
+		case MEM_TAG_SCHED:
+			return (kind < MEM_SCHED_TOTAL)
+				? sched_str[kind]
+				: NULL;
+
+		default:
+			return NULL;
+	}
+}
+
+static void stat_alloc(mem_stat_t *stat, size_t size)
+{
+	atomic_fetch_add_explicit(&stat->allocs, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&stat->bytes, size, memory_order_relaxed);
+
+	size_t live = atomic_fetch_add_explicit(
+		&stat->live,
+		size,
+		memory_order_relaxed);
+
+	stat_peak(stat, live + size);
+}
+
+static void stat_free(mem_stat_t *stat, size_t size)
+{
+	atomic_fetch_add_explicit(&stat->frees, 1, memory_order_relaxed);
+	atomic_fetch_sub_explicit(&stat->live, size, memory_order_relaxed);
+}
+
+static void stat_fprint(
+	FILE             *stream,
+	const char       *name,
+	mem_stat_t       *stat)
+{
+	size_t allocs = atomic_load(&stat->allocs);
+	size_t frees  = atomic_load(&stat->frees);
+
+	fprintf(
+		stream,
+		"mem: %-32s %10zu %10zu %10zu %12zu %12zu %10zu %12zu\n",
+		name,
+		allocs,
+		frees,
+		atomic_load(&stat->reallocs),
+		atomic_load(&stat->bytes),
+		atomic_load(&stat->peak),
+		allocs - frees,
+		atomic_load(&stat->live));
+}
+
+static void stat_peak(mem_stat_t *stat, size_t live)
+{
+	size_t peak = atomic_load_explicit(&stat->peak, memory_order_relaxed);
+
+	while (peak < live && !atomic_compare_exchange_weak_explicit(
+		&stat->peak,
+		&peak,
+		live,
+		memory_order_relaxed,
+		memory_order_relaxed));
+}
+
+static void stat_realloc(mem_stat_t *stat, size_t old, size_t new)
+{
+	atomic_fetch_add_explicit(&stat->reallocs, 1, memory_order_relaxed);
+
+	if (new < old) {
+		atomic_fetch_sub_explicit(
+			&stat->live,
+			old - new,
+			memory_order_relaxed);
+		return;
+	}
+
+	atomic_fetch_add_explicit(
+		&stat->bytes,
+		new - old,
+		memory_order_relaxed);
+
+	size_t live = atomic_fetch_add_explicit(
+		&stat->live,
+		new - old,
+		memory_order_relaxed);
+
+	stat_peak(stat, live + new - old);
+}
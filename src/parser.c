@@ -19,6 +19,8 @@
 #include "y.tab.h"
 #include "lex.yy.h"
 
+#include <jkcc/mem.h>
+
 
 ast_t *parse(parser_t *parser)
 {
@@ -37,10 +39,13 @@ ast_t *parse(parser_t *parser)
 	file_allocated = ast_translation_unit_get_file(translation_unit);
 	base_type      = ast_translation_unit_get_base_type(translation_unit);
 
-	file = calloc(1, sizeof(*file));
+	file = MEM_CALLOC(MEM_TAG_PARSER, 0, 1, sizeof(*file));
 	if (!file) goto error;
 
-	file->path = strdup((parser->path) ? parser->path : "/dev/stdin");
+	file->path = MEM_STRDUP(
+		MEM_TAG_PARSER,
+		0,
+		(parser->path) ? parser->path : "/dev/stdin");
 	if (!file->path) goto error;
 
 	if (vector_append(file_allocated, &file)) goto error;
@@ -101,8 +106,8 @@ error:
 	scope_free(symbol_table);
 
 	if (file) {
-		if (file->path) free(file->path);
-		free(file);
+		if (file->path) MEM_FREE(file->path);
+		MEM_FREE(file);
 	}
 
 	AST_NODE_FREE(translation_unit);
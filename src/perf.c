@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * perf.c -- hardware performance counters
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/perf.h>
+#include <jkcc/private/perf.h>
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+static const uint64_t counter_config[PERF_COUNTERS_TOTAL] = {
+	[PERF_COUNTER_CYCLES]        = PERF_COUNT_HW_CPU_CYCLES,
+	[PERF_COUNTER_INSTRUCTIONS]  = PERF_COUNT_HW_INSTRUCTIONS,
+	[PERF_COUNTER_CACHE_MISSES]  = PERF_COUNT_HW_CACHE_MISSES,
+	[PERF_COUNTER_BRANCH_MISSES] = PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+static const char *const counter_str[PERF_COUNTERS_TOTAL] = {
+	[PERF_COUNTER_CYCLES]        = "cycles",
+	[PERF_COUNTER_INSTRUCTIONS]  = "instructions",
+	[PERF_COUNTER_CACHE_MISSES]  = "cache-misses",
+	[PERF_COUNTER_BRANCH_MISSES] = "branch-misses",
+};
+
+static const char *const phase_str[PERF_PHASES_TOTAL] = {
+	[PERF_PHASE_PARSE]    = "parse",
+	[PERF_PHASE_IR_GEN]   = "ir-gen",
+	[PERF_PHASE_OPT]      = "opt",
+	[PERF_PHASE_REGALLOC] = "regalloc",
+	[PERF_PHASE_INTERP]   = "interp",
+	[PERF_PHASE_JIT]      = "jit",
+	[PERF_PHASE_EMIT]     = "emit",
+	[PERF_PHASE_PRINT]    = "print",
+};
+
+
+void perf_begin(perf_t *perf)
+{
+	if (!perf->enabled) return;
+
+	for (size_t i = 0; i < PERF_COUNTERS_TOTAL; i++)
+		perf->start[i] = read_counter(perf->fd[i]);
+}
+
+void perf_close(perf_t *perf)
+{
+	if (!perf->enabled) return;
+
+	for (size_t i = 0; i < PERF_COUNTERS_TOTAL; i++)
+		if (perf->fd[i] >= 0) close(perf->fd[i]);
+
+	perf->enabled = false;
+}
+
+void perf_end(perf_t *perf, perf_sample_t *sample, perf_phase_t phase)
+{
+	if (!perf->enabled) return;
+
+	for (size_t i = 0; i < PERF_COUNTERS_TOTAL; i++)
+		sample->value[phase][i]
+			+= read_counter(perf->fd[i]) - perf->start[i];
+}
+
+int perf_open(perf_t *perf)
+{
+	struct perf_event_attr attr = {
+		.type           = PERF_TYPE_HARDWARE,
+		.size           = sizeof(attr),
+		.exclude_kernel = 1,
+		.exclude_hv     = 1,
+		.inherit        = 1,
+	};
+
+	size_t opened = 0;
+	int    error  = 0;
+
+	// counters are opened one at a time so that a PMU missing a
+	// single event (common under virtualization) keeps the rest, and
+	// are inherited so that reads include every thread started after
+	// this, -j workers among them
+	for (size_t i = 0; i < PERF_COUNTERS_TOTAL; i++) {
+		attr.config = counter_config[i];
+
+		perf->fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+
+		if (perf->fd[i] < 0) {
+			error = errno;
+			continue;
+		}
+
+		++opened;
+	}
+
+	if (!opened) {
+		errno = error;
+		return -1;
+	}
+
+	perf->enabled = true;
+
+	return 0;
+}
+
+void perf_sample_fprint(
+	FILE                *stream,
+	const perf_t        *perf,
+	const perf_sample_t *sample,
+	const char          *name)
+{
+	if (!perf->enabled) return;
+
+	fprintf(stream, "perf: %s\n", name);
+
+	fprintf(stream, "perf: %-8s", "phase");
+	for (size_t i = 0; i < PERF_COUNTERS_TOTAL; i++)
+		fprintf(stream, " %16s", counter_str[i]);
+	fprintf(stream, "\n");
+
+	for (size_t i = 0; i < PERF_PHASES_TOTAL; i++) {
+		fprintf(stream, "perf: %-8s", phase_str[i]);
+
+		for (size_t j = 0; j < PERF_COUNTERS_TOTAL; j++) {
+			if (perf->fd[j] < 0) {
+				fprintf(stream, " %16s", "n/a");
+				continue;
+			}
+
+			fprintf(
+				stream,
+				" %16lu",
+				(unsigned long) sample->value[i][j]);
+		}
+
+		fprintf(stream, "\n");
+	}
+}
+
+
+static uint64_t read_counter(int fd)
+{
+	uint64_t value = 0;
+
+	if (fd < 0) return 0;
+
+	if (read(fd, &value, sizeof(value)) != sizeof(value)) return 0;
+
+	return value;
+}
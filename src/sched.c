@@ -0,0 +1,572 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * sched.c -- work-stealing task scheduler
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/sched.h>
+#include <jkcc/private/sched.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jkcc/mem.h>
+
+
+static _Thread_local sched_worker_t *self;
+
+
+void *sched_alloc(sched_t *sched, size_t size)
+{
+	sched_worker_t *worker = current(sched);
+
+	return (worker) ? arena_alloc(&worker->arena, size) : NULL;
+}
+
+void sched_free(sched_t *sched)
+{
+	if (!sched->worker) return;
+
+	pthread_mutex_lock(&sched->mutex);
+	atomic_store(&sched->stop, true);
+	pthread_cond_broadcast(&sched->cond);
+	pthread_mutex_unlock(&sched->mutex);
+
+	for (size_t i = 1; i < sched->workers; i++)
+		if (sched->worker[i].started)
+			pthread_join(sched->worker[i].thread, NULL);
+
+	for (size_t i = 0; i < sched->workers; i++) {
+		deque_free(&sched->worker[i].deque);
+		arena_free(&sched->worker[i].arena);
+	}
+
+	if (self && self->sched == sched) self = NULL;
+
+	pthread_cond_destroy(&sched->cond);
+	pthread_mutex_destroy(&sched->mutex);
+
+	MEM_FREE(sched->worker);
+
+	sched->worker = NULL;
+}
+
+void sched_group_init(sched_group_t *group)
+{
+	atomic_init(&group->pending, 0);
+}
+
+int sched_init(sched_t *sched, size_t workers)
+{
+	if (!workers) workers = 1;
+
+	*sched = (sched_t) {
+		.workers = workers,
+	};
+
+	atomic_init(&sched->queued, 0);
+	atomic_init(&sched->live, 0);
+	atomic_init(&sched->sleeping, 0);
+	atomic_init(&sched->stop, false);
+
+	sched->worker = MEM_CALLOC(
+		MEM_TAG_SCHED,
+		MEM_SCHED_WORKER,
+		workers,
+		sizeof(*sched->worker));
+	if (!sched->worker) return SCHED_ERROR_NOMEM;
+
+	int ret = SCHED_ERROR_THREAD;
+
+	if (pthread_mutex_init(&sched->mutex, NULL)) goto error_mutex;
+	if (pthread_cond_init(&sched->cond, NULL)) goto error_cond;
+
+	ret = SCHED_ERROR_NOMEM;
+
+	size_t i;
+	for (i = 0; i < workers; i++) {
+		sched_worker_t *worker = &sched->worker[i];
+
+		worker->sched = sched;
+		worker->id    = i;
+		worker->rng   = UINT64_C(0x9e3779b97f4a7c15) * (i + 1);
+
+		if (deque_init(&worker->deque)) goto error_deque_init;
+	}
+
+	self = &sched->worker[0];
+
+	for (i = 1; i < workers; i++) {
+		sched_worker_t *worker = &sched->worker[i];
+
+		if (pthread_create(&worker->thread, NULL, loop, worker)) {
+			sched_free(sched);
+			return SCHED_ERROR_THREAD;
+		}
+
+		worker->started = true;
+	}
+
+	return 0;
+
+error_deque_init:
+	while (i--) deque_free(&sched->worker[i].deque);
+
+	pthread_cond_destroy(&sched->cond);
+
+error_cond:
+	pthread_mutex_destroy(&sched->mutex);
+
+error_mutex:
+	MEM_FREE(sched->worker);
+	sched->worker = NULL;
+
+	return ret;
+}
+
+void sched_reset(sched_t *sched)
+{
+	sched_worker_t *worker = current(sched);
+
+	// the other workers only touch their arena from within a task
+	if (!worker || worker->id || worker->depth) return;
+	if (atomic_load_explicit(&sched->live, memory_order_acquire)) return;
+
+	for (size_t i = 0; i < sched->workers; i++)
+		arena_reset(&sched->worker[i].arena);
+}
+
+void sched_spawn(
+	sched_t        *sched,
+	sched_group_t  *group,
+	sched_fn_t      fn,
+	void           *arg)
+{
+	sched_worker_t *worker = current(sched);
+	sched_task_t   *task   = NULL;
+
+	if (worker) task = arena_alloc(&worker->arena, sizeof(*task));
+
+	// threads outside of the pool, and spawns that cannot be
+	// queued, still make progress
+	if (!task) goto inline_run;
+
+	task->fn    = fn;
+	task->arg   = arg;
+	task->group = group;
+
+	atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&sched->live, 1, memory_order_relaxed);
+	atomic_fetch_add(&sched->queued, 1);
+
+	if (push(&worker->deque, task)) {
+		atomic_fetch_sub(&sched->queued, 1);
+		atomic_fetch_sub_explicit(
+			&sched->live,
+			1,
+			memory_order_relaxed);
+		atomic_fetch_sub_explicit(
+			&group->pending,
+			1,
+			memory_order_relaxed);
+
+		goto inline_run;
+	}
+
+	++worker->stat.spawned;
+
+	if (atomic_load(&sched->sleeping)) {
+		pthread_mutex_lock(&sched->mutex);
+		pthread_cond_signal(&sched->cond);
+		pthread_mutex_unlock(&sched->mutex);
+	}
+
+	return;
+
+inline_run:
+	if (worker) ++worker->stat.inlined;
+
+	fn(arg);
+}
+
+void sched_stat(const sched_t *sched, sched_stat_t *stat)
+{
+	*stat = (sched_stat_t) {0};
+
+	for (size_t i = 0; i < sched->workers; i++) {
+		const sched_stat_t *worker = &sched->worker[i].stat;
+
+		stat->spawned  += worker->spawned;
+		stat->executed += worker->executed;
+		stat->stolen   += worker->stolen;
+		stat->inlined  += worker->inlined;
+	}
+}
+
+void sched_wait(sched_t *sched, sched_group_t *group)
+{
+	sched_worker_t *worker = current(sched);
+
+	while (atomic_load_explicit(&group->pending, memory_order_acquire)) {
+		sched_task_t *task = (worker) ? find(worker) : NULL;
+
+		if (task) run(worker, task);
+		else sched_yield();
+	}
+}
+
+size_t sched_worker(const sched_t *sched)
+{
+	sched_worker_t *worker = current(sched);
+
+	return (worker) ? worker->id : sched->workers;
+}
+
+
+static void *arena_alloc(sched_arena_t *arena, size_t size)
+{
+	const size_t align = sizeof(max_align_t);
+
+	if (size > SIZE_MAX - sizeof(sched_arena_block_t) - align) return NULL;
+
+	size = (size + align - 1) / align * align;
+
+	sched_arena_block_t *block = arena->block;
+
+	if (block && block->size - block->used >= size) {
+		void *ptr = (uint8_t*) block->data + block->used;
+
+		block->used += size;
+
+		return ptr;
+	}
+
+	// oversized requests get a block of their own
+	size_t capacity = (size > SCHED_ARENA_BLOCK) ? size : SCHED_ARENA_BLOCK;
+
+	block = MEM_MALLOC(
+		MEM_TAG_SCHED,
+		MEM_SCHED_ARENA,
+		sizeof(*block) + capacity);
+	if (!block) return NULL;
+
+	block->next = arena->block;
+	block->size = capacity;
+	block->used = size;
+
+	arena->block = block;
+
+	return block->data;
+}
+
+static void arena_free(sched_arena_t *arena)
+{
+	sched_arena_block_t *block = arena->block;
+
+	while (block) {
+		sched_arena_block_t *next = block->next;
+
+		MEM_FREE(block);
+
+		block = next;
+	}
+
+	arena->block = NULL;
+}
+
+static void arena_reset(sched_arena_t *arena)
+{
+	sched_arena_block_t *block = arena->block;
+
+	if (!block) return;
+
+	// keep the newest block around for the next round
+	sched_arena_t rest = {
+		.block = block->next,
+	};
+
+	arena_free(&rest);
+
+	block->next = NULL;
+	block->used = 0;
+}
+
+static sched_worker_t *current(const sched_t *sched)
+{
+	return (self && self->sched == sched) ? self : NULL;
+}
+
+static int deque_init(sched_deque_t *deque)
+{
+	sched_array_t *array = MEM_MALLOC(
+		MEM_TAG_SCHED,
+		MEM_SCHED_DEQUE,
+		sizeof(*array) + SCHED_DEQUE_MIN * sizeof(*array->task));
+	if (!array) return SCHED_ERROR_NOMEM;
+
+	array->retired = NULL;
+	array->mask    = SCHED_DEQUE_MIN - 1;
+
+	atomic_init(&deque->top, 0);
+	atomic_init(&deque->bottom, 0);
+	atomic_init(&deque->array, array);
+
+	return 0;
+}
+
+static void deque_free(sched_deque_t *deque)
+{
+	sched_array_t *array = atomic_load(&deque->array);
+
+	while (array) {
+		sched_array_t *retired = array->retired;
+
+		MEM_FREE(array);
+
+		array = retired;
+	}
+
+	atomic_store(&deque->array, NULL);
+}
+
+static sched_task_t *find(sched_worker_t *worker)
+{
+	sched_task_t *task = take(&worker->deque);
+
+	if (task) {
+		atomic_fetch_sub(&worker->sched->queued, 1);
+		return task;
+	}
+
+	sched_t *sched   = worker->sched;
+	size_t   workers = sched->workers;
+
+	if (workers < 2) return NULL;
+
+	// a random first victim keeps thieves from piling onto one deque
+	size_t start = rng(worker) % workers;
+
+	for (size_t i = 0; i < workers; i++) {
+		sched_worker_t *victim = &sched->worker[(start + i) % workers];
+
+		if (victim == worker) continue;
+
+		task = steal(&victim->deque);
+
+		if (task) {
+			atomic_fetch_sub(&sched->queued, 1);
+			++worker->stat.stolen;
+			return task;
+		}
+	}
+
+	return NULL;
+}
+
+static sched_array_t *grow(
+	sched_deque_t    *deque,
+	sched_array_t    *array,
+	int_least64_t     top,
+	int_least64_t     bottom)
+{
+	size_t size = (array->mask + 1) * 2;
+
+	sched_array_t *grown = MEM_MALLOC(
+		MEM_TAG_SCHED,
+		MEM_SCHED_DEQUE,
+		sizeof(*grown) + size * sizeof(*grown->task));
+	if (!grown) return NULL;
+
+	grown->mask = size - 1;
+
+	for (int_least64_t i = top; i < bottom; i++)
+		atomic_init(
+			&grown->task[i & grown->mask],
+			atomic_load_explicit(
+				&array->task[i & array->mask],
+				memory_order_relaxed));
+
+	// thieves may still be reading the old array
+	grown->retired = array;
+
+	atomic_store_explicit(&deque->array, grown, memory_order_release);
+
+	return grown;
+}
+
+static void *loop(void *arg)
+{
+	sched_worker_t *worker = arg;
+	sched_t        *sched  = worker->sched;
+	size_t          idle   = 0;
+
+	self = worker;
+
+	while (!atomic_load(&sched->stop)) {
+		sched_task_t *task = find(worker);
+
+		if (task) {
+			run(worker, task);
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < SCHED_SPINS) {
+			sched_yield();
+			continue;
+		}
+
+		idle = 0;
+
+		pthread_mutex_lock(&sched->mutex);
+
+		atomic_fetch_add(&sched->sleeping, 1);
+
+		while (!atomic_load(&sched->queued)
+			&& !atomic_load(&sched->stop))
+			pthread_cond_wait(&sched->cond, &sched->mutex);
+
+		atomic_fetch_sub(&sched->sleeping, 1);
+
+		pthread_mutex_unlock(&sched->mutex);
+	}
+
+	return NULL;
+}
+
+static int push(sched_deque_t *deque, sched_task_t *task)
+{
+	int_least64_t  bottom = atomic_load_explicit(
+		&deque->bottom,
+		memory_order_relaxed);
+	int_least64_t  top    = atomic_load_explicit(
+		&deque->top,
+		memory_order_acquire);
+	sched_array_t *array  = atomic_load_explicit(
+		&deque->array,
+		memory_order_relaxed);
+
+	if (bottom - top > (int_least64_t) array->mask) {
+		array = grow(deque, array, top, bottom);
+		if (!array) return SCHED_ERROR_NOMEM;
+	}
+
+	atomic_store_explicit(
+		&array->task[bottom & array->mask],
+		task,
+		memory_order_relaxed);
+
+	atomic_thread_fence(memory_order_release);
+
+	atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+	return 0;
+}
+
+static uint64_t rng(sched_worker_t *worker)
+{
+	worker->rng ^= worker->rng << 13;
+	worker->rng ^= worker->rng >> 7;
+	worker->rng ^= worker->rng << 17;
+
+	return worker->rng;
+}
+
+static void run(sched_worker_t *worker, sched_task_t *task)
+{
+	sched_t       *sched = worker->sched;
+	sched_group_t *group = task->group;
+
+	++worker->depth;
+	task->fn(task->arg);
+	--worker->depth;
+
+	++worker->stat.executed;
+
+	// the group may go out of scope as soon as it drops to zero
+	atomic_fetch_sub_explicit(&sched->live, 1, memory_order_release);
+	atomic_fetch_sub_explicit(&group->pending, 1, memory_order_release);
+}
+
+static sched_task_t *steal(sched_deque_t *deque)
+{
+	int_least64_t top = atomic_load_explicit(
+		&deque->top,
+		memory_order_acquire);
+
+	atomic_thread_fence(memory_order_seq_cst);
+
+	int_least64_t bottom = atomic_load_explicit(
+		&deque->bottom,
+		memory_order_acquire);
+
+	if (top >= bottom) return NULL;
+
+	sched_array_t *array = atomic_load_explicit(
+		&deque->array,
+		memory_order_acquire);
+	sched_task_t  *task  = atomic_load_explicit(
+		&array->task[top & array->mask],
+		memory_order_relaxed);
+
+	// lost the race to the owner or another thief
+	if (!atomic_compare_exchange_strong_explicit(
+		&deque->top,
+		&top,
+		top + 1,
+		memory_order_seq_cst,
+		memory_order_relaxed))
+		return NULL;
+
+	return task;
+}
+
+static sched_task_t *take(sched_deque_t *deque)
+{
+	int_least64_t  bottom = atomic_load_explicit(
+		&deque->bottom,
+		memory_order_relaxed) - 1;
+	sched_array_t *array  = atomic_load_explicit(
+		&deque->array,
+		memory_order_relaxed);
+
+	atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+
+	atomic_thread_fence(memory_order_seq_cst);
+
+	int_least64_t top = atomic_load_explicit(
+		&deque->top,
+		memory_order_relaxed);
+
+	if (top > bottom) {
+		atomic_store_explicit(
+			&deque->bottom,
+			bottom + 1,
+			memory_order_relaxed);
+
+		return NULL;
+	}
+
+	sched_task_t *task = atomic_load_explicit(
+		&array->task[bottom & array->mask],
+		memory_order_relaxed);
+
+	if (top != bottom) return task;
+
+	// the last task is raced for with the thieves
+	if (!atomic_compare_exchange_strong_explicit(
+		&deque->top,
+		&top,
+		top + 1,
+		memory_order_seq_cst,
+		memory_order_relaxed))
+		task = NULL;
+
+	atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+	return task;
+}
@@ -10,13 +10,14 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <jkcc/mem.h>
 #include <jkcc/symbol.h>
 #include <jkcc/vector.h>
 
 
 scope_t *scope_init(void)
 {
-	scope_t *scope = calloc(1, sizeof(*scope));
+	scope_t *scope = MEM_CALLOC(MEM_TAG_SCOPE, 0, 1, sizeof(*scope));
 	if (!scope) return NULL;
 
 	scope->context.current.identifier = symbol_init();
@@ -84,7 +85,7 @@ void scope_free(scope_t *scope)
 	vector_free(&scope->history.label);
 	vector_free(&scope->history.tag);
 
-	free(scope);
+	MEM_FREE(scope);
 }
 
 void scope_pop(scope_t *scope)
@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <jkcc/mem.h>
+
 
 int string_append(string_t *string, const char *str, size_t len)
 {
@@ -37,7 +39,7 @@ void string_free(string_t *string)
 {
 	if (!string) return;
 
-	free(string->head);
+	MEM_FREE(string->head);
 }
 
 int string_init(string_t *string, size_t size)
@@ -47,7 +49,7 @@ int string_init(string_t *string, size_t size)
 
 	if (!size) size = STRING_DEFAULT_SIZE;
 
-	char *tmp = calloc(size, sizeof(*tmp));
+	char *tmp = MEM_CALLOC(MEM_TAG_STRING, 0, size, sizeof(*tmp));
 	if (!tmp) goto error;
 
 	*tmp = '\0';
@@ -80,7 +82,7 @@ static int resize(string_t *string, size_t request)
 		prv_size = new_size;
 	} while (new_size - used < request);
 
-	char *tmp = realloc(string->head, new_size);
+	char *tmp = MEM_REALLOC(MEM_TAG_STRING, 0, string->head, new_size);
 	if (!tmp) goto error;
 
 	string->head = tmp;
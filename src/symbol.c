@@ -15,6 +15,7 @@
 #include <jkcc/ast/struct.h>
 #include <jkcc/ht.h>
 #include <jkcc/list.h>
+#include <jkcc/mem.h>
 #include <jkcc/string.h>
 
 
@@ -33,7 +34,11 @@ int symbol_check_identifier_collision(
 
 symbol_table_t *symbol_init(void)
 {
-	symbol_table_t *symbol = calloc(1, sizeof(*symbol));
+	symbol_table_t *symbol = MEM_CALLOC(
+		MEM_TAG_SYMBOL,
+		0,
+		1,
+		sizeof(*symbol));
 	if (!symbol) return NULL;
 
 	if (ht_init(&symbol->table, 0)) goto ht_init_error;
@@ -41,7 +46,7 @@ symbol_table_t *symbol_init(void)
 	return symbol;
 
 ht_init_error:
-	free(symbol);
+	MEM_FREE(symbol);
 
 	return NULL;
 }
@@ -69,7 +74,7 @@ void symbol_free(symbol_table_t *symbol)
 
 	ht_free(&symbol->table, NULL);
 
-	free(symbol);
+	MEM_FREE(symbol);
 }
 
 int symbol_get_identifier(
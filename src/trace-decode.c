@@ -0,0 +1,421 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * trace-decode.c -- decode binary execution traces
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/private/trace-decode.h>
+
+#include <argp.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jkcc/trace.h>
+#include <jkcc/vector.h>
+#include <jkcc/version.h>
+
+
+#define TRACE_ARGS_DELIM " ,\t\n"
+#define SPEC_SIZE        32
+#define SITES_MAX        65536
+
+
+const char *argp_program_version     = JKCC_VERSION;
+const char *argp_program_bug_address = "<jacobkoziej@gmail.com>";
+
+static const struct argp argp = {
+	.parser   = parse_opt,
+	.args_doc = "FILE...",
+	.doc      = "Decode binary traces written by jkcc --trace-binary.",
+};
+
+
+int main(int argc, char **argv)
+{
+	int status = EXIT_SUCCESS;
+
+	int index;
+	argp_parse(&argp, argc, argv, 0, &index, NULL);
+
+	for (; index < argc; index++)
+		if (decode(argv[index])) status = EXIT_FAILURE;
+
+	return status;
+}
+
+
+static int decode(const char *path)
+{
+	FILE *stream = fopen(path, "rb");
+	if (!stream) goto error_fopen;
+
+	trace_binary_header_t header;
+	if (fread(&header, sizeof(header), 1, stream) != 1) goto error_header;
+
+	if (memcmp(header.magic, TRACE_BINARY_MAGIC, sizeof(header.magic)))
+		goto error_header;
+
+	if (header.version != TRACE_BINARY_VERSION) goto error_header;
+
+	if (header.event_size != sizeof(trace_binary_event_t))
+		goto error_header;
+
+	vector_t sites;
+	if (vector_init(&sites, sizeof(decode_site_t), 0)) goto error_header;
+
+	// events may be flushed ahead of the site they reference,
+	// so collect every site before printing anything
+	long start = ftell(stream);
+
+	if (read_sites(stream, &sites)) goto error_read;
+
+	if (fseek(stream, start, SEEK_SET)) goto error_read;
+
+	decode_site_t *site = sites.buf;
+
+	for (;;) {
+		uint32_t kind;
+		if (fread(&kind, sizeof(kind), 1, stream) != 1) break;
+
+		if (kind == TRACE_BINARY_KIND_SITE) {
+			trace_binary_site_t record;
+			if (fread(
+				(char*) &record + sizeof(kind),
+				sizeof(record) - sizeof(kind),
+				1,
+				stream) != 1) goto error_read;
+
+			if (fseek(
+				stream,
+				(long) record.file_len
+				+ record.func_len
+				+ record.format_len
+				+ record.args_len,
+				SEEK_CUR)) goto error_read;
+
+			continue;
+		}
+
+		trace_binary_event_t event = {.kind = kind};
+		if (fread(
+			(char*) &event + sizeof(kind),
+			sizeof(event) - sizeof(kind),
+			1,
+			stream) != 1) goto error_read;
+
+		if (!event.site || event.site > sites.use) goto error_read;
+		if (!site[event.site - 1].file) goto error_read;
+
+		fprint_event(stdout, &site[event.site - 1], &event);
+	}
+
+	free_sites(&sites);
+
+	fclose(stream);
+
+	return 0;
+
+error_read:
+	free_sites(&sites);
+
+error_header:
+	fclose(stream);
+
+error_fopen:
+	fprintf(stderr, "error: trace-decode: cannot decode '%s'\n", path);
+
+	return -1;
+}
+
+static int fprint_arg(
+	FILE                       *stream,
+	const char                 *spec,
+	size_t                      len,
+	trace_arg_t                 arg,
+	uint64_t                    raw)
+{
+	char buf[SPEC_SIZE];
+
+	if (len >= sizeof(buf)) return -1;
+
+	memcpy(buf, spec, len);
+	buf[len] = '\0';
+
+	double val;
+
+	switch (arg) {
+		case TRACE_ARG_NONE:
+			return -1;
+
+		case TRACE_ARG_INT:
+			fprintf(stream, buf, (int) raw);
+			break;
+
+		case TRACE_ARG_LONG:
+			fprintf(stream, buf, (long) raw);
+			break;
+
+		case TRACE_ARG_LONG_LONG:
+			fprintf(stream, buf, (long long) raw);
+			break;
+
+		case TRACE_ARG_INTMAX:
+			fprintf(stream, buf, (intmax_t) raw);
+			break;
+
+		case TRACE_ARG_SIZE:
+			fprintf(stream, buf, (size_t) raw);
+			break;
+
+		case TRACE_ARG_PTRDIFF:
+			fprintf(stream, buf, (ptrdiff_t) raw);
+			break;
+
+		case TRACE_ARG_DOUBLE:
+			memcpy(&val, &raw, sizeof(val));
+			fprintf(stream, buf, val);
+			break;
+
+		case TRACE_ARG_LONG_DOUBLE:
+			memcpy(&val, &raw, sizeof(val));
+			fprintf(stream, buf, (long double) val);
+			break;
+
+		case TRACE_ARG_POINTER:
+			// pointed-to data does not survive the trace
+			fprintf(stream, "%p", (void*) (uintptr_t) raw);
+			break;
+	}
+
+	return 0;
+}
+
+static void fprint_event(
+	FILE                       *stream,
+	const decode_site_t        *site,
+	const trace_binary_event_t *event)
+{
+	fprintf(
+		stream,
+		"%lu.%09lu:",
+		(unsigned long) (event->timestamp / 1000000000),
+		(unsigned long) (event->timestamp % 1000000000));
+
+	const char  *format;
+	const char  *args;
+	trace_arg_t  arg;
+	size_t       len;
+	size_t       pos = 0;
+
+	switch (site->type) {
+		case TRACE_SITE_ARGS:
+			fprintf(stream, "%s:%s(", site->file, site->func);
+
+			format = site->format;
+			args   = site->args;
+
+			for (;;) {
+				format += strspn(format, TRACE_ARGS_DELIM);
+				args   += strspn(args,   TRACE_ARGS_DELIM);
+
+				if (!*format || !*args) break;
+
+				size_t format_len = strcspn(
+					format,
+					TRACE_ARGS_DELIM);
+				size_t args_len = strcspn(
+					args,
+					TRACE_ARGS_DELIM);
+
+				if (pos) fprintf(stream, ", ");
+
+				fprintf(
+					stream,
+					"%.*s == ",
+					(int) args_len,
+					args);
+
+				const char *spec = trace_arg_next(
+					format,
+					&arg,
+					&len);
+
+				if (!spec || pos >= TRACE_BINARY_RECORD_ARGS)
+					fprintf(stream, "?");
+				else fprint_arg(
+					stream,
+					spec,
+					len,
+					arg,
+					event->arg[pos++]);
+
+				format += format_len;
+				args   += args_len;
+			}
+
+			fprintf(stream, ")\n");
+			break;
+
+		case TRACE_SITE_PRINTF:
+			fprintf(
+				stream,
+				"%s:%s:%d: ",
+				site->file,
+				site->func,
+				site->line);
+
+			format = site->format;
+
+			const char *spec;
+			while ((spec = trace_arg_next(format, &arg, &len))) {
+				fprint_literal(stream, format, spec - format);
+
+				if (pos < TRACE_BINARY_RECORD_ARGS)
+					fprint_arg(
+						stream,
+						spec,
+						len,
+						arg,
+						event->arg[pos++]);
+
+				format = spec + len;
+			}
+
+			fprint_literal(stream, format, strlen(format));
+			fprintf(stream, "\n");
+			break;
+
+		case TRACE_SITE_RULE:
+			fprintf(
+				stream,
+				"%s:%s: %s: %s\n",
+				site->file,
+				site->func,
+				site->format,
+				site->args);
+			break;
+	}
+}
+
+static void fprint_literal(FILE *stream, const char *str, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		fputc(str[i], stream);
+
+		// "%%" stands for a single '%'
+		if (str[i] == '%' && i + 1 < len && str[i + 1] == '%') ++i;
+	}
+}
+
+static void free_sites(vector_t *sites)
+{
+	decode_site_t *site = sites->buf;
+
+	for (size_t i = 0; i < sites->use; i++) {
+		free(site[i].file);
+		free(site[i].func);
+		free(site[i].format);
+		free(site[i].args);
+	}
+
+	vector_free(sites);
+}
+
+static error_t parse_opt(int key, char *arg, struct argp_state *state)
+{
+	(void) arg;
+
+	switch (key) {
+		case ARGP_KEY_NO_ARGS:
+			argp_usage(state);
+			break;
+
+		default:
+			return ARGP_ERR_UNKNOWN;
+	}
+
+	return 0;
+}
+
+static char *read_string(FILE *stream, size_t len)
+{
+	char *str = malloc(len + 1);
+	if (!str) return NULL;
+
+	if (len && fread(str, len, 1, stream) != 1) {
+		free(str);
+		return NULL;
+	}
+
+	str[len] = '\0';
+
+	return str;
+}
+
+static int read_sites(FILE *stream, vector_t *sites)
+{
+	for (;;) {
+		uint32_t kind;
+		if (fread(&kind, sizeof(kind), 1, stream) != 1) break;
+
+		if (kind == TRACE_BINARY_KIND_EVENT) {
+			if (fseek(
+				stream,
+				sizeof(trace_binary_event_t) - sizeof(kind),
+				SEEK_CUR)) return -1;
+
+			continue;
+		}
+
+		if (kind != TRACE_BINARY_KIND_SITE) return -1;
+
+		trace_binary_site_t record;
+		if (fread(
+			(char*) &record + sizeof(kind),
+			sizeof(record) - sizeof(kind),
+			1,
+			stream) != 1) return -1;
+
+		// site ids are handed out densely starting at one
+		if (!record.site || record.site > SITES_MAX) return -1;
+
+		decode_site_t site = {
+			.type   = record.type,
+			.line   = record.line,
+			.file   = read_string(stream, record.file_len),
+			.func   = read_string(stream, record.func_len),
+			.format = read_string(stream, record.format_len),
+			.args   = read_string(stream, record.args_len),
+		};
+
+		while (sites->use < record.site) {
+			decode_site_t empty = {0};
+			if (vector_append(sites, &empty)) goto error;
+		}
+
+		decode_site_t *slot = sites->buf;
+
+		// each site is written once
+		if (slot[record.site - 1].file) goto error;
+
+		slot[record.site - 1] = site;
+
+		if (!site.file || !site.func || !site.format || !site.args)
+			return -1;
+
+		continue;
+
+error:
+		free(site.file);
+		free(site.func);
+		free(site.format);
+		free(site.args);
+
+		return -1;
+	}
+
+	return 0;
+}
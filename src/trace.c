@@ -7,57 +7,85 @@
 #include <jkcc/trace.h>
 #include <jkcc/private/trace.h>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <jkcc/ansi-esc.h>
-#include <jkcc/string.h>
+
+
+static _Thread_local trace_ring_t   *ring;
+static _Thread_local uint_least32_t  ring_epoch;
+
+// every ring any thread filled, so that close can drain them all
+static pthread_mutex_t       rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static trace_ring_t         *rings;
+static atomic_uint_least32_t epoch;
+
+static atomic_uint_least32_t site_count;
+
+// provided by the linker for every site registered by TRACE_SITE(),
+// weak so that binaries without trace sites still link
+extern trace_site_t *const __start_jkcc_trace_sites[] __attribute__((weak));
+extern trace_site_t *const __stop_jkcc_trace_sites[]  __attribute__((weak));
 
 
 void trace_args(
-	trace_t    *trace,
-	const char *file,
-	const char *func,
-	const char *args,
-	const char *format,
+	trace_t      *trace,
+	trace_site_t *site,
 	...)
 {
-	string_t fmt;
+	va_list va;
+	va_start(va, site);
+
+	if (trace->binary >= 0) {
+		trace_event(trace, site, &va);
 
-	char *wformat = NULL;
-	char *wargs   = NULL;
+		va_end(va);
+
+		return;
+	}
 
-	if (string_init(&fmt, 0) < 0) goto error;
+	// interleave argument names with their conversion specifiers
+	char   fmt[TRACE_ARGS_FORMAT_SIZE];
+	size_t use = 0;
 
-	wformat = strdup(format);
-	if (!wformat) goto error;
+	const char *format = site->format;
+	const char *args   = site->args;
 
-	wargs = strdup(args);
-	if (!wargs) goto error;
+	for (;;) {
+		format += strspn(format, TRACE_ARGS_DELIM);
+		args   += strspn(args,   TRACE_ARGS_DELIM);
 
-	char *format_saveptr;
-	char *args_saveptr;
+		if (!*format || !*args) break;
 
-	char *token;
+		size_t format_len = strcspn(format, TRACE_ARGS_DELIM);
+		size_t args_len   = strcspn(args,   TRACE_ARGS_DELIM);
 
-	token = strtok_r(wformat, TRACE_ARGS_DELIM, &format_saveptr);
-	if (string_append(&fmt,  token, 0) < 0) goto error;
-	if (string_append(&fmt, " == ", 0) < 0) goto error;
-	token = strtok_r(wargs, TRACE_ARGS_DELIM, &args_saveptr);
-	if (string_append(&fmt,  token, 0) < 0) goto error;
+		if (use && format_append(fmt, &use, ", ", 2)) goto error;
+		if (format_append(fmt, &use, args, args_len)) goto error;
+		if (format_append(fmt, &use, " == ", 4)) goto error;
+		if (format_append(fmt, &use, format, format_len)) goto error;
 
-	while ((token = strtok_r(NULL, TRACE_ARGS_DELIM, &format_saveptr))) {
-		if (string_append(&fmt,   ", ", 0) < 0) goto error;
-		if (string_append(&fmt,  token, 0) < 0) goto error;
-		if (string_append(&fmt, " == ", 0) < 0) goto error;
-		token = strtok_r(NULL, TRACE_ARGS_DELIM, &args_saveptr);
-		if (string_append(&fmt,  token, 0) < 0) goto error;
+		format += format_len;
+		args   += args_len;
 	}
 
+	fmt[use] = '\0';
+
 	if (trace->level >= JKCC_TRACE_LEVEL_HIGH)
 		print_time(trace);
 
@@ -89,15 +117,12 @@ void trace_args(
 			ANSI_CSI
 			ANSI_SGR_RESET
 			ANSI_SGR,
-			file,
-			func);
+			site->file,
+			site->func);
 	else
-		fprintf(trace->stream, "%s:%s(", file, func);
-
-	va_list va;
-	va_start(va, format);
+		fprintf(trace->stream, "%s:%s(", site->file, site->func);
 
-	vfprintf(trace->stream, fmt.head, va);
+	vfprintf(trace->stream, fmt, va);
 
 	va_end(va);
 
@@ -118,30 +143,210 @@ void trace_args(
 	else
 		fprintf(trace->stream, ")\n");
 
-	free(wformat);
-	free(wargs);
-
-	string_free(&fmt);
-
 	return;
 
 error:
-	free(wformat);
-	free(wargs);
-
-	string_free(&fmt);
+	va_end(va);
 
 	fprintf(trace->stream, "trace_args() failed\n");
 }
 
+const char *trace_arg_next(
+	const char   *format,
+	trace_arg_t  *arg,
+	size_t       *len)
+{
+	for (;;) {
+		format = strchr(format, '%');
+		if (!format) return NULL;
+
+		// literal '%'
+		if (format[1] != '%') break;
+
+		format += 2;
+	}
+
+	const char *pos = format + 1;
+
+	pos += strspn(pos, "-+ #0'");
+	pos += strspn(pos, "0123456789");
+
+	if (*pos == '.') {
+		++pos;
+		pos += strspn(pos, "0123456789");
+	}
+
+	trace_arg_t length = TRACE_ARG_INT;
+	switch (*pos) {
+		case 'h':
+			pos += (pos[1] == 'h') ? 2 : 1;
+			break;
+
+		case 'l':
+			if (pos[1] == 'l') {
+				length = TRACE_ARG_LONG_LONG;
+				pos += 2;
+			} else {
+				length = TRACE_ARG_LONG;
+				++pos;
+			}
+			break;
+
+		case 'j':
+			length = TRACE_ARG_INTMAX;
+			++pos;
+			break;
+
+		case 'z':
+			length = TRACE_ARG_SIZE;
+			++pos;
+			break;
+
+		case 't':
+			length = TRACE_ARG_PTRDIFF;
+			++pos;
+			break;
+
+		case 'L':
+			length = TRACE_ARG_LONG_DOUBLE;
+			++pos;
+			break;
+	}
+
+	switch (*pos) {
+		case 'a':
+		case 'A':
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+			*arg = (length == TRACE_ARG_LONG_DOUBLE)
+				? TRACE_ARG_LONG_DOUBLE
+				: TRACE_ARG_DOUBLE;
+			break;
+
+		case 'n':
+		case 'p':
+		case 's':
+			*arg = TRACE_ARG_POINTER;
+			break;
+
+		case '\0':
+			*arg = TRACE_ARG_NONE;
+			*len = pos - format;
+			return format;
+
+		default:
+			*arg = (length == TRACE_ARG_LONG_DOUBLE)
+				? TRACE_ARG_INT
+				: length;
+			break;
+	}
+
+	*len = pos + 1 - format;
+
+	return format;
+}
+
+int trace_binary_close(
+	trace_t      *trace)
+{
+	if (trace->binary < 0) return 0;
+
+	int ret = 0;
+
+	// no other thread may be tracing by now, so their rings are
+	// drained here along with this one
+	pthread_mutex_lock(&rings_mutex);
+
+	while (rings) {
+		trace_ring_t *next = rings->next;
+
+		if (rings->use && write_all(
+			trace->binary,
+			rings->event,
+			rings->use * sizeof(*rings->event))) ret = -1;
+
+		free(rings);
+		rings = next;
+	}
+
+	atomic_fetch_add_explicit(&epoch, 1, memory_order_release);
+
+	pthread_mutex_unlock(&rings_mutex);
+
+	ring = NULL;
+
+	if (close(trace->binary)) ret = -1;
+
+	trace->binary = -1;
+
+	return ret;
+}
+
+int trace_binary_flush(
+	trace_t      *trace)
+{
+	if (trace->binary < 0 || !ring_self() || !ring->use) return 0;
+
+	int ret = write_all(
+		trace->binary,
+		ring->event,
+		ring->use * sizeof(*ring->event));
+
+	ring->use = 0;
+
+	return ret;
+}
+
+int trace_binary_open(
+	trace_t      *trace,
+	const char   *path)
+{
+	trace_binary_header_t header = {
+		.magic      = TRACE_BINARY_MAGIC,
+		.version    = TRACE_BINARY_VERSION,
+		.event_size = sizeof(trace_binary_event_t),
+	};
+
+	int fd = open(
+		path,
+		O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+		0666);
+	if (fd < 0) return -1;
+
+	if (write_all(fd, &header, sizeof(header))) goto error;
+
+	trace->binary = fd;
+
+	return 0;
+
+error:
+	close(fd);
+
+	return -1;
+}
+
 void trace_printf(
-	trace_t    *trace,
-	const char *file,
-	const char *func,
-	const int   line,
-	const char *format,
+	trace_t      *trace,
+	trace_site_t *site,
 	...)
 {
+	va_list ap;
+	va_start(ap, site);
+
+	const char *format = va_arg(ap, const char*);
+
+	if (trace->binary >= 0) {
+		trace_event(trace, site, &ap);
+
+		va_end(ap);
+
+		return;
+	}
+
 	if (trace->level >= JKCC_TRACE_LEVEL_HIGH)
 		print_time(trace);
 
@@ -183,14 +388,16 @@ void trace_printf(
 			ANSI_CSI
 			ANSI_SGR_RESET
 			ANSI_SGR,
-			file,
-			func,
-			line);
+			site->file,
+			site->func,
+			site->line);
 	else
-		fprintf(trace->stream, "%s:%s:%d: ", file, func, line);
-
-	va_list ap;
-	va_start(ap, format);
+		fprintf(
+			trace->stream,
+			"%s:%s:%d: ",
+			site->file,
+			site->func,
+			site->line);
 
 	vfprintf(trace->stream, format, ap);
 
@@ -200,12 +407,14 @@ void trace_printf(
 }
 
 void trace_rule(
-	trace_t    *trace,
-	const char *file,
-	const char *func,
-	const char *rule,
-	const char *match)
+	trace_t      *trace,
+	trace_site_t *site)
 {
+	if (trace->binary >= 0) {
+		trace_event(trace, site, NULL);
+		return;
+	}
+
 	if (trace->level >= JKCC_TRACE_LEVEL_HIGH)
 		print_time(trace);
 
@@ -255,20 +464,50 @@ void trace_rule(
 			ANSI_CSI
 			ANSI_SGR_RESET
 			ANSI_SGR,
-			file,
-			func,
-			rule,
-			match);
+			site->file,
+			site->func,
+			site->format,
+			site->args);
 	else
 		fprintf(
 			trace->stream,
 			"%s:%s: %s: %s\n",
-			file,
-			func,
-			rule,
-			match);
+			site->file,
+			site->func,
+			site->format,
+			site->args);
+}
+
+
+size_t trace_sites_enable(
+	const char   *pattern)
+{
+	size_t matches = 0;
+
+	for (
+		trace_site_t *const *entry = __start_jkcc_trace_sites;
+		entry < __stop_jkcc_trace_sites;
+		entry++
+	) {
+		if (!site_match(*entry, pattern)) continue;
+
+		(*entry)->enabled = true;
+		++matches;
+	}
+
+	return matches;
 }
 
+void trace_sites_set(
+	bool          enabled)
+{
+	for (
+		trace_site_t *const *entry = __start_jkcc_trace_sites;
+		entry < __stop_jkcc_trace_sites;
+		entry++
+	)
+		(*entry)->enabled = enabled;
+}
 
 static void print_time(trace_t *trace)
 {
@@ -302,3 +541,201 @@ static void print_time(trace_t *trace)
 	else
 		fprintf(trace->stream, "%s:", buf);
 }
+
+static int format_append(char *fmt, size_t *use, const char *str, size_t len)
+{
+	if (*use + len >= TRACE_ARGS_FORMAT_SIZE) return -1;
+
+	memcpy(fmt + *use, str, len);
+	*use += len;
+
+	return 0;
+}
+
+static trace_ring_t *ring_self(void)
+{
+	// a ring from before the last close was freed along with the rest
+	if (ring_epoch != atomic_load_explicit(&epoch, memory_order_acquire))
+		ring = NULL;
+
+	return ring;
+}
+
+static bool site_match(const trace_site_t *site, const char *pattern)
+{
+	char location[PATH_MAX];
+
+	// sites are matched on "file:func:line" or on their format, which
+	// holds the rule name for parser sites
+	snprintf(
+		location,
+		sizeof(location),
+		"%s:%s:%d",
+		site->file,
+		site->func,
+		site->line);
+
+	if (!fnmatch(pattern, location, 0)) return true;
+
+	return site->format && !fnmatch(pattern, site->format, 0);
+}
+
+static uint32_t site_id(trace_t *trace, trace_site_t *site)
+{
+	uint_least32_t id = atomic_load_explicit(
+		&site->id,
+		memory_order_acquire);
+	if (id) return id;
+
+	uint_least32_t expected = 0;
+
+	id = atomic_fetch_add_explicit(
+		&site_count,
+		1,
+		memory_order_relaxed) + 1;
+
+	// another thread registered this site first
+	if (!atomic_compare_exchange_strong_explicit(
+		&site->id,
+		&expected,
+		id,
+		memory_order_acq_rel,
+		memory_order_acquire)) return expected;
+
+	trace_binary_site_t record = {
+		.kind       = TRACE_BINARY_KIND_SITE,
+		.site       = id,
+		.type       = site->type,
+		.line       = site->line,
+		.file_len   = strlen(site->file),
+		.func_len   = strlen(site->func),
+		.format_len = strlen(site->format),
+		.args_len   = strlen(site->args),
+	};
+
+	struct iovec iov[] = {
+		{&record,                sizeof(record)},
+		{(void*) site->file,     record.file_len},
+		{(void*) site->func,     record.func_len},
+		{(void*) site->format,   record.format_len},
+		{(void*) site->args,     record.args_len},
+	};
+
+	// a single writev() keeps the record contiguous under O_APPEND
+	if (writev(trace->binary, iov, sizeof(iov) / sizeof(*iov)) < 0)
+		fprintf(stderr, "trace: failed to write site %u\n", id);
+
+	return id;
+}
+
+static void trace_event(trace_t *trace, trace_site_t *site, va_list *ap)
+{
+	if (!ring_self()) {
+		ring = malloc(sizeof(*ring));
+		if (!ring) return;
+
+		ring->use  = 0;
+		ring_epoch = atomic_load_explicit(&epoch, memory_order_acquire);
+
+		pthread_mutex_lock(&rings_mutex);
+		ring->next = rings;
+		rings      = ring;
+		pthread_mutex_unlock(&rings_mutex);
+	}
+
+	trace_binary_event_t *event = &ring->event[ring->use];
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	event->kind      = TRACE_BINARY_KIND_EVENT;
+	event->site      = site_id(trace, site);
+	event->timestamp = now.tv_sec * UINT64_C(1000000000) + now.tv_nsec;
+
+	size_t pos = 0;
+
+	const char *format = (ap) ? site->format : NULL;
+
+	trace_arg_t arg;
+	size_t      len;
+
+	while (format && pos < TRACE_BINARY_RECORD_ARGS) {
+		format = trace_arg_next(format, &arg, &len);
+		if (!format) break;
+
+		format += len;
+
+		uint64_t *raw = &event->arg[pos++];
+
+		switch (arg) {
+			case TRACE_ARG_NONE:
+				--pos;
+				break;
+
+			case TRACE_ARG_INT:
+				*raw = va_arg(*ap, int);
+				break;
+
+			case TRACE_ARG_LONG:
+				*raw = va_arg(*ap, long);
+				break;
+
+			case TRACE_ARG_LONG_LONG:
+				*raw = va_arg(*ap, long long);
+				break;
+
+			case TRACE_ARG_INTMAX:
+				*raw = va_arg(*ap, intmax_t);
+				break;
+
+			case TRACE_ARG_SIZE:
+				*raw = va_arg(*ap, size_t);
+				break;
+
+			case TRACE_ARG_PTRDIFF:
+				*raw = va_arg(*ap, ptrdiff_t);
+				break;
+
+			case TRACE_ARG_DOUBLE: {
+				double val = va_arg(*ap, double);
+				memcpy(raw, &val, sizeof(*raw));
+				break;
+			}
+
+			case TRACE_ARG_LONG_DOUBLE: {
+				// squeezed into a double to fit the record
+				double val = va_arg(*ap, long double);
+				memcpy(raw, &val, sizeof(*raw));
+				break;
+			}
+
+			case TRACE_ARG_POINTER:
+				*raw = (uintptr_t) va_arg(*ap, void*);
+				break;
+		}
+	}
+
+	while (pos < TRACE_BINARY_RECORD_ARGS) event->arg[pos++] = 0;
+
+	if (++ring->use == TRACE_BINARY_RING_SIZE) trace_binary_flush(trace);
+}
+
+static int write_all(int fd, const void *buf, size_t len)
+{
+	const char *pos = buf;
+
+	while (len) {
+		ssize_t ret = write(fd, pos, len);
+
+		if (ret < 0) {
+			if (errno == EINTR) continue;
+
+			return -1;
+		}
+
+		pos += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
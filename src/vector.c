@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <jkcc/mem.h>
+
 
 int vector_append(vector_t *vector, void *element)
 {
@@ -37,7 +39,11 @@ void vector_free(vector_t *vector)
 {
 	if (!vector) return;
 
-	free(vector->buf);
+	MEM_FREE(vector->buf);
+
+	vector->buf  = NULL;
+	vector->use  = 0;
+	vector->size = 0;
 }
 
 int vector_init(vector_t *vector, size_t element_size, size_t size)
@@ -53,7 +59,10 @@ int vector_init(vector_t *vector, size_t element_size, size_t size)
 	vector->size         = size;
 	vector->element_size = element_size;
 
-	vector->buf = malloc(vector->size * vector->element_size);
+	vector->buf = MEM_MALLOC(
+		MEM_TAG_VECTOR,
+		0,
+		vector->size * vector->element_size);
 	if (!vector->buf) return -1;
 
 	return 0;
@@ -76,7 +85,11 @@ void vector_pop(vector_t *vector, void **element)
 
 int vector_resize(vector_t *vector, size_t size)
 {
-	vector_t *tmp = realloc(vector->buf, size * vector->element_size);
+	vector_t *tmp = MEM_REALLOC(
+		MEM_TAG_VECTOR,
+		0,
+		vector->buf,
+		size * vector->element_size);
 	if (!tmp) return -1;
 
 	vector->buf  = tmp;
@@ -0,0 +1,378 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * x86.c -- x86-64 machine code encoder
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <jkcc/x86.h>
+#include <jkcc/private/x86.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jkcc/mem.h>
+
+
+void x86_alu(x86_t *x86, x86_alu_t op, bool wide, x86_reg_t dst, x86_reg_t src)
+{
+	rex(x86, wide, src, dst);
+	byte(x86, op);
+	modrm_reg(x86, src, dst);
+}
+
+void x86_alu_imm(
+	x86_t     *x86,
+	x86_alu_t  op,
+	bool       wide,
+	x86_reg_t  dst,
+	int32_t    imm)
+{
+	bool imm8 = imm == (int8_t) imm;
+
+	rex(x86, wide, 0, dst);
+	byte(x86, (imm8) ? 0x83 : 0x81);
+	modrm_reg(x86, op >> 3, dst);
+
+	if (imm8) byte(x86, imm);
+	else imm32(x86, imm);
+}
+
+size_t x86_call(x86_t *x86)
+{
+	byte(x86, 0xe8);
+	imm32(x86, 0);
+
+	return x86->use - sizeof(int32_t);
+}
+
+void x86_cmov(x86_t *x86, x86_cc_t cc, x86_reg_t dst, x86_reg_t src)
+{
+	rex(x86, true, dst, src);
+	byte(x86, 0x0f);
+	byte(x86, 0x40 + cc);
+	modrm_reg(x86, dst, src);
+}
+
+void x86_cqo(x86_t *x86)
+{
+	byte(x86, X86_REX | X86_REX_W);
+	byte(x86, 0x99);
+}
+
+void x86_emit(x86_t *x86, const void *buf, size_t size)
+{
+	if (x86->nomem) return;
+
+	if (x86->use + size > x86->size) {
+		size_t new_size = x86->size * 2;
+
+		while (new_size < x86->use + size) new_size *= 2;
+
+		uint8_t *new_buf = MEM_REALLOC(
+			MEM_TAG_X86,
+			0,
+			x86->buf,
+			new_size);
+		if (!new_buf) {
+			x86->nomem = true;
+			return;
+		}
+
+		x86->buf  = new_buf;
+		x86->size = new_size;
+	}
+
+	memcpy(x86->buf + x86->use, buf, size);
+
+	x86->use += size;
+}
+
+void x86_free(x86_t *x86)
+{
+	if (!x86) return;
+
+	MEM_FREE(x86->buf);
+
+	x86->buf  = NULL;
+	x86->use  = 0;
+	x86->size = 0;
+}
+
+void x86_idiv(x86_t *x86, bool wide, x86_reg_t src)
+{
+	rex(x86, wide, 0, src);
+	byte(x86, 0xf7);
+	modrm_reg(x86, 7, src);
+}
+
+void x86_imul(x86_t *x86, bool wide, x86_reg_t dst, x86_reg_t src)
+{
+	rex(x86, wide, dst, src);
+	byte(x86, 0x0f);
+	byte(x86, 0xaf);
+	modrm_reg(x86, dst, src);
+}
+
+int x86_init(x86_t *x86)
+{
+	*x86 = (x86_t) {
+		.size = X86_DEFAULT_SIZE,
+	};
+
+	x86->buf = MEM_MALLOC(MEM_TAG_X86, 0, x86->size);
+	if (!x86->buf) return -1;
+
+	return 0;
+}
+
+size_t x86_jcc(x86_t *x86, x86_cc_t cc)
+{
+	byte(x86, 0x0f);
+	byte(x86, 0x80 + cc);
+	imm32(x86, 0);
+
+	return x86->use - sizeof(int32_t);
+}
+
+size_t x86_jmp(x86_t *x86)
+{
+	byte(x86, 0xe9);
+	imm32(x86, 0);
+
+	return x86->use - sizeof(int32_t);
+}
+
+void x86_lea(x86_t *x86, x86_reg_t dst, x86_reg_t base, int32_t disp)
+{
+	rex(x86, true, dst, base);
+	byte(x86, 0x8d);
+	modrm_mem(x86, dst, base, disp);
+}
+
+size_t x86_lea_rip(x86_t *x86, x86_reg_t dst)
+{
+	rex(x86, true, dst, X86_RAX);
+	byte(x86, 0x8d);
+	byte(x86, ((dst & 7) << 3) | X86_RM_RIP);
+	imm32(x86, 0);
+
+	return x86->use - sizeof(int32_t);
+}
+
+void x86_load(
+	x86_t     *x86,
+	bool       wide,
+	x86_reg_t  dst,
+	x86_reg_t  base,
+	int32_t    disp)
+{
+	rex(x86, wide, dst, base);
+	byte(x86, 0x8b);
+	modrm_mem(x86, dst, base, disp);
+}
+
+void x86_load_sx32(x86_t *x86, x86_reg_t dst, x86_reg_t base, int32_t disp)
+{
+	rex(x86, true, dst, base);
+	byte(x86, 0x63);
+	modrm_mem(x86, dst, base, disp);
+}
+
+void x86_load_xmm(x86_t *x86, x86_xmm_t dst, x86_reg_t base, int32_t disp)
+{
+	// movdqu, the prefix goes before any rex
+	byte(x86, 0xf3);
+	rex(x86, false, dst, base);
+	byte(x86, 0x0f);
+	byte(x86, 0x6f);
+	modrm_mem(x86, dst, base, disp);
+}
+
+void x86_mov(x86_t *x86, bool wide, x86_reg_t dst, x86_reg_t src)
+{
+	rex(x86, wide, src, dst);
+	byte(x86, 0x89);
+	modrm_reg(x86, src, dst);
+}
+
+void x86_mov_imm(x86_t *x86, x86_reg_t dst, int64_t imm)
+{
+	// never xor, the flags of a pending cmp have to survive
+	if (imm == (int32_t) imm) {
+		rex(x86, true, 0, dst);
+		byte(x86, 0xc7);
+		modrm_reg(x86, 0, dst);
+		imm32(x86, imm);
+		return;
+	}
+
+	bool wide = imm != (int64_t) (uint32_t) imm;
+
+	rex(x86, wide, 0, dst);
+	byte(x86, 0xb8 + (dst & 7));
+
+	imm32(x86, (int32_t) (uint32_t) imm);
+	if (wide) imm32(x86, (int32_t) (uint32_t) ((uint64_t) imm >> 32));
+}
+
+void x86_movsxd(x86_t *x86, x86_reg_t dst, x86_reg_t src)
+{
+	rex(x86, true, dst, src);
+	byte(x86, 0x63);
+	modrm_reg(x86, dst, src);
+}
+
+void x86_patch32(x86_t *x86, size_t offset, int32_t val)
+{
+	uint32_t le = val;
+
+	for (size_t i = 0; i < sizeof(le); i++, le >>= 8)
+		x86->buf[offset + i] = le;
+}
+
+void x86_pop(x86_t *x86, x86_reg_t dst)
+{
+	if (dst & 8) byte(x86, X86_REX | X86_REX_B);
+	byte(x86, 0x58 + (dst & 7));
+}
+
+void x86_push(x86_t *x86, x86_reg_t src)
+{
+	if (src & 8) byte(x86, X86_REX | X86_REX_B);
+	byte(x86, 0x50 + (src & 7));
+}
+
+void x86_ret(x86_t *x86)
+{
+	byte(x86, 0xc3);
+}
+
+void x86_setcc(x86_t *x86, x86_cc_t cc, x86_reg_t dst)
+{
+	// without a rex the low bytes of rsp through rdi are ah through bh
+	if (dst >= X86_RSP && dst <= X86_RDI) byte(x86, X86_REX);
+	else rex(x86, false, 0, dst);
+
+	byte(x86, 0x0f);
+	byte(x86, 0x90 + cc);
+	modrm_reg(x86, 0, dst);
+}
+
+void x86_shift(x86_t *x86, x86_shift_t op, bool wide, x86_reg_t dst)
+{
+	rex(x86, wide, 0, dst);
+	byte(x86, 0xd3);
+	modrm_reg(x86, op, dst);
+}
+
+void x86_shift_imm(
+	x86_t       *x86,
+	x86_shift_t  op,
+	bool         wide,
+	x86_reg_t    dst,
+	uint8_t      imm)
+{
+	rex(x86, wide, 0, dst);
+	byte(x86, 0xc1);
+	modrm_reg(x86, op, dst);
+	byte(x86, imm);
+}
+
+void x86_sse(x86_t *x86, x86_sse_t op, x86_xmm_t dst, x86_xmm_t src)
+{
+	byte(x86, 0x66);
+	rex(x86, false, dst, (x86_reg_t) src);
+	byte(x86, 0x0f);
+	byte(x86, op);
+	modrm_reg(x86, dst, (x86_reg_t) src);
+}
+
+void x86_store(
+	x86_t     *x86,
+	bool       wide,
+	x86_reg_t  base,
+	int32_t    disp,
+	x86_reg_t  src)
+{
+	rex(x86, wide, src, base);
+	byte(x86, 0x89);
+	modrm_mem(x86, src, base, disp);
+}
+
+void x86_store_imm(
+	x86_t     *x86,
+	bool       wide,
+	x86_reg_t  base,
+	int32_t    disp,
+	int32_t    imm)
+{
+	rex(x86, wide, 0, base);
+	byte(x86, 0xc7);
+	modrm_mem(x86, 0, base, disp);
+	imm32(x86, imm);
+}
+
+void x86_store_xmm(x86_t *x86, x86_reg_t base, int32_t disp, x86_xmm_t src)
+{
+	byte(x86, 0xf3);
+	rex(x86, false, src, base);
+	byte(x86, 0x0f);
+	byte(x86, 0x7f);
+	modrm_mem(x86, src, base, disp);
+}
+
+void x86_ud2(x86_t *x86)
+{
+	byte(x86, 0x0f);
+	byte(x86, 0x0b);
+}
+
+
+static void byte(x86_t *x86, uint8_t val)
+{
+	x86_emit(x86, &val, sizeof(val));
+}
+
+static void imm32(x86_t *x86, int32_t val)
+{
+	uint32_t le = val;
+	uint8_t  buf[sizeof(le)];
+
+	// little-endian regardless of the host
+	for (size_t i = 0; i < sizeof(buf); i++, le >>= 8) buf[i] = le;
+
+	x86_emit(x86, buf, sizeof(buf));
+}
+
+static void modrm_mem(x86_t *x86, unsigned reg, x86_reg_t base, int32_t disp)
+{
+	bool disp8 = disp == (int8_t) disp;
+
+	byte(
+		x86,
+		((disp8) ? X86_MOD_DISP8 : X86_MOD_DISP32)
+			| ((reg & 7) << 3)
+			| (base & 7));
+
+	// rsp and r12 can only be a base through a sib byte
+	if ((base & 7) == X86_RSP) byte(x86, X86_SIB_SP);
+
+	if (disp8) byte(x86, disp);
+	else imm32(x86, disp);
+}
+
+static void modrm_reg(x86_t *x86, unsigned reg, x86_reg_t rm)
+{
+	byte(x86, X86_MOD_REG | ((reg & 7) << 3) | (rm & 7));
+}
+
+static void rex(x86_t *x86, bool wide, unsigned reg, x86_reg_t base)
+{
+	uint8_t prefix = ((wide) ? X86_REX_W : 0)
+		| ((reg & 8) ? X86_REX_R : 0)
+		| ((base & 8) ? X86_REX_B : 0);
+
+	if (prefix) byte(x86, X86_REX | prefix);
+}
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * bitset.c -- dense bit-set kernel unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <cmocka.h>
+
+#include <jkcc/bitset.h>
+
+
+#define BITS_MAX 1000
+#define ROUNDS   8
+#define SEED     466
+
+
+typedef enum op_e {
+	OP_DIFF,
+	OP_INTERSECT,
+	OP_TRANSFER,
+	OP_UNION,
+} op_t;
+
+
+// none of these are a multiple of any kernel's width
+static const size_t bits[] = {1, 63, 65, 130, 257, 300, BITS_MAX - 1};
+
+
+static void fill(bitset_t *bitset, size_t len)
+{
+	bitset_zero(bitset);
+
+	for (size_t i = 0; i < len; i++)
+		if (rand() & 1) BITSET_SET(bitset, i);
+}
+
+static bool apply(
+	op_t            op,
+	bitset_t       *dst,
+	const bitset_t *gen,
+	const bitset_t *src,
+	const bitset_t *kill)
+{
+	switch (op) {
+		case OP_DIFF:
+			return bitset_diff(dst, src);
+
+		case OP_INTERSECT:
+			return bitset_intersect(dst, src);
+
+		case OP_TRANSFER:
+			return bitset_transfer(dst, gen, src, kill);
+
+		case OP_UNION:
+			return bitset_union(dst, src);
+
+		default:
+			fail();
+	}
+
+	return false;
+}
+
+static bool expect(op_t op, bool dst, bool gen, bool src, bool kill)
+{
+	switch (op) {
+		case OP_DIFF:
+			return dst && !src;
+
+		case OP_INTERSECT:
+			return dst && src;
+
+		case OP_TRANSFER:
+			return gen || (src && !kill);
+
+		case OP_UNION:
+			return dst || src;
+
+		default:
+			fail();
+	}
+
+	return false;
+}
+
+static void check(op_t op, size_t len)
+{
+	bitset_t dst;
+	bitset_t gen;
+	bitset_t src;
+	bitset_t kill;
+	bitset_t old;
+
+	assert_int_equal(bitset_init(&dst, len), 0);
+	assert_int_equal(bitset_init(&gen, len), 0);
+	assert_int_equal(bitset_init(&src, len), 0);
+	assert_int_equal(bitset_init(&kill, len), 0);
+	assert_int_equal(bitset_init(&old, len), 0);
+
+	for (size_t round = 0; round < ROUNDS; round++) {
+		fill(&old, len);
+		fill(&gen, len);
+		fill(&src, len);
+		fill(&kill, len);
+
+		bitset_copy(&dst, &old);
+
+		bool changed = apply(op, &dst, &gen, &src, &kill);
+
+		assert_int_equal(changed, !bitset_equal(&dst, &old));
+
+		for (size_t i = 0; i < len; i++)
+			assert_int_equal(
+				BITSET_TEST(&dst, i),
+				expect(
+					op,
+					BITSET_TEST(&old, i),
+					BITSET_TEST(&gen, i),
+					BITSET_TEST(&src, i),
+					BITSET_TEST(&kill, i)));
+
+		// the padding past the last bit stays clear
+		for (size_t i = len; i < dst.words * BITSET_WORD_BITS; i++)
+			assert_false(BITSET_TEST(&dst, i));
+
+		// every op is idempotent, so a second pass changes nothing
+		bitset_copy(&old, &dst);
+
+		assert_false(apply(op, &dst, &gen, &src, &kill));
+		assert_true(bitset_equal(&dst, &old));
+	}
+
+	bitset_free(&old);
+	bitset_free(&kill);
+	bitset_free(&src);
+	bitset_free(&gen);
+	bitset_free(&dst);
+}
+
+static void kernels(op_t op)
+{
+	bitset_kernel_t detected = bitset_kernel();
+
+	for (bitset_kernel_t i = 0; i < BITSET_KERNELS_TOTAL; i++) {
+		// kernels this machine lacks are refused
+		if (bitset_kernel_set(i)) continue;
+
+		srand(SEED);
+
+		for (size_t j = 0; j < sizeof(bits) / sizeof(*bits); j++)
+			check(op, bits[j]);
+	}
+
+	assert_int_equal(bitset_kernel_set(detected), 0);
+}
+
+
+static void test_diff(void **state)
+{
+	(void) state;
+
+	kernels(OP_DIFF);
+}
+
+static void test_intersect(void **state)
+{
+	(void) state;
+
+	kernels(OP_INTERSECT);
+}
+
+static void test_kernel(void **state)
+{
+	(void) state;
+
+	bitset_kernel_t detected = bitset_kernel();
+
+	// scalar is always there to fall back on
+	assert_int_equal(bitset_kernel_set(BITSET_KERNEL_SCALAR), 0);
+	assert_int_equal(bitset_kernel(), BITSET_KERNEL_SCALAR);
+	assert_int_not_equal(bitset_kernel_set(BITSET_KERNELS_TOTAL), 0);
+	assert_int_equal(bitset_kernel(), BITSET_KERNEL_SCALAR);
+
+	assert_int_equal(bitset_kernel_set(detected), 0);
+	assert_string_equal(bitset_kernel_str(BITSET_KERNEL_AVX2), "avx2");
+	assert_null(bitset_kernel_str(BITSET_KERNELS_TOTAL));
+}
+
+static void test_transfer(void **state)
+{
+	(void) state;
+
+	kernels(OP_TRANSFER);
+}
+
+static void test_union(void **state)
+{
+	(void) state;
+
+	kernels(OP_UNION);
+}
+
+
+int main(void)
+{
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_diff),
+		cmocka_unit_test(test_intersect),
+		cmocka_unit_test(test_kernel),
+		cmocka_unit_test(test_transfer),
+		cmocka_unit_test(test_union),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * dataflow.c -- bit-vector dataflow analysis unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <cmocka.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/bitset.h>
+#include <jkcc/ir.h>
+#include <jkcc/parser.h>
+#include <jkcc/trace.h>
+
+
+static char      **path_next;
+static trace_t     trace;
+static ast_t      *translation_unit;
+static ir_unit_t  *ir_unit;
+
+
+static int setup(void **state)
+{
+	(void) state;
+
+	parser_t parser = {
+		.path  = *path_next++,
+		.trace = &trace,
+	};
+
+	translation_unit = parse(&parser);
+	if (!translation_unit) return -1;
+
+	ir_unit = ir_unit_alloc();
+	if (!ir_unit) return -1;
+
+	return ir_unit_gen(ir_unit, translation_unit);
+}
+
+static int teardown(void **state)
+{
+	(void) state;
+
+	ir_unit_free(ir_unit);
+	AST_NODE_FREE(translation_unit);
+
+	return 0;
+}
+
+
+// the registers set in bitset, as a mask
+static uint64_t live(const bitset_t *bitset, size_t vregs)
+{
+	uint64_t mask = 0;
+
+	for (size_t i = 0; i < vregs; i++)
+		if (BITSET_TEST(bitset, i)) mask |= UINT64_C(1) << i;
+
+	return mask;
+}
+
+
+static void test_liveness(void **state)
+{
+	(void) state;
+
+	ir_function_t   *ir_function = *(ir_function_t**) ir_unit->function.buf;
+	bitset_kernel_t  detected    = bitset_kernel();
+	ir_cfg_t         ir_cfg;
+
+	// the cells of x and y are the only registers that outlive a bb,
+	// and only y is read once the loop is left
+	static const uint64_t in[]  = {0x0, 0x6, 0x6, 0x4};
+	static const uint64_t out[] = {0x6, 0x6, 0x6, 0x0};
+
+	assert_int_equal(ir_cfg_init(&ir_cfg, ir_function), 0);
+	assert_int_equal(ir_cfg.bbs, sizeof(in) / sizeof(*in));
+
+	// every kernel the machine has reaches the same fixpoint
+	for (bitset_kernel_t i = 0; i < BITSET_KERNELS_TOTAL; i++) {
+		if (bitset_kernel_set(i)) continue;
+
+		ir_liveness_t  ir_liveness;
+		ir_dataflow_t *dataflow = &ir_liveness.dataflow;
+
+		assert_int_equal(ir_liveness_init(&ir_liveness, &ir_cfg), 0);
+		assert_true(ir_liveness.vregs < 64);
+
+		for (size_t j = 0; j < ir_cfg.bbs; j++) {
+			assert_int_equal(
+				live(&dataflow->in[j], ir_liveness.vregs),
+				in[j]);
+			assert_int_equal(
+				live(&dataflow->out[j], ir_liveness.vregs),
+				out[j]);
+		}
+
+		// the loop is walked again once its back edge is seen
+		assert_true(dataflow->visits > ir_cfg.bbs);
+
+		ir_liveness_free(&ir_liveness);
+	}
+
+	assert_int_equal(bitset_kernel_set(detected), 0);
+
+	ir_cfg_free(&ir_cfg);
+}
+
+
+int main(int argc, char **argv)
+{
+	(void) argc;
+
+	path_next = argv + 1;
+
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_liveness,
+			setup,
+			teardown
+		),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * elf.c -- elf64 relocatable object writer unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <elf.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+#include <jkcc/parser.h>
+#include <jkcc/trace.h>
+
+
+static char         **path_next;
+static trace_t        trace;
+static ast_t         *translation_unit;
+static ir_unit_t     *ir_unit;
+static ir_codegen_t   ir_codegen;
+static char          *object;
+static size_t         object_size;
+
+
+static int setup(void **state)
+{
+	(void) state;
+
+	parser_t parser = {
+		.path  = *path_next++,
+		.trace = &trace,
+	};
+
+	translation_unit = parse(&parser);
+	if (!translation_unit) return -1;
+
+	ir_unit = ir_unit_alloc();
+	if (!ir_unit) return -1;
+
+	if (ir_unit_gen(ir_unit, translation_unit)) return -1;
+
+	if (ir_codegen_init(&ir_codegen, ir_unit)) return -1;
+
+	FILE *stream = open_memstream(&object, &object_size);
+	if (!stream) return -1;
+
+	int ret = ir_elf_write(stream, &ir_codegen, parser.path);
+
+	fclose(stream);
+
+	return ret;
+}
+
+static int teardown(void **state)
+{
+	(void) state;
+
+	free(object);
+	ir_codegen_free(&ir_codegen);
+	ir_unit_free(ir_unit);
+	AST_NODE_FREE(translation_unit);
+
+	return 0;
+}
+
+
+static const Elf64_Shdr *section(Elf64_Word type)
+{
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr*) object;
+	const Elf64_Shdr *shdr = (const Elf64_Shdr*) (object + ehdr->e_shoff);
+
+	for (size_t i = 0; i < ehdr->e_shnum; i++)
+		if (shdr[i].sh_type == type) return &shdr[i];
+
+	return NULL;
+}
+
+static const Elf64_Sym *symbol(const char *name)
+{
+	const Elf64_Ehdr *ehdr   = (const Elf64_Ehdr*) object;
+	const Elf64_Shdr *shdr   = (const Elf64_Shdr*) (object + ehdr->e_shoff);
+	const Elf64_Shdr *symtab = section(SHT_SYMTAB);
+	const Elf64_Sym  *sym    = (const Elf64_Sym*) (object
+		+ symtab->sh_offset);
+	const char       *strtab = object + shdr[symtab->sh_link].sh_offset;
+
+	for (size_t i = 0; i < symtab->sh_size / sizeof(*sym); i++) {
+		// the source file may share a name with a function
+		if (ELF64_ST_TYPE(sym[i].st_info) == STT_FILE) continue;
+
+		if (!strcmp(strtab + sym[i].st_name, name)) return &sym[i];
+	}
+
+	return NULL;
+}
+
+
+static void test_fib(void **state)
+{
+	(void) state;
+
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr*) object;
+
+	assert_int_equal(memcmp(ehdr->e_ident, ELFMAG, SELFMAG), 0);
+	assert_int_equal(ehdr->e_ident[EI_CLASS], ELFCLASS64);
+	assert_int_equal(ehdr->e_type, ET_REL);
+	assert_int_equal(ehdr->e_machine, EM_X86_64);
+	assert_int_equal(
+		ehdr->e_shoff + ehdr->e_shnum * sizeof(Elf64_Shdr),
+		object_size);
+
+	const Elf64_Sym *fib    = symbol("fib");
+	const Elf64_Sym *entry  = symbol("main");
+	const Elf64_Sym *import = symbol("printf");
+
+	assert_non_null(fib);
+	assert_non_null(entry);
+	assert_non_null(import);
+
+	assert_int_equal(ELF64_ST_BIND(entry->st_info), STB_GLOBAL);
+	assert_int_equal(ELF64_ST_TYPE(entry->st_info), STT_FUNC);
+	assert_int_equal(entry->st_value, fib->st_value + fib->st_size);
+	assert_int_equal(import->st_shndx, SHN_UNDEF);
+
+	// fib calls itself directly, printf and the literals are left
+	// to the linker
+	const Elf64_Shdr *rela = section(SHT_RELA);
+
+	assert_non_null(rela);
+	assert_int_equal(rela->sh_size, 3 * sizeof(Elf64_Rela));
+}
+
+static void test_static(void **state)
+{
+	(void) state;
+
+	const Elf64_Sym  *twice  = symbol("twice");
+	const Elf64_Shdr *symtab = section(SHT_SYMTAB);
+
+	assert_non_null(twice);
+	assert_int_equal(ELF64_ST_BIND(twice->st_info), STB_LOCAL);
+
+	// locals precede the first global
+	const Elf64_Sym *sym = (const Elf64_Sym*) (object + symtab->sh_offset);
+
+	assert_int_equal(twice - sym < symtab->sh_info, 1);
+	assert_int_equal(section(SHT_RELA)->sh_size, 0);
+}
+
+
+int main(int argc, char **argv)
+{
+	(void) argc;
+
+	path_next = argv + 1;
+
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_fib,
+			setup,
+			teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_static,
+			setup,
+			teardown
+		),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
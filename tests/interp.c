@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * interp.c -- ir interpreter unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+#include <jkcc/parser.h>
+#include <jkcc/trace.h>
+
+
+#define REGISTERS     3
+#define REGISTERS_MIN 2  // what scalar code has to fit in with spills
+
+
+static char      **fixture;
+static int         fixtures;
+static trace_t     trace;
+static ast_t      *translation_unit;
+static ir_unit_t  *ir_unit;
+
+
+// the path given on the command line for the fixture a test names
+static const char *fixture_path(const char *name)
+{
+	for (int i = 0; i < fixtures; i++) {
+		const char *base = strrchr(fixture[i], '/');
+
+		if (!strcmp((base) ? base + 1 : fixture[i], name))
+			return fixture[i];
+	}
+
+	return NULL;
+}
+
+
+static int setup(void **state)
+{
+	const char *path = fixture_path(*state);
+	if (!path) return -1;
+
+	parser_t parser = {
+		.path  = path,
+		.trace = &trace,
+	};
+
+	translation_unit = parse(&parser);
+	if (!translation_unit) return -1;
+
+	ir_unit = ir_unit_alloc();
+	if (!ir_unit) return -1;
+
+	return ir_unit_gen(ir_unit, translation_unit);
+}
+
+static int teardown(void **state)
+{
+	(void) state;
+
+	ir_unit_free(ir_unit);
+	AST_NODE_FREE(translation_unit);
+
+	return 0;
+}
+
+
+static int interpret(ir_interp_t *ir_interp, int64_t *ret, char **output)
+{
+	size_t size;
+	FILE  *stream = open_memstream(output, &size);
+
+	assert_non_null(stream);
+	assert_int_equal(ir_interp_init(ir_interp, ir_unit), 0);
+
+	ir_interp->stream = stream;
+
+	int status = ir_interp_run(ir_interp, "main", ret);
+
+	fclose(stream);
+
+	return status;
+}
+
+static void run(int64_t expected, const char *expected_output)
+{
+	// the allocated ir has to compute the same thing
+	for (size_t i = 0; i < 2; i++) {
+		ir_interp_t  ir_interp;
+		int64_t      ret;
+		char        *output;
+
+		if (i)
+			assert_int_equal(
+				ir_regalloc_unit(ir_unit, REGISTERS),
+				0);
+
+		assert_int_equal(interpret(&ir_interp, &ret, &output), 0);
+		assert_int_equal(ret, expected);
+		assert_string_equal(output, expected_output);
+
+		ir_interp_free(&ir_interp);
+		free(output);
+	}
+}
+
+
+static void test_exit(void **state)
+{
+	(void) state;
+
+	run(7, "hello\nA\n");
+}
+
+static void test_fib(void **state)
+{
+	(void) state;
+
+	run(193, "sum 10945 ok\n");
+}
+
+static void test_loop(void **state)
+{
+	(void) state;
+
+	run(0, "-829718\n");
+}
+
+static void test_nested(void **state)
+{
+	(void) state;
+
+	// every argument list holds a call of its own
+	run(36, "42 6 6\n");
+}
+
+static void test_pressure(void **state)
+{
+	(void) state;
+
+	ir_interp_t  ir_interp;
+	int64_t      ret;
+	char        *output;
+
+	// everything spills, with only the two scratch registers left
+	assert_int_equal(ir_regalloc_unit(ir_unit, REGISTERS_MIN), 0);
+
+	assert_int_equal(interpret(&ir_interp, &ret, &output), 0);
+	assert_int_equal(ret, 0);
+	assert_string_equal(output, "-829718\n");
+
+	ir_interp_free(&ir_interp);
+	free(output);
+}
+
+static void test_trap(void **state)
+{
+	(void) state;
+
+	ir_interp_t  ir_interp;
+	int64_t      ret;
+	char        *output;
+
+	assert_int_equal(
+		interpret(&ir_interp, &ret, &output),
+		IR_ERROR_TRAP);
+	assert_int_equal(ir_interp.trap, IR_INTERP_TRAP_DIVIDE_BY_ZERO);
+	assert_string_equal(ir_interp.trap_function, "main");
+
+	ir_interp_free(&ir_interp);
+	free(output);
+}
+
+
+int main(int argc, char **argv)
+{
+	fixture  = argv + 1;
+	fixtures = argc - 1;
+
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test_prestate_setup_teardown(
+			test_exit,
+			setup,
+			teardown,
+			"exit"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_fib,
+			setup,
+			teardown,
+			"fib"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_loop,
+			setup,
+			teardown,
+			"loop"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_nested,
+			setup,
+			teardown,
+			"nested"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_pressure,
+			setup,
+			teardown,
+			"loop"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_trap,
+			setup,
+			teardown,
+			"trap"
+		),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
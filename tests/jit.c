@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * jit.c -- in-memory x86-64 jit unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cmocka.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+#include <jkcc/parser.h>
+#include <jkcc/trace.h>
+
+
+#define OUTPUT_MAX 256
+#define REGISTERS  3
+
+
+static char      **path_next;
+static trace_t     trace;
+static ast_t      *translation_unit;
+static ir_unit_t  *ir_unit;
+
+
+static int setup(void **state)
+{
+	(void) state;
+
+	parser_t parser = {
+		.path  = *path_next++,
+		.trace = &trace,
+	};
+
+	translation_unit = parse(&parser);
+	if (!translation_unit) return -1;
+
+	ir_unit = ir_unit_alloc();
+	if (!ir_unit) return -1;
+
+	return ir_unit_gen(ir_unit, translation_unit);
+}
+
+static int teardown(void **state)
+{
+	(void) state;
+
+	ir_unit_free(ir_unit);
+	AST_NODE_FREE(translation_unit);
+
+	return 0;
+}
+
+
+static int execute(ir_jit_t *ir_jit, int64_t *ret, char *output)
+{
+	// generated code writes through libc, not through a stream we own
+	FILE *stream = tmpfile();
+	assert_non_null(stream);
+
+	fflush(stdout);
+
+	int saved = dup(STDOUT_FILENO);
+	assert_int_equal(saved >= 0, 1);
+	assert_int_equal(dup2(fileno(stream), STDOUT_FILENO), STDOUT_FILENO);
+
+	int status = ir_jit_run(ir_jit, "main", ret);
+
+	fflush(stdout);
+	dup2(saved, STDOUT_FILENO);
+	close(saved);
+
+	rewind(stream);
+
+	size_t size = fread(output, 1, OUTPUT_MAX - 1, stream);
+	output[size] = '\0';
+
+	fclose(stream);
+
+	return status;
+}
+
+static void run(int64_t expected, const char *expected_output)
+{
+	// the allocated ir has to compute the same thing
+	for (size_t i = 0; i < 2; i++) {
+		ir_codegen_t ir_codegen;
+		ir_jit_t     ir_jit;
+		int64_t      ret;
+		char         output[OUTPUT_MAX];
+
+		if (i)
+			assert_int_equal(
+				ir_regalloc_unit(ir_unit, REGISTERS),
+				0);
+
+		assert_int_equal(ir_codegen_init(&ir_codegen, ir_unit), 0);
+
+		int status = ir_jit_init(&ir_jit, &ir_codegen);
+		if (status == IR_ERROR_UNSUPPORTED_HOST) {
+			ir_codegen_free(&ir_codegen);
+			skip();
+		}
+
+		assert_int_equal(status, 0);
+		assert_int_equal(execute(&ir_jit, &ret, output), 0);
+		assert_int_equal(ret, expected);
+		assert_string_equal(output, expected_output);
+
+		ir_jit_free(&ir_jit);
+		ir_codegen_free(&ir_codegen);
+	}
+}
+
+
+static void test_fib(void **state)
+{
+	(void) state;
+
+	run(193, "sum 10945 ok\n");
+}
+
+static void test_loop(void **state)
+{
+	(void) state;
+
+	run(0, "-829718\n");
+}
+
+static void test_nested(void **state)
+{
+	(void) state;
+
+	// calls inside argument lists pass through the same cells
+	run(36, "42 6 6\n");
+}
+
+static void test_undefined(void **state)
+{
+	(void) state;
+
+	ir_codegen_t ir_codegen;
+	ir_jit_t     ir_jit;
+
+	assert_int_equal(ir_codegen_init(&ir_codegen, ir_unit), 0);
+
+	int status = ir_jit_init(&ir_jit, &ir_codegen);
+	if (status == IR_ERROR_UNSUPPORTED_HOST) {
+		ir_codegen_free(&ir_codegen);
+		skip();
+	}
+
+	assert_int_equal(status, IR_ERROR_UNDEFINED_SYMBOL);
+	assert_string_equal(ir_jit.undefined, "nope");
+
+	ir_jit_free(&ir_jit);
+	ir_codegen_free(&ir_codegen);
+}
+
+
+int main(int argc, char **argv)
+{
+	(void) argc;
+
+	path_next = argv + 1;
+
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_fib,
+			setup,
+			teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_loop,
+			setup,
+			teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_nested,
+			setup,
+			teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_undefined,
+			setup,
+			teardown
+		),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
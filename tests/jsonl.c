@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * jsonl.c -- json lines ast and ir dump unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <ctype.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+#include <jkcc/parser.h>
+#include <jkcc/trace.h>
+
+
+#define RECORD_MAX 4096
+
+
+static char       *path;
+static trace_t     trace;
+static ast_t      *translation_unit;
+static ir_unit_t  *ir_unit;
+
+
+static int setup(void **state)
+{
+	(void) state;
+
+	parser_t parser = {
+		.path  = path,
+		.trace = &trace,
+	};
+
+	translation_unit = parse(&parser);
+	if (!translation_unit) return -1;
+
+	ir_unit = ir_unit_alloc();
+	if (!ir_unit) return -1;
+
+	return ir_unit_gen(ir_unit, translation_unit);
+}
+
+static int teardown(void **state)
+{
+	(void) state;
+
+	ir_unit_free(ir_unit);
+	AST_NODE_FREE(translation_unit);
+
+	return 0;
+}
+
+
+static bool value(const char **pos);
+
+static void space(const char **pos)
+{
+	while (isspace((unsigned char) **pos)) ++*pos;
+}
+
+static bool literal(const char **pos, const char *word)
+{
+	size_t len = strlen(word);
+
+	if (strncmp(*pos, word, len)) return false;
+
+	*pos += len;
+
+	return true;
+}
+
+static bool number(const char **pos)
+{
+	char *end;
+
+	strtod(*pos, &end);
+	if (end == *pos) return false;
+
+	*pos = end;
+
+	return true;
+}
+
+static bool string(const char **pos)
+{
+	if (*(*pos)++ != '"') return false;
+
+	for (;;) {
+		unsigned char c = *(*pos)++;
+
+		if (c == '"') return true;
+		if (c < ' ') return false;
+		if (c != '\\') continue;
+
+		c = *(*pos)++;
+
+		if (c == 'u') {
+			for (size_t i = 0; i < 4; i++)
+				if (!isxdigit((unsigned char) *(*pos)++))
+					return false;
+
+			continue;
+		}
+
+		if (!c || !strchr("\"\\/bfnrt", c)) return false;
+	}
+}
+
+// a comma-separated run of member, or of value, up to close
+static bool members(const char **pos, char close, bool keyed)
+{
+	space(pos);
+	if (**pos == close) {
+		++*pos;
+		return true;
+	}
+
+	for (;;) {
+		space(pos);
+
+		if (keyed) {
+			if (!string(pos)) return false;
+
+			space(pos);
+			if (*(*pos)++ != ':') return false;
+		}
+
+		if (!value(pos)) return false;
+
+		space(pos);
+
+		char c = *(*pos)++;
+
+		if (c == close) return true;
+		if (c != ',') return false;
+	}
+}
+
+static bool value(const char **pos)
+{
+	space(pos);
+
+	switch (**pos) {
+		case '{':
+			++*pos;
+			return members(pos, '}', true);
+
+		case '[':
+			++*pos;
+			return members(pos, ']', false);
+
+		case '"':
+			return string(pos);
+
+		case 't':
+			return literal(pos, "true");
+
+		case 'f':
+			return literal(pos, "false");
+
+		case 'n':
+			return literal(pos, "null");
+
+		default:
+			return number(pos);
+	}
+}
+
+// every line is one object opening with its id, counting up from zero,
+// and the id of a parent already printed, if it has one
+static void check(FILE *stream, size_t *roots)
+{
+	char   record[RECORD_MAX];
+	size_t id = 0;
+
+	*roots = 0;
+
+	rewind(stream);
+
+	while (fgets(record, sizeof(record), stream)) {
+		size_t len = strlen(record);
+
+		assert_true(len && record[len - 1] == '\n');
+
+		const char *pos = record;
+
+		assert_int_equal(*pos, '{');
+		assert_true(value(&pos));
+
+		space(&pos);
+		assert_int_equal(*pos, '\0');
+
+		char *end;
+
+		pos = record;
+
+		assert_true(literal(&pos, "{\"id\":"));
+		assert_int_equal(strtoul(pos, &end, 10), id);
+
+		pos = end;
+		assert_true(literal(&pos, ",\"parent\":"));
+
+		if (literal(&pos, "null")) {
+			++*roots;
+		} else {
+			unsigned long parent = strtoul(pos, &end, 10);
+
+			assert_true(end != pos);
+			assert_true(parent < id);
+		}
+
+		++id;
+	}
+
+	assert_true(id > 0);
+}
+
+
+static void test_ast(void **state)
+{
+	(void) state;
+
+	size_t roots;
+
+	FILE *stream = tmpfile();
+	assert_non_null(stream);
+
+	assert_int_equal(fprint_ast_jsonl(stream, translation_unit), 0);
+
+	check(stream, &roots);
+
+	// everything hangs off the translation unit
+	assert_int_equal(roots, 1);
+
+	fclose(stream);
+}
+
+static void test_ir(void **state)
+{
+	(void) state;
+
+	size_t roots;
+
+	FILE *stream = tmpfile();
+	assert_non_null(stream);
+
+	ir_unit_fprint_jsonl(stream, ir_unit);
+
+	check(stream, &roots);
+
+	// fib and main
+	assert_int_equal(roots, ir_unit->function.use);
+	assert_int_equal(roots, 2);
+
+	fclose(stream);
+}
+
+
+int main(int argc, char **argv)
+{
+	(void) argc;
+
+	path = argv[1];
+
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_ast,
+			setup,
+			teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_ir,
+			setup,
+			teardown
+		),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
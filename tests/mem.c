@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * mem.c -- tagged memory allocation unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include <jkcc/mem.h>
+
+
+#define LINE_SIZE 256
+
+// kinds nothing else allocates under, one per test
+#define KIND_LEAK (MEM_KINDS_MAX - 1)
+#define KIND_PAIR (MEM_KINDS_MAX - 2)
+
+
+typedef enum stat_e {
+	STAT_ALLOCS,
+	STAT_FREES,
+	STAT_REALLOCS,
+	STAT_BYTES,
+	STAT_PEAK,
+	STAT_LEAKS,
+	STAT_LEAKED_BYTES,
+	STATS_TOTAL,
+} stat_t;
+
+
+static const char *const kind[MEM_KINDS_MAX] = {
+	[KIND_LEAK] = "leak",
+	[KIND_PAIR] = "pair",
+};
+
+static const char *const tag[MEM_TAGS_TOTAL] = {
+	[MEM_TAG_AST]     = "ast",
+	[MEM_TAG_BITSET]  = "bitset",
+	[MEM_TAG_HT]      = "ht",
+	[MEM_TAG_IR]      = "ir",
+	[MEM_TAG_IR_QUAD] = "ir-quad",
+	[MEM_TAG_PARSER]  = "parser",
+	[MEM_TAG_SCHED]   = "sched",
+	[MEM_TAG_SCOPE]   = "scope",
+	[MEM_TAG_STRING]  = "string",
+	[MEM_TAG_SYMBOL]  = "symbol",
+	[MEM_TAG_VECTOR]  = "vector",
+	[MEM_TAG_X86]     = "x86",
+};
+
+
+// the row mem_report() prints for name, false if it has none
+static bool census(const char *name, size_t stat[STATS_TOTAL])
+{
+	const char *const *kind_str[MEM_TAGS_TOTAL];
+	char               line[LINE_SIZE];
+	char               row[LINE_SIZE];
+	bool               found = false;
+
+	for (size_t i = 0; i < MEM_TAGS_TOTAL; i++) kind_str[i] = kind;
+
+	FILE *stream = tmpfile();
+	assert_non_null(stream);
+
+	mem_report(stream, kind_str);
+
+	rewind(stream);
+
+	while (fgets(line, sizeof(line), stream)) {
+		if (sscanf(
+			line,
+			"mem: %255s %zu %zu %zu %zu %zu %zu %zu",
+			row,
+			&stat[STAT_ALLOCS],
+			&stat[STAT_FREES],
+			&stat[STAT_REALLOCS],
+			&stat[STAT_BYTES],
+			&stat[STAT_PEAK],
+			&stat[STAT_LEAKS],
+			&stat[STAT_LEAKED_BYTES]) != 1 + STATS_TOTAL) continue;
+
+		if (!strcmp(row, name)) {
+			found = true;
+			break;
+		}
+	}
+
+	fclose(stream);
+
+	return found;
+}
+
+
+static void test_leak(void **state)
+{
+	(void) state;
+
+	char   name[LINE_SIZE];
+	size_t stat[STATS_TOTAL];
+
+	snprintf(name, sizeof(name), "%s/%s", tag[MEM_TAG_STRING], "leak");
+
+	char *str = mem_strdup(MEM_TAG_STRING, KIND_LEAK, "census");
+	assert_non_null(str);
+
+	// still live until freed
+	assert_true(census(name, stat));
+	assert_int_equal(stat[STAT_LEAKS], 1);
+	assert_int_equal(stat[STAT_LEAKED_BYTES], sizeof("census"));
+
+	mem_free(str);
+
+	assert_true(census(name, stat));
+	assert_int_equal(stat[STAT_ALLOCS], 1);
+	assert_int_equal(stat[STAT_FREES], 1);
+	assert_int_equal(stat[STAT_LEAKS], 0);
+	assert_int_equal(stat[STAT_LEAKED_BYTES], 0);
+
+	// nothing else in here goes through the census
+	assert_true(census("total", stat));
+	assert_int_equal(stat[STAT_LEAKS], 0);
+	assert_int_equal(stat[STAT_LEAKED_BYTES], 0);
+}
+
+static void test_pair(void **state)
+{
+	(void) state;
+
+	char   name[LINE_SIZE];
+	size_t stat[STATS_TOTAL];
+
+	for (mem_tag_t i = 0; i < MEM_TAGS_TOTAL; i++) {
+		snprintf(name, sizeof(name), "%s/%s", tag[i], "pair");
+
+		// nothing is reported for a kind never allocated
+		assert_false(census(name, stat));
+
+		void *ptr = mem_calloc(i, KIND_PAIR, 3, 8);
+		assert_non_null(ptr);
+
+		ptr = mem_realloc(i, KIND_PAIR, ptr, 40);
+		assert_non_null(ptr);
+
+		mem_free(ptr);
+
+		assert_true(census(name, stat));
+		assert_int_equal(stat[STAT_ALLOCS], 1);
+		assert_int_equal(stat[STAT_FREES], 1);
+		assert_int_equal(stat[STAT_REALLOCS], 1);
+		assert_int_equal(stat[STAT_BYTES], 40);
+		assert_int_equal(stat[STAT_PEAK], 40);
+		assert_int_equal(stat[STAT_LEAKS], 0);
+		assert_int_equal(stat[STAT_LEAKED_BYTES], 0);
+	}
+}
+
+
+int main(void)
+{
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_leak),
+		cmocka_unit_test(test_pair),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,727 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * pass.c -- ir pass manager unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+#include <jkcc/parser.h>
+#include <jkcc/sched.h>
+#include <jkcc/trace.h>
+
+
+typedef struct executed_s {
+	int64_t  ret;
+	uint64_t before[IR_QUAD_TOTAL];
+	uint64_t after[IR_QUAD_TOTAL];
+} executed_t;
+
+
+static char      **fixture;
+static int         fixtures;
+static trace_t     trace;
+static ast_t      *translation_unit;
+static ir_unit_t  *ir_unit;
+
+
+// the path given on the command line for the fixture a test names
+static const char *fixture_path(const char *name)
+{
+	for (int i = 0; i < fixtures; i++) {
+		const char *base = strrchr(fixture[i], '/');
+
+		if (!strcmp((base) ? base + 1 : fixture[i], name))
+			return fixture[i];
+	}
+
+	return NULL;
+}
+
+
+static int setup(void **state)
+{
+	const char *path = fixture_path(*state);
+	if (!path) return -1;
+
+	parser_t parser = {
+		.path  = path,
+		.trace = &trace,
+	};
+
+	translation_unit = parse(&parser);
+	if (!translation_unit) return -1;
+
+	ir_unit = ir_unit_alloc();
+	if (!ir_unit) return -1;
+
+	return ir_unit_gen(ir_unit, translation_unit);
+}
+
+static int teardown(void **state)
+{
+	(void) state;
+
+	ir_unit_free(ir_unit);
+	AST_NODE_FREE(translation_unit);
+
+	return 0;
+}
+
+
+// interpret main on either side of the passes in list, or of the
+// level's pipeline without one, which must not change what it returns
+static void run(
+	ir_pass_manager_t *ir_pass_manager,
+	const char        *list,
+	executed_t        *executed)
+{
+	ir_interp_t ir_interp;
+	int64_t     ret;
+
+	ir_interp_t *interp = &ir_interp;
+
+	assert_int_equal(ir_interp_init(interp, ir_unit), 0);
+	assert_int_equal(ir_interp_run(interp, "main", &executed->ret), 0);
+
+	memcpy(executed->before, interp->executed, sizeof(executed->before));
+
+	ir_interp_free(interp);
+
+	if (list)
+		assert_int_equal(
+			ir_pass_manager_parse(ir_pass_manager, list),
+			0);
+
+	assert_int_equal(ir_pass_manager_run(ir_pass_manager, ir_unit), 0);
+
+	assert_int_equal(ir_interp_init(interp, ir_unit), 0);
+	assert_int_equal(ir_interp_run(interp, "main", &ret), 0);
+	assert_int_equal(ret, executed->ret);
+
+	memcpy(executed->after, interp->executed, sizeof(executed->after));
+
+	ir_interp_free(interp);
+}
+
+// the binops anywhere in the unit doing op on type with imm as rhs
+static size_t binops(ir_quad_binop_op_t op, ir_reg_type_t type, int64_t imm)
+{
+	ir_function_t **ir_function = ir_unit->function.buf;
+	size_t          count       = 0;
+
+	for (size_t i = 0; i < ir_unit->function.use; i++) {
+		ir_bb_t **ir_bb = ir_function[i]->bb.buf;
+
+		for (size_t j = 0; j < ir_function[i]->bb.use; j++) {
+			ir_quad_t **quad = ir_bb[j]->quad.buf;
+
+			for (size_t k = 0; k < ir_bb[j]->quad.use; k++) {
+				if (*quad[k] != IR_QUAD_BINOP) continue;
+
+				ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+					quad[k],
+					ir_quad_binop_t);
+
+				if (binop->op != op) continue;
+				if (binop->type != type) continue;
+				if (!IR_REG_IS_IMMEDIATE(binop->rhs)) continue;
+				if (IR_REG_IMMEDIATE_VALUE(binop->rhs) != imm)
+					continue;
+
+				++count;
+			}
+		}
+	}
+
+	return count;
+}
+
+static void test_alias(void **state)
+{
+	(void) state;
+
+	ir_function_t *ir_function = *(ir_function_t**) ir_unit->function.buf;
+	ir_bb_t       *ir_bb       = *(ir_bb_t**) ir_function->bb.buf;
+	ir_quad_t    **quad        = ir_bb->quad.buf;
+	ir_quad_t     *load[16];
+	ir_quad_t     *store[8];
+	ir_quad_t     *call  = NULL;
+	size_t         loads  = 0;
+	size_t         stores = 0;
+
+	for (size_t i = 0; i < ir_bb->quad.use; i++) {
+		switch (*quad[i]) {
+			case IR_QUAD_CALL:
+				call = quad[i];
+				break;
+
+			case IR_QUAD_LOAD:;
+				ir_quad_load_t *ir_quad_load = OFFSETOF_IR_QUAD(
+					quad[i],
+					ir_quad_load_t);
+
+				if (ir_quad_load->src.type == IR_LOCATION_REG)
+					load[loads++] = quad[i];
+				break;
+
+			case IR_QUAD_STORE:
+				store[stores++] = quad[i];
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	assert_int_equal(loads, 11);
+	assert_int_equal(stores, 6);
+	assert_non_null(call);
+
+	ir_alias_t ir_alias;
+
+	assert_int_equal(ir_alias_init(&ir_alias, ir_function), 0);
+
+	// x and y, then g and h, then p[1] and p[2]
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[0], store[1]),
+		IR_ALIAS_NO);
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[0], load[2]),
+		IR_ALIAS_MUST);
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[2], store[3]),
+		IR_ALIAS_NO);
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[2], load[6]),
+		IR_ALIAS_MUST);
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[4], store[5]),
+		IR_ALIAS_MAY);
+
+	// nothing else knows where x is, but p may point at g
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[0], store[4]),
+		IR_ALIAS_NO);
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[2], store[4]),
+		IR_ALIAS_MAY);
+
+	// an int written through p cannot be the int pointer h
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[3], store[4]),
+		IR_ALIAS_NO);
+
+	assert_int_equal(
+		ir_alias_query(&ir_alias, call, store[0]),
+		IR_ALIAS_NO);
+	assert_int_equal(
+		ir_alias_query(&ir_alias, call, store[2]),
+		IR_ALIAS_MAY);
+
+	// either order is the same pair
+	assert_int_equal(ir_alias.hits, 0);
+	assert_int_equal(
+		ir_alias_query(&ir_alias, store[4], store[2]),
+		IR_ALIAS_MAY);
+	assert_int_equal(ir_alias.hits, 1);
+
+	ir_alias_free(&ir_alias);
+}
+
+static void test_copy_prop(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	run(&ir_pass_manager, "copy-prop", &executed);
+
+	// n and p are read once, and the two *p in the same compare are
+	// one load, but *p after the store to g, which p may point at, is
+	// read again
+	ir_pass_stat_t *stat = ir_pass_manager.stat;
+
+	assert_int_equal(executed.ret, 33);
+	assert_int_equal(stat[IR_PASS_COPY_PROP].quads, 8);
+	assert_int_equal(
+		executed.after[IR_QUAD_LOAD],
+		executed.before[IR_QUAD_LOAD] - 8);
+}
+
+static void test_dead(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	run(&ir_pass_manager, "dce,simplify-cfg", &executed);
+
+	// the unused product and the load feeding it, then what follows
+	// the ret
+	ir_pass_stat_t *stat = ir_pass_manager.stat;
+
+	assert_int_equal(executed.ret, 0);
+	assert_int_equal(stat[IR_PASS_DCE].quads, 2);
+	assert_int_equal(stat[IR_PASS_SIMPLIFY_CFG].quads, 1);
+	assert_int_equal(
+		executed.after[IR_QUAD_BINOP],
+		executed.before[IR_QUAD_BINOP] - 1);
+}
+
+static void test_dse(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	run(&ir_pass_manager, "dse", &executed);
+
+	// every load of x and y, and the load of g, take what was just
+	// stored, leaving the stores to x and y with nothing to read them
+	ir_pass_stat_t *stat = ir_pass_manager.stat;
+
+	assert_int_equal(executed.ret, 57);
+	assert_int_equal(stat[IR_PASS_DSE].quads, 9);
+	assert_int_equal(
+		executed.after[IR_QUAD_LOAD],
+		executed.before[IR_QUAD_LOAD] - 5);
+	assert_int_equal(
+		executed.after[IR_QUAD_STORE],
+		executed.before[IR_QUAD_STORE] - 4);
+}
+
+static void test_inline(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	run(&ir_pass_manager, "inline", &executed);
+
+	ir_pass_stat_t *stat = ir_pass_manager.stat;
+
+	assert_int_equal(executed.ret, 18);
+	assert_int_equal(stat[IR_PASS_INLINE].quads, -46);
+	assert_int_equal(stat[IR_PASS_INLINE].bbs, -14);
+
+	// only the call of h, whose loop puts it over budget, is left
+	assert_int_equal(executed.before[IR_QUAD_CALL], 6);
+	assert_int_equal(executed.after[IR_QUAD_CALL], 1);
+}
+
+static void test_instcombine(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	run(&ir_pass_manager, "instcombine", &executed);
+
+	// the divide and the remainder become multiplies and shifts, the
+	// multiply by 8 a shift, and each identity only its operand
+	ir_function_t   **ir_function = ir_unit->function.buf;
+	ir_bb_t         **ir_bb       = ir_function[0]->bb.buf;
+	size_t            op[IR_QUAD_BINOP_LSR + 1] = {0};
+	ir_quad_binop_t  *lsl = NULL;
+
+	for (size_t i = 0; i < ir_function[0]->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_BINOP) continue;
+
+			ir_quad_binop_t *binop = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_binop_t);
+
+			if (binop->op == IR_QUAD_BINOP_LSL) lsl = binop;
+
+			++op[binop->op];
+		}
+	}
+
+	assert_int_equal(executed.ret, -79);
+	assert_int_equal(op[IR_QUAD_BINOP_DIV], 0);
+	assert_int_equal(op[IR_QUAD_BINOP_MOD], 0);
+	assert_int_equal(op[IR_QUAD_BINOP_LSL], 1);
+
+	// the shift count is carried in the quad itself
+	assert_non_null(lsl);
+	assert_true(IR_REG_IS_IMMEDIATE(lsl->rhs));
+	assert_int_equal(IR_REG_IMMEDIATE_VALUE(lsl->rhs), 3);
+
+	// 2 < 1 is never taken
+	assert_int_equal(executed.before[IR_QUAD_CMP], 1);
+	assert_int_equal(executed.after[IR_QUAD_CMP], 0);
+}
+
+static void test_jobs(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	ir_pass_manager_t serial;
+	executed_t        executed;
+	sched_t           sched;
+
+	// the same pipeline on a copy of the unit, one function at a time
+	ir_unit_t *copy = ir_unit_alloc();
+
+	assert_non_null(copy);
+	assert_int_equal(ir_unit_gen(copy, translation_unit), 0);
+
+	ir_pass_manager_init(&serial, IR_PASS_LEVEL_MAX);
+
+	assert_int_equal(ir_pass_manager_run(&serial, copy), 0);
+
+	ir_unit_free(copy);
+
+	ir_pass_manager_init(&ir_pass_manager, IR_PASS_LEVEL_MAX);
+
+	// more workers than functions
+	assert_int_equal(sched_init(&sched, 8), 0);
+
+	ir_pass_manager.sched = &sched;
+
+	run(&ir_pass_manager, NULL, &executed);
+
+	sched_free(&sched);
+
+	// which worker takes a function never shows in what is removed
+	for (size_t i = 0; i < IR_PASSES_TOTAL; i++) {
+		ir_pass_stat_t *stat     = &ir_pass_manager.stat[i];
+		ir_pass_stat_t *expected = &serial.stat[i];
+
+		assert_int_equal(stat->runs, expected->runs);
+		assert_int_equal(stat->quads, expected->quads);
+		assert_int_equal(stat->bbs, expected->bbs);
+	}
+
+	assert_int_equal(executed.ret, 18);
+}
+
+static void test_select(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, IR_PASS_LEVEL_MAX);
+
+	run(&ir_pass_manager, NULL, &executed);
+
+	// every ?:, && and || in pick is a select, while the ones in
+	// guard would call or dereference on a path that does not, so
+	// keep their branches
+	assert_int_equal(executed.ret, 1428);
+	assert_int_equal(executed.before[IR_QUAD_SELECT], 18);
+	assert_int_equal(executed.after[IR_QUAD_SELECT], 18);
+	assert_int_equal(
+		executed.after[IR_QUAD_BR],
+		executed.before[IR_QUAD_BR]);
+}
+
+static void test_statics(void **state)
+{
+	(void) state;
+
+	ir_callgraph_t    ir_callgraph;
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	// unused, helper, even, odd, only_dead, then main
+	assert_int_equal(ir_callgraph_init(&ir_callgraph, ir_unit), 0);
+
+	size_t *scc = ir_callgraph.scc;
+
+	assert_int_equal(ir_callgraph.functions, 6);
+	assert_int_equal(ir_callgraph.sccs, 5);
+	assert_int_equal(scc[2], scc[3]);
+	assert_int_not_equal(scc[1], scc[2]);
+
+	// every callee comes before its callers
+	for (size_t i = 0; i < ir_callgraph.functions; i++) {
+		size_t  caller = ir_callgraph.order[i];
+		size_t *callee = ir_callgraph.callee[caller].buf;
+
+		for (size_t j = 0; j < ir_callgraph.callee[caller].use; j++)
+			assert_true(scc[callee[j]] <= scc[caller]);
+	}
+
+	assert_int_equal(ir_callgraph.order[ir_callgraph.functions - 1], 5);
+
+	ir_callgraph_free(&ir_callgraph);
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	run(&ir_pass_manager, "global-dce", &executed);
+
+	// only_dead and unused go, and with them unused_calls
+	assert_int_equal(executed.ret, 15);
+	assert_int_equal(ir_unit->function.use, 4);
+	assert_int_equal(ir_unit->static_declaration.use, 1);
+}
+
+static void test_strength_reduce(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	// count, scan and nest each scale an index by the element size
+	assert_int_equal(binops(IR_QUAD_BINOP_MUL, IR_REG_TYPE_I32, 4), 3);
+	assert_int_equal(binops(IR_QUAD_BINOP_ADD, IR_REG_TYPE_PTR, 4), 0);
+
+	run(&ir_pass_manager, "strength-reduce", &executed);
+
+	// each index multiply becomes a pointer bump, leaving only the
+	// ones working out where the pointers start in the preheaders
+	assert_int_equal(executed.ret, 37);
+	assert_int_equal(binops(IR_QUAD_BINOP_MUL, IR_REG_TYPE_I32, 4), 0);
+	assert_int_equal(binops(IR_QUAD_BINOP_ADD, IR_REG_TYPE_PTR, 4), 3);
+	assert_true(
+		executed.after[IR_QUAD_BINOP] < executed.before[IR_QUAD_BINOP]);
+}
+
+static void test_tail(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	ir_interp_t       ir_interp;
+	int64_t           ret;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	assert_int_equal(
+		ir_pass_manager_parse(&ir_pass_manager, "tail-call"),
+		0);
+	assert_int_equal(ir_pass_manager_run(&ir_pass_manager, ir_unit), 0);
+
+	// far past the interpreter stack without frame reuse
+	ir_interp_t *interp = &ir_interp;
+
+	assert_int_equal(ir_interp_init(interp, ir_unit), 0);
+	assert_int_equal(ir_interp_run(interp, "main", &ret), 0);
+	assert_int_equal(ret, 11);
+
+	// sum loops, ping and pong return once for the whole chain
+	assert_int_equal(interp->executed[IR_QUAD_CALL], 100003);
+	assert_int_equal(interp->executed[IR_QUAD_RET], 3);
+
+	ir_interp_free(interp);
+}
+
+static void test_unroll(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	run(&ir_pass_manager, "unroll", &executed);
+
+	// fixed loses its tests, the others test once per four trips
+	// around with what is left over going the original way
+	assert_int_equal(executed.ret, 124);
+	assert_true(executed.after[IR_QUAD_CMP] < executed.before[IR_QUAD_CMP]);
+}
+
+static void test_vectorize(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+	executed_t        executed;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+
+	// strength reduction steps the indexed addresses as pointers
+	run(&ir_pass_manager, "strength-reduce,vectorize", &executed);
+
+	// the sum and the overlapping and each get four lanes ahead of
+	// their scalar loop, the two statement loop stays as it was
+	ir_function_t   **ir_function = ir_unit->function.buf;
+	ir_bb_t         **ir_bb       = ir_function[0]->bb.buf;
+	ir_quad_vector_t *vector[2];
+	size_t            vectors = 0;
+
+	for (size_t i = 0; i < ir_function[0]->bb.use; i++) {
+		ir_quad_t **quad = ir_bb[i]->quad.buf;
+
+		for (size_t j = 0; j < ir_bb[i]->quad.use; j++) {
+			if (*quad[j] != IR_QUAD_VECTOR) continue;
+
+			assert_true(vectors < 2);
+
+			vector[vectors++] = OFFSETOF_IR_QUAD(
+				quad[j],
+				ir_quad_vector_t);
+		}
+	}
+
+	assert_int_equal(executed.ret, 59);
+	assert_int_equal(vectors, 2);
+	assert_int_equal(vector[0]->op, IR_QUAD_BINOP_ADD);
+	assert_int_equal(vector[1]->op, IR_QUAD_BINOP_AND);
+
+	for (size_t i = 0; i < vectors; i++) {
+		assert_int_equal(vector[i]->type, IR_REG_TYPE_I32);
+		assert_int_equal(vector[i]->lanes, 4);
+	}
+
+	// 13 trips around are 3 whole vectors with 1 left over, while
+	// the overlapping streams send the and the scalar way
+	assert_int_equal(executed.before[IR_QUAD_VECTOR], 0);
+	assert_int_equal(executed.after[IR_QUAD_VECTOR], 13 / 4);
+}
+
+static void test_parse(void **state)
+{
+	(void) state;
+
+	ir_pass_manager_t ir_pass_manager;
+
+	ir_pass_manager_init(&ir_pass_manager, 0);
+	assert_int_equal(ir_pass_manager.passes, 0);
+
+	assert_int_equal(
+		ir_pass_manager_parse(&ir_pass_manager, "dce,simplify-cfg,dce"),
+		0);
+	assert_int_equal(ir_pass_manager.passes, 3);
+	assert_int_equal(ir_pass_manager.pipeline[1], IR_PASS_SIMPLIFY_CFG);
+
+	assert_int_equal(ir_pass_manager_parse(&ir_pass_manager, ""), 0);
+	assert_int_equal(ir_pass_manager.passes, 0);
+
+	assert_int_equal(
+		ir_pass_manager_parse(&ir_pass_manager, "dce,bogus"),
+		-1);
+	assert_int_equal(
+		ir_pass_manager_parse(&ir_pass_manager, "dce,,dce"),
+		-1);
+}
+
+
+int main(int argc, char **argv)
+{
+	fixture  = argv + 1;
+	fixtures = argc - 1;
+
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test_prestate_setup_teardown(
+			test_alias,
+			setup,
+			teardown,
+			"alias"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_copy_prop,
+			setup,
+			teardown,
+			"copy"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_dead,
+			setup,
+			teardown,
+			"dead"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_dse,
+			setup,
+			teardown,
+			"dse"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_inline,
+			setup,
+			teardown,
+			"functions"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_instcombine,
+			setup,
+			teardown,
+			"instcombine"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_jobs,
+			setup,
+			teardown,
+			"functions"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_select,
+			setup,
+			teardown,
+			"select"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_statics,
+			setup,
+			teardown,
+			"statics"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_strength_reduce,
+			setup,
+			teardown,
+			"loop"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_tail,
+			setup,
+			teardown,
+			"tail"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_unroll,
+			setup,
+			teardown,
+			"unroll"
+		),
+		cmocka_unit_test_prestate_setup_teardown(
+			test_vectorize,
+			setup,
+			teardown,
+			"vectorize"
+		),
+		cmocka_unit_test(test_parse),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
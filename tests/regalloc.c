@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * regalloc.c -- linear-scan register allocation unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <jkcc/ast.h>
+#include <jkcc/ir.h>
+#include <jkcc/parser.h>
+#include <jkcc/trace.h>
+
+
+static char       *path;
+static trace_t     trace;
+static ast_t      *translation_unit;
+static ir_unit_t  *ir_unit;
+
+
+static int setup(void **state)
+{
+	(void) state;
+
+	parser_t parser = {
+		.path  = path,
+		.trace = &trace,
+	};
+
+	translation_unit = parse(&parser);
+	if (!translation_unit) return -1;
+
+	ir_unit = ir_unit_alloc();
+	if (!ir_unit) return -1;
+
+	return ir_unit_gen(ir_unit, translation_unit);
+}
+
+static int teardown(void **state)
+{
+	(void) state;
+
+	ir_unit_free(ir_unit);
+	AST_NODE_FREE(translation_unit);
+
+	return 0;
+}
+
+
+// false when this host cannot run what the jit generates
+static bool jit(int64_t *ret)
+{
+	ir_codegen_t ir_codegen;
+	ir_jit_t     ir_jit;
+
+	assert_int_equal(ir_codegen_init(&ir_codegen, ir_unit), 0);
+
+	int status = ir_jit_init(&ir_jit, &ir_codegen);
+	if (status == IR_ERROR_UNSUPPORTED_HOST) {
+		ir_codegen_free(&ir_codegen);
+		return false;
+	}
+
+	assert_int_equal(status, 0);
+	assert_int_equal(ir_jit_run(&ir_jit, "main", ret), 0);
+
+	ir_jit_free(&ir_jit);
+	ir_codegen_free(&ir_codegen);
+
+	return true;
+}
+
+// allocate main onto registers, which must take spills and reloads to
+// fit, and still compute what it did with every vreg its own register
+static void allocate(size_t registers, size_t spills, size_t reloads)
+{
+	ir_interp_t  ir_interp;
+	int64_t      expected;
+	int64_t      ret;
+
+	ir_interp_t *interp = &ir_interp;
+
+	assert_int_equal(ir_interp_init(interp, ir_unit), 0);
+	assert_int_equal(ir_interp_run(interp, "main", &expected), 0);
+	assert_int_equal(interp->executed[IR_QUAD_SPILL], 0);
+	assert_int_equal(interp->executed[IR_QUAD_RELOAD], 0);
+
+	ir_interp_free(interp);
+
+	int64_t jitted;
+	bool    host = jit(&jitted);
+
+	if (host) assert_int_equal(jitted, expected);
+
+	assert_int_equal(ir_regalloc_unit(ir_unit, registers), 0);
+
+	ir_function_t *ir_function = *(ir_function_t**) ir_unit->function.buf;
+	ir_regalloc_t *ir_regalloc = ir_function->regalloc;
+
+	assert_non_null(ir_regalloc);
+	assert_int_equal(ir_regalloc->registers, registers);
+	assert_int_equal(ir_regalloc->spills, spills);
+	assert_int_equal(ir_regalloc->reloads, reloads);
+
+	// main is straight-line, so each one runs exactly once
+	assert_int_equal(ir_interp_init(interp, ir_unit), 0);
+	assert_int_equal(ir_interp_run(interp, "main", &ret), 0);
+	assert_int_equal(ret, expected);
+	assert_int_equal(interp->executed[IR_QUAD_SPILL], spills);
+	assert_int_equal(interp->executed[IR_QUAD_RELOAD], reloads);
+
+	ir_interp_free(interp);
+
+	if (!host) return;
+
+	assert_true(jit(&ret));
+	assert_int_equal(ret, expected);
+}
+
+
+static void test_pressure(void **state)
+{
+	(void) state;
+
+	// far more left operands are waiting on their right subtree
+	// than there are registers to hold them
+	allocate(3, 15, 22);
+}
+
+static void test_roomy(void **state)
+{
+	(void) state;
+
+	// every value gets a register of its own
+	allocate(16, 0, 0);
+}
+
+
+int main(int argc, char **argv)
+{
+	(void) argc;
+
+	path = argv[1];
+
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_pressure,
+			setup,
+			teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_roomy,
+			setup,
+			teardown
+		),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * sched.c -- work-stealing task scheduler unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <cmocka.h>
+
+#include <jkcc/sched.h>
+
+
+#define FIB_N       20
+#define FIB_RESULT  6765
+#define FLOOD_TASKS 100000
+
+
+typedef struct fib_s {
+	sched_t *sched;
+	unsigned n;
+	uint64_t result;
+} fib_t;
+
+
+static const size_t workers[] = {1, 2, 8};
+
+
+static void fib(void *arg)
+{
+	fib_t *fib_arg = arg;
+
+	if (fib_arg->n < 2) {
+		fib_arg->result = fib_arg->n;
+		return;
+	}
+
+	fib_t lhs = {
+		.sched = fib_arg->sched,
+		.n     = fib_arg->n - 1,
+	};
+	fib_t rhs = {
+		.sched = fib_arg->sched,
+		.n     = fib_arg->n - 2,
+	};
+
+	sched_group_t group;
+
+	sched_group_init(&group);
+
+	sched_spawn(fib_arg->sched, &group, fib, &lhs);
+	sched_spawn(fib_arg->sched, &group, fib, &rhs);
+
+	sched_wait(fib_arg->sched, &group);
+
+	fib_arg->result = lhs.result + rhs.result;
+}
+
+static void increment(void *arg)
+{
+	atomic_fetch_add_explicit(
+		(atomic_size_t*) arg,
+		1,
+		memory_order_relaxed);
+}
+
+static void *foreign(void *arg)
+{
+	sched_t       *sched = arg;
+	atomic_size_t  count;
+	sched_group_t  group;
+
+	atomic_init(&count, 0);
+	sched_group_init(&group);
+
+	// not a worker, so the task is run in place
+	sched_spawn(sched, &group, increment, &count);
+	sched_wait(sched, &group);
+
+	if (atomic_load(&count) != 1) return NULL;
+	if (sched_worker(sched) != sched->workers) return NULL;
+	if (sched_alloc(sched, 1)) return NULL;
+
+	return sched;
+}
+
+
+static void test_arena(void **state)
+{
+	(void) state;
+
+	sched_t sched;
+
+	assert_int_equal(sched_init(&sched, 2), 0);
+
+	uint8_t *small = sched_alloc(&sched, 3);
+	uint8_t *next  = sched_alloc(&sched, 1);
+
+	assert_non_null(small);
+	assert_non_null(next);
+	assert_int_equal((uintptr_t) small % sizeof(max_align_t), 0);
+	assert_int_equal((uintptr_t) next % sizeof(max_align_t), 0);
+	assert_true(next >= small + 3);
+
+	uint8_t *large = sched_alloc(&sched, SCHED_ARENA_BLOCK * 2);
+
+	assert_non_null(large);
+
+	large[SCHED_ARENA_BLOCK * 2 - 1] = 0xff;
+
+	sched_reset(&sched);
+
+	assert_non_null(sched_alloc(&sched, SCHED_ARENA_BLOCK));
+
+	sched_free(&sched);
+}
+
+static void test_fib(void **state)
+{
+	(void) state;
+
+	for (size_t i = 0; i < sizeof(workers) / sizeof(*workers); i++) {
+		sched_t      sched;
+		sched_stat_t stat;
+
+		assert_int_equal(sched_init(&sched, workers[i]), 0);
+
+		fib_t root = {
+			.sched = &sched,
+			.n     = FIB_N,
+		};
+
+		fib(&root);
+
+		assert_int_equal(root.result, FIB_RESULT);
+
+		sched_stat(&sched, &stat);
+
+		assert_int_equal(stat.spawned, stat.executed);
+		assert_int_equal(stat.inlined, 0);
+
+		sched_reset(&sched);
+		sched_free(&sched);
+	}
+}
+
+static void test_flood(void **state)
+{
+	(void) state;
+
+	for (size_t i = 0; i < sizeof(workers) / sizeof(*workers); i++) {
+		sched_t       sched;
+		sched_group_t group;
+		atomic_size_t count;
+
+		assert_int_equal(sched_init(&sched, workers[i]), 0);
+
+		atomic_init(&count, 0);
+		sched_group_init(&group);
+
+		// far past the initial deque size
+		for (size_t j = 0; j < FLOOD_TASKS; j++)
+			sched_spawn(&sched, &group, increment, &count);
+
+		sched_wait(&sched, &group);
+
+		assert_int_equal(atomic_load(&count), FLOOD_TASKS);
+		assert_int_equal(sched_worker(&sched), 0);
+
+		sched_reset(&sched);
+		sched_free(&sched);
+	}
+}
+
+static void test_foreign(void **state)
+{
+	(void) state;
+
+	sched_t   sched;
+	pthread_t thread;
+	void     *ret;
+
+	assert_int_equal(sched_init(&sched, 2), 0);
+
+	assert_int_equal(pthread_create(&thread, NULL, foreign, &sched), 0);
+	assert_int_equal(pthread_join(thread, &ret), 0);
+
+	assert_ptr_equal(ret, &sched);
+
+	sched_free(&sched);
+}
+
+
+int main(void)
+{
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_arena),
+		cmocka_unit_test(test_fib),
+		cmocka_unit_test(test_flood),
+		cmocka_unit_test(test_foreign),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,390 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+/*
+ * trace.c -- execution trace unit tests
+ * Copyright (C) 2023  Jacob Koziej <jacobkoziej@gmail.com>
+ */
+
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cmocka.h>
+
+#include <jkcc/trace.h>
+
+
+#define EMITS         10
+#define OUTPUT_MAX    256
+#define PATH_TEMPLATE "trace-XXXXXX"
+#define SITES_MAX     65536
+#define THREADS       4
+#define THREAD_EMITS  100
+
+
+typedef struct sites_s {
+	trace_site_t args;
+	trace_site_t print;
+	trace_site_t rule;
+} sites_t;
+
+
+// built by hand so the tests do not hinge on tracing being configured
+#define SITES {                                                        \
+	.args = {                                                      \
+		.enabled = true,                                       \
+		.type    = TRACE_SITE_ARGS,                            \
+		.file    = __FILE__,                                   \
+		.func    = "emit",                                     \
+		.line    = __LINE__,                                   \
+		.format  = "%d %ld",                                   \
+		.args    = "i, -i",                                    \
+	},                                                             \
+	.print = {                                                     \
+		.enabled = true,                                       \
+		.type    = TRACE_SITE_PRINTF,                          \
+		.file    = __FILE__,                                   \
+		.func    = "emit",                                     \
+		.line    = __LINE__,                                   \
+		.format  = "%d apples, %zu pears, %.2f%% left",        \
+		.args    = "format, i, (size_t) i * 2, i / 4.0",       \
+	},                                                             \
+	.rule = {                                                      \
+		.enabled = true,                                       \
+		.type    = TRACE_SITE_RULE,                            \
+		.file    = __FILE__,                                   \
+		.func    = "emit",                                     \
+		.line    = __LINE__,                                   \
+		.format  = "rule",                                     \
+		.args    = "match",                                    \
+	},                                                             \
+}
+
+
+// a site's id, and the record naming it, go out once per process, so
+// every test writing a trace needs sites of its own
+static sites_t round_trip_sites = SITES;
+static sites_t threads_sites    = SITES;
+
+// registered the way TRACE_SITE() does, for the pattern to pick from
+static trace_site_t pattern_site[] = {
+	{
+		.type   = TRACE_SITE_PRINTF,
+		.file   = __FILE__,
+		.func   = "pattern_alpha",
+		.line   = 1,
+		.format = "",
+		.args   = "",
+	},
+	{
+		.type   = TRACE_SITE_PRINTF,
+		.file   = __FILE__,
+		.func   = "pattern_alpha",
+		.line   = 2,
+		.format = "",
+		.args   = "",
+	},
+	{
+		.type   = TRACE_SITE_RULE,
+		.file   = __FILE__,
+		.func   = "pattern_beta",
+		.line   = 3,
+		.format = "pattern_rule",
+		.args   = "match",
+	},
+};
+
+static trace_site_t *const pattern_site_entry[]
+__attribute__((section(TRACE_SITES_SECTION), used)) = {
+	&pattern_site[0],
+	&pattern_site[1],
+	&pattern_site[2],
+};
+
+static const char *decoder;
+static char        path[sizeof(PATH_TEMPLATE)];
+
+
+static int setup(void **state)
+{
+	(void) state;
+
+	strcpy(path, PATH_TEMPLATE);
+
+	int fd = mkstemp(path);
+	if (fd < 0) return -1;
+
+	close(fd);
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	(void) state;
+
+	unlink(path);
+
+	return 0;
+}
+
+
+// feed what path holds through the decoder, returning its exit status
+static int decode(FILE *output)
+{
+	char command[OUTPUT_MAX];
+	char line[OUTPUT_MAX];
+
+	snprintf(command, sizeof(command), "%s %s 2>/dev/null", decoder, path);
+
+	FILE *stream = popen(command, "r");
+	assert_non_null(stream);
+
+	// drop the timestamp, which the text tracer only prints at
+	// JKCC_TRACE_LEVEL_HIGH
+	while (fgets(line, sizeof(line), stream)) {
+		char *pos = strchr(line, ':');
+		assert_non_null(pos);
+
+		fputs(pos + 1, output);
+	}
+
+	int status = pclose(stream);
+	assert_true(WIFEXITED(status));
+
+	return WEXITSTATUS(status);
+}
+
+static void emit(trace_t *trace, sites_t *sites, int i)
+{
+	trace_printf(
+		trace,
+		&sites->print,
+		sites->print.format,
+		i,
+		(size_t) i * 2,
+		i / 4.0);
+	trace_args(trace, &sites->args, i, (long) -i);
+	trace_rule(trace, &sites->rule);
+}
+
+static size_t lines(FILE *stream)
+{
+	size_t count = 0;
+	int    c;
+
+	rewind(stream);
+
+	while ((c = fgetc(stream)) != EOF)
+		if (c == '\n') ++count;
+
+	return count;
+}
+
+static void *worker(void *arg)
+{
+	for (int i = 0; i < THREAD_EMITS; i++) emit(arg, &threads_sites, i);
+
+	return NULL;
+}
+
+static void write_raw(const void *record, size_t size)
+{
+	trace_binary_header_t header = {
+		.magic      = TRACE_BINARY_MAGIC,
+		.version    = TRACE_BINARY_VERSION,
+		.event_size = sizeof(trace_binary_event_t),
+	};
+
+	FILE *stream = fopen(path, "wb");
+	assert_non_null(stream);
+
+	assert_int_equal(fwrite(&header, sizeof(header), 1, stream), 1);
+	assert_int_equal(fwrite(record, size, 1, stream), 1);
+
+	fclose(stream);
+}
+
+
+static void test_corrupt(void **state)
+{
+	(void) state;
+
+	FILE *output = tmpfile();
+	assert_non_null(output);
+
+	trace_binary_event_t event = {
+		.kind = TRACE_BINARY_KIND_EVENT,
+	};
+
+	// ids start at one
+	write_raw(&event, sizeof(event));
+	assert_int_not_equal(decode(output), 0);
+
+	// nothing ever registered the site
+	event.site = 7;
+
+	write_raw(&event, sizeof(event));
+	assert_int_not_equal(decode(output), 0);
+
+	// far past any id a trace could hand out
+	trace_binary_site_t site = {
+		.kind = TRACE_BINARY_KIND_SITE,
+		.site = SITES_MAX + 1,
+	};
+
+	write_raw(&site, sizeof(site));
+	assert_int_not_equal(decode(output), 0);
+
+	assert_int_equal(lines(output), 0);
+
+	fclose(output);
+}
+
+static void test_round_trip(void **state)
+{
+	(void) state;
+
+	FILE *text    = tmpfile();
+	FILE *decoded = tmpfile();
+
+	assert_non_null(text);
+	assert_non_null(decoded);
+
+	trace_t trace = {
+		.stream = text,
+		.level  = JKCC_TRACE_LEVEL_LOW,
+		.binary = -1,
+	};
+
+	for (int i = 0; i < EMITS; i++) emit(&trace, &round_trip_sites, i);
+
+	assert_int_equal(trace_binary_open(&trace, path), 0);
+
+	for (int i = 0; i < EMITS; i++) emit(&trace, &round_trip_sites, i);
+
+	assert_int_equal(trace_binary_close(&trace), 0);
+	assert_int_equal(decode(decoded), 0);
+
+	// the binary trace prints just as the text one did
+	assert_int_equal(lines(text), EMITS * 3);
+	assert_int_equal(lines(decoded), EMITS * 3);
+
+	char expected[OUTPUT_MAX];
+	char actual[OUTPUT_MAX];
+
+	rewind(text);
+	rewind(decoded);
+
+	while (fgets(expected, sizeof(expected), text)) {
+		assert_non_null(fgets(actual, sizeof(actual), decoded));
+		assert_string_equal(actual, expected);
+	}
+
+	fclose(decoded);
+	fclose(text);
+}
+
+static void test_sites(void **state)
+{
+	(void) state;
+
+	trace_sites_set(false);
+
+	for (size_t i = 0; i < 3; i++) assert_false(pattern_site[i].enabled);
+
+	// on "file:func:line"
+	assert_int_equal(trace_sites_enable("*:pattern_alpha:*"), 2);
+	assert_true(pattern_site[0].enabled);
+	assert_true(pattern_site[1].enabled);
+	assert_false(pattern_site[2].enabled);
+
+	trace_sites_set(false);
+
+	// on the rule name
+	assert_int_equal(trace_sites_enable("pattern_r?le"), 1);
+	assert_false(pattern_site[0].enabled);
+	assert_false(pattern_site[1].enabled);
+	assert_true(pattern_site[2].enabled);
+
+	// what is already on stays on
+	assert_int_equal(trace_sites_enable("*:pattern_alpha:2"), 1);
+	assert_false(pattern_site[0].enabled);
+	assert_true(pattern_site[1].enabled);
+	assert_true(pattern_site[2].enabled);
+
+	assert_int_equal(trace_sites_enable("pattern_gamma"), 0);
+
+	trace_sites_set(true);
+
+	for (size_t i = 0; i < 3; i++) assert_true(pattern_site[i].enabled);
+}
+
+static void test_threads(void **state)
+{
+	(void) state;
+
+	pthread_t thread[THREADS];
+	trace_t   trace = {
+		.stream = stderr,
+		.level  = JKCC_TRACE_LEVEL_LOW,
+		.binary = -1,
+	};
+
+	assert_int_equal(trace_binary_open(&trace, path), 0);
+
+	for (size_t i = 0; i < THREADS; i++)
+		assert_int_equal(
+			pthread_create(&thread[i], NULL, worker, &trace),
+			0);
+
+	for (size_t i = 0; i < THREADS; i++)
+		assert_int_equal(pthread_join(thread[i], NULL), 0);
+
+	// none of the workers filled its ring, so only close writes them
+	assert_int_equal(trace_binary_close(&trace), 0);
+
+	FILE *decoded = tmpfile();
+	assert_non_null(decoded);
+
+	assert_int_equal(decode(decoded), 0);
+	assert_int_equal(lines(decoded), THREADS * THREAD_EMITS * 3);
+
+	fclose(decoded);
+}
+
+
+int main(int argc, char **argv)
+{
+	(void) argc;
+
+	decoder = argv[1];
+
+	static const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_corrupt,
+			setup,
+			teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_round_trip,
+			setup,
+			teardown
+		),
+		cmocka_unit_test(test_sites),
+		cmocka_unit_test_setup_teardown(
+			test_threads,
+			setup,
+			teardown
+		),
+	};
+
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}